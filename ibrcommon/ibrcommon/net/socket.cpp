@@ -36,6 +36,7 @@
 #include <netinet/tcp.h>
 #include <sys/un.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netdb.h>
 #endif
 
@@ -387,6 +388,71 @@ namespace ibrcommon
 		return ret;
 	}
 
+	ssize_t clientsocket::sendv(const char *head, size_t head_len, const char *data, size_t len) throw (socket_exception)
+	{
+#ifdef __WIN32__
+		if (head_len > 0) return send(head, head_len, 0);
+		return send(data, len, 0);
+#else
+		struct iovec iov[2];
+		iov[0].iov_base = const_cast<char*>(head);
+		iov[0].iov_len = head_len;
+		iov[1].iov_base = const_cast<char*>(data);
+		iov[1].iov_len = len;
+
+		ssize_t ret = ::writev(this->fd(), iov, 2);
+		if (ret == -1) {
+			switch (__errno)
+			{
+			case EPIPE:
+				// connection has been reset
+				throw socket_error(ERROR_EPIPE, "connection has been reset");
+
+			case ECONNRESET:
+				// Connection reset by peer
+				throw socket_error(ERROR_RESET, "Connection reset by peer");
+
+			case EAGAIN:
+				// sent failed but we should retry again
+				throw socket_error(ERROR_AGAIN, "sent failed but we should retry again");
+
+			default:
+				throw socket_error(ERROR_WRITE, "send error");
+			}
+		}
+		return ret;
+#endif
+	}
+
+	ssize_t clientsocket::recvv(char *data, size_t len, char *tail, size_t tail_len) throw (socket_exception)
+	{
+#ifdef __WIN32__
+		if (len > 0) return recv(data, len, 0);
+		return recv(tail, tail_len, 0);
+#else
+		struct iovec iov[2];
+		iov[0].iov_base = data;
+		iov[0].iov_len = len;
+		iov[1].iov_base = tail;
+		iov[1].iov_len = tail_len;
+
+		ssize_t ret = ::readv(this->fd(), iov, 2);
+		if (ret == -1) {
+			switch (__errno)
+			{
+			case EPIPE:
+				// connection has been reset
+				throw socket_error(ERROR_EPIPE, "connection has been reset");
+
+			default:
+				throw socket_error(ERROR_READ, "read error");
+			}
+		}
+
+		return ret;
+#endif
+	}
+
 	void clientsocket::set(CLIENT_OPTION opt, bool val) throw (socket_exception)
 	{
 		switch (opt) {
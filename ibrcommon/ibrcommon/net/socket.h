@@ -232,6 +232,18 @@ namespace ibrcommon {
 		ssize_t send(const char *data, size_t len, int flags = 0) throw (socket_exception);
 		ssize_t recv(char *data, size_t len, int flags = 0) throw (socket_exception);
 
+		/**
+		 * Send two buffers with one system call. The data of the second
+		 * buffer is only sent if the first has been sent completely.
+		 */
+		ssize_t sendv(const char *head, size_t head_len, const char *data, size_t len) throw (socket_exception);
+
+		/**
+		 * Receive into two buffers with one system call. The second
+		 * buffer is only filled if the first has been filled completely.
+		 */
+		ssize_t recvv(char *data, size_t len, char *tail, size_t tail_len) throw (socket_exception);
+
 		void set(CLIENT_OPTION opt, bool val) throw (socket_exception);
 
 	protected:
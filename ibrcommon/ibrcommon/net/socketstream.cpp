@@ -84,76 +84,179 @@ namespace ibrcommon
 			return std::char_traits<char>::not_eof(c);
 		}
 
-		try {
-			socketset writeset;
-			_socket.select(NULL, &writeset, NULL, NULL);
+		// bytes to send
+		ssize_t bytes = (iend - ibegin);
 
-			// error checking
-			if (writeset.size() == 0) {
-				throw socket_exception("no select result returned");
-			}
+		// send the data
+		ssize_t ret = __send(ibegin, bytes, NULL, 0);
 
-			// bytes to send
-			ssize_t bytes = (iend - ibegin);
+		// check how many bytes are sent
+		if (ret < bytes)
+		{
+			// we did not sent all bytes
+			char *resched_begin = ibegin + ret;
+			char *resched_end = iend;
 
-			// send the data
-			clientsocket &sock = static_cast<clientsocket&>(**(writeset.begin()));
+			// bytes left to send
+			size_t bytes_left = resched_end - resched_begin;
 
-			ssize_t ret = sock.send(&out_buf_[0], (iend - ibegin), 0);
+			// move the data to the begin of the buffer
+			::memmove(ibegin, resched_begin, bytes_left);
 
-			// check how many bytes are sent
-			if (ret < bytes)
-			{
-				// we did not sent all bytes
-				char *resched_begin = ibegin + ret;
-				char *resched_end = iend;
+			// new free buffer
+			char *buffer_begin = ibegin + bytes_left;
 
-				// bytes left to send
-				size_t bytes_left = resched_end - resched_begin;
+			// mark the buffer as free
+			setp(buffer_begin, &out_buf_[0] + _bufsize - 1);
+		}
 
-				// move the data to the begin of the buffer
-				::memcpy(ibegin, resched_begin, bytes_left);
+		return std::char_traits<char>::not_eof(c);
+	}
 
-				// new free buffer
-				char *buffer_begin = ibegin + bytes_left;
+	std::streamsize socketstream::xsputn(const char *s, std::streamsize n)
+	{
+		// copy the data if it fits into the buffer
+		if (n < (epptr() - pptr())) return std::basic_streambuf<char, std::char_traits<char> >::xsputn(s, n);
+
+		// send the buffered data and the new data with one call
+		// without copying the new data into the buffer
+		char *pending = pbase();
+		size_t pending_len = pptr() - pbase();
+		std::streamsize done = 0;
 
-				// mark the buffer as free
-				setp(buffer_begin, &out_buf_[0] + _bufsize - 1);
+		while ((pending_len > 0) || (done < n))
+		{
+			size_t ret = __send(pending, pending_len, s + done, n - done);
+
+			if (ret < pending_len)
+			{
+				pending += ret;
+				pending_len -= ret;
 			}
-		} catch (const vsocket_interrupt &e) {
-			errmsg = ERROR_CLOSED;
-			close();
-			IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 85) << "select interrupted: " << e.what() << IBRCOMMON_LOGGER_ENDL;
-			throw;
-		} catch (const socket_error &err) {
-			if (err.code() == ERROR_AGAIN) {
-				return overflow(c);
+			else
+			{
+				done += (ret - pending_len);
+				pending_len = 0;
 			}
+		}
 
-			// set the last error code
-			errmsg = err.code();
+		// mark the buffer as free
+		setp(&out_buf_[0], &out_buf_[0] + _bufsize - 1);
 
-			// close the stream/socket due to failures
-			close();
+		return n;
+	}
 
-			// create a detailed exception message
-			std::stringstream ss; ss << "send() failed: " << err.code();
-			throw stream_exception(ss.str());
-		} catch (const socket_exception &ex) {
-			// set the last error code
-			errmsg = ERROR_WRITE;
+	ssize_t socketstream::__send(const char *head, size_t head_len, const char *data, size_t len)
+	{
+		while (true)
+		{
+			try {
+				socketset writeset;
+				_socket.select(NULL, &writeset, NULL, NULL);
 
-			// close the stream/socket due to failures
-			close();
+				// error checking
+				if (writeset.size() == 0) {
+					throw socket_exception("no select result returned");
+				}
 
-			// create a detailed exception message
-			throw stream_exception("<tcpstream> send() timed out");
-		}
+				// send the data
+				clientsocket &sock = static_cast<clientsocket&>(**(writeset.begin()));
 
-		return std::char_traits<char>::not_eof(c);
+				if (len == 0) return sock.send(head, head_len, 0);
+				return sock.sendv(head, head_len, data, len);
+			} catch (const vsocket_interrupt &e) {
+				errmsg = ERROR_CLOSED;
+				close();
+				IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 85) << "select interrupted: " << e.what() << IBRCOMMON_LOGGER_ENDL;
+				throw;
+			} catch (const socket_error &err) {
+				// retry the send operation
+				if (err.code() == ERROR_AGAIN) continue;
+
+				// set the last error code
+				errmsg = err.code();
+
+				// close the stream/socket due to failures
+				close();
+
+				// create a detailed exception message
+				std::stringstream ss; ss << "send() failed: " << err.code();
+				throw stream_exception(ss.str());
+			} catch (const socket_exception &ex) {
+				// set the last error code
+				errmsg = ERROR_WRITE;
+
+				// close the stream/socket due to failures
+				close();
+
+				// create a detailed exception message
+				throw stream_exception("<tcpstream> send() timed out");
+			}
+		}
 	}
 
 	std::char_traits<char>::int_type socketstream::underflow()
+	{
+		// read some bytes
+		ssize_t bytes = __recv(&in_buf_[0], _bufsize, NULL, 0);
+
+		// end of stream or error
+		if (bytes == 0) return std::char_traits<char>::eof();
+
+		// Since the input buffer content is now valid (or is new)
+		// the get pointer should be initialized (or reset).
+		setg(&in_buf_[0], &in_buf_[0], &in_buf_[0] + bytes);
+
+		return std::char_traits<char>::not_eof(in_buf_[0]);
+	}
+
+	std::streamsize socketstream::xsgetn(char *s, std::streamsize n)
+	{
+		std::streamsize done = 0;
+
+		while (done < n)
+		{
+			// take the buffered data first
+			std::streamsize avail = egptr() - gptr();
+			if (avail > 0)
+			{
+				if (avail > (n - done)) avail = (n - done);
+				::memcpy(s + done, gptr(), avail);
+				gbump(static_cast<int>(avail));
+				done += avail;
+				continue;
+			}
+
+			if ((n - done) < static_cast<std::streamsize>(_bufsize))
+			{
+				// small reads are served by the buffer
+				if (std::char_traits<char>::eq_int_type(underflow(), std::char_traits<char>::eof())) break;
+				continue;
+			}
+
+			// receive directly into the destination, data beyond
+			// the requested length is stored in the buffer
+			ssize_t bytes = __recv(s + done, n - done, &in_buf_[0], _bufsize);
+
+			// end of stream or error
+			if (bytes == 0) break;
+
+			if (bytes > (n - done))
+			{
+				setg(&in_buf_[0], &in_buf_[0], &in_buf_[0] + (bytes - (n - done)));
+				done = n;
+			}
+			else
+			{
+				setg(0, 0, 0);
+				done += bytes;
+			}
+		}
+
+		return done;
+	}
+
+	ssize_t socketstream::__recv(char *data, size_t len, char *tail, size_t tail_len)
 	{
 		try {
 			socketset readset;
@@ -175,7 +278,7 @@ namespace ibrcommon
 			clientsocket &sock = static_cast<clientsocket&>(**(readset.begin()));
 
 			// read some bytes
-			ssize_t bytes = sock.recv(&in_buf_[0], _bufsize, 0);
+			ssize_t bytes = (tail_len == 0) ? sock.recv(data, len, 0) : sock.recvv(data, len, tail, tail_len);
 
 			// end of stream
 			if (bytes == 0)
@@ -183,19 +286,13 @@ namespace ibrcommon
 				errmsg = ERROR_CLOSED;
 				close();
 				IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 85) << "recv() returned zero: " << errno << IBRCOMMON_LOGGER_ENDL;
-				return std::char_traits<char>::eof();
 			}
 
-			// Since the input buffer content is now valid (or is new)
-			// the get pointer should be initialized (or reset).
-			setg(&in_buf_[0], &in_buf_[0], &in_buf_[0] + bytes);
-
-			return std::char_traits<char>::not_eof(in_buf_[0]);
+			return bytes;
 		} catch (const vsocket_interrupt &e) {
 			errmsg = ERROR_CLOSED;
 			close();
 			IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 85) << "select interrupted: " << e.what() << IBRCOMMON_LOGGER_ENDL;
-			return std::char_traits<char>::eof();
 		} catch (const socket_error &err) {
 			// set the last error code
 			errmsg = err.code();
@@ -208,6 +305,6 @@ namespace ibrcommon
 			IBRCOMMON_LOGGER_DEBUG_TAG("socketstream", 75) << "recv() failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 		}
 
-		return std::char_traits<char>::eof();
+		return 0;
 	}
 } /* namespace ibrcommon */
@@ -53,7 +53,30 @@ namespace ibrcommon
 		virtual std::char_traits<char>::int_type overflow(std::char_traits<char>::int_type = std::char_traits<char>::eof());
 		virtual std::char_traits<char>::int_type underflow();
 
+		/**
+		 * Large writes are sent together with the buffered data
+		 * by one gather call, without copying them into the buffer.
+		 */
+		virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+		/**
+		 * Large reads are received directly into the destination.
+		 */
+		virtual std::streamsize xsgetn(char *s, std::streamsize n);
+
 	private:
+		/**
+		 * Wait until the socket is writable and send the data.
+		 * @return The number of bytes sent.
+		 */
+		ssize_t __send(const char *head, size_t head_len, const char *data, size_t len);
+
+		/**
+		 * Wait until the socket is readable and receive data.
+		 * @return The number of bytes received or zero on errors.
+		 */
+		ssize_t __recv(char *data, size_t len, char *tail, size_t tail_len);
+
 		vsocket _socket;
 		const size_t _bufsize;
 
@@ -43,10 +43,15 @@ namespace ibrcommon
 	bool TLSStream::_initialized = false;
 	bool TLSStream::_SSL_initialized = false;
 	ibrcommon::Mutex TLSStream::_initialization_lock;
+	TLSStream::session_map TLSStream::_sessions;
+	ibrcommon::Mutex TLSStream::_sessions_lock;
+
+	// identifies the sessions of this application in the server-side cache
+	static const unsigned char SESSION_ID_CONTEXT[] = "ibrcommon-tls";
 
 	TLSStream::TLSStream(std::iostream *stream)
 	  : iostream(this), _activated(false), in_buf_(BUFF_SIZE), out_buf_(BUFF_SIZE),
-	    _stream(stream), _server(false), _ssl(NULL), _peer_cert(NULL), _iostreamBIO(NULL)
+	    _stream(stream), _server(false), _resumed(false), _ssl(NULL), _peer_cert(NULL), _iostreamBIO(NULL)
 	{
 		/* basic_streambuf related initialization */
 		// Initialize get pointer.  This should be zero so that underflow is called upon first read.
@@ -65,6 +70,47 @@ namespace ibrcommon
 		_server = val;
 	}
 
+	void TLSStream::setPeer(const std::string &id)
+	{
+		_peer_id = id;
+	}
+
+	bool TLSStream::isResumed() const
+	{
+		return _resumed;
+	}
+
+	void TLSStream::clearSessions()
+	{
+		ibrcommon::MutexLock l(_sessions_lock);
+		for (session_map::iterator it = _sessions.begin(); it != _sessions.end(); ++it)
+		{
+			SSL_SESSION_free(it->second);
+		}
+		_sessions.clear();
+	}
+
+	void TLSStream::__removeSession(const std::string &id)
+	{
+		session_map::iterator it = _sessions.find(id);
+		if (it == _sessions.end()) return;
+
+		SSL_SESSION_free(it->second);
+		_sessions.erase(it);
+	}
+
+	void TLSStream::storeSession()
+	{
+		if (_server || _peer_id.empty()) return;
+
+		SSL_SESSION *session = SSL_get1_session(_ssl);
+		if (session == NULL) return;
+
+		ibrcommon::MutexLock l(_sessions_lock);
+		__removeSession(_peer_id);
+		_sessions[_peer_id] = session;
+	}
+
 	X509 *TLSStream::activate()
 	{
 		long error;
@@ -96,6 +142,13 @@ namespace ibrcommon
 			SSL_set_accept_state(_ssl);
 		} else {
 			SSL_set_connect_state(_ssl);
+
+			/* offer the session of the last connection to this peer */
+			if (!_peer_id.empty()) {
+				ibrcommon::MutexLock sl(_sessions_lock);
+				session_map::const_iterator it = _sessions.find(_peer_id);
+				if (it != _sessions.end()) SSL_set_session(_ssl, it->second);
+			}
 		}
 
 		/* create and assign BIO object */
@@ -122,6 +175,12 @@ namespace ibrcommon
 
 			IBRCOMMON_LOGGER_TAG(TLSStream::TAG, error) << "TLS handshake failed: " << log_error_msg(errcode) << IBRCOMMON_LOGGER_ENDL;
 
+			/* do not offer the session again */
+			if (!_peer_id.empty()) {
+				ibrcommon::MutexLock sl(_sessions_lock);
+				__removeSession(_peer_id);
+			}
+
 			/* cleanup */
 			if (_iostreamBIO != NULL) delete _iostreamBIO;
 			_iostreamBIO = NULL;
@@ -141,10 +200,22 @@ namespace ibrcommon
 			_iostreamBIO = NULL;
 			SSL_free(_ssl);
 			_ssl = NULL;
+			if (!_peer_id.empty()) {
+				ibrcommon::MutexLock sl(_sessions_lock);
+				__removeSession(_peer_id);
+			}
 			std::stringstream ss; ss << "Certificate verification error " << error << ".";
 			throw TLSCertificateVerificationException(ss.str());
 		}
 
+		_resumed = (SSL_session_reused(_ssl) == 1);
+		if (_resumed) {
+			IBRCOMMON_LOGGER_DEBUG_TAG(TLSStream::TAG, 20) << "TLS session resumed" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		/* remember the session for the next connection */
+		storeSession();
+
 		_activated = true;
 
 		return _peer_cert;
@@ -277,6 +348,10 @@ namespace ibrcommon
 			throw ContextCreationException(err_buf);
 		}
 
+		/* keep sessions of clients to allow an abbreviated handshake on reconnects */
+		SSL_CTX_set_session_cache_mode(_ssl_ctx, SSL_SESS_CACHE_SERVER);
+		SSL_CTX_set_session_id_context(_ssl_ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT) - 1);
+
 		/* set verification mode */
 		/* client and server require a valid certificate or the handshake fails */
 		SSL_CTX_set_verify(_ssl_ctx, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, NULL);
@@ -345,6 +420,9 @@ namespace ibrcommon
 		if(!_initialized)
 			return;
 
+		/* cached sessions belong to the old context */
+		clearSessions();
+
 		/* remove the SSL Context */
 		if(_ssl_ctx){
 			SSL_CTX_free(_ssl_ctx);
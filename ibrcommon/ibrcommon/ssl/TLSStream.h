@@ -26,6 +26,8 @@
 #include <iostream>
 #include <memory>
 #include <vector>
+#include <string>
+#include <map>
 #include <openssl/ssl.h>
 #include "ibrcommon/thread/Mutex.h"
 #include "ibrcommon/data/File.h"
@@ -63,6 +65,25 @@ namespace ibrcommon
 		 */
 		void setServer(bool val);
 
+		/**
+		 * Set an identifier of the peer. In client mode the TLS session
+		 * of the last connection to the same peer is resumed, which
+		 * avoids a full handshake on reconnects.
+		 * @param id A unique identifier of the peer, e.g. its node EID
+		 */
+		void setPeer(const std::string &id);
+
+		/**
+		 * Returns true, if the TLS session of a previous connection
+		 * has been resumed during activate()
+		 */
+		bool isResumed() const;
+
+		/**
+		 * Forget all cached client sessions
+		 */
+		static void clearSessions();
+
 		/*!
 		 * \brief Initializes the TLSStream class
 		 * \param certificate The certificate for the private Key
@@ -94,8 +115,9 @@ namespace ibrcommon
 	     */
 	    void close();
 
-		/// The size of the input and output buffers.
-		static const size_t BUFF_SIZE = 5120;
+		/// The size of the input and output buffers. Equal to the maximum
+		/// plaintext of a TLS record, so each write fills a whole record.
+		static const size_t BUFF_SIZE = 16384;
 
 		/*!
 		 * \return the X509 certificate of the peer
@@ -111,6 +133,20 @@ namespace ibrcommon
 	private:
 		std::string log_error_msg(int errnumber);
 
+		/**
+		 * Store the session of this connection for the peer
+		 */
+		void storeSession();
+
+		/**
+		 * Remove the cached session of the peer, the lock has to be held
+		 */
+		static void __removeSession(const std::string &id);
+
+		typedef std::map<std::string, SSL_SESSION*> session_map;
+		static session_map _sessions;
+		static ibrcommon::Mutex _sessions_lock;
+
 		static bool _initialized;
 		/* this second initialized variable is needed, because init() can fail and SSL_library_init() is not reentrant. */
 		static bool _SSL_initialized;
@@ -128,6 +164,10 @@ namespace ibrcommon
 		/* indicates if this node is the server in the underlying tcp connection */
 		bool _server;
 
+		/* identifier of the peer used to resume sessions */
+		std::string _peer_id;
+		bool _resumed;
+
 		static SSL_CTX *_ssl_ctx;
 		SSL *_ssl;
 		X509 *_peer_cert;
@@ -0,0 +1,394 @@
+/*
+ * RingQueue.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_RINGQUEUE_H_
+#define IBRCOMMON_RINGQUEUE_H_
+
+#include "ibrcommon/thread/Queue.h"
+#include "ibrcommon/thread/MutexLock.h"
+#include "ibrcommon/thread/Conditional.h"
+#include "ibrcommon/thread/Thread.h"
+#include <memory>
+#include <stddef.h>
+
+namespace ibrcommon
+{
+	/**
+	 * A bounded multi-producer/multi-consumer queue based on a ring buffer.
+	 * Elements are put into and taken out of the ring without any lock, each
+	 * slot carries a sequence number which tells producers and consumers if
+	 * the slot is free or filled. Only if the queue is empty (or full) the
+	 * calling thread spins and yields for a short while and then sleeps on a
+	 * conditional.
+	 * Waking up sleeping threads takes the lock only if there is a sleeper.
+	 *
+	 * The blocking and abort semantics follow ibrcommon::Queue, but the queue
+	 * has a fixed capacity and push() blocks if the queue is full.
+	 */
+	template <class T>
+	class RingQueue
+	{
+	public:
+		/**
+		 * Create a new queue. The capacity is rounded up to the
+		 * next power of two.
+		 */
+		RingQueue(size_t capacity = 1024)
+		 : _mask(__capacity(capacity) - 1), _seq(NULL), _data(NULL), _head(0), _tail(0), _sleeping(0), _abort(false)
+		{
+			_seq = new volatile size_t[_mask + 1];
+			_data = _alloc.allocate(_mask + 1);
+
+			for (size_t i = 0; i <= _mask; ++i) _seq[i] = i;
+		};
+
+		virtual ~RingQueue()
+		{
+			abort();
+
+			// destroy all remaining elements
+			size_t pos = 0;
+			while (__claim(pos)) __release(pos);
+
+			_alloc.deallocate(_data, _mask + 1);
+			delete[] _seq;
+		};
+
+		/* Test whether container is empty (public member function) */
+		bool empty() const
+		{
+			return __empty();
+		}
+
+		/* Return size (public member function) */
+		size_t size() const
+		{
+			const size_t tail = _tail;
+			const size_t head = _head;
+			return (tail > head) ? (tail - head) : 0;
+		}
+
+		/* Return the number of elements the queue can hold */
+		size_t capacity() const
+		{
+			return _mask + 1;
+		}
+
+		/**
+		 * Insert an element. If the queue is full, this call blocks
+		 * until an element has been removed.
+		 */
+		void push(const T &x) throw (QueueUnblockedException)
+		{
+			for (size_t spin = 0; !__put(x); ++spin)
+			{
+				if (spin < SPIN_LIMIT)
+				{
+					// give other threads the chance to make progress
+					if (spin >= SPIN_BUSY) ibrcommon::Thread::yield();
+					continue;
+				}
+
+				try {
+					ibrcommon::MutexLock l(_cond);
+					__sleep();
+
+					while (__full())
+					{
+						if (_abort) throw QueueUnblockedException(QueueUnblockedException::QUEUE_ABORT, "push(): queue is aborted!");
+						_cond.wait();
+					}
+
+					__wakeup();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException &ex) {
+					__wakeup();
+					throw QueueUnblockedException(ex, "push()");
+				} catch (const QueueUnblockedException&) {
+					__wakeup();
+					throw;
+				}
+			}
+
+			__notify();
+		}
+
+		/**
+		 * Retrieves and removes the head of this queue.
+		 * If the queue is empty an QueueUnblockedException is thrown.
+		 *
+		 * @return The next element of the queue
+		 */
+		T take() throw (QueueUnblockedException)
+		{
+			size_t pos = 0;
+			if (!__claim(pos))
+			{
+				throw QueueUnblockedException(QueueUnblockedException::QUEUE_ABORT, "take(): queue is empty!");
+			}
+
+			return __get(pos);
+		}
+
+		/**
+		 * Retrieves and removes the head of this queue, waiting if necessary up
+		 * to the specified wait time if no elements are present on this queue.
+		 *
+		 * @param timeout A timeout in milliseconds
+		 * @return The next element of the queue
+		 */
+		T poll(size_t timeout = 0) throw (QueueUnblockedException)
+		{
+			size_t pos = 0;
+
+			for (size_t spin = 0; !__claim(pos); ++spin)
+			{
+				if (spin < SPIN_LIMIT)
+				{
+					// give other threads the chance to make progress
+					if (spin >= SPIN_BUSY) ibrcommon::Thread::yield();
+					continue;
+				}
+
+				try {
+					ibrcommon::MutexLock l(_cond);
+					__sleep();
+
+					struct timespec ts;
+					if (timeout > 0) Conditional::gettimeout(timeout, &ts);
+
+					while (__empty())
+					{
+						if (_abort) throw QueueUnblockedException(QueueUnblockedException::QUEUE_ABORT, "poll(): queue is aborted!");
+
+						if (timeout == 0) _cond.wait();
+						else _cond.wait(&ts);
+					}
+
+					__wakeup();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException &ex) {
+					__wakeup();
+					throw QueueUnblockedException(ex, "poll()");
+				} catch (const QueueUnblockedException&) {
+					__wakeup();
+					throw;
+				}
+			}
+
+			return __get(pos);
+		}
+
+		/**
+		 * Unblock all waiting threads. Until reset() is called, calls
+		 * blocking on this queue throw a QueueUnblockedException.
+		 */
+		void abort() throw ()
+		{
+			ibrcommon::MutexLock l(_cond);
+			_abort = true;
+			_cond.signal(true);
+		}
+
+		void reset() throw ()
+		{
+			ibrcommon::MutexLock l(_cond);
+			_abort = false;
+		}
+
+	private:
+		// number of busy retries before a thread yields
+		static const size_t SPIN_BUSY = 16;
+
+		// number of retries before a thread goes to sleep
+		static const size_t SPIN_LIMIT = 64;
+
+		static size_t __capacity(size_t c)
+		{
+			size_t ret = 2;
+			while (ret < c) ret <<= 1;
+			return ret;
+		}
+
+		/**
+		 * Try to put an element into the ring
+		 */
+		bool __put(const T &x)
+		{
+			size_t pos = _tail;
+
+			for (;;)
+			{
+				const size_t idx = pos & _mask;
+				const size_t seq = _seq[idx];
+				__sync_synchronize();
+
+				const ptrdiff_t diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos);
+
+				if (diff == 0)
+				{
+					// the slot is free, try to claim it
+					const size_t cur = __sync_val_compare_and_swap(&_tail, pos, pos + 1);
+					if (cur == pos)
+					{
+						_alloc.construct(_data + idx, x);
+						__sync_synchronize();
+						_seq[idx] = pos + 1;
+						return true;
+					}
+					pos = cur;
+				}
+				else if (diff < 0)
+				{
+					// the queue is full
+					return false;
+				}
+				else
+				{
+					pos = _tail;
+				}
+			}
+		}
+
+		/**
+		 * Try to claim the next filled slot of the ring. The
+		 * element has to be released using __release() afterwards.
+		 */
+		bool __claim(size_t &ret)
+		{
+			size_t pos = _head;
+
+			for (;;)
+			{
+				const size_t idx = pos & _mask;
+				const size_t seq = _seq[idx];
+				__sync_synchronize();
+
+				const ptrdiff_t diff = static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1);
+
+				if (diff == 0)
+				{
+					// the slot is filled, try to claim it
+					const size_t cur = __sync_val_compare_and_swap(&_head, pos, pos + 1);
+					if (cur == pos)
+					{
+						ret = pos;
+						return true;
+					}
+					pos = cur;
+				}
+				else if (diff < 0)
+				{
+					// the queue is empty
+					return false;
+				}
+				else
+				{
+					pos = _head;
+				}
+			}
+		}
+
+		/**
+		 * Destroy the element of a claimed slot and hand the slot
+		 * back to the producers
+		 */
+		void __release(const size_t pos)
+		{
+			const size_t idx = pos & _mask;
+			_alloc.destroy(_data + idx);
+			__sync_synchronize();
+			_seq[idx] = pos + _mask + 1;
+		}
+
+		/**
+		 * Copy the element out of a claimed slot and release it
+		 */
+		T __get(const size_t pos)
+		{
+			T ret(_data[pos & _mask]);
+			__release(pos);
+			__notify();
+			return ret;
+		}
+
+		bool __empty() const
+		{
+			const size_t pos = _head;
+			const size_t seq = _seq[pos & _mask];
+			__sync_synchronize();
+			return (static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos + 1)) < 0;
+		}
+
+		bool __full() const
+		{
+			const size_t pos = _tail;
+			const size_t seq = _seq[pos & _mask];
+			__sync_synchronize();
+			return (static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(pos)) < 0;
+		}
+
+		/**
+		 * Announce a sleeping thread, the lock has to be held. The full
+		 * barrier orders the announcement before the following check of
+		 * the ring state.
+		 */
+		void __sleep()
+		{
+			__sync_fetch_and_add(&_sleeping, 1);
+		}
+
+		void __wakeup()
+		{
+			__sync_fetch_and_sub(&_sleeping, 1);
+		}
+
+		/**
+		 * Wake-up sleeping threads after the ring has been changed
+		 */
+		void __notify()
+		{
+			__sync_synchronize();
+			if (_sleeping == 0) return;
+
+			ibrcommon::MutexLock l(_cond);
+			_cond.signal(true);
+		}
+
+		// the ring is not copyable
+		RingQueue(const RingQueue&);
+		RingQueue& operator=(const RingQueue&);
+
+		const size_t _mask;
+		volatile size_t *_seq;
+		T *_data;
+		std::allocator<T> _alloc;
+
+		// producer and consumer positions on separate cache lines
+		char _pad0[64];
+		volatile size_t _head;
+		char _pad1[64];
+		volatile size_t _tail;
+		char _pad2[64];
+
+		volatile size_t _sleeping;
+		bool _abort;
+		ibrcommon::Conditional _cond;
+	};
+}
+
+#endif /* IBRCOMMON_RINGQUEUE_H_ */
@@ -21,12 +21,9 @@
 
 #include "ibrcommon/config.h"
 #include "ibrcommon/thread/Timer.h"
-#include "ibrcommon/thread/MutexLock.h"
+#include "ibrcommon/thread/TimerService.h"
 
-#include <iostream>
-#include <queue>
-#include <utility>
-#include <sstream>
+#include <time.h>
 
 namespace ibrcommon
 {
@@ -43,110 +40,53 @@ namespace ibrcommon
 	Timer::Timer(TimerCallback &callback, size_t timeout)
 	 : _state(TIMER_UNSET), _callback(callback), _timeout(timeout * 1000)
 	{
+		// make sure the service is constructed before and thus
+		// destroyed after any static object owning a timer
+		TimerService::getInstance();
 	}
 
 	Timer::~Timer()
 	{
 		stop();
-		join();
 	}
 
-	void Timer::__cancellation() throw ()
+	void Timer::start() throw (ThreadException)
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_CANCELLED);
-		_state.abort();
+		TimerService::getInstance().start(*this);
 	}
 
-	void Timer::set(size_t timeout)
+	void Timer::stop() throw ()
 	{
-		MutexLock l(_state);
-		_timeout = timeout * 1000;
-		_state.setState(TIMER_RESET);
+		TimerService::getInstance().stop(*this);
 	}
 
-	void Timer::reset()
+	void Timer::join() throw (ThreadException)
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_RESET);
+		TimerService::getInstance().join(*this);
 	}
 
-	void Timer::pause()
+	bool Timer::isRunning()
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_STOPPED);
+		return TimerService::getInstance().isActive(*this);
 	}
 
-	size_t Timer::getTimeout() const
+	void Timer::set(size_t timeout)
 	{
-		return _timeout / 1000;
+		TimerService::getInstance().set(*this, timeout * 1000);
 	}
 
-	void Timer::run() throw ()
+	void Timer::reset()
 	{
-		MutexLock l(_state);
-		_state.setState(TIMER_RUNNING);
-
-		while (_state.ifState(TIMER_RUNNING) || _state.ifState(TIMER_STOPPED))
-		{
-			try {
-				if(_state.ifState(TIMER_RUNNING))
-				{
-					if(_timeout > 0)
-					{
-						_state.wait(_timeout);
-					}
-					else
-					{
-						throw ibrcommon::Conditional::ConditionalAbortException(ibrcommon::Conditional::ConditionalAbortException::COND_ABORT);
-					}
-				}
-				else
-				{
-					_state.wait();
-				}
-
-				// got signal, check for reset request
-				if (_state.ifState(TIMER_RESET))
-				{
-					_state.setState(TIMER_RUNNING);
-				}
-				else if(!_state.ifState(TIMER_STOPPED))
-				{
-					// stop the timer
-					_state.setState(TIMER_CANCELLED);
-				}
-			}
-			catch (const ibrcommon::Conditional::ConditionalAbortException &ex)
-			{
-				switch (ex.reason)
-				{
-					case ibrcommon::Conditional::ConditionalAbortException::COND_TIMEOUT:
-					{
-						try
-						{
-							// timeout exceeded, call callback method
-							_timeout = _callback.timeout(this) * 1000;
-							_state.setState(TIMER_RUNNING);
-						}
-						catch(const StopTimerException &ex)
-						{
-							// stop the timer
-							_state.setState(TIMER_STOPPED);
-						}
-						break;
-					}
+		TimerService::getInstance().reset(*this);
+	}
 
-					case ibrcommon::Conditional::ConditionalAbortException::COND_ABORT:
-					case ibrcommon::Conditional::ConditionalAbortException::COND_ERROR:
-					{
-						_state.setState(TIMER_CANCELLED);
-						return;
-					}
-				}
-			}
+	void Timer::pause()
+	{
+		TimerService::getInstance().pause(*this);
+	}
 
-			yield();
-		}
+	size_t Timer::getTimeout() const
+	{
+		return _timeout / 1000;
 	}
 }
@@ -24,6 +24,7 @@
 
 #include "ibrcommon/thread/Thread.h"
 #include "ibrcommon/thread/Conditional.h"
+#include "ibrcommon/thread/TimerWheel.h"
 #include <map>
 #include <set>
 
@@ -48,7 +49,12 @@ namespace ibrcommon
 		virtual size_t timeout(Timer *timer) = 0;
 	};
 
-	class Timer : public JoinableThread
+	/**
+	 * A timer calls the timeout() method of its callback once the timeout
+	 * has been exceeded. All timers are driven by the thread of the shared
+	 * TimerService, thus creating a timer does not create a thread.
+	 */
+	class Timer : public TimerWheel::Entry
 	{
 	public:
 		typedef size_t time_t;
@@ -62,6 +68,29 @@ namespace ibrcommon
 
 		virtual ~Timer();
 
+		/**
+		 * Start the timer. A timer with a timeout of zero
+		 * does not start.
+		 */
+		void start() throw (ThreadException);
+
+		/**
+		 * This method stops the timer. If the callback is running
+		 * in the meantime, the call blocks until it has returned.
+		 */
+		void stop() throw ();
+
+		/**
+		 * Wait until a running callback has returned.
+		 */
+		void join() throw (ThreadException);
+
+		/**
+		 * Returns true if the timer is started and not stopped yet.
+		 * A paused timer is still running.
+		 */
+		bool isRunning();
+
 		void set(size_t timeout);
 
 		/**
@@ -80,21 +109,18 @@ namespace ibrcommon
 		 */
 		size_t getTimeout() const;
 
-	protected:
-		void run() throw ();
-		void __cancellation() throw ();
-
 	private:
+		friend class TimerService;
+
 		enum TIMER_STATE
 		{
 			TIMER_UNSET = 0,
 			TIMER_RUNNING = 1,
-			TIMER_RESET = 2,
-			TIMER_STOPPED = 3,
-			TIMER_CANCELLED = 4
+			TIMER_STOPPED = 2,
+			TIMER_CANCELLED = 3
 		};
 
-		StatefulConditional<Timer::TIMER_STATE, TIMER_STOPPED> _state;
+		TIMER_STATE _state;
 		TimerCallback &_callback;
 		size_t _timeout;
 	public:
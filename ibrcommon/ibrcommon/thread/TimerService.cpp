@@ -0,0 +1,266 @@
+/*
+ * TimerService.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/config.h"
+#include "ibrcommon/thread/TimerService.h"
+#include "ibrcommon/thread/Timer.h"
+#include "ibrcommon/thread/MutexLock.h"
+#include "ibrcommon/MonotonicClock.h"
+
+namespace ibrcommon
+{
+	TimerService& TimerService::getInstance()
+	{
+		static TimerService instance;
+		return instance;
+	}
+
+	TimerWheel::tick_t TimerService::getTicks()
+	{
+		struct timespec ts;
+		MonotonicClock::gettime(ts);
+		return (TimerWheel::tick_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+	}
+
+	TimerService::TimerService()
+	 : _wheel(getTicks()), _current(NULL), _wakeup(TimerWheel::NEVER), _waiting(0), _shutdown(false)
+	{
+	}
+
+	TimerService::~TimerService()
+	{
+		JoinableThread::stop();
+		JoinableThread::join();
+	}
+
+	size_t TimerService::size()
+	{
+		MutexLock l(_cond);
+		return _wheel.size();
+	}
+
+	void TimerService::__cancellation() throw ()
+	{
+		MutexLock l(_cond);
+		_shutdown = true;
+		_cond.abort();
+	}
+
+	void TimerService::run() throw ()
+	{
+		MutexLock l(_cond);
+
+		while (!_shutdown)
+		{
+			_wheel.update(getTicks());
+
+			// fire all expired timers
+			TimerWheel::Entry *e = NULL;
+			while ((e = _wheel.get()) != NULL)
+			{
+				__fire(static_cast<Timer&>(*e));
+			}
+
+			try {
+				const TimerWheel::tick_t next = _wheel.next();
+
+				if (next == TimerWheel::NEVER)
+				{
+					// sleep until a timer is scheduled
+					_wakeup = TimerWheel::NEVER;
+					_cond.wait();
+				}
+				else
+				{
+					_wakeup = _wheel.now() + next;
+
+					const TimerWheel::tick_t now = getTicks();
+					if (_wakeup > now) _cond.wait(static_cast<size_t>(_wakeup - now));
+				}
+			} catch (const Conditional::ConditionalAbortException &ex) {
+				if (ex.reason != Conditional::ConditionalAbortException::COND_TIMEOUT) return;
+			}
+		}
+	}
+
+	void TimerService::__fire(Timer &t)
+	{
+		if (t._state != Timer::TIMER_RUNNING) return;
+
+		size_t timeout = 0;
+		bool paused = false;
+
+		// run the callback without holding the lock
+		_current = &t;
+		_cond.leave();
+
+		try {
+			timeout = t._callback.timeout(&t);
+		} catch (const Timer::StopTimerException&) {
+			paused = true;
+		}
+
+		_cond.enter();
+
+		// if the timer has been stopped or destroyed by the callback
+		// the current pointer has been cleared
+		if (_current != &t)
+		{
+			if (_waiting > 0) _cond.signal(true);
+			return;
+		}
+		_current = NULL;
+
+		// apply the new timeout if the timer has not been modified
+		// during the callback
+		if ((t._state == Timer::TIMER_RUNNING) && !t.isPending())
+		{
+			if (paused)
+			{
+				t._state = Timer::TIMER_STOPPED;
+			}
+			else
+			{
+				t._timeout = timeout * 1000;
+
+				if (t._timeout > 0) schedule(t);
+				else t._state = Timer::TIMER_CANCELLED;
+			}
+		}
+
+		// wake-up threads waiting for this callback
+		if (_waiting > 0) _cond.signal(true);
+	}
+
+	void TimerService::schedule(Timer &t)
+	{
+		const TimerWheel::tick_t expires = getTicks() + t._timeout;
+		_wheel.add(t, expires);
+
+		// wake-up the service thread if this timer expires earlier
+		if (expires < _wakeup) _cond.signal(true);
+	}
+
+	void TimerService::__wait(Timer &t)
+	{
+		// never wait for ourselves
+		if (JoinableThread::isRunning() && equal(tid, pthread_self())) return;
+
+		++_waiting;
+
+		try {
+			while (_current == &t)
+			{
+				_cond.wait();
+			}
+		} catch (const Conditional::ConditionalAbortException&) {
+			// the service has been shut down
+		}
+
+		--_waiting;
+	}
+
+	void TimerService::start(Timer &t)
+	{
+		MutexLock l(_cond);
+
+		// start the service thread with the first timer
+		JoinableThread::start();
+
+		if ((t._state == Timer::TIMER_RUNNING) || (t._state == Timer::TIMER_STOPPED)) return;
+
+		if (t._timeout == 0)
+		{
+			t._state = Timer::TIMER_CANCELLED;
+			return;
+		}
+
+		t._state = Timer::TIMER_RUNNING;
+		schedule(t);
+	}
+
+	void TimerService::set(Timer &t, size_t timeout)
+	{
+		MutexLock l(_cond);
+		t._timeout = timeout;
+
+		if ((t._state != Timer::TIMER_RUNNING) && (t._state != Timer::TIMER_STOPPED)) return;
+
+		if (t._timeout == 0)
+		{
+			_wheel.remove(t);
+			t._state = Timer::TIMER_CANCELLED;
+			return;
+		}
+
+		t._state = Timer::TIMER_RUNNING;
+		schedule(t);
+	}
+
+	void TimerService::reset(Timer &t)
+	{
+		MutexLock l(_cond);
+
+		if ((t._state != Timer::TIMER_RUNNING) && (t._state != Timer::TIMER_STOPPED)) return;
+		if (t._timeout == 0) return;
+
+		t._state = Timer::TIMER_RUNNING;
+		schedule(t);
+	}
+
+	void TimerService::pause(Timer &t)
+	{
+		MutexLock l(_cond);
+
+		if (t._state != Timer::TIMER_RUNNING) return;
+
+		_wheel.remove(t);
+		t._state = Timer::TIMER_STOPPED;
+	}
+
+	void TimerService::stop(Timer &t)
+	{
+		MutexLock l(_cond);
+
+		_wheel.remove(t);
+		t._state = Timer::TIMER_CANCELLED;
+
+		if ((_current == &t) && JoinableThread::isRunning() && equal(tid, pthread_self()))
+		{
+			// stopped within its own callback
+			_current = NULL;
+		}
+		else
+		{
+			__wait(t);
+		}
+	}
+
+	void TimerService::join(Timer &t)
+	{
+		MutexLock l(_cond);
+		__wait(t);
+	}
+
+	bool TimerService::isActive(Timer &t)
+	{
+		MutexLock l(_cond);
+		return (t._state == Timer::TIMER_RUNNING) || (t._state == Timer::TIMER_STOPPED);
+	}
+} /* namespace ibrcommon */
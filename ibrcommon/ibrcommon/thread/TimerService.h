@@ -0,0 +1,127 @@
+/*
+ * TimerService.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_TIMERSERVICE_H_
+#define IBRCOMMON_TIMERSERVICE_H_
+
+#include "ibrcommon/thread/Thread.h"
+#include "ibrcommon/thread/Conditional.h"
+#include "ibrcommon/thread/TimerWheel.h"
+
+namespace ibrcommon
+{
+	class Timer;
+
+	/**
+	 * The timer service drives all instances of ibrcommon::Timer with
+	 * a single thread. Pending timers are kept in a hierarchical timing
+	 * wheel with a resolution of one millisecond. The thread is started
+	 * with the first scheduled timer and sleeps until the next timer
+	 * expires.
+	 */
+	class TimerService : public JoinableThread
+	{
+	public:
+		virtual ~TimerService();
+
+		/**
+		 * Returns the process-wide instance of the timer service
+		 */
+		static TimerService& getInstance();
+
+		/**
+		 * Returns the current time of the service clock in milliseconds
+		 */
+		static TimerWheel::tick_t getTicks();
+
+		/**
+		 * Returns the number of scheduled timers
+		 */
+		size_t size();
+
+	protected:
+		void run() throw ();
+		void __cancellation() throw ();
+
+	private:
+		friend class Timer;
+
+		TimerService();
+
+		/**
+		 * Start a timer with its current timeout
+		 */
+		void start(Timer &t);
+
+		/**
+		 * Set a new timeout in milliseconds and restart the timer
+		 * if it is active
+		 */
+		void set(Timer &t, size_t timeout);
+
+		/**
+		 * Restart the countdown of an active timer
+		 */
+		void reset(Timer &t);
+
+		/**
+		 * Suspend the timer until reset() or set() is called
+		 */
+		void pause(Timer &t);
+
+		/**
+		 * Cancel the timer and wait until a running callback has returned
+		 */
+		void stop(Timer &t);
+
+		/**
+		 * Wait until a running callback of the timer has returned
+		 */
+		void join(Timer &t);
+
+		/**
+		 * Returns true if the timer is scheduled or paused
+		 */
+		bool isActive(Timer &t);
+
+		/**
+		 * Put the timer into the wheel, the lock has to be held
+		 */
+		void schedule(Timer &t);
+
+		/**
+		 * Wait for a running callback, the lock has to be held
+		 */
+		void __wait(Timer &t);
+
+		/**
+		 * Run the callback of an expired timer, the lock has to be held
+		 */
+		void __fire(Timer &t);
+
+		Conditional _cond;
+		TimerWheel _wheel;
+		Timer *_current;
+		TimerWheel::tick_t _wakeup;
+		size_t _waiting;
+		bool _shutdown;
+	};
+} /* namespace ibrcommon */
+
+#endif /* IBRCOMMON_TIMERSERVICE_H_ */
@@ -0,0 +1,304 @@
+/*
+ * TimerWheel.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrcommon/config.h"
+#include "ibrcommon/thread/TimerWheel.h"
+
+namespace ibrcommon
+{
+	const TimerWheel::tick_t TimerWheel::NEVER = ~((TimerWheel::tick_t)0);
+
+	TimerWheel::Entry::Entry()
+	 : _prev(NULL), _next(NULL), _list(NULL), _expires(0)
+	{
+	}
+
+	TimerWheel::Entry::~Entry()
+	{
+	}
+
+	bool TimerWheel::Entry::isPending() const
+	{
+		return (_list != NULL);
+	}
+
+	TimerWheel::tick_t TimerWheel::Entry::getExpiry() const
+	{
+		return _expires;
+	}
+
+	TimerWheel::TimerWheel(tick_t now)
+	 : _now(now), _size(0)
+	{
+		for (int w = 0; w < WHEEL_NUM; ++w)
+		{
+			for (int s = 0; s < WHEEL_LEN; ++s)
+			{
+				_wheel[w][s].head = NULL;
+				_wheel[w][s].tail = NULL;
+			}
+			_pending[w] = 0;
+		}
+
+		_expired.head = NULL;
+		_expired.tail = NULL;
+	}
+
+	TimerWheel::~TimerWheel()
+	{
+	}
+
+	void TimerWheel::append(List &l, Entry &e)
+	{
+		e._list = &l;
+		e._next = NULL;
+		e._prev = l.tail;
+
+		if (l.tail == NULL) l.head = &e;
+		else l.tail->_next = &e;
+
+		l.tail = &e;
+	}
+
+	void TimerWheel::unlink(List &l, Entry &e)
+	{
+		if (e._prev == NULL) l.head = e._next;
+		else e._prev->_next = e._next;
+
+		if (e._next == NULL) l.tail = e._prev;
+		else e._next->_prev = e._prev;
+
+		e._prev = NULL;
+		e._next = NULL;
+		e._list = NULL;
+	}
+
+	void TimerWheel::concat(List &dst, List &src)
+	{
+		if (src.head == NULL) return;
+
+		if (dst.tail == NULL) dst.head = src.head;
+		else
+		{
+			dst.tail->_next = src.head;
+			src.head->_prev = dst.tail;
+		}
+
+		dst.tail = src.tail;
+
+		// re-assign the list of all moved entries
+		for (Entry *e = src.head; e != NULL; e = e->_next)
+		{
+			e->_list = &dst;
+		}
+
+		src.head = NULL;
+		src.tail = NULL;
+	}
+
+	int TimerWheel::fls(tick_t v)
+	{
+		int r = 0;
+		while (v) { v >>= 1; ++r; }
+		return r;
+	}
+
+	int TimerWheel::ctz(uint64_t v)
+	{
+#if defined(__GNUC__)
+		return __builtin_ctzll(v);
+#else
+		int r = 0;
+		while (!(v & 1)) { v >>= 1; ++r; }
+		return r;
+#endif
+	}
+
+	uint64_t TimerWheel::rotl(uint64_t v, int c)
+	{
+		if (!(c &= (sizeof(v) * 8 - 1))) return v;
+		return (v << c) | (v >> (sizeof(v) * 8 - c));
+	}
+
+	uint64_t TimerWheel::rotr(uint64_t v, int c)
+	{
+		if (!(c &= (sizeof(v) * 8 - 1))) return v;
+		return (v >> c) | (v << (sizeof(v) * 8 - c));
+	}
+
+	void TimerWheel::schedule(Entry &e)
+	{
+		if (e._expires > _now)
+		{
+			const tick_t rem = e._expires - _now;
+
+			// select the level according to the remaining time
+			const int wheel = (fls(rem < WHEEL_MAX ? rem : WHEEL_MAX) - 1) / WHEEL_BIT;
+
+			// entries on higher levels are placed one slot earlier, they
+			// get cascaded into the lower levels once this slot is reached
+			const int slot = static_cast<int>(WHEEL_MASK & ((e._expires >> (wheel * WHEEL_BIT)) - (wheel ? 1 : 0)));
+
+			append(_wheel[wheel][slot], e);
+			_pending[wheel] |= ((uint64_t)1 << slot);
+		}
+		else
+		{
+			append(_expired, e);
+		}
+	}
+
+	void TimerWheel::add(Entry &e, tick_t expires)
+	{
+		remove(e);
+
+		e._expires = expires;
+		schedule(e);
+		++_size;
+	}
+
+	void TimerWheel::remove(Entry &e)
+	{
+		if (e._list == NULL) return;
+
+		List &l = *static_cast<List*>(e._list);
+		unlink(l, e);
+
+		// clear the pending bit if the slot is empty now
+		if ((l.head == NULL) && (&l != &_expired))
+		{
+			const size_t offset = &l - &_wheel[0][0];
+			_pending[offset / WHEEL_LEN] &= ~((uint64_t)1 << (offset % WHEEL_LEN));
+		}
+
+		--_size;
+	}
+
+	void TimerWheel::update(tick_t now)
+	{
+		if (now <= _now) return;
+
+		tick_t elapsed = now - _now;
+		List todo;
+		todo.head = NULL;
+		todo.tail = NULL;
+
+		for (int wheel = 0; wheel < WHEEL_NUM; ++wheel)
+		{
+			uint64_t pending;
+
+			if ((elapsed >> (wheel * WHEEL_BIT)) > WHEEL_MASK)
+			{
+				// a full rotation elapsed on this level
+				pending = ~((uint64_t)0);
+			}
+			else
+			{
+				const int e = static_cast<int>(WHEEL_MASK & (elapsed >> (wheel * WHEEL_BIT)));
+				const int oslot = static_cast<int>(WHEEL_MASK & (_now >> (wheel * WHEEL_BIT)));
+				const int nslot = static_cast<int>(WHEEL_MASK & (now >> (wheel * WHEEL_BIT)));
+
+				// all slots passed between the old and the new position
+				pending = rotl(((uint64_t)1 << e) - 1, oslot);
+				pending |= rotr(rotl(((uint64_t)1 << e) - 1, nslot), e);
+				pending |= ((uint64_t)1 << nslot);
+			}
+
+			while (pending & _pending[wheel])
+			{
+				const int slot = ctz(pending & _pending[wheel]);
+				concat(todo, _wheel[wheel][slot]);
+				_pending[wheel] &= ~((uint64_t)1 << slot);
+			}
+
+			// stop here if this level did not wrap around
+			if (!(pending & 0x1)) break;
+
+			// the next level has to tick at least once
+			const tick_t min_elapsed = ((tick_t)WHEEL_LEN << (wheel * WHEEL_BIT));
+			if (elapsed < min_elapsed) elapsed = min_elapsed;
+		}
+
+		_now = now;
+
+		// re-schedule all collected entries, expired ones are
+		// moved into the expired list, all others are cascaded
+		while (todo.head != NULL)
+		{
+			Entry &e = *todo.head;
+			unlink(todo, e);
+			schedule(e);
+		}
+	}
+
+	TimerWheel::Entry* TimerWheel::get()
+	{
+		if (_expired.head == NULL) return NULL;
+
+		Entry *e = _expired.head;
+		unlink(_expired, *e);
+		--_size;
+
+		return e;
+	}
+
+	TimerWheel::tick_t TimerWheel::next() const
+	{
+		if (_expired.head != NULL) return 0;
+
+		tick_t timeout = NEVER;
+		tick_t relmask = 0;
+
+		for (int wheel = 0; wheel < WHEEL_NUM; ++wheel)
+		{
+			if (_pending[wheel])
+			{
+				const int slot = static_cast<int>(WHEEL_MASK & (_now >> (wheel * WHEEL_BIT)));
+
+				// higher levels are one rotation in the future
+				tick_t t = (tick_t)(ctz(rotr(_pending[wheel], slot)) + (wheel ? 1 : 0)) << (wheel * WHEEL_BIT);
+
+				// reduce by the progress of the lower levels
+				t -= (relmask & _now);
+
+				if (t < timeout) timeout = t;
+			}
+
+			relmask <<= WHEEL_BIT;
+			relmask |= WHEEL_MASK;
+		}
+
+		return timeout;
+	}
+
+	TimerWheel::tick_t TimerWheel::now() const
+	{
+		return _now;
+	}
+
+	bool TimerWheel::empty() const
+	{
+		return (_size == 0);
+	}
+
+	size_t TimerWheel::size() const
+	{
+		return _size;
+	}
+} /* namespace ibrcommon */
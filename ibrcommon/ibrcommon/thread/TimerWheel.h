@@ -0,0 +1,153 @@
+/*
+ * TimerWheel.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef IBRCOMMON_TIMERWHEEL_H_
+#define IBRCOMMON_TIMERWHEEL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace ibrcommon
+{
+	/**
+	 * A hierarchical timing wheel. Each level consists of 64 slots and
+	 * covers 64 times the range of the level below. Entries are kept in
+	 * intrusive lists, so adding and removing an entry is O(1). Entries
+	 * whose expiry lies beyond the range of the top level are placed into
+	 * the top level and re-scheduled when their slot comes up.
+	 *
+	 * The wheel is not thread-safe. The owner has to serialize all calls.
+	 */
+	class TimerWheel
+	{
+	public:
+		typedef uint64_t tick_t;
+
+		/**
+		 * Returned by next() if no entry is scheduled.
+		 */
+		static const tick_t NEVER;
+
+		class Entry
+		{
+		public:
+			Entry();
+			virtual ~Entry();
+
+			/**
+			 * Returns true, if this entry is scheduled or expired
+			 * but not yet collected with get().
+			 */
+			bool isPending() const;
+
+			/**
+			 * Returns the tick this entry expires.
+			 */
+			tick_t getExpiry() const;
+
+		private:
+			friend class TimerWheel;
+
+			Entry *_prev;
+			Entry *_next;
+			void *_list;
+			tick_t _expires;
+		};
+
+		TimerWheel(tick_t now = 0);
+		virtual ~TimerWheel();
+
+		/**
+		 * Schedule an entry to expire at the given tick. If the
+		 * entry is already scheduled, it is moved.
+		 */
+		void add(Entry &e, tick_t expires);
+
+		/**
+		 * Remove an entry from the wheel. Does nothing if the
+		 * entry is not pending.
+		 */
+		void remove(Entry &e);
+
+		/**
+		 * Advance the wheel to the given tick. All entries expired
+		 * until then can be collected using get() afterwards.
+		 */
+		void update(tick_t now);
+
+		/**
+		 * Returns the next expired entry and removes it from
+		 * the wheel or NULL if there is none.
+		 */
+		Entry* get();
+
+		/**
+		 * Returns the number of ticks until the wheel needs to be
+		 * updated again or NEVER if no entry is scheduled.
+		 */
+		tick_t next() const;
+
+		/**
+		 * Returns the current tick of the wheel.
+		 */
+		tick_t now() const;
+
+		/**
+		 * Returns true if no entry is pending.
+		 */
+		bool empty() const;
+
+		/**
+		 * Returns the number of pending entries.
+		 */
+		size_t size() const;
+
+	private:
+		static const int WHEEL_BIT = 6;
+		static const int WHEEL_NUM = 4;
+		static const int WHEEL_LEN = (1 << WHEEL_BIT);
+		static const tick_t WHEEL_MASK = (WHEEL_LEN - 1);
+		static const tick_t WHEEL_MAX = ((tick_t)1 << (WHEEL_BIT * WHEEL_NUM)) - 1;
+
+		struct List
+		{
+			Entry *head;
+			Entry *tail;
+		};
+
+		static void append(List &l, Entry &e);
+		static void unlink(List &l, Entry &e);
+		static void concat(List &dst, List &src);
+
+		static int fls(tick_t v);
+		static int ctz(uint64_t v);
+		static uint64_t rotl(uint64_t v, int c);
+		static uint64_t rotr(uint64_t v, int c);
+
+		void schedule(Entry &e);
+
+		tick_t _now;
+		List _wheel[WHEEL_NUM][WHEEL_LEN];
+		uint64_t _pending[WHEEL_NUM];
+		List _expired;
+		size_t _size;
+	};
+} /* namespace ibrcommon */
+
+#endif /* IBRCOMMON_TIMERWHEEL_H_ */
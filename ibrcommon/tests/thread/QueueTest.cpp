@@ -23,6 +23,8 @@
 #include <stdlib.h>
 #include <iostream>
 #include <unistd.h>
+#include <list>
+#include <ibrcommon/TimeMeasurement.h>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (QueueTest);
 
@@ -147,3 +149,268 @@ void QueueTest::tsq_test05()
 		//CPPUNIT_ASSERT_EQUAL((size_t)2, t._count);
 	}
 }
+
+void QueueTest::ringTest()
+{
+	// the capacity is rounded up to a power of two
+	ibrcommon::RingQueue<int> queue(5);
+	CPPUNIT_ASSERT_EQUAL((size_t)8, queue.capacity());
+	CPPUNIT_ASSERT(queue.empty());
+
+	for (int i = 0; i < 8; ++i) queue.push(i);
+	CPPUNIT_ASSERT_EQUAL((size_t)8, queue.size());
+
+	// elements are returned in order
+	for (int i = 0; i < 8; ++i)
+	{
+		CPPUNIT_ASSERT_EQUAL(i, queue.take());
+	}
+	CPPUNIT_ASSERT(queue.empty());
+
+	// take() does not block on an empty queue
+	CPPUNIT_ASSERT_THROW(queue.take(), ibrcommon::QueueUnblockedException);
+
+	// poll() returns with a timeout
+	try {
+		queue.poll(10);
+		CPPUNIT_FAIL("poll() should time out");
+	} catch (const ibrcommon::QueueUnblockedException &ex) {
+		CPPUNIT_ASSERT_EQUAL(ibrcommon::QueueUnblockedException::QUEUE_TIMEOUT, ex.reason);
+	}
+
+	// wrap around the ring several times
+	for (int i = 0; i < 100; ++i)
+	{
+		queue.push(i);
+		queue.push(i + 1);
+		CPPUNIT_ASSERT_EQUAL(i, queue.poll());
+		CPPUNIT_ASSERT_EQUAL(i + 1, queue.poll());
+	}
+}
+
+namespace
+{
+	class RingConsumer : public ibrcommon::JoinableThread
+	{
+	public:
+		RingConsumer(ibrcommon::RingQueue<std::string> &queue)
+		 : _queue(queue), _count(0), _aborted(false) { }
+
+		~RingConsumer() { join(); }
+
+		void run() throw ()
+		{
+			try {
+				while (true)
+				{
+					_queue.poll();
+					_count++;
+				}
+			} catch (const ibrcommon::QueueUnblockedException &ex) {
+				_aborted = (ex.reason == ibrcommon::QueueUnblockedException::QUEUE_ABORT);
+			}
+		}
+
+		void __cancellation() throw () { }
+
+		ibrcommon::RingQueue<std::string> &_queue;
+		size_t _count;
+		bool _aborted;
+	};
+
+	class Element
+	{
+	public:
+		Element(int &counter) : _counter(counter) { ++_counter; }
+		Element(const Element &other) : _counter(other._counter) { ++_counter; }
+		~Element() { --_counter; }
+
+	private:
+		Element& operator=(const Element&);
+		int &_counter;
+	};
+}
+
+void QueueTest::ringAbortTest()
+{
+	ibrcommon::RingQueue<std::string> queue(16);
+	RingConsumer c(queue);
+	c.start();
+
+	queue.push("hallo");
+	queue.push("welt");
+
+	// give the consumer the chance to go to sleep
+	ibrcommon::Thread::sleep(50);
+
+	queue.abort();
+	c.join();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, c._count);
+	CPPUNIT_ASSERT(c._aborted);
+
+	// a full queue does not block after abort
+	for (int i = 0; i < 16; ++i) queue.push("data");
+	CPPUNIT_ASSERT_THROW(queue.push("data"), ibrcommon::QueueUnblockedException);
+
+	// the queue is usable again after reset
+	queue.reset();
+	CPPUNIT_ASSERT_EQUAL(std::string("data"), queue.poll());
+}
+
+void QueueTest::ringElementTest()
+{
+	int counter = 0;
+
+	{
+		// elements without a default constructor
+		ibrcommon::RingQueue<Element> queue(4);
+
+		queue.push(Element(counter));
+		queue.push(Element(counter));
+		queue.push(Element(counter));
+		CPPUNIT_ASSERT_EQUAL(3, counter);
+
+		queue.take();
+		CPPUNIT_ASSERT_EQUAL(2, counter);
+	}
+
+	// remaining elements are destroyed with the queue
+	CPPUNIT_ASSERT_EQUAL(0, counter);
+}
+
+namespace
+{
+	template <class Q>
+	class BenchProducer : public ibrcommon::JoinableThread
+	{
+	public:
+		BenchProducer(Q &queue, size_t first, size_t count)
+		 : _queue(queue), _first(first), _count(count) { }
+
+		~BenchProducer() { join(); }
+
+		void run() throw ()
+		{
+			for (size_t i = _first; i < (_first + _count); ++i)
+			{
+				_queue.push(i);
+			}
+		}
+
+		void __cancellation() throw () { }
+
+	private:
+		Q &_queue;
+		const size_t _first;
+		const size_t _count;
+	};
+
+	template <class Q>
+	class BenchConsumer : public ibrcommon::JoinableThread
+	{
+	public:
+		BenchConsumer(Q &queue)
+		 : _queue(queue), _count(0), _sum(0) { }
+
+		~BenchConsumer() { join(); }
+
+		void run() throw ()
+		{
+			try {
+				while (true)
+				{
+					// zero marks the end of the stream
+					const size_t value = _queue.poll();
+					if (value == 0) return;
+
+					_count++;
+					_sum += value;
+				}
+			} catch (const ibrcommon::QueueUnblockedException&) {
+			}
+		}
+
+		void __cancellation() throw () { }
+
+		Q &_queue;
+		size_t _count;
+		size_t _sum;
+	};
+
+	/**
+	 * Move items through a queue with several producers and consumers
+	 * and return the throughput in items per second
+	 */
+	template <class Q>
+	double mpmc(Q &queue, size_t producers, size_t consumers, size_t items)
+	{
+		std::list<BenchProducer<Q>*> p;
+		std::list<BenchConsumer<Q>*> c;
+
+		for (size_t i = 0; i < consumers; ++i)
+			c.push_back(new BenchConsumer<Q>(queue));
+
+		for (size_t i = 0; i < producers; ++i)
+			p.push_back(new BenchProducer<Q>(queue, 1 + i * items, items));
+
+		ibrcommon::TimeMeasurement tm;
+		tm.start();
+
+		for (typename std::list<BenchConsumer<Q>*>::iterator it = c.begin(); it != c.end(); ++it)
+			(*it)->start();
+
+		for (typename std::list<BenchProducer<Q>*>::iterator it = p.begin(); it != p.end(); ++it)
+			(*it)->start();
+
+		for (typename std::list<BenchProducer<Q>*>::iterator it = p.begin(); it != p.end(); ++it)
+			delete (*it);
+
+		// stop all consumers
+		for (size_t i = 0; i < consumers; ++i) queue.push(0);
+
+		size_t count = 0;
+		size_t sum = 0;
+
+		for (typename std::list<BenchConsumer<Q>*>::iterator it = c.begin(); it != c.end(); ++it)
+		{
+			(*it)->join();
+			count += (*it)->_count;
+			sum += (*it)->_sum;
+			delete (*it);
+		}
+
+		tm.stop();
+
+		// every item has been received exactly once
+		const size_t total = producers * items;
+		CPPUNIT_ASSERT_EQUAL(total, count);
+		CPPUNIT_ASSERT_EQUAL((total * (total + 1)) / 2, sum);
+
+		return (static_cast<double>(total) * 1000.0) / (tm.getMilliseconds() + 1.0);
+	}
+}
+
+void QueueTest::mpmcBenchmark()
+{
+	const size_t items = 50000;
+	const size_t setups[][2] = { { 1, 1 }, { 4, 1 }, { 4, 4 } };
+
+	std::cout << std::endl;
+
+	for (size_t i = 0; i < 3; ++i)
+	{
+		const size_t producers = setups[i][0];
+		const size_t consumers = setups[i][1];
+
+		ibrcommon::Queue<size_t> queue;
+		const double locked = mpmc(queue, producers, consumers, items);
+
+		ibrcommon::RingQueue<size_t> ring(1024);
+		const double ringed = mpmc(ring, producers, consumers, items);
+
+		std::cout << producers << " producer(s) / " << consumers << " consumer(s): "
+				<< static_cast<size_t>(locked) << " items/s with Queue, "
+				<< static_cast<size_t>(ringed) << " items/s with RingQueue" << std::endl;
+	}
+}
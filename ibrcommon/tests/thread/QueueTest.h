@@ -26,6 +26,7 @@
 #define IBRCOMMON_QUEUETEST_H_
 
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/RingQueue.h>
 #include <ibrcommon/thread/Thread.h>
 
 class QueueTest : public CPPUNIT_NS :: TestFixture
@@ -36,6 +37,10 @@ class QueueTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (tsq_test03);
 	CPPUNIT_TEST (tsq_test04);
 	CPPUNIT_TEST (tsq_test05);
+	CPPUNIT_TEST (ringTest);
+	CPPUNIT_TEST (ringAbortTest);
+	CPPUNIT_TEST (ringElementTest);
+	CPPUNIT_TEST (mpmcBenchmark);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -66,6 +71,10 @@ protected:
 	void tsq_test03();
 	void tsq_test04();
 	void tsq_test05();
+	void ringTest();
+	void ringAbortTest();
+	void ringElementTest();
+	void mpmcBenchmark();
 };
 
 #endif /* IBRCOMMON_QUEUETEST_H_ */
@@ -20,7 +20,13 @@
  */
 
 #include "thread/TimerTest.h"
+#include <ibrcommon/thread/TimerService.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/TimeMeasurement.h>
+#include <iostream>
+#include <vector>
 #include <unistd.h>
+#include <time.h>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (TimerTest);
 
@@ -49,3 +55,147 @@ void TimerTest::timer_test01()
 	timer.stop();
 	timer.join();
 }
+
+TimerTest::DriftCallback::DriftCallback(size_t t)
+ : total(t), fired(0), early(false), max_drift(0), sum_drift(0)
+{
+}
+
+TimerTest::DriftCallback::~DriftCallback()
+{
+}
+
+size_t TimerTest::DriftCallback::timeout(ibrcommon::Timer *timer)
+{
+	const ibrcommon::TimerWheel::tick_t now = ibrcommon::TimerService::getTicks();
+	const ibrcommon::TimerWheel::tick_t expiry = timer->getExpiry();
+
+	// a timer must never fire early
+	if (now < expiry) early = true;
+
+	const ibrcommon::TimerWheel::tick_t drift = (now > expiry) ? (now - expiry) : 0;
+
+	ibrcommon::MutexLock l(cond);
+	if (drift > max_drift) max_drift = drift;
+	sum_drift += drift;
+	if (++fired == total) cond.signal(true);
+
+	// do not restart the timer
+	return 0;
+}
+
+void TimerTest::timer_test02()
+{
+	ibrcommon::TimerWheel wheel(1000);
+	std::vector<ibrcommon::TimerWheel::Entry> entries(500);
+
+	// spread the entries over all levels of the wheel
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		wheel.add(entries[i], 1000 + (i * i * 97) + 1);
+	}
+
+	// remove every tenth entry
+	for (size_t i = 0; i < entries.size(); i += 10)
+	{
+		wheel.remove(entries[i]);
+		CPPUNIT_ASSERT(!entries[i].isPending());
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)450, wheel.size());
+
+	size_t expired = 0;
+	while (!wheel.empty())
+	{
+		const ibrcommon::TimerWheel::tick_t next = wheel.next();
+		CPPUNIT_ASSERT(next != ibrcommon::TimerWheel::NEVER);
+
+		// the wheel must not be late
+		wheel.update(wheel.now() + (next > 0 ? next : 1));
+
+		ibrcommon::TimerWheel::Entry *e = NULL;
+		while ((e = wheel.get()) != NULL)
+		{
+			// entries must never expire early or late
+			CPPUNIT_ASSERT_EQUAL(e->getExpiry(), wheel.now());
+			++expired;
+		}
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)450, expired);
+	CPPUNIT_ASSERT_EQUAL(ibrcommon::TimerWheel::NEVER, wheel.next());
+}
+
+void TimerTest::timer_test03()
+{
+	ibrcommon::TimerWheel wheel(0);
+	std::vector<ibrcommon::TimerWheel::Entry> entries(16);
+
+	// jump far ahead in time, all entries have to expire
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		wheel.add(entries[i], (ibrcommon::TimerWheel::tick_t)1 << (i * 2));
+	}
+
+	wheel.update((ibrcommon::TimerWheel::tick_t)1 << 40);
+
+	size_t expired = 0;
+	while (wheel.get() != NULL) ++expired;
+
+	CPPUNIT_ASSERT_EQUAL(entries.size(), expired);
+	CPPUNIT_ASSERT(wheel.empty());
+}
+
+void TimerTest::timer_test04()
+{
+	const size_t count = 100000;
+	std::vector<ibrcommon::Timer*> timers;
+	timers.reserve(count);
+
+	DriftCallback cb(count);
+
+	const clock_t cpu_start = ::clock();
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		ibrcommon::Timer *t = new ibrcommon::Timer(cb, 1);
+		t->start();
+		timers.push_back(t);
+	}
+
+	tm.stop();
+	const double schedule_ms = tm.getMilliseconds();
+
+	// wait until all timers are fired
+	{
+		ibrcommon::MutexLock l(cb.cond);
+		while (cb.fired < count)
+		{
+			try {
+				cb.cond.wait(10000);
+			} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+				break;
+			}
+		}
+	}
+
+	for (std::vector<ibrcommon::Timer*>::iterator it = timers.begin(); it != timers.end(); ++it)
+	{
+		delete (*it);
+	}
+
+	const double cpu_ms = (double)(::clock() - cpu_start) * 1000.0 / CLOCKS_PER_SEC;
+
+	std::cout << std::endl << count << " timers: scheduled in " << schedule_ms << " ms, "
+			<< "max drift " << cb.max_drift << " ms, "
+			<< "avg drift " << ((double)cb.sum_drift / (double)count) << " ms, "
+			<< "cpu " << cpu_ms << " ms" << std::endl;
+
+	CPPUNIT_ASSERT_EQUAL(count, cb.fired);
+	CPPUNIT_ASSERT(!cb.early);
+
+	// one second timers have to be fired within a second
+	CPPUNIT_ASSERT(cb.max_drift < 1000);
+}
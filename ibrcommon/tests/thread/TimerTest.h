@@ -26,11 +26,16 @@
 #define TIMERTEST_H_
 
 #include <ibrcommon/thread/Timer.h>
+#include <ibrcommon/thread/TimerWheel.h>
+#include <ibrcommon/thread/Conditional.h>
 
 class TimerTest : public CPPUNIT_NS :: TestFixture, public ibrcommon::TimerCallback
 {
 	CPPUNIT_TEST_SUITE (TimerTest);
 	CPPUNIT_TEST (timer_test01);
+	CPPUNIT_TEST (timer_test02);
+	CPPUNIT_TEST (timer_test03);
+	CPPUNIT_TEST (timer_test04);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -41,6 +46,26 @@ public:
 
 protected:
 	void timer_test01();
+	void timer_test02();
+	void timer_test03();
+	void timer_test04();
+
+private:
+	class DriftCallback : public ibrcommon::TimerCallback
+	{
+	public:
+		DriftCallback(size_t total);
+		virtual ~DriftCallback();
+
+		size_t timeout(ibrcommon::Timer *timer);
+
+		ibrcommon::Conditional cond;
+		const size_t total;
+		size_t fired;
+		bool early;
+		ibrcommon::TimerWheel::tick_t max_drift;
+		ibrcommon::TimerWheel::tick_t sum_drift;
+	};
 };
 
 #endif /* TIMERTEST_H_ */
@@ -87,17 +87,17 @@ namespace dtn
 		 : _enabled(true), _interval(5), _announce(true), _short(false), _version(2), _crosslayer(false) {}
 
 		Configuration::Debug::Debug()
-		 : _enabled(false), _quiet(false), _level(0), _profiling(false) {}
+		 : _enabled(false), _quiet(false), _level(0), _profiling(false), _latency_sampling(0) {}
 
 		Configuration::Logger::Logger()
 		 : _quiet(false), _options(0), _timestamps(false), _verbose(false) {}
 
 		Configuration::Network::Network()
-		 : _routing("default"), _forwarding(true), _prefer_direct(true), _tcp_nodelay(true), _tcp_chunksize(4096), _tcp_idle_timeout(0), _keepalive_timeout(60), _default_net("lo"), _use_default_net(false), _auto_connect(0), _fragmentation(false), _scheduling(false), _link_request_interval(5000)
+		 : _routing("default"), _forwarding(true), _prefer_direct(true), _tcp_nodelay(true), _tcp_chunksize(4096), _tcp_idle_timeout(0), _tcp_cut_through(false), _tcp_interleaving(false), _keepalive_timeout(60), _default_net("lo"), _use_default_net(false), _auto_connect(0), _fragmentation(false), _scheduling(false), _link_request_interval(5000), _report_aggregation(0), _transfer_window(0)
 		{}
 
 		Configuration::Security::Security()
-		 : _enabled(false), _tlsEnabled(false), _tlsRequired(false), _tlsOptionalOnBadClock(false), _level(SECURITY_LEVEL_NONE), _disableEncryption(false), _generate_dh_params(false)
+		 : _enabled(false), _tlsEnabled(false), _tlsRequired(false), _tlsOptionalOnBadClock(false), _level(SECURITY_LEVEL_NONE), _disableEncryption(false), _generate_dh_params(false), _session_key_lifetime(0), _verify_threads(0)
 		{}
 
 		Configuration::Daemon::Daemon()
@@ -424,6 +424,8 @@ namespace dtn
 			try {
 				_profiling = (conf.read<std::string>("profiling") == "yes");
 			} catch (const ibrcommon::ConfigFile::key_not_found&) { };
+
+			_latency_sampling = conf.read<dtn::data::Size>("latency_sampling", 0);
 		}
 
 		void Configuration::Daemon::load(const ibrcommon::ConfigFile&)
@@ -531,6 +533,11 @@ namespace dtn
 			return _profiling;
 		}
 
+		dtn::data::Size Configuration::Debug::getLatencySampling() const
+		{
+			return _latency_sampling;
+		}
+
 		bool Configuration::Debug::enabled() const
 		{
 			return _enabled;
@@ -672,6 +679,17 @@ namespace dtn
 			return _conf.read<std::string>("use_persistent_bundlesets", "no") == "yes";
 		}
 
+		unsigned int Configuration::getStorageWriters() const
+		{
+			const int writers = _conf.read<int>("storage_writers", 1);
+			return (writers < 1) ? 1 : static_cast<unsigned int>(writers);
+		}
+
+		bool Configuration::getStorageSync() const
+		{
+			return _conf.read<std::string>("storage_sync", "no") == "yes";
+		}
+
 		void Configuration::Network::load(const ibrcommon::ConfigFile &conf)
 		{
 			/**
@@ -899,6 +917,8 @@ namespace dtn
 			_tcp_nodelay = (conf.read<std::string>("tcp_nodelay", "yes") == "yes");
 			_tcp_chunksize = conf.read<unsigned int>("tcp_chunksize", 4096);
 			_tcp_idle_timeout = conf.read<unsigned int>("tcp_idle_timeout", 0);
+			_tcp_cut_through = (conf.read<std::string>("tcp_cut_through", "no") == "yes");
+			_tcp_interleaving = (conf.read<std::string>("tcp_interleaving", "no") == "yes");
 
 			/**
 			 * Keep alive interval for network connections
@@ -936,6 +956,35 @@ namespace dtn
 			 * read link-request-interval
 			 */
 			_link_request_interval = conf.read<dtn::data::Timeout>("link_request_interval",5000);
+
+			/**
+			 * aggregation window for status reports and custody signals
+			 */
+			_report_aggregation = conf.read<dtn::data::Timeout>("report_aggregation", 0);
+
+			/**
+			 * transfer scheduling across all neighbors
+			 */
+			_transfer_window = conf.read<dtn::data::Size>("transfer_window", 0);
+
+			_transfer_shares.clear();
+
+			key = "transfer_share1";
+			keynumber = 1;
+
+			while (conf.keyExists( key ))
+			{
+				vector<string> share = dtn::utils::Utils::tokenize(" ", conf.read<string>(key, "dtn:none 1"));
+				if (share.size() == 2)
+				{
+					std::stringstream ss(share.back());
+					unsigned int weight = 1; ss >> weight;
+					_transfer_shares[share.front()] = weight;
+				}
+
+				keynumber++;
+				stringstream ss; ss << "transfer_share" << keynumber; ss >> key;
+			}
 		}
 
 		const std::multimap<std::string, std::string>& Configuration::Network::getStaticRoutes() const
@@ -1031,6 +1080,16 @@ namespace dtn
 			return _tcp_idle_timeout;
 		}
 
+		bool Configuration::Network::doTCPCutThrough() const
+		{
+			return _tcp_cut_through;
+		}
+
+		bool Configuration::Network::doTCPInterleaving() const
+		{
+			return _tcp_interleaving;
+		}
+
 		dtn::data::Timeout Configuration::Network::getKeepaliveInterval() const
 		{
 			return _keepalive_timeout;
@@ -1056,6 +1115,21 @@ namespace dtn
 			return _link_request_interval;
 		}
 
+		dtn::data::Timeout Configuration::Network::getReportAggregation() const
+		{
+			return _report_aggregation;
+		}
+
+		dtn::data::Size Configuration::Network::getTransferWindow() const
+		{
+			return _transfer_window;
+		}
+
+		const std::map<std::string, unsigned int>& Configuration::Network::getTransferShares() const
+		{
+			return _transfer_shares;
+		}
+
 		dtn::data::Size Configuration::getLimit(const std::string &suffix) const
 		{
 			std::string unparsed = _conf.read<std::string>("limit_" + suffix, "0");
@@ -1165,6 +1239,12 @@ namespace dtn
 			// load level
 			_level = Level(conf.read<int>("security_level", 0));
 
+			// reuse encryption session keys
+			_session_key_lifetime = conf.read<size_t>("security_session_key_lifetime", 0);
+
+			// number of threads verifying received bundles
+			_verify_threads = conf.read<size_t>("security_verify_threads", 0);
+
 			if ( !withTLS )
 			{
 				/* if TLS is enabled, the Certificate file and the key have been read earlier */
@@ -1267,6 +1347,16 @@ namespace dtn
 			return _generate_dh_params;
 		}
 
+		size_t Configuration::Security::getSessionKeyLifetime() const
+		{
+			return _session_key_lifetime;
+		}
+
+		size_t Configuration::Security::getVerifyThreads() const
+		{
+			return _verify_threads;
+		}
+
 		bool Configuration::Logger::quiet() const
 		{
 			return _quiet;
@@ -140,6 +140,17 @@ namespace dtn
 
 			bool getUsePersistentBundleSets() const;
 
+			/**
+			 * Returns the number of threads writing bundles to the storage path
+			 */
+			unsigned int getStorageWriters() const;
+
+			/**
+			 * Returns true, if stored bundles are flushed to the disk
+			 * before they are reported as stored
+			 */
+			bool getStorageSync() const;
+
 			enum RoutingExtension
 			{
 				DEFAULT_ROUTING = 0,
@@ -200,6 +211,7 @@ namespace dtn
 				bool _quiet;
 				int _level;
 				bool _profiling;
+				dtn::data::Size _latency_sampling;
 
 			public:
 				/**
@@ -223,6 +235,13 @@ namespace dtn
 				 * @return True, if profiling is activated
 				 */
 				bool profiling() const;
+
+				/**
+				 * Returns the number of bundles per traced bundle for the
+				 * latency statistics.
+				 * @return Sampling interval, zero if the tracing is disabled
+				 */
+				dtn::data::Size getLatencySampling() const;
 			};
 
 			class Logger : public Configuration::Extension
@@ -320,6 +339,8 @@ namespace dtn
 				bool _tcp_nodelay;
 				dtn::data::Length _tcp_chunksize;
 				dtn::data::Timeout _tcp_idle_timeout;
+				bool _tcp_cut_through;
+				bool _tcp_interleaving;
 				dtn::data::Timeout _keepalive_timeout;
 				ibrcommon::vinterface _default_net;
 				bool _use_default_net;
@@ -330,6 +351,9 @@ namespace dtn
 				std::set<ibrcommon::vinterface> _internet_devices;
 				bool _managed_connectivity;
 				size_t _link_request_interval;
+				dtn::data::Timeout _report_aggregation;
+				dtn::data::Size _transfer_window;
+				std::map<std::string, unsigned int> _transfer_shares;
 
 			public:
 				/**
@@ -380,6 +404,18 @@ namespace dtn
 				 */
 				dtn::data::Timeout getTCPIdleTimeout() const;
 
+				/**
+				 * @return True, if bundles for connected neighbors should be
+				 * forwarded while they are still received.
+				 */
+				bool doTCPCutThrough() const;
+
+				/**
+				 * @return True, if small and expedited bundles should be
+				 * interleaved with other transfers on a TCP connection.
+				 */
+				bool doTCPInterleaving() const;
+
 				/**
 				 * @return The keep-alive interval for network connections.
 				 */
@@ -414,6 +450,23 @@ namespace dtn
 				 * @return Number of milliseconds between two linkstate-requests (as netlink-fallback)
 				 */
 				size_t getLinkRequestInterval() const;
+
+				/**
+				 * @return Number of seconds status reports and custody signals
+				 * are collected before they are sent as aggregate (0 = disabled)
+				 */
+				dtn::data::Timeout getReportAggregation() const;
+
+				/**
+				 * @return Number of bundles handed to the convergence layers
+				 * at once over all neighbors (0 = disabled)
+				 */
+				dtn::data::Size getTransferWindow() const;
+
+				/**
+				 * @return Weights of neighbors sharing the transfer window
+				 */
+				const std::map<std::string, unsigned int>& getTransferShares() const;
 			};
 
 			class Security : public Configuration::Extension
@@ -500,6 +553,18 @@ namespace dtn
 				 */
 				bool isGenerateDHParamsEnabled() const;
 
+				/**
+				 * Get the number of seconds an encryption session key is
+				 * used for bundles to the same destination (0 = disabled)
+				 */
+				size_t getSessionKeyLifetime() const;
+
+				/**
+				 * Get the number of threads verifying received
+				 * bundles (0 = verify in the receiving connection)
+				 */
+				size_t getVerifyThreads() const;
+
 			private:
 				// security related files
 				ibrcommon::File _path;
@@ -521,6 +586,12 @@ namespace dtn
 
 				// TLS encryption disabled?
 				bool _disableEncryption;
+
+				// lifetime of encryption session keys
+				size_t _session_key_lifetime;
+
+				// number of verification threads
+				size_t _verify_threads;
 			};
 
 			class Daemon : public Configuration::Extension
@@ -36,10 +36,13 @@
 #include "storage/BundleSeeker.h"
 #include "storage/MemoryBundleStorage.h"
 #include "storage/SimpleBundleStorage.h"
+#include "storage/TieredBundleStorage.h"
 
 #include "core/BundleCore.h"
 #include "net/ConnectionManager.h"
 #include "core/FragmentManager.h"
+#include "core/LatencyTracer.h"
+#include "core/VerificationPool.h"
 #include "core/Node.h"
 #include "core/EventSwitch.h"
 #include "core/EventDispatcher.h"
@@ -1021,6 +1024,9 @@ namespace dtn
 				IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, info) << "Parallel event processing enabled using " << conf.getDaemon().getThreads() << " processes." << IBRCOMMON_LOGGER_ENDL;
 			}
 
+			// trace the latency of sampled bundles
+			dtn::core::LatencyTracer::getInstance().setSampling(conf.getDebug().getLatencySampling());
+
 			// initialize the event switch
 			dtn::core::EventSwitch::getInstance().initialize();
 
@@ -1048,11 +1054,19 @@ namespace dtn
 #ifdef IBRDTN_SUPPORT_BSP
 			// initialize the key manager for the security extensions
 			dtn::security::SecurityKeyManager::getInstance().onConfigurationChanged( conf );
+
+			// start the workers for the verification of received bundles
+			dtn::core::VerificationPool::getInstance().start(conf.getSecurity().getVerifyThreads());
 #endif
 		}
 
 		void NativeDaemon::shutdown_core() throw (NativeDaemonException)
 		{
+#ifdef IBRDTN_SUPPORT_BSP
+			// stop the verification workers
+			dtn::core::VerificationPool::getInstance().stop();
+#endif
+
 			// shutdown the event switch
 			_event_loop->stop();
 			_event_loop->join();
@@ -1140,7 +1154,7 @@ namespace dtn
 					}
 
 					IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, info) << "using simple bundle storage in " << path.getPath() << IBRCOMMON_LOGGER_ENDL;
-					dtn::storage::SimpleBundleStorage *sbs = new dtn::storage::SimpleBundleStorage(path, conf.getLimit("storage"), static_cast<unsigned int>(conf.getLimit("storage_buffer")));
+					dtn::storage::SimpleBundleStorage *sbs = new dtn::storage::SimpleBundleStorage(path, conf.getLimit("storage"), static_cast<unsigned int>(conf.getLimit("storage_buffer")), conf.getStorageWriters(), conf.getStorageSync());
 					_components[RUNLEVEL_STORAGE].push_back(sbs);
 					storage = sbs;
 				} catch (const dtn::daemon::Configuration::ParameterNotSetException&) {
@@ -1151,6 +1165,28 @@ namespace dtn
 				}
 			}
 
+			if (conf.getStorage() == "tiered")
+			{
+				try {
+					ibrcommon::File path = conf.getPath("storage");
+
+					// create workdir if needed
+					if (!path.exists()) ibrcommon::File::createDirectory(path);
+
+					// bytes of bundles kept in memory before they are spilled to disk
+					dtn::data::Length memory_limit = conf.getLimit("storage_memory");
+					if (memory_limit == 0) memory_limit = 10000000;
+
+					IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, info) << "using tiered bundle storage in " << path.getPath() << " with " << memory_limit << " bytes in memory" << IBRCOMMON_LOGGER_ENDL;
+					dtn::storage::TieredBundleStorage *tbs = new dtn::storage::TieredBundleStorage(path, memory_limit, conf.getLimit("storage"), static_cast<unsigned int>(conf.getLimit("storage_buffer")), conf.getStorageWriters(), conf.getStorageSync());
+					_components[RUNLEVEL_STORAGE].push_back(tbs);
+					storage = tbs;
+				} catch (const dtn::daemon::Configuration::ParameterNotSetException&) {
+					IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, error) << "tiered bundle storage requires a storage_path" << IBRCOMMON_LOGGER_ENDL;
+					throw NativeDaemonException("initialization of the bundle storage failed");
+				}
+			}
+
 			if (storage == NULL)
 			{
 				IBRCOMMON_LOGGER_TAG(NativeDaemon::TAG, error) << "bundle storage module \"" << conf.getStorage() << "\" do not exists!" << IBRCOMMON_LOGGER_ENDL;
@@ -21,6 +21,7 @@
 
 #include "EventConnection.h"
 #include "core/EventDispatcher.h"
+#include "net/LinkMetrics.h"
 
 #include <ibrdtn/utils/Utils.h>
 
@@ -173,6 +174,7 @@ namespace dtn
 			// start with the event tag
 			_stream << "Event: " << aborted.getName() << std::endl;
 			_stream << "Peer: " << aborted.getPeer().getString() << std::endl;
+			_stream << "Reason: " << dtn::net::TransferAbortedEvent::getReason(aborted.reason) << std::endl;
 
 			// write the bundle data
 			_stream << "Source: " << aborted.getBundleID().source.getString() << std::endl;
@@ -251,6 +253,14 @@ namespace dtn
 			// write the peer eid
 			_stream << "Peer: " << connection.getNode().getEID().getString() << std::endl;
 
+			// write the metrics of all links to the peer
+			dtn::net::ConvergenceLayer::stats_data data;
+			dtn::net::LinkMetrics::getStats(connection.getNode().getEID(), data);
+
+			for (dtn::net::ConvergenceLayer::stats_data::const_iterator iter = data.begin(); iter != data.end(); ++iter) {
+				_stream << iter->first << ": " << iter->second << std::endl;
+			}
+
 			// close the event
 			_stream << std::endl;
 		}
@@ -28,6 +28,8 @@
 #include <ibrdtn/data/BundleBuilder.h>
 #include <ibrdtn/api/PlainSerializer.h>
 #include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/data/AggregateStatusReportBlock.h>
+#include <ibrdtn/data/AggregateCustodySignalBlock.h>
 #include <ibrdtn/utils/Utils.h>
 #include <ibrcommon/data/Base64Reader.h>
 #include <ibrcommon/data/Base64Stream.h>
@@ -500,8 +502,8 @@ namespace dtn
 								// construct bundle id
 								dtn::data::BundleID id = readBundleID(cmd, 2);
 
-								// announce this bundle as delivered
-								dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(dtn::core::BundleCore::getInstance().getStorage().get(id));
+								// announce this bundle as delivered, the meta data is sufficient
+								dtn::data::MetaBundle meta = dtn::core::BundleCore::getInstance().getStorage().info(id);
 								_client.getRegistration().delivered(meta);
 
 								ibrcommon::MutexLock l(_write_lock);
@@ -932,100 +934,144 @@ namespace dtn
 				dtn::data::StatusReportBlock report;
 				report.read(payload);
 
-				// lock the API channel
-				ibrcommon::MutexLock l(_write_lock);
+				notifyStatusReport(b.source, report);
+				return;
+			} catch (const dtn::data::StatusReportBlock::WrongRecordException&) {
+				// this is not a status report
+			}
 
-				// write notification header to API channel
-				_stream << API_STATUS_NOTIFY_REPORT << " NOTIFY REPORT ";
+			try {
+				// try to decode as custody signal
+				dtn::data::CustodySignalBlock custody;
+				custody.read(payload);
 
-				// write sender EID
-				_stream << b.source.getString() << " ";
+				notifyCustodySignal(b.source, custody);
+				return;
+			} catch (const dtn::data::CustodySignalBlock::WrongRecordException&) {
+				// this is not a custody report
+			}
 
-				// format the bundle ID and write it to the stream
-				_stream << report.bundleid.timestamp.toString() << "." << report.bundleid.sequencenumber.toString();
+			try {
+				// try to decode as aggregate status report
+				dtn::data::AggregateStatusReportBlock aggregate;
+				aggregate.read(payload);
 
-				if (report.bundleid.isFragment()) {
-					_stream << "." << report.bundleid.fragmentoffset.toString() << ":" << report.bundleid.getPayloadLength() << " ";
-				} else {
-					_stream << " ";
-				}
+				// announce each bundle of the aggregate as single report
+				std::list<dtn::data::StatusReportBlock> reports;
+				aggregate.expand(reports);
 
-				// origin source
-				_stream << report.bundleid.source.getString() << " ";
+				for (std::list<dtn::data::StatusReportBlock>::const_iterator it = reports.begin(); it != reports.end(); ++it)
+				{
+					notifyStatusReport(b.source, *it);
+				}
+				return;
+			} catch (const dtn::data::AggregateStatusReportBlock::WrongRecordException&) {
+				// this is not an aggregate status report
+			}
 
-				// reason code
-				_stream << (int)report.reasoncode << " ";
+			try {
+				// try to decode as aggregate custody signal
+				dtn::data::AggregateCustodySignalBlock aggregate;
+				aggregate.read(payload);
 
-				if (report.status & dtn::data::StatusReportBlock::RECEIPT_OF_BUNDLE)
-					_stream << "RECEIPT[" << report.timeof_receipt.getTimestamp().toString() << "."
-						<< report.timeof_receipt.getNanoseconds().toString() << "] ";
+				// announce each bundle of the aggregate as single signal
+				std::list<dtn::data::CustodySignalBlock> signals;
+				aggregate.expand(signals);
 
-				if (report.status & dtn::data::StatusReportBlock::CUSTODY_ACCEPTANCE_OF_BUNDLE)
-					_stream << "CUSTODY-ACCEPTANCE[" << report.timeof_custodyaccept.getTimestamp().toString() << "."
-						<< report.timeof_custodyaccept.getNanoseconds().toString() << "] ";
+				for (std::list<dtn::data::CustodySignalBlock>::const_iterator it = signals.begin(); it != signals.end(); ++it)
+				{
+					notifyCustodySignal(b.source, *it);
+				}
+				return;
+			} catch (const dtn::data::AggregateCustodySignalBlock::WrongRecordException&) {
+				// this is not an aggregate custody signal
+			}
+		}
 
-				if (report.status & dtn::data::StatusReportBlock::FORWARDING_OF_BUNDLE)
-					_stream << "FORWARDING[" << report.timeof_forwarding.getTimestamp().toString() << "."
-						<< report.timeof_forwarding.getNanoseconds().toString() << "] ";
+		void ExtendedApiHandler::notifyStatusReport(const dtn::data::EID &source, const dtn::data::StatusReportBlock &report)
+		{
+			// lock the API channel
+			ibrcommon::MutexLock l(_write_lock);
 
-				if (report.status & dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE)
-					_stream << "DELIVERY[" << report.timeof_delivery.getTimestamp().toString() << "."
-						<< report.timeof_delivery.getNanoseconds().toString() << "] ";
+			// write notification header to API channel
+			_stream << API_STATUS_NOTIFY_REPORT << " NOTIFY REPORT ";
 
-				if (report.status & dtn::data::StatusReportBlock::DELETION_OF_BUNDLE)
-					_stream << "DELETION[" << report.timeof_deletion.getTimestamp().toString() << "."
-						<< report.timeof_deletion.getNanoseconds().toString() << "] ";
+			// write sender EID
+			_stream << source.getString() << " ";
 
-				// finalize statement with a line-break
-				_stream << std::endl;
+			// format the bundle ID and write it to the stream
+			_stream << report.bundleid.timestamp.toString() << "." << report.bundleid.sequencenumber.toString();
 
-				return;
-			} catch (const dtn::data::StatusReportBlock::WrongRecordException&) {
-				// this is not a status report
+			if (report.bundleid.isFragment()) {
+				_stream << "." << report.bundleid.fragmentoffset.toString() << ":" << report.bundleid.getPayloadLength() << " ";
+			} else {
+				_stream << " ";
 			}
 
-			try {
-				// try to decode as custody signal
-				dtn::data::CustodySignalBlock custody;
-				custody.read(payload);
+			// origin source
+			_stream << report.bundleid.source.getString() << " ";
 
-				// lock the API channel
-				ibrcommon::MutexLock l(_write_lock);
+			// reason code
+			_stream << (int)report.reasoncode << " ";
 
-				// write notification header to API channel
-				_stream << API_STATUS_NOTIFY_CUSTODY << " NOTIFY CUSTODY ";
+			if (report.status & dtn::data::StatusReportBlock::RECEIPT_OF_BUNDLE)
+				_stream << "RECEIPT[" << report.timeof_receipt.getTimestamp().toString() << "."
+					<< report.timeof_receipt.getNanoseconds().toString() << "] ";
 
-				// write sender EID
-				_stream << b.source.getString() << " ";
+			if (report.status & dtn::data::StatusReportBlock::CUSTODY_ACCEPTANCE_OF_BUNDLE)
+				_stream << "CUSTODY-ACCEPTANCE[" << report.timeof_custodyaccept.getTimestamp().toString() << "."
+					<< report.timeof_custodyaccept.getNanoseconds().toString() << "] ";
 
-				// format the bundle ID and write it to the stream
-				_stream << custody.bundleid.timestamp.toString() << "." << custody.bundleid.sequencenumber.toString();
+			if (report.status & dtn::data::StatusReportBlock::FORWARDING_OF_BUNDLE)
+				_stream << "FORWARDING[" << report.timeof_forwarding.getTimestamp().toString() << "."
+					<< report.timeof_forwarding.getNanoseconds().toString() << "] ";
 
-				if (custody.bundleid.isFragment()) {
-					_stream << "." << custody.bundleid.fragmentoffset.toString() << ":" << custody.bundleid.getPayloadLength() << " ";
-				} else {
-					_stream << " ";
-				}
+			if (report.status & dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE)
+				_stream << "DELIVERY[" << report.timeof_delivery.getTimestamp().toString() << "."
+					<< report.timeof_delivery.getNanoseconds().toString() << "] ";
 
-				// origin source
-				_stream << custody.bundleid.source.getString() << " ";
+			if (report.status & dtn::data::StatusReportBlock::DELETION_OF_BUNDLE)
+				_stream << "DELETION[" << report.timeof_deletion.getTimestamp().toString() << "."
+					<< report.timeof_deletion.getNanoseconds().toString() << "] ";
 
-				if (custody.custody_accepted) {
-					_stream << "ACCEPTED ";
-				} else {
-					_stream << "REJECTED(" << (int)custody.reason << ") ";
-				}
+			// finalize statement with a line-break
+			_stream << std::endl;
+		}
 
-				// add time of signal to the message
-				_stream << custody.timeofsignal.getTimestamp().toString() << "." << custody.timeofsignal.getNanoseconds().toString();
+		void ExtendedApiHandler::notifyCustodySignal(const dtn::data::EID &source, const dtn::data::CustodySignalBlock &custody)
+		{
+			// lock the API channel
+			ibrcommon::MutexLock l(_write_lock);
 
-				// finalize statement with a line-break
-				_stream << std::endl;
+			// write notification header to API channel
+			_stream << API_STATUS_NOTIFY_CUSTODY << " NOTIFY CUSTODY ";
 
-				return;
-			} catch (const dtn::data::CustodySignalBlock::WrongRecordException&) {
-				// this is not a custody report
+			// write sender EID
+			_stream << source.getString() << " ";
+
+			// format the bundle ID and write it to the stream
+			_stream << custody.bundleid.timestamp.toString() << "." << custody.bundleid.sequencenumber.toString();
+
+			if (custody.bundleid.isFragment()) {
+				_stream << "." << custody.bundleid.fragmentoffset.toString() << ":" << custody.bundleid.getPayloadLength() << " ";
+			} else {
+				_stream << " ";
 			}
+
+			// origin source
+			_stream << custody.bundleid.source.getString() << " ";
+
+			if (custody.custody_accepted) {
+				_stream << "ACCEPTED ";
+			} else {
+				_stream << "REJECTED(" << (int)custody.reason << ") ";
+			}
+
+			// add time of signal to the message
+			_stream << custody.timeofsignal.getTimestamp().toString() << "." << custody.timeofsignal.getNanoseconds().toString();
+
+			// finalize statement with a line-break
+			_stream << std::endl;
 		}
 
 		void ExtendedApiHandler::sayBundleID(ostream &stream, const dtn::data::BundleID &id)
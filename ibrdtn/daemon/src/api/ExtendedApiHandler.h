@@ -29,6 +29,8 @@
 
 #include <ibrdtn/api/PlainSerializer.h>
 #include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/StatusReportBlock.h>
+#include <ibrdtn/data/CustodySignalBlock.h>
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Queue.h>
 #include <ibrcommon/net/socketstream.h>
@@ -88,6 +90,16 @@ namespace dtn
 			 */
 			void notifyAdministrativeRecord(dtn::data::MetaBundle &bundle);
 
+			/**
+			 * Write a status report notification
+			 */
+			void notifyStatusReport(const dtn::data::EID &source, const dtn::data::StatusReportBlock &report);
+
+			/**
+			 * Write a custody signal notification
+			 */
+			void notifyCustodySignal(const dtn::data::EID &source, const dtn::data::CustodySignalBlock &custody);
+
 			ibrcommon::Mutex _write_lock;
 
 			dtn::data::Bundle _bundle_reg;
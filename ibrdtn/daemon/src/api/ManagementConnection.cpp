@@ -37,6 +37,8 @@
 #include "routing/QueueBundleEvent.h"
 #include "routing/RequeueBundleEvent.h"
 #include "core/TimeAdjustmentEvent.h"
+#include "core/LatencyTracer.h"
+#include "net/LinkMetrics.h"
 
 #include <ibrdtn/ibrdtn.h>
 #ifdef IBRDTN_SUPPORT_BSP
@@ -474,6 +476,13 @@ namespace dtn
 						_stream << "Requeued: " << dtn::core::EventDispatcher<dtn::routing::RequeueBundleEvent>::getCounter() << std::endl;
 						_stream << "Queued: " << dtn::core::EventDispatcher<dtn::routing::QueueBundleEvent>::getCounter() << std::endl;
 						_stream << std::endl;
+					} else if ( cmd[1] == "reports" ) {
+						const dtn::core::ReportAggregator &aggregator = dtn::core::BundleCore::getInstance().getReportAggregator();
+
+						_stream << ClientHandler::API_STATUS_OK << " STATS REPORTS" << std::endl;
+						_stream << "Records: " << aggregator.getRecords() << std::endl;
+						_stream << "Bundles: " << aggregator.getBundles() << std::endl;
+						_stream << std::endl;
 					} else if ( cmd[1] == "convergencelayers" ) {
 						_stream << ClientHandler::API_STATUS_OK << " STATS CONVERGENCELAYERS" << std::endl;
 
@@ -485,6 +494,31 @@ namespace dtn
 								_stream << pair.first << ": " << pair.second << std::endl;
 						}
 						_stream << std::endl;
+					} else if ( cmd[1] == "peers" ) {
+						_stream << ClientHandler::API_STATUS_OK << " STATS PEERS" << std::endl;
+
+						dtn::net::ConvergenceLayer::stats_data data;
+						dtn::net::LinkMetrics::getStats(data);
+
+						for (dtn::net::ConvergenceLayer::stats_data::const_iterator iter = data.begin(); iter != data.end(); ++iter) {
+							const dtn::net::ConvergenceLayer::stats_pair &pair = (*iter);
+							_stream << pair.first << ": " << pair.second << std::endl;
+						}
+						_stream << std::endl;
+					} else if ( cmd[1] == "latency" ) {
+						dtn::core::LatencyTracer &tracer = dtn::core::LatencyTracer::getInstance();
+
+						if ((cmd.size() > 2) && (cmd[2] == "dump")) {
+							_stream << ClientHandler::API_STATUS_OK << " STATS LATENCY DUMP" << std::endl;
+							tracer.dump(_stream);
+							_stream << std::endl;
+						} else {
+							_stream << ClientHandler::API_STATUS_OK << " STATS LATENCY" << std::endl;
+							_stream << "Sampling: " << tracer.getSampling() << std::endl;
+							_stream << "Tracing: " << tracer.size() << std::endl;
+							tracer.summary(_stream);
+							_stream << std::endl;
+						}
 					} else if ( cmd[1] == "reset" ) {
 						dtn::core::EventDispatcher<dtn::core::BundleExpiredEvent>::resetCounter();
 						dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::resetCounter();
@@ -495,6 +529,15 @@ namespace dtn
 						// reset cl stats
 						dtn::core::BundleCore::getInstance().getConnectionManager().resetStats();
 
+						// reset link stats
+						dtn::net::LinkMetrics::resetStats();
+
+						// reset report stats
+						dtn::core::BundleCore::getInstance().getReportAggregator().resetStats();
+
+						// reset latency stats
+						dtn::core::LatencyTracer::getInstance().reset();
+
 						_stream << ClientHandler::API_STATUS_ACCEPTED << " STATS RESET" << std::endl;
 					} else {
 						throw ibrcommon::Exception("malformed command");
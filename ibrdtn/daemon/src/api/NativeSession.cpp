@@ -498,6 +498,44 @@ namespace dtn
 			} catch (const dtn::data::CustodySignalBlock::WrongRecordException&) {
 				// this is not a custody report
 			}
+
+			try {
+				// try to decode as aggregate status report
+				dtn::data::AggregateStatusReportBlock aggregate;
+				aggregate.read(payload);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(NativeSession::TAG, 20) << "fire notifications for aggregate status report" << IBRCOMMON_LOGGER_ENDL;
+
+				std::list<dtn::data::StatusReportBlock> reports;
+				aggregate.expand(reports);
+
+				// fire a status report notification for each bundle
+				for (std::list<dtn::data::StatusReportBlock>::const_iterator it = reports.begin(); it != reports.end(); ++it)
+				{
+					fireNotificationStatusReport(b.source, *it);
+				}
+			} catch (const dtn::data::AggregateStatusReportBlock::WrongRecordException&) {
+				// this is not an aggregate status report
+			}
+
+			try {
+				// try to decode as aggregate custody signal
+				dtn::data::AggregateCustodySignalBlock aggregate;
+				aggregate.read(payload);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(NativeSession::TAG, 20) << "fire notifications for aggregate custody signal" << IBRCOMMON_LOGGER_ENDL;
+
+				std::list<dtn::data::CustodySignalBlock> signals;
+				aggregate.expand(signals);
+
+				// fire a custody signal notification for each bundle
+				for (std::list<dtn::data::CustodySignalBlock>::const_iterator it = signals.begin(); it != signals.end(); ++it)
+				{
+					fireNotificationCustodySignal(b.source, *it);
+				}
+			} catch (const dtn::data::AggregateCustodySignalBlock::WrongRecordException&) {
+				// this is not an aggregate custody signal
+			}
 		}
 
 		const std::string& NativeSession::getHandle() const
@@ -29,6 +29,8 @@
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/StatusReportBlock.h>
 #include <ibrdtn/data/CustodySignalBlock.h>
+#include <ibrdtn/data/AggregateStatusReportBlock.h>
+#include <ibrdtn/data/AggregateCustodySignalBlock.h>
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Queue.h>
 #include <ibrcommon/thread/RWMutex.h>
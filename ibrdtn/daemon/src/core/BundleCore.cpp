@@ -26,6 +26,7 @@
 #include "core/GlobalEvent.h"
 #include "core/BundleEvent.h"
 #include "core/FragmentManager.h"
+#include "core/LatencyTracer.h"
 #include "routing/QueueBundleEvent.h"
 #include "routing/RequeueBundleEvent.h"
 #include "routing/StaticRouteChangeEvent.h"
@@ -33,6 +34,7 @@
 #include <ibrcommon/data/BLOB.h>
 #include <ibrdtn/data/ScopeControlHopLimitBlock.h>
 #include <ibrdtn/data/CustodySignalBlock.h>
+#include <ibrdtn/data/AggregateCustodySignalBlock.h>
 #include <ibrdtn/data/TrackingBlock.h>
 #include <ibrdtn/data/MetaBundle.h>
 #include <ibrdtn/data/Exceptions.h>
@@ -114,12 +116,18 @@ namespace dtn
 			// initialize wall clock
 			_clock.initialize();
 
+			// initialize deadline scheduler
+			_scheduler.initialize();
+
 			// initialize discovery agent
 			_disco_agent.initialize();
 
 			// start a clock
 			_clock.startup();
 
+			// start deadline scheduler
+			_scheduler.startup();
+
 			// start discovery agent
 			_disco_agent.startup();
 		}
@@ -128,6 +136,9 @@ namespace dtn
 		{
 			ibrcommon::LinkManager::getInstance().removeEventListener(this);
 
+			// send pending aggregates while the scheduler is still running
+			_aggregator.flush();
+
 			// terminate discovery agent
 			_disco_agent.terminate();
 
@@ -136,6 +147,9 @@ namespace dtn
 
 			// terminate wall clock
 			_clock.terminate();
+
+			// terminate deadline scheduler
+			_scheduler.terminate();
 		}
 
 		void BundleCore::onConfigurationChanged(const dtn::daemon::Configuration &config) throw ()
@@ -192,6 +206,14 @@ namespace dtn
 				BundleCore::forwarding = false;
 			}
 
+			// aggregate status reports and custody signals
+			const dtn::data::Timeout aggregation = config.getNetwork().getReportAggregation();
+			if (aggregation > 0)
+			{
+				IBRCOMMON_LOGGER_TAG(BundleCore::TAG, info) << "Aggregate status reports and custody signals for " << aggregation << " seconds" << IBRCOMMON_LOGGER_ENDL;
+			}
+			_aggregator.setWindow(aggregation);
+
 			const std::set<ibrcommon::vinterface> &global_nets = config.getNetwork().getInternetDevices();
 
 			// remove myself from all listeners
@@ -258,6 +280,16 @@ namespace dtn
 			return _clock;
 		}
 
+		DeadlineScheduler& BundleCore::getScheduler()
+		{
+			return _scheduler;
+		}
+
+		ReportAggregator& BundleCore::getReportAggregator()
+		{
+			return _aggregator;
+		}
+
 		dtn::net::ConnectionManager& BundleCore::getConnectionManager()
 		{
 			return _connectionmanager;
@@ -299,8 +331,9 @@ namespace dtn
 					// we discard the bundle
 					bool delivered = false;
 
-					// process this bundle locally
-					const dtn::data::Bundle bundle = getStorage().get(meta);
+					// process this bundle locally, the payload is
+					// loaded for administrative records only
+					dtn::storage::BundleView bundle = getStorage().view(meta);
 
 					if (bundle.get(dtn::data::Bundle::APPDATA_IS_ADMRECORD))
 					try {
@@ -321,6 +354,28 @@ namespace dtn
 						// no payload block available
 					}
 
+					if (!delivered && bundle.get(dtn::data::Bundle::APPDATA_IS_ADMRECORD))
+					try {
+						// check for an aggregate custody signal
+						const dtn::data::PayloadBlock &payload = bundle.find<dtn::data::PayloadBlock>();
+
+						AggregateCustodySignalBlock custody;
+						custody.read(payload);
+
+						for (BundleIDRanges::const_iterator it = custody.bundles.begin(); it != custody.bundles.end(); ++it)
+						{
+							getStorage().releaseCustody(bundle.source, *it);
+						}
+
+						IBRCOMMON_LOGGER_DEBUG_TAG("BundleCore", 5) << "custody released for " << custody.bundles.size() << " bundles by " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+
+						delivered = true;
+					} catch (const AdministrativeBlock::WrongRecordException&) {
+						// no aggregate custody signal available
+					} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) {
+						// no payload block available
+					}
+
 					if (delivered)
 					{
 						// gen a report
@@ -708,6 +763,9 @@ namespace dtn
 		{
 			const dtn::data::MetaBundle m = dtn::data::MetaBundle::create(bundle);
 
+			// start the lifecycle trace of this bundle
+			dtn::core::LatencyTracer::getInstance().mark(m, dtn::core::LatencyTracer::STAGE_RECEIVED);
+
 			try {
 				if (local)
 				{
@@ -804,6 +862,7 @@ namespace dtn
 
 					// store the bundle into a storage module
 					getStorage().store(bundle);
+					dtn::core::LatencyTracer::getInstance().mark(m, dtn::core::LatencyTracer::STAGE_STORED);
 
 					// set the bundle as known
 					getRouter().setKnown(m);
@@ -835,6 +894,7 @@ namespace dtn
 
 						// store the bundle into a storage module
 						getStorage().store(bundle);
+						dtn::core::LatencyTracer::getInstance().mark(m, dtn::core::LatencyTracer::STAGE_STORED);
 
 						// raise the queued event to notify all receivers about the new bundle
 						dtn::routing::QueueBundleEvent::raise(m, source);
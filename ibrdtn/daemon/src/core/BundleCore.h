@@ -27,8 +27,10 @@
 
 #include "core/EventReceiver.h"
 #include "core/StatusReportGenerator.h"
+#include "core/ReportAggregator.h"
 #include "storage/BundleStorage.h"
 #include "core/WallClock.h"
+#include "core/DeadlineScheduler.h"
 #include "routing/BaseRouter.h"
 #include "core/BundleFilter.h"
 
@@ -82,6 +84,17 @@ namespace dtn
 
 			WallClock& getClock();
 
+			/**
+			 * Make the deadline scheduler available to other modules.
+			 */
+			DeadlineScheduler& getScheduler();
+
+			/**
+			 * Make the aggregator of status reports and custody signals
+			 * available to other modules.
+			 */
+			ReportAggregator& getReportAggregator();
+
 			virtual void onConfigurationChanged(const dtn::daemon::Configuration &conf) throw ();
 
 			void setStorage(dtn::storage::BundleStorage *storage);
@@ -230,6 +243,14 @@ namespace dtn
 			 */
 			WallClock _clock;
 
+			/**
+			 * Calls registered modules once their deadline has been reached.
+			 */
+			DeadlineScheduler _scheduler;
+
+			// aggregator for status reports and custody signals
+			ReportAggregator _aggregator;
+
 			dtn::storage::BundleStorage *_storage;
 			dtn::storage::BundleSeeker *_seeker;
 			dtn::routing::BaseRouter *_router;
@@ -0,0 +1,194 @@
+/*
+ * DeadlineScheduler.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/DeadlineScheduler.h"
+#include "core/EventDispatcher.h"
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+
+namespace dtn
+{
+	namespace core
+	{
+		DeadlineScheduler::Listener::~Listener()
+		{ }
+
+		DeadlineScheduler::DeadlineScheduler()
+		 : _current(NULL), _armed(0), _running(false), _timer(*this, 0)
+		{
+		}
+
+		DeadlineScheduler::~DeadlineScheduler()
+		{
+			_timer.stop();
+		}
+
+		void DeadlineScheduler::componentUp() throw ()
+		{
+			// routine checked for throw() on 15.02.2013
+			dtn::core::EventDispatcher<dtn::core::TimeAdjustmentEvent>::add(this);
+
+			ibrcommon::MutexLock l(_cond);
+			_running = true;
+			_armed = 0;
+			__arm();
+		}
+
+		void DeadlineScheduler::componentDown() throw ()
+		{
+			// routine checked for throw() on 15.02.2013
+			dtn::core::EventDispatcher<dtn::core::TimeAdjustmentEvent>::remove(this);
+
+			ibrcommon::MutexLock l(_cond);
+			_running = false;
+			_timer.pause();
+		}
+
+		void DeadlineScheduler::schedule(Listener &listener, const dtn::data::Timestamp &deadline)
+		{
+			ibrcommon::MutexLock l(_cond);
+			__remove(listener);
+
+			if (deadline == 0) return;
+
+			_listeners[&listener] = _deadlines.insert(std::make_pair(deadline, &listener));
+			__arm();
+		}
+
+		void DeadlineScheduler::cancel(Listener &listener)
+		{
+			ibrcommon::MutexLock l(_cond);
+			__remove(listener);
+
+			// a listener may cancel itself during its own call
+			if ((_current == &listener) && pthread_equal(_current_thread, pthread_self())) return;
+
+			while (_current == &listener) _cond.wait();
+		}
+
+		void DeadlineScheduler::trigger(const dtn::data::Timestamp &now)
+		{
+			ibrcommon::MutexLock tl(_trigger_lock);
+			ibrcommon::MutexLock l(_cond);
+
+			// only call the listeners due at the beginning, deadlines
+			// re-scheduled into the past are processed on the next run
+			dtn::data::Size due = 0;
+			for (deadline_map::const_iterator it = _deadlines.begin(); (it != _deadlines.end()) && (it->first <= now); ++it)
+			{
+				++due;
+			}
+
+			for (; (due > 0) && !_deadlines.empty(); --due)
+			{
+				deadline_map::iterator it = _deadlines.begin();
+				if (now < it->first) break;
+
+				Listener &listener = *(it->second);
+				_listeners.erase(&listener);
+				_deadlines.erase(it);
+
+				// call the listener without holding the lock
+				_current = &listener;
+				_current_thread = pthread_self();
+				_cond.leave();
+
+				listener.eventDeadline(now);
+
+				_cond.enter();
+				_current = NULL;
+				_cond.signal(true);
+			}
+		}
+
+		dtn::data::Size DeadlineScheduler::size()
+		{
+			ibrcommon::MutexLock l(_cond);
+			return _deadlines.size();
+		}
+
+		size_t DeadlineScheduler::timeout(ibrcommon::Timer*)
+		{
+			{
+				ibrcommon::MutexLock l(_cond);
+				if (!_running) throw ibrcommon::Timer::StopTimerException();
+			}
+
+			trigger(dtn::utils::Clock::getTime());
+
+			ibrcommon::MutexLock l(_cond);
+
+			// sleep until the next deadline is scheduled
+			if (_deadlines.empty() || !_running)
+			{
+				_armed = 0;
+				throw ibrcommon::Timer::StopTimerException();
+			}
+
+			_armed = _deadlines.begin()->first;
+			return __delay();
+		}
+
+		void DeadlineScheduler::raiseEvent(const dtn::core::TimeAdjustmentEvent&) throw ()
+		{
+			// the delay to all deadlines has been changed
+			ibrcommon::MutexLock l(_cond);
+			_armed = 0;
+			__arm();
+		}
+
+		const std::string DeadlineScheduler::getName() const
+		{
+			return "DeadlineScheduler";
+		}
+
+		void DeadlineScheduler::__remove(Listener &listener)
+		{
+			listener_map::iterator it = _listeners.find(&listener);
+			if (it == _listeners.end()) return;
+
+			_deadlines.erase(it->second);
+			_listeners.erase(it);
+		}
+
+		size_t DeadlineScheduler::__delay() const
+		{
+			const dtn::data::Timestamp now = dtn::utils::Clock::getTime();
+			const dtn::data::Timestamp &next = _deadlines.begin()->first;
+
+			if (next <= now) return 1;
+			return (next - now).get<size_t>();
+		}
+
+		void DeadlineScheduler::__arm()
+		{
+			// deadlines are only processed while the component is up,
+			// an idle timer stops itself on the next expiration
+			if (!_running || _deadlines.empty()) return;
+
+			// do not touch the timer if the earliest deadline is unchanged
+			const dtn::data::Timestamp &next = _deadlines.begin()->first;
+			if (next == _armed) return;
+
+			_armed = next;
+			_timer.set(__delay());
+			_timer.start();
+		}
+	} /* namespace core */
+} /* namespace dtn */
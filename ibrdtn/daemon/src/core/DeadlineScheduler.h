@@ -0,0 +1,149 @@
+/*
+ * DeadlineScheduler.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef DEADLINESCHEDULER_H_
+#define DEADLINESCHEDULER_H_
+
+#include "Component.h"
+#include "core/EventReceiver.h"
+#include "core/TimeAdjustmentEvent.h"
+#include <ibrdtn/data/Number.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/thread/Timer.h>
+#include <pthread.h>
+#include <map>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * The deadline scheduler calls registered listeners once the DTN
+		 * time reaches their deadline. Components with expiring data register
+		 * their earliest expiration here instead of sweeping on every TimeEvent.
+		 * A single timer is armed for the earliest deadline and stays idle if
+		 * no deadline is pending. The timer runs only while the component is
+		 * up, but deadlines can always be processed using trigger().
+		 */
+		class DeadlineScheduler : public dtn::daemon::IntegratedComponent, public ibrcommon::TimerCallback, public dtn::core::EventReceiver<dtn::core::TimeAdjustmentEvent>
+		{
+		public:
+			class Listener {
+			public:
+				virtual ~Listener() = 0;
+
+				/**
+				 * Called when the deadline of this listener is reached. The
+				 * deadline is removed before, so the listener has to schedule
+				 * its next deadline again.
+				 * @param now The current DTN time
+				 */
+				virtual void eventDeadline(const dtn::data::Timestamp &now) throw () = 0;
+			};
+
+			DeadlineScheduler();
+			virtual ~DeadlineScheduler();
+
+			/**
+			 * Set the deadline of a listener. Each listener has at most one
+			 * deadline, an existing one is replaced. A deadline of zero
+			 * removes the listener.
+			 */
+			void schedule(Listener &listener, const dtn::data::Timestamp &deadline);
+
+			/**
+			 * Remove the deadline of a listener. If the listener is called
+			 * right now, this method blocks until the call has returned.
+			 */
+			void cancel(Listener &listener);
+
+			/**
+			 * Call all listeners with a deadline equal or lower than the
+			 * given timestamp in the context of the calling thread.
+			 */
+			void trigger(const dtn::data::Timestamp &now);
+
+			/**
+			 * Returns the number of pending deadlines
+			 */
+			dtn::data::Size size();
+
+			/**
+			 * timer callback method
+			 * @see TimerCallback::timeout()
+			 */
+			virtual size_t timeout(ibrcommon::Timer*);
+
+			/**
+			 * Re-arm the timer if the DTN clock has been adjusted
+			 */
+			void raiseEvent(const dtn::core::TimeAdjustmentEvent &evt) throw ();
+
+			/**
+			 * @see Component::getName()
+			 */
+			virtual const std::string getName() const;
+
+		protected:
+			virtual void componentUp() throw ();
+			virtual void componentDown() throw ();
+
+		private:
+			typedef std::multimap<dtn::data::Timestamp, Listener*> deadline_map;
+			typedef std::map<Listener*, deadline_map::iterator> listener_map;
+
+			/**
+			 * Remove the deadline of a listener, the lock has to be held
+			 */
+			void __remove(Listener &listener);
+
+			/**
+			 * Returns the seconds until the earliest deadline, the lock has to be held
+			 */
+			size_t __delay() const;
+
+			/**
+			 * Arm the timer for the earliest deadline, the lock has to be held
+			 */
+			void __arm();
+
+			// serializes concurrent calls of trigger()
+			ibrcommon::Mutex _trigger_lock;
+
+			ibrcommon::Conditional _cond;
+			deadline_map _deadlines;
+			listener_map _listeners;
+
+			// the listener called right now
+			Listener *_current;
+			pthread_t _current_thread;
+
+			// deadline the timer is armed for
+			dtn::data::Timestamp _armed;
+
+			// true, if the timer is allowed to run
+			bool _running;
+
+			ibrcommon::Timer _timer;
+		};
+	} /* namespace core */
+} /* namespace dtn */
+
+#endif /* DEADLINESCHEDULER_H_ */
@@ -0,0 +1,207 @@
+/*
+ * LatencyHistogram.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/LatencyHistogram.h"
+#include <pthread.h>
+#include <string.h>
+
+namespace dtn
+{
+	namespace core
+	{
+		LatencyHistogram::Stripe::Stripe()
+		 : sum(0), max(0)
+		{
+			::memset(buckets, 0, sizeof(buckets));
+		}
+
+		LatencyHistogram::Stripe::~Stripe()
+		{
+		}
+
+		LatencyHistogram::LatencyHistogram()
+		{
+		}
+
+		LatencyHistogram::~LatencyHistogram()
+		{
+		}
+
+		unsigned int LatencyHistogram::getBucket(uint64_t value)
+		{
+			// small values have a bucket of their own
+			if (value < 16) return static_cast<unsigned int>(value);
+
+			// position of the most significant bit
+			const unsigned int msb = 63 - __builtin_clzll(value);
+			const unsigned int shift = msb - 3;
+
+			// the three bits below the most significant bit select the sub-bucket
+			return 16 + ((shift - 1) * 8) + static_cast<unsigned int>((value >> shift) - 8);
+		}
+
+		uint64_t LatencyHistogram::getLowerBound(unsigned int bucket)
+		{
+			if (bucket < 16) return bucket;
+
+			const unsigned int shift = ((bucket - 16) / 8) + 1;
+			return static_cast<uint64_t>(((bucket - 16) % 8) + 8) << shift;
+		}
+
+		uint64_t LatencyHistogram::getUpperBound(unsigned int bucket)
+		{
+			if (bucket < 16) return bucket;
+
+			const unsigned int shift = ((bucket - 16) / 8) + 1;
+			return getLowerBound(bucket) + ((static_cast<uint64_t>(1) << shift) - 1);
+		}
+
+		void LatencyHistogram::record(uint64_t value) throw ()
+		{
+			// select the stripe of the calling thread
+			size_t h = (size_t)pthread_self();
+			h ^= (h >> 12) ^ (h >> 23);
+			Stripe &s = _stripes[h % STRIPES];
+
+			__sync_fetch_and_add(&s.buckets[getBucket(value)], 1);
+			__sync_fetch_and_add(&s.sum, value);
+
+			// raise the maximum
+			uint64_t current = s.max;
+			while (value > current)
+			{
+				const uint64_t prev = __sync_val_compare_and_swap(&s.max, current, value);
+				if (prev == current) break;
+				current = prev;
+			}
+		}
+
+		void LatencyHistogram::__merge(uint64_t *buckets) const
+		{
+			::memset(buckets, 0, sizeof(uint64_t) * BUCKETS);
+
+			for (unsigned int i = 0; i < STRIPES; ++i)
+			{
+				for (unsigned int b = 0; b < BUCKETS; ++b)
+				{
+					buckets[b] += _stripes[i].buckets[b];
+				}
+			}
+		}
+
+		uint64_t LatencyHistogram::count() const
+		{
+			uint64_t ret = 0;
+
+			for (unsigned int i = 0; i < STRIPES; ++i)
+			{
+				for (unsigned int b = 0; b < BUCKETS; ++b)
+				{
+					ret += _stripes[i].buckets[b];
+				}
+			}
+
+			return ret;
+		}
+
+		uint64_t LatencyHistogram::mean() const
+		{
+			const uint64_t c = count();
+			if (c == 0) return 0;
+
+			uint64_t sum = 0;
+			for (unsigned int i = 0; i < STRIPES; ++i)
+			{
+				sum += _stripes[i].sum;
+			}
+
+			return sum / c;
+		}
+
+		uint64_t LatencyHistogram::max() const
+		{
+			uint64_t ret = 0;
+
+			for (unsigned int i = 0; i < STRIPES; ++i)
+			{
+				if (_stripes[i].max > ret) ret = _stripes[i].max;
+			}
+
+			return ret;
+		}
+
+		uint64_t LatencyHistogram::percentile(double p) const
+		{
+			uint64_t buckets[BUCKETS];
+			__merge(buckets);
+
+			uint64_t total = 0;
+			for (unsigned int b = 0; b < BUCKETS; ++b) total += buckets[b];
+			if (total == 0) return 0;
+
+			// number of values at or below the percentile
+			uint64_t rank = static_cast<uint64_t>((p / 100.0) * static_cast<double>(total) + 0.5);
+			if (rank < 1) rank = 1;
+			if (rank > total) rank = total;
+
+			uint64_t seen = 0;
+			for (unsigned int b = 0; b < BUCKETS; ++b)
+			{
+				seen += buckets[b];
+				if (seen >= rank)
+				{
+					// do not report more than the largest value
+					const uint64_t upper = getUpperBound(b);
+					const uint64_t m = max();
+					return (m < upper) ? m : upper;
+				}
+			}
+
+			return max();
+		}
+
+		void LatencyHistogram::reset()
+		{
+			for (unsigned int i = 0; i < STRIPES; ++i)
+			{
+				Stripe &s = _stripes[i];
+
+				for (unsigned int b = 0; b < BUCKETS; ++b)
+				{
+					__sync_lock_test_and_set(&s.buckets[b], 0);
+				}
+
+				__sync_lock_test_and_set(&s.sum, 0);
+				__sync_lock_test_and_set(&s.max, 0);
+			}
+		}
+
+		void LatencyHistogram::dump(std::ostream &stream) const
+		{
+			uint64_t buckets[BUCKETS];
+			__merge(buckets);
+
+			for (unsigned int b = 0; b < BUCKETS; ++b)
+			{
+				if (buckets[b] == 0) continue;
+				stream << getLowerBound(b) << " " << getUpperBound(b) << " " << buckets[b] << std::endl;
+			}
+		}
+	} /* namespace core */
+} /* namespace dtn */
@@ -0,0 +1,126 @@
+/*
+ * LatencyHistogram.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef LATENCYHISTOGRAM_H_
+#define LATENCYHISTOGRAM_H_
+
+#include <stdint.h>
+#include <iostream>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Histogram of latency values in microseconds. The buckets grow
+		 * exponentially and each power of two is divided into eight linear
+		 * sub-buckets, thus the relative error of a recorded value is below
+		 * 12.5 percent. Values are recorded without locks into one of
+		 * several stripes selected by the calling thread. The stripes are
+		 * merged on read.
+		 */
+		class LatencyHistogram
+		{
+		public:
+			LatencyHistogram();
+			virtual ~LatencyHistogram();
+
+			/**
+			 * Record a value
+			 * @param value Latency in microseconds
+			 */
+			void record(uint64_t value) throw ();
+
+			/**
+			 * Returns the number of recorded values
+			 */
+			uint64_t count() const;
+
+			/**
+			 * Returns the mean of all recorded values
+			 */
+			uint64_t mean() const;
+
+			/**
+			 * Returns the largest recorded value
+			 */
+			uint64_t max() const;
+
+			/**
+			 * Returns the upper bound of the bucket holding the given
+			 * percentile of all values
+			 * @param p Percentile between 0 and 100
+			 */
+			uint64_t percentile(double p) const;
+
+			/**
+			 * Clear all recorded values
+			 */
+			void reset();
+
+			/**
+			 * Write all non-empty buckets as lines of lower bound,
+			 * upper bound and count
+			 */
+			void dump(std::ostream &stream) const;
+
+			/**
+			 * Returns the bucket of a value
+			 */
+			static unsigned int getBucket(uint64_t value);
+
+			/**
+			 * Returns the lowest value of a bucket
+			 */
+			static uint64_t getLowerBound(unsigned int bucket);
+
+			/**
+			 * Returns the highest value of a bucket
+			 */
+			static uint64_t getUpperBound(unsigned int bucket);
+
+			// number of buckets
+			static const unsigned int BUCKETS = 16 + (60 * 8);
+
+		private:
+			// number of stripes
+			static const unsigned int STRIPES = 8;
+
+			class Stripe
+			{
+			public:
+				Stripe();
+				~Stripe();
+
+				uint64_t buckets[BUCKETS];
+				uint64_t sum;
+				uint64_t max;
+			};
+
+			/**
+			 * Merge the buckets of all stripes
+			 */
+			void __merge(uint64_t *buckets) const;
+
+			Stripe _stripes[STRIPES];
+		};
+	} /* namespace core */
+} /* namespace dtn */
+
+#endif /* LATENCYHISTOGRAM_H_ */
@@ -0,0 +1,228 @@
+/*
+ * LatencyTracer.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/LatencyTracer.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <sstream>
+#include <time.h>
+#include <sys/time.h>
+
+namespace dtn
+{
+	namespace core
+	{
+		const dtn::data::Size LatencyTracer::TRACES_MAX = 10000;
+		const uint64_t LatencyTracer::TRACE_TIMEOUT = 3600ULL * 1000000ULL;
+
+		LatencyTracer::Trace::Trace()
+		{
+			for (unsigned int i = 0; i < STAGE_MAX; ++i) stages[i] = 0;
+		}
+
+		LatencyTracer::Trace::~Trace()
+		{
+		}
+
+		LatencyTracer::LatencyTracer()
+		 : _sampling(0)
+		{
+		}
+
+		LatencyTracer::~LatencyTracer()
+		{
+		}
+
+		LatencyTracer& LatencyTracer::getInstance()
+		{
+			static LatencyTracer instance;
+			return instance;
+		}
+
+		void LatencyTracer::setSampling(const dtn::data::Size &n)
+		{
+			_sampling = n;
+		}
+
+		const dtn::data::Size& LatencyTracer::getSampling() const
+		{
+			return _sampling;
+		}
+
+		uint64_t LatencyTracer::__now()
+		{
+#ifdef CLOCK_MONOTONIC
+			struct timespec ts;
+			::clock_gettime(CLOCK_MONOTONIC, &ts);
+			return (static_cast<uint64_t>(ts.tv_sec) * 1000000ULL) + (ts.tv_nsec / 1000);
+#else
+			struct timeval tv;
+			::gettimeofday(&tv, NULL);
+			return (static_cast<uint64_t>(tv.tv_sec) * 1000000ULL) + tv.tv_usec;
+#endif
+		}
+
+		void LatencyTracer::mark(const dtn::data::BundleID &id, Stage stage) throw ()
+		{
+			const dtn::data::Size sampling = _sampling;
+			if (sampling == 0) return;
+
+			// select bundles by their sequence number
+			if (((id.timestamp.get<dtn::data::Size>() + id.sequencenumber.get<dtn::data::Size>()) % sampling) != 0) return;
+
+			const uint64_t now = __now();
+			uint64_t stages[STAGE_MAX];
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				if (stage == STAGE_RECEIVED)
+				{
+					// drop outdated traces of bundles never transmitted
+					while (!_ages.empty())
+					{
+						const std::pair<uint64_t, dtn::data::BundleID> &front = _ages.front();
+						trace_map::iterator it = _traces.find(front.second);
+
+						// the trace has been completed or replaced
+						const bool stale = (it == _traces.end()) || (it->second.stages[STAGE_RECEIVED] != front.first);
+
+						if (!stale && (_traces.size() < TRACES_MAX) && (_ages.size() <= (2 * TRACES_MAX))
+								&& ((now - front.first) <= TRACE_TIMEOUT)) break;
+
+						if (!stale) _traces.erase(it);
+						_ages.pop_front();
+					}
+
+					Trace &t = _traces[id];
+					t = Trace();
+					t.stages[STAGE_RECEIVED] = now;
+					_ages.push_back(std::make_pair(now, id));
+					return;
+				}
+
+				trace_map::iterator it = _traces.find(id);
+				if (it == _traces.end()) return;
+
+				Trace &t = it->second;
+
+				// only the first occurrence of a stage is recorded
+				if (t.stages[stage] != 0) return;
+				t.stages[stage] = now;
+
+				for (unsigned int i = 0; i < STAGE_MAX; ++i) stages[i] = t.stages[i];
+
+				// the trace is complete
+				if (stage == STAGE_TRANSMITTED) _traces.erase(it);
+			}
+
+			// record the intervals without the lock
+			switch (stage)
+			{
+				case STAGE_STORED:
+					_histograms[INTERVAL_STORAGE].record(now - stages[STAGE_RECEIVED]);
+					break;
+
+				case STAGE_QUEUED:
+					if (stages[STAGE_STORED] != 0) _histograms[INTERVAL_ROUTING].record(now - stages[STAGE_STORED]);
+					break;
+
+				case STAGE_TRANSMITTED:
+					if (stages[STAGE_QUEUED] != 0) _histograms[INTERVAL_TRANSFER].record(now - stages[STAGE_QUEUED]);
+					_histograms[INTERVAL_TOTAL].record(now - stages[STAGE_RECEIVED]);
+					break;
+
+				default:
+					break;
+			}
+		}
+
+		const LatencyHistogram& LatencyTracer::get(Interval i) const
+		{
+			return _histograms[i];
+		}
+
+		const std::string LatencyTracer::getName(Interval i)
+		{
+			switch (i)
+			{
+				case INTERVAL_STORAGE:
+					return "Storage";
+				case INTERVAL_ROUTING:
+					return "Routing";
+				case INTERVAL_TRANSFER:
+					return "Transfer";
+				case INTERVAL_TOTAL:
+					return "Total";
+				default:
+					return "Unknown";
+			}
+		}
+
+		dtn::data::Size LatencyTracer::size()
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _traces.size();
+		}
+
+		void LatencyTracer::reset()
+		{
+			{
+				ibrcommon::MutexLock l(_lock);
+				_traces.clear();
+				_ages.clear();
+			}
+
+			for (unsigned int i = 0; i < INTERVAL_MAX; ++i)
+			{
+				_histograms[i].reset();
+			}
+		}
+
+		void LatencyTracer::summary(std::ostream &stream) const
+		{
+			for (unsigned int i = 0; i < INTERVAL_MAX; ++i)
+			{
+				const LatencyHistogram &h = _histograms[i];
+
+				stream << getName(Interval(i)) << ": count=" << h.count()
+						<< " mean=" << h.mean()
+						<< " p50=" << h.percentile(50)
+						<< " p90=" << h.percentile(90)
+						<< " p99=" << h.percentile(99)
+						<< " p99.9=" << h.percentile(99.9)
+						<< " max=" << h.max() << std::endl;
+			}
+		}
+
+		void LatencyTracer::dump(std::ostream &stream) const
+		{
+			for (unsigned int i = 0; i < INTERVAL_MAX; ++i)
+			{
+				std::stringstream ss;
+				_histograms[i].dump(ss);
+
+				std::string line;
+				while (std::getline(ss, line))
+				{
+					stream << getName(Interval(i)) << " " << line << std::endl;
+				}
+			}
+		}
+	} /* namespace core */
+} /* namespace dtn */
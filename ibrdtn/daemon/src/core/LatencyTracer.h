@@ -0,0 +1,149 @@
+/*
+ * LatencyTracer.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef LATENCYTRACER_H_
+#define LATENCYTRACER_H_
+
+#include "core/LatencyHistogram.h"
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/Number.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <stdint.h>
+#include <iostream>
+#include <string>
+#include <list>
+#include <map>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Records the points in time a bundle passes the stages of its
+		 * lifecycle in the daemon. Only a sample of all bundles is traced,
+		 * the time between two stages is added to the histogram of the
+		 * interval.
+		 */
+		class LatencyTracer
+		{
+		public:
+			enum Stage
+			{
+				STAGE_RECEIVED = 0,		// handed over to BundleCore::inject()
+				STAGE_STORED = 1,		// put into the storage
+				STAGE_QUEUED = 2,		// first transfer queued by the routing
+				STAGE_TRANSMITTED = 3,	// first transfer completed
+				STAGE_MAX = 4
+			};
+
+			enum Interval
+			{
+				INTERVAL_STORAGE = 0,	// received -> stored
+				INTERVAL_ROUTING = 1,	// stored -> queued
+				INTERVAL_TRANSFER = 2,	// queued -> transmitted
+				INTERVAL_TOTAL = 3,		// received -> transmitted
+				INTERVAL_MAX = 4
+			};
+
+			static LatencyTracer& getInstance();
+
+			/**
+			 * Trace one of every n bundles. Zero disables the tracing.
+			 */
+			void setSampling(const dtn::data::Size &n);
+
+			/**
+			 * Returns the sampling interval
+			 */
+			const dtn::data::Size& getSampling() const;
+
+			/**
+			 * Record that a bundle has reached a stage
+			 */
+			void mark(const dtn::data::BundleID &id, Stage stage) throw ();
+
+			/**
+			 * Returns the histogram of an interval
+			 */
+			const LatencyHistogram& get(Interval i) const;
+
+			/**
+			 * Returns the name of an interval
+			 */
+			static const std::string getName(Interval i);
+
+			/**
+			 * Returns the number of bundles currently traced
+			 */
+			dtn::data::Size size();
+
+			/**
+			 * Clear all histograms and traces
+			 */
+			void reset();
+
+			/**
+			 * Write a summary of all intervals
+			 */
+			void summary(std::ostream &stream) const;
+
+			/**
+			 * Write the buckets of all intervals
+			 */
+			void dump(std::ostream &stream) const;
+
+		private:
+			LatencyTracer();
+			virtual ~LatencyTracer();
+
+			/**
+			 * Returns the monotonic time in microseconds
+			 */
+			static uint64_t __now();
+
+			class Trace
+			{
+			public:
+				Trace();
+				~Trace();
+
+				uint64_t stages[STAGE_MAX];
+			};
+
+			typedef std::map<dtn::data::BundleID, Trace> trace_map;
+			typedef std::list<std::pair<uint64_t, dtn::data::BundleID> > age_list;
+
+			// maximum number of traced bundles
+			static const dtn::data::Size TRACES_MAX;
+
+			// traces are dropped after this number of microseconds
+			static const uint64_t TRACE_TIMEOUT;
+
+			dtn::data::Size _sampling;
+
+			ibrcommon::Mutex _lock;
+			trace_map _traces;
+			age_list _ages;
+
+			LatencyHistogram _histograms[INTERVAL_MAX];
+		};
+	} /* namespace core */
+} /* namespace dtn */
+
+#endif /* LATENCYTRACER_H_ */
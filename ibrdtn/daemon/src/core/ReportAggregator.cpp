@@ -0,0 +1,357 @@
+/*
+ * ReportAggregator.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "core/ReportAggregator.h"
+#include "core/BundleCore.h"
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/Logger.h>
+
+namespace dtn
+{
+	namespace core
+	{
+		const std::string ReportAggregator::TAG = "ReportAggregator";
+
+		const dtn::data::Size ReportAggregator::MAX_BUNDLES = 1024;
+
+		ReportAggregator::ReportAggregator()
+		 : _window(0), _records(0), _bundles(0)
+		{
+		}
+
+		ReportAggregator::~ReportAggregator()
+		{
+		}
+
+		void ReportAggregator::setWindow(const dtn::data::Timeout &window)
+		{
+			{
+				ibrcommon::MutexLock l(_lock);
+				_window = window;
+			}
+
+			// send pending aggregates if the aggregation is disabled
+			if (window == 0) flush();
+		}
+
+		void ReportAggregator::setSupported(const dtn::data::EID &node)
+		{
+			ibrcommon::MutexLock l(_lock);
+			if (_supported.insert(node.getNode()).second)
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(ReportAggregator::TAG, 10) << "aggregate records supported by " << node.getNode().getString() << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		bool ReportAggregator::isSupported(const dtn::data::EID &endpoint) const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return __isSupported(endpoint);
+		}
+
+		bool ReportAggregator::__isSupported(const dtn::data::EID &endpoint) const
+		{
+			// local applications get aggregates expanded by the API
+			if (endpoint.sameHost(dtn::core::BundleCore::local)) return true;
+
+			return (_supported.find(endpoint.getNode()) != _supported.end());
+		}
+
+		bool ReportAggregator::add(const dtn::data::MetaBundle &b, dtn::data::StatusReportBlock::TYPE type, dtn::data::StatusReportBlock::REASON_CODE reason)
+		{
+			std::list<dtn::data::Bundle> bundles;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				_records++;
+
+				if ((_window == 0) || b.isFragment() || !__isSupported(b.reportto))
+				{
+					_bundles++;
+					return false;
+				}
+
+				const ReportKey key(b.reportto, static_cast<char>(type), static_cast<char>(reason), b.get(dtn::data::PrimaryBlock::DTNSEC_STATUS_VERIFIED));
+				Pending<dtn::data::AggregateStatusReportBlock> &p = _reports[key];
+
+				if (p.block.bundles.empty())
+				{
+					p.block.status = key.status;
+					p.block.reasoncode = key.reason;
+					p.block.timeofreport.set();
+					p.deadline = dtn::utils::Clock::getTime() + _window;
+					__schedule();
+				}
+
+				p.block.bundles.add(b);
+
+				// the aggregate lives as long as the longest living bundle
+				if (p.lifetime < b.lifetime) p.lifetime = b.lifetime;
+
+				if (p.block.bundles.size() >= MAX_BUNDLES)
+				{
+					bundles.push_back(create(key, p));
+					_reports.erase(key);
+				}
+			}
+
+			send(bundles);
+			return true;
+		}
+
+		bool ReportAggregator::add(const dtn::data::MetaBundle &b, bool accepted, dtn::data::CustodySignalBlock::REASON_CODE reason)
+		{
+			std::list<dtn::data::Bundle> bundles;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				_records++;
+
+				if ((_window == 0) || b.isFragment() || !__isSupported(b.custodian))
+				{
+					_bundles++;
+					return false;
+				}
+
+				const SignalKey key(b.custodian, accepted, reason);
+				Pending<dtn::data::AggregateCustodySignalBlock> &p = _signals[key];
+
+				if (p.block.bundles.empty())
+				{
+					p.block.custody_accepted = accepted;
+					p.block.reason = reason;
+					p.block.timeofsignal.set();
+					p.deadline = dtn::utils::Clock::getTime() + _window;
+					__schedule();
+				}
+
+				p.block.bundles.add(b);
+
+				if (p.block.bundles.size() >= MAX_BUNDLES)
+				{
+					bundles.push_back(create(key, p));
+					_signals.erase(key);
+				}
+			}
+
+			send(bundles);
+			return true;
+		}
+
+		void ReportAggregator::flush()
+		{
+			std::list<dtn::data::Bundle> bundles;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				for (report_map::const_iterator it = _reports.begin(); it != _reports.end(); ++it)
+				{
+					bundles.push_back(create((*it).first, (*it).second));
+				}
+				_reports.clear();
+
+				for (signal_map::const_iterator it = _signals.begin(); it != _signals.end(); ++it)
+				{
+					bundles.push_back(create((*it).first, (*it).second));
+				}
+				_signals.clear();
+
+				// remove the pending deadline
+				__schedule();
+			}
+
+			send(bundles);
+		}
+
+		void ReportAggregator::eventDeadline(const dtn::data::Timestamp &now) throw ()
+		{
+			std::list<dtn::data::Bundle> bundles;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				__collect(now, bundles);
+				__schedule();
+			}
+
+			send(bundles);
+		}
+
+		dtn::data::Size ReportAggregator::getRecords() const
+		{
+			return _records;
+		}
+
+		dtn::data::Size ReportAggregator::getBundles() const
+		{
+			return _bundles;
+		}
+
+		void ReportAggregator::resetStats()
+		{
+			ibrcommon::MutexLock l(_lock);
+			_records = 0;
+			_bundles = 0;
+		}
+
+		void ReportAggregator::__collect(const dtn::data::Timestamp &now, std::list<dtn::data::Bundle> &bundles)
+		{
+			for (report_map::iterator it = _reports.begin(); it != _reports.end();)
+			{
+				if ((*it).second.deadline <= now)
+				{
+					bundles.push_back(create((*it).first, (*it).second));
+					_reports.erase(it++);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			for (signal_map::iterator it = _signals.begin(); it != _signals.end();)
+			{
+				if ((*it).second.deadline <= now)
+				{
+					bundles.push_back(create((*it).first, (*it).second));
+					_signals.erase(it++);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		void ReportAggregator::__schedule()
+		{
+			dtn::data::Timestamp next = 0;
+
+			for (report_map::const_iterator it = _reports.begin(); it != _reports.end(); ++it)
+			{
+				if ((next == 0) || ((*it).second.deadline < next)) next = (*it).second.deadline;
+			}
+
+			for (signal_map::const_iterator it = _signals.begin(); it != _signals.end(); ++it)
+			{
+				if ((next == 0) || ((*it).second.deadline < next)) next = (*it).second.deadline;
+			}
+
+			// a deadline of zero removes this listener
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, next);
+		}
+
+		void ReportAggregator::send(std::list<dtn::data::Bundle> &bundles)
+		{
+			for (std::list<dtn::data::Bundle>::iterator it = bundles.begin(); it != bundles.end(); ++it)
+			{
+				try {
+					dtn::core::BundleCore::getInstance().inject(dtn::core::BundleCore::local, *it, true);
+				} catch (const std::exception &ex) {
+					IBRCOMMON_LOGGER_TAG(ReportAggregator::TAG, warning) << "aggregate record not sent: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+
+			if (bundles.empty()) return;
+
+			ibrcommon::MutexLock l(_lock);
+			_bundles += bundles.size();
+		}
+
+		dtn::data::Bundle ReportAggregator::create(const ReportKey &key, const Pending<dtn::data::AggregateStatusReportBlock> &p)
+		{
+			dtn::data::Bundle bundle;
+
+			bundle.set(dtn::data::PrimaryBlock::APPDATA_IS_ADMRECORD, true);
+
+			// set source and destination
+			bundle.source = dtn::core::BundleCore::local;
+			bundle.set(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON, true);
+			bundle.destination = key.reportto;
+
+			// set lifetime to the longest lifetime of the reported bundles
+			bundle.lifetime = p.lifetime;
+
+			// sign the report if the references were signed too
+			if (key.sign) bundle.set(dtn::data::PrimaryBlock::DTNSEC_REQUEST_SIGN, true);
+
+			dtn::data::PayloadBlock &payload = bundle.push_back<dtn::data::PayloadBlock>();
+			p.block.write(payload);
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(ReportAggregator::TAG, 20) << "status report for " << p.block.bundles.size() << " bundles to " << key.reportto.getString() << IBRCOMMON_LOGGER_ENDL;
+
+			return bundle;
+		}
+
+		dtn::data::Bundle ReportAggregator::create(const SignalKey &key, const Pending<dtn::data::AggregateCustodySignalBlock> &p)
+		{
+			dtn::data::Bundle bundle;
+
+			// set priority to HIGH
+			bundle.set(dtn::data::PrimaryBlock::PRIORITY_BIT1, false);
+			bundle.set(dtn::data::PrimaryBlock::PRIORITY_BIT2, true);
+
+			bundle.set(dtn::data::PrimaryBlock::APPDATA_IS_ADMRECORD, true);
+			bundle.set(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON, true);
+			bundle.destination = key.custodian;
+			bundle.source = dtn::core::BundleCore::local;
+
+			// always sign custody signals
+			bundle.set(dtn::data::PrimaryBlock::DTNSEC_REQUEST_SIGN, true);
+
+			dtn::data::PayloadBlock &payload = bundle.push_back<dtn::data::PayloadBlock>();
+			p.block.write(payload);
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(ReportAggregator::TAG, 20) << "custody signal for " << p.block.bundles.size() << " bundles to " << key.custodian.getString() << IBRCOMMON_LOGGER_ENDL;
+
+			return bundle;
+		}
+
+		ReportAggregator::ReportKey::ReportKey(const dtn::data::EID &r, char s, char rc, bool sg)
+		 : reportto(r), status(s), reason(rc), sign(sg)
+		{
+		}
+
+		bool ReportAggregator::ReportKey::operator<(const ReportKey &other) const
+		{
+			if (reportto < other.reportto) return true;
+			if (reportto != other.reportto) return false;
+
+			if (status != other.status) return (status < other.status);
+			if (reason != other.reason) return (reason < other.reason);
+
+			return (sign < other.sign);
+		}
+
+		ReportAggregator::SignalKey::SignalKey(const dtn::data::EID &c, bool a, dtn::data::CustodySignalBlock::REASON_CODE r)
+		 : custodian(c), accepted(a), reason(r)
+		{
+		}
+
+		bool ReportAggregator::SignalKey::operator<(const SignalKey &other) const
+		{
+			if (custodian < other.custodian) return true;
+			if (custodian != other.custodian) return false;
+
+			if (accepted != other.accepted) return (accepted < other.accepted);
+
+			return (reason < other.reason);
+		}
+	} /* namespace core */
+} /* namespace dtn */
@@ -0,0 +1,187 @@
+/*
+ * ReportAggregator.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef REPORTAGGREGATOR_H_
+#define REPORTAGGREGATOR_H_
+
+#include "core/DeadlineScheduler.h"
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrdtn/data/StatusReportBlock.h>
+#include <ibrdtn/data/CustodySignalBlock.h>
+#include <ibrdtn/data/AggregateStatusReportBlock.h>
+#include <ibrdtn/data/AggregateCustodySignalBlock.h>
+#include <ibrdtn/data/Number.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <map>
+#include <list>
+#include <set>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * Collects status reports and custody signals with the same
+		 * recipient and status for a short window and sends them as one
+		 * aggregate record. Fragments and records of a disabled aggregator
+		 * are rejected and have to be sent individually by the caller.
+		 */
+		class ReportAggregator : public dtn::core::DeadlineScheduler::Listener
+		{
+		public:
+			static const std::string TAG;
+
+			// send an aggregate as soon as it covers this number of bundles
+			static const dtn::data::Size MAX_BUNDLES;
+
+			ReportAggregator();
+			virtual ~ReportAggregator();
+
+			/**
+			 * Set the aggregation window in seconds. Zero disables the
+			 * aggregation and sends all pending records.
+			 */
+			void setWindow(const dtn::data::Timeout &window);
+
+			/**
+			 * Mark a node as capable of aggregate records. Records to nodes
+			 * without this mark are always sent individually, as the
+			 * aggregate record types are not understood by other
+			 * implementations.
+			 */
+			void setSupported(const dtn::data::EID &node);
+
+			/**
+			 * Returns true if aggregate records may be sent to the given
+			 * endpoint.
+			 */
+			bool isSupported(const dtn::data::EID &endpoint) const;
+
+			/**
+			 * Add a status report for the given bundle.
+			 * @return False, if the report has to be sent individually.
+			 */
+			bool add(const dtn::data::MetaBundle &b, dtn::data::StatusReportBlock::TYPE type, dtn::data::StatusReportBlock::REASON_CODE reason);
+
+			/**
+			 * Add a custody signal for the given bundle.
+			 * @return False, if the signal has to be sent individually.
+			 */
+			bool add(const dtn::data::MetaBundle &b, bool accepted, dtn::data::CustodySignalBlock::REASON_CODE reason);
+
+			/**
+			 * Send all pending aggregates
+			 */
+			void flush();
+
+			/**
+			 * @see DeadlineScheduler::Listener::eventDeadline()
+			 */
+			virtual void eventDeadline(const dtn::data::Timestamp &now) throw ();
+
+			/**
+			 * Returns the number of status reports and custody signals
+			 * generated, aggregated or not.
+			 */
+			dtn::data::Size getRecords() const;
+
+			/**
+			 * Returns the number of bundles sent to carry the records.
+			 */
+			dtn::data::Size getBundles() const;
+
+			void resetStats();
+
+		private:
+			class ReportKey
+			{
+			public:
+				ReportKey(const dtn::data::EID &reportto, char status, char reason, bool sign);
+				bool operator<(const ReportKey &other) const;
+
+				dtn::data::EID reportto;
+				char status;
+				char reason;
+				bool sign;
+			};
+
+			class SignalKey
+			{
+			public:
+				SignalKey(const dtn::data::EID &custodian, bool accepted, dtn::data::CustodySignalBlock::REASON_CODE reason);
+				bool operator<(const SignalKey &other) const;
+
+				dtn::data::EID custodian;
+				bool accepted;
+				dtn::data::CustodySignalBlock::REASON_CODE reason;
+			};
+
+			template<class T>
+			class Pending
+			{
+			public:
+				Pending() : deadline(0), lifetime(0) { };
+
+				T block;
+				dtn::data::Timestamp deadline;
+				dtn::data::Number lifetime;
+			};
+
+			typedef std::map<ReportKey, Pending<dtn::data::AggregateStatusReportBlock> > report_map;
+			typedef std::map<SignalKey, Pending<dtn::data::AggregateCustodySignalBlock> > signal_map;
+
+			/**
+			 * Move all aggregates with a deadline equal or lower than the
+			 * given timestamp into the send lists, the lock has to be held
+			 */
+			void __collect(const dtn::data::Timestamp &now, std::list<dtn::data::Bundle> &bundles);
+
+			/**
+			 * Returns true if aggregate records may be sent to the given
+			 * endpoint, the lock has to be held
+			 */
+			bool __isSupported(const dtn::data::EID &endpoint) const;
+
+			/**
+			 * Schedule the earliest deadline, the lock has to be held
+			 */
+			void __schedule();
+
+			/**
+			 * Inject the bundles into the core
+			 */
+			void send(std::list<dtn::data::Bundle> &bundles);
+
+			static dtn::data::Bundle create(const ReportKey &key, const Pending<dtn::data::AggregateStatusReportBlock> &p);
+			static dtn::data::Bundle create(const SignalKey &key, const Pending<dtn::data::AggregateCustodySignalBlock> &p);
+
+			mutable ibrcommon::Mutex _lock;
+			dtn::data::Timeout _window;
+			report_map _reports;
+			signal_map _signals;
+
+			// nodes known to understand aggregate records
+			std::set<dtn::data::EID> _supported;
+
+			dtn::data::Size _records;
+			dtn::data::Size _bundles;
+		};
+	} /* namespace core */
+} /* namespace dtn */
+#endif /* REPORTAGGREGATOR_H_ */
@@ -42,6 +42,9 @@ namespace dtn
 
 		void StatusReportGenerator::createStatusReport(const dtn::data::MetaBundle &b, StatusReportBlock::TYPE type, StatusReportBlock::REASON_CODE reason)
 		{
+			// collect the report for an aggregate if possible
+			if (dtn::core::BundleCore::getInstance().getReportAggregator().add(b, type, reason)) return;
+
 			// create a new bundle
 			Bundle bundle;
 
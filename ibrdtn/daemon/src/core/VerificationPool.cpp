@@ -0,0 +1,315 @@
+/*
+ * VerificationPool.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "config.h"
+#include "core/VerificationPool.h"
+#include "core/BundleCore.h"
+#include <ibrcommon/Logger.h>
+
+#ifdef IBRDTN_SUPPORT_BSP
+#include <ibrdtn/security/BundleAuthenticationBlock.h>
+#include <ibrdtn/security/PayloadIntegrityBlock.h>
+#endif
+
+namespace dtn
+{
+	namespace core
+	{
+		const std::string VerificationPool::TAG = "VerificationPool";
+
+		VerificationPool& VerificationPool::getInstance()
+		{
+			static VerificationPool instance;
+			return instance;
+		}
+
+		VerificationPool::VerificationPool()
+		 : _running(false)
+		{
+		}
+
+		VerificationPool::~VerificationPool()
+		{
+			stop();
+		}
+
+		void VerificationPool::start(size_t threads)
+		{
+			ibrcommon::MutexLock l(_queue_cond);
+			if (_running || threads == 0) return;
+
+			// reset aborted conditional
+			_queue_cond.reset();
+			_running = true;
+
+			for (size_t i = 0; i < threads; ++i)
+			{
+				Worker *w = new Worker(*this);
+				_workers.push_back(w);
+				w->start();
+			}
+
+			IBRCOMMON_LOGGER_TAG(VerificationPool::TAG, info) << threads << " verification workers started" << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void VerificationPool::stop()
+		{
+			{
+				ibrcommon::MutexLock l(_queue_cond);
+				if (!_running) return;
+
+				// stop accepting new jobs
+				_running = false;
+
+				try {
+					// wait until all queued jobs are taken by the workers
+					while (!_queue.empty())
+					{
+						_queue_cond.wait();
+					}
+
+					_queue_cond.abort();
+				} catch (const ibrcommon::Conditional::ConditionalAbortException&) { };
+			}
+
+			for (std::list<Worker*>::iterator it = _workers.begin(); it != _workers.end(); ++it)
+			{
+				Worker *w = (*it);
+				w->stop();
+				w->join();
+				delete w;
+			}
+			_workers.clear();
+		}
+
+		bool VerificationPool::isRunning()
+		{
+			ibrcommon::MutexLock l(_queue_cond);
+			return _running;
+		}
+
+		bool VerificationPool::isSecured(const dtn::data::Bundle &bundle)
+		{
+#ifdef IBRDTN_SUPPORT_BSP
+			for (dtn::data::Bundle::const_iterator it = bundle.begin(); it != bundle.end(); ++it)
+			{
+				const dtn::data::block_t type = (**it).getType();
+				if (type == dtn::security::BundleAuthenticationBlock::BLOCK_TYPE) return true;
+				if (type == dtn::security::PayloadIntegrityBlock::BLOCK_TYPE) return true;
+			}
+#else
+			(void)bundle;
+#endif
+			return false;
+		}
+
+		bool VerificationPool::queue(Job *job)
+		{
+			ibrcommon::MutexLock l(_queue_cond);
+			if (!_running) return false;
+
+			_queue.push(job);
+			_queue_cond.signal(true);
+			return true;
+		}
+
+		VerificationPool::Job* VerificationPool::next()
+		{
+			try {
+				ibrcommon::MutexLock l(_queue_cond);
+
+				while (_queue.empty())
+				{
+					if (!_running) return NULL;
+					_queue_cond.wait();
+				}
+
+				Job *job = _queue.front();
+				_queue.pop();
+
+				// wake-up stop() if the queue is empty
+				_queue_cond.signal(true);
+
+				return job;
+			} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+				return NULL;
+			}
+		}
+
+		void VerificationPool::process(Job &job)
+		{
+			BundleFilter::ACTION action = BundleFilter::DROP;
+
+			try {
+				action = job.lane.verify(job.peer, job.protocol, job.bundle);
+			} catch (const std::exception &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(VerificationPool::TAG, 2) << "verification of " << job.bundle.toString() << " failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			job.lane.complete(&job, action);
+		}
+
+		VerificationPool::Worker::Worker(VerificationPool &pool)
+		 : _pool(pool)
+		{
+		}
+
+		VerificationPool::Worker::~Worker()
+		{
+		}
+
+		void VerificationPool::Worker::run() throw ()
+		{
+			Job *job = NULL;
+			while ((job = _pool.next()) != NULL)
+			{
+				VerificationPool::process(*job);
+			}
+		}
+
+		void VerificationPool::Worker::__cancellation() throw ()
+		{
+		}
+
+		VerificationPool::Job::Job(Lane &l, const dtn::data::EID &p, const dtn::core::Node::Protocol proto, const dtn::data::Bundle &b)
+		 : lane(l), peer(p), protocol(proto), bundle(b), done(false), action(BundleFilter::DROP)
+		{
+		}
+
+		VerificationPool::Job::~Job()
+		{
+		}
+
+		VerificationPool::Lane::Lane(size_t limit)
+		 : _limit(limit), _injecting(false)
+		{
+		}
+
+		VerificationPool::Lane::~Lane()
+		{
+			flush();
+		}
+
+		bool VerificationPool::Lane::push(const dtn::data::EID &peer, const dtn::core::Node::Protocol protocol, const dtn::data::Bundle &bundle)
+		{
+			VerificationPool &pool = VerificationPool::getInstance();
+			if (!pool.isRunning()) return false;
+
+			ibrcommon::MutexLock l(_cond);
+
+			// unsecured bundles bypass the pool unless they would overtake a pending bundle
+			if (_jobs.empty() && !_injecting && !isSecured(bundle)) return false;
+
+			// block the connection while too many bundles are pending
+			while (_jobs.size() >= _limit)
+			{
+				_cond.wait();
+			}
+
+			Job *job = new Job(*this, peer, protocol, bundle);
+
+			if (!pool.queue(job))
+			{
+				// pool has been stopped in the meantime
+				delete job;
+				return false;
+			}
+
+			_jobs.push_back(job);
+			return true;
+		}
+
+		void VerificationPool::Lane::flush()
+		{
+			ibrcommon::MutexLock l(_cond);
+			while (!_jobs.empty() || _injecting)
+			{
+				_cond.wait();
+			}
+		}
+
+		bool VerificationPool::Lane::isSecured(const dtn::data::Bundle &bundle) const
+		{
+			return VerificationPool::isSecured(bundle);
+		}
+
+		BundleFilter::ACTION VerificationPool::Lane::verify(const dtn::data::EID &peer, const dtn::core::Node::Protocol protocol, dtn::data::Bundle &bundle) const
+		{
+			// push bundle through the filter routines
+			dtn::core::FilterContext context;
+			context.setPeer(peer);
+			context.setProtocol(protocol);
+			context.setBundle(bundle);
+
+			return dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::INPUT, context, bundle);
+		}
+
+		void VerificationPool::Lane::inject(const dtn::data::EID &peer, dtn::data::Bundle &bundle)
+		{
+			dtn::core::BundleCore::getInstance().inject(peer, bundle, false);
+		}
+
+		void VerificationPool::Lane::complete(Job *job, BundleFilter::ACTION action)
+		{
+			ibrcommon::MutexLock l(_cond);
+
+			job->action = action;
+			job->done = true;
+
+			// another worker is already injecting bundles of this lane
+			if (_injecting) return;
+			_injecting = true;
+
+			while (!_jobs.empty() && _jobs.front()->done)
+			{
+				Job *j = _jobs.front();
+				_jobs.pop_front();
+
+				// release a blocked connection
+				_cond.signal(true);
+
+				// do not hold the lock while the bundle is injected
+				_cond.leave();
+
+				try {
+					switch (j->action) {
+						case BundleFilter::ACCEPT:
+							// inject bundle into core
+							inject(j->peer, j->bundle);
+							break;
+
+						default:
+							// bundles verified asynchronously can not be refused anymore
+							IBRCOMMON_LOGGER_DEBUG_TAG(VerificationPool::TAG, 2) << "bundle dropped by input filter: " << j->bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+							break;
+					}
+				} catch (const std::exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(VerificationPool::TAG, 2) << "bundle dropped: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+
+				delete j;
+
+				_cond.enter();
+			}
+
+			_injecting = false;
+			_cond.signal(true);
+		}
+	} /* namespace core */
+} /* namespace dtn */
@@ -0,0 +1,190 @@
+/*
+ * VerificationPool.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef VERIFICATIONPOOL_H_
+#define VERIFICATIONPOOL_H_
+
+#include "core/Node.h"
+#include "core/BundleFilter.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <queue>
+#include <list>
+
+namespace dtn
+{
+	namespace core
+	{
+		/**
+		 * A pool of worker threads which pushes received bundles through
+		 * the input filter. The filter includes the verification of BAB and
+		 * PIB blocks, thus expensive signature checks of secured bundles
+		 * are spread over all workers instead of stalling the receiving
+		 * connection.
+		 */
+		class VerificationPool
+		{
+		public:
+			static const std::string TAG;
+
+			class Job;
+
+			/**
+			 * Each connection owns a lane. Bundles of one lane are injected
+			 * into the core in the order they have been pushed, regardless
+			 * of the worker which verified them.
+			 */
+			class Lane
+			{
+			public:
+				/**
+				 * @param limit Maximum number of pending bundles. A connection
+				 * pushing more bundles is blocked until a bundle has been
+				 * processed.
+				 */
+				Lane(size_t limit = 8);
+				virtual ~Lane();
+
+				/**
+				 * Queue a received bundle for verification.
+				 * @return False, if the bundle has not been queued and has to
+				 * be processed by the caller. This is the case if the pool is
+				 * not running or the bundle is not secured and no other bundle
+				 * of this lane is pending.
+				 */
+				bool push(const dtn::data::EID &peer, const dtn::core::Node::Protocol protocol, const dtn::data::Bundle &bundle);
+
+				/**
+				 * Wait until all pending bundles of this lane are processed.
+				 */
+				void flush();
+
+			protected:
+				/**
+				 * Returns true if the bundle has to be verified by the pool.
+				 */
+				virtual bool isSecured(const dtn::data::Bundle &bundle) const;
+
+				/**
+				 * Push a bundle through the input filter. This is called by
+				 * the workers of the pool.
+				 */
+				virtual BundleFilter::ACTION verify(const dtn::data::EID &peer, const dtn::core::Node::Protocol protocol, dtn::data::Bundle &bundle) const;
+
+				/**
+				 * Inject an accepted bundle into the core
+				 */
+				virtual void inject(const dtn::data::EID &peer, dtn::data::Bundle &bundle);
+
+			private:
+				friend class VerificationPool;
+
+				/**
+				 * Inject all leading bundles which are already processed.
+				 */
+				void complete(Job *job, BundleFilter::ACTION action);
+
+				ibrcommon::Conditional _cond;
+				std::list<Job*> _jobs;
+				const size_t _limit;
+				bool _injecting;
+			};
+
+			class Job
+			{
+			public:
+				Job(Lane &lane, const dtn::data::EID &peer, const dtn::core::Node::Protocol protocol, const dtn::data::Bundle &bundle);
+				~Job();
+
+				Lane &lane;
+				const dtn::data::EID peer;
+				const dtn::core::Node::Protocol protocol;
+				dtn::data::Bundle bundle;
+				bool done;
+				BundleFilter::ACTION action;
+			};
+
+			static VerificationPool& getInstance();
+
+			/**
+			 * Start the given number of worker threads.
+			 */
+			void start(size_t threads);
+
+			/**
+			 * Process all queued bundles and stop the workers.
+			 */
+			void stop();
+
+			/**
+			 * Returns true if the workers are running
+			 */
+			bool isRunning();
+
+			/**
+			 * Returns true if the bundle contains blocks which need
+			 * a verification.
+			 */
+			static bool isSecured(const dtn::data::Bundle &bundle);
+
+		private:
+			class Worker : public ibrcommon::JoinableThread
+			{
+			public:
+				Worker(VerificationPool &pool);
+				virtual ~Worker();
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				VerificationPool &_pool;
+			};
+
+			VerificationPool();
+			virtual ~VerificationPool();
+
+			/**
+			 * Put a job into the queue of the workers.
+			 * @return False, if the pool is not running.
+			 */
+			bool queue(Job *job);
+
+			/**
+			 * Get the next job to process. Blocks until a job is available
+			 * and returns NULL if the pool is stopped.
+			 */
+			Job* next();
+
+			/**
+			 * Verify the bundle of a job
+			 */
+			static void process(Job &job);
+
+			ibrcommon::Conditional _queue_cond;
+			std::queue<Job*> _queue;
+			std::list<Worker*> _workers;
+			bool _running;
+		};
+	} /* namespace core */
+} /* namespace dtn */
+#endif /* VERIFICATIONPOOL_H_ */
@@ -22,7 +22,9 @@
 #include "net/BundleTransfer.h"
 #include "routing/RequeueBundleEvent.h"
 #include "core/BundleEvent.h"
+#include "core/LatencyTracer.h"
 #include "net/TransferCompletedEvent.h"
+#include "net/LinkMetrics.h"
 #include <ibrcommon/thread/MutexLock.h>
 
 namespace dtn
@@ -39,21 +41,28 @@ namespace dtn
 		}
 
 		BundleTransfer::Slot::Slot(const dtn::data::EID &n, const dtn::data::MetaBundle &b, dtn::core::Node::Protocol p)
-		 : neighbor(n), bundle(b), protocol(p), _completed(false), _aborted(false), _abort_reason(TransferAbortedEvent::REASON_UNDEFINED)
+		 : neighbor(n), bundle(b), protocol(p), _metrics(NULL), _completed(false), _aborted(false), _abort_reason(TransferAbortedEvent::REASON_UNDEFINED)
 		{
 		}
 
 		BundleTransfer::Slot::~Slot()
 		{
 			if (_aborted) {
+				if (_metrics != NULL) (*_metrics)->addAbort(_abort_reason);
+
 				// fire TransferAbortedEvent
 				dtn::net::TransferAbortedEvent::raise(neighbor, bundle, _abort_reason);
 			} else if (_completed) {
+				if (_metrics != NULL) (*_metrics)->addTransfer();
+
+				dtn::core::LatencyTracer::getInstance().mark(bundle, dtn::core::LatencyTracer::STAGE_TRANSMITTED);
 				dtn::net::TransferCompletedEvent::raise(neighbor, bundle);
 				dtn::core::BundleEvent::raise(bundle, dtn::core::BUNDLE_FORWARDED);
 			} else {
 				dtn::routing::RequeueBundleEvent::raise(neighbor, bundle, protocol);
 			}
+
+			delete _metrics;
 		}
 
 		const dtn::data::EID& BundleTransfer::getNeighbor() const
@@ -81,6 +90,15 @@ namespace dtn
 			_completed = true;
 		}
 
+		void BundleTransfer::Slot::setMetrics(const refcnt_ptr<LinkMetrics> &metrics)
+		{
+			if (_metrics != NULL) {
+				(*_metrics) = metrics;
+			} else {
+				_metrics = new refcnt_ptr<LinkMetrics>(metrics);
+			}
+		}
+
 		void BundleTransfer::abort(const TransferAbortedEvent::AbortReason reason)
 		{
 			_slot->abort(reason);
@@ -90,5 +108,10 @@ namespace dtn
 		{
 			_slot->complete();
 		}
+
+		void BundleTransfer::setMetrics(const refcnt_ptr<LinkMetrics> &metrics)
+		{
+			_slot->setMetrics(metrics);
+		}
 	} /* namespace net */
 } /* namespace dtn */
@@ -26,6 +26,7 @@
 #include "core/Node.h"
 
 #include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/refcnt_ptr.h>
 #include <map>
 
 #ifndef BUNDLETRANSFER_H_
@@ -35,6 +36,8 @@ namespace dtn
 {
 	namespace net
 	{
+		class LinkMetrics;
+
 		class BundleTransfer {
 		public:
 			BundleTransfer(const dtn::data::EID &neighbor, const dtn::data::MetaBundle &bundle, dtn::core::Node::Protocol p);
@@ -54,6 +57,12 @@ namespace dtn
 			 */
 			void complete();
 
+			/**
+			 * Record the result of this transmission in the metrics of
+			 * the link, set by the connection which takes the job
+			 */
+			void setMetrics(const refcnt_ptr<LinkMetrics> &metrics);
+
 		private:
 			class Slot {
 			public:
@@ -74,7 +83,15 @@ namespace dtn
 				 */
 				void complete();
 
+				/**
+				 * Set the metrics of the link used for this transmission
+				 */
+				void setMetrics(const refcnt_ptr<LinkMetrics> &metrics);
+
 			private:
+				// metrics of the link, NULL if not set by the connection
+				refcnt_ptr<LinkMetrics> *_metrics;
+
 				bool _completed;
 				bool _aborted;
 				TransferAbortedEvent::AbortReason _abort_reason;
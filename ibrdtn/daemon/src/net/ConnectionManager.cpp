@@ -21,9 +21,11 @@
 
 #include "Configuration.h"
 #include "net/ConnectionManager.h"
+#include "net/LinkMetrics.h"
 #include "core/EventDispatcher.h"
 #include "core/BundleEvent.h"
 #include "core/BundleCore.h"
+#include "core/LatencyTracer.h"
 
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
@@ -46,7 +48,7 @@ namespace dtn
 		};
 
 		ConnectionManager::ConnectionManager()
-		 : _next_autoconnect(0)
+		 : _next_autoconnect(0), _scheduler(*this)
 		{
 		}
 
@@ -61,6 +63,9 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::core::NodeEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::GlobalEvent>::add(this);
+			dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::add(this);
+			dtn::core::EventDispatcher<dtn::net::TransferAbortedEvent>::add(this);
+			dtn::core::EventDispatcher<dtn::routing::RequeueBundleEvent>::add(this);
 
 			// set next auto connect
 			const dtn::daemon::Configuration::Network &nc = dtn::daemon::Configuration::getInstance().getNetwork();
@@ -68,6 +73,14 @@ namespace dtn
 			{
 				_next_autoconnect = dtn::utils::Clock::getTime() + nc.getAutoConnect();
 			}
+
+			// set the shares of the transfer window
+			const std::map<std::string, unsigned int> &shares = nc.getTransferShares();
+			for (std::map<std::string, unsigned int>::const_iterator it = shares.begin(); it != shares.end(); ++it)
+			{
+				_scheduler.setShare(dtn::data::EID((*it).first), (*it).second);
+			}
+			_scheduler.setLimit(nc.getTransferWindow());
 		}
 
 		void ConnectionManager::componentDown() throw ()
@@ -91,13 +104,24 @@ namespace dtn
 			dtn::core::EventDispatcher<TimeEvent>::remove(this);
 			dtn::core::EventDispatcher<ConnectionEvent>::remove(this);
 			dtn::core::EventDispatcher<GlobalEvent>::remove(this);
+			dtn::core::EventDispatcher<TransferCompletedEvent>::remove(this);
+			dtn::core::EventDispatcher<TransferAbortedEvent>::remove(this);
+			dtn::core::EventDispatcher<dtn::routing::RequeueBundleEvent>::remove(this);
 		}
 
 		void ConnectionManager::raiseEvent(const dtn::core::NodeEvent &nodeevent) throw ()
 		{
-			ibrcommon::MutexLock l(_node_lock);
 			const Node &n = nodeevent.getNode();
 
+			// the scheduler dispatches transfers, thus call it without holding the node lock
+			if (nodeevent.getAction() == NODE_AVAILABLE) _scheduler.up(n.getEID());
+			else if (nodeevent.getAction() == NODE_UNAVAILABLE) _scheduler.down(n.getEID());
+
+			// forget the metrics of the links to unavailable nodes
+			if (nodeevent.getAction() == NODE_UNAVAILABLE) LinkMetrics::remove(n.getEID());
+
+			ibrcommon::MutexLock l(_node_lock);
+
 			switch (nodeevent.getAction())
 			{
 				case NODE_AVAILABLE:
@@ -117,6 +141,21 @@ namespace dtn
 			}
 		}
 
+		void ConnectionManager::raiseEvent(const dtn::net::TransferCompletedEvent &evt) throw ()
+		{
+			_scheduler.finished(evt.getPeer(), evt.getBundle());
+		}
+
+		void ConnectionManager::raiseEvent(const dtn::net::TransferAbortedEvent &evt) throw ()
+		{
+			_scheduler.finished(evt.getPeer(), evt.getBundleID());
+		}
+
+		void ConnectionManager::raiseEvent(const dtn::routing::RequeueBundleEvent &evt) throw ()
+		{
+			_scheduler.finished(evt.getPeer(), evt.getBundle());
+		}
+
 		void ConnectionManager::raiseEvent(const dtn::core::TimeEvent &timeevent) throw ()
 		{
 			if (timeevent.getAction() == TIME_SECOND_TICK)
@@ -199,7 +238,7 @@ namespace dtn
 			}
 
 			ibrcommon::MutexLock l(_node_lock);
-			pair<nodemap::iterator,bool> ret = _nodes.insert( pair<dtn::data::EID, dtn::core::Node>(n.getEID(), n) );
+			pair<nodemap::iterator,bool> ret = _nodes.insert( pair<dtn::data::EIDHandle, dtn::core::Node>(dtn::data::EIDHandle(n.getEID()), n) );
 
 			dtn::core::Node &db = (*(ret.first)).second;
 
@@ -493,6 +532,19 @@ namespace dtn
 		}
 
 		void ConnectionManager::queue(dtn::net::BundleTransfer &job)
+		{
+			// the routing has decided about the bundle
+			dtn::core::LatencyTracer::getInstance().mark(job.getBundle(), dtn::core::LatencyTracer::STAGE_QUEUED);
+
+			_scheduler.queue(job);
+		}
+
+		bool ConnectionManager::preempt(const dtn::data::EID &peer, const dtn::data::MetaBundle &meta, dtn::data::BundleID &dropped)
+		{
+			return _scheduler.preempt(peer, meta, dropped);
+		}
+
+		void ConnectionManager::dispatch(dtn::net::BundleTransfer &job)
 		{
 			try {
 				ibrcommon::MutexLock l(_node_lock);
@@ -633,7 +685,11 @@ namespace dtn
 
 		dtn::core::Node& ConnectionManager::getNode(const dtn::data::EID &eid) throw (NodeNotAvailableException)
 		{
-			nodemap::iterator iter = _nodes.find(eid);
+			// EIDs never interned are not in the node map
+			dtn::data::EIDHandle handle;
+			if (!dtn::data::EIDHandle::lookup(eid, handle)) throw NodeNotAvailableException("node not found");
+
+			nodemap::iterator iter = _nodes.find(handle);
 			if (iter == _nodes.end()) throw NodeNotAvailableException("node not found");
 			return (*iter).second;
 		}
@@ -28,6 +28,7 @@
 #include "net/BundleReceiver.h"
 #include "core/EventReceiver.h"
 #include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/EIDTable.h>
 #include "core/Node.h"
 #include <ibrcommon/Exceptions.h>
 
@@ -35,6 +36,10 @@
 #include "core/TimeEvent.h"
 #include "core/GlobalEvent.h"
 #include "net/ConnectionEvent.h"
+#include "net/TransferScheduler.h"
+#include "net/TransferCompletedEvent.h"
+#include "net/TransferAbortedEvent.h"
+#include "routing/RequeueBundleEvent.h"
 
 #include <set>
 #include <list>
@@ -61,7 +66,9 @@ namespace dtn
 
 		class ConnectionManager
 		  : public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IntegratedComponent,
-			public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::core::EventReceiver<dtn::core::NodeEvent>, public dtn::core::EventReceiver<dtn::net::ConnectionEvent>
+			public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::core::EventReceiver<dtn::core::NodeEvent>, public dtn::core::EventReceiver<dtn::net::ConnectionEvent>,
+			public dtn::core::EventReceiver<dtn::net::TransferCompletedEvent>, public dtn::core::EventReceiver<dtn::net::TransferAbortedEvent>,
+			public dtn::core::EventReceiver<dtn::routing::RequeueBundleEvent>, private TransferScheduler::Callback
 		{
 		public:
 			ConnectionManager();
@@ -95,6 +102,12 @@ namespace dtn
 			 */
 			void queue(dtn::net::BundleTransfer &job);
 
+			/**
+			 * Drop a waiting transfer to the neighbor in favor of the given bundle
+			 * @see TransferScheduler::preempt()
+			 */
+			bool preempt(const dtn::data::EID &peer, const dtn::data::MetaBundle &meta, dtn::data::BundleID &dropped);
+
 			/**
 			 * method to receive new events from the EventSwitch
 			 */
@@ -102,6 +115,9 @@ namespace dtn
 			void raiseEvent(const dtn::core::NodeEvent &evt) throw ();
 			void raiseEvent(const dtn::net::ConnectionEvent &evt) throw ();
 			void raiseEvent(const dtn::core::GlobalEvent &evt) throw ();
+			void raiseEvent(const dtn::net::TransferCompletedEvent &evt) throw ();
+			void raiseEvent(const dtn::net::TransferAbortedEvent &evt) throw ();
+			void raiseEvent(const dtn::routing::RequeueBundleEvent &evt) throw ();
 
 			class ShutdownException : public ibrcommon::Exception
 			{
@@ -176,6 +192,11 @@ namespace dtn
 			virtual void componentDown() throw ();
 
 		private:
+			/**
+			 * hand-over a scheduled transfer to a convergence layer
+			 */
+			virtual void dispatch(dtn::net::BundleTransfer &job);
+
 			/**
 			 * checks for timed out nodes
 			 */
@@ -216,11 +237,14 @@ namespace dtn
 			ibrcommon::Mutex _node_lock;
 
 			// contains all nodes
-			typedef std::map<dtn::data::EID, dtn::core::Node> nodemap;
+			typedef std::map<dtn::data::EIDHandle, dtn::core::Node> nodemap;
 			nodemap _nodes;
 
 			// next timestamp for autoconnect check
 			dtn::data::Timestamp _next_autoconnect;
+
+			// orders the transfers of all neighbors
+			TransferScheduler _scheduler;
 		};
 	}
 }
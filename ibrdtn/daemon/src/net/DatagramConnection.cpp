@@ -44,7 +44,7 @@ namespace dtn
 
 		DatagramConnection::DatagramConnection(const std::string &identifier, const DatagramService::Parameter &params, DatagramConnectionCallback &callback)
 		 : _send_state(SEND_IDLE), _recv_state(RECV_IDLE), _callback(callback), _identifier(identifier), _stream(*this, params.max_msg_length), _sender(*this, _stream),
-		   _last_ack(0), _next_seqno(0), _head_buf(params.max_msg_length), _head_len(0), _params(params), _avg_rtt(static_cast<double>(params.initial_timeout))
+		   _last_ack(0), _next_seqno(0), _head_buf(params.max_msg_length), _head_len(0), _params(params), _avg_rtt(static_cast<double>(params.initial_timeout)), _metrics_ref(NULL), _metrics(NULL)
 		{
 		}
 
@@ -95,6 +95,9 @@ namespace dtn
 						// read the bundle out of the stream
 						deserializer >> bundle;
 
+						// hand over secured bundles to the verification pool
+						if (_verification.push(_peer_eid, _callback.getDiscoveryProtocol(), bundle)) continue;
+
 						// push bundle through the filter routines
 						context.setBundle(bundle);
 						BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::INPUT, context, bundle);
@@ -127,6 +130,9 @@ namespace dtn
 			} catch (std::exception &ex) {
 				IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 25) << "Main-thread died: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
+
+			// wait until all pending bundles are verified
+			_verification.flush();
 		}
 
 		void DatagramConnection::setup() throw ()
@@ -169,10 +175,18 @@ namespace dtn
 		 * Queue job for delivery to another node
 		 * @param job
 		 */
-		void DatagramConnection::queue(const dtn::net::BundleTransfer &job)
+		void DatagramConnection::queue(const dtn::net::BundleTransfer &j)
 		{
-			IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 15) << "queue bundle " << job.getBundle().toString() << " to " << job.getNeighbor().getString() << IBRCOMMON_LOGGER_ENDL;
-			_sender.queue.push(job);
+			IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 15) << "queue bundle " << j.getBundle().toString() << " to " << j.getNeighbor().getString() << IBRCOMMON_LOGGER_ENDL;
+
+			dtn::net::BundleTransfer job = j;
+			if (_metrics != NULL) job.setMetrics(_metrics_ref);
+
+			try {
+				_sender.queue.push(job);
+			} catch (const ibrcommon::QueueUnblockedException&) {
+				// the sender is gone, dropping the job requeues the transfer
+			}
 		}
 
 		/**
@@ -184,6 +198,8 @@ namespace dtn
 		{
 			IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 25) << "frame received, flags: " << (int)flags << ", seqno: " << seqno << ", len: " << len << IBRCOMMON_LOGGER_ENDL;
 
+			if (_metrics != NULL) _metrics->addTrafficIn(len);
+
 			try {
 				// we will accept every sequence number on first segments
 				// if this is not the first segment
@@ -303,6 +319,9 @@ namespace dtn
 				{
 					IBRCOMMON_LOGGER_DEBUG_TAG(DatagramConnection::TAG, 30) << "transmit frame seqno: " << seqno << IBRCOMMON_LOGGER_ENDL;
 
+					// count each further attempt as retransmission
+					if ((i > 0) && (_metrics != NULL)) _metrics->addRetransmission();
+
 					// send the datagram
 					_callback.callback_send(*this, flags, seqno, getIdentifier(), buf, len);
 
@@ -333,6 +352,7 @@ namespace dtn
 
 						// report result
 						_callback.reportSuccess(i, tm.getMilliseconds());
+						if (_metrics != NULL) _metrics->addRoundTripTime(static_cast<uint64_t>(tm.getMicroseconds()));
 
 						return;
 					} catch (const ibrcommon::Conditional::ConditionalAbortException &e) {
@@ -492,6 +512,8 @@ namespace dtn
 
 						// increment retry counter
 						retry_frame.retry++;
+
+						if (_metrics != NULL) _metrics->addRetransmission();
 					}
 
 					// enter the wait state
@@ -550,6 +572,7 @@ namespace dtn
 
 							// report result
 							_callback.reportSuccess(f.retry, f.tm.getMilliseconds());
+							if (_metrics != NULL) _metrics->addRoundTripTime(static_cast<uint64_t>(f.tm.getMicroseconds()));
 
 							// remove front element
 							_sw_frames.pop_front();
@@ -567,7 +590,14 @@ namespace dtn
 
 		void DatagramConnection::setPeerEID(const dtn::data::EID &peer)
 		{
+			// beacons are received frequently, resolve the metrics once per peer
+			if ((_metrics != NULL) && (_peer_eid == peer)) return;
+
 			_peer_eid = peer;
+
+			LinkMetrics::Handle m = LinkMetrics::get(peer, _callback.getDiscoveryProtocol());
+			_metrics = &(*m);
+			_metrics_ref = m;
 		}
 
 		const dtn::data::EID& DatagramConnection::getPeerEID()
@@ -575,6 +605,11 @@ namespace dtn
 			return _peer_eid;
 		}
 
+		LinkMetrics* DatagramConnection::getMetrics()
+		{
+			return _metrics;
+		}
+
 		void DatagramConnection::adjust_rtt(double value)
 		{
 			// convert current avg to float
@@ -849,6 +884,8 @@ namespace dtn
 
 		void DatagramConnection::Sender::finally() throw ()
 		{
+			// do not block producers on a full queue once the sender is gone
+			queue.abort();
 		}
 
 		void DatagramConnection::Sender::__cancellation() throw ()
@@ -24,8 +24,11 @@
 
 #include "net/ConvergenceLayer.h"
 #include "net/DatagramService.h"
+#include "net/LinkMetrics.h"
+#include "core/VerificationPool.h"
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/RingQueue.h>
 #include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/TimeMeasurement.h>
 #include <streambuf>
@@ -109,6 +112,12 @@ namespace dtn
 			 */
 			const dtn::data::EID& getPeerEID();
 
+			/**
+			 * Returns the metrics of the link to the peer or NULL
+			 * if the peer EID is not known yet
+			 */
+			LinkMetrics* getMetrics();
+
 		private:
 			enum SEND_FLOW {
 				SEND_IDLE,
@@ -223,7 +232,7 @@ namespace dtn
 				void finally() throw ();
 				void __cancellation() throw ();
 
-				ibrcommon::Queue<dtn::net::BundleTransfer> queue;
+				ibrcommon::RingQueue<dtn::net::BundleTransfer> queue;
 
 			private:
 				DatagramConnection::Stream &_stream;
@@ -275,6 +284,13 @@ namespace dtn
 
 			dtn::data::EID _peer_eid;
 
+			// metrics of the link to the peer, set with the peer EID
+			LinkMetrics::Handle _metrics_ref;
+			LinkMetrics *_metrics;
+
+			// received bundles pending in the verification pool
+			dtn::core::VerificationPool::Lane _verification;
+
 			// buffer for sliding window approach
 			class window_frame {
 			public:
@@ -115,7 +115,7 @@ namespace dtn
 			return _service->getProtocol();
 		}
 
-		void DatagramConvergenceLayer::callback_send(DatagramConnection&, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException)
+		void DatagramConvergenceLayer::callback_send(DatagramConnection &connection, const char &flags, const unsigned int &seqno, const std::string &destination, const char *buf, const dtn::data::Length &len) throw (DatagramException)
 		{
 			// only on sender at once
 			ibrcommon::MutexLock l(_send_lock);
@@ -125,6 +125,7 @@ namespace dtn
 
 			// traffic monitoring
 			_stats_out += len;
+			if (connection.getMetrics() != NULL) connection.getMetrics()->addTrafficOut(len);
 		}
 
 		void DatagramConvergenceLayer::callback_ack(DatagramConnection&, const unsigned int &seqno, const std::string &destination) throw (DatagramException)
@@ -62,20 +62,20 @@ namespace dtn
 
 		FileConvergenceLayer::~FileConvergenceLayer()
 		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
 		void FileConvergenceLayer::componentUp() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
 			dtn::core::EventDispatcher<dtn::core::NodeEvent>::add(this);
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
 		}
 
 		void FileConvergenceLayer::componentDown() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
 			dtn::core::EventDispatcher<dtn::core::NodeEvent>::remove(this);
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
 		void FileConvergenceLayer::__cancellation() throw ()
@@ -149,6 +149,12 @@ namespace dtn
 														continue;
 													}
 													_blacklist.add(meta);
+
+													// move the deadline if this entry expires first
+													if (meta.expiretime == _blacklist.getNextExpiration())
+													{
+														dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, meta.expiretime + 1);
+													}
 												}
 
 												// create ECM reply
@@ -233,13 +239,14 @@ namespace dtn
 			}
 		}
 
-		void FileConvergenceLayer::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		void FileConvergenceLayer::eventDeadline(const dtn::data::Timestamp &now) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				ibrcommon::MutexLock l(_blacklist_mutex);
-				_blacklist.expire(time.getTimestamp());
-			}
+			ibrcommon::MutexLock l(_blacklist_mutex);
+			_blacklist.expire(now);
+
+			// register the next expiration of the blacklist
+			const dtn::data::Timestamp next = _blacklist.getNextExpiration();
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, (next == 0) ? next : next + 1);
 		}
 
 		const std::string FileConvergenceLayer::getName() const
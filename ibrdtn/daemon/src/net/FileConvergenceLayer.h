@@ -22,7 +22,7 @@
 #include "Component.h"
 #include "net/ConvergenceLayer.h"
 #include "core/NodeEvent.h"
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 #include "core/Node.h"
 #include "core/EventReceiver.h"
 #include <ibrdtn/data/BundleList.h>
@@ -37,14 +37,14 @@ namespace dtn
 	namespace net
 	{
 
-		class FileConvergenceLayer : public dtn::net::ConvergenceLayer, public dtn::daemon::IndependentComponent, public dtn::core::EventReceiver<dtn::core::NodeEvent>, public dtn::core::EventReceiver<dtn::core::TimeEvent>
+		class FileConvergenceLayer : public dtn::net::ConvergenceLayer, public dtn::daemon::IndependentComponent, public dtn::core::EventReceiver<dtn::core::NodeEvent>, public dtn::core::DeadlineScheduler::Listener
 		{
 		public:
 			FileConvergenceLayer();
 			virtual ~FileConvergenceLayer();
 
 			void raiseEvent(const dtn::core::NodeEvent &evt) throw ();
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
 
 			dtn::core::Node::Protocol getDiscoveryProtocol() const;
 
@@ -27,7 +27,12 @@
 #include "Configuration.h"
 #include "net/HTTPConvergenceLayer.h"
 #include "core/BundleCore.h"
-#include <memory>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/utils/Clock.h>
+#include <sstream>
+#include <cstring>
+#include <unistd.h>
+#include <fcntl.h>
 
 namespace dtn
 {
@@ -39,70 +44,68 @@ namespace dtn
 		const int CONN_TIMEOUT = 5000;
 
 		/** HTTP CODE OK */
-		const int HTTP_OK = 200;
+		const long HTTP_OK = 200;
 		/** HTTP CODE NO DATA ON SERVER */
-		const int HTTP_NO_DATA = 410;
+		const long HTTP_NO_DATA = 410;
 
-		/** CURL CODE CONN OK*/
-		const int CURL_CONN_OK = 0;
-		/** CURL CODE PARTIAL FILE*/
-		const int CURL_PARTIAL_FILE = 18;
+		/** Number of bundles uploaded at once */
+		const size_t MAX_UPLOADS = 4;
 
-		/**
-		 * Stream read function
-		 *
-		 * @param ptr
-		 * @param size
-		 * @param nmemb
-		 * @param s
-		 */
-		static size_t HTTPConvergenceLayer_callback_read(void *ptr, size_t size, size_t nmemb, void *s)
-		{
-			size_t retcode = 0;
-			std::istream *stream = static_cast<std::istream*>(s);
-
-			if (stream->eof()) return 0;
-
-			char *buffer = static_cast<char*>(ptr);
-
-			stream->read(buffer, (size * nmemb));
-			retcode = stream->gcount();
+		/** Size of the chunks read out of the payload BLOB */
+		const long UPLOAD_BUFFER_SIZE = 65536;
 
-			return retcode;
-		}
+		const std::string HTTPConvergenceLayer::TAG = "HTTPConvergenceLayer";
 
 		/**
-		 * Stream write function
-		 *
-		 * @param ptr
-		 * @param size
-		 * @param nmemb
-		 * @param s
+		 * Serializer giving access to the header of the payload block,
+		 * the payload itself is streamed by the upload.
 		 */
-		static size_t HTTPConvergenceLayer_callback_write(void *ptr, size_t size, size_t nmemb, void *s)
+		class UploadSerializer : public dtn::data::DefaultSerializer
 		{
-			std::ostream *stream = static_cast<std::ostream*>(s);
-			char *buffer = static_cast<char*>(ptr);
-
-			if (!stream->good()) return 0;
-
-			stream->write(buffer, (size * nmemb));
-			stream->flush();
+		public:
+			UploadSerializer(std::ostream &stream, const dtn::data::Bundle &bundle)
+			 : dtn::data::DefaultSerializer(stream)
+			{
+				rebuildDictionary(bundle);
+			}
 
-			return (size * nmemb);
-		}
+			void header(const dtn::data::Block &block)
+			{
+				serializeHeader(block, block.getLength());
+			}
+		};
 
 		/**
 		 * HTTPConvergenceLayer constructor calls the curl_global_init() method
-		 * to initialize curl global. Furthermore the attributes _server _push_iob
-		 * and _running will be set.
+		 * to initialize curl global. Furthermore the multi handle, which keeps
+		 * the connections to the server, is created.
 		 *
 		 * @param server The server parameter contains the Tomcat-Server URL
 		 */
 		HTTPConvergenceLayer::HTTPConvergenceLayer(const std::string &server)
-		 : _server(server), _push_iob(NULL), _running(true)
+		 : _server(server), _multi(NULL), _upload_headers(NULL), _running(true)
 		{
 			curl_global_init(CURL_GLOBAL_ALL);
+
+			_multi = curl_multi_init();
+
+#ifdef CURLPIPE_MULTIPLEX
+			/* multiplex the uploads over one connection if the server speaks HTTP/2 */
+			curl_multi_setopt(_multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+#if LIBCURL_VERSION_NUM >= 0x071e00
+			/* all uploads and the long-poll request */
+			curl_multi_setopt(_multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)(MAX_UPLOADS + 1));
+#endif
+
+			/* stream the bundle in chunks and do not wait for a 100-continue */
+			_upload_headers = curl_slist_append(_upload_headers, "Transfer-Encoding: chunked");
+			_upload_headers = curl_slist_append(_upload_headers, "Expect:");
+			_upload_headers = curl_slist_append(_upload_headers, "Content-Type: application/octet-stream");
+
+			if (::pipe(_wakeup_fd) == -1) throw ibrcommon::Exception("could not create wake-up pipe");
+			::fcntl(_wakeup_fd[0], F_SETFL, O_NONBLOCK);
+			::fcntl(_wakeup_fd[1], F_SETFL, O_NONBLOCK);
 		}
 
 
@@ -112,6 +115,13 @@ namespace dtn
 		 */
 		HTTPConvergenceLayer::~HTTPConvergenceLayer()
 		{
+			join();
+
+			::close(_wakeup_fd[0]);
+			::close(_wakeup_fd[1]);
+
+			curl_slist_free_all(_upload_headers);
+			curl_multi_cleanup(_multi);
 			curl_global_cleanup();
 		}
 
@@ -179,123 +189,275 @@ namespace dtn
 		{
 		}
 
+		HTTPConvergenceLayer::Upload::Upload(const dtn::net::BundleTransfer &j, const dtn::data::Bundle &bundle)
+		 : job(j), _split(0), _payload(getPayload(bundle, _payload_length)), _offset(0)
+		{
+			std::stringstream ss;
+			UploadSerializer s(ss, bundle);
+
+			// serialize the primary block
+			s << (const dtn::data::PrimaryBlock&)bundle;
+
+			// serialize all secondary blocks, but only the header of the payload
+			for (dtn::data::Bundle::const_iterator iter = bundle.begin(); iter != bundle.end(); ++iter)
+			{
+				const dtn::data::Block &b = (**iter);
+
+				if ((_split == 0) && (b.getType() == dtn::data::PayloadBlock::BLOCK_TYPE))
+				{
+					s.header(b);
+					_split = static_cast<std::string::size_type>(ss.tellp());
+				}
+				else
+				{
+					s << b;
+				}
+			}
+
+			_frame = ss.str();
+			if (_split == 0) _split = _frame.size();
+		}
+
+		HTTPConvergenceLayer::Upload::~Upload()
+		{
+		}
+
+		ibrcommon::BLOB::Reference HTTPConvergenceLayer::Upload::getPayload(const dtn::data::Bundle &bundle, dtn::data::Length &length)
+		{
+			try {
+				const dtn::data::PayloadBlock &payload = bundle.find<dtn::data::PayloadBlock>();
+				length = payload.getLength();
+				return payload.getBLOB();
+			} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) {
+				length = 0;
+				return ibrcommon::BLOB::create();
+			}
+		}
+
+		/**
+		 * Stream read function, hands out the serialized blocks and the
+		 * payload read out of the BLOB
+		 *
+		 * @param ptr
+		 * @param size
+		 * @param nmemb
+		 * @param u
+		 */
+		size_t HTTPConvergenceLayer::Upload::read(void *ptr, size_t size, size_t nmemb, void *u)
+		{
+			Upload &upload = *static_cast<Upload*>(u);
+			char *buffer = static_cast<char*>(ptr);
+			const size_t length = size * nmemb;
+
+			const dtn::data::Length payload_end = upload._split + upload._payload_length;
+
+			// blocks in front of the payload
+			if (upload._offset < upload._split)
+			{
+				const size_t ret = std::min(length, static_cast<size_t>(upload._split - upload._offset));
+				::memcpy(buffer, upload._frame.data() + upload._offset, ret);
+				upload._offset += ret;
+				return ret;
+			}
+
+			// payload
+			if (upload._offset < payload_end)
+			{
+				const size_t wanted = std::min(length, static_cast<size_t>(payload_end - upload._offset));
+
+				ibrcommon::BLOB::iostream io = upload._payload.iostream();
+				(*io).seekg(static_cast<std::streamoff>(upload._offset - upload._split), std::ios::beg);
+				(*io).read(buffer, wanted);
+
+				const size_t ret = static_cast<size_t>((*io).gcount());
+
+				// the payload is shorter than announced
+				if (ret == 0) return CURL_READFUNC_ABORT;
+
+				upload._offset += ret;
+				return ret;
+			}
+
+			// blocks behind the payload
+			const dtn::data::Length pos = upload._offset - upload._payload_length;
+			if (pos >= upload._frame.size()) return 0;
+
+			const size_t ret = std::min(length, static_cast<size_t>(upload._frame.size() - pos));
+			::memcpy(buffer, upload._frame.data() + pos, ret);
+			upload._offset += ret;
+			return ret;
+		}
+
+		HTTPConvergenceLayer::Receiver::Receiver()
+		 : stream(&_buffer), _thread(_buffer)
+		{
+			_thread.start();
+		}
+
+		HTTPConvergenceLayer::Receiver::~Receiver()
+		{
+			/* finalize iobuffer */
+			_buffer.finalize();
+			_thread.join();
+		}
+
+		HTTPConvergenceLayer::Download::Download(CURL *h, std::ostream &stream)
+		 : handle(h), received(0), _stream(stream)
+		{
+		}
+
+		HTTPConvergenceLayer::Download::~Download()
+		{
+		}
+
+		/**
+		 * Stream write function, passes data of successful responses
+		 * to the DownloadThread
+		 *
+		 * @param ptr
+		 * @param size
+		 * @param nmemb
+		 * @param d
+		 */
+		size_t HTTPConvergenceLayer::Download::write(void *ptr, size_t size, size_t nmemb, void *d)
+		{
+			Download &download = *static_cast<Download*>(d);
+			char *buffer = static_cast<char*>(ptr);
+
+			// discard the body of error responses
+			long http_code = 0;
+			curl_easy_getinfo(download.handle, CURLINFO_RESPONSE_CODE, &http_code);
+			if (http_code != HTTP_OK) return (size * nmemb);
+
+			if (!download._stream.good()) return 0;
+
+			download._stream.write(buffer, (size * nmemb));
+			download._stream.flush();
+
+			download.received += (size * nmemb);
+
+			return (size * nmemb);
+		}
+
 		/**
 		 * Function to send data to Tomcat Server. This method is from the
 		 * ConvergenceLayer interface. Everytime a bundle is queued, this method
-		 * will be called to send the bundle over HTTP. The HTTP transfer is
-		 * performed in classical request-response principle. For file upload the
-		 * HTTP PUT method is used. Curl uses the HTTPConvergenceLayer_callback_read()
-		 * method for reading the bundle content. After a bundle is successfully
-		 * transfered this method will raise the events for TransferCompletedEvent and
-		 * the BundleEvent for BUNDLE_FORWARDED.
+		 * will be called. The transfer is put into a queue and the upload is
+		 * started by the componentRun() loop as soon as less than MAX_UPLOADS
+		 * bundles are on the way. For file upload the HTTP PUT method is used.
 		 *
 		 * @param node node informations
 		 * @param job parameter to get next bundle to send from storage
 		 */
-		void HTTPConvergenceLayer::queue(const dtn::core::Node &node, const dtn::net::BundleTransfer &job)
+		void HTTPConvergenceLayer::queue(const dtn::core::Node&, const dtn::net::BundleTransfer &job)
 		{
-			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
-			std::string url_send;
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				_queue.push(job);
+			}
 
-			long http_code = 0;
-			//double upload_size = 0;
+			__wakeup();
+		}
 
-			// create a filter context
-			dtn::core::FilterContext context;
-			context.setProtocol(dtn::core::Node::CONN_HTTP);
+		void HTTPConvergenceLayer::__wakeup()
+		{
+			const char c = 0;
 
-			try {
-				// read the bundle out of the storage
-				dtn::data::Bundle bundle = storage.get(job.getBundle());
+			// a full pipe already wakes up the loop
+			if (::write(_wakeup_fd[1], &c, 1) == -1) return;
+		}
 
-				// push bundle through the filter routines
-				context.setBundle(bundle);
-				BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::OUTPUT, context, bundle);
+		CURL* HTTPConvergenceLayer::__create(const std::string &url) const
+		{
+			CURL *curl = curl_easy_init();
+			if (curl == NULL) return NULL;
 
-				if (ret != BundleFilter::ACCEPT) {
-					dtn::net::BundleTransfer local_job = job;
-					local_job.abort(dtn::net::TransferAbortedEvent::REASON_REFUSED_BY_FILTER);
-					return;
-				}
+			curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
 
-				ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
-				{
-					ibrcommon::BLOB::iostream io = ref.iostream();
-					dtn::data::DefaultSerializer(*io) << bundle;
-				}
-
-				ibrcommon::BLOB::iostream io = ref.iostream();
-				size_t length = io.size();
-				CURLcode res;
-				CURL *curl_up;
+			/* no progress meter please */
+			curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 1L);
 
-				url_send = _server + "?eid=" + dtn::core::BundleCore::local.getString();
-										 //+ "&dst-eid=dtn://experthe-laptop/filetransfer";
-										 //+ "&priority=2";
-										 //+ "&ttl=3600";
+			/* do not use signals in a multi-threaded process */
+			curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
 
-				//if (job._bundle.source.getString() == (dtn::core::BundleCore::local.getString() + "/echo-client"))
-				//{
-				//	url_send = _server + "?eid=" + dtn::core::BundleCore::local.getString() + "&dst-eid=echo-client";
-				//}
+			/* give up connecting after a while and retry later */
+			curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, (long)CONN_TIMEOUT);
 
-				curl_up = curl_easy_init();
-				if(curl_up)
-				{
-					/* we want to use our own read function */
-					curl_easy_setopt(curl_up, CURLOPT_READFUNCTION, HTTPConvergenceLayer_callback_read);
+#if LIBCURL_VERSION_NUM >= 0x071900
+			/* detect dead connections to the server */
+			curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
 
-					/* enable uploading */
-					curl_easy_setopt(curl_up, CURLOPT_UPLOAD, 1L);
+			/* cURL DEBUG options */
+			//curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
 
-					/* HTTP PUT please */
-					curl_easy_setopt(curl_up, CURLOPT_PUT, 1L);
+			return curl;
+		}
 
-					/* disable connection timeout */
-					curl_easy_setopt(curl_up, CURLOPT_CONNECTTIMEOUT, 0);
+		void HTTPConvergenceLayer::__start_uploads(std::map<CURL*, Upload*> &uploads, const std::string &url)
+		{
+			dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
 
-					/* specify target URL, and note that this URL should include a file
-					   name, not only a directory */
-					curl_easy_setopt(curl_up, CURLOPT_URL, url_send.c_str());
+			std::queue<dtn::net::BundleTransfer> jobs;
 
-					/* now specify which file to upload */
-					curl_easy_setopt(curl_up, CURLOPT_READDATA, &(*io));
+			// take as many transfers as uploads are free
+			{
+				ibrcommon::MutexLock l(_queue_lock);
+				while (!_queue.empty() && ((uploads.size() + jobs.size()) < MAX_UPLOADS))
+				{
+					jobs.push(_queue.front());
+					_queue.pop();
+				}
+			}
 
-					/* provide the size of the upload, we specicially typecast the value
-					   to curl_off_t since we must be sure to use the correct data size */
-					curl_easy_setopt(curl_up, CURLOPT_INFILESIZE_LARGE,
-									 (curl_off_t)length);
+			for (; !jobs.empty(); jobs.pop())
+			{
+				dtn::net::BundleTransfer &job = jobs.front();
 
-					/* Now run off and do what you've been told! */
-					res = curl_easy_perform(curl_up);
+				// create a filter context
+				dtn::core::FilterContext context;
+				context.setProtocol(dtn::core::Node::CONN_HTTP);
 
-					if(res == CURL_CONN_OK)
-					{
-						/* get HTTP Header StatusCode */
-						curl_easy_getinfo (curl_up, CURLINFO_RESPONSE_CODE, &http_code);
-						//curl_easy_getinfo (curl, CURLINFO_SIZE_UPLOAD, &upload_size);
+				try {
+					// read the bundle out of the storage
+					dtn::data::Bundle bundle = storage.get(job.getBundle());
 
-						/* DEBUG OUTPUT INFORMATION */
-						//std::cout << "CURL CODE    : " << res << std::endl;
-						//std::cout << "HTTP CODE    : " << http_code << std::endl;
-						//std::cout << "UPLOAD_SIZE: " << upload_size << " Bytes" << std::endl;
-						/* DEBUG OUTPUT INFORMATION */
+					// push bundle through the filter routines
+					context.setBundle(bundle);
+					BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::OUTPUT, context, bundle);
 
-						if(http_code == HTTP_OK)
-						{
-							dtn::net::BundleTransfer local_job = job;
-							local_job.complete();
-						}
+					if (ret != BundleFilter::ACCEPT) {
+						job.abort(dtn::net::TransferAbortedEvent::REASON_REFUSED_BY_FILTER);
+						continue;
 					}
 
-					curl_easy_cleanup(curl_up);
+					CURL *curl_up = __create(url);
+					if (curl_up == NULL) continue;
+
+					Upload *upload = new Upload(job, bundle);
+
+					/* we want to use our own read function */
+					curl_easy_setopt(curl_up, CURLOPT_READFUNCTION, Upload::read);
+					curl_easy_setopt(curl_up, CURLOPT_READDATA, upload);
+
+					/* enable uploading, HTTP PUT with unknown size */
+					curl_easy_setopt(curl_up, CURLOPT_UPLOAD, 1L);
+					curl_easy_setopt(curl_up, CURLOPT_INFILESIZE_LARGE, (curl_off_t)-1);
+					curl_easy_setopt(curl_up, CURLOPT_HTTPHEADER, _upload_headers);
+
+#if LIBCURL_VERSION_NUM >= 0x073e00
+					curl_easy_setopt(curl_up, CURLOPT_UPLOAD_BUFFERSIZE, UPLOAD_BUFFER_SIZE);
+#endif
+
+					uploads[curl_up] = upload;
+					curl_multi_add_handle(_multi, curl_up);
+				} catch (const dtn::storage::NoBundleFoundException&) {
+					// send transfer aborted event
+					job.abort(dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
+				} catch (const ibrcommon::Exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(HTTPConvergenceLayer::TAG, 10) << "upload of " << job.getBundle().toString() << " failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 				}
-			} catch (const dtn::storage::NoBundleFoundException&) {
-				// send transfer aborted event
-				dtn::net::BundleTransfer local_job = job;
-				local_job.abort(dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
 			}
-
 		}
 
 		/**
@@ -308,103 +470,188 @@ namespace dtn
 
 		/**
 		 * Method from IndependentComponent interface, this method is called before
-		 * the componentRun() method is called. At time here is nothing to do.
+		 * the componentRun() method is called.
 		 */
 		void HTTPConvergenceLayer::componentUp() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
+			_running = true;
 		}
 
 		/**
 		 * This method is from IndependentComponent interface. It runs as independent
-		 * thread. This method is for receving data vom HTTP server. For the receiving
-		 * the long polling mechanism is used. Curl calls when receiving data the
-		 * HTTPConvergenceLayer_callback_write() method. There the received data is written
-		 * in the ibrcommon::iobuffer, where the DownloadThread::run() method evaluate
-		 * the stream. If the connection aborted, it will wait the CONN_TIMEOUT value
-		 * and retry to connect until it could connect. When the connection is set up the
-		 * DownloadThread the iobuffer will be initialize, when disconnecting the iobuffer
-		 * will finalize.
+		 * thread and drives all requests to the HTTP server through one curl multi
+		 * handle. Queued bundles are uploaded while a long-poll request receives
+		 * bundles from the server. Curl calls when receiving data the
+		 * Download::write() method. There the received data is written in the
+		 * ibrcommon::iobuffer, where the DownloadThread::run() method evaluate
+		 * the stream. All long-poll requests share one DownloadThread. A
+		 * long-poll request which delivered bundles is issued again on the kept
+		 * connection immediately. If the server had no bundles, the next request
+		 * is issued after the TIMEOUT value. If the connection aborted, it will
+		 * wait the CONN_TIMEOUT value and retry to connect until it could connect.
 		 */
 		void HTTPConvergenceLayer::componentRun() throw ()
 		{
+			const std::string url = _server + "?eid=" + dtn::core::BundleCore::local.getString();
 
-			std::string url = _server + "?eid=" + dtn::core::BundleCore::local.getString();
-
-			CURL *curl_down;
+			std::map<CURL*, Upload*> uploads;
+			Receiver *receiver = NULL;
+			Download *download = NULL;
+			dtn::data::Timestamp retry = 0;
 
 			while (_running)
 			{
-				curl_down = curl_easy_init();
-
-				while(curl_down)
+				// (re-)issue the long-poll request
+				if ((download == NULL) && (retry <= dtn::utils::Clock::getMonotonicTimestamp()))
 				{
-					curl_easy_setopt(curl_down, CURLOPT_URL, url.c_str());
-
-					/* disable connection timeout */
-					curl_easy_setopt(curl_down, CURLOPT_CONNECTTIMEOUT, 0);
+					CURL *curl_down = __create(url);
 
-					/* no progress meter please */
-					curl_easy_setopt(curl_down, CURLOPT_NOPROGRESS, 1L);
+					if (curl_down != NULL)
+					{
+						if (receiver == NULL) receiver = new Receiver();
+						download = new Download(curl_down, receiver->stream);
 
-					/* cURL DEBUG options */
-					//curl_easy_setopt(curl_down, CURLOPT_DEBUGFUNCTION, my_trace);
-				    //curl_easy_setopt(curl_down, CURLOPT_DEBUGDATA, &config);
+						/* send all data to this function  */
+						curl_easy_setopt(curl_down, CURLOPT_WRITEFUNCTION, Download::write);
 
-				    //curl_easy_setopt(curl_down, CURLOPT_DEBUGFUNCTION, my_trace);
-					//curl_easy_setopt(curl_down, CURLOPT_VERBOSE, 1);
+						/* now specify where to write data */
+						curl_easy_setopt(curl_down, CURLOPT_WRITEDATA, download);
 
-					// create a receiver thread
+						curl_multi_add_handle(_multi, curl_down);
+					}
+					else
 					{
-						ibrcommon::MutexLock l(_push_iob_mutex);
-						_push_iob = new ibrcommon::iobuffer();
+						retry = dtn::utils::Clock::getMonotonicTimestamp() + (CONN_TIMEOUT / 1000);
 					}
+				}
 
-					std::auto_ptr<ibrcommon::iobuffer> auto_kill(_push_iob);
-					std::ostream os(_push_iob);
-					DownloadThread receiver(*_push_iob);
+				__start_uploads(uploads, url);
 
-					/* send all data to this function  */
-					curl_easy_setopt(curl_down, CURLOPT_WRITEFUNCTION, HTTPConvergenceLayer_callback_write);
+				int running = 0;
+				curl_multi_perform(_multi, &running);
 
-					/* now specify where to write data */
-					curl_easy_setopt(curl_down, CURLOPT_WRITEDATA, &os);
+				// process finished requests
+				int left = 0;
+				CURLMsg *msg = NULL;
+				while ((msg = curl_multi_info_read(_multi, &left)) != NULL)
+				{
+					if (msg->msg != CURLMSG_DONE) continue;
+
+					CURL *handle = msg->easy_handle;
+					const CURLcode res = msg->data.result;
 
-					/* do curl */
-					receiver.start();
-					curl_easy_perform(curl_down);
+					/* get HTTP Header StatusCode */
+					long http_code = 0;
+					curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &http_code);
 
+					curl_multi_remove_handle(_multi, handle);
+
+					if ((download != NULL) && (handle == download->handle))
 					{
-						ibrcommon::MutexLock l(_push_iob_mutex);
-						/* finalize iobuffer */
-						_push_iob->finalize();
-						receiver.join();
-						_push_iob = NULL;
+						const dtn::data::Length received = download->received;
+
+						delete download;
+						download = NULL;
+
+						if ((res != CURLE_OK) || ((http_code != HTTP_OK) && (http_code != HTTP_NO_DATA)))
+						{
+							/* a cut off response may leave a partial bundle in the buffer */
+							delete receiver;
+							receiver = NULL;
+
+							/* Wait some time an retry to connect */
+							retry = dtn::utils::Clock::getMonotonicTimestamp() + (CONN_TIMEOUT / 1000);
+							IBRCOMMON_LOGGER_DEBUG_TAG(HTTPConvergenceLayer::TAG, 10) << "http error: " << "Couldn't connect to server ... wait " << CONN_TIMEOUT/1000 << "s until retry" << IBRCOMMON_LOGGER_ENDL;
+						}
+						else if ((http_code == HTTP_NO_DATA) || (received == 0))
+						{
+							/* the server has no bundles, do not poll again before the next interval */
+							retry = dtn::utils::Clock::getMonotonicTimestamp() + (TIMEOUT / 1000);
+						}
 					}
+					else
+					{
+						std::map<CURL*, Upload*>::iterator it = uploads.find(handle);
 
-					/* get HTTP Header StatusCode */
-					//curl_easy_getinfo (curl_down, CURLINFO_RESPONSE_CODE, &http_code);
-					//curl_easy_getinfo (curl, CURLINFO_SIZE_DOWNLOAD, &download_size);
-					//curl_easy_getinfo (curl, CURLINFO_NUM_CONNECTS, &connects);
+						if (it != uploads.end())
+						{
+							Upload *upload = (*it).second;
+
+							if ((res == CURLE_OK) && (http_code == HTTP_OK))
+							{
+								upload->job.complete();
+							}
+							else
+							{
+								// the transfer is requeued when the job is destroyed
+								IBRCOMMON_LOGGER_DEBUG_TAG(HTTPConvergenceLayer::TAG, 10) << "upload of " << upload->job.getBundle().toString() << " failed: " << curl_easy_strerror(res) << " (" << http_code << ")" << IBRCOMMON_LOGGER_ENDL;
+							}
+
+							delete upload;
+							uploads.erase(it);
+						}
+					}
+
+					curl_easy_cleanup(handle);
+				}
+
+				// re-issue a finished long-poll request before waiting
+				if ((download == NULL) && (retry <= dtn::utils::Clock::getMonotonicTimestamp())) continue;
 
-					/* Wait some time an retry to connect */
-					ibrcommon::Thread::sleep(CONN_TIMEOUT);  // Wenn Verbindung nicht hergestellt werden konnte warte 5 sec.
-					IBRCOMMON_LOGGER_DEBUG_TAG("HTTPConvergenceLayer", 10) << "http error: " << "Couldn't connect to server ... wait " << CONN_TIMEOUT/1000 << "s until retry" << IBRCOMMON_LOGGER_ENDL;
+				// start uploads on the freed slots before waiting
+				if (uploads.size() < MAX_UPLOADS)
+				{
+					ibrcommon::MutexLock l(_queue_lock);
+					if (!_queue.empty()) continue;
+				}
+
+				// wait for network activity, queued bundles or the next retry
+				struct curl_waitfd wakeup;
+				wakeup.fd = _wakeup_fd[0];
+				wakeup.events = CURL_WAIT_POLLIN;
+				wakeup.revents = 0;
+
+				curl_multi_wait(_multi, &wakeup, 1, TIMEOUT, NULL);
+
+				if (wakeup.revents != 0)
+				{
+					char buf[64];
+					while (::read(_wakeup_fd[0], buf, sizeof(buf)) > 0);
 				}
+			}
+
+			// abort all running requests, unfinished transfers are requeued
+			for (std::map<CURL*, Upload*>::iterator it = uploads.begin(); it != uploads.end(); ++it)
+			{
+				curl_multi_remove_handle(_multi, (*it).first);
+				curl_easy_cleanup((*it).first);
+				delete (*it).second;
+			}
 
-				/* always cleanup */
-				curl_easy_cleanup(curl_down);
+			if (download != NULL)
+			{
+				CURL *handle = download->handle;
+				curl_multi_remove_handle(_multi, handle);
+				delete download;
+				curl_easy_cleanup(handle);
 			}
-			yield();
+
+			delete receiver;
+
+			ibrcommon::MutexLock l(_queue_lock);
+			while (!_queue.empty()) _queue.pop();
 		}
 
 		/**
 		 * This method is from IndependentComponent interface and is called when
-		 * the IBR-DTN is shutting down. This method trys to stop the DownloadThread
-		 * and to finalize the iobuffer, for a clean shut down.
+		 * the IBR-DTN is shutting down. The componentRun() loop is interrupted
+		 * and cleans up all running requests.
 		 */
 		void HTTPConvergenceLayer::componentDown() throw ()
 		{
+			_running = false;
+			__wakeup();
 		}
 
 		/**
@@ -414,13 +661,7 @@ namespace dtn
 		void HTTPConvergenceLayer::__cancellation() throw ()
 		{
 			_running = false;
-
-			ibrcommon::MutexLock l(_push_iob_mutex);
-			if (_push_iob != NULL)
-			{
-				_push_iob->finalize();
-				_push_iob = NULL;
-			}
+			__wakeup();
 		}
 
 		/**
@@ -429,7 +670,7 @@ namespace dtn
 		 */
 		const std::string HTTPConvergenceLayer::getName() const
 		{
-			return "HTTPConvergenceLayer";
+			return HTTPConvergenceLayer::TAG;
 		}
 	}
 }
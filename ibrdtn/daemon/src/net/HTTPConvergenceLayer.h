@@ -6,8 +6,10 @@
  * HTTPConvergenceLayer header file. In this file the classes
  * DownloadThread and HTTPConvergenceLayer are defined. The class
  * HTTPConvergenceLayer implements the interfaces ConvergenceLayer
- * and IndependentComponent. The class DownloadThread implemets the
- * JoinableThread interface.
+ * and IndependentComponent. All transfers are driven by one curl
+ * multi handle, thus connections to the server are kept alive and
+ * reused. The class DownloadThread implemets the JoinableThread
+ * interface.
  *
  * Copyright (C) 2011 IBR, TU Braunschweig
  *
@@ -53,17 +55,38 @@
 
 #include <curl/curl.h>
 #include <curl/easy.h>
+#include <curl/multi.h>
 
 
 #include <iostream>
+#include <queue>
+#include <map>
 
 namespace dtn
 {
 	namespace net
 	{
+		class DownloadThread : public ibrcommon::JoinableThread
+		{
+		public:
+
+			DownloadThread(ibrcommon::iobuffer &buf);
+			virtual ~DownloadThread();
+
+		protected:
+			void run() throw ();
+			void __cancellation() throw ();
+
+		private:
+			/** istream variable is using for reading from iobuffer */
+			std::istream _stream;
+		};
+
 		class HTTPConvergenceLayer : public ConvergenceLayer, public dtn::daemon::IndependentComponent
 		{
 		public:
+			static const std::string TAG;
+
 			HTTPConvergenceLayer(const std::string &server);
 			virtual ~HTTPConvergenceLayer();
 
@@ -87,35 +110,115 @@ namespace dtn
 			void __cancellation() throw ();
 
 		private:
+			/**
+			 * A running upload of one bundle. The serialized blocks are
+			 * kept in memory while the payload is read directly out
+			 * of its BLOB, the data is sent with chunked encoding.
+			 */
+			class Upload
+			{
+			public:
+				Upload(const dtn::net::BundleTransfer &job, const dtn::data::Bundle &bundle);
+				~Upload();
+
+				/** curl read function */
+				static size_t read(void *ptr, size_t size, size_t nmemb, void *u);
+
+				dtn::net::BundleTransfer job;
+
+			private:
+				static ibrcommon::BLOB::Reference getPayload(const dtn::data::Bundle &bundle, dtn::data::Length &length);
+
+				/** serialized blocks, the payload belongs at offset _split */
+				std::string _frame;
+				std::string::size_type _split;
+
+				ibrcommon::BLOB::Reference _payload;
+				dtn::data::Length _payload_length;
+
+				/** number of bytes already handed to curl */
+				dtn::data::Length _offset;
+			};
+
+			/**
+			 * The iobuffer evaluated by the DownloadThread. It is kept
+			 * across all long-poll requests and replaced only if a
+			 * response has been cut off in the middle of a bundle.
+			 */
+			class Receiver
+			{
+			public:
+				Receiver();
+				~Receiver();
+
+			private:
+				ibrcommon::iobuffer _buffer;
+
+			public:
+				std::ostream stream;
+
+			private:
+				DownloadThread _thread;
+			};
+
+			/**
+			 * A running long-poll request. The received data is written
+			 * into the stream of the Receiver.
+			 */
+			class Download
+			{
+			public:
+				Download(CURL *handle, std::ostream &stream);
+				~Download();
+
+				/** curl write function */
+				static size_t write(void *ptr, size_t size, size_t nmemb, void *d);
+
+				CURL * const handle;
+
+				/** number of bytes received with a successful response */
+				dtn::data::Length received;
+
+			private:
+				std::ostream &_stream;
+			};
+
+			/**
+			 * Create an easy handle with the options of all requests
+			 */
+			CURL* __create(const std::string &url) const;
+
+			/**
+			 * Add uploads of queued transfers to the multi handle
+			 */
+			void __start_uploads(std::map<CURL*, Upload*> &uploads, const std::string &url);
+
+			/**
+			 * Interrupt a waiting componentRun() loop
+			 */
+			void __wakeup();
+
 			/** Variable contains Tomcat-Server URL, which is specified
 			 * in the IBR-DTN configuration file.
 			 */
 			const std::string _server;
 
-			/** For managing access for iobuffer */
-			ibrcommon::Mutex _push_iob_mutex;
-			/** IO buffer in witch the received data will be witten.*/
-			ibrcommon::iobuffer *_push_iob;
-			/** variable to control the independent thread, when true the thread is running */
-			bool _running;
-		};
+			/** curl multi handle keeping the connections to the server */
+			CURLM *_multi;
 
-		class DownloadThread : public ibrcommon::JoinableThread
-		{
-		public:
+			/** header list of all uploads */
+			struct curl_slist *_upload_headers;
 
-			DownloadThread(ibrcommon::iobuffer &buf);
-			virtual ~DownloadThread();
+			/** pipe to interrupt curl_multi_wait() */
+			int _wakeup_fd[2];
 
-		protected:
-			void run() throw ();
-			void __cancellation() throw ();
+			/** transfers waiting for a free upload */
+			ibrcommon::Mutex _queue_lock;
+			std::queue<dtn::net::BundleTransfer> _queue;
 
-		private:
-			/** istream variable is using for reading from iobuffer */
-			std::istream _stream;
+			/** variable to control the independent thread, when true the thread is running */
+			bool _running;
 		};
-
 	}
 }
 
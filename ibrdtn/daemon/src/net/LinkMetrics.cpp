@@ -0,0 +1,260 @@
+/*
+ * LinkMetrics.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "net/LinkMetrics.h"
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/MonotonicClock.h>
+#include <sstream>
+
+namespace dtn
+{
+	namespace net
+	{
+		static const char* ABORT_TAGS[] = { "undefined", "down", "refused", "retries", "deleted", "filtered", "preempted" };
+
+		LinkMetrics::Slot::Slot()
+		 : second(0), in(0), out(0)
+		{
+		}
+
+		LinkMetrics::Slot::~Slot()
+		{
+		}
+
+		LinkMetrics::LinkMetrics()
+		 : _in(0), _out(0), _rtt(0), _queue(0), _retransmissions(0), _transfers(0)
+		{
+			for (unsigned int i = 0; i < ABORT_REASONS; ++i) _aborts[i] = 0;
+		}
+
+		LinkMetrics::~LinkMetrics()
+		{
+		}
+
+		ibrcommon::Mutex& LinkMetrics::__registry_lock()
+		{
+			static ibrcommon::Mutex lock;
+			return lock;
+		}
+
+		LinkMetrics::link_map& LinkMetrics::__registry()
+		{
+			static link_map registry;
+			return registry;
+		}
+
+		LinkMetrics::Handle LinkMetrics::get(const dtn::data::EID &peer, const dtn::core::Node::Protocol proto)
+		{
+			const link_key key(peer.getNode(), proto);
+
+			ibrcommon::MutexLock l(__registry_lock());
+
+			link_map::const_iterator it = __registry().find(key);
+			if (it != __registry().end()) return it->second;
+
+			const Handle m(new LinkMetrics());
+			__registry().insert(std::make_pair(key, m));
+			return m;
+		}
+
+		void LinkMetrics::remove(const dtn::data::EID &peer)
+		{
+			const dtn::data::EID node = peer.getNode();
+
+			ibrcommon::MutexLock l(__registry_lock());
+
+			for (link_map::iterator it = __registry().begin(); it != __registry().end();)
+			{
+				if (it->first.first == node)
+				{
+					__registry().erase(it++);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+
+		void LinkMetrics::getStats(ConvergenceLayer::stats_data &data)
+		{
+			ibrcommon::MutexLock l(__registry_lock());
+
+			for (link_map::const_iterator it = __registry().begin(); it != __registry().end(); ++it)
+			{
+				const link_key &key = it->first;
+				it->second->__getStats(key.first.getString() + "|" + dtn::core::Node::toString(key.second) + "|", data);
+			}
+		}
+
+		void LinkMetrics::getStats(const dtn::data::EID &peer, ConvergenceLayer::stats_data &data)
+		{
+			ibrcommon::MutexLock l(__registry_lock());
+
+			const dtn::data::EID node = peer.getNode();
+
+			for (link_map::const_iterator it = __registry().begin(); it != __registry().end(); ++it)
+			{
+				const link_key &key = it->first;
+				if (key.first != node) continue;
+				it->second->__getStats(dtn::core::Node::toString(key.second) + "|", data);
+			}
+		}
+
+		void LinkMetrics::resetStats()
+		{
+			ibrcommon::MutexLock l(__registry_lock());
+
+			for (link_map::iterator it = __registry().begin(); it != __registry().end(); ++it)
+			{
+				it->second->reset();
+			}
+		}
+
+		uint64_t LinkMetrics::__now() throw ()
+		{
+			struct timespec ts;
+			ibrcommon::MonotonicClock::gettime(ts);
+			return static_cast<uint64_t>(ts.tv_sec);
+		}
+
+		LinkMetrics::Slot& LinkMetrics::__slot() throw ()
+		{
+			const uint64_t now = __now();
+			Slot &s = _slots[now % (WINDOW + 1)];
+
+			const uint64_t second = s.second;
+			if (second != now)
+			{
+				// the first thread of a new second clears the slot, amounts
+				// added concurrently by other threads may get lost
+				if (__sync_bool_compare_and_swap(&s.second, second, now))
+				{
+					__sync_lock_test_and_set(&s.in, 0);
+					__sync_lock_test_and_set(&s.out, 0);
+				}
+			}
+
+			return s;
+		}
+
+		uint64_t LinkMetrics::__rate(uint64_t Slot::*field) const throw ()
+		{
+			const uint64_t now = __now();
+			uint64_t sum = 0;
+
+			// sum up all completed seconds of the window
+			for (unsigned int i = 0; i <= WINDOW; ++i)
+			{
+				const Slot &s = _slots[i];
+				if ((s.second < now) && (s.second + WINDOW >= now)) sum += s.*field;
+			}
+
+			return sum / WINDOW;
+		}
+
+		void LinkMetrics::addTrafficIn(size_t amount) throw ()
+		{
+			__sync_fetch_and_add(&_in, static_cast<uint64_t>(amount));
+			__sync_fetch_and_add(&__slot().in, static_cast<uint64_t>(amount));
+		}
+
+		void LinkMetrics::addTrafficOut(size_t amount) throw ()
+		{
+			__sync_fetch_and_add(&_out, static_cast<uint64_t>(amount));
+			__sync_fetch_and_add(&__slot().out, static_cast<uint64_t>(amount));
+		}
+
+		void LinkMetrics::addRoundTripTime(uint64_t rtt) throw ()
+		{
+			uint64_t current = _rtt;
+
+			while (true)
+			{
+				// smoothing as in TCP with a weight of 1/8 for the new value
+				const uint64_t smoothed = (current == 0) ? rtt : ((current * 7) + rtt) / 8;
+				const uint64_t prev = __sync_val_compare_and_swap(&_rtt, current, smoothed);
+				if (prev == current) break;
+				current = prev;
+			}
+		}
+
+		void LinkMetrics::setQueueDepth(size_t depth) throw ()
+		{
+			__sync_lock_test_and_set(&_queue, static_cast<uint64_t>(depth));
+		}
+
+		void LinkMetrics::addRetransmission(size_t count) throw ()
+		{
+			__sync_fetch_and_add(&_retransmissions, static_cast<uint64_t>(count));
+		}
+
+		void LinkMetrics::addTransfer() throw ()
+		{
+			__sync_fetch_and_add(&_transfers, 1);
+		}
+
+		void LinkMetrics::addAbort(TransferAbortedEvent::AbortReason reason) throw ()
+		{
+			const unsigned int i = static_cast<unsigned int>(reason);
+			__sync_fetch_and_add(&_aborts[(i < ABORT_REASONS) ? i : 0], 1);
+		}
+
+		uint64_t LinkMetrics::getRateIn() const throw ()
+		{
+			return __rate(&Slot::in);
+		}
+
+		uint64_t LinkMetrics::getRateOut() const throw ()
+		{
+			return __rate(&Slot::out);
+		}
+
+		void LinkMetrics::reset() throw ()
+		{
+			__sync_lock_test_and_set(&_in, 0);
+			__sync_lock_test_and_set(&_out, 0);
+			__sync_lock_test_and_set(&_rtt, 0);
+			__sync_lock_test_and_set(&_retransmissions, 0);
+			__sync_lock_test_and_set(&_transfers, 0);
+			for (unsigned int i = 0; i < ABORT_REASONS; ++i) __sync_lock_test_and_set(&_aborts[i], 0);
+		}
+
+		void LinkMetrics::__getStats(const std::string &prefix, ConvergenceLayer::stats_data &data) const
+		{
+			std::stringstream ss;
+
+			ss << _in; data[prefix + "in"] = ss.str(); ss.str("");
+			ss << _out; data[prefix + "out"] = ss.str(); ss.str("");
+			ss << getRateIn(); data[prefix + "in_rate"] = ss.str(); ss.str("");
+			ss << getRateOut(); data[prefix + "out_rate"] = ss.str(); ss.str("");
+			ss << _rtt; data[prefix + "rtt"] = ss.str(); ss.str("");
+			ss << _queue; data[prefix + "queue"] = ss.str(); ss.str("");
+			ss << _retransmissions; data[prefix + "retransmissions"] = ss.str(); ss.str("");
+			ss << _transfers; data[prefix + "transfers"] = ss.str(); ss.str("");
+
+			for (unsigned int i = 0; i < ABORT_REASONS; ++i)
+			{
+				ss << _aborts[i];
+				data[prefix + "aborted_" + ABORT_TAGS[i]] = ss.str();
+				ss.str("");
+			}
+		}
+	} /* namespace net */
+} /* namespace dtn */
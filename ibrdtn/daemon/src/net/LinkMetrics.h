@@ -0,0 +1,164 @@
+/*
+ * LinkMetrics.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef LINKMETRICS_H_
+#define LINKMETRICS_H_
+
+#include "net/ConvergenceLayer.h"
+#include "net/TransferAbortedEvent.h"
+#include "core/Node.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/refcnt_ptr.h>
+#include <stdint.h>
+#include <string>
+#include <map>
+
+namespace dtn
+{
+	namespace net
+	{
+		/**
+		 * Traffic metrics of the link to one peer over one convergence
+		 * layer. All counters are updated with atomic operations, thus
+		 * connections may record without any lock once they hold a
+		 * handle to their metrics object. Metrics objects are created
+		 * on first use and are dropped from the registry if the peer
+		 * becomes unavailable, the object lives until the last handle
+		 * is released.
+		 */
+		class LinkMetrics
+		{
+		public:
+			// length of the window for the throughput in seconds
+			static const unsigned int WINDOW = 10;
+
+			typedef refcnt_ptr<LinkMetrics> Handle;
+
+			virtual ~LinkMetrics();
+
+			/**
+			 * Returns the metrics of the link to a peer, the object is
+			 * created if necessary. Connections should resolve the handle
+			 * once and hold it.
+			 */
+			static Handle get(const dtn::data::EID &peer, const dtn::core::Node::Protocol proto);
+
+			/**
+			 * Drop the metrics of all links to a peer from the registry
+			 */
+			static void remove(const dtn::data::EID &peer);
+
+			/**
+			 * Add the metrics of all links to the data, keyed by
+			 * "<peer>|<protocol>|<metric>"
+			 */
+			static void getStats(ConvergenceLayer::stats_data &data);
+
+			/**
+			 * Add the metrics of all links to a peer to the data, keyed
+			 * by "<protocol>|<metric>"
+			 */
+			static void getStats(const dtn::data::EID &peer, ConvergenceLayer::stats_data &data);
+
+			/**
+			 * Reset the counters of all links
+			 */
+			static void resetStats();
+
+			void addTrafficIn(size_t amount) throw ();
+			void addTrafficOut(size_t amount) throw ();
+
+			/**
+			 * Add a measured round-trip-time in microseconds, the reported
+			 * value is smoothed by an exponential moving average
+			 */
+			void addRoundTripTime(uint64_t rtt) throw ();
+
+			/**
+			 * Set the number of bundles waiting for the transmission
+			 */
+			void setQueueDepth(size_t depth) throw ();
+
+			void addRetransmission(size_t count = 1) throw ();
+			void addTransfer() throw ();
+			void addAbort(TransferAbortedEvent::AbortReason reason) throw ();
+
+			/**
+			 * Returns the throughput in bytes per second over the last window
+			 */
+			uint64_t getRateIn() const throw ();
+			uint64_t getRateOut() const throw ();
+
+			void reset() throw ();
+
+		private:
+			LinkMetrics();
+
+			typedef std::pair<dtn::data::EID, dtn::core::Node::Protocol> link_key;
+			typedef std::map<link_key, Handle> link_map;
+
+			static ibrcommon::Mutex& __registry_lock();
+			static link_map& __registry();
+
+			/**
+			 * Write the metrics to the data using the given key prefix
+			 */
+			void __getStats(const std::string &prefix, ConvergenceLayer::stats_data &data) const;
+
+			/**
+			 * Returns the monotonic time in seconds
+			 */
+			static uint64_t __now() throw ();
+
+			class Slot
+			{
+			public:
+				Slot();
+				~Slot();
+
+				uint64_t second;
+				uint64_t in;
+				uint64_t out;
+			};
+
+			/**
+			 * Returns the slot of the current second, outdated slots are cleared
+			 */
+			Slot& __slot() throw ();
+
+			uint64_t __rate(uint64_t Slot::*field) const throw ();
+
+			static const unsigned int ABORT_REASONS = 7;
+
+			uint64_t _in;
+			uint64_t _out;
+			uint64_t _rtt;
+			uint64_t _queue;
+			uint64_t _retransmissions;
+			uint64_t _transfers;
+			uint64_t _aborts[ABORT_REASONS];
+
+			// one more slot than the window, the current second is incomplete
+			Slot _slots[WINDOW + 1];
+		};
+	} /* namespace net */
+} /* namespace dtn */
+
+#endif /* LINKMETRICS_H_ */
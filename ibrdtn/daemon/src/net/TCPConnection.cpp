@@ -29,9 +29,13 @@
 #include "net/TCPConvergenceLayer.h"
 #include "net/ConnectionEvent.h"
 #include "net/TransferAbortedEvent.h"
+#include "routing/BaseRouter.h"
+
+#include <ibrdtn/data/PayloadBlock.h>
 
 #include <ibrcommon/net/socket.h>
 #include <ibrcommon/TimeMeasurement.h>
+#include <ibrcommon/MonotonicClock.h>
 #include <ibrcommon/net/vinterface.h>
 #include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/RWLock.h>
@@ -40,6 +44,7 @@
 #include <iostream>
 #include <iomanip>
 #include <memory>
+#include <algorithm>
 
 #ifdef WITH_TLS
 #include "security/SecurityCertificateManager.h"
@@ -59,8 +64,8 @@ namespace dtn
 		 */
 		TCPConnection::TCPConnection(TCPConvergenceLayer &tcpsrv, const dtn::core::Node &node, ibrcommon::clientsocket *sock, const size_t timeout)
 		 : _peer(), _node(node), _socket(sock), _socket_stream(NULL), _sec_stream(NULL), _protocol_stream(NULL), _sender(*this),
-		   _keepalive_sender(*this, _keepalive_timeout), _timeout(timeout), _lastack(0), _resume_offset(0), _keepalive_timeout(0),
-		   _callback(tcpsrv), _flags(0), _aborted(false)
+		   _express_sender(*this, true), _keepalive_sender(*this, _keepalive_timeout), _timeout(timeout), _interleaving(false), _lastack(0), _resume_offset(0), _keepalive_timeout(0),
+		   _callback(tcpsrv), _flags(0), _aborted(false), _metrics_ref(NULL), _metrics(NULL), _last_flush(0)
 		{
 		}
 
@@ -69,8 +74,9 @@ namespace dtn
 			// join the keepalive sender thread
 			_keepalive_sender.join();
 
-			// wait until the sender thread is finished
+			// wait until the sender threads are finished
 			_sender.join();
+			_express_sender.join();
 
 			// clean-up
 			{
@@ -90,9 +96,40 @@ namespace dtn
 			}
 		}
 
-		void TCPConnection::queue(const dtn::net::BundleTransfer &job)
+		void TCPConnection::queue(const dtn::net::BundleTransfer &j)
+		{
+			dtn::net::BundleTransfer job = j;
+			if (_metrics != NULL) job.setMetrics(_metrics_ref);
+
+			try {
+				if (_interleaving && __express(job.getBundle()))
+				{
+					_express_sender.push(job);
+				}
+				else
+				{
+					_sender.push(job);
+				}
+			} catch (const ibrcommon::QueueUnblockedException&) {
+				// the sender is gone, dropping the job requeues the transfer
+			}
+
+			__updateQueueDepth();
+		}
+
+		void TCPConnection::__updateQueueDepth() throw ()
 		{
-			_sender.push(job);
+			if (_metrics == NULL) return;
+			_metrics->setQueueDepth(_sender.size() + _express_sender.size());
+		}
+
+		bool TCPConnection::__express(const dtn::data::MetaBundle &meta) const
+		{
+			// expedited bundles
+			if (meta.getPriority() > 0) return true;
+
+			// bundles fitting into one segment
+			return (meta.getPayloadLength() <= dtn::daemon::Configuration::getInstance().getNetwork().getTCPChunkSize());
 		}
 
 		const dtn::streams::StreamContactHeader& TCPConnection::getHeader() const
@@ -140,8 +177,16 @@ namespace dtn
 			{
 				try{
 					ibrcommon::TLSStream &tls = dynamic_cast<ibrcommon::TLSStream&>(*_sec_stream);
+
+					// resume the session of the last contact with this node
+					tls.setPeer(_peer.getEID().getNode().getString());
+
 					X509 *peer_cert = tls.activate();
 
+					if (tls.isResumed()) {
+						IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 20) << "TLS session with " << _peer.getEID().getString() << " resumed" << IBRCOMMON_LOGGER_ENDL;
+					}
+
 					// check the full EID first
 					const std::string cn = _peer.getEID().getString();
 
@@ -208,8 +253,15 @@ namespace dtn
 				return;
 			}
 
+			_metrics_ref = LinkMetrics::get(_node.getEID(), Node::CONN_TCPIP);
+			_metrics = &(*_metrics_ref);
+
 			_keepalive_timeout = header._keepalive * 1000;
 
+			// use the express lane if both peers support it
+			_interleaving = _flags.getBit(dtn::streams::StreamContactHeader::REQUEST_INTERLEAVING)
+					&& header._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_INTERLEAVING);
+
 			try {
 				// initiate extended handshake (e.g. TLS)
 				initiateExtendedHandshake();
@@ -255,8 +307,9 @@ namespace dtn
 				// shutdown the keepalive sender thread
 				_keepalive_sender.stop();
 
-				// stop the sender
+				// stop the senders
 				_sender.stop();
+				_express_sender.stop();
 			} catch (const ibrcommon::ThreadException &ex) {
 				IBRCOMMON_LOGGER_TAG(TCPConnection::TAG, error) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
@@ -301,6 +354,16 @@ namespace dtn
 				return;
 			}
 
+			// the acknowledgement of the only outstanding bundle
+			// follows the transmission by one round-trip-time
+			if ((_metrics != NULL) && (l.size() == 1) && (_last_flush > 0))
+			{
+				struct timespec ts;
+				ibrcommon::MonotonicClock::gettime(ts);
+				const uint64_t now = (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
+				if (now > _last_flush) _metrics->addRoundTripTime(now - _last_flush);
+			}
+
 			// get the job on top of the sent queue
 			dtn::net::BundleTransfer &job = l.front();
 
@@ -319,14 +382,96 @@ namespace dtn
 			_lastack = ack;
 		}
 
+		void TCPConnection::eventExpressBundleForwarded() throw ()
+		{
+			ibrcommon::Queue<dtn::net::BundleTransfer>::Locked l = _express_sentqueue.exclusive();
+
+			// stop here if the queue is already empty
+			if (l.empty()) {
+				IBRCOMMON_LOGGER_TAG(TCPConnection::TAG, error) << "express transfer completed without a bundle in queue" << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			// mark job as complete
+			l.front().complete();
+
+			// release the job
+			l.pop();
+		}
+
+		void TCPConnection::eventExpressBundleRefused() throw ()
+		{
+			ibrcommon::Queue<dtn::net::BundleTransfer>::Locked l = _express_sentqueue.exclusive();
+
+			// stop here if the queue is already empty
+			if (l.empty()) {
+				IBRCOMMON_LOGGER_TAG(TCPConnection::TAG, error) << "express transfer refused without a bundle in queue" << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 10) << "express bundle refused by " << _peer._localeid.getString() << IBRCOMMON_LOGGER_ENDL;
+
+			// abort the transmission
+			l.front().abort(dtn::net::TransferAbortedEvent::REASON_REFUSED);
+
+			// release the job
+			l.pop();
+		}
+
+		bool TCPConnection::eventExpressBundleReceived(std::istream &stream) throw ()
+		{
+			try {
+				dtn::data::Bundle bundle;
+
+				dtn::data::DefaultDeserializer deserializer(stream, dtn::core::BundleCore::getInstance());
+				deserializer.setFragmentationSupport(_peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION));
+				deserializer >> bundle;
+
+				// check the bundle
+				if ( ( bundle.destination == EID() ) || ( bundle.source == EID() ) )
+				{
+					// invalid bundle!
+					throw dtn::data::Validator::RejectedException("destination or source EID is null");
+				}
+
+				// express bundles are verified here instead of the verification pool,
+				// because the last segment is not acknowledged until the bundle is accepted
+				dtn::core::FilterContext context;
+				context.setPeer(_peer._localeid);
+				context.setProtocol(_callback.getDiscoveryProtocol());
+				context.setBundle(bundle);
+
+				switch (dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::INPUT, context, bundle)) {
+					case BundleFilter::ACCEPT:
+						// inject bundle into core
+						dtn::core::BundleCore::getInstance().inject(_peer._localeid, bundle, false);
+						return true;
+
+					case BundleFilter::REJECT:
+						IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 2) << "express bundle refused by input filter: " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+						return false;
+
+					default:
+						// accept and discard the bundle silently
+						return true;
+				}
+			} catch (const std::exception &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 2) << "express bundle refused: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			return false;
+		}
+
 		void TCPConnection::addTrafficIn(size_t amount) throw ()
 		{
 			_callback.addTrafficIn(amount);
+			if (_metrics != NULL) _metrics->addTrafficIn(amount);
 		}
 
 		void TCPConnection::addTrafficOut(size_t amount) throw ()
 		{
 			_callback.addTrafficOut(amount);
+			if (_metrics != NULL) _metrics->addTrafficOut(amount);
 		}
 
 		void TCPConnection::initialize() throw ()
@@ -371,8 +516,9 @@ namespace dtn
 				// shutdown the keepalive sender thread
 				_keepalive_sender.stop();
 
-				// shutdown the sender thread
+				// shutdown the sender threads
 				_sender.stop();
+				_express_sender.stop();
 			} catch (const std::exception&) { };
 
 			// close the tcpstream
@@ -382,6 +528,11 @@ namespace dtn
 				_callback.connectionDown(this);
 			} catch (const ibrcommon::MutexException&) { };
 
+			// wait until a cut-through transfer to this connection is released
+			{
+				ibrcommon::MutexLock l(_send_lock);
+			}
+
 			// clear the queue
 			clearQueue();
 		}
@@ -395,6 +546,11 @@ namespace dtn
 			{
 				_flags |= dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION;
 			}
+
+			if (dtn::daemon::Configuration::getInstance().getNetwork().doTCPInterleaving())
+			{
+				_flags |= dtn::streams::StreamContactHeader::REQUEST_INTERLEAVING;
+			}
 		}
 
 		void TCPConnection::__setup_socket(ibrcommon::clientsocket *sock, bool server)
@@ -426,6 +582,7 @@ namespace dtn
 			if (_protocol_stream != NULL) delete _protocol_stream;
 			_protocol_stream = new dtn::streams::StreamConnection(*this, (_sec_stream == NULL) ? *_socket_stream : *_sec_stream, chunksize);
 			_protocol_stream->exceptions(std::ios::badbit | std::ios::eofbit);
+			_protocol_stream->express().exceptions(std::ios::badbit | std::ios::eofbit);
 		}
 
 		void TCPConnection::connect()
@@ -516,8 +673,9 @@ namespace dtn
 				// do the handshake
 				(*sc).handshake(dtn::core::BundleCore::local, _timeout, _flags);
 
-				// start the sender
+				// start the senders
 				_sender.start();
+				_express_sender.start();
 
 				// start keepalive sender
 				_keepalive_sender.start();
@@ -527,8 +685,15 @@ namespace dtn
 				context.setPeer(_peer._localeid);
 				context.setProtocol(_callback.getDiscoveryProtocol());
 
+				// forward bundles to connected neighbors while they are received
+				const bool cut_through = dtn::daemon::Configuration::getInstance().getNetwork().doTCPCutThrough();
+				CutThrough ct(*this, stream);
+				std::istream ct_stream(&ct);
+				ct_stream.exceptions(std::ios::badbit | std::ios::eofbit);
+
 				// create a deserializer for next bundle
-				dtn::data::DefaultDeserializer deserializer(stream, dtn::core::BundleCore::getInstance());
+				dtn::data::DefaultDeserializer deserializer(cut_through ? ct_stream : stream,
+						cut_through ? (dtn::data::Validator&)ct : (dtn::data::Validator&)dtn::core::BundleCore::getInstance());
 
 				while (!(*sc).eof())
 				{
@@ -543,7 +708,9 @@ namespace dtn
 						deserializer.setFragmentationSupport(_peer._flags.getBit(dtn::streams::StreamContactHeader::REQUEST_FRAGMENTATION));
 
 						// read the bundle (or the fragment if fragmentation is enabled)
+						if (cut_through) ct.begin();
 						deserializer >> bundle;
+						if (cut_through) ct.finish();
 
 						// check the bundle
 						if ( ( bundle.destination == EID() ) || ( bundle.source == EID() ) )
@@ -552,6 +719,9 @@ namespace dtn
 							throw dtn::data::Validator::RejectedException("destination or source EID is null");
 						}
 
+						// hand over secured bundles to the verification pool
+						if (_verification.push(_peer._localeid, _callback.getDiscoveryProtocol(), bundle)) continue;
+
 						// push bundle through the filter routines
 						context.setBundle(bundle);
 						BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().filter(dtn::core::BundleFilter::INPUT, context, bundle);
@@ -572,6 +742,9 @@ namespace dtn
 					}
 					catch (const dtn::data::Validator::RejectedException &ex)
 					{
+						// complete or abort a forwarded transfer
+						if (cut_through) ct.finish();
+
 						// bundle rejected
 						rejectTransmission();
 
@@ -579,6 +752,9 @@ namespace dtn
 						IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 2) << "bundle has been rejected: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
 					}
 					catch (const dtn::InvalidDataException &ex) {
+						// complete or abort a forwarded transfer
+						if (cut_through) ct.finish();
+
 						// bundle rejected
 						rejectTransmission();
 
@@ -588,6 +764,9 @@ namespace dtn
 
 					yield();
 				}
+
+				// wait until all pending bundles are verified
+				_verification.flush();
 			} catch (const ibrcommon::ThreadException &ex) {
 				IBRCOMMON_LOGGER_TAG(TCPConnection::TAG, error) << "failed to start thread in TCPConnection\n" << ex.what() << IBRCOMMON_LOGGER_ENDL;
 				try {
@@ -645,8 +824,8 @@ namespace dtn
 			_wait.abort();
 		}
 
-		TCPConnection::Sender::Sender(TCPConnection &connection)
-		 : _connection(connection)
+		TCPConnection::Sender::Sender(TCPConnection &connection, const bool express)
+		 : _connection(connection), _express(express)
 		{
 		}
 
@@ -657,7 +836,7 @@ namespace dtn
 		void TCPConnection::Sender::__cancellation() throw ()
 		{
 			// cancel the main thread in here
-			ibrcommon::Queue<dtn::net::BundleTransfer>::abort();
+			ibrcommon::RingQueue<dtn::net::BundleTransfer>::abort();
 		}
 
 		void TCPConnection::Sender::run() throw ()
@@ -666,7 +845,7 @@ namespace dtn
 				dtn::storage::BundleStorage &storage = dtn::core::BundleCore::getInstance().getStorage();
 
 				TCPConnection::safe_streamconnection sc = _connection.getProtocolStream();
-				std::iostream &stream = (*sc);
+				std::ostream &stream = _express ? (*sc).express() : (std::ostream&)(*sc);
 
 				// create a filter context
 				dtn::core::FilterContext context;
@@ -678,12 +857,21 @@ namespace dtn
 
 				while (stream.good())
 				{
-					dtn::net::BundleTransfer transfer = ibrcommon::Queue<dtn::net::BundleTransfer>::poll();
+					dtn::net::BundleTransfer transfer = ibrcommon::RingQueue<dtn::net::BundleTransfer>::poll();
+					_connection.__updateQueueDepth();
 
 					// check if the transfer is directed to the connected neighbor
 					if (transfer.getNeighbor() != _connection.getNode().getEID()) continue;
 
 					try {
+						// hand-over bundles too large for the express lane before the payload is loaded,
+						// other storages read the whole bundle for a view and the length is checked below
+						if (_express && storage.hasLazyView() && (storage.view(transfer.getBundle()).getLength() > dtn::streams::StreamConnection::EXPRESS_LIMIT))
+						{
+							_connection._sender.push(transfer);
+							continue;
+						}
+
 						// read the bundle out of the storage
 						dtn::data::Bundle bundle = storage.get(transfer.getBundle());
 
@@ -700,6 +888,28 @@ namespace dtn
 								continue;
 						}
 
+						if (_express)
+						{
+							// hand-over bundles grown by the filters
+							if (serializer.getLength(bundle) > dtn::streams::StreamConnection::EXPRESS_LIMIT)
+							{
+								_connection._sender.push(transfer);
+								continue;
+							}
+
+							// put the bundle into the sentqueue
+							_connection._express_sentqueue.push(transfer);
+
+							// transmit the bundle
+							serializer << bundle;
+							stream << std::flush;
+
+							continue;
+						}
+
+						// exclusive access to the stream for the whole bundle
+						ibrcommon::MutexLock send_lock(_connection._send_lock);
+
 						// send bundle
 						// get the offset, if this bundle has been reactively fragmented before
 						if (dtn::daemon::Configuration::getInstance().getNetwork().doFragmentation()
@@ -734,6 +944,10 @@ namespace dtn
 
 							// flush the stream
 							stream << std::flush;
+
+							struct timespec ts;
+							ibrcommon::MonotonicClock::gettime(ts);
+							_connection._last_flush = (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
 						} catch (const ibrcommon::Exception &ex) {
 							// the connection not available
 							IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 10) << "connection error: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
@@ -759,8 +973,214 @@ namespace dtn
 			_connection.stop();
 		}
 
+		TCPConnection::CutThrough::CutThrough(TCPConnection &connection, std::istream &source)
+		 : _connection(connection), _source(source), _recording(false), _sink(NULL), _transfer(NULL), _remaining(0)
+		{
+		}
+
+		TCPConnection::CutThrough::~CutThrough()
+		{
+			finish();
+		}
+
+		void TCPConnection::CutThrough::begin() throw ()
+		{
+			finish();
+
+			_prefix.clear();
+			_recording = true;
+		}
+
+		void TCPConnection::CutThrough::finish() throw ()
+		{
+			_prefix.clear();
+			_recording = false;
+
+			if (_sink == NULL) return;
+
+			if (_remaining == 0)
+			{
+				try {
+					// end the bundle on the outgoing connection
+					(*_sink->getProtocolStream()) << std::flush;
+				} catch (const std::exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 10) << "cut-through transfer failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+				}
+			}
+			else
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 10) << "cut-through transfer of " << _transfer->getBundle().toString() << " interrupted" << IBRCOMMON_LOGGER_ENDL;
+
+				// the bundle is incomplete and the outgoing connection
+				// has to be closed to withdraw the partial bundle
+				_transfer->abort(dtn::net::TransferAbortedEvent::REASON_CONNECTION_DOWN);
+				_sink->shutdown();
+			}
+
+			__release();
+		}
+
+		void TCPConnection::CutThrough::validate(const dtn::data::PrimaryBlock &primary) const throw (RejectedException)
+		{
+			dtn::core::BundleCore::getInstance().validate(primary);
+		}
+
+		void TCPConnection::CutThrough::validate(const dtn::data::Block &block, const dtn::data::Number &size) const throw (RejectedException)
+		{
+			dtn::core::BundleCore::getInstance().validate(block, size);
+		}
+
+		void TCPConnection::CutThrough::validate(const dtn::data::PrimaryBlock &primary, const dtn::data::Block &block, const dtn::data::Number &size) const throw (RejectedException)
+		{
+			dtn::core::BundleCore::getInstance().validate(primary, block, size);
+
+			// the payload block is reached and everything before is known
+			if (_recording && (block.getType() == dtn::data::PayloadBlock::BLOCK_TYPE))
+			{
+				_recording = false;
+				__engage(primary, block, size);
+				_prefix.clear();
+			}
+		}
+
+		void TCPConnection::CutThrough::validate(const dtn::data::Bundle &bundle) const throw (RejectedException)
+		{
+			dtn::core::BundleCore::getInstance().validate(bundle);
+		}
+
+		void TCPConnection::CutThrough::__engage(const dtn::data::PrimaryBlock &primary, const dtn::data::Block &block, const dtn::data::Number &size) const throw ()
+		{
+			// only bundles consisting of the primary and the payload block are
+			// forwarded, other blocks may have to be processed on each hop
+			const dtn::data::Bundle *bundle = dynamic_cast<const dtn::data::Bundle*>(&primary);
+			if ((bundle == NULL) || (bundle->size() != 1) || !block.get(dtn::data::Block::LAST_BLOCK)) return;
+
+			// bundles with custody transfer need to be accepted locally first
+			if (!primary.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON)) return;
+			if (primary.get(dtn::data::PrimaryBlock::CUSTODY_REQUESTED)) return;
+
+			// do not forward local bundles or bundles back to the sender
+			if (primary.destination.sameHost(dtn::core::BundleCore::local)) return;
+			if (primary.destination.sameHost(_connection._peer._localeid)) return;
+
+			const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(*bundle);
+
+			// skip known bundles
+			if (dtn::core::BundleCore::getInstance().getStorage().contains(meta)) return;
+
+			// the filter rules have to accept the bundle without the payload
+			dtn::core::FilterContext context;
+			context.setPeer(_connection._peer._localeid);
+			context.setProtocol(_connection._callback.getDiscoveryProtocol());
+			context.setPrimaryBlock(primary);
+			if (dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::INPUT, context) != dtn::core::BundleFilter::ACCEPT) return;
+
+			TCPConnection *sink = _connection._callback.lockConnection(primary.destination, _connection);
+			if (sink == NULL) return;
+
+			const dtn::data::EID neighbor = sink->getNode().getEID();
+
+			context.setPeer(neighbor);
+			if (dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::OUTPUT, context) != dtn::core::BundleFilter::ACCEPT)
+			{
+				sink->_send_lock.leave();
+				return;
+			}
+
+			try {
+				// acquire the transfer like the routing does
+				dtn::routing::NeighborDatabase &db = dtn::core::BundleCore::getInstance().getRouter().getNeighborDB();
+				ibrcommon::MutexLock l(db);
+
+				dtn::routing::NeighborDatabase::NeighborEntry &entry = db.get(neighbor, true);
+				if (entry.has(meta)) throw dtn::routing::NeighborDatabase::AlreadyInTransitException();
+				entry.acquireTransfer(meta);
+			} catch (const ibrcommon::Exception&) {
+				sink->_send_lock.leave();
+				return;
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 15) << "cut-through of bundle " << meta.toString() << " to " << neighbor.getString() << IBRCOMMON_LOGGER_ENDL;
+
+			_sink = sink;
+			_transfer = new dtn::net::BundleTransfer(neighbor, meta, dtn::core::Node::CONN_TCPIP);
+			_remaining = size.get<dtn::data::Length>();
+
+			// the acknowledgement of the neighbor completes the transfer
+			_sink->_resume_offset = 0;
+			_sink->_sentqueue.push(*_transfer);
+
+			// send the blocks received so far
+			const_cast<CutThrough*>(this)->__forward(_prefix.c_str(), _prefix.length());
+		}
+
+		void TCPConnection::CutThrough::__forward(const char *data, std::streamsize length) throw ()
+		{
+			if (_recording) _prefix.append(data, length);
+
+			if (_sink == NULL) return;
+
+			try {
+				(*_sink->getProtocolStream()).write(data, length);
+			} catch (const std::exception &ex) {
+				IBRCOMMON_LOGGER_DEBUG_TAG(TCPConnection::TAG, 10) << "cut-through transfer failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the outgoing connection is broken, release it at once to
+				// not hold its teardown until the bundle is received, the
+				// stored bundle is requeued once the connection is down
+				_sink->shutdown();
+				__release();
+			}
+		}
+
+		void TCPConnection::CutThrough::__release() throw ()
+		{
+			// the job stays in the sent queue of the outgoing connection
+			delete _transfer;
+			_transfer = NULL;
+
+			try {
+				_sink->_send_lock.leave();
+			} catch (const ibrcommon::MutexException&) { };
+			_sink = NULL;
+		}
+
+		TCPConnection::CutThrough::int_type TCPConnection::CutThrough::underflow()
+		{
+			return _source.rdbuf()->sgetc();
+		}
+
+		TCPConnection::CutThrough::int_type TCPConnection::CutThrough::uflow()
+		{
+			const int_type c = _source.rdbuf()->sbumpc();
+			if (traits_type::eq_int_type(c, traits_type::eof())) return c;
+
+			const char data = traits_type::to_char_type(c);
+			if (_sink != NULL && _remaining > 0) --_remaining;
+			__forward(&data, 1);
+
+			return c;
+		}
+
+		std::streamsize TCPConnection::CutThrough::xsgetn(char *s, std::streamsize n)
+		{
+			const std::streamsize ret = _source.rdbuf()->sgetn(s, n);
+			if (ret <= 0) return ret;
+
+			if (_sink != NULL) _remaining -= std::min(_remaining, static_cast<dtn::data::Length>(ret));
+			__forward(s, ret);
+
+			return ret;
+		}
+
 		void TCPConnection::clearQueue()
 		{
+			// requeue all bundles of the express lane
+			{
+				ibrcommon::Queue<dtn::net::BundleTransfer>::Locked l = _express_sentqueue.exclusive();
+				while (!l.empty()) l.pop();
+			}
+
 			// requeue all bundles still in transit
 			ibrcommon::Queue<dtn::net::BundleTransfer>::Locked l = _sentqueue.exclusive();
 
@@ -803,6 +1223,8 @@ namespace dtn
 
 		void TCPConnection::Sender::finally() throw ()
 		{
+			// do not block producers on a full queue once the sender is gone
+			ibrcommon::RingQueue<dtn::net::BundleTransfer>::abort();
 		}
 
 		bool TCPConnection::match(const dtn::core::Node &n) const
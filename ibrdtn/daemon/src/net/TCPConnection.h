@@ -23,6 +23,8 @@
 #define TCPCONNECTION_H_
 
 #include "core/NodeEvent.h"
+#include "net/LinkMetrics.h"
+#include "core/VerificationPool.h"
 
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
@@ -35,9 +37,12 @@
 #include <ibrcommon/net/socket.h>
 #include <ibrcommon/net/socketstream.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/thread/RingQueue.h>
 #include <ibrcommon/thread/SharedReference.h>
 
 #include <memory>
+#include <streambuf>
+#include <string>
 
 namespace dtn
 {
@@ -47,6 +52,8 @@ namespace dtn
 
 		class TCPConnection : public dtn::streams::StreamConnection::Callback, public ibrcommon::DetachedThread
 		{
+			friend class TCPConvergenceLayer;
+
 			const static std::string TAG;
 		public:
 			/**
@@ -100,6 +107,10 @@ namespace dtn
 			virtual void eventBundleForwarded() throw ();
 			virtual void eventBundleAck(const dtn::data::Length &ack) throw ();
 
+			virtual void eventExpressBundleForwarded() throw ();
+			virtual void eventExpressBundleRefused() throw ();
+			virtual bool eventExpressBundleReceived(std::istream &stream) throw ();
+
 			virtual void addTrafficIn(size_t) throw ();
 			virtual void addTrafficOut(size_t) throw ();
 
@@ -161,10 +172,10 @@ namespace dtn
 				size_t &_keepalive_timeout;
 			};
 
-			class Sender : public ibrcommon::JoinableThread, public ibrcommon::Queue<dtn::net::BundleTransfer>
+			class Sender : public ibrcommon::JoinableThread, public ibrcommon::RingQueue<dtn::net::BundleTransfer>
 			{
 			public:
-				Sender(TCPConnection &connection);
+				Sender(TCPConnection &connection, const bool express = false);
 				virtual ~Sender();
 
 			protected:
@@ -174,10 +185,85 @@ namespace dtn
 
 			private:
 				TCPConnection &_connection;
+
+				// this sender serves the express lane
+				const bool _express;
+			};
+
+			/**
+			 * Forwards a received bundle to the connection of its destination
+			 * while it is still received (cut-through). This object is placed
+			 * between the protocol stream and the deserializer. Once the
+			 * payload block is reached, the bytes read so far and all following
+			 * bytes of the bundle are copied to the outgoing connection. The
+			 * bundle is stored as usual, thus the regular routing takes over
+			 * if the outgoing transfer fails.
+			 */
+			class CutThrough : public std::streambuf, public dtn::data::Validator
+			{
+			public:
+				CutThrough(TCPConnection &connection, std::istream &source);
+				virtual ~CutThrough();
+
+				/**
+				 * Prepare for the reception of the next bundle
+				 */
+				void begin() throw ();
+
+				/**
+				 * Complete the outgoing transfer of the current bundle. If the
+				 * bundle has not been forwarded completely, the outgoing
+				 * connection is closed since a partial bundle can not be
+				 * withdrawn.
+				 */
+				void finish() throw ();
+
+				virtual void validate(const dtn::data::PrimaryBlock&) const throw (RejectedException);
+				virtual void validate(const dtn::data::Block&, const dtn::data::Number&) const throw (RejectedException);
+				virtual void validate(const dtn::data::PrimaryBlock&, const dtn::data::Block&, const dtn::data::Number&) const throw (RejectedException);
+				virtual void validate(const dtn::data::Bundle&) const throw (RejectedException);
+
+			protected:
+				virtual int_type underflow();
+				virtual int_type uflow();
+				virtual std::streamsize xsgetn(char *s, std::streamsize n);
+
+			private:
+				/**
+				 * Start forwarding the bundle if its destination is connected
+				 */
+				void __engage(const dtn::data::PrimaryBlock &primary, const dtn::data::Block &block, const dtn::data::Number &size) const throw ();
+
+				/**
+				 * Copy received data to the outgoing connection
+				 */
+				void __forward(const char *data, std::streamsize length) throw ();
+
+				/**
+				 * Leave the outgoing connection
+				 */
+				void __release() throw ();
+
+				TCPConnection &_connection;
+				std::istream &_source;
+
+				// bytes of the current bundle received before forwarding started
+				mutable std::string _prefix;
+				mutable bool _recording;
+
+				// outgoing connection with its send lock held
+				mutable TCPConnection *_sink;
+				mutable dtn::net::BundleTransfer *_transfer;
+				mutable dtn::data::Length _remaining;
 			};
 
 			void __setup_socket(ibrcommon::clientsocket *sock, bool server);
 
+			/**
+			 * Returns true, if the bundle should be sent on the express lane
+			 */
+			bool __express(const dtn::data::MetaBundle &meta) const;
+
 			// lock object for the procotol stream
 			typedef ibrcommon::SharedReference<dtn::streams::StreamConnection> safe_streamconnection;
 
@@ -187,6 +273,11 @@ namespace dtn
 			 */
 			safe_streamconnection getProtocolStream() throw (ibrcommon::Exception);
 
+			/**
+			 * Report the number of queued bundles to the link metrics
+			 */
+			void __updateQueueDepth() throw ();
+
 			dtn::streams::StreamContactHeader _peer;
 			dtn::core::Node _node;
 
@@ -207,6 +298,10 @@ namespace dtn
 			// and transmit them to the peer.
 			Sender _sender;
 
+			// Transmits small and expedited bundles interleaved with
+			// the transfers of the regular sender.
+			Sender _express_sender;
+
 			// Keepalive sender
 			KeepaliveSender _keepalive_sender;
 
@@ -214,6 +309,13 @@ namespace dtn
 			size_t _timeout;
 
 			ibrcommon::Queue<dtn::net::BundleTransfer> _sentqueue;
+			ibrcommon::Queue<dtn::net::BundleTransfer> _express_sentqueue;
+
+			// true, if the express lane has been negotiated
+			bool _interleaving;
+
+			// held while a bundle is written to the protocol stream
+			ibrcommon::Mutex _send_lock;
 			dtn::data::Length _lastack;
 			dtn::data::Length _resume_offset;
 			size_t _keepalive_timeout;
@@ -225,6 +327,16 @@ namespace dtn
 
 			/* with this boolean the connection is marked as aborted */
 			bool _aborted;
+
+			// metrics of the link to the peer, set once the connection is up
+			LinkMetrics::Handle _metrics_ref;
+			LinkMetrics *_metrics;
+
+			// time of the last completed bundle transmission in microseconds
+			uint64_t _last_flush;
+
+			// received bundles pending in the verification pool
+			dtn::core::VerificationPool::Lane _verification;
 		};
 	}
 }
@@ -509,6 +509,31 @@ namespace dtn
 			}
 		}
 
+		TCPConnection* TCPConvergenceLayer::lockConnection(const dtn::data::EID &destination, const TCPConnection &source)
+		{
+			ibrcommon::MutexLock l(_connections_cond);
+			for (std::list<TCPConnection*>::iterator iter = _connections.begin(); iter != _connections.end(); ++iter)
+			{
+				TCPConnection &conn = *(*iter);
+
+				if (&conn == &source) continue;
+				if (!conn.match(destination)) continue;
+
+				// skip connections without a completed handshake
+				if (conn._peer._localeid == dtn::data::EID()) return NULL;
+
+				try {
+					// do not wait for a transmission in progress
+					conn._send_lock.trylock();
+					return &conn;
+				} catch (const ibrcommon::MutexException&) {
+					return NULL;
+				}
+			}
+
+			return NULL;
+		}
+
 		void TCPConvergenceLayer::addTrafficIn(size_t amount) throw ()
 		{
 			ibrcommon::MutexLock l(_stats_lock);
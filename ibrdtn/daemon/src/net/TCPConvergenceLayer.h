@@ -150,6 +150,14 @@ namespace dtn
 			 */
 			void connectionDown(TCPConnection *conn);
 
+			/**
+			 * Returns an established connection to the given destination with
+			 * its send lock held or NULL, if there is no idle connection.
+			 * @param destination The destination of a bundle
+			 * @param source The connection the bundle is received on
+			 */
+			TCPConnection* lockConnection(const dtn::data::EID &destination, const TCPConnection &source);
+
 			/**
 			 * Reports inbound traffic amount
 			 */
@@ -78,6 +78,9 @@ namespace dtn
 
 			case REASON_REFUSED_BY_FILTER:
 				return "bundle has been rejected by filtering directives";
+
+			case REASON_PREEMPTED:
+				return "transfer has been preempted";
 			}
 			return "undefined";
 		}
@@ -41,7 +41,8 @@ namespace dtn
 				REASON_REFUSED = 2,
 				REASON_RETRY_LIMIT_REACHED = 3,
 				REASON_BUNDLE_DELETED = 4,
-				REASON_REFUSED_BY_FILTER = 5
+				REASON_REFUSED_BY_FILTER = 5,
+				REASON_PREEMPTED = 6
 			};
 
 			virtual ~TransferAbortedEvent();
@@ -57,9 +58,10 @@ namespace dtn
 
 			const AbortReason reason;
 
-		private:
 			static const std::string getReason(const AbortReason reason);
 
+		private:
+
 			const dtn::data::EID _peer;
 			const dtn::data::BundleID _bundle;
 			TransferAbortedEvent(const dtn::data::EID &peer, const dtn::data::BundleID &id, const AbortReason reason);
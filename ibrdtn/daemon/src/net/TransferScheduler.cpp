@@ -0,0 +1,349 @@
+/*
+ * TransferScheduler.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "net/TransferScheduler.h"
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+namespace dtn
+{
+	namespace net
+	{
+		const std::string TransferScheduler::TAG = "TransferScheduler";
+
+		TransferScheduler::TransferScheduler(Callback &callback)
+		 : _callback(callback), _limit(0), _inflight(0)
+		{
+		}
+
+		TransferScheduler::~TransferScheduler()
+		{
+		}
+
+		void TransferScheduler::setLimit(const dtn::data::Size &limit)
+		{
+			std::list<BundleTransfer> jobs;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+				_limit = limit;
+				__collect(jobs);
+			}
+
+			__dispatch(jobs);
+		}
+
+		void TransferScheduler::setShare(const dtn::data::EID &peer, unsigned int weight)
+		{
+			ibrcommon::MutexLock l(_lock);
+			_peers[peer.getNode()].weight = (weight == 0) ? 1 : weight;
+		}
+
+		void TransferScheduler::queue(BundleTransfer &job)
+		{
+			std::list<BundleTransfer> jobs;
+			bool scheduled = false;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				if (_limit > 0)
+				{
+					_peers[job.getNeighbor().getNode()].pending.push_back(job);
+					__collect(jobs);
+					scheduled = true;
+				}
+			}
+
+			// dispatch directly if the scheduling is disabled
+			if (!scheduled)
+			{
+				_callback.dispatch(job);
+				return;
+			}
+
+			// the transfer of the caller is dispatched last, because its
+			// errors are passed to the caller
+			std::list<BundleTransfer> own;
+			for (std::list<BundleTransfer>::iterator it = jobs.begin(); it != jobs.end();)
+			{
+				if (((*it).getNeighbor().getNode() == job.getNeighbor().getNode()) && ((*it).getBundle() == job.getBundle()))
+				{
+					own.splice(own.end(), jobs, it++);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			__dispatch(jobs);
+
+			for (std::list<BundleTransfer>::iterator it = own.begin(); it != own.end(); ++it)
+			{
+				try {
+					_callback.dispatch(*it);
+				} catch (...) {
+					// release the share and hand it over to waiting transfers
+					std::list<BundleTransfer> next;
+
+					{
+						ibrcommon::MutexLock l(_lock);
+						__release(*it);
+						__collect(next);
+					}
+
+					__dispatch(next);
+					throw;
+				}
+			}
+		}
+
+		void TransferScheduler::finished(const dtn::data::EID &peer, const dtn::data::BundleID &id)
+		{
+			std::list<BundleTransfer> jobs;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				peer_map::iterator it = _peers.find(peer.getNode());
+				if (it == _peers.end()) return;
+
+				if ((*it).second.inflight.erase(id) > 0) --_inflight;
+
+				__collect(jobs);
+			}
+
+			__dispatch(jobs);
+		}
+
+		bool TransferScheduler::preempt(const dtn::data::EID &peer, const dtn::data::MetaBundle &meta, dtn::data::BundleID &dropped)
+		{
+			// the dropped transfer is aborted when it is destroyed outside of the lock
+			std::list<BundleTransfer> victims;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				peer_map::iterator pit = _peers.find(peer.getNode());
+				if (pit == _peers.end()) return false;
+
+				Peer &p = (*pit).second;
+				const dtn::data::Timestamp r = __remaining(p, dtn::utils::Clock::getMonotonicTimestamp());
+
+				// search for the waiting transfer dispatched last
+				std::list<BundleTransfer>::iterator worst = p.pending.end();
+				for (std::list<BundleTransfer>::iterator it = p.pending.begin(); it != p.pending.end(); ++it)
+				{
+					if ((worst == p.pending.end()) || !__before((*it).getBundle(), r, (*worst).getBundle(), r)) worst = it;
+				}
+
+				if (worst == p.pending.end()) return false;
+				if ((*worst).getBundle().getPriority() >= meta.getPriority()) return false;
+
+				dropped = (*worst).getBundle();
+				(*worst).abort(TransferAbortedEvent::REASON_PREEMPTED);
+
+				victims.splice(victims.end(), p.pending, worst);
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG(TransferScheduler::TAG, 20) << "transfer of " << dropped.toString() << " to " << peer.getString() << " preempted by " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
+
+			return true;
+		}
+
+		void TransferScheduler::up(const dtn::data::EID &peer)
+		{
+			ibrcommon::MutexLock l(_lock);
+			Peer &p = _peers[peer.getNode()];
+			if (p.since == 0) p.since = dtn::utils::Clock::getMonotonicTimestamp();
+		}
+
+		void TransferScheduler::down(const dtn::data::EID &peer)
+		{
+			std::list<BundleTransfer> jobs;
+
+			// waiting transfers are requeued when they are destroyed outside of the lock
+			std::list<BundleTransfer> dropped;
+
+			{
+				ibrcommon::MutexLock l(_lock);
+
+				peer_map::iterator it = _peers.find(peer.getNode());
+				if (it == _peers.end()) return;
+
+				Peer &p = (*it).second;
+
+				if (p.since > 0)
+				{
+					// contacts shorter than a second count as one second
+					dtn::data::Timestamp d = dtn::utils::Clock::getMonotonicTimestamp() - p.since;
+					if (d == 0) d = 1;
+
+					p.duration = (p.duration == 0) ? d : (p.duration + d) / 2;
+					p.since = 0;
+				}
+
+				dropped.swap(p.pending);
+
+				// dispatched transfers are finished by the convergence layer
+				_inflight -= p.inflight.size();
+				p.inflight.clear();
+
+				// the shares of the other neighbors may grow
+				__collect(jobs);
+			}
+
+			__dispatch(jobs);
+		}
+
+		dtn::data::Size TransferScheduler::getPending(const dtn::data::EID &peer) const
+		{
+			ibrcommon::MutexLock l(_lock);
+			peer_map::const_iterator it = _peers.find(peer.getNode());
+			if (it == _peers.end()) return 0;
+			return (*it).second.pending.size();
+		}
+
+		dtn::data::Size TransferScheduler::getInFlight(const dtn::data::EID &peer) const
+		{
+			ibrcommon::MutexLock l(_lock);
+			peer_map::const_iterator it = _peers.find(peer.getNode());
+			if (it == _peers.end()) return 0;
+			return (*it).second.inflight.size();
+		}
+
+		dtn::data::Timestamp TransferScheduler::__remaining(const Peer &p, const dtn::data::Timestamp &now)
+		{
+			if ((p.since == 0) || (p.duration == 0)) return dtn::data::Timestamp::max();
+
+			const dtn::data::Timestamp elapsed = now - p.since;
+			if (elapsed >= p.duration) return 0;
+
+			return p.duration - elapsed;
+		}
+
+		bool TransferScheduler::__before(const dtn::data::MetaBundle &a, const dtn::data::Timestamp &ra,
+				const dtn::data::MetaBundle &b, const dtn::data::Timestamp &rb)
+		{
+			// higher priority first
+			if (a.getPriority() != b.getPriority()) return (a.getPriority() > b.getPriority());
+
+			// serve contacts which are expected to end earlier
+			if (ra != rb) return (ra < rb);
+
+			// bundles which expire earlier first
+			return (a.expiretime < b.expiretime);
+		}
+
+		dtn::data::Size TransferScheduler::__share(const Peer &p) const
+		{
+			dtn::data::Size weights = 0;
+
+			for (peer_map::const_iterator it = _peers.begin(); it != _peers.end(); ++it)
+			{
+				const Peer &other = (*it).second;
+				if ((&other == &p) || !other.pending.empty() || !other.inflight.empty()) weights += other.weight;
+			}
+
+			const dtn::data::Size share = (_limit * p.weight) / weights;
+			return (share == 0) ? 1 : share;
+		}
+
+		bool TransferScheduler::__admit(const Peer &p) const
+		{
+			if (_limit == 0) return true;
+			if (p.inflight.size() >= __share(p)) return false;
+
+			// every neighbor may have one transfer in flight
+			return (_inflight < _limit) || p.inflight.empty();
+		}
+
+		void TransferScheduler::__collect(std::list<BundleTransfer> &jobs)
+		{
+			const dtn::data::Timestamp now = dtn::utils::Clock::getMonotonicTimestamp();
+
+			while (true)
+			{
+				peer_map::iterator best_peer = _peers.end();
+				std::list<BundleTransfer>::iterator best;
+				dtn::data::Timestamp best_remaining = 0;
+
+				for (peer_map::iterator pit = _peers.begin(); pit != _peers.end(); ++pit)
+				{
+					Peer &p = (*pit).second;
+					if (p.pending.empty() || !__admit(p)) continue;
+
+					const dtn::data::Timestamp r = __remaining(p, now);
+
+					for (std::list<BundleTransfer>::iterator it = p.pending.begin(); it != p.pending.end(); ++it)
+					{
+						if ((best_peer == _peers.end()) || __before((*it).getBundle(), r, (*best).getBundle(), best_remaining))
+						{
+							best_peer = pit;
+							best = it;
+							best_remaining = r;
+						}
+					}
+				}
+
+				if (best_peer == _peers.end()) return;
+
+				Peer &p = (*best_peer).second;
+				if (p.inflight.insert((*best).getBundle()).second) ++_inflight;
+
+				jobs.splice(jobs.end(), p.pending, best);
+			}
+		}
+
+		void TransferScheduler::__dispatch(std::list<BundleTransfer> &jobs)
+		{
+			for (std::list<BundleTransfer>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+			{
+				BundleTransfer &job = (*it);
+
+				try {
+					_callback.dispatch(job);
+				} catch (const std::exception &ex) {
+					IBRCOMMON_LOGGER_DEBUG_TAG(TransferScheduler::TAG, 10) << "dispatch of " << job.getBundle().toString() << " failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+					// release the share, the transfer is requeued by the routing
+					ibrcommon::MutexLock l(_lock);
+					__release(job);
+				}
+			}
+		}
+
+		void TransferScheduler::__release(const BundleTransfer &job)
+		{
+			peer_map::iterator pit = _peers.find(job.getNeighbor().getNode());
+			if ((pit != _peers.end()) && ((*pit).second.inflight.erase(job.getBundle()) > 0)) --_inflight;
+		}
+
+		TransferScheduler::Peer::Peer()
+		 : weight(1), since(0), duration(0)
+		{
+		}
+
+		TransferScheduler::Peer::~Peer()
+		{
+		}
+	} /* namespace net */
+} /* namespace dtn */
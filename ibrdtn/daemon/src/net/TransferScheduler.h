@@ -0,0 +1,194 @@
+/*
+ * TransferScheduler.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef TRANSFERSCHEDULER_H_
+#define TRANSFERSCHEDULER_H_
+
+#include "net/BundleTransfer.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/BundleID.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrdtn/data/Number.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <string>
+#include <list>
+#include <map>
+#include <set>
+
+namespace dtn
+{
+	namespace net
+	{
+		/**
+		 * Orders the pending transfers of all neighbors. The number of
+		 * bundles handed to the convergence layers at once is limited and
+		 * the limit is shared by all neighbors with pending transfers
+		 * according to their weight. The shares count bundles and not
+		 * bytes, the size of the bundles is not taken into account.
+		 * Waiting transfers are dispatched by priority, the expected
+		 * remaining duration of the contact and the expiration of the
+		 * bundle. Without a limit every transfer is dispatched
+		 * immediately.
+		 */
+		class TransferScheduler
+		{
+		public:
+			static const std::string TAG;
+
+			class Callback
+			{
+			public:
+				virtual ~Callback() { };
+
+				/**
+				 * Hand-over a transfer to the convergence layer
+				 */
+				virtual void dispatch(BundleTransfer &job) = 0;
+			};
+
+			TransferScheduler(Callback &callback);
+			virtual ~TransferScheduler();
+
+			/**
+			 * Set the number of bundles in flight over all neighbors.
+			 * Zero disables the scheduling.
+			 */
+			void setLimit(const dtn::data::Size &limit);
+
+			/**
+			 * Set the weight of a neighbor while the limit is shared,
+			 * the default weight is one.
+			 */
+			void setShare(const dtn::data::EID &peer, unsigned int weight);
+
+			/**
+			 * Queue a transfer. If the neighbor has a free share the
+			 * transfer is dispatched immediately and errors of the
+			 * convergence layer are passed to the caller.
+			 */
+			void queue(BundleTransfer &job);
+
+			/**
+			 * Release the share of a dispatched transfer which has been
+			 * completed, aborted or requeued and dispatch waiting transfers.
+			 */
+			void finished(const dtn::data::EID &peer, const dtn::data::BundleID &id);
+
+			/**
+			 * Drop the waiting transfer with the lowest value for the given
+			 * neighbor, if its priority is lower than the one of the given
+			 * bundle. The dropped transfer is aborted as preempted.
+			 * @return True, if a transfer has been dropped.
+			 */
+			bool preempt(const dtn::data::EID &peer, const dtn::data::MetaBundle &meta, dtn::data::BundleID &dropped);
+
+			/**
+			 * A contact to the neighbor has been established
+			 */
+			void up(const dtn::data::EID &peer);
+
+			/**
+			 * The contact to the neighbor has been lost, all waiting
+			 * transfers are dropped and requeued by the routing.
+			 */
+			void down(const dtn::data::EID &peer);
+
+			/**
+			 * Returns the number of transfers waiting for the neighbor
+			 */
+			dtn::data::Size getPending(const dtn::data::EID &peer) const;
+
+			/**
+			 * Returns the number of dispatched transfers of the neighbor
+			 */
+			dtn::data::Size getInFlight(const dtn::data::EID &peer) const;
+
+		private:
+			class Peer
+			{
+			public:
+				Peer();
+				~Peer();
+
+				std::list<BundleTransfer> pending;
+				std::set<dtn::data::BundleID> inflight;
+				unsigned int weight;
+
+				// start of the current contact, zero without contact
+				dtn::data::Timestamp since;
+
+				// smoothed duration of the past contacts, zero if unknown
+				dtn::data::Timestamp duration;
+			};
+
+			typedef std::map<dtn::data::EID, Peer> peer_map;
+
+			/**
+			 * Returns the expected remaining duration of the contact
+			 * or the maximum value if unknown
+			 */
+			static dtn::data::Timestamp __remaining(const Peer &p, const dtn::data::Timestamp &now);
+
+			/**
+			 * Returns true, if the transfer a has to be dispatched before b
+			 */
+			static bool __before(const dtn::data::MetaBundle &a, const dtn::data::Timestamp &ra,
+					const dtn::data::MetaBundle &b, const dtn::data::Timestamp &rb);
+
+			/**
+			 * Returns the number of transfers the neighbor may have in flight,
+			 * the lock has to be held
+			 */
+			dtn::data::Size __share(const Peer &p) const;
+
+			/**
+			 * Returns true, if another transfer of the neighbor may be
+			 * dispatched, the lock has to be held
+			 */
+			bool __admit(const Peer &p) const;
+
+			/**
+			 * Move the best waiting transfers into the list as long as
+			 * the limit allows, the lock has to be held
+			 */
+			void __collect(std::list<BundleTransfer> &jobs);
+
+			/**
+			 * Dispatch the collected transfers without holding the lock,
+			 * errors of the convergence layer are logged and the share of
+			 * the failed transfer is released
+			 */
+			void __dispatch(std::list<BundleTransfer> &jobs);
+
+			/**
+			 * Release the share of a dispatched transfer, the lock has
+			 * to be held
+			 */
+			void __release(const BundleTransfer &job);
+
+			Callback &_callback;
+
+			mutable ibrcommon::Mutex _lock;
+			peer_map _peers;
+			dtn::data::Size _limit;
+			dtn::data::Size _inflight;
+		};
+	} /* namespace net */
+} /* namespace dtn */
+#endif /* TRANSFERSCHEDULER_H_ */
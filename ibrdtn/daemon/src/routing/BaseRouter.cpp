@@ -49,7 +49,7 @@ namespace dtn
 		 * implementation of the BaseRouter class
 		 */
 		BaseRouter::BaseRouter()
-		 : _known_bundles("router-known-bundles"), _purged_bundles("router-purged-bundles"), _extension_state(false), _next_expiration(0)
+		 : _known_bundles("router-known-bundles"), _purged_bundles("router-purged-bundles"), _extension_state(false)
 		{
 			// make the router globally available
 			dtn::core::BundleCore::getInstance().setRouter(this);
@@ -57,6 +57,8 @@ namespace dtn
 
 		BaseRouter::~BaseRouter()
 		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
+
 			// unregister this router from the core
 			dtn::core::BundleCore::getInstance().setRouter(NULL);
 
@@ -214,9 +216,11 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::routing::QueueBundleEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::NodeEvent>::add(this);
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::add(this);
+
+			// do the first expiration as soon as possible
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, dtn::utils::Clock::getTime());
 		}
 
 		void BaseRouter::componentDown() throw ()
@@ -226,9 +230,10 @@ namespace dtn
 			dtn::core::EventDispatcher<dtn::net::TransferCompletedEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::routing::QueueBundleEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::core::NodeEvent>::remove(this);
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::net::ConnectionEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::core::BundlePurgeEvent>::remove(this);
+
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
 		/**
@@ -377,51 +382,47 @@ namespace dtn
 			}
 		}
 
-		void BaseRouter::raiseEvent(const dtn::core::TimeEvent &event) throw ()
+		void BaseRouter::eventDeadline(const dtn::data::Timestamp &now) throw ()
 		{
-			dtn::data::Timestamp expire_time = event.getTimestamp();
+			// do the next expiration in 60 seconds
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, now + 60);
 
-			// do the expiration only every 60 seconds
-			if (expire_time > _next_expiration) {
-				// store the next expiration time
-				_next_expiration = expire_time + 60;
+			// expire all bundles and neighbors one minute late
+			dtn::data::Timestamp expire_time = now;
+			if (expire_time <= 60) expire_time = 0;
+			else expire_time -= 60;
 
-				// expire all bundles and neighbors one minute late
-				if (expire_time <= 60) expire_time = 0;
-				else expire_time -= 60;
-
-				{
-					ibrcommon::MutexLock l(_known_bundles_lock);
-					_known_bundles.expire(expire_time);
-
-					// sync known bundles to disk
-					_known_bundles.sync();
-				}
+			{
+				ibrcommon::MutexLock l(_known_bundles_lock);
+				_known_bundles.expire(expire_time);
 
-				{
-					ibrcommon::MutexLock l(_purged_bundles_lock);
-					_purged_bundles.expire(expire_time);
+				// sync known bundles to disk
+				_known_bundles.sync();
+			}
 
-					// sync purged bundles to disk
-					_purged_bundles.sync();
-				}
+			{
+				ibrcommon::MutexLock l(_purged_bundles_lock);
+				_purged_bundles.expire(expire_time);
 
-				{
-					ibrcommon::MutexLock l(_neighbor_database);
+				// sync purged bundles to disk
+				_purged_bundles.sync();
+			}
 
-					// get all active neighbors
-					const std::set<dtn::core::Node> neighbors = dtn::core::BundleCore::getInstance().getConnectionManager().getNeighbors();
+			{
+				ibrcommon::MutexLock l(_neighbor_database);
 
-					// touch all active neighbors
-					for (std::set<dtn::core::Node>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it) {
-						try {
-							_neighbor_database.get( (*it).getEID() );
-						} catch (const NeighborDatabase::EntryNotFoundException&) { };
-					}
+				// get all active neighbors
+				const std::set<dtn::core::Node> neighbors = dtn::core::BundleCore::getInstance().getConnectionManager().getNeighbors();
 
-					// check all neighbor entries for expiration
-					_neighbor_database.expire(event.getTimestamp());
+				// touch all active neighbors
+				for (std::set<dtn::core::Node>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it) {
+					try {
+						_neighbor_database.get( (*it).getEID() );
+					} catch (const NeighborDatabase::EntryNotFoundException&) { };
 				}
+
+				// check all neighbor entries for expiration
+				_neighbor_database.expire(now);
 			}
 		}
 
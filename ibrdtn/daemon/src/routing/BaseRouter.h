@@ -46,7 +46,7 @@
 #include "net/TransferCompletedEvent.h"
 #include "routing/QueueBundleEvent.h"
 #include "core/NodeEvent.h"
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 #include "net/ConnectionEvent.h"
 #include "core/BundlePurgeEvent.h"
 
@@ -62,9 +62,9 @@ namespace dtn
 			public dtn::core::EventReceiver<dtn::net::TransferCompletedEvent>,
 			public dtn::core::EventReceiver<dtn::routing::QueueBundleEvent>,
 			public dtn::core::EventReceiver<dtn::core::NodeEvent>,
-			public dtn::core::EventReceiver<dtn::core::TimeEvent>,
 			public dtn::core::EventReceiver<dtn::net::ConnectionEvent>,
-			public dtn::core::EventReceiver<dtn::core::BundlePurgeEvent>
+			public dtn::core::EventReceiver<dtn::core::BundlePurgeEvent>,
+			public dtn::core::DeadlineScheduler::Listener
 		{
 			static const std::string TAG;
 
@@ -138,10 +138,15 @@ namespace dtn
 			void raiseEvent(const dtn::net::TransferCompletedEvent &evt) throw ();
 			void raiseEvent(const dtn::routing::QueueBundleEvent &evt) throw ();
 			void raiseEvent(const dtn::core::NodeEvent &evt) throw ();
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
 			void raiseEvent(const dtn::net::ConnectionEvent &evt) throw ();
 			void raiseEvent(const dtn::core::BundlePurgeEvent &evt) throw ();
 
+			/**
+			 * Expire known bundles and neighbors periodically
+			 * @see DeadlineScheduler::Listener::eventDeadline()
+			 */
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
+
 			/**
 			 * provides direct access to the bundle storage
 			 */
@@ -277,8 +282,6 @@ namespace dtn
 			NeighborDatabase _neighbor_database;
 			NodeHandshakeExtension _nh_extension;
 			RetransmissionExtension _retransmission_extension;
-
-			dtn::data::Timestamp _next_expiration;
 		};
 	}
 }
@@ -0,0 +1,164 @@
+/*
+ * HandshakeDeltaTable.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "routing/HandshakeDeltaTable.h"
+#include <ibrcommon/thread/MutexLock.h>
+
+namespace dtn
+{
+	namespace routing
+	{
+		HandshakeDeltaTable::Vector::Vector()
+		 : version(0)
+		{
+		}
+
+		HandshakeDeltaTable::PeerState::PeerState()
+		 : used(0)
+		{
+		}
+
+		HandshakeDeltaTable::HandshakeDeltaTable(size_t limit)
+		 : _limit(limit), _sequence(0), _version(0)
+		{
+		}
+
+		HandshakeDeltaTable::~HandshakeDeltaTable()
+		{
+		}
+
+		void HandshakeDeltaTable::request(const dtn::data::EID &peer, NodeHandshake &request)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			const bool summary = request.hasRequest(BloomFilterSummaryVector::identifier);
+			const bool purge = request.hasRequest(BloomFilterPurgeVector::identifier);
+
+			if (!summary && !purge) return;
+
+			PeerState &state = get(peer);
+			DeltaVersionSet *versions = new DeltaVersionSet();
+
+			if (summary)
+			{
+				request.addRequest(SummaryVectorDelta::identifier);
+				versions->set(SummaryVectorDelta::identifier, state.received[SummaryVectorDelta::identifier].version);
+			}
+
+			if (purge)
+			{
+				request.addRequest(PurgeVectorDelta::identifier);
+				versions->set(PurgeVectorDelta::identifier, state.received[PurgeVectorDelta::identifier].version);
+			}
+
+			request.addItem(versions);
+		}
+
+		void HandshakeDeltaTable::response(const dtn::data::EID &peer, const NodeHandshake &request, const ibrcommon::BloomFilter &filter, BloomFilterDelta &item)
+		{
+			const dtn::data::Number &id = item.getIdentifier();
+
+			// get the version known by the peer
+			dtn::data::Number known = 0;
+			try {
+				known = request.get<DeltaVersionSet>().get(id);
+			} catch (const std::exception&) { };
+
+			ibrcommon::MutexLock l(_lock);
+
+			Vector &sent = get(peer).sent[id];
+			const dtn::data::Number version = ++_version;
+
+			if ((known != 0) && (known == sent.version))
+			{
+				item.assign(known, sent.table, version, filter);
+			}
+			else
+			{
+				item.assign(version, filter);
+			}
+
+			// remember the sent state as base for the next delta
+			sent.version = version;
+			sent.table.assign((const char*)filter.table(), filter.size());
+		}
+
+		bool HandshakeDeltaTable::process(const dtn::data::EID &peer, const BloomFilterDelta &item, ibrcommon::BloomFilter &filter)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			Vector &received = get(peer).received[item.getIdentifier()];
+
+			if (!item.isFull())
+			{
+				// the delta has to be based on the known version
+				if ((received.version == 0) || (item.getBase() != received.version))
+				{
+					// request the full vector next time
+					received.version = 0;
+					return false;
+				}
+
+				filter.load((const ibrcommon::cell_type*)received.table.c_str(), received.table.size());
+			}
+
+			if (!item.apply(filter))
+			{
+				received.version = 0;
+				return false;
+			}
+
+			received.version = item.getVersion();
+			received.table.assign((const char*)filter.table(), filter.size());
+			return true;
+		}
+
+		size_t HandshakeDeltaTable::size()
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _peers.size();
+		}
+
+		HandshakeDeltaTable::PeerState& HandshakeDeltaTable::get(const dtn::data::EID &peer)
+		{
+			const dtn::data::EID node = peer.getNode();
+
+			peer_map::iterator it = _peers.find(node);
+
+			if (it == _peers.end())
+			{
+				// drop the least recently used peer
+				if (!_peers.empty() && (_peers.size() >= _limit))
+				{
+					peer_map::iterator lru = _peers.begin();
+					for (peer_map::iterator i = _peers.begin(); i != _peers.end(); ++i)
+					{
+						if ((*i).second.used < (*lru).second.used) lru = i;
+					}
+					_peers.erase(lru);
+				}
+
+				it = _peers.insert(std::make_pair(node, PeerState())).first;
+			}
+
+			(*it).second.used = ++_sequence;
+			return (*it).second;
+		}
+	} /* namespace routing */
+} /* namespace dtn */
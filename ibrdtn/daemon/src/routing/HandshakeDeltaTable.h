@@ -0,0 +1,111 @@
+/*
+ * HandshakeDeltaTable.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef HANDSHAKEDELTATABLE_H_
+#define HANDSHAKEDELTATABLE_H_
+
+#include "routing/NodeHandshake.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrcommon/data/BloomFilter.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <map>
+#include <string>
+
+namespace dtn
+{
+	namespace routing
+	{
+		/**
+		 * Keeps the state of the Bloom-filter vectors exchanged with each
+		 * peer to transfer only the changes since the last exchange.
+		 *
+		 * Each side remembers the last version sent to and received from
+		 * a peer. A request carries the versions known by the requester
+		 * and the responder sends a delta only if it sent exactly this
+		 * version before. In any other case the full vector is sent.
+		 */
+		class HandshakeDeltaTable
+		{
+		public:
+			/**
+			 * @param limit Maximum number of peers to keep the state for
+			 */
+			HandshakeDeltaTable(size_t limit = 64);
+			virtual ~HandshakeDeltaTable();
+
+			/**
+			 * Add delta requests for all requested summary and purge
+			 * vectors and the versions known for the peer.
+			 */
+			void request(const dtn::data::EID &peer, NodeHandshake &request);
+
+			/**
+			 * Assign the filter to the delta item sent to the peer.
+			 */
+			void response(const dtn::data::EID &peer, const NodeHandshake &request, const ibrcommon::BloomFilter &filter, BloomFilterDelta &item);
+
+			/**
+			 * Reconstruct the filter of the peer from a received delta item.
+			 * @return False, if the delta does not fit to the known version.
+			 */
+			bool process(const dtn::data::EID &peer, const BloomFilterDelta &item, ibrcommon::BloomFilter &filter);
+
+			/**
+			 * Returns the number of peers with a known state
+			 */
+			size_t size();
+
+		private:
+			class Vector
+			{
+			public:
+				Vector();
+
+				dtn::data::Number version;
+				std::string table;
+			};
+
+			class PeerState
+			{
+			public:
+				PeerState();
+
+				// the vectors sent to this peer
+				std::map<dtn::data::Number, Vector> sent;
+
+				// the vectors received from this peer
+				std::map<dtn::data::Number, Vector> received;
+
+				// sequence number of the last use
+				size_t used;
+			};
+
+			typedef std::map<dtn::data::EID, PeerState> peer_map;
+
+			PeerState& get(const dtn::data::EID &peer);
+
+			ibrcommon::Mutex _lock;
+			peer_map _peers;
+			const size_t _limit;
+			size_t _sequence;
+			size_t _version;
+		};
+	} /* namespace routing */
+} /* namespace dtn */
+#endif /* HANDSHAKEDELTATABLE_H_ */
@@ -206,11 +206,13 @@ namespace dtn
 
 		NeighborDatabase::NeighborEntry& NeighborDatabase::create(const dtn::data::EID &eid) throw ()
 		{
-			neighbor_map::iterator iter = _entries.find(eid);
+			const dtn::data::EIDHandle handle(eid);
+
+			neighbor_map::iterator iter = _entries.find(handle);
 			if (iter == _entries.end())
 			{
 				NeighborEntry *entry = new NeighborEntry(eid);
-				pair<neighbor_map::iterator,bool> itm = _entries.insert( pair<dtn::data::EID, NeighborDatabase::NeighborEntry*>(eid, entry) );
+				pair<neighbor_map::iterator,bool> itm = _entries.insert( pair<dtn::data::EIDHandle, NeighborDatabase::NeighborEntry*>(handle, entry) );
 				iter = itm.first;
 			}
 
@@ -225,7 +227,11 @@ namespace dtn
 			if (noCached && !dtn::core::BundleCore::getInstance().getConnectionManager().isNeighbor(eid))
 				throw NeighborDatabase::EntryNotFoundException();
 
-			neighbor_map::iterator iter = _entries.find(eid);
+			// EIDs never interned are not in the database
+			dtn::data::EIDHandle handle;
+			if (!dtn::data::EIDHandle::lookup(eid, handle)) throw EntryNotFoundException();
+
+			neighbor_map::iterator iter = _entries.find(handle);
 			if (iter == _entries.end())
 			{
 				throw EntryNotFoundException();
@@ -239,8 +245,11 @@ namespace dtn
 
 		void NeighborDatabase::remove(const dtn::data::EID &eid)
 		{
-			neighbor_map::iterator iter = _entries.find(eid);
-			if (iter == _entries.end())
+			dtn::data::EIDHandle handle;
+			if (!dtn::data::EIDHandle::lookup(eid, handle)) return;
+
+			neighbor_map::iterator iter = _entries.find(handle);
+			if (iter != _entries.end())
 			{
 				delete (*iter).second;
 				_entries.erase(iter);
@@ -25,6 +25,7 @@
 #include "routing/NeighborDataset.h"
 #include <ibrdtn/data/BundleSet.h>
 #include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/EIDTable.h>
 #include <ibrdtn/data/BundleID.h>
 #include <ibrdtn/data/Number.h>
 #include <ibrcommon/data/BloomFilter.h>
@@ -261,7 +262,7 @@ namespace dtn
 			void expire(const dtn::data::Timestamp &timestamp);
 
 		private:
-			typedef std::map<dtn::data::EID, NeighborDatabase::NeighborEntry* > neighbor_map;
+			typedef std::map<dtn::data::EIDHandle, NeighborDatabase::NeighborEntry* > neighbor_map;
 			neighbor_map _entries;
 		};
 	}
@@ -20,6 +20,7 @@
  */
 
 #include "routing/NodeHandshake.h"
+#include <ibrdtn/data/Exceptions.h>
 
 namespace dtn
 {
@@ -46,6 +47,7 @@ namespace dtn
 			{
 				delete (*iter);
 			}
+			_items.clear();
 
 			// clear raw items too
 			_raw_items.clear();
@@ -143,6 +145,17 @@ namespace dtn
 					const dtn::data::Number &item = (*iter);
 					ss << " " << item.toString();
 				}
+
+				if (!_items.empty())
+				{
+					ss << " ;";
+
+					for (item_set::const_iterator iter = _items.begin(); iter != _items.end(); ++iter)
+					{
+						const NodeHandshakeItem &item (**iter);
+						ss << " " << item.getIdentifier().toString();
+					}
+				}
 			}
 			else if (getType() == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
@@ -160,6 +173,28 @@ namespace dtn
 			return ss.str();
 		}
 
+		void NodeHandshake::serialize_items(std::ostream &stream, const item_set &items)
+		{
+			// the number of items
+			dtn::data::Number number_of_items(items.size());
+			stream << number_of_items;
+
+			for (NodeHandshake::item_set::const_iterator iter = items.begin(); iter != items.end(); ++iter)
+			{
+				const NodeHandshakeItem &item = (**iter);
+
+				// first the identifier of the item
+				dtn::data::Number id(item.getIdentifier());
+				stream << id;
+
+				// then the length of the payload
+				dtn::data::Number len(item.getLength());
+				stream << len;
+
+				item.serialize(stream);
+			}
+		}
+
 		std::ostream& operator<<(std::ostream &stream, const NodeHandshake &hs)
 		{
 			// first the type as SDNV
@@ -176,33 +211,43 @@ namespace dtn
 					dtn::data::Number req(*iter);
 					stream << req;
 				}
+
+				// optional items of the request, ignored by older implementations
+				if (!hs._items.empty()) NodeHandshake::serialize_items(stream, hs._items);
 			}
 			else if (hs.getType() == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
 				// then the lifetime of this data
 				stream << hs._lifetime;
 
-				// then the number of request items
-				dtn::data::Number number_of_items(hs._items.size());
-				stream << number_of_items;
+				NodeHandshake::serialize_items(stream, hs._items);
+			}
 
-				for (NodeHandshake::item_set::const_iterator iter = hs._items.begin(); iter != hs._items.end(); ++iter)
-				{
-					const NodeHandshakeItem &item = (**iter);
+			return stream;
+		}
 
-					// first the identifier of the item
-					dtn::data::Number id(item.getIdentifier());
-					stream << id;
+		void NodeHandshake::deserialize_items(std::istream &stream, NodeHandshake &hs)
+		{
+			// the number of items
+			dtn::data::Number number_of_items;
+			stream >> number_of_items;
 
-					// then the length of the payload
-					dtn::data::Number len(item.getLength());
-					stream << len;
+			for (size_t i = 0; number_of_items > i; ++i)
+			{
+				// first the identifier of the item
+				dtn::data::Number id;
+				stream >> id;
 
-					item.serialize(stream);
-				}
-			}
+				// then the length of the payload
+				dtn::data::Number len;
+				stream >> len;
 
-			return stream;
+				// add to raw map and create data container
+				std::stringstream &data = hs._raw_items.get(id);
+
+				// copy data to stringstream
+				ibrcommon::BLOB::copy(data, stream, len.get<std::streamsize>());
+			}
 		}
 
 		std::istream& operator>>(std::istream &stream, NodeHandshake &hs)
@@ -225,33 +270,19 @@ namespace dtn
 					stream >> req;
 					hs._requests.insert(req);
 				}
+
+				// read optional items of the request
+				if (stream.good() && (stream.peek() != std::char_traits<char>::eof()))
+				{
+					NodeHandshake::deserialize_items(stream, hs);
+				}
 			}
 			else if (hs.getType() == NodeHandshake::HANDSHAKE_RESPONSE)
 			{
 				// then the lifetime of this data
 				stream >> hs._lifetime;
 
-				// then the number of request items
-				dtn::data::Number number_of_items;
-				stream >> number_of_items;
-
-				for (size_t i = 0; number_of_items > i; ++i)
-				{
-					// first the identifier of the item
-					dtn::data::Number id;
-					stream >> id;
-
-					// then the length of the payload
-					dtn::data::Number len;
-					stream >> len;
-
-					// add to raw map and create data container
-					//std::stringstream *data = new std::stringstream();
-					std::stringstream &data = hs._raw_items.get(id);
-
-					// copy data to stringstream
-					ibrcommon::BLOB::copy(data, stream, len.get<std::streamsize>());
-				}
+				NodeHandshake::deserialize_items(stream, hs);
 			}
 
 			return stream;
@@ -390,5 +421,315 @@ namespace dtn
 
 		const dtn::data::Number BloomFilterPurgeVector::identifier = NodeHandshakeItem::BLOOM_FILTER_PURGE_VECTOR;
 
+		BloomFilterDelta::BloomFilterDelta()
+		 : _base(0), _version(0), _size(0)
+		{
+		}
+
+		BloomFilterDelta::~BloomFilterDelta()
+		{
+		}
+
+		void BloomFilterDelta::assign(const dtn::data::Number &version, const ibrcommon::BloomFilter &filter)
+		{
+			_base = 0;
+			_version = version;
+			_size = filter.size();
+			_table.assign((const char*)filter.table(), filter.size());
+			_changes.clear();
+		}
+
+		void BloomFilterDelta::assign(const dtn::data::Number &base, const std::string &previous, const dtn::data::Number &version, const ibrcommon::BloomFilter &filter)
+		{
+			// a delta requires tables of the same size
+			if (base == 0 || previous.size() != filter.size())
+			{
+				assign(version, filter);
+				return;
+			}
+
+			const ibrcommon::cell_type *table = filter.table();
+			change_list changes;
+			dtn::data::Length length = 0;
+			size_t last = 0;
+
+			for (size_t i = 0; i < previous.size(); ++i)
+			{
+				const unsigned char diff = (unsigned char)previous[i] ^ table[i];
+				if (diff == 0) continue;
+
+				changes.push_back(std::make_pair(i, diff));
+				length += dtn::data::Number(i - last).getLength() + 1;
+				last = i + 1;
+
+				// stop if the delta gets larger than the full table
+				if (length >= filter.size())
+				{
+					assign(version, filter);
+					return;
+				}
+			}
+
+			_base = base;
+			_version = version;
+			_size = filter.size();
+			_table.clear();
+			_changes.swap(changes);
+		}
+
+		const dtn::data::Number& BloomFilterDelta::getBase() const
+		{
+			return _base;
+		}
+
+		const dtn::data::Number& BloomFilterDelta::getVersion() const
+		{
+			return _version;
+		}
+
+		bool BloomFilterDelta::isFull() const
+		{
+			return (_base == 0);
+		}
+
+		bool BloomFilterDelta::apply(ibrcommon::BloomFilter &filter) const
+		{
+			if (isFull())
+			{
+				filter.load((const ibrcommon::cell_type*)_table.c_str(), _table.size());
+				return true;
+			}
+
+			if (_size != filter.size()) return false;
+
+			std::vector<ibrcommon::cell_type> table(filter.table(), filter.table() + filter.size());
+
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				table[(*it).first] ^= (*it).second;
+			}
+
+			if (!table.empty()) filter.load(&table[0], table.size());
+			return true;
+		}
+
+		dtn::data::Length BloomFilterDelta::getLength() const
+		{
+			dtn::data::Length len = _base.getLength() + _version.getLength() + _size.getLength();
+
+			if (isFull())
+			{
+				return len + _table.size();
+			}
+
+			len += dtn::data::Number(_changes.size()).getLength();
+
+			size_t last = 0;
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				len += dtn::data::Number((*it).first - last).getLength() + 1;
+				last = (*it).first + 1;
+			}
+
+			return len;
+		}
+
+		std::ostream& BloomFilterDelta::serialize(std::ostream &stream) const
+		{
+			stream << _base << _version << _size;
+
+			if (isFull())
+			{
+				stream.write(_table.c_str(), _table.size());
+				return stream;
+			}
+
+			stream << dtn::data::Number(_changes.size());
+
+			// positions are encoded as gap to the previous change
+			size_t last = 0;
+			for (change_list::const_iterator it = _changes.begin(); it != _changes.end(); ++it)
+			{
+				stream << dtn::data::Number((*it).first - last);
+				stream.put((char)(*it).second);
+				last = (*it).first + 1;
+			}
+
+			return stream;
+		}
+
+		std::istream& BloomFilterDelta::deserialize(std::istream &stream)
+		{
+			stream >> _base >> _version >> _size;
+
+			const size_t size = _size.get<size_t>();
+			_table.clear();
+			_changes.clear();
+
+			if (isFull())
+			{
+				std::vector<char> buffer(size);
+				if (size > 0) stream.read(&buffer[0], size);
+				if (stream.gcount() != (std::streamsize)size)
+					throw dtn::InvalidDataException("bloom filter delta truncated");
+				_table.assign(buffer.begin(), buffer.end());
+				return stream;
+			}
+
+			dtn::data::Number count;
+			stream >> count;
+
+			size_t pos = 0;
+			for (size_t i = 0; count > i; ++i)
+			{
+				dtn::data::Number gap;
+				stream >> gap;
+				pos += gap.get<size_t>();
+
+				const int diff = stream.get();
+				if (!stream.good() || pos >= size)
+					throw dtn::InvalidDataException("bloom filter delta malformed");
+
+				_changes.push_back(std::make_pair(pos, (unsigned char)diff));
+				++pos;
+			}
+
+			return stream;
+		}
+
+		SummaryVectorDelta::SummaryVectorDelta()
+		{
+		}
+
+		SummaryVectorDelta::~SummaryVectorDelta()
+		{
+		}
+
+		const dtn::data::Number& SummaryVectorDelta::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		const dtn::data::Number SummaryVectorDelta::identifier = NodeHandshakeItem::SUMMARY_VECTOR_DELTA;
+
+		PurgeVectorDelta::PurgeVectorDelta()
+		{
+		}
+
+		PurgeVectorDelta::~PurgeVectorDelta()
+		{
+		}
+
+		const dtn::data::Number& PurgeVectorDelta::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		const dtn::data::Number PurgeVectorDelta::identifier = NodeHandshakeItem::PURGE_VECTOR_DELTA;
+
+		DeltaVersionSet::DeltaVersionSet()
+		{
+		}
+
+		DeltaVersionSet::~DeltaVersionSet()
+		{
+		}
+
+		const dtn::data::Number& DeltaVersionSet::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		void DeltaVersionSet::set(const dtn::data::Number &item, const dtn::data::Number &version)
+		{
+			_versions[item] = version;
+		}
+
+		const dtn::data::Number& DeltaVersionSet::get(const dtn::data::Number &item) const
+		{
+			static const dtn::data::Number unknown(0);
+			version_map::const_iterator it = _versions.find(item);
+			if (it == _versions.end()) return unknown;
+			return (*it).second;
+		}
+
+		bool DeltaVersionSet::empty() const
+		{
+			return _versions.empty();
+		}
+
+		dtn::data::Length DeltaVersionSet::getLength() const
+		{
+			dtn::data::Length len = dtn::data::Number(_versions.size()).getLength();
+
+			for (version_map::const_iterator it = _versions.begin(); it != _versions.end(); ++it)
+			{
+				len += (*it).first.getLength() + (*it).second.getLength();
+			}
+
+			return len;
+		}
+
+		std::ostream& DeltaVersionSet::serialize(std::ostream &stream) const
+		{
+			stream << dtn::data::Number(_versions.size());
+
+			for (version_map::const_iterator it = _versions.begin(); it != _versions.end(); ++it)
+			{
+				stream << (*it).first << (*it).second;
+			}
+
+			return stream;
+		}
+
+		std::istream& DeltaVersionSet::deserialize(std::istream &stream)
+		{
+			_versions.clear();
+
+			dtn::data::Number count;
+			stream >> count;
+
+			for (size_t i = 0; count > i; ++i)
+			{
+				dtn::data::Number item, version;
+				stream >> item >> version;
+				_versions[item] = version;
+			}
+
+			return stream;
+		}
+
+		const dtn::data::Number DeltaVersionSet::identifier = NodeHandshakeItem::DELTA_VERSION_SET;
+
+		AggregateRecordSupport::AggregateRecordSupport()
+		{
+		}
+
+		AggregateRecordSupport::~AggregateRecordSupport()
+		{
+		}
+
+		const dtn::data::Number& AggregateRecordSupport::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		dtn::data::Length AggregateRecordSupport::getLength() const
+		{
+			return 0;
+		}
+
+		std::ostream& AggregateRecordSupport::serialize(std::ostream &stream) const
+		{
+			return stream;
+		}
+
+		std::istream& AggregateRecordSupport::deserialize(std::istream &stream)
+		{
+			return stream;
+		}
+
+		const dtn::data::Number AggregateRecordSupport::identifier = NodeHandshakeItem::AGGREGATE_RECORD_SUPPORT;
+
 	} /* namespace routing */
 } /* namespace dtn */
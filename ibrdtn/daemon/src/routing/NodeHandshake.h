@@ -24,11 +24,13 @@
 
 #include <ibrdtn/data/BundleSet.h>
 #include <ibrdtn/data/SDNV.h>
+#include <ibrcommon/data/BloomFilter.h>
 #include <iostream>
 #include <sstream>
 #include <list>
 #include <set>
 #include <map>
+#include <vector>
 
 namespace dtn
 {
@@ -43,7 +45,12 @@ namespace dtn
 				BLOOM_FILTER_SUMMARY_VECTOR = 1,
 				BLOOM_FILTER_PURGE_VECTOR = 2,
 				DELIVERY_PREDICTABILITY_MAP = 3,
-				PROPHET_ACKNOWLEDGEMENT_SET = 4
+				PROPHET_ACKNOWLEDGEMENT_SET = 4,
+				COMPACT_PREDICTABILITY_MAP = 5,
+				DELTA_VERSION_SET = 6,
+				SUMMARY_VECTOR_DELTA = 7,
+				PURGE_VECTOR_DELTA = 8,
+				AGGREGATE_RECORD_SUPPORT = 9
 			};
 
 			virtual ~NodeHandshakeItem() { };
@@ -89,6 +96,121 @@ namespace dtn
 			dtn::data::BundleSet _vector;
 		};
 
+		/**
+		 * Base class for Bloom-filter items transferred as delta to the
+		 * state previously sent to the same peer. The base version
+		 * names the state the delta applies to, a base of zero denotes
+		 * the full filter.
+		 */
+		class BloomFilterDelta : public NodeHandshakeItem
+		{
+		public:
+			BloomFilterDelta();
+			virtual ~BloomFilterDelta();
+			dtn::data::Length getLength() const;
+			std::ostream& serialize(std::ostream&) const;
+			std::istream& deserialize(std::istream&);
+
+			/**
+			 * Assign the full filter
+			 */
+			void assign(const dtn::data::Number &version, const ibrcommon::BloomFilter &filter);
+
+			/**
+			 * Assign the changes of the filter since the base version
+			 * with the given table. Falls back to the full filter if the
+			 * delta is not smaller.
+			 */
+			void assign(const dtn::data::Number &base, const std::string &previous, const dtn::data::Number &version, const ibrcommon::BloomFilter &filter);
+
+			const dtn::data::Number& getBase() const;
+			const dtn::data::Number& getVersion() const;
+			bool isFull() const;
+
+			/**
+			 * Apply this item to the filter. A delta requires a filter
+			 * with the table of the base version.
+			 * @return False, if the delta does not fit to the filter.
+			 */
+			bool apply(ibrcommon::BloomFilter &filter) const;
+
+		private:
+			typedef std::vector<std::pair<size_t, unsigned char> > change_list;
+
+			dtn::data::Number _base;
+			dtn::data::Number _version;
+			dtn::data::Number _size;
+
+			// the table of a full filter
+			std::string _table;
+
+			// positions and xor values of changed bytes
+			change_list _changes;
+		};
+
+		class SummaryVectorDelta : public BloomFilterDelta
+		{
+		public:
+			SummaryVectorDelta();
+			virtual ~SummaryVectorDelta();
+			const dtn::data::Number& getIdentifier() const;
+			static const dtn::data::Number identifier;
+		};
+
+		class PurgeVectorDelta : public BloomFilterDelta
+		{
+		public:
+			PurgeVectorDelta();
+			virtual ~PurgeVectorDelta();
+			const dtn::data::Number& getIdentifier() const;
+			static const dtn::data::Number identifier;
+		};
+
+		/**
+		 * Request item with the versions of the delta items
+		 * known by the requesting node.
+		 */
+		class DeltaVersionSet : public NodeHandshakeItem
+		{
+		public:
+			DeltaVersionSet();
+			virtual ~DeltaVersionSet();
+			const dtn::data::Number& getIdentifier() const;
+			dtn::data::Length getLength() const;
+			std::ostream& serialize(std::ostream&) const;
+			std::istream& deserialize(std::istream&);
+			static const dtn::data::Number identifier;
+
+			void set(const dtn::data::Number &item, const dtn::data::Number &version);
+
+			/**
+			 * Returns the known version of an item or zero if unknown
+			 */
+			const dtn::data::Number& get(const dtn::data::Number &item) const;
+
+			bool empty() const;
+
+		private:
+			typedef std::map<dtn::data::Number, dtn::data::Number> version_map;
+			version_map _versions;
+		};
+
+		/**
+		 * Response item which announces that the node understands
+		 * aggregate status reports and custody signals.
+		 */
+		class AggregateRecordSupport : public NodeHandshakeItem
+		{
+		public:
+			AggregateRecordSupport();
+			virtual ~AggregateRecordSupport();
+			const dtn::data::Number& getIdentifier() const;
+			dtn::data::Length getLength() const;
+			std::ostream& serialize(std::ostream&) const;
+			std::istream& deserialize(std::istream&);
+			static const dtn::data::Number identifier;
+		};
+
 		class NodeHandshake
 		{
 		public:
@@ -127,6 +249,9 @@ namespace dtn
 			template<class T>
 			T& get();
 
+			template<class T>
+			const T& get() const;
+
 		private:
 			class StreamMap
 			{
@@ -146,13 +271,17 @@ namespace dtn
 			NodeHandshakeItem* getItem(const dtn::data::Number &identifier) const;
 			void clear();
 
+			static void serialize_items(std::ostream &stream, const item_set &items);
+			static void deserialize_items(std::istream &stream, NodeHandshake &hs);
+
 			dtn::data::Number _type;
 			dtn::data::Number _lifetime;
 
 			request_set _requests;
-			item_set _items;
 
-			StreamMap _raw_items;
+			// items are deserialized on demand
+			mutable item_set _items;
+			mutable StreamMap _raw_items;
 
 			// deny copying
 			NodeHandshake& operator=( const NodeHandshake& ) { return *this; };
@@ -183,6 +312,13 @@ namespace dtn
 
 			return dynamic_cast<T&>(*item);
 		}
+
+		template<class T>
+		const T& NodeHandshake::get() const
+		{
+			// only mutable members are modified on demand
+			return const_cast<NodeHandshake&>(*this).get<T>();
+		}
 	} /* namespace routing */
 } /* namespace dtn */
 #endif /* NODEHANDSHAKE_H_ */
@@ -54,20 +54,33 @@ namespace dtn
 		void NodeHandshakeExtension::requestHandshake(const dtn::data::EID&, NodeHandshake &request) const
 		{
 			request.addRequest(BloomFilterPurgeVector::identifier);
+
+			// ask whether the peer understands aggregate records
+			request.addRequest(AggregateRecordSupport::identifier);
 		}
 
-		void NodeHandshakeExtension::responseHandshake(const dtn::data::EID&, const NodeHandshake &request, NodeHandshake &answer)
+		void NodeHandshakeExtension::responseHandshake(const dtn::data::EID &source, const NodeHandshake &request, NodeHandshake &answer)
 		{
 			if (request.hasRequest(BloomFilterSummaryVector::identifier))
 			{
 				// add own summary vector to the message
 				const dtn::data::BundleSet vec = (**this).getKnownBundles();
 
-				// create an item
-				BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
+				if (request.hasRequest(SummaryVectorDelta::identifier))
+				{
+					// send the changes since the last exchange
+					SummaryVectorDelta *item = new SummaryVectorDelta();
+					_deltas.response(source, request, vec.getBloomFilter(), *item);
+					answer.addItem(item);
+				}
+				else
+				{
+					// create an item
+					BloomFilterSummaryVector *item = new BloomFilterSummaryVector(vec);
 
-				// add it to the handshake
-				answer.addItem(item);
+					// add it to the handshake
+					answer.addItem(item);
+				}
 			}
 
 			if (request.hasRequest(BloomFilterPurgeVector::identifier))
@@ -75,23 +88,58 @@ namespace dtn
 				// add own purge vector to the message
 				const dtn::data::BundleSet vec = (**this).getPurgedBundles();
 
-				// create an item
-				BloomFilterPurgeVector *item = new BloomFilterPurgeVector(vec);
+				if (request.hasRequest(PurgeVectorDelta::identifier))
+				{
+					// send the changes since the last exchange
+					PurgeVectorDelta *item = new PurgeVectorDelta();
+					_deltas.response(source, request, vec.getBloomFilter(), *item);
+					answer.addItem(item);
+				}
+				else
+				{
+					// create an item
+					BloomFilterPurgeVector *item = new BloomFilterPurgeVector(vec);
+
+					// add it to the handshake
+					answer.addItem(item);
+				}
+			}
 
-				// add it to the handshake
-				answer.addItem(item);
+			if (request.hasRequest(AggregateRecordSupport::identifier))
+			{
+				// this node understands aggregate records
+				answer.addItem(new AggregateRecordSupport());
 			}
 		}
 
-		void NodeHandshakeExtension::processHandshake(const dtn::data::EID &source, NodeHandshake &answer)
+		template<class DELTA, class VECTOR>
+		bool NodeHandshakeExtension::getFilter(const dtn::data::EID &source, NodeHandshake &answer, ibrcommon::BloomFilter &filter)
 		{
 			try {
-				const BloomFilterSummaryVector bfsv = answer.get<BloomFilterSummaryVector>();
+				const DELTA &delta = answer.get<DELTA>();
 
-				IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "summary vector received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
+				if (_deltas.process(source, delta, filter)) return true;
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "delta " << delta.getIdentifier().toString() << " from " << source.getString() << " does not match the known version" << IBRCOMMON_LOGGER_ENDL;
+				return false;
+			} catch (std::exception&) { };
 
-				// get the summary vector (bloomfilter) of this ECM
-				const ibrcommon::BloomFilter &filter = bfsv.getVector().getBloomFilter();
+			try {
+				const VECTOR &vector = answer.get<VECTOR>();
+				filter = vector.getVector().getBloomFilter();
+				return true;
+			} catch (std::exception&) { };
+
+			return false;
+		}
+
+		void NodeHandshakeExtension::processHandshake(const dtn::data::EID &source, NodeHandshake &answer)
+		{
+			// get the summary vector (bloomfilter) of this ECM
+			ibrcommon::BloomFilter filter;
+			if (getFilter<SummaryVectorDelta, BloomFilterSummaryVector>(source, answer, filter))
+			{
+				IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "summary vector received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
 
 				/**
 				 * Update the neighbor database with the received filter.
@@ -101,77 +149,89 @@ namespace dtn
 				NeighborDatabase &db = (**this).getNeighborDB();
 				ibrcommon::MutexLock l(db);
 				db.get(source.getNode()).update(filter, answer.getLifetime());
-			} catch (std::exception&) { };
-
-			try {
-				const BloomFilterPurgeVector bfpv = answer.get<BloomFilterPurgeVector>();
+			}
 
+			// get the purge vector (bloomfilter) of this ECM
+			ibrcommon::BloomFilter purge_filter;
+			if (getFilter<PurgeVectorDelta, BloomFilterPurgeVector>(source, answer, purge_filter))
+			{
 				IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "purge vector received from " << source.getString() << IBRCOMMON_LOGGER_ENDL;
 
-				// get the purge vector (bloomfilter) of this ECM
-				const ibrcommon::BloomFilter &purge = bfpv.getVector().getBloomFilter();
+				try {
+					purge(purge_filter);
+				} catch (std::exception&) { };
+			}
 
-				// get a reference to the storage
-				dtn::storage::BundleStorage &storage = (**this).getStorage();
+			try {
+				answer.get<AggregateRecordSupport>();
 
-				// create a bundle filter which selects bundles contained in the received
-				// purge vector but not addressed locally
-				class BundleFilter : public dtn::storage::BundleSelector
-				{
-				public:
-					BundleFilter(const ibrcommon::BloomFilter &filter)
-					 : _filter(filter)
-					{};
+				// send aggregate records to this node from now on
+				dtn::core::BundleCore::getInstance().getReportAggregator().setSupported(source.getNode());
+			} catch (std::exception&) { };
+		}
 
-					virtual ~BundleFilter() {};
+		void NodeHandshakeExtension::purge(const ibrcommon::BloomFilter &purge)
+		{
+			// get a reference to the storage
+			dtn::storage::BundleStorage &storage = (**this).getStorage();
 
-					virtual dtn::data::Size limit() const throw () { return 100; };
+			// create a bundle filter which selects bundles contained in the received
+			// purge vector but not addressed locally
+			class BundleFilter : public dtn::storage::BundleSelector
+			{
+			public:
+				BundleFilter(const ibrcommon::BloomFilter &filter)
+				 : _filter(filter)
+				{};
 
-					virtual bool shouldAdd(const dtn::data::MetaBundle &meta) const throw (dtn::storage::BundleSelectorException)
-					{
-						// do not select locally addressed bundles
-						if (meta.destination.getNode() == dtn::core::BundleCore::local)
-							return false;
+				virtual ~BundleFilter() {};
 
-						// do not purge non-singleton bundles
-						if (meta.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
-							return false;
+				virtual dtn::data::Size limit() const throw () { return 100; };
 
-						// select the bundle if it is in the filter
-						return meta.isIn(_filter);
-					};
+				virtual bool shouldAdd(const dtn::data::MetaBundle &meta) const throw (dtn::storage::BundleSelectorException)
+				{
+					// do not select locally addressed bundles
+					if (meta.destination.getNode() == dtn::core::BundleCore::local)
+						return false;
 
-					const ibrcommon::BloomFilter &_filter;
-				} bundle_filter(purge);
+					// do not purge non-singleton bundles
+					if (meta.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))
+						return false;
 
-				dtn::storage::BundleResultList list;
+					// select the bundle if it is in the filter
+					return meta.isIn(_filter);
+				};
 
-				// while we are getting more results from the storage
-				do {
-					// delete all previous results
-					list.clear();
+				const ibrcommon::BloomFilter &_filter;
+			} bundle_filter(purge);
 
-					// query for more bundles
-					storage.get(bundle_filter, list);
+			dtn::storage::BundleResultList list;
 
-					for (dtn::storage::BundleResultList::const_iterator iter = list.begin(); iter != list.end(); ++iter)
-					{
-						const dtn::data::MetaBundle &meta = (*iter);
+			// while we are getting more results from the storage
+			do {
+				// delete all previous results
+				list.clear();
 
-						// delete bundle from storage
-						storage.remove(meta);
+				// query for more bundles
+				storage.get(bundle_filter, list);
 
-						// log the purged bundle
-						IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "bundle purged: " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
+				for (dtn::storage::BundleResultList::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+				{
+					const dtn::data::MetaBundle &meta = (*iter);
 
-						// gen a report
-						dtn::core::BundleEvent::raise(meta, dtn::core::BUNDLE_DELETED, StatusReportBlock::NO_ADDITIONAL_INFORMATION);
+					// delete bundle from storage
+					storage.remove(meta);
 
-						// add this bundle to the own purge vector
-						(**this).setPurged(meta);
-					}
-				} while (!list.empty());
-			} catch (std::exception&) { };
+					// log the purged bundle
+					IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 10) << "bundle purged: " << meta.toString() << IBRCOMMON_LOGGER_ENDL;
+
+					// gen a report
+					dtn::core::BundleEvent::raise(meta, dtn::core::BUNDLE_DELETED, StatusReportBlock::NO_ADDITIONAL_INFORMATION);
+
+					// add this bundle to the own purge vector
+					(**this).setPurged(meta);
+				}
+			} while (!list.empty());
 		}
 
 		void NodeHandshakeExtension::doHandshake(const dtn::data::EID &eid)
@@ -299,6 +359,9 @@ namespace dtn
 			// walk through all extensions to generate a request
 			(*_callback).requestHandshake(origin, request);
 
+			// ask for deltas of the requested vectors
+			_callback._deltas.request(origin, request);
+
 			IBRCOMMON_LOGGER_DEBUG_TAG(NodeHandshakeExtension::TAG, 15) << "handshake query for " << origin.getString() << ": " << request.toString() << IBRCOMMON_LOGGER_ENDL;
 
 			// create a new bundle with a zero timestamp (+age block)
@@ -23,6 +23,7 @@
 #define NODEHANDSHAKEEXTENSION_H_
 
 #include "routing/RoutingExtension.h"
+#include "routing/HandshakeDeltaTable.h"
 #include "core/AbstractWorker.h"
 #include "core/EventReceiver.h"
 #include "core/NodeEvent.h"
@@ -70,6 +71,16 @@ namespace dtn
 			void processHandshake(const dtn::data::Bundle &bundle);
 
 		private:
+			/**
+			 * Get the filter of a received vector item or
+			 * reconstruct it from a delta item.
+			 * @return False, if no usable filter has been received.
+			 */
+			template<class DELTA, class VECTOR>
+			bool getFilter(const dtn::data::EID &source, NodeHandshake &answer, ibrcommon::BloomFilter &filter);
+
+			void purge(const ibrcommon::BloomFilter &purge);
+
 			class HandshakeEndpoint : public dtn::core::AbstractWorker
 			{
 			public:
@@ -95,6 +106,11 @@ namespace dtn
 			 */
 			HandshakeEndpoint _endpoint;
 
+			/**
+			 * versions of the vectors exchanged with each peer
+			 */
+			HandshakeDeltaTable _deltas;
+
 			static const dtn::data::EID BROADCAST_ENDPOINT;
 		};
 	} /* namespace routing */
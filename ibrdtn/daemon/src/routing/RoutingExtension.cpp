@@ -78,7 +78,16 @@ namespace dtn
 				NeighborDatabase::NeighborEntry &entry = (**this).getNeighborDB().get(destination, true);
 
 				// acquire the transfer, could throw already in transit or no resource left exception
-				entry.acquireTransfer(meta);
+				try {
+					entry.acquireTransfer(meta);
+				} catch (const NeighborDatabase::NoMoreTransfersAvailable&) {
+					// make room by dropping a waiting transfer with lower priority
+					dtn::data::BundleID dropped;
+					if (!dtn::core::BundleCore::getInstance().getConnectionManager().preempt(destination, meta, dropped)) throw;
+
+					entry.releaseTransfer(dropped);
+					entry.acquireTransfer(meta);
+				}
 			}
 			try{
 				//create the transfer object
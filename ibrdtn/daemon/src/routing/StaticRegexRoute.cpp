@@ -91,6 +91,44 @@ namespace dtn
 			}
 		}
 
+		StaticRoute::INDEX_TYPE StaticRegexRoute::getIndexKey(std::string &key, bool &verify) const
+		{
+			key.clear();
+			verify = true;
+
+			// only expressions anchored at the beginning have a mandatory prefix
+			if (_invalid || (_regex_str.length() == 0) || (_regex_str[0] != '^')) return INDEX_NONE;
+
+			// alternatives may match without the prefix
+			if (_regex_str.find("\\|") != std::string::npos) return INDEX_NONE;
+
+			std::string::size_type i = 1;
+			for (; i < _regex_str.length(); ++i)
+			{
+				const char c = _regex_str[i];
+
+				if ((c == '*') || (c == '\\'))
+				{
+					// the previous character may be optional or repeated
+					if (key.length() > 0) key.erase(key.length() - 1);
+					return INDEX_PREFIX;
+				}
+
+				if ((c == '.') || (c == '[') || (c == '$')) break;
+
+				key.push_back(c);
+			}
+
+			// the expression matches every EID starting with the prefix
+			const std::string rest = _regex_str.substr(i);
+			if ((rest.length() == 0) || (rest == ".*") || (rest == ".*$"))
+			{
+				verify = false;
+			}
+
+			return INDEX_PREFIX;
+		}
+
 		const dtn::data::EID& StaticRegexRoute::getDestination() const
 		{
 			return _dest;
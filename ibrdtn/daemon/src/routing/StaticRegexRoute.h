@@ -34,6 +34,12 @@ namespace dtn
 			 */
 			bool equals(const StaticRoute &route) const;
 
+			/**
+			 * Returns the literal prefix of an anchored expression
+			 * @see StaticRoute::getIndexKey()
+			 */
+			INDEX_TYPE getIndexKey(std::string &key, bool &verify) const;
+
 			/**
 			 * copy and assignment operators
 			 * @param obj The object to copy
@@ -13,5 +13,12 @@ namespace dtn
 	{
 		// virtual destructor
 		StaticRoute::~StaticRoute() {}
+
+		StaticRoute::INDEX_TYPE StaticRoute::getIndexKey(std::string &key, bool &verify) const
+		{
+			key.clear();
+			verify = true;
+			return INDEX_NONE;
+		}
 	}
 }
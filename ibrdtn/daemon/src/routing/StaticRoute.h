@@ -18,6 +18,19 @@ namespace dtn
 		class StaticRoute
 		{
 		public:
+			/**
+			 * Describes how a route can be indexed by a StaticRouteTable
+			 */
+			enum INDEX_TYPE
+			{
+				// the route has to be checked using match() for each destination
+				INDEX_NONE = 0,
+				// the route matches all EIDs of the node given by the key
+				INDEX_NODE = 1,
+				// all matching EIDs start with the literal prefix given by the key
+				INDEX_PREFIX = 2
+			};
+
 			virtual ~StaticRoute() = 0;
 			virtual bool match(const dtn::data::EID &eid) const = 0;
 			virtual const dtn::data::EID& getDestination() const = 0;
@@ -33,6 +46,14 @@ namespace dtn
 			 * Compare this static route with another one
 			 */
 			virtual bool equals(const StaticRoute &route) const = 0;
+
+			/**
+			 * Returns the index key of this route. If verify is set to false,
+			 * every EID selected by the key matches this route. Otherwise
+			 * match() has to be called for the selected EIDs.
+			 * The default implementation returns INDEX_NONE.
+			 */
+			virtual INDEX_TYPE getIndexKey(std::string &key, bool &verify) const;
 		};
 	}
 }
@@ -0,0 +1,213 @@
+/*
+ * StaticRouteTable.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "routing/StaticRouteTable.h"
+#include <algorithm>
+
+namespace dtn
+{
+	namespace routing
+	{
+		StaticRouteTable::Entry::Entry(size_t i, const StaticRoute *r, bool v)
+		 : index(i), route(r), verify(v)
+		{
+		}
+
+		StaticRouteTable::TrieNode::TrieNode()
+		{
+		}
+
+		StaticRouteTable::TrieNode::~TrieNode()
+		{
+			for (std::map<char, TrieNode*>::iterator it = children.begin(); it != children.end(); ++it)
+			{
+				delete (*it).second;
+			}
+		}
+
+		StaticRouteTable::StaticRouteTable()
+		 : _trie(new TrieNode()), _size(0)
+		{
+		}
+
+		StaticRouteTable::StaticRouteTable(const std::list<StaticRoute*> &routes)
+		 : _trie(new TrieNode()), _size(0)
+		{
+			compile(routes);
+		}
+
+		StaticRouteTable::~StaticRouteTable()
+		{
+			delete _trie;
+		}
+
+		void StaticRouteTable::compile(const std::list<StaticRoute*> &routes)
+		{
+			for (std::list<StaticRoute*>::const_iterator iter = routes.begin(); iter != routes.end(); ++iter)
+			{
+				const StaticRoute *route = (*iter);
+				std::string key;
+				bool verify = true;
+
+				switch (route->getIndexKey(key, verify))
+				{
+				case StaticRoute::INDEX_NODE:
+					_nodes[dtn::data::EIDHandle(dtn::data::EID(key))].push_back(Entry(_size, route, verify));
+					break;
+
+				case StaticRoute::INDEX_PREFIX:
+				{
+					TrieNode *n = _trie;
+					for (std::string::const_iterator it = key.begin(); it != key.end(); ++it)
+					{
+						TrieNode *&child = n->children[*it];
+						if (child == NULL) child = new TrieNode();
+						n = child;
+					}
+					n->entries.push_back(Entry(_size, route, verify));
+					break;
+				}
+
+				default:
+					_unindexed.push_back(Entry(_size, route, true));
+					break;
+				}
+
+				++_nexthops[route->getDestination()];
+				++_size;
+			}
+		}
+
+		void StaticRouteTable::match(const dtn::data::EID &destination, route_list &ret) const
+		{
+			std::vector<const Entry*> entries;
+			__match(destination, NULL, &entries);
+
+			// restore the order of the compiled list
+			std::sort(entries.begin(), entries.end(), __order);
+
+			for (std::vector<const Entry*>::const_iterator it = entries.begin(); it != entries.end(); ++it)
+			{
+				ret.push_back((*it)->route);
+			}
+		}
+
+		bool StaticRouteTable::match(const dtn::data::EID &destination, const dtn::data::EID &nexthop) const
+		{
+			if (!hasNextHop(nexthop)) return false;
+			return __match(destination, &nexthop, NULL);
+		}
+
+		bool StaticRouteTable::hasNextHop(const dtn::data::EID &nexthop) const
+		{
+			return _nexthops.find(nexthop) != _nexthops.end();
+		}
+
+		void StaticRouteTable::swap(StaticRouteTable &other)
+		{
+			_nodes.swap(other._nodes);
+			std::swap(_trie, other._trie);
+			_unindexed.swap(other._unindexed);
+			_nexthops.swap(other._nexthops);
+			std::swap(_size, other._size);
+		}
+
+		size_t StaticRouteTable::size() const
+		{
+			return _size;
+		}
+
+		bool StaticRouteTable::__check(const Entry &e, const dtn::data::EID &destination, const dtn::data::EID *nexthop, std::vector<const Entry*> *ret)
+		{
+			if ((nexthop != NULL) && (e.route->getDestination() != *nexthop)) return false;
+			if (e.verify && !e.route->match(destination)) return false;
+			if (ret != NULL) ret->push_back(&e);
+			return true;
+		}
+
+		bool StaticRouteTable::__match(const dtn::data::EID &destination, const dtn::data::EID *nexthop, std::vector<const Entry*> *ret) const
+		{
+			bool found = false;
+
+			// routes to the whole node of the destination
+			if (!_nodes.empty())
+			{
+				dtn::data::EIDHandle node;
+				if (dtn::data::EIDHandle::lookup(destination.getNode(), node))
+				{
+					node_map::const_iterator it = _nodes.find(node);
+					if (it != _nodes.end())
+					{
+						for (entry_list::const_iterator e = (*it).second.begin(); e != (*it).second.end(); ++e)
+						{
+							if (__check(*e, destination, nexthop, ret))
+							{
+								if (ret == NULL) return true;
+								found = true;
+							}
+						}
+					}
+				}
+			}
+
+			// routes with a prefix of the destination
+			if (!_trie->children.empty() || !_trie->entries.empty())
+			{
+				const std::string dest = destination.getString();
+				const TrieNode *n = _trie;
+				std::string::const_iterator c = dest.begin();
+
+				while (n != NULL)
+				{
+					for (entry_list::const_iterator e = n->entries.begin(); e != n->entries.end(); ++e)
+					{
+						if (__check(*e, destination, nexthop, ret))
+						{
+							if (ret == NULL) return true;
+							found = true;
+						}
+					}
+
+					if (c == dest.end()) break;
+
+					std::map<char, TrieNode*>::const_iterator it = n->children.find(*c);
+					n = (it == n->children.end()) ? NULL : (*it).second;
+					++c;
+				}
+			}
+
+			// all other routes
+			for (entry_list::const_iterator e = _unindexed.begin(); e != _unindexed.end(); ++e)
+			{
+				if (__check(*e, destination, nexthop, ret))
+				{
+					if (ret == NULL) return true;
+					found = true;
+				}
+			}
+
+			return found;
+		}
+
+		bool StaticRouteTable::__order(const Entry *left, const Entry *right)
+		{
+			return left->index < right->index;
+		}
+	}
+}
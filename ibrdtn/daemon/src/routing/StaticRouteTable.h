@@ -0,0 +1,140 @@
+/*
+ * StaticRouteTable.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef STATICROUTETABLE_H_
+#define STATICROUTETABLE_H_
+
+#include "routing/StaticRoute.h"
+#include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/EIDTable.h>
+#include <list>
+#include <map>
+#include <vector>
+
+namespace dtn
+{
+	namespace routing
+	{
+		/**
+		 * A compiled lookup structure for a list of static routes. Routes
+		 * to a whole node are kept in an exact-match map, routes with a
+		 * literal EID prefix in a prefix trie. Only routes without any
+		 * index key are checked one by one.
+		 *
+		 * The table references the routes of the compiled list, thus it has
+		 * to be compiled again if the list has been changed.
+		 */
+		class StaticRouteTable
+		{
+		public:
+			typedef std::vector<const StaticRoute*> route_list;
+
+			StaticRouteTable();
+
+			/**
+			 * Creates a table compiled from the given list of routes
+			 */
+			explicit StaticRouteTable(const std::list<StaticRoute*> &routes);
+
+			virtual ~StaticRouteTable();
+
+			/**
+			 * Returns all routes matching the destination in the order
+			 * of the compiled list.
+			 */
+			void match(const dtn::data::EID &destination, route_list &ret) const;
+
+			/**
+			 * Returns true, if at least one route via the given next-hop
+			 * matches the destination.
+			 */
+			bool match(const dtn::data::EID &destination, const dtn::data::EID &nexthop) const;
+
+			/**
+			 * Returns true, if at least one route uses the given next-hop
+			 */
+			bool hasNextHop(const dtn::data::EID &nexthop) const;
+
+			/**
+			 * Exchange the content with another table
+			 */
+			void swap(StaticRouteTable &other);
+
+			/**
+			 * Returns the number of compiled routes
+			 */
+			size_t size() const;
+
+		private:
+			class Entry
+			{
+			public:
+				Entry(size_t index, const StaticRoute *route, bool verify);
+
+				// position of the route in the compiled list
+				size_t index;
+				const StaticRoute *route;
+
+				// if true, the route has to be checked with match()
+				bool verify;
+			};
+
+			typedef std::vector<Entry> entry_list;
+
+			class TrieNode
+			{
+			public:
+				TrieNode();
+				~TrieNode();
+
+				std::map<char, TrieNode*> children;
+				entry_list entries;
+			};
+
+			typedef std::map<dtn::data::EIDHandle, entry_list> node_map;
+			typedef std::map<dtn::data::EID, size_t> nexthop_map;
+
+			// the table is not copyable
+			StaticRouteTable(const StaticRouteTable&);
+			StaticRouteTable& operator=(const StaticRouteTable&);
+
+			void compile(const std::list<StaticRoute*> &routes);
+
+			/**
+			 * Walk through all candidates of the destination. If a next-hop is
+			 * given, the walk stops at the first matching route via this next-hop.
+			 * Otherwise all matching entries are appended to the result.
+			 * @return True, if a matching route has been found
+			 */
+			bool __match(const dtn::data::EID &destination, const dtn::data::EID *nexthop, std::vector<const Entry*> *ret) const;
+
+			static bool __order(const Entry *left, const Entry *right);
+
+			static bool __check(const Entry &e, const dtn::data::EID &destination, const dtn::data::EID *nexthop, std::vector<const Entry*> *ret);
+
+			node_map _nodes;
+			TrieNode *_trie;
+			entry_list _unindexed;
+			nexthop_map _nexthops;
+			size_t _size;
+		};
+	}
+}
+
+#endif /* STATICROUTETABLE_H_ */
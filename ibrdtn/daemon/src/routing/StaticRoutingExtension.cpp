@@ -50,7 +50,7 @@ namespace dtn
 		const std::string StaticRoutingExtension::TAG = "StaticRoutingExtension";
 
 		StaticRoutingExtension::StaticRoutingExtension()
-		 : next_expire(0)
+		 : _table_outdated(false), next_expire(0)
 		{
 		}
 
@@ -77,8 +77,8 @@ namespace dtn
 			class BundleFilter : public dtn::storage::BundleSelector
 			{
 			public:
-				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const std::list<const StaticRoute*> &routes, const dtn::core::FilterContext &context, const dtn::net::ConnectionManager::protocol_list &plist)
-				 : _entry(entry), _routes(routes), _plist(plist), _context(context)
+				BundleFilter(const NeighborDatabase::NeighborEntry &entry, const StaticRouteTable &table, const dtn::core::FilterContext &context, const dtn::net::ConnectionManager::protocol_list &plist)
+				 : _entry(entry), _table(table), _plist(plist), _context(context)
 				{};
 
 				virtual ~BundleFilter() {};
@@ -117,30 +117,25 @@ namespace dtn
 					dtn::core::FilterContext context = _context;
 					context.setMetaBundle(meta);
 
-					// search for one rule that match
-					for (std::list<const StaticRoute*>::const_iterator iter = _routes.begin(); iter != _routes.end(); ++iter)
+					// search for one rule via this neighbor that match
+					if (_table.match(meta.destination, _entry.eid))
 					{
-						const StaticRoute &route = (**iter);
-
-						if (route.match(meta.destination))
+						// check bundle filter for each possible path
+						for (dtn::net::ConnectionManager::protocol_list::const_iterator it = _plist.begin(); it != _plist.end(); ++it)
 						{
-							// check bundle filter for each possible path
-							for (dtn::net::ConnectionManager::protocol_list::const_iterator it = _plist.begin(); it != _plist.end(); ++it)
-							{
-								const dtn::core::Node::Protocol &p = (*it);
+							const dtn::core::Node::Protocol &p = (*it);
 
-								// update context with current protocol
-								context.setProtocol(p);
+							// update context with current protocol
+							context.setProtocol(p);
 
-								// execute filtering
-								dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
+							// execute filtering
+							dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
 
-								if (ret == dtn::core::BundleFilter::ACCEPT)
-								{
-									// put the selected bundle with targeted interface into the result-set
-									static_cast<RoutingResult&>(result).put(meta, p);
-									return true;
-								}
+							if (ret == dtn::core::BundleFilter::ACCEPT)
+							{
+								// put the selected bundle with targeted interface into the result-set
+								static_cast<RoutingResult&>(result).put(meta, p);
+								return true;
 							}
 						}
 					}
@@ -150,7 +145,7 @@ namespace dtn
 
 			private:
 				const NeighborDatabase::NeighborEntry &_entry;
-				const std::list<const StaticRoute*> &_routes;
+				const StaticRouteTable &_table;
 				const dtn::net::ConnectionManager::protocol_list &_plist;
 				const dtn::core::FilterContext &_context;
 			};
@@ -169,7 +164,7 @@ namespace dtn
 			while (true)
 			{
 				NeighborDatabase &db = (**this).getNeighborDB();
-				std::list<const StaticRoute*> routes;
+				StaticRouteTable::route_list routes;
 
 				try {
 					Task *t = _taskqueue.poll();
@@ -180,25 +175,13 @@ namespace dtn
 					try {
 						SearchNextBundleTask &task = dynamic_cast<SearchNextBundleTask&>(*t);
 
-						// remove all routes of the previous round
-						routes.clear();
-
 						// clear the result list
 						list.clear();
 
 						// look for routes to this node
-						for (std::list<StaticRoute*>::const_iterator iter = _routes.begin();
-								iter != _routes.end(); ++iter)
-						{
-							const StaticRoute *route = (*iter);
-							if (route->getDestination() == task.eid)
-							{
-								// add to the valid routes
-								routes.push_back(route);
-							}
-						}
+						const StaticRouteTable &table = getTable();
 
-						if (!routes.empty())
+						if (table.hasNextHop(task.eid))
 						{
 							// lock the neighbor database while searching for bundles
 							{
@@ -220,7 +203,7 @@ namespace dtn
 								context.setRouting(*this);
 
 								// get the bundle filter of the neighbor
-								BundleFilter filter(entry, routes, context, plist);
+								BundleFilter filter(entry, table, context, plist);
 
 								// some debug
 								IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 40) << "search some bundles not known by " << task.eid.getString() << IBRCOMMON_LOGGER_ENDL;
@@ -255,53 +238,53 @@ namespace dtn
 						// check Scope Control Block - do not forward non-group bundles with hop limit <= 1
 						if ((task.bundle.hopcount <= 1) && (task.bundle.get(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON))) continue;
 
-						// look for routes to this node
-						for (std::list<StaticRoute*>::const_iterator iter = _routes.begin(); iter != _routes.end(); ++iter)
+						// look for routes matching the destination
+						routes.clear();
+						getTable().match(task.bundle.destination, routes);
+
+						for (StaticRouteTable::route_list::const_iterator iter = routes.begin(); iter != routes.end(); ++iter)
 						{
 							const StaticRoute &route = (**iter);
 
-							IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 50) << "check static route: " << route.toString() << IBRCOMMON_LOGGER_ENDL;
+							IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 50) << "use static route: " << route.toString() << IBRCOMMON_LOGGER_ENDL;
 
 							try {
-								if (route.match(task.bundle.destination))
+								// lock the neighbor database while checking if the bundle
+								// is already known by the peer
 								{
-									// lock the neighbor database while checking if the bundle
-									// is already known by the peer
-									{
-										// get data about the potential next-hop
-										ibrcommon::MutexLock l(db);
-										NeighborDatabase::NeighborEntry &entry = db.get(route.getDestination(), true);
+									// get data about the potential next-hop
+									ibrcommon::MutexLock l(db);
+									NeighborDatabase::NeighborEntry &entry = db.get(route.getDestination(), true);
 
-										// do not forward bundles already known by the destination
-										if (entry.has(task.bundle)) continue;
-									}
+									// do not forward bundles already known by the destination
+									if (entry.has(task.bundle)) continue;
+								}
 
-									// get a list of protocols supported by both, the local BPA and the remote peer
-									const dtn::net::ConnectionManager::protocol_list plist =
-											dtn::core::BundleCore::getInstance().getConnectionManager().getSupportedProtocols(route.getDestination());
+								// get a list of protocols supported by both, the local BPA and the remote peer
+								const dtn::net::ConnectionManager::protocol_list plist =
+										dtn::core::BundleCore::getInstance().getConnectionManager().getSupportedProtocols(route.getDestination());
 
-									// create a filter context
-									dtn::core::FilterContext context;
-									context.setPeer(route.getDestination());
-									context.setRouting(*this);
+								// create a filter context
+								dtn::core::FilterContext context;
+								context.setPeer(route.getDestination());
+								context.setRouting(*this);
 
-									// check bundle filter for each possible path
-									for (dtn::net::ConnectionManager::protocol_list::const_iterator it = plist.begin(); it != plist.end(); ++it)
-									{
-										const dtn::core::Node::Protocol &p = (*it);
+								// check bundle filter for each possible path
+								for (dtn::net::ConnectionManager::protocol_list::const_iterator it = plist.begin(); it != plist.end(); ++it)
+								{
+									const dtn::core::Node::Protocol &p = (*it);
 
-										// update context with current protocol
-										context.setProtocol(p);
+									// update context with current protocol
+									context.setProtocol(p);
 
-										// execute filtering
-										dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
+									// execute filtering
+									dtn::core::BundleFilter::ACTION ret = dtn::core::BundleCore::getInstance().evaluate(dtn::core::BundleFilter::ROUTING, context);
 
-										if (ret == dtn::core::BundleFilter::ACCEPT)
-										{
-											// transfer the bundle to the neighbor
-											transferTo(route.getDestination(), task.bundle, p);
-											break;
-										}
+									if (ret == dtn::core::BundleFilter::ACCEPT)
+									{
+										// transfer the bundle to the neighbor
+										transferTo(route.getDestination(), task.bundle, p);
+										break;
 									}
 								}
 							} catch (const NeighborDatabase::EntryNotFoundException&) {
@@ -333,6 +316,8 @@ namespace dtn
 							}
 						}
 
+						_table_outdated = true;
+
 						if (task.type == RouteChangeTask::ROUTE_ADD)
 						{
 							_routes.push_back(task.route);
@@ -368,6 +353,7 @@ namespace dtn
 							delete route;
 						}
 						_routes.clear();
+						_table_outdated = true;
 
 						ibrcommon::MutexLock l(_expire_lock);
 						next_expire = 0;
@@ -390,6 +376,7 @@ namespace dtn
 								route->raiseExpired();
 								delete route;
 								_routes.erase(iter++);
+								_table_outdated = true;
 							}
 							else
 							{
@@ -412,6 +399,21 @@ namespace dtn
 			}
 		}
 
+		const StaticRouteTable& StaticRoutingExtension::getTable()
+		{
+			if (_table_outdated)
+			{
+				// compile the current routes and replace the table at once
+				StaticRouteTable table(_routes);
+				_table.swap(table);
+				_table_outdated = false;
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(StaticRoutingExtension::TAG, 25) << "route table compiled with " << _table.size() << " routes" << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			return _table;
+		}
+
 		void StaticRoutingExtension::eventDataChanged(const dtn::data::EID &peer) throw ()
 		{
 			_taskqueue.push( new SearchNextBundleTask(peer) );
@@ -562,6 +564,13 @@ namespace dtn
 			}
 		}
 
+		StaticRoute::INDEX_TYPE StaticRoutingExtension::EIDRoute::getIndexKey(std::string &key, bool &verify) const
+		{
+			key = _match.getNode().getString();
+			verify = false;
+			return INDEX_NODE;
+		}
+
 		/****************************************/
 
 		StaticRoutingExtension::SearchNextBundleTask::SearchNextBundleTask(const dtn::data::EID &e)
@@ -23,6 +23,7 @@
 #define STATICROUTINGEXTENSION_H_
 
 #include "routing/StaticRoute.h"
+#include "routing/StaticRouteTable.h"
 #include "routing/RoutingExtension.h"
 #include "routing/StaticRouteChangeEvent.h"
 #include "core/TimeEvent.h"
@@ -95,6 +96,12 @@ namespace dtn
 				 */
 				bool equals(const StaticRoute &route) const;
 
+				/**
+				 * Returns the node EID of this route
+				 * @see StaticRoute::getIndexKey()
+				 */
+				INDEX_TYPE getIndexKey(std::string &key, bool &verify) const;
+
 			private:
 				const dtn::data::EID _nexthop;
 				const dtn::data::EID _match;
@@ -173,10 +180,23 @@ namespace dtn
 			 */
 			ibrcommon::Queue<StaticRoutingExtension::Task* > _taskqueue;
 
+			/**
+			 * Returns the compiled table of the current routes
+			 */
+			const StaticRouteTable& getTable();
+
 			/**
 			 * static list of routes
 			 */
 			std::list<StaticRoute*> _routes;
+
+			/**
+			 * compiled lookup table of the routes, it is compiled
+			 * again on the next lookup once the routes have changed
+			 */
+			StaticRouteTable _table;
+			bool _table_outdated;
+
 			ibrcommon::Mutex _expire_lock;
 			dtn::data::Timestamp next_expire;
 		};
@@ -9,6 +9,7 @@
 #include "core/BundleCore.h"
 #include <ibrdtn/utils/Clock.h>
 #include <ibrcommon/Logger.h>
+#include <algorithm>
 #include <vector>
 
 #include <ibrcommon/ibrcommon.h>
@@ -23,14 +24,19 @@ namespace dtn
 	namespace routing
 	{
 		const dtn::data::Number DeliveryPredictabilityMap::identifier = NodeHandshakeItem::DELIVERY_PREDICTABILITY_MAP;
+		const size_t DeliveryPredictabilityMap::MAX_INTERNED_NODES = 4096;
+		const size_t DeliveryPredictabilityMap::MAX_EID_LENGTH = 1024;
+
+		// longest float string accepted from a neighbor
+		static const size_t MAX_FLOAT_LENGTH = 64;
 
 		DeliveryPredictabilityMap::DeliveryPredictabilityMap()
-		: NeighborDataSetImpl(DeliveryPredictabilityMap::identifier), _beta(0.0), _gamma(0.0), _lastAgingTime(0), _time_unit(0)
+		: NeighborDataSetImpl(DeliveryPredictabilityMap::identifier), _size(0), _beta(0.0), _gamma(0.0), _lastAgingTime(0), _time_unit(0)
 		{
 		}
 
 		DeliveryPredictabilityMap::DeliveryPredictabilityMap(const size_t &time_unit, const float &beta, const float &gamma)
-		: NeighborDataSetImpl(DeliveryPredictabilityMap::identifier), _beta(beta), _gamma(gamma), _lastAgingTime(0), _time_unit(time_unit)
+		: NeighborDataSetImpl(DeliveryPredictabilityMap::identifier), _size(0), _beta(beta), _gamma(gamma), _lastAgingTime(0), _time_unit(time_unit)
 		{
 		}
 
@@ -45,33 +51,33 @@ namespace dtn
 		dtn::data::Length DeliveryPredictabilityMap::getLength() const
 		{
 			dtn::data::Length len = 0;
-			for(predictmap::const_iterator it = _predictmap.begin(); it != _predictmap.end(); ++it)
+			for (const_iterator it = begin(); it != end(); ++it)
 			{
 				/* calculate length of the EID */
-				const std::string eid = it->first.getString();
+				const std::string eid = (*it).getString();
 				dtn::data::Length eid_len = eid.length();
 				len += data::Number(eid_len).getLength() + eid_len;
 
 				/* calculate length of the float in fixed notation */
-				const float& f = it->second;
+				const float& f = _values[it._pos];
 				std::stringstream ss;
 				ss << f << std::flush;
 
 				dtn::data::Length float_len = ss.str().length();
 				len += data::Number(float_len).getLength() + float_len;
 			}
-			return data::Number(_predictmap.size()).getLength() + len;
+			return data::Number(_size).getLength() + len;
 		}
 
 		std::ostream& DeliveryPredictabilityMap::serialize(std::ostream& stream) const
 		{
-			stream << data::Number(_predictmap.size());
-			for(predictmap::const_iterator it = _predictmap.begin(); it != _predictmap.end(); ++it)
+			stream << data::Number(_size);
+			for (const_iterator it = begin(); it != end(); ++it)
 			{
-				const std::string eid = it->first.getString();
+				const std::string eid = (*it).getString();
 				stream << data::Number(eid.length()) << eid;
 
-				const float& f = it->second;
+				const float& f = _values[it._pos];
 				/* write f into a stringstream to get final length */
 				std::stringstream ss;
 				ss << f << std::flush;
@@ -79,7 +85,7 @@ namespace dtn
 				stream << data::Number(ss.str().length());
 				stream << ss.str();
 			}
-			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 20) << "Serialized with " << _predictmap.size() << " items." << IBRCOMMON_LOGGER_ENDL;
+			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 20) << "Serialized with " << _size << " items." << IBRCOMMON_LOGGER_ENDL;
 			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 60) << *this << IBRCOMMON_LOGGER_ENDL;
 			return stream;
 		}
@@ -96,6 +102,12 @@ namespace dtn
 				data::Number eid_len;
 				stream >> eid_len;
 
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a dp_map.");
+
+				if ((eid_len.get<size_t>() == 0) || (eid_len.get<size_t>() > MAX_EID_LENGTH))
+					throw dtn::InvalidDataException("Invalid EID length, while parsing a dp_map.");
+
 				// create a buffer for the EID
 				std::vector<char> eid_cstr(eid_len.get<size_t>());
 
@@ -113,12 +125,21 @@ namespace dtn
 				dtn::data::Number float_len;
 				stream >> float_len;
 
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a dp_map.");
+
+				if ((float_len.get<size_t>() == 0) || (float_len.get<size_t>() > MAX_FLOAT_LENGTH))
+					throw dtn::InvalidDataException("Invalid float length, while parsing a dp_map.");
+
 				// create a buffer for the data string
 				std::vector<char> f_cstr(float_len.get<size_t>());
 
 				// read the data string
 				stream.read(&f_cstr[0], f_cstr.size());
 
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a dp_map.");
+
 				// convert string data into a stringstream
 				std::stringstream ss(std::string(f_cstr.begin(), f_cstr.end()));
 
@@ -132,22 +153,53 @@ namespace dtn
 					continue;
 
 				/* insert the data into the map */
-				_predictmap[eid] = f;
+				setReceived(eid, f);
 
 				elements_read += 1;
 			}
 
-			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 20) << "Deserialized with " << _predictmap.size() << " items." << IBRCOMMON_LOGGER_ENDL;
+			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 20) << "Deserialized with " << _size << " items." << IBRCOMMON_LOGGER_ENDL;
 			IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 60) << *this << IBRCOMMON_LOGGER_ENDL;
 			return stream;
 		}
 
+		bool DeliveryPredictabilityMap::__slot(const dtn::data::EID &eid, size_t &slot)
+		{
+			dtn::data::EIDHandle node;
+			if (!dtn::data::EIDHandle::lookup(eid.getNode(), node)) return false;
+			slot = node.id();
+			return true;
+		}
+
+		void DeliveryPredictabilityMap::__resize(size_t slots)
+		{
+			if (_values.size() >= slots) return;
+
+			// grow in steps to avoid frequent copies
+			size_t n = (_values.size() < 64) ? 64 : _values.size();
+			while (n < slots) n <<= 1;
+
+			_values.resize(n, -1.0f);
+			_nodes.resize(n, dtn::data::EIDHandle());
+		}
+
 		float DeliveryPredictabilityMap::get(const dtn::data::EID &neighbor) const throw (ValueNotFoundException)
 		{
-			predictmap::const_iterator it;
-			if ((it = _predictmap.find(neighbor)) != _predictmap.end())
+			size_t slot = 0;
+			if (__slot(neighbor, slot) && (slot < _values.size()) && (_values[slot] >= 0.0f))
 			{
-				return it->second;
+				return _values[slot];
+			}
+
+			throw ValueNotFoundException();
+		}
+
+		float DeliveryPredictabilityMap::get(const dtn::data::EIDHandle &node) const throw (ValueNotFoundException)
+		{
+			const size_t slot = node.id();
+			if ((slot < _values.size()) && (_values[slot] >= 0.0f))
+			{
+				return _values[slot];
 			}
 
 			throw ValueNotFoundException();
@@ -155,17 +207,50 @@ namespace dtn
 
 		void DeliveryPredictabilityMap::set(const dtn::data::EID &neighbor, float value)
 		{
-			_predictmap[neighbor] = value;
+			__set(dtn::data::EIDHandle(neighbor.getNode()), value);
+		}
+
+		bool DeliveryPredictabilityMap::setReceived(const dtn::data::EID &neighbor, float value)
+		{
+			const dtn::data::EID node_eid = neighbor.getNode();
+			dtn::data::EIDHandle node;
+
+			if (!dtn::data::EIDHandle::lookup(node_eid, node))
+			{
+				if (dtn::data::EIDTable::getInstance().size() >= MAX_INTERNED_NODES)
+				{
+					IBRCOMMON_LOGGER_DEBUG_TAG("DeliveryPredictabilityMap", 30) << "entry of " << node_eid.getString() << " dropped, too many nodes known" << IBRCOMMON_LOGGER_ENDL;
+					return false;
+				}
+
+				node = dtn::data::EIDHandle(node_eid);
+			}
+
+			__set(node, value);
+			return true;
+		}
+
+		void DeliveryPredictabilityMap::__set(const dtn::data::EIDHandle &node, float value)
+		{
+			const size_t slot = node.id();
+
+			__resize(slot + 1);
+
+			if (_values[slot] < 0.0f) ++_size;
+			_values[slot] = value;
+			_nodes[slot] = node;
 		}
 
 		void DeliveryPredictabilityMap::clear()
 		{
-			_predictmap.clear();
+			_values.clear();
+			_nodes.clear();
+			_size = 0;
 		}
 
 		size_t DeliveryPredictabilityMap::size() const
 		{
-			return _predictmap.size();
+			return _size;
 		}
 
 		void DeliveryPredictabilityMap::update(const dtn::data::EID &host_b, const DeliveryPredictabilityMap &dpm, const float &p_encounter_first)
@@ -178,66 +263,105 @@ namespace dtn
 				p_ab = p_encounter_first;
 			}
 
+			const size_t slots = dpm._values.size();
+			if (slots == 0) return;
+
+			__resize(slots);
+
+			// do not update values for the origin host and our own EID
+			size_t excluded[2] = { slots, slots };
+			float saved[2] = { 0.0f, 0.0f };
+
+			if (__slot(host_b, excluded[0]) && (excluded[0] < slots)) saved[0] = _values[excluded[0]];
+			else excluded[0] = slots;
+
+			if (__slot(dtn::core::BundleCore::local, excluded[1]) && (excluded[1] < slots)) saved[1] = _values[excluded[1]];
+			else excluded[1] = slots;
+
 			/**
 			 * Calculate transitive values
 			 */
-			for (predictmap::const_iterator it = dpm._predictmap.begin(); it != dpm._predictmap.end(); ++it)
-			{
-				const dtn::data::EID &host_c = it->first;
-				const float &p_bc = it->second;
+			const float factor = p_ab * _beta;
+			const float *p_bc = &dpm._values[0];
+			float *p_ac = &_values[0];
+			size_t added = 0;
 
-				// do not update values for the origin host
-				if (host_b.sameHost(host_c)) continue;
+			for (size_t i = 0; i < slots; ++i)
+			{
+				const float value = (p_bc[i] >= 0.0f) ? (factor * p_bc[i]) : -1.0f;
+				added += ((p_ac[i] < 0.0f) & (value >= 0.0f));
+				p_ac[i] = (value > p_ac[i]) ? value : p_ac[i];
+			}
 
-				// do not process values with our own EID
-				if (dtn::core::BundleCore::local.sameHost(host_c)) continue;
+			// restore the excluded values
+			for (size_t i = 0; i < 2; ++i)
+			{
+				const size_t slot = excluded[i];
+				if (slot >= slots) continue;
+				if ((saved[i] < 0.0f) && (p_ac[slot] >= 0.0f)) --added;
+				p_ac[slot] = saved[i];
+			}
 
-				predictmap::iterator dp_it;
-				if ((dp_it = _predictmap.find(host_c)) != _predictmap.end()) {
-					dp_it->second = max(dp_it->second, p_ab * p_bc * _beta);
-				} else {
-					_predictmap[host_c] = p_ab * p_bc * _beta;
+			// adopt the node EIDs of new entries
+			if (added > 0)
+			{
+				for (size_t i = 0; i < slots; ++i)
+				{
+					if (p_bc[i] >= 0.0f) _nodes[i] = dpm._nodes[i];
 				}
 			}
+
+			_size += added;
 		}
 
 		void DeliveryPredictabilityMap::age(const float &p_first_threshold)
 		{
-			const dtn::data::Timestamp current_time = dtn::utils::Clock::getMonotonicTimestamp();
+			age(p_first_threshold, dtn::utils::Clock::getMonotonicTimestamp());
+		}
 
+		void DeliveryPredictabilityMap::age(const float &p_first_threshold, const dtn::data::Timestamp &current_time)
+		{
 			// prevent double aging
 			if (current_time <= _lastAgingTime) return;
 
 			const dtn::data::Timestamp k = (current_time - _lastAgingTime) / _time_unit;
+			_lastAgingTime = current_time;
 
-			predictmap::iterator it;
-			for(it = _predictmap.begin(); it != _predictmap.end();)
-			{
-				if(it->first == dtn::core::BundleCore::local)
-				{
-					++it;
-					continue;
-				}
+			const size_t slots = _values.size();
+			if (slots == 0) return;
 
-				it->second *= pow(_gamma, k.get<int>());
+			// do not age the value of our own EID
+			size_t local = slots;
+			float saved = 0.0f;
+			if (__slot(dtn::core::BundleCore::local, local) && (local < slots)) saved = _values[local];
+			else local = slots;
 
-				if(it->second < p_first_threshold)
-				{
-					_predictmap.erase(it++);
-				} else {
-					++it;
-				}
+			const float factor = pow(_gamma, k.get<int>());
+			float *p = &_values[0];
+			size_t removed = 0;
+
+			for (size_t i = 0; i < slots; ++i)
+			{
+				const float value = p[i] * factor;
+				const bool drop = (value < p_first_threshold);
+				removed += (drop & (p[i] >= 0.0f));
+				p[i] = (drop | (p[i] < 0.0f)) ? -1.0f : value;
 			}
 
-			_lastAgingTime = current_time;
+			if (local < slots)
+			{
+				if ((saved >= 0.0f) && (p[local] < 0.0f)) --removed;
+				p[local] = saved;
+			}
+
+			_size -= removed;
 		}
 
 		void DeliveryPredictabilityMap::toString(std::ostream &stream) const
 		{
-			predictmap::const_iterator it;
-			for (it = _predictmap.begin(); it != _predictmap.end(); ++it)
+			for (const_iterator it = begin(); it != end(); ++it)
 			{
-				stream << it->first.getString() << ": " << it->second << std::endl;
+				stream << (*it).getString() << ": " << _values[it._pos] << std::endl;
 			}
 		}
 
@@ -259,12 +383,12 @@ namespace dtn
 			output << absAgingTime;
 
 			// store the number of map entries
-			output << dtn::data::Number(_predictmap.size());
+			output << dtn::data::Number(_size);
 
-			for (predictmap::const_iterator it = _predictmap.begin(); it != _predictmap.end(); ++it)
+			for (const_iterator it = begin(); it != end(); ++it)
 			{
-				const dtn::data::EID &peer = it->first;
-				const float &p_value = it->second;
+				const dtn::data::EID &peer = (*it);
+				const float &p_value = _values[it._pos];
 
 				dtn::data::BundleString peer_entry(peer.getString());
 
@@ -279,7 +403,7 @@ namespace dtn
 		void DeliveryPredictabilityMap::restore(std::istream &input)
 		{
 			// clear the map
-			_predictmap.clear();
+			clear();
 
 			// get a absolute time-stamp
 			dtn::data::Timestamp absAgingTime;
@@ -316,7 +440,7 @@ namespace dtn
 				input.read(static_cast<char*>((char*)&p_value), sizeof(p_value));
 
 				// add entry to the map
-				_predictmap[dtn::data::EID(peer_entry)] = p_value;
+				set(dtn::data::EID(peer_entry), p_value);
 
 				num_entries--;
 			}
@@ -327,28 +451,211 @@ namespace dtn
 			unsigned int hashCode = 0;
 
 #ifdef IBRCOMMON_SUPPORT_SSL
+			std::vector<std::pair<std::string, float> > entries;
+			getEntries(entries);
+
 			ibrcommon::MD5Stream stream;
-			for (predictmap::const_iterator it = _predictmap.begin(); it != _predictmap.end(); ++it) {
-				stream << (*it).first.getString();
+			for (std::vector<std::pair<std::string, float> >::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+				stream << (*it).first;
 			}
 			std::string hash;
 			stream >> hash;
 
 			::memcpy(&hashCode, hash.c_str(), sizeof(unsigned int));
 #else
-			hashCode = _predictmap.size();
+			hashCode = _size;
 #endif
 			return hashCode;
 		}
 
+		void DeliveryPredictabilityMap::getEntries(std::vector<std::pair<std::string, float> > &entries) const
+		{
+			entries.reserve(_size);
+
+			for (const_iterator it = begin(); it != end(); ++it)
+			{
+				entries.push_back(std::make_pair((*it).getString(), _values[it._pos]));
+			}
+
+			std::sort(entries.begin(), entries.end());
+		}
+
 		DeliveryPredictabilityMap::const_iterator DeliveryPredictabilityMap::begin() const
 		{
-			return _predictmap.begin();
+			return const_iterator(*this, 0);
 		}
 
 		DeliveryPredictabilityMap::const_iterator DeliveryPredictabilityMap::end() const
 		{
-			return _predictmap.end();
+			return const_iterator(*this, _values.size());
+		}
+
+		DeliveryPredictabilityMap::const_iterator::const_iterator(const DeliveryPredictabilityMap &map, size_t pos)
+		 : _map(&map), _pos(pos)
+		{
+			// move to the first slot with a value
+			while ((_pos < _map->_values.size()) && (_map->_values[_pos] < 0.0f)) ++_pos;
+		}
+
+		const dtn::data::EID& DeliveryPredictabilityMap::const_iterator::operator*() const
+		{
+			return _map->_nodes[_pos].get();
+		}
+
+		DeliveryPredictabilityMap::const_iterator& DeliveryPredictabilityMap::const_iterator::operator++()
+		{
+			++_pos;
+			while ((_pos < _map->_values.size()) && (_map->_values[_pos] < 0.0f)) ++_pos;
+			return *this;
+		}
+
+		bool DeliveryPredictabilityMap::const_iterator::operator==(const const_iterator &other) const
+		{
+			return _pos == other._pos;
+		}
+
+		bool DeliveryPredictabilityMap::const_iterator::operator!=(const const_iterator &other) const
+		{
+			return _pos != other._pos;
+		}
+
+		const dtn::data::Number CompactPredictabilityMap::identifier = NodeHandshakeItem::COMPACT_PREDICTABILITY_MAP;
+		const float CompactPredictabilityMap::FIXED_POINT_SCALE = 65535.0f;
+
+		CompactPredictabilityMap::CompactPredictabilityMap()
+		{
+		}
+
+		CompactPredictabilityMap::CompactPredictabilityMap(const DeliveryPredictabilityMap &map)
+		 : DeliveryPredictabilityMap(map)
+		{
+		}
+
+		CompactPredictabilityMap::~CompactPredictabilityMap()
+		{
+		}
+
+		const dtn::data::Number& CompactPredictabilityMap::getIdentifier() const
+		{
+			return identifier;
+		}
+
+		dtn::data::Length CompactPredictabilityMap::getLength() const
+		{
+			std::vector<std::pair<std::string, float> > entries;
+			getEntries(entries);
+
+			dtn::data::Length len = data::Number(entries.size()).getLength();
+			const std::string *previous = NULL;
+
+			for (std::vector<std::pair<std::string, float> >::const_iterator it = entries.begin(); it != entries.end(); ++it)
+			{
+				const std::string &eid = (*it).first;
+
+				// length of the prefix shared with the previous EID
+				std::string::size_type prefix = 0;
+				if (previous != NULL)
+				{
+					const std::string::size_type max = std::min(previous->length(), eid.length());
+					while ((prefix < max) && ((*previous)[prefix] == eid[prefix])) ++prefix;
+				}
+
+				const dtn::data::Length suffix = eid.length() - prefix;
+				len += data::Number(prefix).getLength() + data::Number(suffix).getLength() + suffix;
+				len += data::Number(static_cast<size_t>((*it).second * FIXED_POINT_SCALE + 0.5f)).getLength();
+
+				previous = &eid;
+			}
+
+			return len;
+		}
+
+		std::ostream& CompactPredictabilityMap::serialize(std::ostream& stream) const
+		{
+			std::vector<std::pair<std::string, float> > entries;
+			getEntries(entries);
+
+			stream << data::Number(entries.size());
+			const std::string *previous = NULL;
+
+			for (std::vector<std::pair<std::string, float> >::const_iterator it = entries.begin(); it != entries.end(); ++it)
+			{
+				const std::string &eid = (*it).first;
+
+				// length of the prefix shared with the previous EID
+				std::string::size_type prefix = 0;
+				if (previous != NULL)
+				{
+					const std::string::size_type max = std::min(previous->length(), eid.length());
+					while ((prefix < max) && ((*previous)[prefix] == eid[prefix])) ++prefix;
+				}
+
+				stream << data::Number(prefix) << data::Number(eid.length() - prefix);
+				stream.write(eid.c_str() + prefix, eid.length() - prefix);
+				stream << data::Number(static_cast<size_t>((*it).second * FIXED_POINT_SCALE + 0.5f));
+
+				previous = &eid;
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG("CompactPredictabilityMap", 20) << "Serialized with " << entries.size() << " items." << IBRCOMMON_LOGGER_ENDL;
+			return stream;
+		}
+
+		std::istream& CompactPredictabilityMap::deserialize(std::istream& stream)
+		{
+			data::Number map_size;
+			stream >> map_size;
+
+			const size_t count = map_size.get<size_t>();
+			std::string eid;
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				data::Number prefix, suffix, value;
+				stream >> prefix >> suffix;
+
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a compact dp_map.");
+
+				if (suffix.get<size_t>() > MAX_EID_LENGTH)
+					throw dtn::InvalidDataException("Invalid suffix length, while parsing a compact dp_map.");
+
+				if (prefix.get<size_t>() > eid.length())
+					throw dtn::InvalidDataException("Invalid prefix length, while parsing a compact dp_map.");
+
+				// read the remaining characters of the EID
+				std::vector<char> buf(suffix.get<size_t>());
+				if (buf.size() > 0) stream.read(&buf[0], buf.size());
+
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a compact dp_map.");
+
+				eid.erase(prefix.get<size_t>());
+				eid.append(buf.begin(), buf.end());
+
+				if (eid.length() > MAX_EID_LENGTH)
+					throw dtn::InvalidDataException("Invalid EID length, while parsing a compact dp_map.");
+
+				stream >> value;
+
+				if (stream.fail())
+					throw dtn::InvalidDataException("Unexpected end of a compact dp_map.");
+
+				const float f = static_cast<float>(value.get<size_t>()) / FIXED_POINT_SCALE;
+
+				/* check if f is in a proper range */
+				if (f > 1.0f) continue;
+
+				const dtn::data::EID peer(eid);
+
+				if (peer == data::EID())
+					throw dtn::InvalidDataException("EID could not be casted, while parsing a compact dp_map.");
+
+				setReceived(peer, f);
+			}
+
+			IBRCOMMON_LOGGER_DEBUG_TAG("CompactPredictabilityMap", 20) << "Deserialized with " << size() << " items." << IBRCOMMON_LOGGER_ENDL;
+			return stream;
 		}
 	} /* namespace routing */
 } /* namespace dtn */
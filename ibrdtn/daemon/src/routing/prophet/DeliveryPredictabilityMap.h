@@ -11,9 +11,9 @@
 #include "routing/NeighborDataset.h"
 #include "routing/NodeHandshake.h"
 #include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/EIDTable.h>
 #include <ibrcommon/thread/Mutex.h>
-#include <ibrcommon/Iterator.h>
-#include <map>
+#include <vector>
 
 namespace dtn
 {
@@ -24,11 +24,25 @@ namespace dtn
 		 *
 		 * This class can be used as a map from EID to float.
 		 * Also, it can be serialized as a NodeHandshakeItem to be exchanged with neighbors.
+		 *
+		 * The values are kept per node in a dense array indexed by the unique
+		 * number of the interned node EID. Slots without a value are negative.
+		 * Thus, transitive updates and aging run as plain loops over arrays.
 		 */
 		class DeliveryPredictabilityMap : public NeighborDataSetImpl, public NodeHandshakeItem, public ibrcommon::Mutex {
 		public:
 			static const dtn::data::Number identifier;
 
+			/**
+			 * Node EIDs received from neighbors are interned only while the
+			 * process-wide EIDTable holds less entries, since interned EIDs
+			 * are never freed. Entries of other nodes are dropped.
+			 */
+			static const size_t MAX_INTERNED_NODES;
+
+			// longest EID accepted from a neighbor
+			static const size_t MAX_EID_LENGTH;
+
 			DeliveryPredictabilityMap();
 			DeliveryPredictabilityMap(const size_t &time_unit, const float &beta, const float &gamma);
 			virtual ~DeliveryPredictabilityMap();
@@ -48,6 +62,12 @@ namespace dtn
 			};
 
 			float get(const dtn::data::EID &neighbor) const throw (ValueNotFoundException);
+
+			/**
+			 * Returns the value of an interned node EID
+			 */
+			float get(const dtn::data::EIDHandle &node) const throw (ValueNotFoundException);
+
 			void set(const dtn::data::EID &neighbor, float value);
 			void clear();
 			size_t size() const;
@@ -65,6 +85,12 @@ namespace dtn
 			 */
 			void age(const float &p_first_threshold);
 
+			/*!
+			 * Age all entries in the DeliveryPredictabilityMap up to the given time.
+			 * \warning The _deliveryPredictabilityMap has to be locked before calling this function
+			 */
+			void age(const float &p_first_threshold, const dtn::data::Timestamp &current_time);
+
 			/**
 			 * Print out the content as readable text.
 			 */
@@ -88,16 +114,65 @@ namespace dtn
 			unsigned int hashCode() const;
 
 			/**
-			 * Iterator methods and definitions
+			 * Iterates over the EIDs of all nodes with a value
 			 */
-			typedef std::map<dtn::data::EID, float> predictmap;
-			typedef ibrcommon::key_iterator<predictmap> const_iterator;
+			class const_iterator
+			{
+			public:
+				const_iterator(const DeliveryPredictabilityMap &map, size_t pos);
+
+				const dtn::data::EID& operator*() const;
+				const_iterator& operator++();
+				bool operator==(const const_iterator &other) const;
+				bool operator!=(const const_iterator &other) const;
+
+			private:
+				friend class DeliveryPredictabilityMap;
+
+				const DeliveryPredictabilityMap *_map;
+				size_t _pos;
+			};
 
 			const_iterator begin() const;
 			const_iterator end() const;
 
+		protected:
+			/**
+			 * Returns all entries ordered by the EID
+			 */
+			void getEntries(std::vector<std::pair<std::string, float> > &entries) const;
+
+			/**
+			 * Set the value of a node received from a neighbor. The node EID
+			 * is not interned once the EIDTable reached MAX_INTERNED_NODES.
+			 * @return False, if the entry has been dropped.
+			 */
+			bool setReceived(const dtn::data::EID &neighbor, float value);
+
 		private:
-			predictmap _predictmap;
+			/**
+			 * Returns the slot of a node EID, if it has been interned
+			 */
+			static bool __slot(const dtn::data::EID &eid, size_t &slot);
+
+			/**
+			 * Set the value of an interned node EID
+			 */
+			void __set(const dtn::data::EIDHandle &node, float value);
+
+			/**
+			 * Grow the arrays to the given number of slots
+			 */
+			void __resize(size_t slots);
+
+			// the values indexed by the unique number of the node EID
+			std::vector<float> _values;
+
+			// the interned node EID of each slot
+			std::vector<dtn::data::EIDHandle> _nodes;
+
+			// number of slots with a value
+			size_t _size;
 
 			float _beta; ///< Weight of the transitive property of prophet.
 			float _gamma; ///< Determines how quickly predictabilities age.
@@ -106,6 +181,31 @@ namespace dtn
 			size_t _time_unit; ///< time unit to be used in the network
 
 		};
+
+		/*!
+		 * \brief The DeliveryPredictabilityMap with a compact encoding for the node handshake
+		 *
+		 * Entries are sorted and each EID is encoded as the length of the prefix it
+		 * shares with the previous EID followed by the remaining characters. The
+		 * predictability is sent as a 16-bit fixed-point number.
+		 * Peers not knowing this item answer with the plain DeliveryPredictabilityMap.
+		 */
+		class CompactPredictabilityMap : public DeliveryPredictabilityMap {
+		public:
+			static const dtn::data::Number identifier;
+
+			CompactPredictabilityMap();
+			CompactPredictabilityMap(const DeliveryPredictabilityMap &map);
+			virtual ~CompactPredictabilityMap();
+
+			virtual const dtn::data::Number& getIdentifier() const; ///< \see NodeHandshakeItem::getIdentifier
+			virtual dtn::data::Length getLength() const; ///< \see NodeHandshakeItem::getLength
+			virtual std::ostream& serialize(std::ostream& stream) const; ///< \see NodeHandshakeItem::serialize
+			virtual std::istream& deserialize(std::istream& stream); ///< \see NodeHandshakeItem::deserialize
+
+		private:
+			static const float FIXED_POINT_SCALE;
+		};
 	} /* namespace routing */
 } /* namespace dtn */
 #endif /* DELIVERYPREDICTABILITYMAP_H_ */
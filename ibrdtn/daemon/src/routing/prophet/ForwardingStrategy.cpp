@@ -22,7 +22,9 @@ namespace dtn
 
 		bool ForwardingStrategy::neighborDPIsGreater(const DeliveryPredictabilityMap& neighbor_dpm, const dtn::data::EID& destination) const
 		{
-			const dtn::data::EID destnode = destination.getNode();
+			// nodes without an interned EID are not part of any predictability map
+			dtn::data::EIDHandle destnode;
+			if (!dtn::data::EIDHandle::lookup(destination.getNode(), destnode)) return false;
 
 			try {
 				float local_pv = 0.0f;
@@ -53,16 +55,19 @@ namespace dtn
 
 		bool ForwardingStrategy::isBackrouteValid(const DeliveryPredictabilityMap& neighbor_dpm, const dtn::data::EID& source) const
 		{
+			dtn::data::EIDHandle sourcenode;
+			if (!dtn::data::EIDHandle::lookup(source.getNode(), sourcenode)) return false;
+
 			ibrcommon::MutexLock dpm_lock(_prophet_router->_deliveryPredictabilityMap);
 
 			// check if we know a way to the source
 			try {
-				if (_prophet_router->_deliveryPredictabilityMap.get(source.getNode()) > 0.0) return true;
+				if (_prophet_router->_deliveryPredictabilityMap.get(sourcenode) > 0.0) return true;
 			} catch (const dtn::routing::DeliveryPredictabilityMap::ValueNotFoundException&) { }
 
 			// check if the peer know a way to the source
 			try {
-				if (neighbor_dpm.get(source.getNode()) > 0.0) return true;
+				if (neighbor_dpm.get(sourcenode) > 0.0) return true;
 			} catch (const dtn::routing::DeliveryPredictabilityMap::ValueNotFoundException&) { }
 
 			return false;
@@ -88,6 +88,8 @@ namespace dtn
 
 		void ProphetRoutingExtension::requestHandshake(const dtn::data::EID&, NodeHandshake& handshake) const
 		{
+			// request the compact map, peers without support answer with the plain one
+			handshake.addRequest(CompactPredictabilityMap::identifier);
 			handshake.addRequest(DeliveryPredictabilityMap::identifier);
 			handshake.addRequest(AcknowledgementSet::identifier);
 
@@ -97,7 +99,13 @@ namespace dtn
 
 		void ProphetRoutingExtension::responseHandshake(const dtn::data::EID& neighbor, const NodeHandshake& request, NodeHandshake& response)
 		{
-			if (request.hasRequest(DeliveryPredictabilityMap::identifier))
+			if (request.hasRequest(CompactPredictabilityMap::identifier))
+			{
+				ibrcommon::MutexLock l(_deliveryPredictabilityMap);
+				age();
+				response.addItem(new CompactPredictabilityMap(_deliveryPredictabilityMap));
+			}
+			else if (request.hasRequest(DeliveryPredictabilityMap::identifier))
 			{
 				ibrcommon::MutexLock l(_deliveryPredictabilityMap);
 				age();
@@ -116,7 +124,7 @@ namespace dtn
 			if (neighbor.sameHost(dtn::core::BundleCore::local)) return;
 
 			try {
-				const DeliveryPredictabilityMap& neighbor_dp_map = response.get<DeliveryPredictabilityMap>();
+				const DeliveryPredictabilityMap& neighbor_dp_map = getPredictabilityMap(response);
 
 				// strip possible application part off the neighbor EID
 				const dtn::data::EID neighbor_node = neighbor.getNode();
@@ -620,6 +628,17 @@ namespace dtn
 			}
 		}
 
+		const DeliveryPredictabilityMap& ProphetRoutingExtension::getPredictabilityMap(NodeHandshake& response)
+		{
+			try {
+				return response.get<CompactPredictabilityMap>();
+			} catch (const ibrcommon::Exception&) {
+				// the peer does not support the compact map
+			}
+
+			return response.get<DeliveryPredictabilityMap>();
+		}
+
 		void ProphetRoutingExtension::updateNeighbor(const dtn::data::EID &neighbor, const DeliveryPredictabilityMap& neighbor_dp_map)
 		{
 			// a set where all new endpoints are stored
@@ -111,6 +111,12 @@ namespace dtn
 			virtual void run() throw ();
 			void __cancellation() throw ();
 		private:
+			/*!
+			 * Returns the predictability map of a handshake response, the compact
+			 * map is preferred over the plain one.
+			 */
+			static const DeliveryPredictabilityMap& getPredictabilityMap(NodeHandshake& response);
+
 			/*!
 			 * Updates the DeliveryPredictabilityMap in the event that a neighbor has been encountered.
 			 * \warning The _deliveryPredictabilityMap has to be locked before calling this function
@@ -24,6 +24,7 @@
 #include "security/SecurityKeyManager.h"
 #include <ibrdtn/data/DTNTime.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <sstream>
 #include <iomanip>
 #include <fstream>
@@ -53,10 +54,33 @@ namespace dtn
 		{
 		}
 
+		SecurityKeyManager::CachedKey::CachedKey()
+		 : key_mtime(0), meta_mtime(0)
+		{
+		}
+
+		SecurityKeyManager::CachedKey::CachedKey(const dtn::security::SecurityKey &k, const time_t kmt, const time_t mmt)
+		 : key(k), key_mtime(kmt), meta_mtime(mmt)
+		{
+		}
+
+		SecurityKeyManager::CachedKey::~CachedKey()
+		{
+		}
+
+		void SecurityKeyManager::invalidate() const
+		{
+			ibrcommon::MutexLock l(_cache_lock);
+			_cache.clear();
+		}
+
 		void SecurityKeyManager::onConfigurationChanged(const dtn::daemon::Configuration &conf) throw ()
 		{
 			const dtn::daemon::Configuration::Security &sec = conf.getSecurity();
 
+			// the key path may have changed
+			invalidate();
+
 			if (sec.enabled())
 			{
 				IBRCOMMON_LOGGER_TAG(SecurityKeyManager::TAG, info) << "initialized; path: " << sec.getPath().getPath() << IBRCOMMON_LOGGER_ENDL;
@@ -143,6 +167,9 @@ namespace dtn
 
 			RSA_free(rsa);
 
+			// drop the previous key-pair
+			invalidate();
+
 			// set trust-level to high
 			SecurityKey key = get(ref, SecurityKey::KEY_PUBLIC);
 			key.trustlevel = SecurityKey::HIGH;
@@ -195,12 +222,45 @@ namespace dtn
 				throw SecurityKey::KeyNotFoundException(ss.str());
 			}
 
+			const ibrcommon::File metafile = keydata.getMetaFilename();
+			const time_t key_mtime = keydata.file.lastmodify();
+			const time_t meta_mtime = metafile.exists() ? metafile.lastmodify() : 0;
+
+			// the default shared key is used for several references
+			const std::string id = keydata.file.getPath() + "|" + keydata.reference.getString();
+
+			{
+				ibrcommon::MutexLock l(_cache_lock);
+				key_cache::const_iterator it = _cache.find(id);
+
+				if ((it != _cache.end()) && ((*it).second.key_mtime == key_mtime) && ((*it).second.meta_mtime == meta_mtime))
+				{
+					keydata = (*it).second.key;
+					return;
+				}
+			}
+
 			// load meta-data
-			if (keydata.getMetaFilename().exists())
+			if (meta_mtime > 0)
 			{
-				std::ifstream metastream(keydata.getMetaFilename().getPath().c_str(), std::ios::in);
+				std::ifstream metastream(metafile.getPath().c_str(), std::ios::in);
 				metastream >> keydata;
 			}
+
+			// parse the key once for all further operations
+			if ((keydata.type == SecurityKey::KEY_PUBLIC) || (keydata.type == SecurityKey::KEY_PRIVATE))
+			{
+				try {
+					keydata.setRSA(keydata.getRSA());
+				} catch (const ibrcommon::Exception &ex) {
+					// the key is read from the file on each use
+					IBRCOMMON_LOGGER_TAG(SecurityKeyManager::TAG, warning) << ex.what() << IBRCOMMON_LOGGER_ENDL;
+					return;
+				}
+			}
+
+			ibrcommon::MutexLock l(_cache_lock);
+			_cache[id] = CachedKey(keydata, key_mtime, meta_mtime);
 		}
 
 		void SecurityKeyManager::store(const dtn::security::SecurityKey &key)
@@ -215,6 +275,9 @@ namespace dtn
 
 		void SecurityKeyManager::store(const dtn::security::SecurityKey &key, const std::string &data)
 		{
+			// the stored key replaces cached ones
+			invalidate();
+
 			dtn::security::SecurityKey keydata = key;
 
 			// get the path for the key
@@ -231,6 +294,9 @@ namespace dtn
 
 		void SecurityKeyManager::store(const std::string &prefix, const dtn::security::SecurityKey &key, const std::string &data)
 		{
+			// the stored key replaces cached ones
+			invalidate();
+
 			dtn::security::SecurityKey keydata = key;
 
 			// get the path for the key
@@ -247,6 +313,8 @@ namespace dtn
 
 		void SecurityKeyManager::remove(const SecurityKey &key)
 		{
+			invalidate();
+
 			// remove key file
 			ibrcommon::File keyfile = key.file;
 			keyfile.remove();
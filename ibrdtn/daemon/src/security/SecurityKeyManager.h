@@ -28,7 +28,9 @@
 #include <ibrdtn/data/BundleString.h>
 #include <ibrdtn/data/SDNV.h>
 #include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Mutex.h>
 #include <iostream>
+#include <map>
 
 namespace dtn
 {
@@ -126,13 +128,36 @@ namespace dtn
 			void createRSA(const dtn::data::EID &ref, const int bits = 2048);
 
 			/**
-			 * Load a security key
+			 * Load a security key, the meta-data and the parsed key
+			 * are taken from the cache as long as the files are unchanged
 			 */
 			void load(dtn::security::SecurityKey &key) const;
 
+			/**
+			 * Drop all cached keys
+			 */
+			void invalidate() const;
+
+			class CachedKey
+			{
+			public:
+				CachedKey();
+				CachedKey(const dtn::security::SecurityKey &key, const time_t key_mtime, const time_t meta_mtime);
+				~CachedKey();
+
+				dtn::security::SecurityKey key;
+				time_t key_mtime;
+				time_t meta_mtime;
+			};
+
+			typedef std::map<std::string, CachedKey> key_cache;
+
 			ibrcommon::File _path;
 			ibrcommon::File _ca;
 			ibrcommon::File _key;
+
+			mutable ibrcommon::Mutex _cache_lock;
+			mutable key_cache _cache;
 		};
 	}
 }
@@ -27,6 +27,8 @@
 #include <ibrdtn/security/PayloadIntegrityBlock.h>
 #include <ibrdtn/security/PayloadConfidentialBlock.h>
 #include <ibrdtn/security/ExtensionSecurityBlock.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
 #include <ibrcommon/Logger.h>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
@@ -50,6 +52,30 @@ namespace dtn
 
 		SecurityManager::~SecurityManager()
 		{
+			resetSessions();
+		}
+
+		SecurityManager::Session::Session(const dtn::security::SecurityKey &long_key)
+		 : key(long_key), created(dtn::utils::Clock::getMonotonicTimestamp()), mtime(long_key.file.lastmodify())
+		{
+		}
+
+		SecurityManager::Session::~Session()
+		{
+		}
+
+		void SecurityManager::resetSessions()
+		{
+			ibrcommon::MutexLock l(_session_lock);
+
+			for (session_map::iterator it = _sessions.begin(); it != _sessions.end(); ++it)
+			{
+				delete (*it).second;
+			}
+
+			_sessions.clear();
+
+			_received_keys.clear();
 		}
 
 		void SecurityManager::auth(dtn::data::Bundle &bundle) const throw (KeyMissingException)
@@ -178,7 +204,7 @@ namespace dtn
 				dtn::security::SecurityKey key = SecurityKeyManager::getInstance().get(dtn::core::BundleCore::local, dtn::security::SecurityKey::KEY_PRIVATE);
 
 				// encrypt the payload of the bundle
-				dtn::security::PayloadConfidentialBlock::decrypt(bundle, key);
+				dtn::security::PayloadConfidentialBlock::decrypt(bundle, key, _received_keys);
 
 				bundle.set(dtn::data::PrimaryBlock::DTNSEC_STATUS_CONFIDENTIAL, true);
 			} catch (const ibrcommon::Exception &ex) {
@@ -186,6 +212,52 @@ namespace dtn
 			}
 		}
 
+		const dtn::security::PayloadConfidentialBlock::SessionKey SecurityManager::getSession(const dtn::security::SecurityKey &key, const size_t lifetime) const
+		{
+			const dtn::data::Timestamp now = dtn::utils::Clock::getMonotonicTimestamp();
+			const time_t mtime = key.file.lastmodify();
+
+			ibrcommon::MutexLock l(_session_lock);
+
+			// drop all expired sessions
+			for (session_map::iterator it = _sessions.begin(); it != _sessions.end();)
+			{
+				const Session *s = (*it).second;
+
+				if ((s == NULL) || (s->created.get<size_t>() + lifetime <= now.get<size_t>()))
+				{
+					delete s;
+					_sessions.erase(it++);
+				}
+				else
+				{
+					++it;
+				}
+			}
+
+			Session *&session = _sessions[key.reference];
+
+			// renew expired sessions and sessions of replaced keys
+			if ((session != NULL) && ((session->created.get<size_t>() + lifetime <= now.get<size_t>()) || (session->mtime != mtime)))
+			{
+				delete session;
+				session = NULL;
+			}
+
+			if (session == NULL) session = new Session(key);
+
+			const dtn::security::PayloadConfidentialBlock::SessionKey ret = session->key;
+
+			// do not keep a session key which could not be encrypted
+			if (ret.wrapped.empty())
+			{
+				delete session;
+				session = NULL;
+			}
+
+			return ret;
+		}
+
 		void SecurityManager::encrypt(dtn::data::Bundle &bundle) const throw (EncryptException, KeyMissingException)
 		{
 			try {
@@ -194,8 +266,17 @@ namespace dtn
 				// get the encryption key
 				dtn::security::SecurityKey key = SecurityKeyManager::getInstance().get(bundle.destination, dtn::security::SecurityKey::KEY_PUBLIC);
 
-				// encrypt the payload of the bundle
-				dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, dtn::core::BundleCore::local);
+				const size_t lifetime = dtn::daemon::Configuration::getInstance().getSecurity().getSessionKeyLifetime();
+
+				if (lifetime == 0)
+				{
+					// encrypt the payload of the bundle
+					dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, dtn::core::BundleCore::local);
+					return;
+				}
+
+				// encrypt the payload of the bundle with the session key of the destination
+				dtn::security::PayloadConfidentialBlock::encrypt(bundle, key, dtn::core::BundleCore::local, getSession(key, lifetime));
 			} catch (const ibrcommon::Exception &ex) {
 				throw EncryptException(ex.what());
 			}
@@ -26,6 +26,8 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/security/SecurityBlock.h>
+#include <ibrdtn/security/PayloadConfidentialBlock.h>
+#include <ibrcommon/thread/Mutex.h>
 #include <map>
 
 namespace dtn
@@ -87,6 +89,11 @@ namespace dtn
 				 */
 				void encrypt(dtn::data::Bundle &bundle) const throw (EncryptException, KeyMissingException);
 
+				/**
+				 * Drop all encryption session keys
+				 */
+				void resetSessions();
+
 			protected:
 				/**
 				need a list of nodes, their security blocks type and the key
@@ -97,8 +104,38 @@ namespace dtn
 				virtual ~SecurityManager();
 
 			private:
+				class Session
+				{
+				public:
+					Session(const dtn::security::SecurityKey &long_key);
+					~Session();
+
+					const dtn::security::PayloadConfidentialBlock::SessionKey key;
+
+					// monotonic creation time of the session
+					const dtn::data::Timestamp created;
+
+					// modification time of the key used for the session
+					const time_t mtime;
+				};
+
+				typedef std::map<dtn::data::EID, Session*> session_map;
+
+				/**
+				 * Returns the session key for the owner of the key, a new
+				 * session is created if there is none or it is older than
+				 * the lifetime
+				 */
+				const dtn::security::PayloadConfidentialBlock::SessionKey getSession(const dtn::security::SecurityKey &key, const size_t lifetime) const;
+
 				bool _accept_only_bab;
 				bool _accept_only_pib;
+
+				mutable ibrcommon::Mutex _session_lock;
+				mutable session_map _sessions;
+
+				// session keys of received bundles
+				mutable dtn::security::PayloadConfidentialBlock::KeyCache _received_keys;
 		};
 	}
 }
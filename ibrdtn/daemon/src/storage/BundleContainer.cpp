@@ -0,0 +1,101 @@
+/*
+ * BundleContainer.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/BundleContainer.h"
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+
+namespace dtn
+{
+	namespace storage
+	{
+		BundleContainer::BundleContainer(const dtn::data::Bundle &b)
+		 : _bundle(b)
+		{ }
+
+		BundleContainer::~BundleContainer()
+		{ }
+
+		std::string BundleContainer::getId() const
+		{
+			return createId(_bundle);
+		}
+
+		std::string BundleContainer::createId(const dtn::data::BundleID &id)
+		{
+			std::stringstream ss_hash, ss_raw;
+			ss_raw << id;
+
+			int c = 0xff & ss_raw.get();
+			while (ss_raw.good())
+			{
+				ss_hash << std::hex << std::setw( 2 ) << std::setfill( '0' ) << c;
+				c = 0xff & ss_raw.get();
+			}
+
+			return ss_hash.str();
+		}
+
+		bool BundleContainer::restore(const DataStorage::Hash &hash, DataStorage::istream &stream, dtn::data::Bundle &bundle, dtn::data::Length &length)
+		{
+			// load a bundle into the storage
+			dtn::data::DefaultDeserializer(*stream) >> bundle;
+
+			// the length of the stored bundle
+			length = static_cast<dtn::data::Length>( (*stream).tellg() );
+
+			// check if the hash is different
+			return (hash == DataStorage::Hash(createId(dtn::data::MetaBundle::create(bundle))));
+		}
+
+		std::ostream& BundleContainer::serialize(std::ostream &stream)
+		{
+			// get an serializer for bundles
+			dtn::data::DefaultSerializer s(stream);
+
+			// length of the bundle
+			dtn::data::Length size = s.getLength(_bundle);
+
+			// serialize the bundle
+			s << _bundle; stream.flush();
+
+			// check the streams health
+			if (!stream.good())
+			{
+				std::stringstream ss; ss << "Output stream went bad [" << std::strerror(errno) << "]";
+				throw dtn::SerializationFailedException(ss.str());
+			}
+
+			// get the write position
+			if (static_cast<std::streamoff>(size) > stream.tellp())
+			{
+				std::stringstream ss; ss << "Not all data were written [" << stream.tellp() << " of " << size << " bytes]";
+				throw dtn::SerializationFailedException(ss.str());
+			}
+
+			// return the stream, this allows stacking
+			return stream;
+		}
+	} /* namespace storage */
+} /* namespace dtn */
@@ -0,0 +1,72 @@
+/*
+ * BundleContainer.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BUNDLECONTAINER_H_
+#define BUNDLECONTAINER_H_
+
+#include "storage/DataStorage.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleID.h>
+#include <string>
+#include <iostream>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * Stores a whole bundle in a DataStorage, the bundle ID is
+		 * used as identifier of the stored element
+		 */
+		class BundleContainer : public DataStorage::Container
+		{
+		public:
+			BundleContainer(const dtn::data::Bundle &b);
+			virtual ~BundleContainer();
+
+			/**
+			 * create a unique identifier from the bundle ID
+			 */
+			static std::string createId(const dtn::data::BundleID &id);
+
+			/**
+			 * Read a bundle written by serialize() from the stream
+			 * @param hash the identifier the bundle has been stored with
+			 * @param length is set to the length of the stored bundle
+			 * @return false, if the identifier does not match the bundle
+			 */
+			static bool restore(const DataStorage::Hash &hash, DataStorage::istream &stream, dtn::data::Bundle &bundle, dtn::data::Length &length);
+
+			/**
+			 * get the unique identifier for this bundle container
+			 */
+			std::string getId() const;
+
+			/**
+			 * write the container to a stream object
+			 */
+			std::ostream& serialize(std::ostream &stream);
+
+		private:
+			const dtn::data::Bundle _bundle;
+		};
+	} /* namespace storage */
+} /* namespace dtn */
+
+#endif /* BUNDLECONTAINER_H_ */
@@ -40,6 +40,23 @@ namespace dtn
 		{
 		}
 
+		BundleView BundleStorage::view(const dtn::data::BundleID &id)
+		{
+			BundleView v(*this);
+			v.assign(get(id));
+			return v;
+		}
+
+		bool BundleStorage::hasLazyView() const
+		{
+			return false;
+		}
+
+		void BundleStorage::load(BundleView &view, const dtn::data::block_t)
+		{
+			view.assign(get(view));
+		}
+
 		void BundleStorage::remove(const dtn::data::Bundle &b)
 		{
 			remove(dtn::data::BundleID(b));
@@ -53,6 +70,15 @@ namespace dtn
 			if (meta.custodian == EID())
 				throw ibrcommon::Exception("no previous custodian is set.");
 
+			// collect the signal for an aggregate if possible
+			if (dtn::core::BundleCore::getInstance().getReportAggregator().add(meta, true, CustodySignalBlock::NO_ADDITIONAL_INFORMATION))
+			{
+				// raise the custody accepted event
+				dtn::core::CustodyEvent::raise(meta, dtn::core::CUSTODY_ACCEPT);
+
+				return dtn::core::BundleCore::local;
+			}
+
 			// create a new bundle
 			Bundle custody_bundle;
 
@@ -98,6 +124,14 @@ namespace dtn
 			if (meta.custodian == EID())
 				throw ibrcommon::Exception("no previous custodian is set.");
 
+			// collect the signal for an aggregate if possible
+			if (dtn::core::BundleCore::getInstance().getReportAggregator().add(meta, false, reason))
+			{
+				// raise the custody rejected event
+				dtn::core::CustodyEvent::raise(meta, dtn::core::CUSTODY_REJECT);
+				return;
+			}
+
 			// create a new bundle
 			Bundle b;
 
@@ -25,6 +25,7 @@
 #include <storage/BundleSeeker.h>
 #include <storage/BundleResult.h>
 #include <storage/BundleIndex.h>
+#include <storage/BundleView.h>
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/BundleSet.h>
 #include <ibrdtn/data/BundleID.h>
@@ -89,6 +90,27 @@ namespace dtn
 			 */
 			virtual dtn::data::Bundle get(const dtn::data::BundleID &id) = 0;
 
+			/**
+			 * Returns a view on a specific bundle which contains the primary
+			 * block and the block index only. Other blocks are loaded on demand.
+			 * The default implementation loads the whole bundle.
+			 * @param id The ID of the bundle to return.
+			 * @return A view of the bundle.
+			 */
+			virtual BundleView view(const dtn::data::BundleID &id);
+
+			/**
+			 * Returns true, if view() reads the primary block and the block
+			 * index only. Otherwise a view costs as much as get().
+			 */
+			virtual bool hasLazyView() const;
+
+			/**
+			 * Load all blocks of the given type into the view. This is called
+			 * by the view on the first access of a block type.
+			 */
+			virtual void load(BundleView &view, const dtn::data::block_t type);
+
 			/**
 			 * @see BundleSeeker::get(BundleSelector &cb, BundleResult &result)
 			 */
@@ -0,0 +1,185 @@
+/*
+ * BundleView.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/BundleView.h"
+#include "storage/BundleStorage.h"
+#include <ibrdtn/data/BundleBuilder.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/data/Exceptions.h>
+
+namespace dtn
+{
+	namespace storage
+	{
+		BundleView::BlockInfo::BlockInfo(const dtn::data::block_t t, const dtn::data::Bitset<dtn::data::Block::ProcFlags> &f, const dtn::data::Length &l)
+		 : type(t), procflags(f), length(l)
+		{
+		}
+
+		BundleView::BundleView(BundleStorage &storage)
+		 : _storage(storage), _complete(false), _length(0)
+		{
+		}
+
+		BundleView::~BundleView()
+		{
+		}
+
+		const BundleView::block_index& BundleView::getIndex() const
+		{
+			return _index;
+		}
+
+		bool BundleView::has(const dtn::data::block_t type) const
+		{
+			for (block_index::const_iterator it = _index.begin(); it != _index.end(); ++it)
+			{
+				if ((*it).type == type) return true;
+			}
+			return false;
+		}
+
+		dtn::data::Length BundleView::getLength() const
+		{
+			return _length;
+		}
+
+		dtn::data::Bundle BundleView::load()
+		{
+			return _storage.get(*this);
+		}
+
+		void BundleView::__load(const dtn::data::block_t type)
+		{
+			// do not bother the storage for absent blocks
+			if (has(type)) _storage.load(*this, type);
+			_loaded.insert(type);
+		}
+
+		void BundleView::read(std::istream &stream, const dtn::data::block_t type)
+		{
+			const std::streampos start = stream.tellg();
+			const bool seekable = (start != std::streampos(-1));
+
+			// keep the dictionary of the primary block for EIDs of the loaded blocks
+			dtn::data::DefaultDeserializer d(stream);
+			d >> (dtn::data::PrimaryBlock&)_blocks;
+			(dtn::data::PrimaryBlock&)(*this) = _blocks;
+
+			const bool load = (type != 0) && !_complete && (_loaded.find(type) == _loaded.end());
+
+			dtn::data::BundleBuilder builder(_blocks);
+			_index.clear();
+
+			bool lastblock = false;
+			while (!lastblock)
+			{
+				dtn::data::block_t block_type;
+				dtn::data::Bitset<dtn::data::Block::ProcFlags> procflags;
+
+				stream.get((char&)block_type);
+				stream >> procflags;
+
+				if (!stream.good()) throw dtn::InvalidDataException("Block header is incomplete.");
+
+				lastblock = procflags.getBit(dtn::data::Block::LAST_BLOCK);
+
+				if (load && (block_type == type))
+				{
+					try {
+						dtn::data::Block &block = builder.insert(block_type, procflags);
+						d.read(_blocks, block);
+
+						_index.push_back(BlockInfo(block_type, procflags, block.getLength()));
+						continue;
+					} catch (const dtn::data::BundleBuilder::DiscardBlockException&) {
+						// skip the block like all others
+					}
+				}
+
+				// skip EIDs
+				if (procflags.getBit(dtn::data::Block::BLOCK_CONTAINS_EIDS))
+				{
+					dtn::data::Number eidcount;
+					stream >> eidcount;
+
+					for (unsigned int i = 0; eidcount > i; ++i)
+					{
+						dtn::data::Number scheme, ssp;
+						stream >> scheme;
+						stream >> ssp;
+					}
+				}
+
+				// read the size of the payload in the block
+				dtn::data::Number block_size;
+				stream >> block_size;
+
+				const dtn::data::Length length = block_size.get<dtn::data::Length>();
+
+				// skip the block content without reading it
+				if (seekable)
+				{
+					stream.seekg(static_cast<std::streamoff>(length), std::ios::cur);
+				}
+				else
+				{
+					stream.ignore(static_cast<std::streamsize>(length));
+				}
+
+				_index.push_back(BlockInfo(block_type, procflags, length));
+			}
+
+			if (stream.fail()) throw dtn::InvalidDataException("Bundle is incomplete.");
+
+			if (seekable)
+			{
+				_length = static_cast<dtn::data::Length>(stream.tellg() - start);
+			}
+
+			if (load) _loaded.insert(type);
+		}
+
+		void BundleView::assign(const dtn::data::Bundle &bundle)
+		{
+			(dtn::data::PrimaryBlock&)(*this) = bundle;
+			_blocks = bundle;
+			_complete = true;
+
+			_index.clear();
+			for (dtn::data::Bundle::const_iterator it = bundle.begin(); it != bundle.end(); ++it)
+			{
+				const dtn::data::Block &block = (**it);
+				_index.push_back(BlockInfo(block.getType(), block.getProcessingFlags(), block.getLength()));
+			}
+
+			dtn::data::DefaultSerializer s(std::cout);
+			_length = s.getLength(bundle);
+		}
+
+		void BundleView::addAge(const dtn::data::Number &seconds)
+		{
+			try {
+				dtn::data::AgeBlock &agebl = _blocks.find<dtn::data::AgeBlock>();
+				agebl.addSeconds(seconds);
+			} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { };
+		}
+	} /* namespace storage */
+} /* namespace dtn */
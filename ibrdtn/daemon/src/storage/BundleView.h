@@ -0,0 +1,131 @@
+/*
+ * BundleView.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BUNDLEVIEW_H_
+#define BUNDLEVIEW_H_
+
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/PrimaryBlock.h>
+#include <ibrdtn/data/Block.h>
+#include <ibrdtn/data/Number.h>
+#include <iostream>
+#include <list>
+#include <set>
+
+namespace dtn
+{
+	namespace storage
+	{
+		class BundleStorage;
+
+		/**
+		 * A view on a stored bundle which holds the primary block and an
+		 * index of all other blocks. The content of a block is read out of
+		 * the storage on the first access, thus consumers of meta data
+		 * never load the payload of a bundle.
+		 */
+		class BundleView : public dtn::data::PrimaryBlock
+		{
+		public:
+			class BlockInfo
+			{
+			public:
+				BlockInfo(const dtn::data::block_t type, const dtn::data::Bitset<dtn::data::Block::ProcFlags> &procflags, const dtn::data::Length &length);
+
+				dtn::data::block_t type;
+				dtn::data::Bitset<dtn::data::Block::ProcFlags> procflags;
+				dtn::data::Length length;
+			};
+
+			typedef std::list<BlockInfo> block_index;
+
+			BundleView(BundleStorage &storage);
+			virtual ~BundleView();
+
+			/**
+			 * Returns the type, flags and length of all blocks
+			 * in the order of the serialized bundle.
+			 */
+			const block_index& getIndex() const;
+
+			/**
+			 * Returns true, if the bundle contains a block of the given type.
+			 */
+			bool has(const dtn::data::block_t type) const;
+
+			/**
+			 * Returns the length of the serialized bundle or zero
+			 * if the length is not known.
+			 */
+			dtn::data::Length getLength() const;
+
+			/**
+			 * Returns the first block of the given type. The block is
+			 * loaded from the storage on the first call.
+			 */
+			template<class T>
+			const T& find();
+
+			/**
+			 * Load the whole bundle from the storage
+			 */
+			dtn::data::Bundle load();
+
+			/**
+			 * Read the primary block and the block index of a serialized
+			 * bundle. Only blocks of the given type are deserialized, all
+			 * others are skipped. A type of zero reads the index only.
+			 */
+			void read(std::istream &stream, const dtn::data::block_t type = 0);
+
+			/**
+			 * Take the primary block and all blocks of an already loaded bundle.
+			 */
+			void assign(const dtn::data::Bundle &bundle);
+
+			/**
+			 * Add the given age to a loaded AgeBlock. Used by storages
+			 * to account the time a bundle was held on the disk.
+			 */
+			void addAge(const dtn::data::Number &seconds);
+
+		private:
+			void __load(const dtn::data::block_t type);
+
+			BundleStorage &_storage;
+			dtn::data::Bundle _blocks;
+			std::set<dtn::data::block_t> _loaded;
+			bool _complete;
+			block_index _index;
+			dtn::data::Length _length;
+		};
+
+		template<class T>
+		const T& BundleView::find()
+		{
+			if (!_complete && (_loaded.find(T::BLOCK_TYPE) == _loaded.end()))
+			{
+				__load(T::BLOCK_TYPE);
+			}
+
+			return _blocks.find<T>();
+		}
+	} /* namespace storage */
+} /* namespace dtn */
+#endif /* BUNDLEVIEW_H_ */
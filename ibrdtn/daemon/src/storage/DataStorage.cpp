@@ -24,6 +24,12 @@
 #include <sstream>
 #include <iomanip>
 #include <list>
+#include <map>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <string.h>
 #include <stdlib.h>
@@ -86,8 +92,11 @@ namespace dtn
 		std::istream& DataStorage::istream::operator*()
 		{ return *_stream; }
 
-		DataStorage::DataStorage(Callback &callback, const ibrcommon::File &path, unsigned int write_buffer, bool initialize)
-		 : _callback(callback), _path(path), _tasks(), _store_sem(write_buffer), _store_limited(write_buffer > 0), _faulty(false)
+		const size_t DataStorage::SYNC_GROUP = 64;
+		const size_t DataStorage::SYNC_UNCACHE_SIZE = 1048576;
+
+		DataStorage::DataStorage(Callback &callback, const ibrcommon::File &path, unsigned int write_buffer, bool initialize, unsigned int writers, bool sync)
+		 : _callback(callback), _path(path), _store_sem(write_buffer), _store_limited(write_buffer > 0), _faulty(false), _sync(sync)
 		// limit the number of bundles in the write buffer
 		{
 			// initialize the storage
@@ -110,28 +119,64 @@ namespace dtn
 					ibrcommon::File::createDirectory(_path);
 				}
 			}
+
+			// create at least one slot
+			if (writers == 0) writers = 1;
+
+			for (unsigned int i = 0; i < writers; ++i)
+			{
+				_slots.push_back(new Slot());
+			}
+
+			// additional writers for all slots except the first one
+			for (unsigned int i = 1; i < writers; ++i)
+			{
+				_writers.push_back(new Writer(*this, *_slots[i]));
+			}
 		}
 
 		DataStorage::~DataStorage()
 		{
-			_tasks.abort();
+			for (std::vector<Slot*>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+			{
+				(*it)->tasks.abort();
+			}
+
 			join();
 
+			for (std::vector<Writer*>::iterator it = _writers.begin(); it != _writers.end(); ++it)
+			{
+				(*it)->join();
+				delete (*it);
+			}
+
 			// delete all task objects
-			try {
-				while (true)
-				{
-					Task *t = _tasks.take();
-					delete t;
+			for (std::vector<Slot*>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+			{
+				try {
+					while (true)
+					{
+						Task *t = (*it)->tasks.take();
+						delete t;
+					}
+				} catch (const ibrcommon::QueueUnblockedException&) {
+					// exit
 				}
-			} catch (const ibrcommon::QueueUnblockedException&) {
-				// exit
+
+				delete (*it);
 			}
 		}
 
 		void DataStorage::reset()
 		{
 			JoinableThread::reset();
+
+			for (std::vector<Writer*>::iterator it = _writers.begin(); it != _writers.end(); ++it)
+			{
+				// finalize writers which never has been started
+				(*it)->join();
+				(*it)->reset();
+			}
 		}
 
 		void DataStorage::setFaulty(bool mode)
@@ -139,17 +184,97 @@ namespace dtn
 			_faulty = mode;
 		}
 
+		DataStorage::Slot& DataStorage::__slot(const Hash &hash)
+		{
+			if (_slots.size() == 1) return *_slots[0];
+
+			// FNV-1a hash of the value
+			size_t h = 2166136261u;
+			for (std::string::const_iterator it = hash.value.begin(); it != hash.value.end(); ++it)
+			{
+				h = (h ^ static_cast<unsigned char>(*it)) * 16777619u;
+			}
+
+			return *_slots[h % _slots.size()];
+		}
+
 		void DataStorage::iterateAll()
+		{
+			std::list<ibrcommon::File> files;
+			_path.getFiles(files);
+			__iterate(files);
+		}
+
+		void DataStorage::iterate(const std::set<Hash> &hashes)
+		{
+			std::list<ibrcommon::File> files;
+			for (std::set<Hash>::const_iterator it = hashes.begin(); it != hashes.end(); ++it)
+			{
+				files.push_back(_path.get((*it).value));
+			}
+			__iterate(files);
+		}
+
+		void DataStorage::getHashes(std::set<Hash> &hashes)
 		{
 			std::list<ibrcommon::File> files;
 			_path.getFiles(files);
 
+			for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+			{
+				if (!(*iter).isSystem() && !(*iter).isDirectory())
+				{
+					hashes.insert(DataStorage::Hash(*iter));
+				}
+			}
+		}
+
+		void DataStorage::__iterate(const std::list<ibrcommon::File> &files)
+		{
+			if (_slots.size() == 1)
+			{
+				__iterate(*_slots[0], files);
+				return;
+			}
+
+			// scan the files of each slot in a separate thread
+			std::map<Slot*, Scanner*> scanners;
+			for (std::vector<Slot*>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+			{
+				scanners[*it] = new Scanner(*this, **it);
+			}
+
+			for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
+			{
+				const DataStorage::Hash hash(*iter);
+				scanners[&__slot(hash)]->files.push_back(*iter);
+			}
+
+			for (std::map<Slot*, Scanner*>::iterator it = scanners.begin(); it != scanners.end(); ++it)
+			{
+				try {
+					(*it).second->start();
+				} catch (const ibrcommon::ThreadException&) {
+					// scan the files in this thread
+					__iterate(*(*it).first, (*it).second->files);
+				}
+			}
+
+			for (std::map<Slot*, Scanner*>::iterator it = scanners.begin(); it != scanners.end(); ++it)
+			{
+				(*it).second->join();
+				delete (*it).second;
+			}
+		}
+
+		void DataStorage::__iterate(Slot &slot, const std::list<ibrcommon::File> &files)
+		{
 			for (std::list<ibrcommon::File>::const_iterator iter = files.begin(); iter != files.end(); ++iter)
 			{
 				if (!(*iter).isSystem() && !(*iter).isDirectory())
 				{
 					DataStorage::Hash hash(*iter);
-					DataStorage::istream stream(_global_mutex, *iter);
+					DataStorage::istream stream(slot.lock, *iter);
 
 					_callback.iterateDataStorage(hash, stream);
 				}
@@ -162,7 +287,7 @@ namespace dtn
 			if (_store_limited) _store_sem.wait();
 
 			// put the task into the queue
-			_tasks.push( new StoreDataTask(hash, data) );
+			__slot(hash).tasks.push( new StoreDataTask(hash, data) );
 		}
 
 		const DataStorage::Hash DataStorage::store(DataStorage::Container *data)
@@ -182,31 +307,55 @@ namespace dtn
 				throw DataNotAvailableException("file " + file.getPath() + " not found");
 			}
 
-			return DataStorage::istream(_global_mutex, file);
+			return DataStorage::istream(__slot(hash).lock, file);
 		}
 
 		void DataStorage::remove(const DataStorage::Hash &hash)
 		{
-			_tasks.push( new RemoveDataTask(hash) );
+			__slot(hash).tasks.push( new RemoveDataTask(hash) );
 		}
 
 		void DataStorage::wait()
 		{
-			_tasks.wait(ibrcommon::Queue< Task* >::QUEUE_EMPTY);
+			for (std::vector<Slot*>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+			{
+				(*it)->tasks.wait(ibrcommon::Queue< Task* >::QUEUE_EMPTY);
+			}
 		}
 
 		void DataStorage::__cancellation() throw ()
 		{
-			_tasks.abort();
+			// the queues of the other slots are aborted by their writers
+			_slots[0]->tasks.abort();
 		}
 
 		void DataStorage::run() throw ()
+		{
+			for (std::vector<Writer*>::iterator it = _writers.begin(); it != _writers.end(); ++it)
+			{
+				try {
+					(*it)->start();
+				} catch (const ibrcommon::ThreadException&) {
+					// the writer has been stopped before
+				}
+			}
+
+			__process(*_slots[0]);
+
+			for (std::vector<Writer*>::iterator it = _writers.begin(); it != _writers.end(); ++it)
+			{
+				(*it)->stop();
+				(*it)->join();
+			}
+		}
+
+		void DataStorage::__process(Slot &slot) throw ()
 		{
 			try {
 				while (true)
 				{
-					_tasks.wait(ibrcommon::Queue<Task*>::QUEUE_NOT_EMPTY);
-					Task *t = _tasks.front();
+					slot.tasks.wait(ibrcommon::Queue<Task*>::QUEUE_NOT_EMPTY);
+					Task *t = slot.tasks.front();
 
 					try {
 						StoreDataTask &store = dynamic_cast<StoreDataTask&>(*t);
@@ -215,7 +364,7 @@ namespace dtn
 							ibrcommon::File destination = _path.get(store.hash.value);
 
 							{
-								ibrcommon::MutexLock l(_global_mutex);
+								ibrcommon::MutexLock l(slot.lock);
 								std::ofstream stream(destination.getPath().c_str(), ios::out | ios::binary | ios::trunc);
 
 								// check the streams health
@@ -232,8 +381,16 @@ namespace dtn
 							// release resources
 							if (_store_limited) _store_sem.post();
 
-							// notify the stored item
-							_callback.eventDataStorageStored(store.hash);
+							if (_sync)
+							{
+								// report the stored item after the next sync
+								slot.unsynced.push_back(store.hash);
+							}
+							else
+							{
+								// notify the stored item
+								_callback.eventDataStorageStored(store.hash);
+							}
 						} catch (const ibrcommon::Exception &ex) {
 							// release resources
 							if (_store_limited) _store_sem.post();
@@ -247,10 +404,13 @@ namespace dtn
 					try {
 						RemoveDataTask &remove = dynamic_cast<RemoveDataTask&>(*t);
 
+						// report pending items before they get removed
+						if (!slot.unsynced.empty()) __sync(slot);
+
 						try {
 							ibrcommon::File destination = _path.get(remove.hash.value);
 							{
-								ibrcommon::MutexLock l(_global_mutex);
+								ibrcommon::MutexLock l(slot.lock);
 								if (!destination.exists())
 								{
 									throw DataNotAvailableException();
@@ -265,12 +425,85 @@ namespace dtn
 
 					}
 
+					// sync at the end of a group of tasks, before the last task
+					// is popped to keep wait() blocked until all items are reported
+					if (!slot.unsynced.empty() && ((slot.tasks.size() <= 1) || (slot.unsynced.size() >= SYNC_GROUP)))
+					{
+						__sync(slot);
+					}
+
 					delete t;
-					_tasks.pop();
+					slot.tasks.pop();
 				}
 			} catch (const ibrcommon::QueueUnblockedException&) {
 				// exit
 			}
+
+			// report all remaining items
+			if (!slot.unsynced.empty()) __sync(slot);
+		}
+
+		void DataStorage::__sync(Slot &slot) throw ()
+		{
+			std::list<std::pair<Hash, int> > failed;
+
+			{
+				ibrcommon::MutexLock l(slot.lock);
+
+				for (std::list<Hash>::iterator it = slot.unsynced.begin(); it != slot.unsynced.end();)
+				{
+					const std::string path = _path.get((*it).value).getPath();
+					int fd = ::open(path.c_str(), O_RDONLY);
+
+					if ((fd < 0) || (::fsync(fd) != 0))
+					{
+						failed.push_back(std::make_pair(*it, errno));
+						if (fd >= 0) ::close(fd);
+						slot.unsynced.erase(it++);
+						continue;
+					}
+
+#ifdef POSIX_FADV_DONTNEED
+					// large files are rarely read again, do not keep them in the page cache
+					struct stat st;
+					if ((::fstat(fd, &st) == 0) && (static_cast<size_t>(st.st_size) >= SYNC_UNCACHE_SIZE))
+					{
+						::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+					}
+#endif
+
+					::close(fd);
+					++it;
+				}
+
+				// persist the directory entries of the new files
+				int dfd = ::open(_path.getPath().c_str(), O_RDONLY);
+				if (dfd >= 0)
+				{
+					::fsync(dfd);
+					::close(dfd);
+				}
+			}
+
+			for (std::list<Hash>::const_iterator it = slot.unsynced.begin(); it != slot.unsynced.end(); ++it)
+			{
+				_callback.eventDataStorageStored(*it);
+			}
+			slot.unsynced.clear();
+
+			for (std::list<std::pair<Hash, int> >::const_iterator it = failed.begin(); it != failed.end(); ++it)
+			{
+				const Hash &hash = (*it).first;
+
+				// do not leave incomplete data behind
+				{
+					ibrcommon::MutexLock l(slot.lock);
+					_path.get(hash.value).remove();
+				}
+
+				std::stringstream ss; ss << "unable to sync data [" << std::strerror((*it).second) << "]";
+				_callback.eventDataStorageStoreFailed(hash, ibrcommon::IOException(ss.str()));
+			}
 		}
 
 		DataStorage::Container::~Container() {}
@@ -290,5 +523,52 @@ namespace dtn
 		DataStorage::RemoveDataTask::~RemoveDataTask()
 		{
 		}
+
+		DataStorage::Slot::Slot()
+		{
+		}
+
+		DataStorage::Slot::~Slot()
+		{
+		}
+
+		DataStorage::Writer::Writer(DataStorage &storage, Slot &slot)
+		 : _storage(storage), _slot(slot)
+		{
+		}
+
+		DataStorage::Writer::~Writer()
+		{
+			join();
+		}
+
+		void DataStorage::Writer::run() throw ()
+		{
+			_storage.__process(_slot);
+		}
+
+		void DataStorage::Writer::__cancellation() throw ()
+		{
+			_slot.tasks.abort();
+		}
+
+		DataStorage::Scanner::Scanner(DataStorage &storage, Slot &slot)
+		 : _storage(storage), _slot(slot)
+		{
+		}
+
+		DataStorage::Scanner::~Scanner()
+		{
+			join();
+		}
+
+		void DataStorage::Scanner::run() throw ()
+		{
+			_storage.__iterate(_slot, files);
+		}
+
+		void DataStorage::Scanner::__cancellation() throw ()
+		{
+		}
 	}
 }
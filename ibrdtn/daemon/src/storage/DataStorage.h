@@ -30,6 +30,9 @@
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/thread/Semaphore.h>
 #include <memory>
+#include <vector>
+#include <list>
+#include <set>
 
 #ifndef DATASTORAGE_H_
 #define DATASTORAGE_H_
@@ -94,7 +97,16 @@ namespace dtn
 				virtual void iterateDataStorage(const Hash &hash, DataStorage::istream &stream) = 0;
 			};
 
-			DataStorage(Callback &callback, const ibrcommon::File &path, unsigned int write_buffer = 0, bool initialize = false);
+			/**
+			 * Constructor
+			 * @param callback Receiver of the results of all operations
+			 * @param path Directory of the stored data
+			 * @param write_buffer Maximum number of queued store operations, zero for no limit
+			 * @param initialize Remove all existing data in the directory
+			 * @param writers Number of threads writing to the directory
+			 * @param sync Flush written data to the disk before reporting it as stored
+			 */
+			DataStorage(Callback &callback, const ibrcommon::File &path, unsigned int write_buffer = 0, bool initialize = false, unsigned int writers = 1, bool sync = false);
 			virtual ~DataStorage();
 
 			const Hash store(Container *data);
@@ -109,10 +121,21 @@ namespace dtn
 			void wait();
 
 			/**
-			 * iterate through all the data and call the iterateDataStorage() on each dataset
+			 * iterate through all the data and call the iterateDataStorage() on each dataset,
+			 * with more than one writer the callback is called by concurrent threads
 			 */
 			void iterateAll();
 
+			/**
+			 * iterate through the given datasets only
+			 */
+			void iterate(const std::set<Hash> &hashes);
+
+			/**
+			 * get the hashes of all stored datasets without reading them
+			 */
+			void getHashes(std::set<Hash> &hashes);
+
 			/**
 			 * reset the data storage
 			 */
@@ -158,14 +181,91 @@ namespace dtn
 				const Hash hash;
 			};
 
+			/**
+			 * Each slot processes the tasks of a distinct set of hashes in order.
+			 * The lock of a slot protects the files of its hashes.
+			 */
+			class Slot
+			{
+			public:
+				Slot();
+				~Slot();
+
+				ibrcommon::Queue< Task* > tasks;
+				ibrcommon::Mutex lock;
+
+				// written data waiting for the next sync
+				std::list<Hash> unsynced;
+			};
+
+			class Writer : public ibrcommon::JoinableThread
+			{
+			public:
+				Writer(DataStorage &storage, Slot &slot);
+				virtual ~Writer();
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				DataStorage &_storage;
+				Slot &_slot;
+			};
+
+			class Scanner : public ibrcommon::JoinableThread
+			{
+			public:
+				Scanner(DataStorage &storage, Slot &slot);
+				virtual ~Scanner();
+
+				std::list<ibrcommon::File> files;
+
+			protected:
+				void run() throw ();
+				void __cancellation() throw ();
+
+			private:
+				DataStorage &_storage;
+				Slot &_slot;
+			};
+
+			/**
+			 * Returns the slot responsible for the hash
+			 */
+			Slot& __slot(const Hash &hash);
+
+			/**
+			 * Process the tasks of a slot until the queue is aborted
+			 */
+			void __process(Slot &slot) throw ();
+
+			/**
+			 * Flush all written data of the slot to the disk and
+			 * report it as stored
+			 */
+			void __sync(Slot &slot) throw ();
+
+			void __iterate(const std::list<ibrcommon::File> &files);
+			void __iterate(Slot &slot, const std::list<ibrcommon::File> &files);
+
+			// maximum number of files synced at once
+			static const size_t SYNC_GROUP;
+
+			// files of this size are dropped from the page cache after sync
+			static const size_t SYNC_UNCACHE_SIZE;
+
 			Callback &_callback;
 			ibrcommon::File _path;
-			ibrcommon::Queue< Task* > _tasks;
 			ibrcommon::Semaphore _store_sem;
 			bool _store_limited;
 			bool _faulty;
+			const bool _sync;
 
-			ibrcommon::Mutex _global_mutex;
+			// the first slot is processed by this thread, any
+			// further slot by an additional writer thread
+			std::vector<Slot*> _slots;
+			std::vector<Writer*> _writers;
 		};
 	}
 }
@@ -42,28 +42,36 @@ namespace dtn
 
 		MemoryBundleStorage::~MemoryBundleStorage()
 		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
 		void MemoryBundleStorage::componentUp() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
+			ibrcommon::MutexLock l(_bundleslock);
+			__schedule();
 		}
 
 		void MemoryBundleStorage::componentDown() throw ()
 		{
 			// routine checked for throw() on 15.02.2013
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
-		void MemoryBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		void MemoryBundleStorage::eventDeadline(const dtn::data::Timestamp &now) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				// do expiration of bundles
-				ibrcommon::MutexLock l(_bundleslock);
-				_list.expire(time.getTimestamp());
-			}
+			// do expiration of bundles
+			ibrcommon::MutexLock l(_bundleslock);
+			_list.expire(now);
+			__schedule();
+		}
+
+		void MemoryBundleStorage::__schedule() throw ()
+		{
+			const dtn::data::Timestamp next = _list.getNextExpiration();
+
+			// bundles expire one second after their expiration time
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, (next == 0) ? next : next + 1);
 		}
 
 		const std::string MemoryBundleStorage::getName() const
@@ -184,6 +192,9 @@ namespace dtn
 				_list.add(m);
 				_priority_index.insert(m);
 
+				// move the deadline if this bundle expires first
+				if (m.expiretime == _list.getNextExpiration()) __schedule();
+
 				_bundle_lengths[m] = size;
 
 				// raise bundle added event
@@ -24,7 +24,7 @@
 
 #include "Component.h"
 #include "core/BundleCore.h"
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 #include "storage/BundleStorage.h"
 #include "core/Node.h"
 #include "core/EventReceiver.h"
@@ -36,7 +36,7 @@ namespace dtn
 {
 	namespace storage
 	{
-		class MemoryBundleStorage : public BundleStorage, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IntegratedComponent, public BundleList::Listener
+		class MemoryBundleStorage : public BundleStorage, public dtn::core::DeadlineScheduler::Listener, public dtn::daemon::IntegratedComponent, public BundleList::Listener
 		{
 			static const std::string TAG;
 
@@ -107,10 +107,10 @@ namespace dtn
 			void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
 
 			/**
-			 * This method is used to receive events.
-			 * @param evt
+			 * Expire bundles once the next expiration time is reached
+			 * @see DeadlineScheduler::Listener::eventDeadline()
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
 
 			/**
 			 * @see Component::getName()
@@ -132,6 +132,11 @@ namespace dtn
 
 			void __erase(const bundle_list::iterator &iter);
 
+			/**
+			 * Register the next expiration time as deadline, the lock has to be held
+			 */
+			void __schedule() throw ();
+
 			struct CMP_BUNDLE_PRIORITY
 			{
 				bool operator() (const dtn::data::MetaBundle& lhs, const dtn::data::MetaBundle& rhs) const
@@ -0,0 +1,326 @@
+/*
+ * MetaSnapshot.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/MetaSnapshot.h"
+#include <ibrdtn/data/BundleString.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#include <stdio.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifndef __WIN32__
+#include <sys/mman.h>
+#endif
+
+namespace dtn
+{
+	namespace storage
+	{
+		const size_t MetaSnapshot::JOURNAL_MIN = 10000;
+		const std::string MetaSnapshot::MAGIC = "IBRIDX01";
+
+		/**
+		 * Read-only stream buffer on a memory region
+		 */
+		class MemoryStreamBuffer : public std::streambuf
+		{
+		public:
+			MemoryStreamBuffer(char *data, size_t length)
+			{
+				setg(data, data, data + length);
+			}
+
+			virtual ~MemoryStreamBuffer()
+			{ }
+		};
+
+		MetaSnapshot::MetaSnapshot(const ibrcommon::File &path)
+		 : _path(path), _snapshot(path.get("snapshot")), _journal_file(path.get("journal")), _journal_records(0), _snapshot_records(0)
+		{
+		}
+
+		MetaSnapshot::~MetaSnapshot()
+		{
+			if (_journal.is_open()) _journal.close();
+		}
+
+		bool MetaSnapshot::load(index_map &index)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			if (!_snapshot.exists()) return false;
+
+			bool ret = false;
+
+#ifndef __WIN32__
+			// map the whole snapshot into memory
+			int fd = ::open(_snapshot.getPath().c_str(), O_RDONLY);
+			if (fd < 0) return false;
+
+			struct stat st;
+			if ((::fstat(fd, &st) != 0) || (st.st_size == 0))
+			{
+				::close(fd);
+				return false;
+			}
+
+			void *data = ::mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			::close(fd);
+
+			if (data == MAP_FAILED) return false;
+
+			{
+				MemoryStreamBuffer buf(static_cast<char*>(data), st.st_size);
+				std::istream stream(&buf);
+				ret = __load(stream, index);
+			}
+
+			::munmap(data, st.st_size);
+#else
+			{
+				std::ifstream stream(_snapshot.getPath().c_str(), std::ios::in | std::ios::binary);
+				ret = __load(stream, index);
+			}
+#endif
+
+			if (!ret)
+			{
+				IBRCOMMON_LOGGER_TAG("MetaSnapshot", warning) << "index snapshot " << _snapshot.getPath() << " is invalid" << IBRCOMMON_LOGGER_ENDL;
+				index.clear();
+				return false;
+			}
+
+			// apply the changes since the snapshot
+			if (_journal_file.exists())
+			{
+				std::ifstream stream(_journal_file.getPath().c_str(), std::ios::in | std::ios::binary);
+				__replay(stream, index);
+			}
+
+			return true;
+		}
+
+		void MetaSnapshot::write(const MetaStorage &storage)
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			if (!_path.exists()) ibrcommon::File::createDirectory(_path);
+
+			const ibrcommon::File tmp = _path.get("snapshot.tmp");
+			size_t records = 0;
+
+			{
+				std::ofstream stream(tmp.getPath().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+				// count the bundles to write
+				for (MetaStorage::const_iterator it = storage.begin(); it != storage.end(); ++it)
+				{
+					if (!storage.isRemoved(*it)) ++records;
+				}
+
+				stream << MAGIC << dtn::data::Number(records);
+
+				for (MetaStorage::const_iterator it = storage.begin(); it != storage.end(); ++it)
+				{
+					const dtn::data::MetaBundle &meta = (*it);
+					if (storage.isRemoved(meta)) continue;
+					__write(stream, meta, storage.getSize(meta));
+				}
+
+				// the trailing magic marks a complete snapshot
+				stream << MAGIC;
+				stream.close();
+
+				if (stream.fail())
+				{
+					IBRCOMMON_LOGGER_TAG("MetaSnapshot", error) << "failed to write index snapshot " << tmp.getPath() << IBRCOMMON_LOGGER_ENDL;
+					return;
+				}
+			}
+
+			// replace the previous snapshot
+			if (::rename(tmp.getPath().c_str(), _snapshot.getPath().c_str()) != 0)
+			{
+				IBRCOMMON_LOGGER_TAG("MetaSnapshot", error) << "failed to replace index snapshot " << _snapshot.getPath() << IBRCOMMON_LOGGER_ENDL;
+				return;
+			}
+
+			_snapshot_records = records;
+
+			// start a new journal
+			if (_journal.is_open()) _journal.close();
+			_journal.open(_journal_file.getPath().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+			_journal_records = 0;
+		}
+
+		void MetaSnapshot::add(const dtn::data::MetaBundle &meta, const dtn::data::Length &length)
+		{
+			ibrcommon::MutexLock l(_lock);
+			__open();
+
+			_journal.put('+');
+			__write(_journal, meta, length);
+			_journal.flush();
+
+			++_journal_records;
+		}
+
+		void MetaSnapshot::remove(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_lock);
+			__open();
+
+			_journal.put('-');
+			_journal << id;
+			_journal.flush();
+
+			++_journal_records;
+		}
+
+		bool MetaSnapshot::full() const
+		{
+			return (_journal_records > JOURNAL_MIN) && (_journal_records > _snapshot_records);
+		}
+
+		void MetaSnapshot::__open()
+		{
+			if (_journal.is_open()) return;
+			if (!_path.exists()) ibrcommon::File::createDirectory(_path);
+			_journal.open(_journal_file.getPath().c_str(), std::ios::out | std::ios::binary | std::ios::app);
+		}
+
+		void MetaSnapshot::__write(std::ostream &stream, const dtn::data::MetaBundle &meta, const dtn::data::Length &length)
+		{
+			const int priority = meta.net_priority.get<int>();
+
+			stream << (const dtn::data::BundleID&)meta;
+			stream << dtn::data::Number(meta.getPayloadLength());
+			stream << meta.lifetime;
+			stream << dtn::data::BundleString(meta.destination.getString());
+			stream << dtn::data::BundleString(meta.reportto.getString());
+			stream << dtn::data::BundleString(meta.custodian.getString());
+			stream << meta.appdatalength;
+			stream << meta.procflags;
+			stream << meta.expiretime;
+			stream << meta.hopcount;
+			stream.put((priority < 0) ? 1 : 0);
+			stream << dtn::data::Number((priority < 0) ? -priority : priority);
+			stream << dtn::data::Number(length);
+		}
+
+		void MetaSnapshot::__read(std::istream &stream, dtn::data::MetaBundle &meta, dtn::data::Length &length)
+		{
+			dtn::data::BundleID id;
+			dtn::data::Number payload_length;
+			dtn::data::BundleString destination, reportto, custodian;
+			dtn::data::Number priority, size;
+
+			stream >> id;
+			stream >> payload_length;
+			id.setPayloadLength(payload_length.get<dtn::data::Length>());
+
+			(dtn::data::BundleID&)meta = id;
+
+			stream >> meta.lifetime;
+			stream >> destination; meta.destination = dtn::data::EID(destination);
+			stream >> reportto; meta.reportto = dtn::data::EID(reportto);
+			stream >> custodian; meta.custodian = dtn::data::EID(custodian);
+			stream >> meta.appdatalength;
+			stream >> meta.procflags;
+			stream >> meta.expiretime;
+			stream >> meta.hopcount;
+
+			const int negative = stream.get();
+			stream >> priority;
+			meta.net_priority = (negative == 1) ? -priority.get<int>() : priority.get<int>();
+
+			stream >> size;
+			length = size.get<dtn::data::Length>();
+
+			if (stream.fail()) throw dtn::InvalidDataException("incomplete index record");
+		}
+
+		bool MetaSnapshot::__load(std::istream &stream, index_map &index)
+		{
+			try {
+				char magic[8];
+
+				stream.read(magic, sizeof(magic));
+				if (!stream.good() || (std::string(magic, sizeof(magic)) != MAGIC)) return false;
+
+				dtn::data::Number records;
+				stream >> records;
+
+				for (size_t i = 0; i < records.get<size_t>(); ++i)
+				{
+					dtn::data::MetaBundle meta;
+					dtn::data::Length length = 0;
+					__read(stream, meta, length);
+					index[meta] = length;
+				}
+
+				// check for the trailing magic
+				stream.read(magic, sizeof(magic));
+				if (!stream.good() || (std::string(magic, sizeof(magic)) != MAGIC)) return false;
+			} catch (const std::exception&) {
+				return false;
+			}
+
+			return true;
+		}
+
+		void MetaSnapshot::__replay(std::istream &stream, index_map &index)
+		{
+			try {
+				while (stream.good())
+				{
+					const int op = stream.get();
+
+					if (op == '+')
+					{
+						dtn::data::MetaBundle meta;
+						dtn::data::Length length = 0;
+						__read(stream, meta, length);
+						index[meta] = length;
+					}
+					else if (op == '-')
+					{
+						dtn::data::BundleID id;
+						stream >> id;
+						if (stream.fail()) break;
+						index.erase(dtn::data::MetaBundle::create(id));
+					}
+					else
+					{
+						// end of the journal
+						break;
+					}
+				}
+			} catch (const std::exception&) {
+				// an incomplete record at the end of the journal
+				// is the result of an unclean shutdown
+			}
+		}
+	} /* namespace storage */
+} /* namespace dtn */
@@ -0,0 +1,108 @@
+/*
+ * MetaSnapshot.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef METASNAPSHOT_H_
+#define METASNAPSHOT_H_
+
+#include "storage/MetaStorage.h"
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Mutex.h>
+#include <iostream>
+#include <fstream>
+#include <map>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * Persistent copy of the meta data of a storage. The snapshot
+		 * contains all bundles at the time it was written, all later
+		 * changes are appended to a journal. Loading both on startup
+		 * avoids the deserialization of every stored bundle.
+		 */
+		class MetaSnapshot
+		{
+		public:
+			typedef std::map<dtn::data::MetaBundle, dtn::data::Length> index_map;
+
+			/**
+			 * @param path Directory for the snapshot and the journal
+			 */
+			MetaSnapshot(const ibrcommon::File &path);
+			virtual ~MetaSnapshot();
+
+			/**
+			 * Load the snapshot and apply the journal
+			 * @return False, if there is no valid snapshot
+			 */
+			bool load(index_map &index);
+
+			/**
+			 * Write a snapshot of all bundles in the meta storage
+			 * which are not marked as removed and reset the journal
+			 */
+			void write(const MetaStorage &storage);
+
+			/**
+			 * Add a stored bundle to the journal
+			 */
+			void add(const dtn::data::MetaBundle &meta, const dtn::data::Length &length);
+
+			/**
+			 * Add a removed bundle to the journal
+			 */
+			void remove(const dtn::data::BundleID &id);
+
+			/**
+			 * Returns true, if the journal is larger than the snapshot
+			 * and a new snapshot should be written
+			 */
+			bool full() const;
+
+		private:
+			static void __write(std::ostream &stream, const dtn::data::MetaBundle &meta, const dtn::data::Length &length);
+			static void __read(std::istream &stream, dtn::data::MetaBundle &meta, dtn::data::Length &length);
+
+			static bool __load(std::istream &stream, index_map &index);
+			static void __replay(std::istream &stream, index_map &index);
+
+			/**
+			 * Open the journal for appending, the lock has to be held
+			 */
+			void __open();
+
+			// minimum number of journal records before a new snapshot is due
+			static const size_t JOURNAL_MIN;
+
+			static const std::string MAGIC;
+
+			ibrcommon::Mutex _lock;
+			ibrcommon::File _path;
+			ibrcommon::File _snapshot;
+			ibrcommon::File _journal_file;
+			std::ofstream _journal;
+
+			size_t _journal_records;
+			size_t _snapshot_records;
+		};
+	} /* namespace storage */
+} /* namespace dtn */
+#endif /* METASNAPSHOT_H_ */
@@ -44,6 +44,11 @@ namespace dtn
 			_list.expire(timestamp);
 		}
 
+		dtn::data::Timestamp MetaStorage::getNextExpiration() const throw ()
+		{
+			return _list.getNextExpiration();
+		}
+
 		const dtn::data::MetaBundle& MetaStorage::find(const ibrcommon::BloomFilter &filter) const throw (NoBundleFoundException)
 		{
 			for (const_iterator iter = begin(); iter != end(); ++iter)
@@ -130,6 +135,13 @@ namespace dtn
 			return (_removal_set.find(meta) != _removal_set.end());
 		}
 
+		dtn::data::Length MetaStorage::getSize(const dtn::data::BundleID &id) const throw ()
+		{
+			size_map::const_iterator it = _bundle_lengths.find(id);
+			if (it == _bundle_lengths.end()) return 0;
+			return (*it).second;
+		}
+
 		bool MetaStorage::empty() throw ()
 		{
 			if ( _priority_index.empty() )
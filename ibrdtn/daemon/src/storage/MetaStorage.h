@@ -82,6 +82,12 @@ namespace dtn
 			bool contains(const dtn::data::BundleID &id) const throw ();
 			void expire(const dtn::data::Timestamp &timestamp) throw ();
 
+			/**
+			 * Returns the expiration time of the bundle which expires
+			 * next or zero if there is no bundle.
+			 */
+			dtn::data::Timestamp getNextExpiration() const throw ();
+
 			template<class T>
 			const dtn::data::MetaBundle& find(const T &id) const throw (NoBundleFoundException)
 			{
@@ -115,6 +121,12 @@ namespace dtn
 			 */
 			bool isRemoved(const dtn::data::MetaBundle &meta) const throw ();
 
+			/**
+			 * Returns the number of bytes used by a bundle or zero
+			 * if the bundle is unknown
+			 */
+			dtn::data::Length getSize(const dtn::data::BundleID &id) const throw ();
+
 			/**
 			 * Delete all bundles
 			 */
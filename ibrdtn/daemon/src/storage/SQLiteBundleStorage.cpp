@@ -148,6 +148,8 @@ namespace dtn
 
 		SQLiteBundleStorage::~SQLiteBundleStorage()
 		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
+
 			// stop factory from creating SQLiteBundleSets
 			dtn::data::BundleSet::setFactory(NULL);
 
@@ -196,7 +198,6 @@ namespace dtn
 			// routine checked for throw() on 15.02.2013
 
 			//register Events
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
 			dtn::core::EventDispatcher<dtn::core::GlobalEvent>::add(this);
 
 			try {
@@ -205,6 +206,12 @@ namespace dtn
 			} catch (const SQLiteDatabase::SQLiteQueryException &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
+
+			// register the expiration of the stored bundles
+			{
+				ibrcommon::RWLock l(_global_lock);
+				dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, _database.get_expire_time());
+			}
 		}
 
 		void SQLiteBundleStorage::componentDown() throw ()
@@ -212,8 +219,8 @@ namespace dtn
 			// routine checked for throw() on 15.02.2013
 
 			//unregister Events
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
 			dtn::core::EventDispatcher<dtn::core::GlobalEvent>::remove(this);
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 
 			stop();
 			join();
@@ -442,6 +449,12 @@ namespace dtn
 
 				_database.commit();
 
+				// move the deadline if this bundle expires first
+				if (meta.expiretime == _database.get_expire_time())
+				{
+					dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, meta.expiretime);
+				}
+
 				try {
 					// the bundle is stored sucessfully, we could accept custody if it is requested
 					const dtn::data::EID custodian = acceptCustody(meta);
@@ -541,12 +554,9 @@ namespace dtn
 			return 0;
 		}
 
-		void SQLiteBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		void SQLiteBundleStorage::eventDeadline(const dtn::data::Timestamp &now) throw ()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
-			{
-				_tasks.push(new TaskExpire(time.getTimestamp()));
-			}
+			_tasks.push(new TaskExpire(now));
 		}
 
 		void SQLiteBundleStorage::raiseEvent(const dtn::core::GlobalEvent &global) throw ()
@@ -573,6 +583,9 @@ namespace dtn
 			try {
 				ibrcommon::RWLock l(storage._global_lock);
 				storage._database.expire(_timestamp);
+
+				// register the next expiration
+				dtn::core::BundleCore::getInstance().getScheduler().schedule(storage, storage._database.get_expire_time());
 			} catch (const ibrcommon::Exception &ex) {
 				IBRCOMMON_LOGGER_TAG(SQLiteBundleStorage::TAG, critical) << ex.what() << IBRCOMMON_LOGGER_ENDL;
 			}
@@ -30,7 +30,7 @@
 
 #include "Component.h"
 #include "core/EventReceiver.h"
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 #include "core/GlobalEvent.h"
 #include <ibrdtn/data/MetaBundle.h>
 
@@ -48,7 +48,7 @@ namespace dtn
 {
 	namespace storage
 	{
-		class SQLiteBundleStorage: public BundleStorage, public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IndependentComponent, public ibrcommon::BLOB::Provider, public SQLiteDatabase::DatabaseListener
+		class SQLiteBundleStorage: public BundleStorage, public dtn::core::EventReceiver<dtn::core::GlobalEvent>, public dtn::core::DeadlineScheduler::Listener, public dtn::daemon::IndependentComponent, public ibrcommon::BLOB::Provider, public SQLiteDatabase::DatabaseListener
 		{
 			static const std::string TAG;
 
@@ -139,9 +139,14 @@ namespace dtn
 			 * This method is used to receive events.
 			 * @param evt
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
 			void raiseEvent(const dtn::core::GlobalEvent &evt) throw ();
 
+			/**
+			 * Queue an expiration task once the next bundle expires
+			 * @see DeadlineScheduler::Listener::eventDeadline()
+			 */
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
+
 			/**
 			 * callbacks for the sqlite database
 			 */
@@ -207,6 +207,12 @@ namespace dtn
 			 */
 			void expire(const dtn::data::Timestamp &timestamp) throw ();
 
+			/**
+			 * Returns the time when the next bundle expires or zero
+			 * if there is no bundle.
+			 */
+			const dtn::data::Timestamp& get_expire_time() const throw ();
+
 			/**
 			 * Shrink down the database.
 			 */
@@ -323,7 +329,6 @@ namespace dtn
 			 */
 			void new_expire_time(const dtn::data::Timestamp &ttl) throw ();
 			void reset_expire_time() throw ();
-			const dtn::data::Timestamp& get_expire_time() const throw ();
 
 			void set_bundleid(Statement &st, const dtn::data::BundleID &id, int offset = 0) const throw (SQLiteQueryException);
 
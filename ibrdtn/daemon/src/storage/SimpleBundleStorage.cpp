@@ -20,6 +20,7 @@
  */
 
 #include "storage/SimpleBundleStorage.h"
+#include "storage/BundleContainer.h"
 #include "core/EventDispatcher.h"
 #include "core/BundleExpiredEvent.h"
 #include "core/BundleEvent.h"
@@ -45,21 +46,39 @@ namespace dtn
 	{
 		const std::string SimpleBundleStorage::TAG = "SimpleBundleStorage";
 
-		SimpleBundleStorage::SimpleBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length maxsize, const unsigned int buffer_limit)
-		 : BundleStorage(maxsize), _datastore(*this, workdir, buffer_limit), _metastore(this)
+		SimpleBundleStorage::SimpleBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length maxsize, const unsigned int buffer_limit, const unsigned int writers, const bool sync)
+		 : BundleStorage(maxsize), _datastore(*this, workdir, buffer_limit, false, writers, sync), _metastore(this), _snapshot(workdir.get("index"))
 		{
 		}
 
 		SimpleBundleStorage::~SimpleBundleStorage()
 		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
 		}
 
 		void SimpleBundleStorage::eventDataStorageStored(const dtn::storage::DataStorage::Hash &hash)
 		{
 			IBRCOMMON_LOGGER_DEBUG_TAG(SimpleBundleStorage::TAG, 30) << "element successfully stored: " << hash.value << IBRCOMMON_LOGGER_ENDL;
 
-			ibrcommon::RWLock l(_pending_lock);
-			_pending_bundles.erase(hash);
+			dtn::data::MetaBundle meta;
+
+			{
+				ibrcommon::RWLock l(_pending_lock);
+
+				pending_map::iterator it = _pending_bundles.find(hash);
+				if (it == _pending_bundles.end()) return;
+
+				meta = dtn::data::MetaBundle::create((*it).second);
+				_pending_bundles.erase(it);
+			}
+
+			ibrcommon::RWLock l(_meta_lock);
+
+			// bundles removed in the meantime are not added to the index
+			if (!_metastore.contains(meta) || _metastore.isRemoved(meta)) return;
+
+			_snapshot.add(meta, _metastore.getSize(meta));
+			if (_snapshot.full()) _snapshot.write(_metastore);
 		}
 
 		void SimpleBundleStorage::eventDataStorageStoreFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception &ex)
@@ -102,6 +121,9 @@ namespace dtn
 
 				if (it_hash == hash)
 				{
+					_snapshot.remove(meta);
+					if (_snapshot.full()) _snapshot.write(_metastore);
+
 					// remove bundle and decrement the storage size
 					freeSpace( _metastore.remove(meta) );
 
@@ -122,17 +144,10 @@ namespace dtn
 		{
 			try {
 				dtn::data::Bundle bundle;
-				dtn::data::DefaultDeserializer ds(*stream);
+				dtn::data::Length bundle_size = 0;
 
 				// load a bundle into the storage
-				ds >> bundle;
-				
-				// extract meta data
-				const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
-
-				// check if the hash is different
-				DataStorage::Hash hash2(BundleContainer::createId(meta));
-				if (hash != hash2)
+				if (!BundleContainer::restore(hash, stream, bundle, bundle_size))
 				{
 					// if hash does not match, remove old file
 					_datastore.remove(hash);
@@ -143,8 +158,10 @@ namespace dtn
 					return;
 				}
 
+				// extract meta data
+				const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
+
 				// allocate space for the bundle
-				const dtn::data::Length bundle_size = static_cast<dtn::data::Length>( (*stream).tellg() );
 				allocSpace(bundle_size);
 
 				// lock the bundle lists
@@ -153,6 +170,9 @@ namespace dtn
 				// add the bundle to the stored bundles
 				_metastore.store(meta, bundle_size);
 
+				// move the deadline if this bundle expires first
+				if (meta.expiretime == _metastore.getNextExpiration()) __schedule();
+
 				// raise bundle added event
 				eventBundleAdded(meta);
 
@@ -170,16 +190,17 @@ namespace dtn
 		{
 			// routine checked for throw() on 15.02.2013
 
-			// load persistent bundles
-			_datastore.iterateAll();
+			// load the index snapshot or all persistent bundles
+			if (!__restore()) _datastore.iterateAll();
 
 			// some output
 			{
-				ibrcommon::MutexLock l(_meta_lock);
+				ibrcommon::RWLock l(_meta_lock);
 				IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, info) << _metastore.size() << " Bundles restored." << IBRCOMMON_LOGGER_ENDL;
-			}
 
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::add(this);
+				// start with a fresh snapshot of the restored bundles
+				_snapshot.write(_metastore);
+			}
 
 			try {
 				_datastore.start();
@@ -192,7 +213,8 @@ namespace dtn
 		{
 			// routine checked for throw() on 15.02.2013
 
-			dtn::core::EventDispatcher<dtn::core::TimeEvent>::remove(this);
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
+
 			try {
 				_datastore.wait();
 				_datastore.stop();
@@ -203,6 +225,10 @@ namespace dtn
 
 				// clear all data structures
 				ibrcommon::RWLock l(_meta_lock);
+
+				// persist the meta data for the next start
+				_snapshot.write(_metastore);
+
 				_metastore.clear();
 				clearSpace();
 			} catch (const ibrcommon::Exception &ex) {
@@ -210,13 +236,67 @@ namespace dtn
 			}
 		}
 
-		void SimpleBundleStorage::raiseEvent(const dtn::core::TimeEvent &time) throw ()
+		bool SimpleBundleStorage::__restore()
 		{
-			if (time.getAction() == dtn::core::TIME_SECOND_TICK)
+			MetaSnapshot::index_map index;
+			if (!_snapshot.load(index)) return false;
+
+			// files on the disk are authoritative, bundles of the
+			// snapshot without a file are dropped
+			std::set<DataStorage::Hash> files;
+			_datastore.getHashes(files);
+
+			for (MetaSnapshot::index_map::const_iterator it = index.begin(); it != index.end(); ++it)
 			{
+				const dtn::data::MetaBundle &meta = (*it).first;
+				const DataStorage::Hash hash(BundleContainer::createId(meta));
+
+				std::set<DataStorage::Hash>::iterator file = files.find(hash);
+				if (file == files.end()) continue;
+				files.erase(file);
+
+				try {
+					// allocate space for the bundle
+					allocSpace((*it).second);
+				} catch (const StorageSizeExeededException&) {
+					IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, error) << "Unable to restore bundle " << meta.toString() << ", storage is full" << IBRCOMMON_LOGGER_ENDL;
+					_datastore.remove(hash);
+					continue;
+				}
+
 				ibrcommon::RWLock l(_meta_lock);
-				_metastore.expire(time.getTimestamp());
+
+				// add the bundle to the stored bundles
+				_metastore.store(meta, (*it).second);
+
+				// raise bundle added event
+				eventBundleAdded(meta);
 			}
+
+			{
+				ibrcommon::RWLock l(_meta_lock);
+				__schedule();
+			}
+
+			// read the bundles not listed in the snapshot
+			_datastore.iterate(files);
+
+			return true;
+		}
+
+		void SimpleBundleStorage::eventDeadline(const dtn::data::Timestamp &now) throw ()
+		{
+			ibrcommon::RWLock l(_meta_lock);
+			_metastore.expire(now);
+			__schedule();
+		}
+
+		void SimpleBundleStorage::__schedule() throw ()
+		{
+			const dtn::data::Timestamp next = _metastore.getNextExpiration();
+
+			// bundles expire one second after their expiration time
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, (next == 0) ? next : next + 1);
 		}
 
 		const std::string SimpleBundleStorage::getName() const
@@ -340,6 +420,81 @@ namespace dtn
 			throw NoBundleFoundException();
 		}
 
+		BundleView SimpleBundleStorage::view(const dtn::data::BundleID &id)
+		{
+			BundleView v(*this);
+			__read(id, v, 0);
+			return v;
+		}
+
+		bool SimpleBundleStorage::hasLazyView() const
+		{
+			return true;
+		}
+
+		void SimpleBundleStorage::load(BundleView &view, const dtn::data::block_t type)
+		{
+			__read(view, view, type);
+		}
+
+		void SimpleBundleStorage::__read(const dtn::data::BundleID &id, BundleView &view, const dtn::data::block_t type)
+		{
+			try {
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// faulty mechanism for unit-testing
+				if (_faulty) {
+					throw dtn::SerializationFailedException("bundle get failed due to faulty setting");
+				}
+
+				// search for the bundle in the meta storage
+				const dtn::data::MetaBundle &meta = _metastore.find(dtn::data::MetaBundle::create(id));
+
+				// create a hash for the data storage
+				DataStorage::Hash hash(BundleContainer::createId(meta));
+
+				// check pending bundles
+				{
+					ibrcommon::MutexLock l(_pending_lock);
+
+					pending_map::iterator it = _pending_bundles.find(hash);
+
+					if (_pending_bundles.end() != it)
+					{
+						view.assign(it->second);
+						return;
+					}
+				}
+
+				try {
+					DataStorage::istream stream = _datastore.retrieve(hash);
+
+					// read the requested parts of the bundle from file
+					try {
+						view.read(*stream, type);
+					} catch (const std::exception &ex) {
+						throw dtn::SerializationFailedException(ex.what());
+					}
+
+					// modify the AgeBlock with the age of the file
+					if (type == dtn::data::AgeBlock::BLOCK_TYPE)
+					{
+						view.addAge(stream.lastaccess() - stream.lastmodify());
+					}
+				} catch (const DataStorage::DataNotAvailableException &ex) {
+					throw dtn::SerializationFailedException(ex.what());
+				}
+			} catch (const dtn::SerializationFailedException &ex) {
+				// bundle loading failed
+				IBRCOMMON_LOGGER_TAG(SimpleBundleStorage::TAG, error) << "failed to load bundle: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the bundle is broken, delete it
+				remove(id);
+
+				throw BundleStorage::BundleLoadException(ex.what());
+			}
+		}
+
 		const SimpleBundleStorage::eid_set SimpleBundleStorage::getDistinctDestinations()
 		{
 			ibrcommon::MutexLock l(_meta_lock);
@@ -438,6 +593,9 @@ namespace dtn
 
 				// add the new bundles to the meta storage
 				_metastore.store(meta, bundle_size);
+
+				// move the deadline if this bundle expires first
+				if (meta.expiretime == _metastore.getNextExpiration()) __schedule();
 			}
 
 			// put the bundle into the data store
@@ -481,61 +639,5 @@ namespace dtn
 			// raise bundle removed event
 			eventBundleRemoved(b);
 		}
-
-		SimpleBundleStorage::BundleContainer::BundleContainer(const dtn::data::Bundle &b)
-		 : _bundle(b)
-		{ }
-
-		SimpleBundleStorage::BundleContainer::~BundleContainer()
-		{ }
-
-		std::string SimpleBundleStorage::BundleContainer::getId() const
-		{
-			return createId(_bundle);
-		}
-
-		std::string SimpleBundleStorage::BundleContainer::createId(const dtn::data::BundleID &id)
-		{
-			std::stringstream ss_hash, ss_raw;
-			ss_raw << id;
-
-			int c = 0xff & ss_raw.get();
-			while (ss_raw.good())
-			{
-				ss_hash << std::hex << std::setw( 2 ) << std::setfill( '0' ) << c;
-				c = 0xff & ss_raw.get();
-			}
-
-			return ss_hash.str();
-		}
-
-		std::ostream& SimpleBundleStorage::BundleContainer::serialize(std::ostream &stream)
-		{
-			// get an serializer for bundles
-			dtn::data::DefaultSerializer s(stream);
-
-			// length of the bundle
-			dtn::data::Length size = s.getLength(_bundle);
-
-			// serialize the bundle
-			s << _bundle; stream.flush();
-
-			// check the streams health
-			if (!stream.good())
-			{
-				std::stringstream ss; ss << "Output stream went bad [" << std::strerror(errno) << "]";
-				throw dtn::SerializationFailedException(ss.str());
-			}
-
-			// get the write position
-			if (static_cast<std::streamoff>(size) > stream.tellp())
-			{
-				std::stringstream ss; ss << "Not all data were written [" << stream.tellp() << " of " << size << " bytes]";
-				throw dtn::SerializationFailedException(ss.str());
-			}
-
-			// return the stream, this allows stacking
-			return stream;
-		}
 	}
 }
@@ -27,10 +27,11 @@
 #include "storage/BundleStorage.h"
 #include "core/Node.h"
 #include "core/EventReceiver.h"
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 
 #include "storage/DataStorage.h"
 #include "storage/MetaStorage.h"
+#include "storage/MetaSnapshot.h"
 
 #include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/AtomicCounter.h>
@@ -51,7 +52,7 @@ namespace dtn
 		/**
 		 * This storage holds all bundles and fragments in the system memory.
 		 */
-		class SimpleBundleStorage : public DataStorage::Callback, public BundleStorage, public dtn::core::EventReceiver<dtn::core::TimeEvent>, public dtn::daemon::IntegratedComponent, public dtn::data::BundleList::Listener
+		class SimpleBundleStorage : public DataStorage::Callback, public BundleStorage, public dtn::core::DeadlineScheduler::Listener, public dtn::daemon::IntegratedComponent, public dtn::data::BundleList::Listener
 		{
 			static const std::string TAG;
 
@@ -59,7 +60,7 @@ namespace dtn
 			/**
 			 * Constructor
 			 */
-			SimpleBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length maxsize = 0, const unsigned int buffer_limit = 0);
+			SimpleBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length maxsize = 0, const unsigned int buffer_limit = 0, const unsigned int writers = 1, const bool sync = false);
 
 			/**
 			 * Destructor
@@ -91,6 +92,21 @@ namespace dtn
 			 */
 			virtual dtn::data::Bundle get(const dtn::data::BundleID &id);
 
+			/**
+			 * @see BundleStorage::view(const dtn::data::BundleID &id)
+			 */
+			virtual BundleView view(const dtn::data::BundleID &id);
+
+			/**
+			 * @see BundleStorage::hasLazyView()
+			 */
+			virtual bool hasLazyView() const;
+
+			/**
+			 * @see BundleStorage::load(BundleView &view, const dtn::data::block_t type)
+			 */
+			virtual void load(BundleView &view, const dtn::data::block_t type);
+
 			/**
 			 * @see BundleSeeker::get(BundleSelector &cb, BundleResult &result)
 			 */
@@ -129,10 +145,10 @@ namespace dtn
 			void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
 
 			/**
-			 * This method is used to receive events.
-			 * @param evt
+			 * Expire bundles once the next expiration time is reached
+			 * @see DeadlineScheduler::Listener::eventDeadline()
 			 */
-			void raiseEvent(const dtn::core::TimeEvent &evt) throw ();
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
 
 			/**
 			 * @see Component::getName()
@@ -166,34 +182,27 @@ namespace dtn
 			virtual void eventBundleExpired(const dtn::data::MetaBundle &b) throw ();
 
 		private:
-			class BundleContainer : public DataStorage::Container
-			{
-			public:
-				BundleContainer(const dtn::data::Bundle &b);
-				virtual ~BundleContainer();
-
-				/**
-				 * create a unique identifier from the bundle ID
-				 */
-				static std::string createId(const dtn::data::BundleID &id);
-
-				/**
-				 * get the unique identifier for this bundle container
-				 */
-				std::string getId() const;
-
-				/**
-				 * write the container to a stream object
-				 */
-				std::ostream& serialize(std::ostream &stream);
-
-			private:
-				const dtn::data::Bundle _bundle;
-			};
-
 			void __remove(const dtn::data::MetaBundle &meta);
+
+			/**
+			 * Read the primary block, the block index and all blocks of
+			 * the given type of a stored bundle into the view
+			 */
+			void __read(const dtn::data::BundleID &id, BundleView &view, const dtn::data::block_t type);
 			void __store(const dtn::data::Bundle &bundle, const dtn::data::Length &bundle_size);
 
+			/**
+			 * Register the next expiration time as deadline, the meta lock has to be held
+			 */
+			void __schedule() throw ();
+
+			/**
+			 * Restore the meta data from the index snapshot. Only bundles
+			 * missing in the snapshot are read from the disk.
+			 * @return False, if no snapshot is available
+			 */
+			bool __restore();
+
 			typedef std::map<DataStorage::Hash, dtn::data::Bundle> pending_map;
 			ibrcommon::RWMutex _pending_lock;
 			pending_map _pending_bundles;
@@ -204,6 +213,9 @@ namespace dtn
 			// stores all the meta data in memory
 			ibrcommon::RWMutex _meta_lock;
 			MetaStorage _metastore;
+
+			// persistent copy of the meta data
+			MetaSnapshot _snapshot;
 		};
 	}
 }
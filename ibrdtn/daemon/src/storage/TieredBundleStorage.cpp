@@ -0,0 +1,825 @@
+/*
+ * TieredBundleStorage.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "storage/TieredBundleStorage.h"
+#include "storage/BundleContainer.h"
+#include "core/EventDispatcher.h"
+#include "core/BundleExpiredEvent.h"
+#include "core/BundleEvent.h"
+
+#include <ibrdtn/data/AgeBlock.h>
+#include <ibrdtn/utils/Clock.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/Logger.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+
+namespace dtn
+{
+	namespace storage
+	{
+		const std::string TieredBundleStorage::TAG = "TieredBundleStorage";
+
+		TieredBundleStorage::TieredBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length memory_limit, const dtn::data::Length maxsize, const unsigned int buffer_limit, const unsigned int writers, const bool sync)
+		 : BundleStorage(maxsize), _datastore(*this, workdir, buffer_limit, false, writers, sync), _memory_limit(memory_limit), _metastore(this), _snapshot(workdir.get("index")), _memory_size(0), _access(0)
+		{
+		}
+
+		TieredBundleStorage::~TieredBundleStorage()
+		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
+		}
+
+		void TieredBundleStorage::eventDataStorageStored(const dtn::storage::DataStorage::Hash &hash)
+		{
+			IBRCOMMON_LOGGER_DEBUG_TAG(TieredBundleStorage::TAG, 30) << "element successfully stored: " << hash.value << IBRCOMMON_LOGGER_ENDL;
+
+			ibrcommon::MutexLock l(_meta_lock);
+			_pending.erase(hash);
+
+			disk_map::const_iterator d = _on_disk.find(hash);
+			if (d == _on_disk.end()) return;
+
+			// bundles removed in the meantime are not added to the index
+			const dtn::data::MetaBundle &meta = d->second;
+			if (!_metastore.contains(meta) || _metastore.isRemoved(meta)) return;
+
+			_snapshot.add(meta, _metastore.getSize(meta));
+			if (_snapshot.full()) _snapshot.write(_metastore);
+		}
+
+		void TieredBundleStorage::eventDataStorageStoreFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception &ex)
+		{
+			IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "store of element " << hash.value << " failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+			ibrcommon::MutexLock l(_meta_lock);
+
+			pending_map::iterator it = _pending.find(hash);
+			if (it == _pending.end()) return;
+
+			const dtn::data::Bundle bundle = it->second;
+			_pending.erase(it);
+
+			disk_map::iterator d = _on_disk.find(hash);
+			if (d == _on_disk.end()) return;
+
+			// the meta data of removed bundles is released once
+			// the queued removal has been processed
+			if (_metastore.isRemoved(d->second)) return;
+
+			const dtn::data::MetaBundle meta = d->second;
+			_on_disk.erase(d);
+
+			if (!_metastore.contains(meta)) return;
+
+			// keep the only copy of the bundle in memory, even if
+			// this exceeds the memory budget
+			dtn::data::DefaultSerializer s(std::cout);
+			__insert(bundle, s.getLength(bundle));
+		}
+
+		void TieredBundleStorage::eventDataStorageRemoved(const dtn::storage::DataStorage::Hash &hash)
+		{
+			IBRCOMMON_LOGGER_DEBUG_TAG(TieredBundleStorage::TAG, 30) << "element successfully removed: " << hash.value << IBRCOMMON_LOGGER_ENDL;
+
+			ibrcommon::MutexLock l(_meta_lock);
+
+			disk_map::iterator d = _on_disk.find(hash);
+			if (d == _on_disk.end()) return;
+
+			const dtn::data::MetaBundle meta = d->second;
+			_on_disk.erase(d);
+
+			_snapshot.remove(meta);
+			if (_snapshot.full()) _snapshot.write(_metastore);
+
+			// drop a promoted copy
+			__drop(meta);
+
+			// remove bundle and decrement the storage size
+			freeSpace( _metastore.remove(meta) );
+		}
+
+		void TieredBundleStorage::eventDataStorageRemoveFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception &ex)
+		{
+			IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "remove of element " << hash.value << " failed: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+			// forward this to eventDataStorageRemoved
+			eventDataStorageRemoved(hash);
+		}
+
+		void TieredBundleStorage::iterateDataStorage(const dtn::storage::DataStorage::Hash &hash, dtn::storage::DataStorage::istream &stream)
+		{
+			try {
+				dtn::data::Bundle bundle;
+				dtn::data::Length bundle_size = 0;
+
+				// load a bundle into the storage
+				if (!BundleContainer::restore(hash, stream, bundle, bundle_size))
+				{
+					// if hash does not match, remove old file
+					_datastore.remove(hash);
+
+					// and store bundle again
+					store(bundle);
+
+					return;
+				}
+
+				// extract meta data
+				const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
+
+				// allocate space for the bundle
+				allocSpace(bundle_size);
+
+				// lock the bundle lists
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// add the bundle to the stored bundles, the data
+				// remains on disk until it is requested
+				_metastore.store(meta, bundle_size);
+				_on_disk[hash] = meta;
+
+				// move the deadline if this bundle expires first
+				if (meta.expiretime == _metastore.getNextExpiration()) __schedule();
+
+				// raise bundle added event
+				eventBundleAdded(meta);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(TieredBundleStorage::TAG, 10) << "bundle restored " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+			} catch (const std::exception&) {
+				// report this error to the console
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "Unable to restore bundle from file " << hash.value << IBRCOMMON_LOGGER_ENDL;
+
+				// error while reading file
+				_datastore.remove(hash);
+			}
+		}
+
+		void TieredBundleStorage::componentUp() throw ()
+		{
+			// load the index snapshot or all persistent bundles
+			if (!__restore()) _datastore.iterateAll();
+
+			// some output
+			{
+				ibrcommon::MutexLock l(_meta_lock);
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, info) << _metastore.size() << " Bundles restored." << IBRCOMMON_LOGGER_ENDL;
+
+				// start with a fresh snapshot of the restored bundles
+				_snapshot.write(_metastore);
+			}
+
+			try {
+				_datastore.start();
+			} catch (const ibrcommon::ThreadException &ex) {
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		void TieredBundleStorage::componentDown() throw ()
+		{
+			dtn::core::BundleCore::getInstance().getScheduler().cancel(*this);
+
+			try {
+				// write all bundles of the memory tier to disk
+				spill_list spills;
+				{
+					ibrcommon::MutexLock l(_meta_lock);
+					for (memory_map::const_iterator it = _memory.begin(); it != _memory.end(); ++it)
+					{
+						const dtn::data::Bundle &bundle = it->second.bundle;
+						__spill(dtn::data::MetaBundle::create(bundle), bundle, spills);
+					}
+				}
+				__write(spills);
+
+				_datastore.wait();
+				_datastore.stop();
+				_datastore.join();
+
+				// reset datastore
+				_datastore.reset();
+
+				// clear all data structures
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// persist the meta data for the next start
+				_snapshot.write(_metastore);
+
+				_metastore.clear();
+				_memory.clear();
+				_eviction.clear();
+				_memory_size = 0;
+				_on_disk.clear();
+				_pending.clear();
+				_expired.clear();
+				clearSpace();
+			} catch (const ibrcommon::Exception &ex) {
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << ex.what() << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		bool TieredBundleStorage::__restore()
+		{
+			MetaSnapshot::index_map index;
+			if (!_snapshot.load(index)) return false;
+
+			// files on the disk are authoritative, bundles of the
+			// snapshot without a file are dropped
+			std::set<DataStorage::Hash> files;
+			_datastore.getHashes(files);
+
+			for (MetaSnapshot::index_map::const_iterator it = index.begin(); it != index.end(); ++it)
+			{
+				const dtn::data::MetaBundle &meta = (*it).first;
+				const DataStorage::Hash hash(BundleContainer::createId(meta));
+
+				std::set<DataStorage::Hash>::iterator file = files.find(hash);
+				if (file == files.end()) continue;
+				files.erase(file);
+
+				try {
+					// allocate space for the bundle
+					allocSpace((*it).second);
+				} catch (const StorageSizeExeededException&) {
+					IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "Unable to restore bundle " << meta.toString() << ", storage is full" << IBRCOMMON_LOGGER_ENDL;
+					_datastore.remove(hash);
+					continue;
+				}
+
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// add the bundle to the stored bundles, the data
+				// remains on disk until it is requested
+				_metastore.store(meta, (*it).second);
+				_on_disk[hash] = meta;
+
+				// raise bundle added event
+				eventBundleAdded(meta);
+			}
+
+			{
+				ibrcommon::MutexLock l(_meta_lock);
+				__schedule();
+			}
+
+			// read the bundles not listed in the snapshot
+			_datastore.iterate(files);
+
+			return true;
+		}
+
+		void TieredBundleStorage::eventDeadline(const dtn::data::Timestamp &now) throw ()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			_metastore.expire(now);
+
+			// release expired bundles without a copy on disk
+			for (std::list<dtn::data::MetaBundle>::const_iterator it = _expired.begin(); it != _expired.end(); ++it)
+			{
+				freeSpace( _metastore.remove(*it) );
+			}
+			_expired.clear();
+
+			__schedule();
+		}
+
+		void TieredBundleStorage::__schedule() throw ()
+		{
+			const dtn::data::Timestamp next = _metastore.getNextExpiration();
+
+			// bundles expire one second after their expiration time
+			dtn::core::BundleCore::getInstance().getScheduler().schedule(*this, (next == 0) ? next : next + 1);
+		}
+
+		const std::string TieredBundleStorage::getName() const
+		{
+			return TieredBundleStorage::TAG;
+		}
+
+		bool TieredBundleStorage::empty()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			return _metastore.empty();
+		}
+
+		void TieredBundleStorage::releaseCustody(const dtn::data::EID&, const dtn::data::BundleID&)
+		{
+			// custody is successful transferred to another node.
+			// it is safe to delete this bundle now. (depending on the routing algorithm.)
+		}
+
+		dtn::data::Size TieredBundleStorage::count()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			return _metastore.size();
+		}
+
+		void TieredBundleStorage::wait()
+		{
+			_datastore.wait();
+		}
+
+		void TieredBundleStorage::setFaulty(bool mode)
+		{
+			_faulty = mode;
+			_datastore.setFaulty(mode);
+		}
+
+		dtn::data::Length TieredBundleStorage::getMemoryUsage()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			return _memory_size;
+		}
+
+		bool TieredBundleStorage::isResident(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			return (_memory.find(id) != _memory.end());
+		}
+
+		void TieredBundleStorage::get(const BundleSelector &cb, BundleResult &result) throw (NoBundleFoundException, BundleSelectorException)
+		{
+			size_t items_added = 0;
+
+			// we have to iterate through all bundles
+			ibrcommon::MutexLock l(_meta_lock);
+
+			for (MetaStorage::const_iterator iter = _metastore.begin(); (iter != _metastore.end()) && ((cb.limit() == 0) || (items_added < cb.limit())); ++iter)
+			{
+				const dtn::data::MetaBundle &meta = (*iter);
+
+				// skip expired bundles
+				if ( dtn::utils::Clock::isExpired( meta ) ) continue;
+
+				if ( cb.addIfSelected(result, meta) ) items_added++;
+			}
+
+			if (items_added == 0) throw NoBundleFoundException();
+		}
+
+		dtn::data::Bundle TieredBundleStorage::get(const dtn::data::BundleID &id)
+		{
+			spill_list spills;
+			dtn::data::Bundle bundle;
+
+			try {
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// faulty mechanism for unit-testing
+				if (_faulty) {
+					throw dtn::SerializationFailedException("bundle get failed due to faulty setting");
+				}
+
+				// search for the bundle in the meta storage
+				const dtn::data::MetaBundle &meta = _metastore.find(dtn::data::MetaBundle::create(id));
+
+				// check the memory tier first
+				memory_map::iterator it = _memory.find(meta);
+				if (it != _memory.end())
+				{
+					MemoryEntry &entry = it->second;
+
+					// mark the bundle as recently used
+					_eviction.erase(EvictionKey(entry.bundle.getPriority(), entry.access, it->first));
+					entry.access = ++_access;
+					_eviction.insert(EvictionKey(entry.bundle.getPriority(), entry.access, it->first));
+
+					return entry.bundle;
+				}
+
+				// create a hash for the data storage
+				DataStorage::Hash hash(BundleContainer::createId(meta));
+
+				// check bundles queued for writing
+				pending_map::const_iterator pit = _pending.find(hash);
+				if (pit != _pending.end())
+				{
+					return pit->second;
+				}
+
+				try {
+					DataStorage::istream stream = _datastore.retrieve(hash);
+
+					// load the bundle from file
+					try {
+						dtn::data::DefaultDeserializer(*stream) >> bundle;
+					} catch (const std::exception &ex) {
+						throw dtn::SerializationFailedException(ex.what());
+					}
+
+					const dtn::data::Length length = static_cast<dtn::data::Length>( (*stream).tellg() );
+
+					try {
+						dtn::data::AgeBlock &agebl = bundle.find<dtn::data::AgeBlock>();
+
+						// modify the AgeBlock with the age of the file
+						time_t age = stream.lastaccess() - stream.lastmodify();
+
+						agebl.addSeconds(age);
+					} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) { };
+
+					// promote the bundle, the copy on disk is kept
+					// and makes a later eviction free of charge
+					if ((length <= _memory_limit) && !_metastore.isRemoved(meta))
+					{
+						__insert(bundle, length);
+						__evict(spills);
+					}
+				} catch (const DataStorage::DataNotAvailableException &ex) {
+					throw dtn::SerializationFailedException(ex.what());
+				}
+			} catch (const dtn::SerializationFailedException &ex) {
+				// bundle loading failed
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "failed to load bundle: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the bundle is broken, delete it
+				remove(id);
+
+				throw BundleStorage::BundleLoadException(ex.what());
+			}
+
+			__write(spills);
+
+			return bundle;
+		}
+
+		BundleView TieredBundleStorage::view(const dtn::data::BundleID &id)
+		{
+			BundleView v(*this);
+			__read(id, v, 0);
+			return v;
+		}
+
+		bool TieredBundleStorage::hasLazyView() const
+		{
+			return true;
+		}
+
+		void TieredBundleStorage::load(BundleView &view, const dtn::data::block_t type)
+		{
+			__read(view, view, type);
+		}
+
+		void TieredBundleStorage::__read(const dtn::data::BundleID &id, BundleView &view, const dtn::data::block_t type)
+		{
+			try {
+				ibrcommon::MutexLock l(_meta_lock);
+
+				// faulty mechanism for unit-testing
+				if (_faulty) {
+					throw dtn::SerializationFailedException("bundle get failed due to faulty setting");
+				}
+
+				// search for the bundle in the meta storage
+				const dtn::data::MetaBundle &meta = _metastore.find(dtn::data::MetaBundle::create(id));
+
+				// bundles of the memory tier are complete already,
+				// a view does not count as access for the eviction
+				memory_map::const_iterator it = _memory.find(meta);
+				if (it != _memory.end())
+				{
+					view.assign(it->second.bundle);
+					return;
+				}
+
+				// create a hash for the data storage
+				DataStorage::Hash hash(BundleContainer::createId(meta));
+
+				// check bundles queued for writing
+				pending_map::const_iterator pit = _pending.find(hash);
+				if (pit != _pending.end())
+				{
+					view.assign(pit->second);
+					return;
+				}
+
+				try {
+					DataStorage::istream stream = _datastore.retrieve(hash);
+
+					// read the requested parts of the bundle from file,
+					// a view never promotes a bundle into the memory
+					try {
+						view.read(*stream, type);
+					} catch (const std::exception &ex) {
+						throw dtn::SerializationFailedException(ex.what());
+					}
+
+					// modify the AgeBlock with the age of the file
+					if (type == dtn::data::AgeBlock::BLOCK_TYPE)
+					{
+						view.addAge(stream.lastaccess() - stream.lastmodify());
+					}
+				} catch (const DataStorage::DataNotAvailableException &ex) {
+					throw dtn::SerializationFailedException(ex.what());
+				}
+			} catch (const dtn::SerializationFailedException &ex) {
+				// bundle loading failed
+				IBRCOMMON_LOGGER_TAG(TieredBundleStorage::TAG, error) << "failed to load bundle: " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				// the bundle is broken, delete it
+				remove(id);
+
+				throw BundleStorage::BundleLoadException(ex.what());
+			}
+		}
+
+		const TieredBundleStorage::eid_set TieredBundleStorage::getDistinctDestinations()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			return _metastore.getDistinctDestinations();
+		}
+
+		void TieredBundleStorage::store(const dtn::data::Bundle &bundle)
+		{
+			// faulty mechanism for unit-testing
+			if (_faulty) return;
+
+			// get the bundle size
+			dtn::data::DefaultSerializer s(std::cout);
+			const dtn::data::Length bundle_size = s.getLength(bundle);
+
+			// allocate space for the bundle
+			allocSpace(bundle_size);
+
+			// accept custody if requested
+			try {
+				// create meta data object
+				const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
+
+				// accept custody
+				const dtn::data::EID custodian = BundleStorage::acceptCustody(meta);
+
+				// container for the custody accepted bundle
+				dtn::data::Bundle ca_bundle = bundle;
+
+				// set the new custodian
+				ca_bundle.custodian = custodian;
+
+				// store the bundle with the custodian
+				__store(ca_bundle, bundle_size);
+			} catch (const ibrcommon::Exception&) {
+				// no custody has been requested - go on with standard store procedure
+				__store(bundle, bundle_size);
+			}
+		}
+
+		bool TieredBundleStorage::contains(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+
+			// search for the bundle in the meta storage
+			return _metastore.contains(id);
+		}
+
+		dtn::data::MetaBundle TieredBundleStorage::info(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+
+			// search for the bundle in the meta storage
+			return _metastore.find(dtn::data::MetaBundle::create(id));
+		}
+
+		void TieredBundleStorage::remove(const dtn::data::BundleID &id)
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+			const dtn::data::MetaBundle meta = _metastore.find(dtn::data::MetaBundle::create(id));
+
+			// first check if the bundles is already marked as removed
+			if (_metastore.isRemoved(meta)) return;
+
+			// remove if from the meta storage
+			_metastore.markRemoved(meta);
+
+			// raise bundle removed event
+			eventBundleRemoved(meta);
+
+			__remove(meta);
+		}
+
+		void TieredBundleStorage::clear()
+		{
+			ibrcommon::MutexLock l(_meta_lock);
+
+			// copy the meta data, since bundles without a copy
+			// on disk are removed immediately
+			const std::list<dtn::data::MetaBundle> bundles(_metastore.begin(), _metastore.end());
+
+			for (std::list<dtn::data::MetaBundle>::const_iterator iter = bundles.begin(); iter != bundles.end(); ++iter)
+			{
+				const dtn::data::MetaBundle &meta = (*iter);
+
+				// skip bundles with a pending removal
+				if (_metastore.isRemoved(meta)) continue;
+
+				_metastore.markRemoved(meta);
+
+				// raise bundle removed event
+				eventBundleRemoved(meta);
+
+				__remove(meta);
+			}
+		}
+
+		void TieredBundleStorage::eventBundleExpired(const dtn::data::MetaBundle &b) throw ()
+		{
+			// drop the bundle from the memory tier
+			__drop(b);
+
+			DataStorage::Hash hash(BundleContainer::createId(b));
+
+			if (_on_disk.find(hash) != _on_disk.end())
+			{
+				// the meta data is released after the removal on disk
+				_metastore.markRemoved(b);
+
+				// create a background task for removing the bundle
+				_datastore.remove(hash);
+			}
+			else
+			{
+				// release the meta data once the expiration is done
+				_expired.push_back(b);
+			}
+
+			// raise bundle event
+			dtn::core::BundleEvent::raise( b, dtn::core::BUNDLE_DELETED, dtn::data::StatusReportBlock::LIFETIME_EXPIRED);
+
+			// raise an event
+			dtn::core::BundleExpiredEvent::raise( b );
+
+			// raise bundle removed event
+			eventBundleRemoved(b);
+		}
+
+		void TieredBundleStorage::__store(const dtn::data::Bundle &bundle, const dtn::data::Length &bundle_size)
+		{
+			// create meta bundle object
+			const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(bundle);
+
+			spill_list spills;
+
+			// enter critical section - lock all data structures
+			{
+				ibrcommon::MutexLock l(_meta_lock);
+
+				if (_metastore.contains(meta))
+				{
+					// free the previously allocated space
+					freeSpace(bundle_size);
+
+					IBRCOMMON_LOGGER_DEBUG_TAG(TieredBundleStorage::TAG, 5) << "got bundle duplicate " << bundle.toString() << IBRCOMMON_LOGGER_ENDL;
+					return;
+				}
+
+				// add the new bundles to the meta storage
+				_metastore.store(meta, bundle_size);
+
+				// move the deadline if this bundle expires first
+				if (meta.expiretime == _metastore.getNextExpiration()) __schedule();
+
+				if (bundle_size > _memory_limit)
+				{
+					// bundles larger than the memory budget go straight to disk
+					__spill(meta, bundle, spills);
+				}
+				else
+				{
+					__insert(bundle, bundle_size);
+					__evict(spills);
+				}
+			}
+
+			// put spilled bundles into the data store
+			__write(spills);
+
+			// raise bundle added event
+			eventBundleAdded(meta);
+		}
+
+		void TieredBundleStorage::__insert(const dtn::data::Bundle &bundle, const dtn::data::Length &length)
+		{
+			const dtn::data::BundleID id(bundle);
+			const dtn::data::Size access = ++_access;
+
+			_memory.insert(std::make_pair(id, MemoryEntry(bundle, length, access)));
+			_eviction.insert(EvictionKey(bundle.getPriority(), access, id));
+			_memory_size += length;
+		}
+
+		void TieredBundleStorage::__drop(const dtn::data::BundleID &id)
+		{
+			memory_map::iterator it = _memory.find(id);
+			if (it == _memory.end()) return;
+
+			const MemoryEntry &entry = it->second;
+			_eviction.erase(EvictionKey(entry.bundle.getPriority(), entry.access, it->first));
+			_memory_size -= entry.length;
+			_memory.erase(it);
+		}
+
+		bool TieredBundleStorage::__spill(const dtn::data::MetaBundle &meta, const dtn::data::Bundle &bundle, spill_list &spills)
+		{
+			DataStorage::Hash hash(BundleContainer::createId(meta));
+
+			// a clean copy exists already
+			if (_on_disk.find(hash) != _on_disk.end()) return false;
+
+			_on_disk[hash] = meta;
+
+			// keep the bundle accessible until it is written
+			_pending[hash] = bundle;
+			spills.push_back(std::make_pair(hash, bundle));
+
+			return true;
+		}
+
+		void TieredBundleStorage::__evict(spill_list &spills)
+		{
+			while ((_memory_size > _memory_limit) && !_eviction.empty())
+			{
+				const dtn::data::BundleID id = _eviction.begin()->id;
+
+				memory_map::const_iterator it = _memory.find(id);
+				if (it != _memory.end())
+				{
+					const dtn::data::Bundle &bundle = it->second.bundle;
+					__spill(dtn::data::MetaBundle::create(bundle), bundle, spills);
+				}
+
+				__drop(id);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG(TieredBundleStorage::TAG, 40) << "bundle evicted from memory: " << id.toString() << IBRCOMMON_LOGGER_ENDL;
+			}
+		}
+
+		void TieredBundleStorage::__write(spill_list &spills)
+		{
+			for (spill_list::const_iterator it = spills.begin(); it != spills.end(); ++it)
+			{
+				_datastore.store(it->first, new BundleContainer(it->second));
+			}
+			spills.clear();
+		}
+
+		void TieredBundleStorage::__remove(const dtn::data::MetaBundle &meta)
+		{
+			// drop the bundle from the memory tier
+			__drop(meta);
+
+			DataStorage::Hash hash(BundleContainer::createId(meta));
+
+			if (_on_disk.find(hash) != _on_disk.end())
+			{
+				// the meta data is released after the removal on disk
+				_datastore.remove(hash);
+			}
+			else
+			{
+				// remove bundle and decrement the storage size
+				freeSpace( _metastore.remove(meta) );
+			}
+		}
+
+		TieredBundleStorage::EvictionKey::EvictionKey(int p, const dtn::data::Size &a, const dtn::data::BundleID &i)
+		 : priority(p), access(a), id(i)
+		{ }
+
+		TieredBundleStorage::EvictionKey::~EvictionKey()
+		{ }
+
+		bool TieredBundleStorage::EvictionKey::operator<(const EvictionKey &other) const
+		{
+			if (priority != other.priority) return (priority < other.priority);
+			if (access != other.access) return (access < other.access);
+			return (id < other.id);
+		}
+
+		TieredBundleStorage::MemoryEntry::MemoryEntry(const dtn::data::Bundle &b, const dtn::data::Length &l, const dtn::data::Size &a)
+		 : bundle(b), length(l), access(a)
+		{ }
+
+		TieredBundleStorage::MemoryEntry::~MemoryEntry()
+		{ }
+	}
+}
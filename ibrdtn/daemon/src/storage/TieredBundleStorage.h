@@ -0,0 +1,320 @@
+/*
+ * TieredBundleStorage.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef TIEREDBUNDLESTORAGE_H_
+#define TIEREDBUNDLESTORAGE_H_
+
+#include "Component.h"
+#include "core/BundleCore.h"
+#include "storage/BundleStorage.h"
+#include "core/EventReceiver.h"
+#include "core/DeadlineScheduler.h"
+
+#include "storage/DataStorage.h"
+#include "storage/MetaStorage.h"
+#include "storage/MetaSnapshot.h"
+
+#include <ibrcommon/thread/Mutex.h>
+#include <ibrcommon/data/File.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleList.h>
+
+#include <list>
+#include <set>
+#include <map>
+
+namespace dtn
+{
+	namespace storage
+	{
+		/**
+		 * This storage holds the meta data of all bundles and the most
+		 * recently used bundles up to a memory budget in the system memory.
+		 * If the budget is exceeded, bundles of the lowest priority which
+		 * have not been used for the longest time are spilled to the disk.
+		 * Spilled bundles are promoted back to the memory on access.
+		 *
+		 * All bundles are written to the disk on shutdown, thus the content
+		 * of the storage survives a regular restart of the daemon.
+		 */
+		class TieredBundleStorage : public DataStorage::Callback, public BundleStorage, public dtn::core::DeadlineScheduler::Listener, public dtn::daemon::IntegratedComponent, public dtn::data::BundleList::Listener
+		{
+			static const std::string TAG;
+
+		public:
+			/**
+			 * Constructor
+			 * @param workdir Path for the bundles on the disk
+			 * @param memory_limit Number of bytes kept in the memory
+			 * @param maxsize Maximum size of the whole storage
+			 * @param buffer_limit Number of pending write operations
+			 * @param writers Number of threads writing to the disk
+			 * @param sync Flush bundles to the disk before they are reported as stored
+			 */
+			TieredBundleStorage(const ibrcommon::File &workdir, const dtn::data::Length memory_limit, const dtn::data::Length maxsize = 0, const unsigned int buffer_limit = 0, const unsigned int writers = 1, const bool sync = false);
+
+			/**
+			 * Destructor
+			 */
+			virtual ~TieredBundleStorage();
+
+			/**
+			 * Stores a bundle in the storage.
+			 * @param bundle The bundle to store.
+			 */
+			virtual void store(const dtn::data::Bundle &bundle);
+
+			/**
+			 * This method returns true if the requested bundle is
+			 * stored in the storage.
+			 */
+			virtual bool contains(const dtn::data::BundleID &id);
+
+			/**
+			 * Get meta data about a specific bundle ID
+			 */
+			virtual dtn::data::MetaBundle info(const dtn::data::BundleID &id);
+
+			/**
+			 * This method returns a specific bundle which is identified by
+			 * its id. Bundles on the disk are moved into the memory.
+			 * @param id The ID of the bundle to return.
+			 * @return A bundle object of the
+			 */
+			virtual dtn::data::Bundle get(const dtn::data::BundleID &id);
+
+			/**
+			 * @see BundleStorage::view(const dtn::data::BundleID &id)
+			 */
+			virtual BundleView view(const dtn::data::BundleID &id);
+
+			/**
+			 * @see BundleStorage::hasLazyView()
+			 */
+			virtual bool hasLazyView() const;
+
+			/**
+			 * @see BundleStorage::load(BundleView &view, const dtn::data::block_t type)
+			 */
+			virtual void load(BundleView &view, const dtn::data::block_t type);
+
+			/**
+			 * @see BundleSeeker::get(BundleSelector &cb, BundleResult &result)
+			 */
+			virtual void get(const BundleSelector &cb, BundleResult &result) throw (NoBundleFoundException, BundleSelectorException);
+
+			/**
+			 * @see BundleSeeker::getDistinctDestinations()
+			 */
+			virtual const eid_set getDistinctDestinations();
+
+			/**
+			 * This method deletes a specific bundle in the storage.
+			 * No reports will be generated here.
+			 * @param id The ID of the bundle to remove.
+			 */
+			void remove(const dtn::data::BundleID &id);
+
+			/**
+			 * @sa BundleStorage::clear()
+			 */
+			void clear();
+
+			/**
+			 * @sa BundleStorage::empty()
+			 */
+			bool empty();
+
+			/**
+			 * @sa BundleStorage::count()
+			 */
+			dtn::data::Size count();
+
+			/**
+			 * @sa BundleStorage::releaseCustody();
+			 */
+			void releaseCustody(const dtn::data::EID &custodian, const dtn::data::BundleID &id);
+
+			/**
+			 * Expire bundles once the next expiration time is reached
+			 * @see DeadlineScheduler::Listener::eventDeadline()
+			 */
+			void eventDeadline(const dtn::data::Timestamp &now) throw ();
+
+			/**
+			 * @see Component::getName()
+			 */
+			virtual const std::string getName() const;
+
+			virtual void eventDataStorageStored(const dtn::storage::DataStorage::Hash &hash);
+			virtual void eventDataStorageStoreFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception&);
+			virtual void eventDataStorageRemoved(const dtn::storage::DataStorage::Hash &hash);
+			virtual void eventDataStorageRemoveFailed(const dtn::storage::DataStorage::Hash &hash, const ibrcommon::Exception&);
+			virtual void iterateDataStorage(const dtn::storage::DataStorage::Hash &hash, dtn::storage::DataStorage::istream &stream);
+
+			/*** BEGIN: methods for unit-testing ***/
+
+			/**
+			 * Wait until all the data has been stored to the disk
+			 */
+			virtual void wait();
+
+			/**
+			 * Set the storage to faulty. If set to true, each try to store
+			 * or retrieve a bundle will fail.
+			 */
+			virtual void setFaulty(bool mode);
+
+			/**
+			 * Returns the number of bytes held in the memory
+			 */
+			dtn::data::Length getMemoryUsage();
+
+			/**
+			 * Returns true, if the bundle is held in the memory
+			 */
+			bool isResident(const dtn::data::BundleID &id);
+
+			/*** END: methods for unit-testing ***/
+
+		protected:
+			virtual void componentUp() throw ();
+			virtual void componentDown() throw ();
+			virtual void eventBundleExpired(const dtn::data::MetaBundle &b) throw ();
+
+		private:
+			/**
+			 * Order of bundles for the eviction from the memory,
+			 * lowest priority first and least recently used within
+			 * the same priority
+			 */
+			class EvictionKey
+			{
+			public:
+				EvictionKey(int priority, const dtn::data::Size &access, const dtn::data::BundleID &id);
+				~EvictionKey();
+
+				bool operator<(const EvictionKey &other) const;
+
+				int priority;
+				dtn::data::Size access;
+				dtn::data::BundleID id;
+			};
+
+			class MemoryEntry
+			{
+			public:
+				MemoryEntry(const dtn::data::Bundle &b, const dtn::data::Length &length, const dtn::data::Size &access);
+				~MemoryEntry();
+
+				dtn::data::Bundle bundle;
+				dtn::data::Length length;
+				dtn::data::Size access;
+			};
+
+			typedef std::map<dtn::data::BundleID, MemoryEntry> memory_map;
+			typedef std::set<EvictionKey> eviction_set;
+			typedef std::map<DataStorage::Hash, dtn::data::MetaBundle> disk_map;
+			typedef std::map<DataStorage::Hash, dtn::data::Bundle> pending_map;
+			typedef std::list<std::pair<DataStorage::Hash, dtn::data::Bundle> > spill_list;
+
+			void __store(const dtn::data::Bundle &bundle, const dtn::data::Length &bundle_size);
+
+			/**
+			 * Put a bundle into the memory tier, the meta lock has to be held
+			 */
+			void __insert(const dtn::data::Bundle &bundle, const dtn::data::Length &length);
+
+			/**
+			 * Drop a bundle from the memory tier, the meta lock has to be held
+			 */
+			void __drop(const dtn::data::BundleID &id);
+
+			/**
+			 * Move a bundle to the disk tier. Returns false if the disk
+			 * already holds a copy of the bundle. The meta lock has to be held.
+			 */
+			bool __spill(const dtn::data::MetaBundle &meta, const dtn::data::Bundle &bundle, spill_list &spills);
+
+			/**
+			 * Evict bundles until the memory budget is met, the meta lock
+			 * has to be held
+			 */
+			void __evict(spill_list &spills);
+
+			/**
+			 * Hand spilled bundles over to the data storage. This has to
+			 * be done without the meta lock held.
+			 */
+			void __write(spill_list &spills);
+
+			/**
+			 * Delete a bundle from both tiers, the meta lock has to be held
+			 */
+			void __remove(const dtn::data::MetaBundle &meta);
+
+			/**
+			 * Read the primary block, the block index and all blocks of
+			 * the given type of a stored bundle into the view
+			 */
+			void __read(const dtn::data::BundleID &id, BundleView &view, const dtn::data::block_t type);
+
+			/**
+			 * Register the next expiration time as deadline, the meta lock has to be held
+			 */
+			void __schedule() throw ();
+
+			/**
+			 * Restore the meta data from the index snapshot. Only bundles
+			 * missing in the snapshot are read from the disk.
+			 * @return False, if no snapshot is available
+			 */
+			bool __restore();
+
+			// This object manages data stored on disk
+			DataStorage _datastore;
+
+			// maximum number of bytes held in memory
+			const dtn::data::Length _memory_limit;
+
+			// stores all the meta data in memory, the lock protects
+			// the data structures of both tiers
+			ibrcommon::Mutex _meta_lock;
+			MetaStorage _metastore;
+
+			// persistent copy of the meta data
+			MetaSnapshot _snapshot;
+
+			// bundles in the memory tier
+			memory_map _memory;
+			eviction_set _eviction;
+			dtn::data::Length _memory_size;
+			dtn::data::Size _access;
+
+			// bundles with a copy on disk or queued for writing
+			disk_map _on_disk;
+			pending_map _pending;
+
+			// expired bundles without a copy on disk
+			std::list<dtn::data::MetaBundle> _expired;
+		};
+	}
+}
+
+#endif /*TIEREDBUNDLESTORAGE_H_*/
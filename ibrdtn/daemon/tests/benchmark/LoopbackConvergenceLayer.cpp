@@ -0,0 +1,122 @@
+/*
+ * LoopbackConvergenceLayer.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LoopbackConvergenceLayer.h"
+#include "core/BundleCore.h"
+#include "net/ConnectionEvent.h"
+#include "storage/BundleStorage.h"
+#include <ibrdtn/data/Serializer.h>
+#include <streambuf>
+#include <ostream>
+
+/**
+ * Discards all data written to it and counts the bytes
+ */
+class CountingStreamBuffer : public std::streambuf
+{
+public:
+	CountingStreamBuffer() : length(0) { };
+	virtual ~CountingStreamBuffer() { };
+
+	dtn::data::Length length;
+
+protected:
+	virtual int overflow(int c)
+	{
+		if (c != traits_type::eof()) ++length;
+		return traits_type::not_eof(c);
+	}
+
+	virtual std::streamsize xsputn(const char*, std::streamsize n)
+	{
+		length += n;
+		return n;
+	}
+};
+
+LoopbackConvergenceLayer::LoopbackConvergenceLayer(Callback &cb)
+ : _callback(cb)
+{
+}
+
+LoopbackConvergenceLayer::~LoopbackConvergenceLayer()
+{
+	join();
+}
+
+dtn::core::Node::Protocol LoopbackConvergenceLayer::getDiscoveryProtocol() const
+{
+	return dtn::core::Node::CONN_TCPIP;
+}
+
+void LoopbackConvergenceLayer::queue(const dtn::core::Node&, const dtn::net::BundleTransfer &job)
+{
+	_queue.push(job);
+}
+
+void LoopbackConvergenceLayer::connect(const dtn::data::EID &peer)
+{
+	dtn::core::Node n(peer);
+	n.add(dtn::core::Node::URI(dtn::core::Node::NODE_CONNECTED, dtn::core::Node::CONN_TCPIP, "", 0, 10));
+	_peers.push_back(n);
+
+	dtn::core::BundleCore::getInstance().getConnectionManager().add(n);
+	dtn::net::ConnectionEvent::raise(dtn::net::ConnectionEvent::CONNECTION_UP, n);
+}
+
+void LoopbackConvergenceLayer::disconnect()
+{
+	for (std::list<dtn::core::Node>::const_iterator it = _peers.begin(); it != _peers.end(); ++it)
+	{
+		dtn::net::ConnectionEvent::raise(dtn::net::ConnectionEvent::CONNECTION_DOWN, *it);
+		dtn::core::BundleCore::getInstance().getConnectionManager().remove(*it);
+	}
+	_peers.clear();
+}
+
+void LoopbackConvergenceLayer::run() throw ()
+{
+	try {
+		while (true)
+		{
+			dtn::net::BundleTransfer job = _queue.poll();
+
+			try {
+				const dtn::data::Bundle b = dtn::core::BundleCore::getInstance().getStorage().get(job.getBundle());
+
+				// serialize the bundle like a real convergence layer
+				CountingStreamBuffer buf;
+				std::ostream stream(&buf);
+				dtn::data::DefaultSerializer(stream) << b;
+
+				_callback.eventBundleTransmitted(job.getNeighbor(), b, buf.length);
+				job.complete();
+			} catch (const dtn::storage::NoBundleFoundException&) {
+				job.abort(dtn::net::TransferAbortedEvent::REASON_BUNDLE_DELETED);
+			}
+		}
+	} catch (const ibrcommon::QueueUnblockedException&) {
+		// the queue has been aborted
+	}
+}
+
+void LoopbackConvergenceLayer::__cancellation() throw ()
+{
+	_queue.abort();
+}
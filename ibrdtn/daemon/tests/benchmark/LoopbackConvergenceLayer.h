@@ -0,0 +1,80 @@
+/*
+ * LoopbackConvergenceLayer.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef LOOPBACKCONVERGENCELAYER_H_
+#define LOOPBACKCONVERGENCELAYER_H_
+
+#include "net/ConvergenceLayer.h"
+#include "net/BundleTransfer.h"
+#include "core/Node.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Queue.h>
+#include <list>
+
+/**
+ * Emulates neighbors of the node under test within the same process.
+ * Queued bundles are loaded from the storage and serialized into
+ * memory as a real convergence layer would do, then the transfer is
+ * reported as completed. The emulated neighbors are announced with the
+ * TCP protocol, thus the node under test must not run a TCP
+ * convergence layer.
+ */
+class LoopbackConvergenceLayer : public dtn::net::ConvergenceLayer, public ibrcommon::JoinableThread
+{
+public:
+	class Callback
+	{
+	public:
+		virtual ~Callback() { };
+
+		/**
+		 * Called for each bundle received by an emulated neighbor
+		 */
+		virtual void eventBundleTransmitted(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const dtn::data::Length &length) throw () = 0;
+	};
+
+	LoopbackConvergenceLayer(Callback &cb);
+	virtual ~LoopbackConvergenceLayer();
+
+	dtn::core::Node::Protocol getDiscoveryProtocol() const;
+
+	void queue(const dtn::core::Node &n, const dtn::net::BundleTransfer &job);
+
+	/**
+	 * Announce an emulated neighbor to the connection manager
+	 */
+	void connect(const dtn::data::EID &peer);
+
+	/**
+	 * Remove all emulated neighbors
+	 */
+	void disconnect();
+
+protected:
+	void run() throw ();
+	void __cancellation() throw ();
+
+private:
+	Callback &_callback;
+	ibrcommon::Queue<dtn::net::BundleTransfer> _queue;
+	std::list<dtn::core::Node> _peers;
+};
+
+#endif /* LOOPBACKCONVERGENCELAYER_H_ */
@@ -0,0 +1,1098 @@
+/*
+ * Main.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "config.h"
+#include "NativeDaemon.h"
+#include "core/BundleCore.h"
+#include "core/LatencyHistogram.h"
+#include "LoopbackConvergenceLayer.h"
+#include "storage/BundleStorage.h"
+#include "storage/BundleView.h"
+
+#ifdef IBRDTN_SUPPORT_BSP
+#include "security/SecurityManager.h"
+#endif
+
+#include <ibrdtn/api/Client.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/streams/StreamConnection.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/net/socket.h>
+#include <ibrcommon/net/socketstream.h>
+#include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <signal.h>
+
+/**
+ * Runs a node in this process, emulates neighbors with the loopback
+ * convergence layer and drives bundles through the API of the node.
+ * Each combination of storage and routing is measured in a separate
+ * child process, since the daemon core exists only once per process.
+ */
+
+struct Options
+{
+	Options()
+	 : nodes(4), count(1000), size(1024), rate(0), senders(1), local(false), security(false), metadata(false),
+	   goodput(false), workdir("/tmp/ibrdtn-benchmark"), timeout(300)
+	{
+		storages.push_back("memory");
+		storages.push_back("default");
+		storages.push_back("tiered");
+#ifdef HAVE_SQLITE
+		storages.push_back("sqlite");
+#endif
+
+		routings.push_back("default");
+		routings.push_back("epidemic");
+		routings.push_back("flooding");
+		routings.push_back("prophet");
+	}
+
+	unsigned int nodes;
+	unsigned int count;
+	unsigned int size;
+	unsigned int rate;
+	unsigned int senders;
+	bool local;
+	bool security;
+	bool metadata;
+	bool goodput;
+	std::vector<std::string> storages;
+	std::vector<std::string> routings;
+	std::string workdir;
+	unsigned int timeout;
+};
+
+/**
+ * Returns the monotonic time in microseconds
+ */
+static uint64_t now()
+{
+	struct timespec ts;
+	::clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec / 1000);
+}
+
+/**
+ * Returns the consumed cpu time of this process in microseconds
+ */
+static uint64_t cputime()
+{
+	struct rusage ru;
+	::getrusage(RUSAGE_SELF, &ru);
+	return static_cast<uint64_t>(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ULL
+			+ static_cast<uint64_t>(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+}
+
+/**
+ * Returns the number of bytes read by this process
+ */
+static uint64_t bytesread()
+{
+	std::ifstream io("/proc/self/io");
+	std::string key;
+	uint64_t value = 0;
+
+	while (io >> key >> value)
+	{
+		if (key == "rchar:") return value;
+	}
+
+	return 0;
+}
+
+static std::vector<std::string> split(const std::string &value)
+{
+	std::vector<std::string> ret;
+	std::stringstream ss(value);
+	std::string item;
+	while (std::getline(ss, item, ',')) if (item.length() > 0) ret.push_back(item);
+	return ret;
+}
+
+/**
+ * Collects all bundles arriving at the emulated neighbors or the
+ * local application
+ */
+class Sink : public LoopbackConvergenceLayer::Callback
+{
+public:
+	Sink() : delivered(0), transmissions(0), bytes(0), last(0) { };
+	virtual ~Sink() { };
+
+	void eventBundleTransmitted(const dtn::data::EID &peer, const dtn::data::Bundle &bundle, const dtn::data::Length &length) throw ()
+	{
+		ibrcommon::MutexLock l(_cond);
+		++transmissions;
+		bytes += length;
+
+		// count only bundles which reached their destination
+		if (!bundle.destination.sameHost(peer) || (bundle.destination.getApplication() != "bench")) return;
+		__record(bundle);
+	}
+
+	void record(const dtn::data::Bundle &bundle)
+	{
+		ibrcommon::MutexLock l(_cond);
+		__record(bundle);
+	}
+
+	/**
+	 * Wait until the number of bundles are delivered
+	 * @return False, if the timeout has been reached
+	 */
+	bool wait(unsigned int count, unsigned int timeout)
+	{
+		ibrcommon::MutexLock l(_cond);
+		try {
+			while (delivered < count) _cond.wait(timeout * 1000);
+		} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+			return false;
+		}
+		return true;
+	}
+
+	dtn::core::LatencyHistogram latency;
+	unsigned int delivered;
+	unsigned int transmissions;
+	dtn::data::Length bytes;
+	uint64_t last;
+
+private:
+	void __record(const dtn::data::Bundle &bundle)
+	{
+		uint64_t sent = 0;
+
+		try {
+			ibrcommon::BLOB::Reference ref = bundle.find<dtn::data::PayloadBlock>().getBLOB();
+			ibrcommon::BLOB::iostream stream = ref.iostream();
+			(*stream).read(reinterpret_cast<char*>(&sent), sizeof(sent));
+		} catch (const dtn::data::Bundle::NoSuchBlockFoundException&) {
+			return;
+		}
+
+		last = now();
+		latency.record(last - sent);
+		++delivered;
+		_cond.signal(true);
+	}
+
+	ibrcommon::Conditional _cond;
+};
+
+/**
+ * Sends bundles through the API of the node
+ */
+class Sender : public ibrcommon::JoinableThread
+{
+public:
+	Sender(const Options &opt, const ibrcommon::File &socket, unsigned int id, unsigned int count)
+	 : _opt(opt), _socket(socket), _id(id), _count(count), _failed(false)
+	{ }
+
+	virtual ~Sender()
+	{
+		join();
+	}
+
+	bool failed() const
+	{
+		return _failed;
+	}
+
+protected:
+	void run() throw ()
+	{
+		try {
+			ibrcommon::socketstream conn(new ibrcommon::filesocket(_socket));
+
+			std::stringstream app;
+			app << "bench-src-" << _id;
+
+			dtn::api::Client client(app.str(), conn, dtn::api::Client::MODE_SENDONLY);
+			client.connect();
+
+			const std::string filler(_opt.size - sizeof(uint64_t), 'x');
+			const uint64_t start = now();
+
+			for (unsigned int i = 0; i < _count; ++i)
+			{
+				// pace the bundles if a rate is given
+				if (_opt.rate > 0)
+				{
+					const uint64_t due = start + (static_cast<uint64_t>(i) * 1000000ULL) / _opt.rate;
+					const uint64_t t = now();
+					if (due > t) ::usleep(static_cast<useconds_t>(due - t));
+				}
+
+				dtn::data::Bundle b;
+				b.lifetime = 3600;
+
+				std::stringstream dest;
+				if (_opt.local)
+					dest << "dtn://bench-node/bench";
+				else
+					dest << "dtn://bench-peer-" << ((_id + i) % _opt.nodes) << "/bench";
+				b.destination = dtn::data::EID(dest.str());
+
+				ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+				{
+					ibrcommon::BLOB::iostream stream = ref.iostream();
+					const uint64_t placeholder = 0;
+					(*stream).write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+					(*stream) << filler;
+
+					// put the send time in front of the payload
+					const uint64_t sent = now();
+					(*stream).seekp(0);
+					(*stream).write(reinterpret_cast<const char*>(&sent), sizeof(sent));
+				}
+				b.push_back(ref);
+
+				client << b;
+				client.flush();
+			}
+
+			client.close();
+			conn.close();
+		} catch (const std::exception &ex) {
+			std::cerr << "sender " << _id << ": " << ex.what() << std::endl;
+			_failed = true;
+		}
+	}
+
+	void __cancellation() throw ()
+	{
+	}
+
+private:
+	const Options &_opt;
+	const ibrcommon::File _socket;
+	const unsigned int _id;
+	const unsigned int _count;
+	bool _failed;
+};
+
+/**
+ * Receives bundles through the API for the local destination
+ */
+class Receiver : public ibrcommon::JoinableThread
+{
+public:
+	Receiver(Sink &sink, const ibrcommon::File &socket)
+	 : _sink(sink), _conn(new ibrcommon::filesocket(socket)), _client("bench", _conn)
+	{
+		_client.connect();
+	}
+
+	virtual ~Receiver()
+	{
+		join();
+	}
+
+protected:
+	void run() throw ()
+	{
+		try {
+			while (true)
+			{
+				_sink.record(_client.getBundle());
+			}
+		} catch (const std::exception&) {
+			// connection closed
+		}
+	}
+
+	void __cancellation() throw ()
+	{
+		try {
+			_client.close();
+			_conn.close();
+		} catch (const std::exception&) { };
+	}
+
+private:
+	Sink &_sink;
+	ibrcommon::socketstream _conn;
+	dtn::api::Client _client;
+};
+
+static void report(int fd, const std::string &data)
+{
+	if (::write(fd, data.c_str(), data.length()) < 0) { };
+	::close(fd);
+}
+
+/**
+ * Measure one combination of storage and routing. Has to be called in
+ * a separate process and writes the result line to the given descriptor
+ * before the node is shut down.
+ */
+static bool measure(const Options &opt, const std::string &storage, const std::string &routing, int fd)
+{
+	ibrcommon::File workdir = ibrcommon::File(opt.workdir).get(storage + "-" + routing);
+	if (workdir.exists()) workdir.remove(true);
+	ibrcommon::File::createDirectory(workdir);
+
+	const ibrcommon::File socket = workdir.get("api.sock");
+	const ibrcommon::File config = workdir.get("ibrdtnd.conf");
+
+	{
+		std::ofstream conf(config.getPath().c_str());
+		conf << "local_uri = dtn://bench-node" << std::endl;
+		conf << "api_socket = " << socket.getPath() << std::endl;
+		conf << "routing = " << routing << std::endl;
+		conf << "discovery_announce = 0" << std::endl;
+
+		if (storage == "memory") {
+			conf << "storage = default" << std::endl;
+		} else {
+			conf << "storage = " << storage << std::endl;
+			conf << "storage_path = " << workdir.get("storage").getPath() << std::endl;
+		}
+	}
+
+	dtn::daemon::NativeDaemon daemon;
+	daemon.setConfigFile(config.getPath());
+	daemon.init(dtn::daemon::RUNLEVEL_ROUTING_EXTENSIONS);
+
+	Sink sink;
+	LoopbackConvergenceLayer cl(sink);
+	dtn::core::BundleCore::getInstance().getConnectionManager().add(&cl);
+	cl.start();
+
+	for (unsigned int i = 0; i < opt.nodes; ++i)
+	{
+		std::stringstream peer;
+		peer << "dtn://bench-peer-" << i;
+		cl.connect(dtn::data::EID(peer.str()));
+	}
+
+	Receiver *receiver = NULL;
+	if (opt.local)
+	{
+		receiver = new Receiver(sink, socket);
+		receiver->start();
+	}
+
+	const uint64_t cpu_start = cputime();
+	const uint64_t start = now();
+
+	std::vector<Sender*> senders;
+	for (unsigned int i = 0; i < opt.senders; ++i)
+	{
+		unsigned int count = opt.count / opt.senders;
+		if (i == 0) count += opt.count % opt.senders;
+
+		Sender *s = new Sender(opt, socket, i, count);
+		senders.push_back(s);
+		s->start();
+	}
+
+	const bool completed = sink.wait(opt.count, opt.timeout);
+	const uint64_t cpu = cputime() - cpu_start;
+
+	std::stringstream result;
+	bool failed = !completed;
+	for (std::vector<Sender*>::iterator it = senders.begin(); it != senders.end(); ++it)
+	{
+		failed |= (*it)->failed();
+		delete (*it);
+	}
+
+	if (failed)
+	{
+		result << std::setw(8) << storage << " " << std::setw(9) << routing << "  failed after " << sink.delivered << " bundles" << std::endl;
+	}
+	else
+	{
+		const double elapsed = static_cast<double>(sink.last - start) / 1000000.0;
+		const dtn::core::LatencyHistogram &l = sink.latency;
+
+		result << std::setw(8) << storage << " " << std::setw(9) << routing
+				<< std::fixed << std::setprecision(2)
+				<< std::setw(10) << (static_cast<double>(sink.delivered) / elapsed)
+				<< std::setw(9) << ((static_cast<double>(sink.delivered) * opt.size) / elapsed / 1000000.0)
+				<< std::setw(7) << (opt.local ? 0.0 : static_cast<double>(sink.transmissions) / sink.delivered)
+				<< std::setw(9) << (static_cast<double>(l.percentile(50)) / 1000.0)
+				<< std::setw(9) << (static_cast<double>(l.percentile(90)) / 1000.0)
+				<< std::setw(9) << (static_cast<double>(l.percentile(99)) / 1000.0)
+				<< std::setw(9) << (static_cast<double>(l.max()) / 1000.0)
+				<< std::setw(10) << (cpu / sink.delivered)
+				<< std::endl;
+	}
+
+	report(fd, result.str());
+
+	if (receiver != NULL)
+	{
+		receiver->stop();
+		delete receiver;
+	}
+
+	cl.disconnect();
+	cl.stop();
+	cl.join();
+	dtn::core::BundleCore::getInstance().getConnectionManager().remove(&cl);
+
+	daemon.init(dtn::daemon::RUNLEVEL_ZERO);
+
+	return !failed;
+}
+
+/**
+ * Measure the access to the meta data of stored bundles, once with
+ * fully loaded bundles and once with views which load the primary
+ * block and the block index only. Has to be called in a separate
+ * process like measure().
+ */
+static bool measure_metadata(const Options &opt, const std::string &storage, int fd)
+{
+	ibrcommon::File workdir = ibrcommon::File(opt.workdir).get(storage + "-metadata");
+	if (workdir.exists()) workdir.remove(true);
+	ibrcommon::File::createDirectory(workdir);
+
+	const ibrcommon::File config = workdir.get("ibrdtnd.conf");
+
+	{
+		std::ofstream conf(config.getPath().c_str());
+		conf << "local_uri = dtn://bench-node" << std::endl;
+		conf << "discovery_announce = 0" << std::endl;
+
+		if (storage == "memory") {
+			conf << "storage = default" << std::endl;
+		} else {
+			conf << "storage = " << storage << std::endl;
+			conf << "storage_path = " << workdir.get("storage").getPath() << std::endl;
+		}
+	}
+
+	dtn::daemon::NativeDaemon daemon;
+	daemon.setConfigFile(config.getPath());
+	daemon.init(dtn::daemon::RUNLEVEL_STORAGE);
+
+	dtn::storage::BundleStorage &bs = dtn::core::BundleCore::getInstance().getStorage();
+	const std::string payload(opt.size, 'x');
+
+	std::vector<dtn::data::BundleID> ids;
+	for (unsigned int i = 0; i < opt.count; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://bench-node/sender");
+		b.destination = dtn::data::EID("dtn://bench-peer-0/bench");
+		b.lifetime = 3600;
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		(*ref.iostream()) << payload;
+		b.push_back(ref);
+
+		bs.store(b);
+		ids.push_back(b);
+	}
+
+	// wait until all bundles are written
+	bs.wait();
+
+	std::stringstream result;
+	dtn::data::DefaultSerializer s(std::cout);
+	dtn::data::Length check[2] = { 0, 0 };
+
+	for (unsigned int mode = 0; mode < 2; ++mode)
+	{
+		const uint64_t read_start = bytesread();
+		const uint64_t start = now();
+
+		for (std::vector<dtn::data::BundleID>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+		{
+			if (mode == 0)
+			{
+				const dtn::data::Bundle b = bs.get(*it);
+				if (b.destination.sameHost(b.source)) continue;
+				check[mode] += s.getLength(b);
+			}
+			else
+			{
+				const dtn::storage::BundleView v = bs.view(*it);
+				if (v.destination.sameHost(v.source)) continue;
+				check[mode] += v.getLength();
+			}
+		}
+
+		const double elapsed = static_cast<double>(now() - start) / 1000000.0;
+		const uint64_t bytes = bytesread() - read_start;
+
+		result << std::setw(8) << storage << std::setw(6) << ((mode == 0) ? "get" : "view")
+				<< std::fixed << std::setprecision(2)
+				<< std::setw(10) << (static_cast<double>(opt.count) / elapsed)
+				<< std::setw(11) << (static_cast<double>(bytes) / opt.count / 1024.0)
+				<< std::endl;
+	}
+
+	// both modes have to see the same bundles
+	if (check[0] != check[1])
+	{
+		result << std::setw(8) << storage << "  view length mismatch: " << check[1] << " != " << check[0] << std::endl;
+	}
+
+	report(fd, result.str());
+
+	daemon.init(dtn::daemon::RUNLEVEL_ZERO);
+
+	return (check[0] == check[1]);
+}
+
+#ifdef IBRDTN_SUPPORT_BSP
+/**
+ * Measure signing and encryption of bundles addressed to the local
+ * node, with or without reuse of the encryption session key. Has to be
+ * called in a separate process like measure().
+ */
+static bool measure_security(const Options &opt, const size_t session_lifetime, int fd)
+{
+	std::stringstream mode;
+	mode << "session " << session_lifetime << "s";
+
+	ibrcommon::File workdir = ibrcommon::File(opt.workdir).get("security");
+	ibrcommon::File keys = workdir.get("bpsec");
+	if (!keys.exists()) ibrcommon::File::createDirectory(keys);
+
+	const ibrcommon::File config = workdir.get("ibrdtnd.conf");
+
+	{
+		std::ofstream conf(config.getPath().c_str());
+		conf << "local_uri = dtn://bench-node" << std::endl;
+		conf << "discovery_announce = 0" << std::endl;
+		conf << "security_path = " << keys.getPath() << std::endl;
+		conf << "security_session_key_lifetime = " << session_lifetime << std::endl;
+	}
+
+	// generates the local key-pair on the first run
+	dtn::daemon::NativeDaemon daemon;
+	daemon.setConfigFile(config.getPath());
+	daemon.init(dtn::daemon::RUNLEVEL_CORE);
+
+	const dtn::security::SecurityManager &sec = dtn::security::SecurityManager::getInstance();
+	const std::string payload(opt.size, 'x');
+
+	const uint64_t cpu_start = cputime();
+	const uint64_t start = now();
+
+	try {
+		for (unsigned int i = 0; i < opt.count; ++i)
+		{
+			dtn::data::Bundle b;
+			b.source = dtn::data::EID("dtn://bench-node/sender");
+			b.destination = dtn::data::EID("dtn://bench-node/receiver");
+
+			ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+			(*ref.iostream()) << payload;
+			b.push_back(ref);
+
+			sec.sign(b);
+			sec.encrypt(b);
+		}
+	} catch (const std::exception &ex) {
+		std::stringstream result;
+		result << std::setw(18) << mode.str() << "  error: " << ex.what() << std::endl;
+		report(fd, result.str());
+		daemon.init(dtn::daemon::RUNLEVEL_ZERO);
+		return false;
+	}
+
+	const double elapsed = static_cast<double>(now() - start) / 1000000.0;
+	const uint64_t cpu = cputime() - cpu_start;
+
+	std::stringstream result;
+	result << std::setw(18) << mode.str()
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(10) << (static_cast<double>(opt.count) / elapsed)
+			<< std::setw(9) << ((static_cast<double>(opt.count) * opt.size) / elapsed / 1000000.0)
+			<< std::setw(10) << (cpu / opt.count)
+			<< std::endl;
+
+	report(fd, result.str());
+
+	daemon.init(dtn::daemon::RUNLEVEL_ZERO);
+
+	return true;
+}
+#endif
+
+/**
+ * A peer of a stream connection, which either sends the transfers or
+ * receives them and counts the completed transfers
+ */
+class StreamPeer : public ibrcommon::JoinableThread, public dtn::streams::StreamConnection::Callback
+{
+private:
+	ibrcommon::socketstream _conn;
+	const dtn::data::EID _eid;
+	const std::vector<size_t> &_sizes;
+	const bool _receiver;
+
+public:
+	StreamPeer(ibrcommon::clientsocket *sock, const dtn::data::EID &eid, const std::vector<size_t> &sizes, bool receiver)
+	 : _conn(sock), _eid(eid), _sizes(sizes), _receiver(receiver), stream(*this, _conn), up(false), transfers(0)
+	{ }
+
+	virtual ~StreamPeer()
+	{
+		join();
+	}
+
+	void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () { };
+	void eventTimeout() throw () { };
+	void eventError() throw () { };
+	void eventBundleRefused() throw () { };
+	void eventBundleForwarded() throw () { };
+	void eventBundleAck(const dtn::data::Length&) throw () { };
+	void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () { };
+	void eventConnectionDown() throw () { };
+
+	dtn::streams::StreamConnection stream;
+
+	ibrcommon::Conditional cond;
+	bool up;
+	size_t transfers;
+
+protected:
+	void run() throw ()
+	{
+		try {
+			stream.handshake(_eid, 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+
+			{
+				ibrcommon::MutexLock l(cond);
+				up = true;
+				cond.signal(true);
+			}
+
+			if (_receiver)
+			{
+				std::vector<char> buf(0x10000);
+
+				for (std::vector<size_t>::const_iterator it = _sizes.begin(); it != _sizes.end(); ++it)
+				{
+					size_t remain = (*it);
+					while (remain > 0)
+					{
+						const size_t len = (remain < buf.size()) ? remain : buf.size();
+						stream.read(&buf[0], len);
+						if (!stream.good()) return;
+						remain -= len;
+					}
+
+					ibrcommon::MutexLock l(cond);
+					transfers++;
+					cond.signal(true);
+				}
+			}
+
+			// process the acknowledgements until the connection is closed
+			char c;
+			while (stream.good()) stream.read(&c, 1);
+		} catch (const std::exception&) {
+			// connection closed
+		}
+	}
+
+	void __cancellation() throw ()
+	{
+		_conn.close();
+	}
+};
+
+/**
+ * Measure the goodput of a stream connection over the loopback
+ * interface with transfer sizes from 1 KB up to 1 GB
+ */
+static bool measure_goodput(const Options &opt)
+{
+	// transfers of each size add up to at least this volume
+	static const size_t min_volume = 16 * 1024 * 1024;
+
+	// transfer sizes from 1 KB up to 1 GB, in steps of factor four
+	static const size_t steps = 11;
+
+	// the peers close their ends while acknowledgements may still be written
+	::signal(SIGPIPE, SIG_IGN);
+
+	std::vector<size_t> sizes;
+	for (size_t k = 0; k < steps; ++k)
+	{
+		const size_t size = size_t(1024) << (2 * k);
+		const size_t repeat = (size < min_volume) ? (min_volume / size) : 1;
+		for (size_t i = 0; i < repeat; ++i) sizes.push_back(size);
+	}
+
+	ibrcommon::clientsocket *client = NULL;
+	ibrcommon::clientsocket *server = NULL;
+
+	try {
+		// connect both peers through the loopback interface on an ephemeral port
+		ibrcommon::tcpserversocket srv(ibrcommon::vaddress("127.0.0.1", 0));
+		srv.up();
+
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+		::memset(&addr, 0, sizeof(addr));
+		if (::getsockname(srv.fd(), (struct sockaddr*)&addr, &len) == -1)
+			throw ibrcommon::socket_exception("can not get the port of the server socket");
+
+		client = new ibrcommon::tcpsocket(ibrcommon::vaddress("127.0.0.1", ntohs(addr.sin_port)));
+		client->up();
+
+		ibrcommon::vaddress peeraddr;
+		server = srv.accept(peeraddr);
+	} catch (const ibrcommon::socket_exception &ex) {
+		delete client;
+
+		// fall back to a local socket pair if TCP is not available
+		std::cout << "loopback connection failed (" << ex.what() << "), using a socket pair" << std::endl;
+
+		int fds[2];
+		if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return false;
+		client = new ibrcommon::filesocket(fds[0]);
+		server = new ibrcommon::filesocket(fds[1]);
+	}
+
+	StreamPeer sender(client, dtn::data::EID("dtn:sender"), sizes, false);
+	StreamPeer receiver(server, dtn::data::EID("dtn:receiver"), sizes, true);
+
+	sender.start();
+	receiver.start();
+
+	bool success = true;
+
+	try {
+		// wait until both peers are connected
+		{
+			ibrcommon::MutexLock ls(sender.cond);
+			while (!sender.up) sender.cond.wait(opt.timeout * 1000);
+		}
+		{
+			ibrcommon::MutexLock lr(receiver.cond);
+			while (!receiver.up) receiver.cond.wait(opt.timeout * 1000);
+		}
+
+		// data pattern of the transfers
+		std::vector<char> pattern(0x10000);
+		for (size_t i = 0; i < pattern.size(); ++i) pattern[i] = static_cast<char>(i % 10);
+
+		std::cout << std::setw(12) << "bytes" << std::setw(10) << "MB/s" << std::endl;
+
+		std::vector<size_t>::const_iterator it = sizes.begin();
+		size_t transfers = 0;
+
+		while (it != sizes.end())
+		{
+			const size_t size = (*it);
+			double volume = 0;
+			const uint64_t start = now();
+
+			for (; (it != sizes.end()) && ((*it) == size); ++it)
+			{
+				size_t remain = size;
+				while (remain > 0)
+				{
+					const size_t len = (remain < pattern.size()) ? remain : pattern.size();
+					sender.stream.write(&pattern[0], len);
+					remain -= len;
+				}
+
+				// mark the end of the transfer
+				sender.stream << std::flush;
+
+				volume += static_cast<double>(size);
+				transfers++;
+			}
+
+			{
+				ibrcommon::MutexLock lr(receiver.cond);
+				while (receiver.transfers < transfers) receiver.cond.wait(opt.timeout * 1000);
+			}
+
+			std::cout << std::setw(12) << size << std::fixed << std::setprecision(2)
+					<< std::setw(10) << (volume / static_cast<double>(now() - start)) << std::endl;
+		}
+
+		success = sender.stream.good();
+		sender.stream.shutdown();
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		std::cout << "timeout reached" << std::endl;
+		success = false;
+	}
+
+	sender.stop();
+	receiver.stop();
+
+	return success;
+}
+
+static void print_help()
+{
+	Options opt;
+
+	std::cout << "-- ibrdtn benchmark --" << std::endl;
+	std::cout << "Syntax: benchmark [options]" << std::endl;
+	std::cout << " -h               Display this text" << std::endl;
+	std::cout << " -n <nodes>       Number of emulated neighbors (default: " << opt.nodes << ")" << std::endl;
+	std::cout << " -c <count>       Number of bundles per run (default: " << opt.count << ")" << std::endl;
+	std::cout << " -s <size>        Payload size in bytes (default: " << opt.size << ")" << std::endl;
+	std::cout << " -r <rate>        Bundles per second of each sender, 0 is unlimited (default: " << opt.rate << ")" << std::endl;
+	std::cout << " -p <senders>     Number of parallel API clients (default: " << opt.senders << ")" << std::endl;
+	std::cout << " -l               Send to a local application instead of the neighbors" << std::endl;
+	std::cout << " -S <list>        Comma separated storage backends (default: memory,default,tiered)" << std::endl;
+	std::cout << " -R <list>        Comma separated routing modules (default: default,epidemic,flooding,prophet)" << std::endl;
+	std::cout << " -w <path>        Working directory (default: " << opt.workdir << ")" << std::endl;
+	std::cout << " -t <seconds>     Timeout of each run (default: " << opt.timeout << ")" << std::endl;
+	std::cout << " -m               Measure meta data access of stored bundles instead of forwarding" << std::endl;
+	std::cout << " -g               Measure the goodput of a stream connection instead of forwarding" << std::endl;
+#ifdef IBRDTN_SUPPORT_BSP
+	std::cout << " -e               Measure signing and encryption instead of forwarding" << std::endl;
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+	Options opt;
+	int c;
+
+	while ((c = ::getopt(argc, argv, "hn:c:s:r:p:lS:R:w:t:emg")) != -1)
+	{
+		switch (c)
+		{
+		case 'n': opt.nodes = atoi(optarg); break;
+		case 'c': opt.count = atoi(optarg); break;
+		case 's': opt.size = atoi(optarg); break;
+		case 'r': opt.rate = atoi(optarg); break;
+		case 'p': opt.senders = atoi(optarg); break;
+		case 'l': opt.local = true; break;
+		case 'S': opt.storages = split(optarg); break;
+		case 'R': opt.routings = split(optarg); break;
+		case 'w': opt.workdir = optarg; break;
+		case 't': opt.timeout = atoi(optarg); break;
+		case 'e': opt.security = true; break;
+		case 'm': opt.metadata = true; break;
+		case 'g': opt.goodput = true; break;
+		default:
+			print_help();
+			return (c == 'h') ? 0 : -1;
+		}
+	}
+
+	if (opt.nodes == 0) opt.nodes = 1;
+	if (opt.senders == 0) opt.senders = 1;
+	if (opt.count < opt.senders) opt.count = opt.senders;
+	if (opt.size < sizeof(uint64_t)) opt.size = sizeof(uint64_t);
+
+	ibrcommon::File workdir(opt.workdir);
+	if (!workdir.exists()) ibrcommon::File::createDirectory(workdir);
+
+	if (opt.goodput)
+	{
+		return measure_goodput(opt) ? 0 : 1;
+	}
+
+#ifdef IBRDTN_SUPPORT_BSP
+	if (opt.security)
+	{
+		std::cout << "bundles: " << opt.count << ", payload: " << opt.size << " bytes, sign and encrypt" << std::endl;
+		std::cout << std::setw(18) << "mode" << std::setw(10) << "bundles/s" << std::setw(9) << "MB/s" << std::setw(10) << "cpu/b" << std::endl;
+
+		int ret = 0;
+		const size_t lifetimes[] = { 0, 3600 };
+
+		for (unsigned int i = 0; i < 2; ++i)
+		{
+			int fds[2];
+			if (::pipe(fds) != 0) return -1;
+
+			std::cout << std::flush;
+			const pid_t pid = ::fork();
+
+			if (pid == 0)
+			{
+				::close(fds[0]);
+				::alarm(opt.timeout * 2);
+				::_exit(measure_security(opt, lifetimes[i], fds[1]) ? 0 : 1);
+			}
+
+			::close(fds[1]);
+
+			std::string data;
+			char buf[256];
+			ssize_t len = 0;
+			while ((len = ::read(fds[0], buf, sizeof(buf))) > 0) data.append(buf, len);
+			::close(fds[0]);
+
+			int status = 0;
+			::waitpid(pid, &status, 0);
+
+			std::cout << data << std::flush;
+			if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) ret = 1;
+		}
+
+		return ret;
+	}
+#endif
+
+	if (opt.metadata)
+	{
+		std::cout << "bundles: " << opt.count << ", payload: " << opt.size << " bytes, meta data access" << std::endl;
+		std::cout << "bytes read in KB per bundle, includes the storage index" << std::endl;
+		std::cout << std::setw(8) << "storage" << std::setw(6) << "mode" << std::setw(10) << "bundles/s" << std::setw(11) << "KB read/b" << std::endl;
+
+		int ret = 0;
+
+		for (std::vector<std::string>::const_iterator s = opt.storages.begin(); s != opt.storages.end(); ++s)
+		{
+			int fds[2];
+			if (::pipe(fds) != 0) return -1;
+
+			std::cout << std::flush;
+			const pid_t pid = ::fork();
+
+			if (pid == 0)
+			{
+				::close(fds[0]);
+				::alarm(opt.timeout * 2);
+
+				bool success = false;
+
+				try {
+					success = measure_metadata(opt, *s, fds[1]);
+				} catch (const std::exception &ex) {
+					std::stringstream result;
+					result << std::setw(8) << (*s) << "  error: " << ex.what() << std::endl;
+					report(fds[1], result.str());
+				}
+
+				::_exit(success ? 0 : 1);
+			}
+
+			::close(fds[1]);
+
+			std::string data;
+			char buf[256];
+			ssize_t len = 0;
+			while ((len = ::read(fds[0], buf, sizeof(buf))) > 0) data.append(buf, len);
+			::close(fds[0]);
+
+			int status = 0;
+			::waitpid(pid, &status, 0);
+
+			std::cout << data << std::flush;
+			if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) ret = 1;
+		}
+
+		return ret;
+	}
+
+	std::cout << "bundles: " << opt.count << ", payload: " << opt.size << " bytes, senders: " << opt.senders
+			<< ", rate: " << opt.rate << "/s, destination: " << (opt.local ? "local application" : "neighbors")
+			<< ", neighbors: " << opt.nodes << std::endl;
+	std::cout << "latencies in ms, cpu time in us per bundle including the API clients" << std::endl;
+	std::cout << std::setw(8) << "storage" << " " << std::setw(9) << "routing"
+			<< std::setw(10) << "bundles/s" << std::setw(9) << "MB/s" << std::setw(7) << "tx/b"
+			<< std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(9) << "p99" << std::setw(9) << "max"
+			<< std::setw(10) << "cpu/b" << std::endl;
+
+	int ret = 0;
+
+	for (std::vector<std::string>::const_iterator s = opt.storages.begin(); s != opt.storages.end(); ++s)
+	{
+		for (std::vector<std::string>::const_iterator r = opt.routings.begin(); r != opt.routings.end(); ++r)
+		{
+			int fds[2];
+			if (::pipe(fds) != 0) return -1;
+
+			std::cout << std::flush;
+			const pid_t pid = ::fork();
+
+			if (pid == 0)
+			{
+				::close(fds[0]);
+
+				// do not hang forever if the shutdown blocks
+				::alarm(opt.timeout * 2);
+
+				bool success = false;
+
+				try {
+					success = measure(opt, *s, *r, fds[1]);
+				} catch (const std::exception &ex) {
+					std::stringstream result;
+					result << std::setw(8) << (*s) << " " << std::setw(9) << (*r) << "  error: " << ex.what() << std::endl;
+					report(fds[1], result.str());
+				}
+
+				::_exit(success ? 0 : 1);
+			}
+
+			::close(fds[1]);
+
+			std::string data;
+			char buf[256];
+			ssize_t len = 0;
+			while ((len = ::read(fds[0], buf, sizeof(buf))) > 0) data.append(buf, len);
+			::close(fds[0]);
+
+			int status = 0;
+			::waitpid(pid, &status, 0);
+
+			if (data.length() == 0)
+			{
+				std::cout << std::setw(8) << (*s) << " " << std::setw(9) << (*r) << "  aborted" << std::endl;
+			}
+			else
+			{
+				std::cout << data << std::flush;
+			}
+
+			if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0)) ret = 1;
+		}
+	}
+
+	return ret;
+}
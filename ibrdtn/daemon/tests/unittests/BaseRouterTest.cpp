@@ -30,9 +30,11 @@
  *
  */
 
+#include "config.h"
 #include "BaseRouterTest.hh"
 #include "routing/RoutingExtension.h"
 #include "routing/BaseRouter.h"
+#include "routing/StaticRouteTable.h"
 #include "storage/BundleStorage.h"
 #include "core/Node.h"
 #include "../tools/EventSwitchLoop.h"
@@ -40,6 +42,14 @@
 #include <ibrdtn/data/EID.h>
 #include <ibrcommon/thread/Thread.h>
 #include <ibrcommon/Logger.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#ifdef HAVE_REGEX_H
+#include "routing/StaticRegexRoute.h"
+#endif
+
+#include <sstream>
+#include <iostream>
 
 
 CPPUNIT_TEST_SUITE_REGISTRATION(BaseRouterTest);
@@ -251,6 +261,208 @@ void BaseRouterTest::testGetSummaryVector()
 
 /*=== END   tests for class 'BaseRouter' ===*/
 
+namespace {
+	/**
+	 * A static route to all EIDs of a node
+	 */
+	class NodeRoute : public dtn::routing::StaticRoute
+	{
+	public:
+		NodeRoute(const dtn::data::EID &match, const dtn::data::EID &nexthop)
+		 : _match(match), _nexthop(nexthop), _expire(0) {};
+		virtual ~NodeRoute() {};
+
+		bool match(const dtn::data::EID &eid) const { return _match.sameHost(eid); };
+		const dtn::data::EID& getDestination() const { return _nexthop; };
+		const std::string toString() const { return _match.getString(); };
+		const dtn::data::Timestamp& getExpiration() const { return _expire; };
+		void raiseExpired() const {};
+		bool equals(const dtn::routing::StaticRoute&) const { return false; };
+
+		INDEX_TYPE getIndexKey(std::string &key, bool &verify) const
+		{
+			key = _match.getNode().getString();
+			verify = false;
+			return INDEX_NODE;
+		}
+
+	private:
+		const dtn::data::EID _match;
+		const dtn::data::EID _nexthop;
+		const dtn::data::Timestamp _expire;
+	};
+
+	/**
+	 * Create a set of node routes and, if available, regular expression
+	 * routes with and without a literal prefix
+	 */
+	void createRoutes(std::list<dtn::routing::StaticRoute*> &routes, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			std::stringstream node, hop;
+			node << "dtn://node" << i;
+			hop << "dtn://hop" << (i % 8);
+
+			switch (i % 4)
+			{
+#ifdef HAVE_REGEX_H
+			case 1:
+				// anchored expression, matches every EID with this prefix
+				routes.push_back(new dtn::routing::StaticRegexRoute("^" + node.str() + "/.*", hop.str()));
+				break;
+
+			case 2:
+				// anchored expression which has to be verified
+				routes.push_back(new dtn::routing::StaticRegexRoute("^" + node.str() + "/app[0-9]", hop.str()));
+				break;
+
+			case 3:
+				if (i % 64 == 3)
+				{
+					// expression without an index key
+					std::stringstream ss;
+					ss << "node" << i << "/moon";
+					routes.push_back(new dtn::routing::StaticRegexRoute(ss.str(), hop.str()));
+				}
+				else
+				{
+					routes.push_back(new NodeRoute(node.str(), hop.str()));
+				}
+				break;
+#endif
+			default:
+				routes.push_back(new NodeRoute(node.str(), hop.str()));
+				break;
+			}
+		}
+	}
+
+	void deleteRoutes(std::list<dtn::routing::StaticRoute*> &routes)
+	{
+		for (std::list<dtn::routing::StaticRoute*>::iterator it = routes.begin(); it != routes.end(); ++it)
+		{
+			delete (*it);
+		}
+		routes.clear();
+	}
+
+	void linearMatch(const std::list<dtn::routing::StaticRoute*> &routes, const dtn::data::EID &destination, dtn::routing::StaticRouteTable::route_list &ret)
+	{
+		for (std::list<dtn::routing::StaticRoute*>::const_iterator it = routes.begin(); it != routes.end(); ++it)
+		{
+			if ((*it)->match(destination)) ret.push_back(*it);
+		}
+	}
+}
+
+void BaseRouterTest::testStaticRouteTable()
+{
+	std::list<dtn::routing::StaticRoute*> routes;
+	createRoutes(routes, 256);
+
+	// add a second route to the same node via another next-hop
+	routes.push_back(new NodeRoute(dtn::data::EID("dtn://node0"), dtn::data::EID("dtn://hop9")));
+
+	const dtn::routing::StaticRouteTable table(routes);
+	CPPUNIT_ASSERT_EQUAL(routes.size(), table.size());
+
+	const char *apps[] = { "", "/app1", "/appx", "/moon", "/app5/moon" };
+
+	for (size_t i = 0; i < 300; ++i)
+	{
+		for (size_t a = 0; a < 5; ++a)
+		{
+			std::stringstream ss;
+			ss << "dtn://node" << i << apps[a];
+			const dtn::data::EID destination(ss.str());
+
+			// the table has to return the same routes in the same order
+			dtn::routing::StaticRouteTable::route_list expected, result;
+			linearMatch(routes, destination, expected);
+			table.match(destination, result);
+
+			CPPUNIT_ASSERT(expected == result);
+
+			for (size_t h = 0; h < 10; ++h)
+			{
+				std::stringstream hop;
+				hop << "dtn://hop" << h;
+				const dtn::data::EID nexthop(hop.str());
+
+				bool found = false;
+				for (dtn::routing::StaticRouteTable::route_list::const_iterator it = expected.begin(); it != expected.end(); ++it)
+				{
+					if ((*it)->getDestination() == nexthop) found = true;
+				}
+
+				CPPUNIT_ASSERT_EQUAL(found, table.match(destination, nexthop));
+			}
+		}
+	}
+
+	CPPUNIT_ASSERT(table.hasNextHop(dtn::data::EID("dtn://hop9")));
+	CPPUNIT_ASSERT(!table.hasNextHop(dtn::data::EID("dtn://hop10")));
+
+	deleteRoutes(routes);
+}
+
+void BaseRouterTest::testStaticRouteTablePerformance()
+{
+	const size_t sizes[] = { 16, 256, 4096 };
+
+	for (size_t s = 0; s < 3; ++s)
+	{
+		std::list<dtn::routing::StaticRoute*> routes;
+		createRoutes(routes, sizes[s]);
+
+		const dtn::routing::StaticRouteTable table(routes);
+
+		std::vector<dtn::data::EID> destinations;
+		for (size_t i = 0; i < 256; ++i)
+		{
+			std::stringstream ss;
+			ss << "dtn://node" << ((i * 7919) % (sizes[s] * 2)) << "/app" << (i % 10);
+			destinations.push_back(dtn::data::EID(ss.str()));
+		}
+
+		size_t linear_matches = 0;
+		size_t table_matches = 0;
+		dtn::routing::StaticRouteTable::route_list result;
+
+		ibrcommon::TimeMeasurement tm;
+
+		tm.start();
+		for (size_t i = 0; i < 4096; ++i)
+		{
+			result.clear();
+			linearMatch(routes, destinations[i % destinations.size()], result);
+			linear_matches += result.size();
+		}
+		tm.stop();
+		const double linear_rate = 4096000.0 / tm.getMilliseconds();
+
+		tm.start();
+		for (size_t i = 0; i < 4096; ++i)
+		{
+			result.clear();
+			table.match(destinations[i % destinations.size()], result);
+			table_matches += result.size();
+		}
+		tm.stop();
+		const double table_rate = 4096000.0 / tm.getMilliseconds();
+
+		CPPUNIT_ASSERT_EQUAL(linear_matches, table_matches);
+
+		std::cout << std::endl << sizes[s] << " routes: " << static_cast<size_t>(linear_rate) << " linear lookups/s, "
+				<< static_cast<size_t>(table_rate) << " compiled lookups/s";
+
+		deleteRoutes(routes);
+	}
+
+	std::cout << std::endl;
+}
+
 void BaseRouterTest::setUp()
 {
 	_storage.clear();
@@ -37,6 +37,9 @@ class BaseRouterTest : public CppUnit::TestFixture {
 		void testGetSummaryVector();
 		/*=== END   tests for class 'BaseRouter' ===*/
 
+		void testStaticRouteTable();
+		void testStaticRouteTablePerformance();
+
 		void setUp();
 		void tearDown();
 
@@ -50,6 +53,8 @@ class BaseRouterTest : public CppUnit::TestFixture {
 			CPPUNIT_TEST(testIsKnown);
 			CPPUNIT_TEST(testSetKnown);
 			CPPUNIT_TEST(testGetSummaryVector);
+			CPPUNIT_TEST(testStaticRouteTable);
+			CPPUNIT_TEST(testStaticRouteTablePerformance);
 		CPPUNIT_TEST_SUITE_END();
 };
 #endif /* BASEROUTERTEST_HH */
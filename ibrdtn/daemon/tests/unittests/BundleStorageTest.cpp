@@ -32,13 +32,14 @@
 
 #include "config.h"
 #include "BundleStorageTest.hh"
-#include "../tools/TestEventListener.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 #include <ibrdtn/data/Bundle.h>
 #include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/ScopeControlHopLimitBlock.h>
+#include <ibrdtn/data/Serializer.h>
 #include <ibrcommon/thread/Thread.h>
-#include "core/TimeEvent.h"
+#include "core/DeadlineScheduler.h"
 #include <ibrdtn/utils/Clock.h>
 #include "core/BundleCore.h"
 #include <ibrcommon/data/File.h>
@@ -50,6 +51,7 @@
 
 #include "storage/SimpleBundleStorage.h"
 #include "storage/MemoryBundleStorage.h"
+#include "storage/TieredBundleStorage.h"
 
 #ifdef HAVE_SQLITE
 #include "storage/SQLiteBundleStorage.h"
@@ -102,8 +104,20 @@ void BundleStorageTest::setUp()
 			break;
 		}
 
-#ifdef HAVE_SQLITE
 	case 2:
+		{
+			// prepare path for the tiered storage
+			ibrcommon::File path("/tmp/bundle-tiered-test");
+			if (path.exists()) path.remove(true);
+			ibrcommon::File::createDirectory(path);
+
+			// add tiered storage with a small memory budget and a pool of synced writers
+			_storage = new dtn::storage::TieredBundleStorage(path, 4096, 0, 0, 2, true);
+			break;
+		}
+
+#ifdef HAVE_SQLITE
+	case 3:
 		{
 			// prepare path for the sqlite based storage
 			ibrcommon::File path("/tmp/bundle-sqlite-test");
@@ -408,18 +422,8 @@ void BundleStorageTest::testSizeExpiration(dtn::storage::BundleStorage &storage)
 
 	CPPUNIT_ASSERT_EQUAL(ssize, storage.size());
 
-	TestEventListener<dtn::core::TimeEvent> evtl;
-
-	// raise time event to trigger expiration
-	dtn::core::TimeEvent::raise(timestamp + 21, TIME_SECOND_TICK);
-
-	// wait until the time event has been processed
-	{
-		ibrcommon::Thread::sleep(2000);
-
-		ibrcommon::MutexLock l(evtl.event_cond);
-		while (evtl.event_counter == 0) evtl.event_cond.wait(20000);
-	}
+	// run all deadlines up to the expiration of the bundles
+	dtn::core::BundleCore::getInstance().getScheduler().trigger(timestamp + 21);
 
 	// special case for storages deferred mechanisms (SimpleBundleStorage)
 	// wait until all tasks of the storage are processed
@@ -462,7 +466,7 @@ void BundleStorageTest::testRaiseEvent(dtn::storage::BundleStorage &storage)
 
 	storage.store(b);
 	storage.wait();
-	dtn::core::TimeEvent::raise(dtn::utils::Clock::getTime() + 3600, dtn::core::TIME_SECOND_TICK);
+	dtn::core::BundleCore::getInstance().getScheduler().trigger(dtn::utils::Clock::getTime() + 3600);
 }
 
 void BundleStorageTest::testConcurrentStoreGet()
@@ -607,18 +611,8 @@ void BundleStorageTest::testExpiration(dtn::storage::BundleStorage &storage)
 	// check if the storage count is right
 	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, storage.count());
 
-	TestEventListener<dtn::core::TimeEvent> evtl;
-
-	// raise time event to trigger expiration
-	dtn::core::TimeEvent::raise(b.timestamp + 21, TIME_SECOND_TICK);
-
-	// wait until the time event has been processed
-	{
-		ibrcommon::Thread::sleep(2000);
-
-		ibrcommon::MutexLock l(evtl.event_cond);
-		while (evtl.event_counter == 0) evtl.event_cond.wait(20000);
-	}
+	// run all deadlines up to the expiration of the bundle
+	dtn::core::BundleCore::getInstance().getScheduler().trigger(b.timestamp + 21);
 
 	// special case for storages deferred mechanisms (SimpleBundleStorage)
 	// wait until all tasks of the storage are processed
@@ -981,6 +975,58 @@ void BundleStorageTest::testInfo(dtn::storage::BundleStorage &storage)
 	CPPUNIT_ASSERT_EQUAL((dtn::data::BundleID&)b, (dtn::data::BundleID&)meta);
 }
 
+void BundleStorageTest::testView()
+{
+	STORAGE_TEST(testView);
+}
+
+void BundleStorageTest::testView(dtn::storage::BundleStorage &storage)
+{
+	dtn::data::Bundle b;
+
+	// set standard variables
+	b.source = dtn::data::EID("dtn://node-one/test");
+	b.lifetime = 1;
+	b.destination = dtn::data::EID("dtn://node-two/test");
+
+	{
+		dtn::data::AgeBlock &agebl = b.push_back<dtn::data::AgeBlock>();
+		agebl.setSeconds(42);
+	}
+
+	// add some payload
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	(*ref.iostream()) << "Hallo Welt" << std::endl;
+
+	dtn::data::DefaultSerializer s(std::cout);
+	const dtn::data::Length length = s.getLength(b);
+
+	// store the bundle
+	storage.store(b);
+
+	// special case for caching storages (SimpleBundleStorage)
+	// wait until the bundle is written
+	storage.wait();
+
+	dtn::storage::BundleView view = storage.view(b);
+
+	// check primary block and block index
+	CPPUNIT_ASSERT_EQUAL((dtn::data::BundleID&)b, (dtn::data::BundleID&)view);
+	CPPUNIT_ASSERT(view.destination == b.destination);
+	CPPUNIT_ASSERT_EQUAL((size_t)2, view.getIndex().size());
+	CPPUNIT_ASSERT(view.has(dtn::data::AgeBlock::BLOCK_TYPE));
+	CPPUNIT_ASSERT(view.has(dtn::data::PayloadBlock::BLOCK_TYPE));
+	CPPUNIT_ASSERT(!view.has(dtn::data::ScopeControlHopLimitBlock::BLOCK_TYPE));
+	CPPUNIT_ASSERT_EQUAL(length, view.getLength());
+
+	// load blocks on demand
+	CPPUNIT_ASSERT(view.find<dtn::data::AgeBlock>().getSeconds() >= 42);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Length)11, view.find<dtn::data::PayloadBlock>().getLength());
+	CPPUNIT_ASSERT_THROW(view.find<dtn::data::ScopeControlHopLimitBlock>(), dtn::data::Bundle::NoSuchBlockFoundException);
+}
+
 void BundleStorageTest::testQueryBloomFilter()
 {
 	STORAGE_TEST(testQueryBloomFilter);
@@ -1043,3 +1089,123 @@ void BundleStorageTest::testQueryBloomFilter(dtn::storage::BundleStorage &storag
 
 	CPPUNIT_ASSERT_EQUAL((size_t)0, list.size());
 }
+
+void BundleStorageTest::testTieredSpill()
+{
+	STORAGE_TEST(testTieredSpill);
+}
+
+void BundleStorageTest::testTieredSpill(dtn::storage::BundleStorage &storage)
+{
+	// only the tiered storage has a memory budget
+	dtn::storage::TieredBundleStorage *tiered = dynamic_cast<dtn::storage::TieredBundleStorage*>(&storage);
+	if (tiered == NULL) return;
+
+	std::list<dtn::data::Bundle> list;
+
+	for (int i = 0; i < 500; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = dtn::data::EID("dtn://node-two/test");
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+
+		(*ref.iostream()) << "Hallo Welt " << i << std::endl;
+
+		list.push_back(b);
+		storage.store(b);
+
+		// the memory tier never exceeds the budget
+		CPPUNIT_ASSERT(tiered->getMemoryUsage() <= 4096);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)500, storage.count());
+
+	// wait until all spilled bundles are written
+	storage.wait();
+
+	// the first bundle has been spilled to disk
+	const dtn::data::Bundle &first = list.front();
+	CPPUNIT_ASSERT(!tiered->isResident(first));
+
+	// get the bundle back from disk and promote it into memory
+	const dtn::data::Bundle retrieved = storage.get(first);
+	CPPUNIT_ASSERT_EQUAL(first.getPayloadLength(), retrieved.getPayloadLength());
+	CPPUNIT_ASSERT(tiered->isResident(first));
+	CPPUNIT_ASSERT(tiered->getMemoryUsage() <= 4096);
+
+	// all bundles are still available
+	for (std::list<dtn::data::Bundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+	{
+		const dtn::data::Bundle bundle = storage.get(*iter);
+		CPPUNIT_ASSERT_EQUAL((*iter).getPayloadLength(), bundle.getPayloadLength());
+	}
+
+	// removed bundles are dropped from both tiers
+	storage.remove(first);
+	CPPUNIT_ASSERT(!tiered->isResident(first));
+	storage.wait();
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)499, storage.count());
+}
+
+void BundleStorageTest::testRestoreIndex()
+{
+	STORAGE_TEST(testRestoreIndex);
+}
+
+void BundleStorageTest::testRestoreIndex(dtn::storage::BundleStorage &storage)
+{
+	// only the file based storages restore their index from a snapshot
+	if ((dynamic_cast<dtn::storage::SimpleBundleStorage*>(&storage) == NULL) &&
+		(dynamic_cast<dtn::storage::TieredBundleStorage*>(&storage) == NULL)) return;
+
+	dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(storage);
+
+	std::list<dtn::data::Bundle> list;
+
+	for (int i = 0; i < 10; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://node-one/test");
+		b.destination = dtn::data::EID("dtn://node-two/test");
+		b.lifetime = 3600;
+
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+		b.push_back(ref);
+
+		(*ref.iostream()) << "Hallo Welt " << i << std::endl;
+
+		list.push_back(b);
+		storage.store(b);
+	}
+
+	// restart the storage, the index is restored from the snapshot
+	c.terminate();
+	c.initialize();
+	c.startup();
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)10, storage.count());
+
+	for (std::list<dtn::data::Bundle>::const_iterator iter = list.begin(); iter != list.end(); ++iter)
+	{
+		const dtn::data::MetaBundle meta = storage.info(*iter);
+		CPPUNIT_ASSERT((*iter).destination == meta.destination);
+		CPPUNIT_ASSERT((*iter).lifetime == meta.lifetime);
+
+		const dtn::data::Bundle bundle = storage.get(*iter);
+		CPPUNIT_ASSERT_EQUAL((*iter).getPayloadLength(), bundle.getPayloadLength());
+	}
+
+	// removed bundles do not come back after a restart
+	storage.remove(list.front());
+	storage.wait();
+
+	c.terminate();
+	c.initialize();
+	c.startup();
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)9, storage.count());
+	CPPUNIT_ASSERT(!storage.contains(list.front()));
+}
@@ -51,6 +51,9 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testFragment(dtn::storage::BundleStorage &storage);
 		void testContains(dtn::storage::BundleStorage &storage);
 		void testInfo(dtn::storage::BundleStorage &storage);
+		void testView(dtn::storage::BundleStorage &storage);
+		void testTieredSpill(dtn::storage::BundleStorage &storage);
+		void testRestoreIndex(dtn::storage::BundleStorage &storage);
 
 	public:
 #define CPPUNIT_TEST_ALL_STORAGES(testMethod) \
@@ -86,6 +89,9 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		void testFragment();
 		void testContains();
 		void testInfo();
+		void testView();
+		void testTieredSpill();
+		void testRestoreIndex();
 
 		void setUp();
 		void tearDown();
@@ -94,6 +100,7 @@ class BundleStorageTest : public CppUnit::TestFixture {
 
 		_storage_names.push_back("MemoryBundleStorage");
 		_storage_names.push_back("SimpleBundleStorage");
+		_storage_names.push_back("TieredBundleStorage");
 
 #ifdef HAVE_SQLITE
 		_storage_names.push_back("SQLiteBundleStorage");
@@ -122,6 +129,9 @@ class BundleStorageTest : public CppUnit::TestFixture {
 		CPPUNIT_TEST_ALL_STORAGES(testFragment);
 		CPPUNIT_TEST_ALL_STORAGES(testContains);
 		CPPUNIT_TEST_ALL_STORAGES(testInfo);
+		CPPUNIT_TEST_ALL_STORAGES(testView);
+		CPPUNIT_TEST_ALL_STORAGES(testTieredSpill);
+		CPPUNIT_TEST_ALL_STORAGES(testRestoreIndex);
 		CPPUNIT_TEST_SUITE_END();
 
 		static size_t testCounter;
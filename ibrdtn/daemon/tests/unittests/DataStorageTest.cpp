@@ -381,6 +381,109 @@ void DataStorageTest::testStressTest()
 //	}
 }
 
+void DataStorageTest::testWriterPoolTest()
+{
+	class DataCallback : public dtn::storage::DataStorage::Callback
+	{
+	public:
+		DataCallback() : stored(0), failed(0), removed(0), iterated(0) {};
+		virtual ~DataCallback() {};
+
+		void eventDataStorageStored(const dtn::storage::DataStorage::Hash&)
+		{
+			ibrcommon::MutexLock l(_cond);
+			stored++;
+		};
+
+		void eventDataStorageStoreFailed(const dtn::storage::DataStorage::Hash&, const ibrcommon::Exception&)
+		{
+			ibrcommon::MutexLock l(_cond);
+			failed++;
+		};
+
+		void eventDataStorageRemoved(const dtn::storage::DataStorage::Hash&)
+		{
+			ibrcommon::MutexLock l(_cond);
+			removed++;
+		};
+
+		void eventDataStorageRemoveFailed(const dtn::storage::DataStorage::Hash&, const ibrcommon::Exception&)
+		{
+			ibrcommon::MutexLock l(_cond);
+			failed++;
+		};
+
+		void iterateDataStorage(const dtn::storage::DataStorage::Hash&, dtn::storage::DataStorage::istream &stream)
+		{
+			std::stringstream ss; ss << (*stream).rdbuf();
+
+			ibrcommon::MutexLock l(_cond);
+			if (ss.str() == "data") iterated++;
+		};
+
+		int stored;
+		int failed;
+		int removed;
+		int iterated;
+		ibrcommon::Conditional _cond;
+	};
+
+	class DataContainer : public dtn::storage::DataStorage::Container
+	{
+	public:
+		DataContainer(size_t id) : _id(id) {};
+		~DataContainer() {};
+
+		std::string getId() const
+		{
+			std::stringstream ss; ss << "datastorage-" << _id;
+			return ss.str();
+		}
+
+		std::ostream& serialize(std::ostream &stream)
+		{
+			stream << "data";
+			return stream;
+		}
+
+	private:
+		size_t _id;
+	};
+
+	ibrcommon::File datapath("/tmp/datastorage");
+
+	{
+		DataCallback callback;
+		dtn::storage::DataStorage storage(callback, datapath, 0, true, 4, true);
+		storage.start();
+
+		for (size_t i = 0; i < 200; ++i)
+		{
+			const dtn::storage::DataStorage::Hash h = storage.store(new DataContainer(i));
+
+			// removals are ordered after the store of the same hash
+			if (i % 2 == 0) storage.remove(h);
+		}
+
+		// all items are reported once wait() returns
+		storage.wait();
+
+		ibrcommon::MutexLock l(callback._cond);
+		CPPUNIT_ASSERT_EQUAL(0, callback.failed);
+		CPPUNIT_ASSERT_EQUAL(200, callback.stored);
+		CPPUNIT_ASSERT_EQUAL(100, callback.removed);
+	}
+
+	{
+		// scan the remaining data with concurrent threads
+		DataCallback callback;
+		dtn::storage::DataStorage storage(callback, datapath, 0, false, 4, true);
+		storage.iterateAll();
+
+		CPPUNIT_ASSERT_EQUAL(100, callback.iterated);
+	}
+}
+
 void DataStorageTest::setUp()
 {
 	// create temporary directory for data storage
@@ -33,6 +33,7 @@ public:
 	void testStoreTest();
 	void testRemoveTest();
 	void testStressTest();
+	void testWriterPoolTest();
 
 	void setUp();
 	void tearDown();
@@ -42,6 +43,7 @@ public:
 	CPPUNIT_TEST(testStoreTest);
 	CPPUNIT_TEST(testRemoveTest);
 	CPPUNIT_TEST(testStressTest);
+	CPPUNIT_TEST(testWriterPoolTest);
 	CPPUNIT_TEST_SUITE_END();
 
 private:
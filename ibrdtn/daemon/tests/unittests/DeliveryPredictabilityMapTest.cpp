@@ -0,0 +1,264 @@
+/*
+ * DeliveryPredictabilityMapTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "DeliveryPredictabilityMapTest.h"
+#include "routing/prophet/DeliveryPredictabilityMap.h"
+#include "core/BundleCore.h"
+#include <ibrcommon/TimeMeasurement.h>
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <set>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DeliveryPredictabilityMapTest);
+
+static dtn::data::EID node(size_t i)
+{
+	std::stringstream ss;
+	ss << "dtn://node" << i;
+	return dtn::data::EID(ss.str());
+}
+
+void DeliveryPredictabilityMapTest::setUp()
+{
+	_local = dtn::core::BundleCore::local;
+	dtn::core::BundleCore::local = dtn::data::EID("dtn://local");
+}
+
+void DeliveryPredictabilityMapTest::tearDown()
+{
+	dtn::core::BundleCore::local = _local;
+}
+
+void DeliveryPredictabilityMapTest::testSetGet()
+{
+	dtn::routing::DeliveryPredictabilityMap dpm(1, 0.9f, 0.999f);
+
+	CPPUNIT_ASSERT_THROW(dpm.get(dtn::data::EID("dtn://unknown-node")), dtn::routing::DeliveryPredictabilityMap::ValueNotFoundException);
+
+	dpm.set(dtn::data::EID("dtn://node1/app"), 0.5f);
+	dpm.set(node(2), 0.25f);
+	dpm.set(node(2), 0.75f);
+
+	// values are kept per node
+	CPPUNIT_ASSERT_EQUAL((size_t)2, dpm.size());
+	CPPUNIT_ASSERT_EQUAL(0.5f, dpm.get(node(1)));
+	CPPUNIT_ASSERT_EQUAL(0.5f, dpm.get(dtn::data::EID("dtn://node1/other")));
+	CPPUNIT_ASSERT_EQUAL(0.75f, dpm.get(dtn::data::EIDHandle(node(2))));
+
+	std::set<dtn::data::EID> nodes(dpm.begin(), dpm.end());
+	CPPUNIT_ASSERT_EQUAL((size_t)2, nodes.size());
+	CPPUNIT_ASSERT(nodes.find(node(1)) != nodes.end());
+
+	dpm.clear();
+	CPPUNIT_ASSERT_EQUAL((size_t)0, dpm.size());
+	CPPUNIT_ASSERT(dpm.begin() == dpm.end());
+}
+
+void DeliveryPredictabilityMapTest::testUpdate()
+{
+	dtn::routing::DeliveryPredictabilityMap local(1, 0.5f, 0.999f);
+	dtn::routing::DeliveryPredictabilityMap neighbor(1, 0.5f, 0.999f);
+
+	local.set(dtn::core::BundleCore::local, 1.0f);
+	local.set(node(1), 0.8f);
+	local.set(node(2), 0.3f);
+
+	neighbor.set(node(1), 1.0f);
+	neighbor.set(node(2), 0.2f);
+	neighbor.set(node(3), 0.6f);
+	neighbor.set(dtn::core::BundleCore::local, 0.9f);
+
+	local.update(node(1), neighbor, 0.75f);
+
+	// the value of the origin and of the local node are not changed
+	CPPUNIT_ASSERT_EQUAL(0.8f, local.get(node(1)));
+	CPPUNIT_ASSERT_EQUAL(1.0f, local.get(dtn::core::BundleCore::local));
+
+	// higher values are kept
+	CPPUNIT_ASSERT_EQUAL(0.3f, local.get(node(2)));
+
+	// transitive value: p_ab * p_bc * beta
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.8 * 0.6 * 0.5, local.get(node(3)), 0.0001);
+	CPPUNIT_ASSERT_EQUAL((size_t)4, local.size());
+
+	// use p_encounter_first for unknown origins
+	dtn::routing::DeliveryPredictabilityMap empty(1, 0.5f, 0.999f);
+	empty.update(node(4), neighbor, 0.75f);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.75 * 0.6 * 0.5, empty.get(node(3)), 0.0001);
+	CPPUNIT_ASSERT_THROW(empty.get(dtn::core::BundleCore::local), dtn::routing::DeliveryPredictabilityMap::ValueNotFoundException);
+	CPPUNIT_ASSERT_EQUAL((size_t)3, empty.size());
+}
+
+void DeliveryPredictabilityMapTest::testAge()
+{
+	dtn::routing::DeliveryPredictabilityMap dpm(1, 0.5f, 0.5f);
+
+	dpm.set(dtn::core::BundleCore::local, 1.0f);
+	dpm.set(node(1), 0.8f);
+	dpm.set(node(2), 0.3f);
+
+	dpm.age(0.1f, 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.4, dpm.get(node(1)), 0.0001);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.15, dpm.get(node(2)), 0.0001);
+
+	// do not age twice
+	dpm.age(0.1f, 1);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.4, dpm.get(node(1)), 0.0001);
+
+	// values below the threshold are removed, the local node is never aged
+	dpm.age(0.1f, 2);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL(0.2, dpm.get(node(1)), 0.0001);
+	CPPUNIT_ASSERT_THROW(dpm.get(node(2)), dtn::routing::DeliveryPredictabilityMap::ValueNotFoundException);
+	CPPUNIT_ASSERT_EQUAL(1.0f, dpm.get(dtn::core::BundleCore::local));
+	CPPUNIT_ASSERT_EQUAL((size_t)2, dpm.size());
+}
+
+void DeliveryPredictabilityMapTest::testSerialize()
+{
+	dtn::routing::DeliveryPredictabilityMap dpm(1, 0.5f, 0.5f);
+	for (size_t i = 0; i < 100; ++i) dpm.set(node(i), static_cast<float>(i) / 100.0f);
+
+	std::stringstream ss;
+	dpm.serialize(ss);
+	CPPUNIT_ASSERT_EQUAL((size_t)dpm.getLength(), ss.str().length());
+
+	dtn::routing::DeliveryPredictabilityMap copy;
+	copy.deserialize(ss);
+
+	CPPUNIT_ASSERT_EQUAL(dpm.size(), copy.size());
+	for (size_t i = 0; i < 100; ++i)
+	{
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(dpm.get(node(i)), copy.get(node(i)), 0.0001);
+	}
+}
+
+void DeliveryPredictabilityMapTest::testCompactSerialize()
+{
+	dtn::routing::DeliveryPredictabilityMap dpm(1, 0.5f, 0.5f);
+	for (size_t i = 0; i < 100; ++i) dpm.set(node(i), static_cast<float>(i) / 100.0f);
+
+	std::stringstream plain;
+	dpm.serialize(plain);
+
+	const dtn::routing::CompactPredictabilityMap compact(dpm);
+	std::stringstream ss;
+	compact.serialize(ss);
+	CPPUNIT_ASSERT_EQUAL((size_t)compact.getLength(), ss.str().length());
+
+	dtn::routing::CompactPredictabilityMap copy;
+	copy.deserialize(ss);
+
+	CPPUNIT_ASSERT_EQUAL(dpm.size(), copy.size());
+	for (size_t i = 0; i < 100; ++i)
+	{
+		CPPUNIT_ASSERT_DOUBLES_EQUAL(dpm.get(node(i)), copy.get(node(i)), 0.0001);
+	}
+
+	std::cout << std::endl << "100 entries: " << plain.str().length() << " bytes plain, " << ss.str().length() << " bytes compact" << std::endl;
+	CPPUNIT_ASSERT(ss.str().length() < plain.str().length());
+
+	// reject a prefix longer than the previous EID
+	std::stringstream broken;
+	broken << dtn::data::Number(1) << dtn::data::Number(4) << dtn::data::Number(1) << "x" << dtn::data::Number(1);
+	dtn::routing::CompactPredictabilityMap invalid;
+	CPPUNIT_ASSERT_THROW(invalid.deserialize(broken), dtn::InvalidDataException);
+}
+
+void DeliveryPredictabilityMapTest::testReceivedLimits()
+{
+	// huge lengths are rejected before a buffer is allocated
+	{
+		std::stringstream broken;
+		broken << dtn::data::Number(1) << dtn::data::Number(0) << dtn::data::Number(static_cast<size_t>(1) << 40);
+		dtn::routing::CompactPredictabilityMap invalid;
+		CPPUNIT_ASSERT_THROW(invalid.deserialize(broken), dtn::InvalidDataException);
+	}
+
+	{
+		std::stringstream broken;
+		broken << dtn::data::Number(1) << dtn::data::Number(static_cast<size_t>(1) << 40);
+		dtn::routing::DeliveryPredictabilityMap invalid;
+		CPPUNIT_ASSERT_THROW(invalid.deserialize(broken), dtn::InvalidDataException);
+	}
+
+	// a neighbor advertising many unknown nodes does not grow the table beyond the limit
+	const size_t limit = dtn::routing::DeliveryPredictabilityMap::MAX_INTERNED_NODES;
+	const size_t before = dtn::data::EIDTable::getInstance().size();
+	const size_t count = limit + 100;
+
+	std::stringstream ss;
+	ss << dtn::data::Number(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		std::stringstream eid;
+		eid << "dtn://advertised" << i;
+		ss << dtn::data::Number(0) << dtn::data::Number(eid.str().length()) << eid.str() << dtn::data::Number(100);
+	}
+
+	dtn::routing::CompactPredictabilityMap received;
+	received.deserialize(ss);
+
+	const size_t after = dtn::data::EIDTable::getInstance().size();
+	CPPUNIT_ASSERT(after <= std::max(before, limit));
+	CPPUNIT_ASSERT(received.size() < count);
+}
+
+void DeliveryPredictabilityMapTest::testPerformance()
+{
+	const size_t sizes[] = { 1000, 10000 };
+
+	for (size_t s = 0; s < 2; ++s)
+	{
+		const size_t nodes = sizes[s];
+		dtn::routing::DeliveryPredictabilityMap local(1, 0.25f, 0.999f);
+		dtn::routing::DeliveryPredictabilityMap neighbor(1, 0.25f, 0.999f);
+
+		for (size_t i = 0; i < nodes; ++i)
+		{
+			if (i % 2 == 0) local.set(node(i), 0.5f);
+			neighbor.set(node(i), static_cast<float>(i % 100) / 100.0f);
+		}
+
+		const size_t rounds = 200;
+		ibrcommon::TimeMeasurement tm;
+
+		tm.start();
+		for (size_t i = 0; i < rounds; ++i)
+		{
+			local.update(node(i % nodes), neighbor, 0.75f);
+		}
+		tm.stop();
+		const double update_us = tm.getMicroseconds() / rounds;
+
+		tm.start();
+		for (size_t i = 0; i < rounds; ++i)
+		{
+			local.age(0.00001f, i + 1);
+		}
+		tm.stop();
+		const double age_us = tm.getMicroseconds() / rounds;
+
+		CPPUNIT_ASSERT(local.size() > 0);
+
+		std::cout << std::endl << nodes << " nodes: update " << update_us << " us, age " << age_us << " us";
+	}
+
+	std::cout << std::endl;
+}
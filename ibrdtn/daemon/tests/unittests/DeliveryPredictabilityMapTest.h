@@ -0,0 +1,55 @@
+/*
+ * DeliveryPredictabilityMapTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <ibrdtn/data/EID.h>
+
+#ifndef DELIVERYPREDICTABILITYMAPTEST_H_
+#define DELIVERYPREDICTABILITYMAPTEST_H_
+
+class DeliveryPredictabilityMapTest : public CppUnit::TestFixture
+{
+public:
+	void testSetGet();
+	void testUpdate();
+	void testAge();
+	void testSerialize();
+	void testCompactSerialize();
+	void testReceivedLimits();
+	void testPerformance();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(DeliveryPredictabilityMapTest);
+	CPPUNIT_TEST(testSetGet);
+	CPPUNIT_TEST(testUpdate);
+	CPPUNIT_TEST(testAge);
+	CPPUNIT_TEST(testSerialize);
+	CPPUNIT_TEST(testCompactSerialize);
+	CPPUNIT_TEST(testReceivedLimits);
+	CPPUNIT_TEST(testPerformance);
+	CPPUNIT_TEST_SUITE_END();
+
+private:
+	dtn::data::EID _local;
+};
+
+#endif /* DELIVERYPREDICTABILITYMAPTEST_H_ */
@@ -0,0 +1,599 @@
+/*
+ * HTTPClTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "HTTPClTest.h"
+#include "../tools/TestEventListener.h"
+#include "storage/MemoryBundleStorage.h"
+#include "net/TransferCompletedEvent.h"
+#include "core/BundleCore.h"
+#include "core/BundleEvent.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/TimeMeasurement.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <strings.h>
+#include <cstdlib>
+#include <sstream>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HTTPClTest);
+
+/**
+ * Minimal HTTP/1.1 server standing in for the bundle server. Uploaded
+ * bundles are collected and pushed data is delivered to a waiting
+ * long-poll request. Connections are kept alive.
+ */
+class HTTPStandin : public ibrcommon::JoinableThread
+{
+public:
+	HTTPStandin(size_t poll_timeout)
+	 : connections(0), polls(0), _poll_timeout(poll_timeout), _fd(-1), _port(0), _running(true)
+	{
+		_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+		if (_fd == -1) throw ibrcommon::Exception("could not create socket");
+
+		const int on = 1;
+		::setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+		struct sockaddr_in addr;
+		::memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = 0;
+
+		socklen_t len = sizeof(addr);
+		if ((::bind(_fd, (struct sockaddr*)&addr, len) == -1) || (::listen(_fd, 16) == -1)
+				|| (::getsockname(_fd, (struct sockaddr*)&addr, &len) == -1))
+		{
+			::close(_fd);
+			throw ibrcommon::Exception("could not bind to the loopback interface");
+		}
+
+		_port = ntohs(addr.sin_port);
+	}
+
+	virtual ~HTTPStandin()
+	{
+		join();
+		::close(_fd);
+	}
+
+	std::string getURL() const
+	{
+		std::stringstream ss;
+		ss << "http://127.0.0.1:" << _port << "/";
+		return ss.str();
+	}
+
+	/**
+	 * Deliver data with the next long-poll response
+	 */
+	void push(const std::string &data)
+	{
+		ibrcommon::MutexLock l(cond);
+		_mailbox.append(data);
+		cond.signal(true);
+	}
+
+	/**
+	 * Set the time a long-poll request waits for pushed data,
+	 * zero answers immediately
+	 */
+	void setPollTimeout(size_t timeout)
+	{
+		ibrcommon::MutexLock l(cond);
+		_poll_timeout = timeout;
+	}
+
+	/**
+	 * Wait for pushed data or the poll timeout
+	 */
+	std::string poll()
+	{
+		ibrcommon::MutexLock l(cond);
+		polls++;
+
+		try {
+			while (_mailbox.empty() && _running && (_poll_timeout > 0)) cond.wait(_poll_timeout);
+		} catch (const ibrcommon::Conditional::ConditionalAbortException&) { }
+
+		std::string ret;
+		ret.swap(_mailbox);
+		return ret;
+	}
+
+	ibrcommon::Conditional cond;
+	std::list<std::string> uploads;
+	size_t connections;
+	size_t polls;
+
+protected:
+	class Connection : public ibrcommon::JoinableThread
+	{
+	public:
+		Connection(HTTPStandin &server, int fd)
+		 : _server(server), _fd(fd)
+		{
+		}
+
+		virtual ~Connection()
+		{
+			join();
+			::close(_fd);
+		}
+
+	protected:
+		void run() throw ()
+		{
+			std::string line;
+
+			// handle requests as long as the client keeps the connection
+			while (readLine(line) && !line.empty())
+			{
+				std::stringstream request(line);
+				std::string method;
+				request >> method;
+
+				size_t length = 0;
+				bool chunked = false;
+
+				while (true)
+				{
+					if (!readLine(line)) return;
+					if (line.empty()) break;
+
+					if (::strncasecmp(line.c_str(), "Content-Length:", 15) == 0)
+					{
+						length = ::strtoul(line.c_str() + 15, NULL, 10);
+					}
+					else if ((::strncasecmp(line.c_str(), "Transfer-Encoding:", 18) == 0) && (line.find("chunked") != std::string::npos))
+					{
+						chunked = true;
+					}
+				}
+
+				std::string body;
+
+				if (chunked)
+				{
+					while (true)
+					{
+						if (!readLine(line)) return;
+						const size_t size = ::strtoul(line.c_str(), NULL, 16);
+
+						if (size == 0)
+						{
+							// skip the trailer
+							while (readLine(line) && !line.empty());
+							break;
+						}
+
+						std::string chunk;
+						if (!readData(chunk, size) || !readLine(line)) return;
+						body.append(chunk);
+					}
+				}
+				else if (length > 0)
+				{
+					if (!readData(body, length)) return;
+				}
+
+				if (method == "PUT")
+				{
+					{
+						ibrcommon::MutexLock l(_server.cond);
+						_server.uploads.push_back(body);
+						_server.cond.signal(true);
+					}
+
+					if (!send("HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n")) return;
+				}
+				else if (method == "GET")
+				{
+					const std::string data = _server.poll();
+
+					std::stringstream response;
+					if (data.empty())
+					{
+						response << "HTTP/1.1 410 Gone\r\nContent-Length: 0\r\n\r\n";
+					}
+					else
+					{
+						response << "HTTP/1.1 200 OK\r\nContent-Length: " << data.size() << "\r\n\r\n" << data;
+					}
+
+					if (!send(response.str())) return;
+				}
+				else
+				{
+					if (!send("HTTP/1.1 405 Method Not Allowed\r\nContent-Length: 0\r\n\r\n")) return;
+				}
+			}
+		}
+
+		void __cancellation() throw ()
+		{
+			::shutdown(_fd, SHUT_RDWR);
+		}
+
+	private:
+		bool fill()
+		{
+			char buf[4096];
+			const ssize_t ret = ::recv(_fd, buf, sizeof(buf), 0);
+			if (ret <= 0) return false;
+			_buffer.append(buf, ret);
+			return true;
+		}
+
+		bool readLine(std::string &line)
+		{
+			std::string::size_type pos;
+			while ((pos = _buffer.find("\r\n")) == std::string::npos)
+			{
+				if (!fill()) return false;
+			}
+
+			line = _buffer.substr(0, pos);
+			_buffer.erase(0, pos + 2);
+			return true;
+		}
+
+		bool readData(std::string &data, size_t length)
+		{
+			while (_buffer.size() < length)
+			{
+				if (!fill()) return false;
+			}
+
+			data = _buffer.substr(0, length);
+			_buffer.erase(0, length);
+			return true;
+		}
+
+		bool send(const std::string &data)
+		{
+			size_t offset = 0;
+			while (offset < data.size())
+			{
+				const ssize_t ret = ::send(_fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+				if (ret <= 0) return false;
+				offset += ret;
+			}
+			return true;
+		}
+
+		HTTPStandin &_server;
+		const int _fd;
+		std::string _buffer;
+	};
+
+	void run() throw ()
+	{
+		while (true)
+		{
+			const int fd = ::accept(_fd, NULL, NULL);
+			if (fd == -1) break;
+
+			Connection *c = new Connection(*this, fd);
+
+			{
+				ibrcommon::MutexLock l(cond);
+				if (!_running)
+				{
+					delete c;
+					break;
+				}
+
+				connections++;
+				_connections.push_back(c);
+			}
+
+			c->start();
+		}
+
+		std::list<Connection*> conns;
+		{
+			ibrcommon::MutexLock l(cond);
+			conns.swap(_connections);
+		}
+
+		for (std::list<Connection*>::iterator it = conns.begin(); it != conns.end(); ++it)
+		{
+			(*it)->stop();
+			delete (*it);
+		}
+	}
+
+	void __cancellation() throw ()
+	{
+		{
+			ibrcommon::MutexLock l(cond);
+			_running = false;
+			cond.signal(true);
+		}
+
+		::shutdown(_fd, SHUT_RDWR);
+	}
+
+private:
+	size_t _poll_timeout;
+	int _fd;
+	int _port;
+	bool _running;
+	std::list<Connection*> _connections;
+	std::string _mailbox;
+};
+
+/**
+ * Count bundles received from the network
+ */
+class ReceivedListener : public dtn::core::EventReceiver<dtn::core::BundleEvent>
+{
+public:
+	ReceivedListener() : counter(0)
+	{
+		dtn::core::EventDispatcher<dtn::core::BundleEvent>::add(this);
+	}
+
+	virtual ~ReceivedListener()
+	{
+		dtn::core::EventDispatcher<dtn::core::BundleEvent>::remove(this);
+	}
+
+	void raiseEvent(const dtn::core::BundleEvent &evt) throw ()
+	{
+		if (evt.getAction() != dtn::core::BUNDLE_RECEIVED) return;
+
+		ibrcommon::MutexLock l(cond);
+		counter++;
+		cond.signal(true);
+	}
+
+	ibrcommon::Conditional cond;
+	unsigned int counter;
+};
+
+static dtn::data::Bundle createBundle(size_t payload)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://server/test");
+	b.destination = dtn::data::EID("dtn://node-one/test");
+	b.lifetime = 3600;
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	{
+		ibrcommon::BLOB::iostream io = ref.iostream();
+		for (size_t i = 0; i < payload; ++i) (*io).put(static_cast<char>('a' + (i % 26)));
+	}
+
+	return b;
+}
+
+template<class T>
+static void waitFor(ibrcommon::Conditional &cond, T &counter, T value)
+{
+	ibrcommon::MutexLock l(cond);
+	try {
+		while (counter < value) cond.wait(20000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("timeout reached");
+	}
+}
+
+void HTTPClTest::setUp() {
+	// create a new event switch
+	_esl = new ibrtest::EventSwitchLoop();
+
+	// enable blob path
+	ibrcommon::File blob_path("/tmp/blobs");
+
+	// check if the BLOB path exists
+	if (!blob_path.exists()) {
+		// try to create the BLOB path
+		ibrcommon::File::createDirectory(blob_path);
+	}
+
+	// enable the blob provider
+	ibrcommon::BLOB::changeProvider(new ibrcommon::FileBLOBProvider(blob_path), true);
+
+	// add standard memory base storage
+	_storage = new dtn::storage::MemoryBundleStorage();
+
+	// make storage globally available
+	dtn::core::BundleCore::getInstance().setStorage(_storage);
+	dtn::core::BundleCore::getInstance().setSeeker(_storage);
+
+	// the router filters duplicates of received bundles
+	_router = new dtn::routing::BaseRouter();
+
+	// start the stand-in server with a long-poll timeout of one second
+	_server = new HTTPStandin(1000);
+	_server->start();
+
+	_cl = new dtn::net::HTTPConvergenceLayer(_server->getURL());
+
+	// initialize BundleCore
+	dtn::core::BundleCore::getInstance().initialize();
+
+	// start-up event switch
+	_esl->start();
+
+	_cl->initialize();
+
+	// startup BundleCore
+	dtn::core::BundleCore::getInstance().startup();
+
+	_cl->startup();
+}
+
+void HTTPClTest::tearDown() {
+	_cl->terminate();
+	delete _cl;
+	_cl = NULL;
+
+	_server->stop();
+	delete _server;
+	_server = NULL;
+
+	_esl->stop();
+
+	// shutdown BundleCore
+	dtn::core::BundleCore::getInstance().terminate();
+
+	_esl->join();
+	delete _esl;
+	_esl = NULL;
+
+	delete _router;
+	_router = NULL;
+
+	// delete storage
+	delete _storage;
+	_storage = NULL;
+}
+
+void HTTPClTest::uploadTest() {
+	const dtn::core::Node n(dtn::data::EID("dtn://server"));
+	const unsigned int count = 500;
+	const unsigned int rounds = 20;
+
+	std::list<dtn::data::MetaBundle> ids;
+	for (unsigned int i = 0; i < (count + rounds); ++i)
+	{
+		dtn::data::Bundle b = createBundle(1024);
+		_storage->store(b);
+		ids.push_back(dtn::data::MetaBundle::create(b));
+	}
+
+	TestEventListener<dtn::net::TransferCompletedEvent> completed;
+	ibrcommon::TimeMeasurement tm;
+
+	// latency of single bundles
+	std::list<dtn::data::MetaBundle>::const_iterator it = ids.begin();
+	tm.start();
+	for (unsigned int i = 0; i < rounds; ++i, ++it)
+	{
+		_cl->queue(n, dtn::net::BundleTransfer(n.getEID(), *it, dtn::core::Node::CONN_HTTP));
+		waitFor(completed.event_cond, completed.event_counter, i + 1);
+	}
+	tm.stop();
+
+	const double latency = tm.getMilliseconds() / rounds;
+
+	// throughput of many queued bundles
+	tm.start();
+	for (; it != ids.end(); ++it)
+	{
+		_cl->queue(n, dtn::net::BundleTransfer(n.getEID(), *it, dtn::core::Node::CONN_HTTP));
+	}
+	waitFor(completed.event_cond, completed.event_counter, count + rounds);
+	tm.stop();
+
+	std::cout << std::endl << "upload: " << static_cast<size_t>(count / (tm.getMilliseconds() / 1000.0)) << " bundles/s, "
+			<< latency << " ms latency" << std::endl;
+
+	ibrcommon::MutexLock l(_server->cond);
+	CPPUNIT_ASSERT_EQUAL((size_t)(count + rounds), _server->uploads.size());
+
+	// all requests share the kept connections
+	CPPUNIT_ASSERT(_server->connections <= 5);
+
+	// the streamed upload contains the whole bundle
+	std::stringstream ss(_server->uploads.front());
+	dtn::data::Bundle b;
+	dtn::data::DefaultDeserializer(ss) >> b;
+
+	CPPUNIT_ASSERT(dtn::data::BundleID(b) == ids.front());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Length)1024, b.find<dtn::data::PayloadBlock>().getLength());
+}
+
+void HTTPClTest::downloadTest() {
+	const unsigned int count = 200;
+	const unsigned int rounds = 20;
+
+	ReceivedListener received;
+	ibrcommon::TimeMeasurement tm;
+
+	// latency of single bundles delivered by the long-poll
+	tm.start();
+	for (unsigned int i = 0; i < rounds; ++i)
+	{
+		std::stringstream ss;
+		dtn::data::DefaultSerializer(ss) << createBundle(1024);
+		_server->push(ss.str());
+
+		waitFor(received.cond, received.counter, i + 1);
+	}
+	tm.stop();
+
+	const double latency = tm.getMilliseconds() / rounds;
+
+	// throughput of many bundles in one response
+	std::stringstream ss;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		dtn::data::DefaultSerializer(ss) << createBundle(1024);
+	}
+
+	tm.start();
+	_server->push(ss.str());
+	waitFor(received.cond, received.counter, count + rounds);
+	tm.stop();
+
+	std::cout << std::endl << "download: " << static_cast<size_t>(count / (tm.getMilliseconds() / 1000.0)) << " bundles/s, "
+			<< latency << " ms latency" << std::endl;
+
+	ibrcommon::MutexLock l(_server->cond);
+	CPPUNIT_ASSERT(_server->connections <= 5);
+}
+
+void HTTPClTest::noDataTest() {
+	// the server answers every long-poll request with 410 at once
+	_server->setPollTimeout(0);
+
+	// let the running long-poll request return
+	ibrcommon::Thread::sleep(1500);
+
+	size_t polls = 0;
+	{
+		ibrcommon::MutexLock l(_server->cond);
+		polls = _server->polls;
+	}
+
+	ibrcommon::Thread::sleep(3000);
+
+	ibrcommon::MutexLock l(_server->cond);
+
+	// the layer waits for the request interval between two polls
+	CPPUNIT_ASSERT(_server->polls > polls);
+	CPPUNIT_ASSERT((_server->polls - polls) <= 4);
+}
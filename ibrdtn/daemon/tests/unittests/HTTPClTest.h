@@ -0,0 +1,54 @@
+/*
+ * HTTPClTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "storage/BundleStorage.h"
+#include "routing/BaseRouter.h"
+#include "net/HTTPConvergenceLayer.h"
+#include "../tools/EventSwitchLoop.h"
+
+#ifndef HTTPCLTEST_H_
+#define HTTPCLTEST_H_
+
+class HTTPStandin;
+
+class HTTPClTest : public CppUnit::TestFixture {
+	dtn::storage::BundleStorage *_storage;
+	dtn::routing::BaseRouter *_router;
+	ibrtest::EventSwitchLoop *_esl;
+	HTTPStandin *_server;
+	dtn::net::HTTPConvergenceLayer *_cl;
+
+	void uploadTest();
+	void downloadTest();
+	void noDataTest();
+
+public:
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(HTTPClTest);
+	CPPUNIT_TEST(uploadTest);
+	CPPUNIT_TEST(downloadTest);
+	CPPUNIT_TEST(noDataTest);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* HTTPCLTEST_H_ */
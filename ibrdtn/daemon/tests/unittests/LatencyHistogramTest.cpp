@@ -0,0 +1,149 @@
+/*
+ * LatencyHistogramTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LatencyHistogramTest.h"
+#include "core/LatencyHistogram.h"
+#include "core/LatencyTracer.h"
+#include <ibrdtn/data/BundleID.h>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LatencyHistogramTest);
+
+void LatencyHistogramTest::setUp()
+{
+}
+
+void LatencyHistogramTest::tearDown()
+{
+	dtn::core::LatencyTracer::getInstance().setSampling(0);
+	dtn::core::LatencyTracer::getInstance().reset();
+}
+
+void LatencyHistogramTest::testBuckets()
+{
+	using dtn::core::LatencyHistogram;
+
+	// small values are counted exactly
+	for (uint64_t v = 0; v < 16; ++v)
+	{
+		const unsigned int b = LatencyHistogram::getBucket(v);
+		CPPUNIT_ASSERT_EQUAL(v, LatencyHistogram::getLowerBound(b));
+		CPPUNIT_ASSERT_EQUAL(v, LatencyHistogram::getUpperBound(b));
+	}
+
+	// every value lies within the bounds of its bucket
+	uint64_t values[] = { 16, 17, 100, 1000, 4095, 4096, 123456, 1000000, 3600000000ULL, 0xffffffffffffffffULL };
+
+	for (unsigned int i = 0; i < sizeof(values) / sizeof(uint64_t); ++i)
+	{
+		const unsigned int b = LatencyHistogram::getBucket(values[i]);
+		CPPUNIT_ASSERT(LatencyHistogram::getLowerBound(b) <= values[i]);
+		CPPUNIT_ASSERT(LatencyHistogram::getUpperBound(b) >= values[i]);
+
+		// the relative error is bounded by the sub-buckets
+		CPPUNIT_ASSERT((LatencyHistogram::getUpperBound(b) - LatencyHistogram::getLowerBound(b)) <= (values[i] / 8));
+	}
+
+	// buckets are contiguous
+	for (unsigned int b = 1; b < 16 + (60 * 8); ++b)
+	{
+		CPPUNIT_ASSERT_EQUAL(LatencyHistogram::getUpperBound(b - 1) + 1, LatencyHistogram::getLowerBound(b));
+	}
+}
+
+void LatencyHistogramTest::testPercentile()
+{
+	dtn::core::LatencyHistogram h;
+
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, h.count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, h.percentile(50));
+
+	for (uint64_t v = 1; v <= 1000; ++v) h.record(v);
+
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1000, h.count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1000, h.max());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)500, h.mean());
+
+	// percentiles are within the precision of the buckets
+	const uint64_t p50 = h.percentile(50);
+	CPPUNIT_ASSERT((p50 >= 500 - 500 / 8) && (p50 <= 500 + 500 / 8));
+
+	const uint64_t p99 = h.percentile(99);
+	CPPUNIT_ASSERT((p99 >= 990 - 990 / 8) && (p99 <= 1000));
+
+	std::stringstream ss;
+	h.dump(ss);
+	CPPUNIT_ASSERT(ss.str().length() > 0);
+
+	h.reset();
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, h.count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, h.max());
+}
+
+void LatencyHistogramTest::testTracer()
+{
+	using dtn::core::LatencyTracer;
+
+	LatencyTracer &tracer = LatencyTracer::getInstance();
+	tracer.reset();
+
+	dtn::data::BundleID id;
+	id.timestamp = 1000;
+	id.sequencenumber = 0;
+
+	// tracing is disabled
+	tracer.mark(id, LatencyTracer::STAGE_RECEIVED);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, tracer.size());
+
+	tracer.setSampling(1);
+
+	tracer.mark(id, LatencyTracer::STAGE_RECEIVED);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, tracer.size());
+
+	tracer.mark(id, LatencyTracer::STAGE_STORED);
+	tracer.mark(id, LatencyTracer::STAGE_QUEUED);
+
+	// a second transfer of the same bundle is not counted
+	tracer.mark(id, LatencyTracer::STAGE_QUEUED);
+
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1, tracer.get(LatencyTracer::INTERVAL_STORAGE).count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1, tracer.get(LatencyTracer::INTERVAL_ROUTING).count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, tracer.get(LatencyTracer::INTERVAL_TRANSFER).count());
+
+	tracer.mark(id, LatencyTracer::STAGE_TRANSMITTED);
+
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1, tracer.get(LatencyTracer::INTERVAL_TRANSFER).count());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1, tracer.get(LatencyTracer::INTERVAL_TOTAL).count());
+
+	// the trace is complete
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, tracer.size());
+
+	// bundles outside of the sample are not traced
+	tracer.setSampling(2);
+	id.sequencenumber = 1;
+	tracer.mark(id, LatencyTracer::STAGE_RECEIVED);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, tracer.size());
+
+	std::stringstream ss;
+	tracer.summary(ss);
+	CPPUNIT_ASSERT(ss.str().find("Total:") != std::string::npos);
+
+	tracer.reset();
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, tracer.get(LatencyTracer::INTERVAL_TOTAL).count());
+}
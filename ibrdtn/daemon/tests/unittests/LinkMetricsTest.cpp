@@ -0,0 +1,189 @@
+/*
+ * LinkMetricsTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "LinkMetricsTest.h"
+#include "net/LinkMetrics.h"
+#include "net/BundleTransfer.h"
+#include "../tools/EventSwitchLoop.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/thread/Thread.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(LinkMetricsTest);
+
+void LinkMetricsTest::setUp()
+{
+}
+
+void LinkMetricsTest::tearDown()
+{
+	dtn::net::LinkMetrics::resetStats();
+}
+
+void LinkMetricsTest::testCounters()
+{
+	using dtn::net::LinkMetrics;
+
+	LinkMetrics::Handle m = LinkMetrics::get(dtn::data::EID("dtn://counters/app"), dtn::core::Node::CONN_TCPIP);
+
+	// the same object is returned for any endpoint of the node
+	CPPUNIT_ASSERT(m == LinkMetrics::get(dtn::data::EID("dtn://counters"), dtn::core::Node::CONN_TCPIP));
+	CPPUNIT_ASSERT(!(m == LinkMetrics::get(dtn::data::EID("dtn://counters"), dtn::core::Node::CONN_UDPIP)));
+
+	m->addTrafficIn(100);
+	m->addTrafficIn(50);
+	m->addTrafficOut(10);
+	m->addRetransmission(3);
+	m->addTransfer();
+	m->addAbort(dtn::net::TransferAbortedEvent::REASON_REFUSED);
+	m->addAbort(dtn::net::TransferAbortedEvent::REASON_REFUSED);
+	m->setQueueDepth(7);
+
+	dtn::net::ConvergenceLayer::stats_data data;
+	LinkMetrics::getStats(dtn::data::EID("dtn://counters"), data);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("150"), data["TCP|in"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("10"), data["TCP|out"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("3"), data["TCP|retransmissions"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("1"), data["TCP|transfers"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("2"), data["TCP|aborted_refused"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), data["TCP|aborted_down"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("7"), data["TCP|queue"]);
+
+	// the untouched UDP link is reported too
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), data["UDP|in"]);
+
+	// the first sample initializes the round-trip-time
+	m->addRoundTripTime(8000);
+	m->addRoundTripTime(16000);
+
+	data.clear();
+	LinkMetrics::getStats(dtn::data::EID("dtn://counters"), data);
+	CPPUNIT_ASSERT_EQUAL(std::string("9000"), data["TCP|rtt"]);
+
+	m->reset();
+
+	data.clear();
+	LinkMetrics::getStats(dtn::data::EID("dtn://counters"), data);
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), data["TCP|in"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), data["TCP|aborted_refused"]);
+}
+
+void LinkMetricsTest::testRate()
+{
+	using dtn::net::LinkMetrics;
+
+	LinkMetrics::Handle m = LinkMetrics::get(dtn::data::EID("dtn://rate"), dtn::core::Node::CONN_TCPIP);
+
+	m->addTrafficOut(LinkMetrics::WINDOW * 1000);
+
+	// the current second does not count
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, m->getRateOut());
+
+	ibrcommon::Thread::sleep(1100);
+
+	CPPUNIT_ASSERT_EQUAL((uint64_t)1000, m->getRateOut());
+	CPPUNIT_ASSERT_EQUAL((uint64_t)0, m->getRateIn());
+}
+
+void LinkMetricsTest::testStats()
+{
+	using dtn::net::LinkMetrics;
+
+	LinkMetrics::get(dtn::data::EID("dtn://stats"), dtn::core::Node::CONN_TCPIP)->addTrafficIn(42);
+
+	dtn::net::ConvergenceLayer::stats_data data;
+	LinkMetrics::getStats(data);
+
+	CPPUNIT_ASSERT_EQUAL(std::string("42"), data["dtn://stats|TCP|in"]);
+	CPPUNIT_ASSERT(data.find("dtn://stats|TCP|in_rate") != data.end());
+}
+
+void LinkMetricsTest::testRemove()
+{
+	using dtn::net::LinkMetrics;
+
+	LinkMetrics::Handle m = LinkMetrics::get(dtn::data::EID("dtn://remove/app"), dtn::core::Node::CONN_TCPIP);
+	m->addTrafficIn(42);
+	LinkMetrics::get(dtn::data::EID("dtn://remove"), dtn::core::Node::CONN_UDPIP)->addTrafficIn(1);
+	LinkMetrics::get(dtn::data::EID("dtn://other"), dtn::core::Node::CONN_TCPIP)->addTrafficIn(7);
+
+	LinkMetrics::remove(dtn::data::EID("dtn://remove"));
+
+	// all links to the node are gone, other nodes are kept
+	dtn::net::ConvergenceLayer::stats_data data;
+	LinkMetrics::getStats(data);
+	CPPUNIT_ASSERT(data.find("dtn://remove|TCP|in") == data.end());
+	CPPUNIT_ASSERT(data.find("dtn://remove|UDP|in") == data.end());
+	CPPUNIT_ASSERT_EQUAL(std::string("7"), data["dtn://other|TCP|in"]);
+
+	// the handle of a connection remains usable
+	m->addTrafficIn(8);
+
+	// a new link gets new metrics
+	LinkMetrics::Handle n = LinkMetrics::get(dtn::data::EID("dtn://remove"), dtn::core::Node::CONN_TCPIP);
+	CPPUNIT_ASSERT(!(m == n));
+
+	data.clear();
+	LinkMetrics::getStats(dtn::data::EID("dtn://remove"), data);
+	CPPUNIT_ASSERT_EQUAL(std::string("0"), data["TCP|in"]);
+}
+
+void LinkMetricsTest::testTransfer()
+{
+	using dtn::net::LinkMetrics;
+
+	// finished transfers raise events
+	ibrtest::EventSwitchLoop esl; esl.start();
+
+	LinkMetrics::Handle m = LinkMetrics::get(dtn::data::EID("dtn://transfer"), dtn::core::Node::CONN_TCPIP);
+
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://source/app");
+	b.destination = dtn::data::EID("dtn://transfer/app");
+	const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(b);
+
+	// the result of a transfer is recorded in the metrics of the connection
+	{
+		dtn::net::BundleTransfer job(dtn::data::EID("dtn://transfer"), meta, dtn::core::Node::CONN_TCPIP);
+		job.setMetrics(m);
+		job.complete();
+	}
+
+	{
+		dtn::net::BundleTransfer job(dtn::data::EID("dtn://transfer"), meta, dtn::core::Node::CONN_TCPIP);
+		job.setMetrics(m);
+		job.abort(dtn::net::TransferAbortedEvent::REASON_REFUSED);
+	}
+
+	// transfers without metrics do not create a link
+	{
+		dtn::net::BundleTransfer job(dtn::data::EID("dtn://nometrics"), meta, dtn::core::Node::CONN_TCPIP);
+		job.complete();
+	}
+
+	dtn::net::ConvergenceLayer::stats_data data;
+	LinkMetrics::getStats(dtn::data::EID("dtn://transfer"), data);
+	CPPUNIT_ASSERT_EQUAL(std::string("1"), data["TCP|transfers"]);
+	CPPUNIT_ASSERT_EQUAL(std::string("1"), data["TCP|aborted_refused"]);
+
+	data.clear();
+	LinkMetrics::getStats(data);
+	CPPUNIT_ASSERT(data.find("dtn://nometrics|TCP|transfers") == data.end());
+}
@@ -0,0 +1,47 @@
+/*
+ * LinkMetricsTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef LINKMETRICSTEST_H_
+#define LINKMETRICSTEST_H_
+
+class LinkMetricsTest : public CppUnit::TestFixture
+{
+public:
+	void testCounters();
+	void testRate();
+	void testStats();
+	void testRemove();
+	void testTransfer();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(LinkMetricsTest);
+	CPPUNIT_TEST(testCounters);
+	CPPUNIT_TEST(testRate);
+	CPPUNIT_TEST(testStats);
+	CPPUNIT_TEST(testRemove);
+	CPPUNIT_TEST(testTransfer);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* LINKMETRICSTEST_H_ */
@@ -0,0 +1,291 @@
+/*
+ * NodeHandshakeTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "NodeHandshakeTest.h"
+#include "routing/NodeHandshake.h"
+#include "routing/HandshakeDeltaTable.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleSet.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NodeHandshakeTest);
+
+using namespace dtn::routing;
+
+static const dtn::data::EID node_a("dtn://node-a");
+static const dtn::data::EID node_b("dtn://node-b");
+
+static void addBundle(dtn::data::BundleSet &set, size_t i)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node-b/app");
+	b.timestamp = i;
+	b.sequencenumber = i;
+	b.lifetime = 3600;
+	set.add(dtn::data::MetaBundle::create(b));
+}
+
+static bool equals(const ibrcommon::BloomFilter &left, const ibrcommon::BloomFilter &right)
+{
+	if (left.size() != right.size()) return false;
+	return ::memcmp(left.table(), right.table(), left.size()) == 0;
+}
+
+/**
+ * Simulates one handshake of node A asking node B for its summary and purge
+ * vector. If no delta table is given for A, A behaves like an implementation
+ * without delta support.
+ * @return The number of bytes of request and response
+ */
+static size_t exchange(HandshakeDeltaTable *a, HandshakeDeltaTable &b,
+		const dtn::data::BundleSet &summary, const dtn::data::BundleSet &purged,
+		ibrcommon::BloomFilter &sv, ibrcommon::BloomFilter &pv, bool deliver = true)
+{
+	std::stringstream request_data;
+	{
+		NodeHandshake request(NodeHandshake::HANDSHAKE_REQUEST);
+		request.addRequest(BloomFilterSummaryVector::identifier);
+		request.addRequest(BloomFilterPurgeVector::identifier);
+		if (a != NULL) a->request(node_b, request);
+		request_data << request;
+	}
+
+	std::stringstream response_data;
+	{
+		NodeHandshake request;
+		request_data >> request;
+
+		NodeHandshake response(NodeHandshake::HANDSHAKE_RESPONSE);
+
+		if (request.hasRequest(SummaryVectorDelta::identifier))
+		{
+			SummaryVectorDelta *item = new SummaryVectorDelta();
+			b.response(node_a, request, summary.getBloomFilter(), *item);
+			response.addItem(item);
+		}
+		else
+		{
+			response.addItem(new BloomFilterSummaryVector(summary));
+		}
+
+		if (request.hasRequest(PurgeVectorDelta::identifier))
+		{
+			PurgeVectorDelta *item = new PurgeVectorDelta();
+			b.response(node_a, request, purged.getBloomFilter(), *item);
+			response.addItem(item);
+		}
+		else
+		{
+			response.addItem(new BloomFilterPurgeVector(purged));
+		}
+
+		response_data << response;
+	}
+
+	const size_t bytes = request_data.str().size() + response_data.str().size();
+
+	// the response got lost
+	if (!deliver) return bytes;
+
+	NodeHandshake response;
+	response_data >> response;
+
+	if (a != NULL)
+	{
+		CPPUNIT_ASSERT(a->process(node_b, response.get<SummaryVectorDelta>(), sv));
+		CPPUNIT_ASSERT(a->process(node_b, response.get<PurgeVectorDelta>(), pv));
+	}
+	else
+	{
+		sv = response.get<BloomFilterSummaryVector>().getVector().getBloomFilter();
+		pv = response.get<BloomFilterPurgeVector>().getVector().getBloomFilter();
+	}
+
+	return bytes;
+}
+
+void NodeHandshakeTest::setUp()
+{
+}
+
+void NodeHandshakeTest::tearDown()
+{
+}
+
+void NodeHandshakeTest::testRequestItems()
+{
+	std::stringstream ss;
+
+	{
+		NodeHandshake request(NodeHandshake::HANDSHAKE_REQUEST);
+		request.addRequest(BloomFilterSummaryVector::identifier);
+		request.addRequest(SummaryVectorDelta::identifier);
+
+		DeltaVersionSet *versions = new DeltaVersionSet();
+		versions->set(SummaryVectorDelta::identifier, 42);
+		request.addItem(versions);
+
+		ss << request;
+	}
+
+	const std::string data = ss.str();
+
+	// parse the request with items
+	NodeHandshake request;
+	ss >> request;
+
+	CPPUNIT_ASSERT(request.getType() == NodeHandshake::HANDSHAKE_REQUEST);
+	CPPUNIT_ASSERT(request.hasRequest(BloomFilterSummaryVector::identifier));
+	CPPUNIT_ASSERT(request.hasRequest(SummaryVectorDelta::identifier));
+
+	const NodeHandshake &const_request = request;
+	const DeltaVersionSet &versions = const_request.get<DeltaVersionSet>();
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Number(42), versions.get(SummaryVectorDelta::identifier));
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Number(0), versions.get(PurgeVectorDelta::identifier));
+
+	// a request without items is encoded as before
+	std::stringstream plain;
+	{
+		NodeHandshake request(NodeHandshake::HANDSHAKE_REQUEST);
+		request.addRequest(BloomFilterSummaryVector::identifier);
+		request.addRequest(SummaryVectorDelta::identifier);
+		plain << request;
+	}
+
+	// the items are appended to the plain encoding
+	CPPUNIT_ASSERT(data.size() > plain.str().size());
+	CPPUNIT_ASSERT_EQUAL(plain.str(), data.substr(0, plain.str().size()));
+
+	NodeHandshake plain_request;
+	plain >> plain_request;
+	CPPUNIT_ASSERT(plain_request.hasRequest(SummaryVectorDelta::identifier));
+	CPPUNIT_ASSERT_THROW(plain_request.get<DeltaVersionSet>(), ibrcommon::Exception);
+}
+
+void NodeHandshakeTest::testDeltaExchange()
+{
+	// two nodes exchanging vectors with and without delta support
+	HandshakeDeltaTable table_a, table_b;
+	HandshakeDeltaTable full_b;
+
+	dtn::data::BundleSet summary;
+	dtn::data::BundleSet purged;
+
+	ibrcommon::BloomFilter sv, pv;
+	ibrcommon::BloomFilter full_sv, full_pv;
+
+	size_t bytes_delta = 0;
+	size_t bytes_full = 0;
+	size_t next = 0;
+
+	for (; next < 50; ++next) addBundle(summary, next);
+
+	for (size_t round = 0; round < 20; ++round)
+	{
+		// a few changes between two contacts
+		for (size_t i = 0; i < 3; ++i, ++next) addBundle(summary, next);
+		if (round % 4 == 0) addBundle(purged, round);
+
+		bytes_delta += exchange(&table_a, table_b, summary, purged, sv, pv);
+		bytes_full += exchange(NULL, full_b, summary, purged, full_sv, full_pv);
+
+		// both nodes know the same vectors
+		CPPUNIT_ASSERT(equals(summary.getBloomFilter(), sv));
+		CPPUNIT_ASSERT(equals(purged.getBloomFilter(), pv));
+		CPPUNIT_ASSERT(equals(full_sv, sv));
+		CPPUNIT_ASSERT(equals(full_pv, pv));
+	}
+
+	std::cout << std::endl << "handshake bytes of 20 exchanges: " << bytes_full << " full, " << bytes_delta << " delta" << std::endl;
+
+	CPPUNIT_ASSERT(bytes_delta < bytes_full);
+	CPPUNIT_ASSERT_EQUAL((size_t)1, table_a.size());
+	CPPUNIT_ASSERT_EQUAL((size_t)1, table_b.size());
+}
+
+void NodeHandshakeTest::testDeltaMismatch()
+{
+	HandshakeDeltaTable table_a, table_b;
+	dtn::data::BundleSet summary;
+	dtn::data::BundleSet purged;
+	ibrcommon::BloomFilter sv, pv;
+
+	for (size_t i = 0; i < 10; ++i) addBundle(summary, i);
+
+	// first exchange transfers the full vectors
+	const size_t first = exchange(&table_a, table_b, summary, purged, sv, pv);
+	CPPUNIT_ASSERT(equals(summary.getBloomFilter(), sv));
+
+	// the next response is lost
+	addBundle(summary, 10);
+	const size_t lost = exchange(&table_a, table_b, summary, purged, sv, pv, false);
+	CPPUNIT_ASSERT(lost < first);
+
+	// node B falls back to the full vectors
+	addBundle(summary, 11);
+	const size_t recovered = exchange(&table_a, table_b, summary, purged, sv, pv);
+	CPPUNIT_ASSERT(recovered > lost);
+	CPPUNIT_ASSERT(equals(summary.getBloomFilter(), sv));
+
+	// and continues with deltas
+	addBundle(summary, 12);
+	exchange(&table_a, table_b, summary, purged, sv, pv);
+	CPPUNIT_ASSERT(equals(summary.getBloomFilter(), sv));
+
+	// a delta with an unknown base is rejected
+	HandshakeDeltaTable table_c;
+	SummaryVectorDelta delta;
+	delta.assign(5, std::string((const char*)sv.table(), sv.size()), 6, summary.getBloomFilter());
+	CPPUNIT_ASSERT(!delta.isFull());
+	CPPUNIT_ASSERT(!table_c.process(node_b, delta, sv));
+}
+
+void NodeHandshakeTest::testAggregateRecordSupport()
+{
+	std::stringstream ss;
+
+	{
+		NodeHandshake response(NodeHandshake::HANDSHAKE_RESPONSE);
+		response.addItem(new BloomFilterPurgeVector(dtn::data::BundleSet()));
+		response.addItem(new AggregateRecordSupport());
+		ss << response;
+	}
+
+	NodeHandshake response;
+	ss >> response;
+
+	// the empty item announces the support
+	response.get<AggregateRecordSupport>();
+	response.get<BloomFilterPurgeVector>();
+
+	// a node without support does not answer the request
+	std::stringstream plain;
+	{
+		NodeHandshake response(NodeHandshake::HANDSHAKE_RESPONSE);
+		response.addItem(new BloomFilterPurgeVector(dtn::data::BundleSet()));
+		plain << response;
+	}
+
+	NodeHandshake old;
+	plain >> old;
+	CPPUNIT_ASSERT_THROW(old.get<AggregateRecordSupport>(), ibrcommon::Exception);
+}
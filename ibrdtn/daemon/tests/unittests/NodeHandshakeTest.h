@@ -0,0 +1,45 @@
+/*
+ * NodeHandshakeTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef NODEHANDSHAKETEST_H_
+#define NODEHANDSHAKETEST_H_
+
+class NodeHandshakeTest : public CppUnit::TestFixture
+{
+public:
+	void testRequestItems();
+	void testDeltaExchange();
+	void testDeltaMismatch();
+	void testAggregateRecordSupport();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(NodeHandshakeTest);
+	CPPUNIT_TEST(testRequestItems);
+	CPPUNIT_TEST(testDeltaExchange);
+	CPPUNIT_TEST(testDeltaMismatch);
+	CPPUNIT_TEST(testAggregateRecordSupport);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* NODEHANDSHAKETEST_H_ */
@@ -0,0 +1,145 @@
+/*
+ * ReportAggregatorTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ReportAggregatorTest.h"
+#include "core/BundleCore.h"
+#include "core/ReportAggregator.h"
+#include "storage/MemoryBundleStorage.h"
+#include "Component.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ReportAggregatorTest);
+
+static dtn::data::MetaBundle createMeta(const dtn::data::EID &reportto, const dtn::data::Number &seq)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://source/app");
+	b.destination = dtn::data::EID("dtn://destination/app");
+	b.reportto = reportto;
+	b.custodian = reportto;
+	b.sequencenumber = seq;
+	b.lifetime = 3600;
+	return dtn::data::MetaBundle::create(b);
+}
+
+void ReportAggregatorTest::setUp()
+{
+	_esl = new ibrtest::EventSwitchLoop();
+
+	// enable blob path
+	ibrcommon::File blob_path("/tmp/blobs");
+	if (!blob_path.exists()) ibrcommon::File::createDirectory(blob_path);
+	ibrcommon::BLOB::changeProvider(new ibrcommon::FileBLOBProvider(blob_path), true);
+
+	_storage = new dtn::storage::MemoryBundleStorage();
+	dtn::core::BundleCore::getInstance().setStorage(_storage);
+	dtn::core::BundleCore::getInstance().setSeeker(_storage);
+
+	dtn::core::BundleCore::getInstance().initialize();
+	_esl->start();
+
+	dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(*_storage);
+	c.initialize();
+
+	dtn::core::BundleCore::getInstance().startup();
+	c.startup();
+
+	dtn::core::BundleCore::getInstance().getReportAggregator().resetStats();
+}
+
+void ReportAggregatorTest::tearDown()
+{
+	// disable the aggregation
+	dtn::core::BundleCore::getInstance().getReportAggregator().setWindow(0);
+
+	_esl->stop();
+
+	dtn::daemon::Component &c = dynamic_cast<dtn::daemon::Component&>(*_storage);
+	c.terminate();
+
+	dtn::core::BundleCore::getInstance().terminate();
+
+	_esl->join();
+	delete _esl;
+	_esl = NULL;
+
+	dtn::core::BundleCore::getInstance().setStorage(NULL);
+	dtn::core::BundleCore::getInstance().setSeeker(NULL);
+	delete _storage;
+	_storage = NULL;
+}
+
+void ReportAggregatorTest::testSupport()
+{
+	dtn::core::ReportAggregator &aggregator = dtn::core::BundleCore::getInstance().getReportAggregator();
+	aggregator.setWindow(60);
+
+	const dtn::data::EID remote("dtn://unknown-peer/reports");
+
+	// records to nodes without announced support are sent individually
+	CPPUNIT_ASSERT(!aggregator.isSupported(remote));
+	CPPUNIT_ASSERT(!aggregator.add(createMeta(remote, 1), dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION));
+	CPPUNIT_ASSERT(!aggregator.add(createMeta(remote, 1), true, dtn::data::CustodySignalBlock::NO_ADDITIONAL_INFORMATION));
+
+	// local applications always understand aggregate records
+	dtn::data::EID local = dtn::core::BundleCore::local;
+	local.setApplication("reports");
+	CPPUNIT_ASSERT(aggregator.add(createMeta(local, 2), dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION));
+
+	// the node announced the support in a handshake
+	const dtn::data::EID peer("dtn://aggregate-peer/reports");
+	aggregator.setSupported(dtn::data::EID("dtn://aggregate-peer"));
+
+	CPPUNIT_ASSERT(aggregator.isSupported(peer));
+	CPPUNIT_ASSERT(aggregator.add(createMeta(peer, 3), dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION));
+	CPPUNIT_ASSERT(aggregator.add(createMeta(peer, 3), true, dtn::data::CustodySignalBlock::NO_ADDITIONAL_INFORMATION));
+
+	// only the two individual records have been sent so far
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)5, aggregator.getRecords());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, aggregator.getBundles());
+}
+
+void ReportAggregatorTest::testFlushOnShutdown()
+{
+	dtn::core::ReportAggregator &aggregator = dtn::core::BundleCore::getInstance().getReportAggregator();
+	aggregator.setWindow(60);
+
+	const dtn::data::EID peer("dtn://aggregate-peer/reports");
+	aggregator.setSupported(dtn::data::EID("dtn://aggregate-peer"));
+
+	CPPUNIT_ASSERT(aggregator.add(createMeta(peer, 1), dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION));
+	CPPUNIT_ASSERT(aggregator.add(createMeta(peer, 2), dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION));
+	CPPUNIT_ASSERT(aggregator.add(createMeta(peer, 1), true, dtn::data::CustodySignalBlock::NO_ADDITIONAL_INFORMATION));
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, aggregator.getBundles());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, _storage->count());
+
+	// the pending aggregates are sent before the core goes down
+	dtn::core::BundleCore::getInstance().terminate();
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, aggregator.getBundles());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, _storage->count());
+
+	// bring the core up again for the tear down
+	dtn::core::BundleCore::getInstance().initialize();
+	dtn::core::BundleCore::getInstance().startup();
+}
@@ -0,0 +1,46 @@
+/*
+ * ReportAggregatorTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "storage/BundleStorage.h"
+#include "../tools/EventSwitchLoop.h"
+
+#ifndef REPORTAGGREGATORTEST_H_
+#define REPORTAGGREGATORTEST_H_
+
+class ReportAggregatorTest : public CppUnit::TestFixture
+{
+	dtn::storage::BundleStorage *_storage;
+	ibrtest::EventSwitchLoop *_esl;
+
+public:
+	void testSupport();
+	void testFlushOnShutdown();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(ReportAggregatorTest);
+	CPPUNIT_TEST(testSupport);
+	CPPUNIT_TEST(testFlushOnShutdown);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* REPORTAGGREGATORTEST_H_ */
@@ -0,0 +1,466 @@
+/*
+ * TCPClTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "TCPClTest.h"
+#include "../tools/TestEventListener.h"
+#include "storage/MemoryBundleStorage.h"
+#include "routing/NeighborRoutingExtension.h"
+#include "routing/RequeueBundleEvent.h"
+#include "net/TransferCompletedEvent.h"
+#include "net/TransferAbortedEvent.h"
+#include "net/ConnectionEvent.h"
+#include "core/BundleCore.h"
+#include "routing/QueueBundleEvent.h"
+#include "Configuration.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/Serializer.h>
+#include <ibrdtn/streams/StreamConnection.h>
+#include <ibrcommon/net/socket.h>
+#include <ibrcommon/net/socketstream.h>
+#include <ibrcommon/net/vinterface.h>
+#include <ibrcommon/data/BLOB.h>
+#include <ibrcommon/data/File.h>
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TCPClTest);
+
+/**
+ * A neighbor of the tested node speaking TCPCL. It either reads whole
+ * bundles or raw bytes, in the latter case the connection is killed
+ * after the given number of bytes.
+ */
+static int connectTo(int port)
+{
+	const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+	struct sockaddr_in addr;
+	::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	addr.sin_port = htons(port);
+
+	if (::connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == -1)
+	{
+		::close(fd);
+		throw ibrcommon::Exception("could not connect to the node");
+	}
+
+	return fd;
+}
+
+class TCPPeer : public ibrcommon::JoinableThread, public dtn::streams::StreamConnection::Callback
+{
+	ibrcommon::socketstream _conn;
+	const dtn::data::EID _eid;
+	const size_t _limit;
+
+public:
+	TCPPeer(const dtn::data::EID &eid, int port, size_t limit = 0)
+	 : _conn(new ibrcommon::tcpsocket(connectTo(port))), _eid(eid), _limit(limit),
+	   stream(*this, _conn), bundles(0), bytes(0), closed(false)
+	{
+	}
+
+	virtual ~TCPPeer()
+	{
+		stop();
+		join();
+	}
+
+	void handshake()
+	{
+		stream.handshake(_eid, 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+	}
+
+	/**
+	 * Send a part of a serialized bundle, the bundle ends with end()
+	 */
+	void write(const std::string &data, size_t offset, size_t length)
+	{
+		stream.write(data.data() + offset, length);
+	}
+
+	void end()
+	{
+		stream << std::flush;
+	}
+
+	/**
+	 * Close the socket without a shutdown of the protocol
+	 */
+	void kill()
+	{
+		_conn.close();
+	}
+
+	void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () { };
+	void eventTimeout() throw () { };
+	void eventError() throw () { };
+	void eventBundleRefused() throw () { };
+	void eventBundleForwarded() throw () { };
+	void eventBundleAck(const dtn::data::Length&) throw () { };
+	void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () { };
+	void eventConnectionDown() throw () { };
+
+	dtn::streams::StreamConnection stream;
+
+	ibrcommon::Conditional cond;
+	unsigned int bundles;
+	size_t bytes;
+	bool closed;
+
+protected:
+	void run() throw ()
+	{
+		try {
+			while (_conn.good())
+			{
+				if (_limit == 0)
+				{
+					dtn::data::Bundle b;
+					dtn::data::DefaultDeserializer(stream) >> b;
+
+					ibrcommon::MutexLock l(cond);
+					bundles++;
+					cond.signal(true);
+				}
+				else
+				{
+					char buf[1024];
+					stream.read(buf, sizeof(buf));
+
+					ibrcommon::MutexLock l(cond);
+					bytes += stream.gcount();
+					cond.signal(true);
+
+					if (!stream.good()) break;
+					if (bytes >= _limit)
+					{
+						kill();
+						break;
+					}
+				}
+			}
+		} catch (const std::exception&) {
+			// connection closed
+		}
+
+		ibrcommon::MutexLock l(cond);
+		closed = true;
+		cond.signal(true);
+	}
+
+	void __cancellation() throw ()
+	{
+		_conn.close();
+	}
+};
+
+static dtn::data::Bundle createBundle(size_t payload)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://source/app");
+	b.destination = dtn::data::EID("dtn://sink/app");
+	b.lifetime = 3600;
+	b.set(dtn::data::PrimaryBlock::DESTINATION_IS_SINGLETON, true);
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	b.push_back(ref);
+
+	{
+		ibrcommon::BLOB::iostream io = ref.iostream();
+		for (size_t i = 0; i < payload; ++i) (*io).put(static_cast<char>('a' + (i % 26)));
+	}
+
+	return b;
+}
+
+static std::string serialize(const dtn::data::Bundle &b)
+{
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+	return ss.str();
+}
+
+template<class T>
+static void waitFor(ibrcommon::Conditional &cond, T &counter, T value)
+{
+	ibrcommon::MutexLock l(cond);
+	try {
+		while (counter < value) cond.wait(10000);
+	} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+		CPPUNIT_FAIL("timeout reached");
+	}
+}
+
+static int getFreePort()
+{
+	const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+
+	struct sockaddr_in addr;
+	::memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	socklen_t len = sizeof(addr);
+	::bind(fd, (struct sockaddr*)&addr, len);
+	::getsockname(fd, (struct sockaddr*)&addr, &len);
+	::close(fd);
+
+	return ntohs(addr.sin_port);
+}
+
+void TCPClTest::setUp() {
+	// peers close their sockets while the node may still write
+	::signal(SIGPIPE, SIG_IGN);
+
+	// create a new event switch
+	_esl = new ibrtest::EventSwitchLoop();
+
+	// enable blob path
+	ibrcommon::File blob_path("/tmp/blobs");
+
+	// check if the BLOB path exists
+	if (!blob_path.exists()) {
+		// try to create the BLOB path
+		ibrcommon::File::createDirectory(blob_path);
+	}
+
+	// enable the blob provider
+	ibrcommon::BLOB::changeProvider(new ibrcommon::FileBLOBProvider(blob_path), true);
+
+	// enable cut-through forwarding
+	{
+		std::ofstream conf("/tmp/tcpcltest.conf");
+		conf << "tcp_cut_through = yes" << std::endl;
+	}
+	dtn::daemon::Configuration::getInstance(true).load("/tmp/tcpcltest.conf", true);
+
+	// add standard memory base storage
+	_storage = new dtn::storage::MemoryBundleStorage();
+
+	// make storage globally available
+	dtn::core::BundleCore::getInstance().setStorage(_storage);
+	dtn::core::BundleCore::getInstance().setSeeker(_storage);
+
+	// forward bundles to their destination if it is a neighbor
+	_router = new dtn::routing::BaseRouter();
+	_router->add(new dtn::routing::NeighborRoutingExtension());
+
+	_port = getFreePort();
+	_cl = new dtn::net::TCPConvergenceLayer();
+	_cl->add(ibrcommon::vinterface(ibrcommon::vinterface::LOOPBACK), _port);
+
+	// add convergence layer to bundle core
+	dtn::core::BundleCore::getInstance().getConnectionManager().add(_cl);
+
+	// initialize BundleCore
+	dtn::core::BundleCore::getInstance().initialize();
+
+	_local = dtn::core::BundleCore::local;
+	dtn::core::BundleCore::local = dtn::data::EID("dtn://relay");
+
+	// start-up event switch
+	_esl->start();
+
+	_router->initialize();
+	_cl->initialize();
+
+	// startup BundleCore
+	dtn::core::BundleCore::getInstance().startup();
+
+	_router->startup();
+	_cl->startup();
+}
+
+void TCPClTest::tearDown() {
+	// close all connections
+	_cl->terminate();
+	_router->terminate();
+
+	_esl->stop();
+
+	// shutdown BundleCore
+	dtn::core::BundleCore::getInstance().terminate();
+
+	dtn::core::BundleCore::getInstance().getConnectionManager().remove(_cl);
+
+	delete _cl;
+	_cl = NULL;
+
+	_esl->join();
+	delete _esl;
+	_esl = NULL;
+
+	delete _router;
+	_router = NULL;
+
+	// delete storage
+	delete _storage;
+	_storage = NULL;
+
+	dtn::core::BundleCore::local = _local;
+
+	// restore the default configuration
+	dtn::daemon::Configuration::getInstance(true);
+	ibrcommon::File("/tmp/tcpcltest.conf").remove();
+}
+
+void TCPClTest::cutThroughTest() {
+	TestEventListener<dtn::net::ConnectionEvent> connections;
+	TestEventListener<dtn::net::TransferCompletedEvent> completed;
+	TestEventListener<dtn::routing::QueueBundleEvent> queued;
+
+	TCPPeer sink(dtn::data::EID("dtn://sink"), _port);
+	sink.handshake();
+	sink.start();
+
+	// wait until the sink is connected
+	waitFor(connections.event_cond, connections.event_counter, 1u);
+
+	TCPPeer source(dtn::data::EID("dtn://source"), _port);
+	source.handshake();
+	source.start();
+
+	const dtn::data::Bundle b = createBundle(256 * 1024);
+	const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(b);
+	const std::string data = serialize(b);
+
+	source.write(data, 0, data.size());
+	source.end();
+
+	// the acknowledgement of the sink completes the forwarded transfer
+	waitFor(completed.event_cond, completed.event_counter, 1u);
+	waitFor(queued.event_cond, queued.event_counter, 1u);
+	waitFor(sink.cond, sink.bundles, 1u);
+
+	// the bundle is known to be delivered to the sink
+	{
+		dtn::routing::NeighborDatabase &db = _router->getNeighborDB();
+		ibrcommon::MutexLock l(db);
+		CPPUNIT_ASSERT(db.get(dtn::data::EID("dtn://sink")).has(meta));
+	}
+
+	// the routing does not send the bundle a second time
+	::usleep(500000);
+
+	ibrcommon::MutexLock l(sink.cond);
+	CPPUNIT_ASSERT_EQUAL(1u, sink.bundles);
+	CPPUNIT_ASSERT_EQUAL(1u, completed.event_counter);
+}
+
+void TCPClTest::cutThroughSourceAbortTest() {
+	TestEventListener<dtn::net::ConnectionEvent> connections;
+	TestEventListener<dtn::net::TransferAbortedEvent> aborted;
+
+	// read raw bytes until the connection is closed
+	TCPPeer sink(dtn::data::EID("dtn://sink"), _port, static_cast<size_t>(-1));
+	sink.handshake();
+	sink.start();
+
+	// wait until the sink is connected
+	waitFor(connections.event_cond, connections.event_counter, 1u);
+
+	TCPPeer source(dtn::data::EID("dtn://source"), _port);
+	source.handshake();
+	source.start();
+
+	const dtn::data::Bundle b = createBundle(1024 * 1024);
+	const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(b);
+	const std::string data = serialize(b);
+
+	// send a part of the bundle and wait until it is forwarded
+	source.write(data, 0, data.size() / 4);
+	waitFor(sink.cond, sink.bytes, static_cast<size_t>(64 * 1024));
+
+	// the source is interrupted
+	source.kill();
+
+	// the forwarded transfer is aborted and the sink is closed
+	waitFor(aborted.event_cond, aborted.event_counter, 1u);
+	waitFor(sink.cond, sink.closed, true);
+
+	CPPUNIT_ASSERT(!_storage->contains(meta));
+}
+
+void TCPClTest::cutThroughSinkAbortTest() {
+	TestEventListener<dtn::net::ConnectionEvent> connections;
+	TestEventListener<dtn::net::TransferCompletedEvent> completed;
+	TestEventListener<dtn::routing::RequeueBundleEvent> requeued;
+	TestEventListener<dtn::routing::QueueBundleEvent> queued;
+
+	// the sink fails after receiving a part of the bundle
+	TCPPeer sink(dtn::data::EID("dtn://sink"), _port, 64 * 1024);
+	sink.handshake();
+	sink.start();
+
+	// wait until the sink is connected
+	waitFor(connections.event_cond, connections.event_counter, 1u);
+
+	TCPPeer source(dtn::data::EID("dtn://source"), _port);
+	source.handshake();
+	source.start();
+
+	const dtn::data::Bundle b = createBundle(1024 * 1024);
+	const dtn::data::MetaBundle meta = dtn::data::MetaBundle::create(b);
+	const std::string data = serialize(b);
+
+	size_t offset = data.size() / 4;
+	source.write(data, 0, offset);
+	waitFor(sink.cond, sink.closed, true);
+
+	// the sink is released on the next failed write, thus its transfer
+	// is requeued while the bundle is still received
+	for (int i = 0; i < 500; ++i)
+	{
+		{
+			ibrcommon::MutexLock l(requeued.event_cond);
+			if (requeued.event_counter > 0) break;
+		}
+
+		source.write(data, offset, 1024);
+		offset += 1024;
+		::usleep(10000);
+	}
+
+	{
+		ibrcommon::MutexLock l(requeued.event_cond);
+		CPPUNIT_ASSERT_EQUAL(1u, requeued.event_counter);
+	}
+
+	source.write(data, offset, data.size() - offset);
+	source.end();
+
+	// the bundle is stored for the regular routing
+	waitFor(queued.event_cond, queued.event_counter, 1u);
+	CPPUNIT_ASSERT(_storage->contains(meta));
+
+	ibrcommon::MutexLock l(completed.event_cond);
+	CPPUNIT_ASSERT_EQUAL(0u, completed.event_counter);
+}
@@ -0,0 +1,53 @@
+/*
+ * TCPClTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include "storage/BundleStorage.h"
+#include "routing/BaseRouter.h"
+#include "net/TCPConvergenceLayer.h"
+#include "../tools/EventSwitchLoop.h"
+
+#ifndef TCPCLTEST_H_
+#define TCPCLTEST_H_
+
+class TCPClTest : public CppUnit::TestFixture {
+	dtn::storage::BundleStorage *_storage;
+	dtn::routing::BaseRouter *_router;
+	ibrtest::EventSwitchLoop *_esl;
+	dtn::net::TCPConvergenceLayer *_cl;
+	dtn::data::EID _local;
+	int _port;
+
+	void cutThroughTest();
+	void cutThroughSourceAbortTest();
+	void cutThroughSinkAbortTest();
+
+public:
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(TCPClTest);
+	CPPUNIT_TEST(cutThroughTest);
+	CPPUNIT_TEST(cutThroughSourceAbortTest);
+	CPPUNIT_TEST(cutThroughSinkAbortTest);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* TCPCLTEST_H_ */
@@ -0,0 +1,351 @@
+/*
+ * TransferSchedulerTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "TransferSchedulerTest.h"
+#include "net/TransferScheduler.h"
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/thread/Thread.h>
+#include <iterator>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TransferSchedulerTest);
+
+/**
+ * A link which sends the dispatched transfers in the order of arrival
+ */
+class FakeLink : public dtn::net::TransferScheduler::Callback
+{
+public:
+	FakeLink() : high(0) { };
+	virtual ~FakeLink() { };
+
+	virtual void dispatch(dtn::net::BundleTransfer &job)
+	{
+		queue.push_back(job);
+	}
+
+	/**
+	 * Complete up to the given number of transfers
+	 */
+	void send(dtn::net::TransferScheduler &scheduler, unsigned int count)
+	{
+		for (unsigned int i = 0; (i < count) && !queue.empty(); ++i)
+		{
+			dtn::net::BundleTransfer job = queue.front();
+			queue.pop_front();
+
+			job.complete();
+			if (job.getBundle().getPriority() > 0) high++;
+
+			scheduler.finished(job.getNeighbor(), job.getBundle());
+		}
+	}
+
+	std::list<dtn::net::BundleTransfer> queue;
+	unsigned int high;
+};
+
+/**
+ * A link which fails to dispatch transfers while the flag is set
+ */
+class FailingLink : public FakeLink
+{
+public:
+	FailingLink() : fail(false), failed(0) { };
+	virtual ~FailingLink() { };
+
+	virtual void dispatch(dtn::net::BundleTransfer &job)
+	{
+		if (fail)
+		{
+			failed++;
+			throw ibrcommon::Exception("dial-up failed");
+		}
+
+		FakeLink::dispatch(job);
+	}
+
+	bool fail;
+	unsigned int failed;
+};
+
+static dtn::net::BundleTransfer createTransfer(const dtn::data::EID &peer, dtn::data::PrimaryBlock::PRIORITY prio)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://source/app");
+	b.destination = peer;
+
+	if (prio == dtn::data::PrimaryBlock::PRIO_HIGH) b.set(dtn::data::PrimaryBlock::PRIORITY_BIT2, true);
+	if (prio == dtn::data::PrimaryBlock::PRIO_MEDIUM) b.set(dtn::data::PrimaryBlock::PRIORITY_BIT1, true);
+
+	return dtn::net::BundleTransfer(peer, dtn::data::MetaBundle::create(b), dtn::core::Node::CONN_UNDEFINED);
+}
+
+/**
+ * Queue many bundles with low priority followed by a few bundles with
+ * high priority and send only a part of them before the contact ends.
+ * Returns the number of delivered bundles with high priority.
+ */
+static unsigned int shortContact(const dtn::data::Size &limit)
+{
+	const dtn::data::EID peer("dtn://peer");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setLimit(limit);
+	scheduler.up(peer);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+		scheduler.queue(job);
+	}
+
+	for (int i = 0; i < 5; ++i)
+	{
+		dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_HIGH);
+		scheduler.queue(job);
+	}
+
+	// the contact lasts for seven bundles
+	link.send(scheduler, 7);
+	scheduler.down(peer);
+
+	return link.high;
+}
+
+void TransferSchedulerTest::setUp()
+{
+}
+
+void TransferSchedulerTest::tearDown()
+{
+}
+
+void TransferSchedulerTest::testDisabled()
+{
+	const dtn::data::EID peer("dtn://peer");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+		scheduler.queue(job);
+	}
+
+	// without a limit all transfers are dispatched immediately
+	CPPUNIT_ASSERT_EQUAL((size_t)10, link.queue.size());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getPending(peer));
+
+	link.send(scheduler, 10);
+}
+
+void TransferSchedulerTest::testShortContact()
+{
+	const unsigned int fifo = shortContact(0);
+	const unsigned int scheduled = shortContact(2);
+
+	const double fifo_ratio = static_cast<double>(fifo) / 5.0;
+	const double scheduled_ratio = static_cast<double>(scheduled) / 5.0;
+
+	// all bundles with high priority are delivered within the contact
+	CPPUNIT_ASSERT_EQUAL(1.0, scheduled_ratio);
+	CPPUNIT_ASSERT(scheduled_ratio > fifo_ratio);
+}
+
+void TransferSchedulerTest::testShares()
+{
+	const dtn::data::EID a("dtn://a");
+	const dtn::data::EID b("dtn://b");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setShare(a, 3);
+	scheduler.setShare(b, 1);
+	scheduler.setLimit(4);
+
+	for (int i = 0; i < 10; ++i)
+	{
+		dtn::net::BundleTransfer ja = createTransfer(a, dtn::data::PrimaryBlock::PRIO_LOW);
+		dtn::net::BundleTransfer jb = createTransfer(b, dtn::data::PrimaryBlock::PRIO_LOW);
+		scheduler.queue(ja);
+		scheduler.queue(jb);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)3, scheduler.getInFlight(a));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getInFlight(b));
+
+	// the share of the other neighbor grows if one has nothing to send
+	scheduler.down(b);
+	link.send(scheduler, 1);
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)4, scheduler.getInFlight(a));
+}
+
+void TransferSchedulerTest::testContactDuration()
+{
+	// the neighbors are ordered by their address, the one with the long
+	// contact comes first if the transfers can not be distinguished
+	const dtn::data::EID lng("dtn://long");
+	const dtn::data::EID shrt("dtn://short");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setLimit(2);
+
+	// learn a contact of at least three seconds and one of a second
+	scheduler.up(lng);
+	ibrcommon::Thread::sleep(3000);
+	scheduler.down(lng);
+
+	scheduler.up(shrt);
+	scheduler.down(shrt);
+
+	scheduler.up(shrt);
+	scheduler.up(lng);
+
+	// one transfer of each neighbor is in flight, the others are waiting
+	for (int i = 0; i < 2; ++i)
+	{
+		dtn::net::BundleTransfer jl = createTransfer(lng, dtn::data::PrimaryBlock::PRIO_LOW);
+		dtn::net::BundleTransfer js = createTransfer(shrt, dtn::data::PrimaryBlock::PRIO_LOW);
+		scheduler.queue(jl);
+		scheduler.queue(js);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((size_t)2, link.queue.size());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getPending(lng));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getPending(shrt));
+
+	// both waiting transfers are admitted at once, the contact which is
+	// expected to end earlier is served first
+	scheduler.setLimit(4);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)4, link.queue.size());
+
+	std::list<dtn::net::BundleTransfer>::const_iterator it = link.queue.begin();
+	std::advance(it, 2);
+	CPPUNIT_ASSERT(shrt == (*it).getNeighbor());
+	++it;
+	CPPUNIT_ASSERT(lng == (*it).getNeighbor());
+
+	link.send(scheduler, 4);
+}
+
+void TransferSchedulerTest::testPreempt()
+{
+	const dtn::data::EID peer("dtn://peer");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setLimit(1);
+
+	std::list<dtn::data::BundleID> ids;
+	for (int i = 0; i < 3; ++i)
+	{
+		dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+		ids.push_back(job.getBundle());
+		scheduler.queue(job);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getInFlight(peer));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, scheduler.getPending(peer));
+
+	dtn::data::BundleID dropped;
+
+	// bundles of the same priority do not preempt others
+	const dtn::net::BundleTransfer low = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+	CPPUNIT_ASSERT(!scheduler.preempt(peer, low.getBundle(), dropped));
+
+	// the last waiting transfer is dropped
+	const dtn::net::BundleTransfer high = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_HIGH);
+	CPPUNIT_ASSERT(scheduler.preempt(peer, high.getBundle(), dropped));
+	CPPUNIT_ASSERT(ids.back() == dropped);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getPending(peer));
+
+	link.send(scheduler, 2);
+}
+
+void TransferSchedulerTest::testDown()
+{
+	const dtn::data::EID peer("dtn://peer");
+
+	FakeLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setLimit(2);
+	scheduler.up(peer);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+		scheduler.queue(job);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, scheduler.getInFlight(peer));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)3, scheduler.getPending(peer));
+
+	// waiting transfers are dropped for a requeue by the routing
+	scheduler.down(peer);
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getInFlight(peer));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getPending(peer));
+}
+
+void TransferSchedulerTest::testDispatchError()
+{
+	const dtn::data::EID peer("dtn://peer");
+	const dtn::data::EID other("dtn://other");
+
+	FailingLink link;
+	dtn::net::TransferScheduler scheduler(link);
+	scheduler.setLimit(2);
+
+	// the error of a transfer dispatched for the caller is passed to the caller
+	link.fail = true;
+	dtn::net::BundleTransfer job = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+	CPPUNIT_ASSERT_THROW(scheduler.queue(job), ibrcommon::Exception);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getInFlight(peer));
+	link.fail = false;
+
+	// fill the shares of both neighbors and let one transfer wait
+	dtn::net::BundleTransfer j1 = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+	dtn::net::BundleTransfer j2 = createTransfer(other, dtn::data::PrimaryBlock::PRIO_LOW);
+	dtn::net::BundleTransfer j3 = createTransfer(peer, dtn::data::PrimaryBlock::PRIO_LOW);
+	scheduler.queue(j1);
+	scheduler.queue(j2);
+	scheduler.queue(j3);
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getInFlight(peer));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, scheduler.getPending(peer));
+
+	// the waiting transfer is dispatched on behalf of the finished one,
+	// its error is not passed to that caller and its share is released
+	link.fail = true;
+	link.send(scheduler, 1);
+
+	CPPUNIT_ASSERT_EQUAL((unsigned int)2, link.failed);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getInFlight(peer));
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)0, scheduler.getPending(peer));
+
+	link.fail = false;
+	link.send(scheduler, 1);
+}
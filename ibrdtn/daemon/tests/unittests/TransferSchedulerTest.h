@@ -0,0 +1,51 @@
+/*
+ * TransferSchedulerTest.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TRANSFERSCHEDULERTEST_H_
+#define TRANSFERSCHEDULERTEST_H_
+
+class TransferSchedulerTest : public CppUnit::TestFixture
+{
+public:
+	void testDisabled();
+	void testShortContact();
+	void testShares();
+	void testContactDuration();
+	void testPreempt();
+	void testDown();
+	void testDispatchError();
+
+	void setUp();
+	void tearDown();
+
+	CPPUNIT_TEST_SUITE(TransferSchedulerTest);
+	CPPUNIT_TEST(testDisabled);
+	CPPUNIT_TEST(testShortContact);
+	CPPUNIT_TEST(testShares);
+	CPPUNIT_TEST(testContactDuration);
+	CPPUNIT_TEST(testPreempt);
+	CPPUNIT_TEST(testDown);
+	CPPUNIT_TEST(testDispatchError);
+	CPPUNIT_TEST_SUITE_END();
+};
+
+#endif /* TRANSFERSCHEDULERTEST_H_ */
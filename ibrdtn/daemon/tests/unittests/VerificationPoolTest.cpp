@@ -0,0 +1,291 @@
+/*
+ * VerificationPoolTest.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "VerificationPoolTest.h"
+#include "core/VerificationPool.h"
+#include <ibrcommon/thread/Conditional.h>
+#include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/thread/Thread.h>
+#include <set>
+#include <vector>
+
+CPPUNIT_TEST_SUITE_REGISTRATION(VerificationPoolTest);
+
+/**
+ * A lane which verifies every bundle in the pool. The verification of
+ * a bundle is blocked until it is released by the test and accepted
+ * bundles are recorded instead of being injected into the core.
+ */
+class TestLane : public dtn::core::VerificationPool::Lane
+{
+public:
+	TestLane() : _all(false) { }
+	virtual ~TestLane() { }
+
+	/**
+	 * Release the verification of the bundle with the given sequence number
+	 */
+	void release(const dtn::data::Number &seq)
+	{
+		ibrcommon::MutexLock l(_cond);
+		_released.insert(seq);
+		_cond.signal(true);
+	}
+
+	/**
+	 * Release the verification of all bundles
+	 */
+	void releaseAll()
+	{
+		ibrcommon::MutexLock l(_cond);
+		_all = true;
+		_cond.signal(true);
+	}
+
+	/**
+	 * Wait until the given number of bundles has been injected
+	 */
+	void waitFor(size_t count)
+	{
+		ibrcommon::MutexLock l(_cond);
+		while (_injected.size() < count) _cond.wait(10000);
+	}
+
+	std::vector<dtn::data::Number> injected()
+	{
+		ibrcommon::MutexLock l(_cond);
+		return _injected;
+	}
+
+protected:
+	bool isSecured(const dtn::data::Bundle&) const
+	{
+		return true;
+	}
+
+	dtn::core::BundleFilter::ACTION verify(const dtn::data::EID&, const dtn::core::Node::Protocol, dtn::data::Bundle &bundle) const
+	{
+		ibrcommon::MutexLock l(_cond);
+		while (!_all && (_released.find(bundle.sequencenumber) == _released.end())) _cond.wait(10000);
+		return dtn::core::BundleFilter::ACCEPT;
+	}
+
+	void inject(const dtn::data::EID&, dtn::data::Bundle &bundle)
+	{
+		ibrcommon::MutexLock l(_cond);
+		_injected.push_back(bundle.sequencenumber);
+		_cond.signal(true);
+	}
+
+private:
+	mutable ibrcommon::Conditional _cond;
+	std::set<dtn::data::Number> _released;
+	std::vector<dtn::data::Number> _injected;
+	bool _all;
+};
+
+/**
+ * Pushes a bundle into a lane in the background
+ */
+class LanePusher : public ibrcommon::JoinableThread
+{
+public:
+	LanePusher(dtn::core::VerificationPool::Lane &lane, const dtn::data::Bundle &bundle)
+	 : _lane(lane), _bundle(bundle), _queued(false), _done(false) { }
+
+	virtual ~LanePusher() {
+		join();
+	}
+
+	bool done()
+	{
+		ibrcommon::MutexLock l(_cond);
+		return _done;
+	}
+
+	bool queued()
+	{
+		ibrcommon::MutexLock l(_cond);
+		return _queued;
+	}
+
+	void waitDone()
+	{
+		ibrcommon::MutexLock l(_cond);
+		while (!_done) _cond.wait(10000);
+	}
+
+protected:
+	void run() throw ()
+	{
+		const bool ret = _lane.push(dtn::data::EID("dtn://peer"), dtn::core::Node::CONN_TCPIP, _bundle);
+
+		ibrcommon::MutexLock l(_cond);
+		_queued = ret;
+		_done = true;
+		_cond.signal(true);
+	}
+
+	void __cancellation() throw () { }
+
+private:
+	dtn::core::VerificationPool::Lane &_lane;
+	const dtn::data::Bundle _bundle;
+	ibrcommon::Conditional _cond;
+	bool _queued;
+	bool _done;
+};
+
+/**
+ * Releases all bundles of a lane after a delay
+ */
+class LaneReleaser : public ibrcommon::JoinableThread
+{
+public:
+	LaneReleaser(TestLane &lane) : _lane(lane) { }
+
+	virtual ~LaneReleaser() {
+		join();
+	}
+
+protected:
+	void run() throw ()
+	{
+		ibrcommon::Thread::sleep(200);
+		_lane.releaseAll();
+	}
+
+	void __cancellation() throw () { }
+
+private:
+	TestLane &_lane;
+};
+
+static dtn::data::Bundle createBundle(const dtn::data::Number &seq)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://peer/app");
+	b.destination = dtn::data::EID("dtn://local/app");
+	b.sequencenumber = seq;
+	return b;
+}
+
+static bool push(dtn::core::VerificationPool::Lane &lane, const dtn::data::Number &seq)
+{
+	return lane.push(dtn::data::EID("dtn://peer"), dtn::core::Node::CONN_TCPIP, createBundle(seq));
+}
+
+void VerificationPoolTest::setUp()
+{
+	dtn::core::VerificationPool::getInstance().start(4);
+}
+
+void VerificationPoolTest::tearDown()
+{
+	dtn::core::VerificationPool::getInstance().stop();
+}
+
+void VerificationPoolTest::testOrder()
+{
+	TestLane lane1, lane2;
+
+	CPPUNIT_ASSERT(push(lane1, 1));
+	CPPUNIT_ASSERT(push(lane1, 2));
+	CPPUNIT_ASSERT(push(lane1, 3));
+	CPPUNIT_ASSERT(push(lane2, 4));
+
+	// complete the bundles of the first lane in reverse order
+	lane1.release(3);
+	lane1.release(2);
+
+	// the other lane is not blocked by the pending bundles
+	lane2.release(4);
+	lane2.waitFor(1);
+
+	// nothing is injected before the first bundle is verified
+	ibrcommon::Thread::sleep(100);
+	CPPUNIT_ASSERT(lane1.injected().empty());
+
+	lane1.release(1);
+	lane1.waitFor(3);
+
+	const std::vector<dtn::data::Number> order = lane1.injected();
+	CPPUNIT_ASSERT_EQUAL((size_t)3, order.size());
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Number(1), order[0]);
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Number(2), order[1]);
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Number(3), order[2]);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)1, lane2.injected().size());
+
+	lane1.flush();
+	lane2.flush();
+}
+
+void VerificationPoolTest::testLimit()
+{
+	TestLane lane;
+
+	// fill the lane up to the default limit
+	for (int i = 1; i <= 8; ++i)
+	{
+		CPPUNIT_ASSERT(push(lane, i));
+	}
+
+	// the next bundle blocks the connection
+	LanePusher pusher(lane, createBundle(9));
+	pusher.start();
+
+	ibrcommon::Thread::sleep(200);
+	CPPUNIT_ASSERT(!pusher.done());
+
+	// processing one bundle releases the connection
+	lane.release(1);
+	pusher.waitDone();
+	CPPUNIT_ASSERT(pusher.queued());
+
+	lane.releaseAll();
+	lane.waitFor(9);
+	lane.flush();
+
+	CPPUNIT_ASSERT_EQUAL((size_t)9, lane.injected().size());
+}
+
+void VerificationPoolTest::testStop()
+{
+	dtn::core::VerificationPool &pool = dtn::core::VerificationPool::getInstance();
+
+	TestLane lane;
+
+	for (int i = 1; i <= 6; ++i)
+	{
+		CPPUNIT_ASSERT(push(lane, i));
+	}
+
+	// release the verification while the pool is stopped
+	LaneReleaser releaser(lane);
+	releaser.start();
+
+	// all queued bundles are processed before the workers are gone
+	pool.stop();
+	CPPUNIT_ASSERT(!pool.isRunning());
+	CPPUNIT_ASSERT_EQUAL((size_t)6, lane.injected().size());
+
+	// no bundle is queued into a stopped pool
+	CPPUNIT_ASSERT(!push(lane, 7));
+}
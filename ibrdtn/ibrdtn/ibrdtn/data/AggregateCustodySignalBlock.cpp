@@ -0,0 +1,102 @@
+/*
+ * AggregateCustodySignalBlock.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrdtn/data/AggregateCustodySignalBlock.h"
+#include "ibrdtn/data/PayloadBlock.h"
+
+namespace dtn
+{
+	namespace data
+	{
+		const char AggregateCustodySignalBlock::RECORD_TYPE = 15;
+
+		AggregateCustodySignalBlock::AggregateCustodySignalBlock()
+		 : custody_accepted(false), reason(CustodySignalBlock::NO_ADDITIONAL_INFORMATION), timeofsignal()
+		{
+		}
+
+		AggregateCustodySignalBlock::~AggregateCustodySignalBlock()
+		{
+		}
+
+		void AggregateCustodySignalBlock::read(const dtn::data::PayloadBlock &p) throw (WrongRecordException)
+		{
+			ibrcommon::BLOB::Reference r = p.getBLOB();
+			ibrcommon::BLOB::iostream stream = r.iostream();
+
+			char admfield;
+			(*stream).get(admfield);
+
+			// check type field
+			if (((admfield >> 4) & 0x0f) != RECORD_TYPE) throw WrongRecordException();
+
+			char status = 0;
+			(*stream).get(status);
+
+			// decode custody acceptance
+			custody_accepted = (status & 0x01);
+
+			// decode reason flag
+			reason = CustodySignalBlock::REASON_CODE(status >> 1);
+
+			try {
+				(*stream) >> timeofsignal;
+				(*stream) >> bundles;
+			} catch (const dtn::InvalidDataException &ex) {
+				throw WrongRecordException(ex.what());
+			}
+		}
+
+		void AggregateCustodySignalBlock::write(dtn::data::PayloadBlock &p) const
+		{
+			ibrcommon::BLOB::Reference r = p.getBLOB();
+			ibrcommon::BLOB::iostream stream = r.iostream();
+
+			// clear the whole data first
+			stream.clear();
+
+			// write the content
+			(*stream).put(static_cast<char>(RECORD_TYPE << 4));
+
+			// encode reason flag
+			char status = static_cast<char>(reason << 1);
+
+			// encode custody acceptance
+			if (custody_accepted) status |= 0x01;
+
+			// write the status byte
+			(*stream).put(status);
+
+			(*stream) << timeofsignal << bundles;
+		}
+
+		void AggregateCustodySignalBlock::expand(std::list<dtn::data::CustodySignalBlock> &signals) const
+		{
+			for (BundleIDRanges::const_iterator it = bundles.begin(); it != bundles.end(); ++it)
+			{
+				CustodySignalBlock signal;
+				signal.custody_accepted = custody_accepted;
+				signal.reason = reason;
+				signal.timeofsignal = timeofsignal;
+				signal.bundleid = (*it);
+				signals.push_back(signal);
+			}
+		}
+	}
+}
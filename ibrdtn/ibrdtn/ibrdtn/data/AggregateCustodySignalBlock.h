@@ -0,0 +1,67 @@
+/*
+ * AggregateCustodySignalBlock.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef AGGREGATECUSTODYSIGNALBLOCK_H_
+#define AGGREGATECUSTODYSIGNALBLOCK_H_
+
+#include "ibrdtn/data/AdministrativeBlock.h"
+#include "ibrdtn/data/CustodySignalBlock.h"
+#include "ibrdtn/data/BundleIDRanges.h"
+#include "ibrdtn/data/DTNTime.h"
+#include <list>
+
+namespace dtn
+{
+	namespace data
+	{
+		/**
+		 * An administrative record which signals the same custody decision
+		 * for a set of bundles at once. The bundles are encoded as ranges
+		 * of sequence numbers.
+		 */
+		class AggregateCustodySignalBlock : public AdministrativeBlock
+		{
+		public:
+			/**
+			 * The record type of this block. The type is not assigned and
+			 * only understood by nodes which announce the support of
+			 * aggregate records.
+			 */
+			static const char RECORD_TYPE;
+
+			AggregateCustodySignalBlock();
+			virtual ~AggregateCustodySignalBlock();
+
+			virtual void read(const dtn::data::PayloadBlock &p) throw (WrongRecordException);
+			virtual void write(dtn::data::PayloadBlock &p) const;
+
+			/**
+			 * Create a single custody signal for each bundle
+			 */
+			void expand(std::list<dtn::data::CustodySignalBlock> &signals) const;
+
+			bool custody_accepted;
+			CustodySignalBlock::REASON_CODE reason;
+			DTNTime timeofsignal;
+			BundleIDRanges bundles;
+		};
+	}
+}
+
+#endif /* AGGREGATECUSTODYSIGNALBLOCK_H_ */
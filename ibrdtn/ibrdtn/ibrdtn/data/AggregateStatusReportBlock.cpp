@@ -0,0 +1,103 @@
+/*
+ * AggregateStatusReportBlock.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrdtn/data/AggregateStatusReportBlock.h"
+#include "ibrdtn/data/PayloadBlock.h"
+
+namespace dtn
+{
+	namespace data
+	{
+		const char AggregateStatusReportBlock::RECORD_TYPE = 14;
+
+		AggregateStatusReportBlock::AggregateStatusReportBlock()
+		 : status(0), reasoncode(0), timeofreport()
+		{
+		}
+
+		AggregateStatusReportBlock::~AggregateStatusReportBlock()
+		{
+		}
+
+		void AggregateStatusReportBlock::read(const dtn::data::PayloadBlock &p) throw (WrongRecordException)
+		{
+			ibrcommon::BLOB::Reference r = p.getBLOB();
+			ibrcommon::BLOB::iostream stream = r.iostream();
+
+			char admfield;
+			(*stream).get(admfield);
+
+			// check type field
+			if (((admfield >> 4) & 0x0f) != RECORD_TYPE) throw WrongRecordException();
+
+			(*stream).get(status);
+			(*stream).get(reasoncode);
+
+			try {
+				(*stream) >> timeofreport;
+				(*stream) >> bundles;
+			} catch (const dtn::InvalidDataException &ex) {
+				throw WrongRecordException(ex.what());
+			}
+		}
+
+		void AggregateStatusReportBlock::write(dtn::data::PayloadBlock &p) const
+		{
+			ibrcommon::BLOB::Reference r = p.getBLOB();
+			ibrcommon::BLOB::iostream stream = r.iostream();
+
+			// clear the whole data first
+			stream.clear();
+
+			(*stream).put(static_cast<char>(RECORD_TYPE << 4));
+			(*stream).put(status);
+			(*stream).put(reasoncode);
+
+			(*stream) << timeofreport << bundles;
+		}
+
+		void AggregateStatusReportBlock::expand(std::list<dtn::data::StatusReportBlock> &reports) const
+		{
+			for (BundleIDRanges::const_iterator it = bundles.begin(); it != bundles.end(); ++it)
+			{
+				StatusReportBlock report;
+				report.status = status;
+				report.reasoncode = reasoncode;
+
+				if (status & StatusReportBlock::RECEIPT_OF_BUNDLE)
+					report.timeof_receipt = timeofreport;
+
+				if (status & StatusReportBlock::CUSTODY_ACCEPTANCE_OF_BUNDLE)
+					report.timeof_custodyaccept = timeofreport;
+
+				if (status & StatusReportBlock::FORWARDING_OF_BUNDLE)
+					report.timeof_forwarding = timeofreport;
+
+				if (status & StatusReportBlock::DELIVERY_OF_BUNDLE)
+					report.timeof_delivery = timeofreport;
+
+				if (status & StatusReportBlock::DELETION_OF_BUNDLE)
+					report.timeof_deletion = timeofreport;
+
+				report.bundleid = (*it);
+				reports.push_back(report);
+			}
+		}
+	}
+}
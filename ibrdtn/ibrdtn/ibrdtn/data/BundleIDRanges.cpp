@@ -0,0 +1,212 @@
+/*
+ * BundleIDRanges.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrdtn/data/BundleIDRanges.h"
+#include "ibrdtn/data/BundleString.h"
+#include "ibrdtn/data/Exceptions.h"
+#include <list>
+
+namespace dtn
+{
+	namespace data
+	{
+		// upper limit of bundle IDs accepted while decoding
+		static const dtn::data::Size MAX_DECODED_IDS = 65536;
+
+		class BundleIDGroup
+		{
+		public:
+			typedef std::pair<dtn::data::Number, dtn::data::Number> range;
+
+			BundleIDGroup(const dtn::data::BundleID &id)
+			 : source(id.source), timestamp(id.timestamp)
+			{
+				ranges.push_back(range(id.sequencenumber, 1));
+			}
+
+			bool matches(const dtn::data::BundleID &id) const
+			{
+				return (id.source == source) && (id.timestamp == timestamp);
+			}
+
+			void add(const dtn::data::BundleID &id)
+			{
+				range &last = ranges.back();
+				if (last.first + last.second == id.sequencenumber)
+				{
+					++last.second;
+				}
+				else
+				{
+					ranges.push_back(range(id.sequencenumber, 1));
+				}
+			}
+
+			dtn::data::EID source;
+			dtn::data::Timestamp timestamp;
+			std::list<range> ranges;
+		};
+
+		static void group(const BundleIDRanges &ids, std::list<BundleIDGroup> &groups)
+		{
+			for (BundleIDRanges::const_iterator it = ids.begin(); it != ids.end(); ++it)
+			{
+				if (!groups.empty() && groups.back().matches(*it))
+				{
+					groups.back().add(*it);
+				}
+				else
+				{
+					groups.push_back(BundleIDGroup(*it));
+				}
+			}
+		}
+
+		BundleIDRanges::BundleIDRanges()
+		{
+		}
+
+		BundleIDRanges::~BundleIDRanges()
+		{
+		}
+
+		void BundleIDRanges::add(const dtn::data::BundleID &id)
+		{
+			dtn::data::BundleID plain;
+			plain.source = id.source;
+			plain.timestamp = id.timestamp;
+			plain.sequencenumber = id.sequencenumber;
+			_ids.insert(plain);
+		}
+
+		bool BundleIDRanges::has(const dtn::data::BundleID &id) const
+		{
+			dtn::data::BundleID plain;
+			plain.source = id.source;
+			plain.timestamp = id.timestamp;
+			plain.sequencenumber = id.sequencenumber;
+			return (_ids.find(plain) != _ids.end());
+		}
+
+		void BundleIDRanges::clear()
+		{
+			_ids.clear();
+		}
+
+		bool BundleIDRanges::empty() const
+		{
+			return _ids.empty();
+		}
+
+		dtn::data::Size BundleIDRanges::size() const
+		{
+			return _ids.size();
+		}
+
+		dtn::data::Size BundleIDRanges::getRanges() const
+		{
+			std::list<BundleIDGroup> groups;
+			group(*this, groups);
+
+			dtn::data::Size ret = 0;
+			for (std::list<BundleIDGroup>::const_iterator it = groups.begin(); it != groups.end(); ++it)
+			{
+				ret += (*it).ranges.size();
+			}
+			return ret;
+		}
+
+		BundleIDRanges::const_iterator BundleIDRanges::begin() const
+		{
+			return _ids.begin();
+		}
+
+		BundleIDRanges::const_iterator BundleIDRanges::end() const
+		{
+			return _ids.end();
+		}
+
+		std::ostream &operator<<(std::ostream &stream, const BundleIDRanges &obj)
+		{
+			std::list<BundleIDGroup> groups;
+			group(obj, groups);
+
+			stream << dtn::data::Number(groups.size());
+
+			for (std::list<BundleIDGroup>::const_iterator it = groups.begin(); it != groups.end(); ++it)
+			{
+				const BundleIDGroup &g = (*it);
+
+				stream << BundleString(g.source.getString());
+				stream << g.timestamp;
+				stream << dtn::data::Number(g.ranges.size());
+
+				for (std::list<BundleIDGroup::range>::const_iterator r = g.ranges.begin(); r != g.ranges.end(); ++r)
+				{
+					stream << (*r).first << (*r).second;
+				}
+			}
+
+			return stream;
+		}
+
+		std::istream &operator>>(std::istream &stream, BundleIDRanges &obj)
+		{
+			obj.clear();
+
+			// decoding of an SDNV does not throw if the data runs out,
+			// thus the stream has to be checked after each field
+			dtn::data::Number groups;
+			stream >> groups;
+			if (stream.fail()) throw dtn::InvalidDataException("range list truncated");
+
+			for (dtn::data::Size i = 0; i < groups.get<dtn::data::Size>(); ++i)
+			{
+				dtn::data::BundleID id;
+
+				BundleString source;
+				stream >> source;
+				if (stream.fail()) throw dtn::InvalidDataException("range list truncated");
+				id.source = dtn::data::EID(source);
+
+				dtn::data::Number ranges;
+				stream >> id.timestamp >> ranges;
+				if (stream.fail()) throw dtn::InvalidDataException("range list truncated");
+
+				for (dtn::data::Size j = 0; j < ranges.get<dtn::data::Size>(); ++j)
+				{
+					dtn::data::Number first, length;
+					stream >> first >> length;
+					if (stream.fail()) throw dtn::InvalidDataException("range list truncated");
+
+					if (length.get<dtn::data::Size>() > (MAX_DECODED_IDS - obj.size()))
+						throw dtn::InvalidDataException("too many bundle IDs in range list");
+
+					for (dtn::data::Size k = 0; k < length.get<dtn::data::Size>(); ++k)
+					{
+						id.sequencenumber = first + k;
+						obj._ids.insert(id);
+					}
+				}
+			}
+
+			return stream;
+		}
+	} /* namespace data */
+} /* namespace dtn */
@@ -0,0 +1,76 @@
+/*
+ * BundleIDRanges.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef BUNDLEIDRANGES_H_
+#define BUNDLEIDRANGES_H_
+
+#include "ibrdtn/data/BundleID.h"
+#include "ibrdtn/data/Number.h"
+#include <iostream>
+#include <set>
+
+namespace dtn
+{
+	namespace data
+	{
+		/**
+		 * A set of bundle IDs which is serialized as ranges of consecutive
+		 * sequence numbers. Bundle IDs are grouped by their source and
+		 * creation timestamp, thus a burst of bundles of one source is
+		 * encoded with a few bytes only. Fragments are not supported.
+		 */
+		class BundleIDRanges
+		{
+		public:
+			typedef std::set<dtn::data::BundleID> id_set;
+			typedef id_set::const_iterator const_iterator;
+
+			BundleIDRanges();
+			virtual ~BundleIDRanges();
+
+			/**
+			 * Add a bundle ID to the set. The fragment information of
+			 * the ID is discarded.
+			 */
+			void add(const dtn::data::BundleID &id);
+
+			bool has(const dtn::data::BundleID &id) const;
+
+			void clear();
+
+			bool empty() const;
+			dtn::data::Size size() const;
+
+			/**
+			 * Returns the number of ranges used to encode the set
+			 */
+			dtn::data::Size getRanges() const;
+
+			const_iterator begin() const;
+			const_iterator end() const;
+
+			friend std::ostream &operator<<(std::ostream &stream, const BundleIDRanges &obj);
+			friend std::istream &operator>>(std::istream &stream, BundleIDRanges &obj);
+
+		private:
+			id_set _ids;
+		};
+	} /* namespace data */
+} /* namespace dtn */
+#endif /* BUNDLEIDRANGES_H_ */
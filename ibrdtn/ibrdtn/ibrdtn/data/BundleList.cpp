@@ -93,6 +93,12 @@ namespace dtn
 			}
 		}
 
+		Timestamp BundleList::getNextExpiration() const throw ()
+		{
+			if (_bundles.empty()) return 0;
+			return _bundles.begin()->bundle.expiretime;
+		}
+
 		BundleList::ExpiringBundle::ExpiringBundle(const MetaBundle &b)
 		 : bundle(b)
 		{ }
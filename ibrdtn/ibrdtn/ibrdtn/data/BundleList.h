@@ -48,6 +48,12 @@ namespace dtn
 
 			virtual void expire(const Timestamp &timestamp) throw ();
 
+			/**
+			 * Returns the expiration time of the bundle which expires
+			 * next or zero if the list is empty.
+			 */
+			Timestamp getNextExpiration() const throw ();
+
 			typedef std::set<dtn::data::MetaBundle> meta_set;
 			typedef meta_set::iterator iterator;
 			typedef meta_set::const_iterator const_iterator;
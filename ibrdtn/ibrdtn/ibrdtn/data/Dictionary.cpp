@@ -150,6 +150,11 @@ namespace dtn
 			}
 		}
 
+		void Dictionary::assign(const char *data, const Size len)
+		{
+			_bytestream.str(std::string(data, len));
+		}
+
 		EID Dictionary::get(const Number &scheme, const Number &ssp)
 		{
 			char buffer[1024];
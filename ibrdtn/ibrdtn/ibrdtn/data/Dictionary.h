@@ -93,6 +93,11 @@ namespace dtn
 			 */
 			EID get(const Number &scheme, const Number &ssp);
 
+			/**
+			 * replace the content of the dictionary with the given byte array
+			 */
+			void assign(const char *data, const Size len);
+
 			/**
 			 * clear the dictionary
 			 */
@@ -186,12 +186,12 @@ namespace dtn
 		}
 
 		EID::EID()
-		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL), _entry(NULL)
 		{
 		}
 
 		EID::EID(const Scheme scheme_type, const std::string &scheme, const std::string &ssp, const std::string &application)
-		: _scheme_type(scheme_type), _scheme(scheme), _ssp(ssp), _application(application), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _scheme_type(scheme_type), _scheme(scheme), _ssp(ssp), _application(application), _cbhe_node(0), _cbhe_application(0), _regex(NULL), _entry(NULL)
 		{
 			if (scheme_type == SCHEME_CBHE) {
 				throw dtn::InvalidDataException("This constructor does not work for CBHE schemes");
@@ -199,7 +199,7 @@ namespace dtn
 		}
 
 		EID::EID(const std::string &scheme, const std::string &ssp)
-		 : _scheme_type(SCHEME_EXTENDED), _scheme(), _ssp(ssp), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		 : _scheme_type(SCHEME_EXTENDED), _scheme(), _ssp(ssp), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL), _entry(NULL)
 		{
 			// resolve scheme
 			_scheme_type = resolveScheme(scheme);
@@ -225,7 +225,7 @@ namespace dtn
 		}
 
 		EID::EID(const std::string &orig_value)
-		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL)
+		: _scheme_type(SCHEME_DTN), _scheme(), _ssp("none"), _application(), _cbhe_node(0), _cbhe_application(0), _regex(NULL), _entry(NULL)
 		{
 			try {
 				if (orig_value.length() == 0) {
@@ -284,7 +284,7 @@ namespace dtn
 		}
 
 		EID::EID(const dtn::data::Number &node, const dtn::data::Number &application)
-		 : _scheme_type(SCHEME_CBHE), _scheme(), _ssp(), _application(), _cbhe_node(node), _cbhe_application(application), _regex(NULL)
+		 : _scheme_type(SCHEME_CBHE), _scheme(), _ssp(), _application(), _cbhe_node(node), _cbhe_application(application), _regex(NULL), _entry(NULL)
 		{
 			// set dtn:none if the node is zero
 			if (node == 0) {
@@ -304,8 +304,26 @@ namespace dtn
 #endif
 		}
 
+		const EIDEntry* EID::__getEntry() const
+		{
+			// aligned pointers are read in one access
+			return *const_cast<const EIDEntry* const volatile*>(&_entry);
+		}
+
+		const EIDEntry* EID::__setEntry(const EIDEntry *entry) const
+		{
+			// only the first thread sets the entry, all others get its value
+			const EIDEntry *prev = __sync_val_compare_and_swap(&_entry, (const EIDEntry*)NULL, entry);
+			return (prev == NULL) ? entry : prev;
+		}
+
 		bool EID::operator==(const EID &other) const
 		{
+			// interned EIDs are equal if they share the same entry
+			const EIDEntry *entry = __getEntry();
+			const EIDEntry *other_entry = other.__getEntry();
+			if ((entry != NULL) && (other_entry != NULL)) return (entry == other_entry);
+
 			if (_scheme_type != other._scheme_type) return false;
 
 			switch (_scheme_type) {
@@ -427,6 +445,9 @@ namespace dtn
 				break;
 			}
 
+			// the EID is not interned anymore
+			_entry = NULL;
+
 #ifdef HAVE_REGEX_H
 			if (_regex != NULL) {
 				regfree((regex_t*)_regex);
@@ -453,6 +474,9 @@ namespace dtn
 				break;
 			}
 
+			// the EID is not interned anymore
+			_entry = NULL;
+
 #ifdef HAVE_REGEX_H
 			if (_regex != NULL) {
 				regfree((regex_t*)_regex);
@@ -619,6 +643,45 @@ namespace dtn
 #endif
 		}
 
+		/**
+		 * FNV-1a hash over a sequence of bytes
+		 */
+		static size_t __hash(size_t hash, const void *data, const size_t len)
+		{
+			const unsigned char *bp = static_cast<const unsigned char*>(data);
+
+			for (size_t i = 0; i < len; ++i)
+			{
+				hash = (hash ^ bp[i]) * 16777619U;
+			}
+
+			return hash;
+		}
+
+		size_t EID::hash() const
+		{
+			size_t ret = __hash(2166136261U, &_scheme_type, sizeof(_scheme_type));
+
+			// hash the same fields as compared by operator==()
+			switch (_scheme_type) {
+			case SCHEME_CBHE:
+			{
+				const size_t node = _cbhe_node.get<size_t>();
+				const size_t app = _cbhe_application.get<size_t>();
+				ret = __hash(ret, &node, sizeof(node));
+				return __hash(ret, &app, sizeof(app));
+			}
+
+			case SCHEME_DTN:
+				ret = __hash(ret, _ssp.c_str(), _ssp.length() + 1);
+				return __hash(ret, _application.c_str(), _application.length());
+
+			default:
+				ret = __hash(ret, _scheme.c_str(), _scheme.length() + 1);
+				return __hash(ret, _ssp.c_str(), _ssp.length());
+			}
+		}
+
 		bool EID::match(const dtn::data::EID &other) const
 		{
 #ifdef HAVE_REGEX_H
@@ -31,6 +31,8 @@ namespace dtn
 {
 	namespace data
 	{
+		class EIDEntry;
+
 		class EID
 		{
 		public:
@@ -138,7 +140,15 @@ namespace dtn
 			 */
 			bool match(const dtn::data::EID &other) const;
 
+			/**
+			 * Returns a hash value of this EID. Equal EIDs have
+			 * equal hash values.
+			 */
+			size_t hash() const;
+
 		private:
+			friend class EIDEntry;
+			friend class EIDHandle;
 			/**
 			 * private constructor to create a modified EID
 			 */
@@ -154,6 +164,13 @@ namespace dtn
 			 */
 			static void extractDTN(const std::string &ssp, std::string &node, std::string &application);
 
+			/**
+			 * Access the interned entry, const EIDs are shared between
+			 * threads and may be interned by any of them
+			 */
+			const EIDEntry* __getEntry() const;
+			const EIDEntry* __setEntry(const EIDEntry *entry) const;
+
 			// abstract values
 			Scheme _scheme_type;
 			std::string _scheme;
@@ -170,6 +187,9 @@ namespace dtn
 			// regex structure
 			void *_regex;
 
+			// interned entry of this EID, set on first use of an EIDHandle
+			mutable const EIDEntry *_entry;
+
 			// well-known CBHE numbers
 			typedef std::map<std::string, Number> cbhe_map;
 			static cbhe_map& getApplicationMap();
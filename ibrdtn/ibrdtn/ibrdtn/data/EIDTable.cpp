@@ -0,0 +1,205 @@
+/*
+ * EIDTable.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "ibrdtn/data/EIDTable.h"
+#include <ibrcommon/thread/MutexLock.h>
+
+namespace dtn
+{
+	namespace data
+	{
+		EIDEntry::EIDEntry(const EID &e, const size_t h, const size_t i)
+		 : eid(e), hash(h), id(i), node(this), _next(NULL)
+		{
+			// the stored EID refers to its own entry
+			eid._entry = this;
+		}
+
+		EIDHandle::EIDHandle()
+		 : _entry(&EIDTable::getInstance().get(EID()))
+		{
+		}
+
+		EIDHandle::EIDHandle(const EID &eid)
+		 : _entry(eid.__getEntry())
+		{
+			if (_entry == NULL)
+			{
+				_entry = eid.__setEntry(&EIDTable::getInstance().get(eid));
+			}
+		}
+
+		bool EIDHandle::lookup(const EID &eid, EIDHandle &handle)
+		{
+			const EIDEntry *entry = eid.__getEntry();
+
+			if (entry == NULL)
+			{
+				entry = EIDTable::getInstance().find(eid);
+				if (entry == NULL) return false;
+				entry = eid.__setEntry(entry);
+			}
+
+			handle._entry = entry;
+			return true;
+		}
+
+		EIDHandle::EIDHandle(const EIDEntry *entry)
+		 : _entry(entry)
+		{
+		}
+
+		EIDHandle::~EIDHandle()
+		{
+		}
+
+		const EID& EIDHandle::get() const
+		{
+			return _entry->eid;
+		}
+
+		EIDHandle EIDHandle::getNode() const
+		{
+			return EIDHandle(_entry->node);
+		}
+
+		size_t EIDHandle::hash() const
+		{
+			return _entry->hash;
+		}
+
+		size_t EIDHandle::id() const
+		{
+			return _entry->id;
+		}
+
+		bool EIDHandle::operator==(const EIDHandle &other) const
+		{
+			return _entry == other._entry;
+		}
+
+		bool EIDHandle::operator!=(const EIDHandle &other) const
+		{
+			return _entry != other._entry;
+		}
+
+		bool EIDHandle::operator<(const EIDHandle &other) const
+		{
+			return _entry->id < other._entry->id;
+		}
+
+		EIDTable& EIDTable::getInstance()
+		{
+			static EIDTable instance;
+			return instance;
+		}
+
+		EIDTable::EIDTable()
+		 : _buckets(64, NULL), _size(0)
+		{
+		}
+
+		EIDTable::~EIDTable()
+		{
+			// entries are not freed, because static objects may still
+			// hold handles to them during the shutdown of the process
+		}
+
+		const EIDEntry& EIDTable::get(const EID &eid)
+		{
+			const size_t hash = eid.hash();
+
+			ibrcommon::MutexLock l(_lock);
+			return __get(eid, hash);
+		}
+
+		const EIDEntry* EIDTable::find(const EID &eid)
+		{
+			const size_t hash = eid.hash();
+
+			ibrcommon::MutexLock l(_lock);
+			const size_t mask = _buckets.size() - 1;
+
+			for (const EIDEntry *e = _buckets[hash & mask]; e != NULL; e = e->_next)
+			{
+				if ((e->hash == hash) && (e->eid == eid)) return e;
+			}
+
+			return NULL;
+		}
+
+		size_t EIDTable::size()
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _size;
+		}
+
+		const EIDEntry& EIDTable::__get(const EID &eid, const size_t hash)
+		{
+			const size_t mask = _buckets.size() - 1;
+
+			for (const EIDEntry *e = _buckets[hash & mask]; e != NULL; e = e->_next)
+			{
+				if ((e->hash == hash) && (e->eid == eid)) return *e;
+			}
+
+			// intern the node EID first
+			const EIDEntry *node = NULL;
+			const EID node_eid = eid.getNode();
+
+			if (node_eid != eid)
+			{
+				node = &__get(node_eid, node_eid.hash());
+			}
+
+			if (_size >= _buckets.size()) __grow();
+
+			EIDEntry *entry = new EIDEntry(eid, hash, _size);
+			if (node != NULL) entry->node = node;
+
+			EIDEntry *&bucket = _buckets[hash & (_buckets.size() - 1)];
+			entry->_next = bucket;
+			bucket = entry;
+
+			++_size;
+
+			return *entry;
+		}
+
+		void EIDTable::__grow()
+		{
+			std::vector<EIDEntry*> buckets(_buckets.size() * 2, NULL);
+			const size_t mask = buckets.size() - 1;
+
+			for (std::vector<EIDEntry*>::iterator it = _buckets.begin(); it != _buckets.end(); ++it)
+			{
+				EIDEntry *e = (*it);
+				while (e != NULL)
+				{
+					EIDEntry *next = e->_next;
+					e->_next = buckets[e->hash & mask];
+					buckets[e->hash & mask] = e;
+					e = next;
+				}
+			}
+
+			_buckets.swap(buckets);
+		}
+	}
+}
@@ -0,0 +1,164 @@
+/*
+ * EIDTable.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef EIDTABLE_H_
+#define EIDTABLE_H_
+
+#include "ibrdtn/data/EID.h"
+#include <ibrcommon/thread/Mutex.h>
+#include <vector>
+
+namespace dtn
+{
+	namespace data
+	{
+		/**
+		 * An interned EID. Entries are created by the EIDTable only
+		 * and never change or vanish once created.
+		 */
+		class EIDEntry
+		{
+		public:
+			// the EID of this entry
+			const EID eid;
+
+			// the precomputed hash value of the EID
+			const size_t hash;
+
+			// unique number of this entry, assigned in order of creation
+			const size_t id;
+
+			// the entry of the node EID, points to itself for node EIDs
+			const EIDEntry *node;
+
+		private:
+			friend class EIDTable;
+
+			EIDEntry(const EID &e, const size_t h, const size_t i);
+
+			// next entry in the same bucket
+			EIDEntry *_next;
+		};
+
+		/**
+		 * A compact reference to an interned EID. Two handles are equal if
+		 * and only if their EIDs are equal, thus the comparison is done in
+		 * constant time. Handles are ordered by the time of interning.
+		 */
+		class EIDHandle
+		{
+		public:
+			/**
+			 * Creates a handle of dtn:none
+			 */
+			EIDHandle();
+
+			/**
+			 * Interns the EID. The handle is cached in the given EID
+			 * object, so a repeated interning of the same object is cheap.
+			 */
+			explicit EIDHandle(const EID &eid);
+
+			/**
+			 * Looks up the handle of an EID without interning it.
+			 * @return True, if the EID has been interned before.
+			 */
+			static bool lookup(const EID &eid, EIDHandle &handle);
+
+			~EIDHandle();
+
+			/**
+			 * Returns the interned EID
+			 */
+			const EID& get() const;
+
+			/**
+			 * Returns the handle of the EID without application part
+			 */
+			EIDHandle getNode() const;
+
+			/**
+			 * Returns the precomputed hash value of the EID
+			 */
+			size_t hash() const;
+
+			/**
+			 * Returns the unique number of the interned EID
+			 */
+			size_t id() const;
+
+			bool operator==(const EIDHandle &other) const;
+			bool operator!=(const EIDHandle &other) const;
+			bool operator<(const EIDHandle &other) const;
+
+		private:
+			EIDHandle(const EIDEntry *entry);
+
+			const EIDEntry *_entry;
+		};
+
+		/**
+		 * The process-wide table of interned EIDs. Entries are kept in a
+		 * hash table indexed by the hash value of the EID and are never
+		 * removed. Thus, only bounded sets of EIDs like neighbors or routing
+		 * peers should be interned.
+		 */
+		class EIDTable
+		{
+		public:
+			virtual ~EIDTable();
+
+			static EIDTable& getInstance();
+
+			/**
+			 * Returns the entry of an EID and creates one if necessary
+			 */
+			const EIDEntry& get(const EID &eid);
+
+			/**
+			 * Returns the entry of an EID or NULL if it is not interned
+			 */
+			const EIDEntry* find(const EID &eid);
+
+			/**
+			 * Returns the number of interned EIDs
+			 */
+			size_t size();
+
+		private:
+			EIDTable();
+
+			/**
+			 * Lookup or create an entry, the lock has to be held
+			 */
+			const EIDEntry& __get(const EID &eid, const size_t hash);
+
+			/**
+			 * Double the number of buckets, the lock has to be held
+			 */
+			void __grow();
+
+			ibrcommon::Mutex _lock;
+			std::vector<EIDEntry*> _buckets;
+			size_t _size;
+		};
+	}
+}
+
+#endif /* EIDTABLE_H_ */
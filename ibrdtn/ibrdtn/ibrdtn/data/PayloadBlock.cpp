@@ -30,6 +30,10 @@ namespace dtn
 	{
 		const dtn::data::block_t PayloadBlock::BLOCK_TYPE = 1;
 
+		// the payload is copied in large chunks, thus streams are able
+		// to pass them without copying them into their own buffers
+		static const size_t COPY_BUFFER_SIZE = 0x10000;
+
 		PayloadBlock::PayloadBlock()
 		 : Block(PayloadBlock::BLOCK_TYPE), _blobref(ibrcommon::BLOB::create())
 		{
@@ -60,7 +64,7 @@ namespace dtn
 			ibrcommon::BLOB::iostream io = blobref.iostream();
 
 			try {
-				ibrcommon::BLOB::copy(stream, *io, io.size());
+				ibrcommon::BLOB::copy(stream, *io, io.size(), COPY_BUFFER_SIZE);
 				length += io.size();
 			} catch (const ibrcommon::IOException &ex) {
 				throw dtn::SerializationFailedException(ex.what());
@@ -76,7 +80,7 @@ namespace dtn
 
 			try {
 				(*io).seekg(clip_offset, std::ios::beg);
-				ibrcommon::BLOB::copy(stream, *io, clip_length);
+				ibrcommon::BLOB::copy(stream, *io, clip_length, COPY_BUFFER_SIZE);
 			} catch (const ibrcommon::IOException &ex) {
 				throw dtn::SerializationFailedException(ex.what());
 			}
@@ -99,7 +103,7 @@ namespace dtn
 			set(dtn::data::Block::FORWARDED_WITHOUT_PROCESSED, false);
 
 			try {
-				ibrcommon::BLOB::copy(*io, stream, length);
+				ibrcommon::BLOB::copy(*io, stream, length, COPY_BUFFER_SIZE);
 			} catch (const ibrcommon::IOException &ex) {
 				throw dtn::PayloadReceptionInterrupted(length, ex.what());
 			}
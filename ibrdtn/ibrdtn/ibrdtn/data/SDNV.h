@@ -31,6 +31,7 @@
 #include <stdint.h>
 #include <limits>
 #include <cstdlib>
+#include <cstring>
 
 #ifndef _SDNV_H_
 #define _SDNV_H_
@@ -98,15 +99,11 @@ namespace dtn
 			 */
 			size_t getLength() const
 			{
-				size_t val_len = 0;
-				E tmp = _value;
+				const uint64_t val = static_cast<uint64_t>(_value);
 
-				do {
-					tmp = tmp >> 7;
-					val_len++;
-				} while (tmp != 0);
-
-				return val_len;
+				// one byte per started group of 7 bits
+				if (val < 0x80) return 1;
+				return (64 - __builtin_clzll(val) + 6) / 7;
 			}
 
 			template<typename T>
@@ -426,65 +423,181 @@ namespace dtn
 				stream >> _value;
 			}
 
-			void encode(std::ostream &stream) const
+			/**
+			 * Encode the value into a buffer.
+			 * @param data The buffer to write to.
+			 * @param len The size of the buffer.
+			 * @return The number of bytes written or zero if the buffer is too small.
+			 */
+			size_t encode(char *data, const size_t len) const
 			{
-				unsigned char buffer[10];
-				unsigned char *bp = &buffer[0];
-				uint64_t val = _value;
+				uint64_t val = static_cast<uint64_t>(_value);
+				unsigned char *bp = reinterpret_cast<unsigned char*>(data);
+
+				// fast path for single byte values
+				if ((val < 0x80) && (len > 0))
+				{
+					bp[0] = static_cast<unsigned char>(val);
+					return 1;
+				}
 
 				const size_t val_len = getLength();
+				if (val_len > len) return 0;
 
-				if (!(val_len > 0)) throw ValueOutOfRangeException("ERROR(SDNV): !(val_len > 0)");
-				if (!(val_len <= SDNV::MAX_LENGTH)) throw ValueOutOfRangeException("ERROR(SDNV): !(val_len <= MAX_LENGTH)");
+				// fill the buffer backwards, the last octet has no high bit
+				bp += val_len - 1;
+				*bp = static_cast<unsigned char>(val & 0x7f);
 
-				// Now advance bp to the last byte and fill it in backwards with the value bytes.
-				bp += val_len;
-				unsigned char high_bit = 0; // for the last octet
-				do {
-					--bp;
-					*bp = (unsigned char)(high_bit | (val & 0x7f));
-					high_bit = (1 << 7); // for all but the last octet
-					val = val >> 7;
-				} while (val != 0);
+				while ((val >>= 7) != 0)
+				{
+					*(--bp) = static_cast<unsigned char>(0x80 | (val & 0x7f));
+				}
 
-				if (!(bp == &buffer[0])) throw ValueOutOfRangeException("ERROR(SDNV): !(bp == buffer)");
+				return val_len;
+			}
+
+			/**
+			 * Decode the value from a buffer.
+			 * @param data The buffer to read from.
+			 * @param len The number of bytes available in the buffer.
+			 * @return The number of bytes consumed or zero if the buffer
+			 *   does not contain the complete value.
+			 */
+			size_t decode(const char *data, const size_t len)
+			{
+				const unsigned char *bp = reinterpret_cast<const unsigned char*>(data);
+
+				if (len == 0) return 0;
+
+				// fast path for single byte values
+				if (bp[0] < 0x80)
+				{
+					_value = static_cast<E>(bp[0]);
+					return 1;
+				}
+
+				const size_t limit = getLimit();
+				const size_t val_len = scan(bp, (len < limit) ? len : limit);
+
+				if (val_len == 0)
+				{
+					if (len < limit) return 0;
+					throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+				}
+
+				if ((val_len == SDNV::MAX_LENGTH) && (bp[0] != 0x81))
+					throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+
+				E value = 0;
+				for (size_t i = 0; i < val_len; ++i)
+				{
+					value = (value << 7) | (bp[i] & 0x7f);
+				}
+
+				_value = value;
+				return val_len;
+			}
+
+			void encode(std::ostream &stream) const
+			{
+				char buffer[SDNV::MAX_LENGTH];
+
+				const size_t val_len = encode(buffer, SDNV::MAX_LENGTH);
+				if (val_len == 0) throw ValueOutOfRangeException("ERROR(SDNV): !(val_len <= MAX_LENGTH)");
 
 				// write encoded value to the stream
-				stream.write((const char*)&buffer[0], val_len);
+				stream.write(buffer, val_len);
 			}
 
 			void decode(std::istream &stream)
 			{
-				size_t val_len = 0;
-				unsigned char bp = 0;
-				unsigned char start = 0;
+				_value = 0;
 
-				int carry = 0;
+				// behave like an unformatted input function on a failed stream
+				if (!stream.good())
+				{
+					stream.setstate(std::ios::failbit);
+					return;
+				}
+
+				// read the octets directly from the stream buffer
+				std::streambuf &buf = *stream.rdbuf();
+				const size_t limit = getLimit();
+				char data[SDNV::MAX_LENGTH];
+
+				try {
+					for (size_t i = 0; i < limit; ++i)
+					{
+						const std::char_traits<char>::int_type c = buf.sbumpc();
+
+						if (std::char_traits<char>::eq_int_type(c, std::char_traits<char>::eof()))
+						{
+							stream.setstate(std::ios::eofbit | std::ios::failbit);
+							if (i == 0) return;
+							throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+						}
+
+						data[i] = std::char_traits<char>::to_char_type(c);
+
+						if ((c & 0x80) == 0)
+						{
+							decode(data, i + 1);
+							return;
+						}
+					}
+				} catch (const ValueOutOfRangeException&) {
+					throw;
+				} catch (const std::ios_base::failure&) {
+					throw;
+				} catch (...) {
+					// errors of the stream buffer mark the stream as bad
+					if (stream.exceptions() & std::ios::badbit) throw;
+					stream.setstate(std::ios::badbit);
+					return;
+				}
+
+				throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+			}
 
-				_value = 0;
-				do {
-					stream.get((char&)bp);
+		private:
+			/**
+			 * Returns the maximum number of octets of an encoded value of type E
+			 */
+			static size_t getLimit()
+			{
+				return (sizeof(E) < 8) ? (sizeof(E) + 1) : SDNV::MAX_LENGTH;
+			}
 
-					_value = (_value << 7) | (bp & 0x7f);
-					++val_len;
+			/**
+			 * Returns the length of the encoded value at the beginning of the
+			 * buffer or zero if the last octet is not within the first len bytes.
+			 */
+			static size_t scan(const unsigned char *bp, const size_t len)
+			{
+				size_t i = 0;
 
-					if ((bp & (1 << 7)) == 0)
-						break; // all done;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+				// look for the last octet in eight bytes at once
+				if (len >= 8)
+				{
+					uint64_t word;
+					::memcpy(&word, bp, sizeof(word));
 
-					// check if the value fits into sizeof(E)
-					if ((val_len % 8) == 0) ++carry;
+					const uint64_t last = ~word & 0x8080808080808080ULL;
+					if (last != 0) return (__builtin_ctzll(last) >> 3) + 1;
 
-					if ((sizeof(E) + carry) < val_len)
-						throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+					i = 8;
+				}
+#endif
 
-					if (start == 0) start = bp;
-				} while (1);
+				for (; i < len; ++i)
+				{
+					if (bp[i] < 0x80) return i + 1;
+				}
 
-				if ((val_len > SDNV::MAX_LENGTH) || ((val_len == SDNV::MAX_LENGTH) && (start != 0x81)))
-					throw ValueOutOfRangeException("ERROR(SDNV): overflow value in sdnv");
+				return 0;
 			}
 
-		private:
 			friend
 			std::ostream &operator<<(std::ostream &stream, const dtn::data::SDNV<E> &obj)
 			{
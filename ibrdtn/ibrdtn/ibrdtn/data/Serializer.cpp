@@ -33,6 +33,8 @@
 #include <ibrcommon/Logger.h>
 #include <list>
 #include <limits>
+#include <vector>
+#include <cstring>
 
 #ifdef __DEVELOPMENT_ASSERTIONS__
 #include <cassert>
@@ -283,48 +285,40 @@ namespace dtn
 
 		Serializer& DefaultSerializer::operator <<(const dtn::data::Block& obj)
 		{
-			_stream.put((char&)obj.getType());
-			_stream << obj.getProcessingFlags();
+			// write the header of the block
+			serializeHeader(obj, obj.getLength());
 
-			const Block::eid_list &eids = obj.getEIDList();
+			// write the payload of the block
+			Length slength = 0;
+			obj.serialize(_stream, slength);
 
-#ifdef __DEVELOPMENT_ASSERTIONS__
-			// test: BLOCK_CONTAINS_EIDS => (eids.size() > 0)
-			assert(!obj.get(Block::BLOCK_CONTAINS_EIDS) || (eids.size() > 0));
-#endif
+			return (*this);
+		}
 
-			if (obj.get(Block::BLOCK_CONTAINS_EIDS))
-			{
-				_stream << Number(eids.size());
-				for (Block::eid_list::const_iterator it = eids.begin(); it != eids.end(); ++it)
-				{
-					dtn::data::Dictionary::Reference offsets;
+		Serializer& DefaultSerializer::serialize(const dtn::data::PayloadBlock& obj, const Length &clip_offset, const Length &clip_length)
+		{
+			// get the remaining payload size
+			Length payload_size = obj.getLength();
 
-					if (_compressable)
-					{
-						offsets = (*it).getCompressed();
-					}
-					else
-					{
-						offsets = _dictionary.getRef(*it);
-					}
+			// check if the remaining data length is >= clip_length
+			Length frag_len = (clip_offset < payload_size) ? payload_size - clip_offset : 0;
 
-					_stream << offsets.first;
-					_stream << offsets.second;
-				}
-			}
+			// limit the fragment length to the clip length
+			if (frag_len > clip_length) frag_len = clip_length;
 
-			// write size of the payload in the block
-			_stream << Number(obj.getLength());
+			// write the header with the real predicted payload length
+			serializeHeader(obj, frag_len);
 
-			// write the payload of the block
-			Length slength = 0;
-			obj.serialize(_stream, slength);
+			if (frag_len > 0)
+			{
+				// now skip the <offset>-bytes and all bytes after <offset + length>
+				obj.serialize( _stream, clip_offset, frag_len );
+			}
 
 			return (*this);
 		}
 
-		Serializer& DefaultSerializer::serialize(const dtn::data::PayloadBlock& obj, const Length &clip_offset, const Length &clip_length)
+		Serializer& DefaultSerializer::serializeHeader(const dtn::data::Block &obj, const Length &length)
 		{
 			_stream.put((char&)obj.getType());
 			_stream << obj.getProcessingFlags();
@@ -357,24 +351,8 @@ namespace dtn
 				}
 			}
 
-			// get the remaining payload size
-			Length payload_size = obj.getLength();
-
-			// check if the remaining data length is >= clip_length
-			Length frag_len = (clip_offset < payload_size) ? payload_size - clip_offset : 0;
-
-			// limit the fragment length to the clip length
-			if (frag_len > clip_length) frag_len = clip_length;
-
-			// set the real predicted payload length
 			// write size of the payload in the block
-			_stream << Number(frag_len);
-
-			if (frag_len > 0)
-			{
-				// now skip the <offset>-bytes and all bytes after <offset + length>
-				obj.serialize( _stream, clip_offset, frag_len );
-			}
+			_stream << Number(length);
 
 			return (*this);
 		}
@@ -656,6 +634,36 @@ namespace dtn
 			return (*this);
 		}
 
+		/**
+		 * Read a SDNV out of a buffer and move the position forward
+		 */
+		template <class E>
+		static void __read_sdnv(const char *data, const Length len, Length &pos, dtn::data::SDNV<E> &value)
+		{
+			const size_t ret = value.decode(data + pos, len - pos);
+			if (ret == 0) throw dtn::InvalidDataException("Primary block is shorter than its length.");
+			pos += ret;
+		}
+
+		/**
+		 * Returns the EID for a reference into a dictionary byte array
+		 */
+		static dtn::data::EID __read_eid(const char *dict, const Length len, const dtn::data::Dictionary::Reference &ref)
+		{
+			const Length scheme = ref.first.get<Length>();
+			const Length ssp = ref.second.get<Length>();
+
+			if ((scheme >= len) || (ssp >= len)) throw dtn::InvalidDataException("Dictionary reference out of range.");
+
+			const char *scheme_end = static_cast<const char*>(::memchr(dict + scheme, '\0', len - scheme));
+			const char *ssp_end = static_cast<const char*>(::memchr(dict + ssp, '\0', len - ssp));
+
+			return dtn::data::EID(
+					std::string(dict + scheme, (scheme_end == NULL) ? (dict + len) : scheme_end),
+					std::string(dict + ssp, (ssp_end == NULL) ? (dict + len) : ssp_end)
+				);
+		}
+
 		Deserializer& DefaultDeserializer::operator >>(dtn::data::PrimaryBlock& obj)
 		{
 			char version = 0;
@@ -671,35 +679,66 @@ namespace dtn
 			// BLOCK LENGTH
 			_stream >> blocklength;
 
+			// read the remaining primary block at once and
+			// parse all fields out of the contiguous buffer
+			const Length len = blocklength.get<Length>();
+
+			char stack_buffer[512];
+			std::vector<char> heap_buffer;
+			char *data = stack_buffer;
+
+			if (len > sizeof(stack_buffer))
+			{
+				heap_buffer.resize(len);
+				data = &heap_buffer[0];
+			}
+
+			_stream.read(data, len);
+			if (static_cast<Length>(_stream.gcount()) != len) throw dtn::InvalidDataException("Primary block is incomplete.");
+
+			Length pos = 0;
+
 			// EID References
 			dtn::data::Dictionary::Reference ref[4];
 			for (int i = 0; i < 4; ++i)
 			{
-				_stream >> ref[i].first;
-				_stream >> ref[i].second;
+				__read_sdnv(data, len, pos, ref[i].first);
+				__read_sdnv(data, len, pos, ref[i].second);
 			}
 
 			// timestamp
-			_stream >> obj.timestamp;
+			__read_sdnv(data, len, pos, obj.timestamp);
 
 			// sequence number
-			_stream >> obj.sequencenumber;
+			__read_sdnv(data, len, pos, obj.sequencenumber);
 
 			// lifetime
-			_stream >> obj.lifetime;
+			__read_sdnv(data, len, pos, obj.lifetime);
 
-			try {
-				// dictionary
-				_stream >> _dictionary;
+			// dictionary
+			Number dictlength;
+			__read_sdnv(data, len, pos, dictlength);
+
+			const Length dictlen = dictlength.get<Length>();
+			if (dictlen > (len - pos)) throw dtn::InvalidDataException("Dictionary exceeds the primary block.");
+
+			if (dictlen > 0)
+			{
+				const char *dict = data + pos;
 
 				// decode EIDs
-				obj.destination = _dictionary.get(ref[0].first, ref[0].second);
-				obj.source = _dictionary.get(ref[1].first, ref[1].second);
-				obj.reportto = _dictionary.get(ref[2].first, ref[2].second);
-				obj.custodian = _dictionary.get(ref[3].first, ref[3].second);
+				obj.destination = __read_eid(dict, dictlen, ref[0]);
+				obj.source = __read_eid(dict, dictlen, ref[1]);
+				obj.reportto = __read_eid(dict, dictlen, ref[2]);
+				obj.custodian = __read_eid(dict, dictlen, ref[3]);
+
+				// keep the dictionary for EID references in other blocks
+				_dictionary.assign(dict, dictlen);
 				_compressed = false;
-			} catch (const dtn::InvalidDataException&) {
-				// error while reading the dictionary. We assume that this is a compressed bundle header.
+			}
+			else
+			{
+				// no dictionary available. We assume that this is a compressed bundle header.
 				obj.destination = dtn::data::EID(ref[0].first, ref[0].second);
 				obj.source = dtn::data::EID(ref[1].first, ref[1].second);
 				obj.reportto = dtn::data::EID(ref[2].first, ref[2].second);
@@ -707,11 +746,13 @@ namespace dtn
 				_compressed = true;
 			}
 
+			pos += dictlen;
+
 			// fragmentation?
 			if (obj.get(dtn::data::Bundle::FRAGMENT))
 			{
-				_stream >> obj.fragmentoffset;
-				_stream >> obj.appdatalength;
+				__read_sdnv(data, len, pos, obj.fragmentoffset);
+				__read_sdnv(data, len, pos, obj.appdatalength);
 			}
 			
 			// validate this primary block
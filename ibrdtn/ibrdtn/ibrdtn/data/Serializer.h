@@ -125,6 +125,12 @@ namespace dtn
 
 		protected:
 			Serializer &serialize(const dtn::data::PayloadBlock& obj, const Length &clip_offset, const Length &clip_length);
+
+			/**
+			 * Write the header of a block announcing the given length of the block data
+			 */
+			Serializer &serializeHeader(const dtn::data::Block &obj, const Length &length);
+
 			void rebuildDictionary(const dtn::data::Bundle &obj);
 			bool isCompressable(const dtn::data::Bundle &obj) const;
 			std::ostream &_stream;
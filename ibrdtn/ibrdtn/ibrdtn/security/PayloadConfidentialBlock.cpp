@@ -57,8 +57,93 @@ namespace dtn
 		{
 		}
 
+		PayloadConfidentialBlock::SessionKey::SessionKey(const dtn::security::SecurityKey &long_key)
+		{
+			uint32_t salt;
+
+			// create a random key
+			createSaltAndKey(salt, key, ibrcommon::AES128Stream::key_size_in_bytes);
+
+			// get the RSA key
+			RSA *rsa_key = long_key.getRSA();
+
+			// encrypt the random key
+			TLVList params;
+			addKey(params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key);
+			wrapped = params.get(SecurityBlock::key_information);
+
+			// free the RSA key
+			long_key.free(rsa_key);
+		}
+
+		PayloadConfidentialBlock::SessionKey::~SessionKey()
+		{
+		}
+
+		PayloadConfidentialBlock::KeyCache::KeyCache(const dtn::data::Size limit)
+		 : _limit(limit)
+		{
+		}
+
+		PayloadConfidentialBlock::KeyCache::~KeyCache()
+		{
+		}
+
+		bool PayloadConfidentialBlock::KeyCache::get(const std::string &wrapped, unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes]) const
+		{
+			ibrcommon::MutexLock l(_lock);
+
+			std::map<std::string, std::string>::const_iterator it = _keys.find(wrapped);
+			if (it == _keys.end()) return false;
+
+			std::copy((*it).second.begin(), (*it).second.end(), key);
+			return true;
+		}
+
+		void PayloadConfidentialBlock::KeyCache::put(const std::string &wrapped, const unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes])
+		{
+			if (_limit == 0) return;
+
+			ibrcommon::MutexLock l(_lock);
+
+			const std::string plain(reinterpret_cast<const char*>(key), ibrcommon::AES128Stream::key_size_in_bytes);
+
+			if (_keys.find(wrapped) != _keys.end()) return;
+
+			// drop the oldest keys
+			while (_order.size() >= _limit)
+			{
+				_keys.erase(_order.front());
+				_order.pop_front();
+			}
+
+			_keys[wrapped] = plain;
+			_order.push_back(wrapped);
+		}
+
+		void PayloadConfidentialBlock::KeyCache::clear()
+		{
+			ibrcommon::MutexLock l(_lock);
+			_keys.clear();
+			_order.clear();
+		}
+
+		dtn::data::Size PayloadConfidentialBlock::KeyCache::size() const
+		{
+			ibrcommon::MutexLock l(_lock);
+			return _keys.size();
+		}
+
 		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source)
 		{
+			encrypt(bundle, long_key, source, SessionKey(long_key));
+		}
+
+		void PayloadConfidentialBlock::encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const SessionKey &session)
+		{
+			// the destination is not able to decrypt the bundle without the wrapped key
+			if (session.wrapped.empty()) throw EncryptException("session key could not be encrypted with the public key of " + long_key.reference.getString());
+
 			// contains the random salt
 			uint32_t salt;
 
@@ -71,8 +156,9 @@ namespace dtn
 			// create a new correlator value
 			dtn::data::Number correlator = createCorrelatorValue(bundle);
 
-			// create a random salt and key
+			// create a random salt, the key is taken from the session
 			createSaltAndKey(salt, ephemeral_key, ibrcommon::AES128Stream::key_size_in_bytes);
+			std::copy(session.key, session.key + ibrcommon::AES128Stream::key_size_in_bytes, ephemeral_key);
 
 			// count all PCBs
 			dtn::data::Size pcbs_size = std::count(bundle.begin(), bundle.end(), PayloadConfidentialBlock::BLOCK_TYPE);
@@ -137,14 +223,8 @@ namespace dtn
 			// store encypted key, tag, iv and salt
 			addSalt(pcb._ciphersuite_params, salt);
 
-			// get the RSA key
-			RSA *rsa_key = long_key.getRSA();
-
-			// encrypt the random key and add it to the ciphersuite params
-			addKey(pcb._ciphersuite_params, ephemeral_key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key);
-
-			// free the RSA key
-			long_key.free(rsa_key);
+			// add the encrypted key to the ciphersuite params
+			pcb._ciphersuite_params.set(SecurityBlock::key_information, session.wrapped);
 
 			pcb._ciphersuite_params.set(SecurityBlock::initialization_vector, iv, ibrcommon::AES128Stream::iv_len);
 			pcb._ciphersuite_flags |= SecurityBlock::CONTAINS_CIPHERSUITE_PARAMS;
@@ -154,12 +234,22 @@ namespace dtn
 		}
 
 		void PayloadConfidentialBlock::decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key)
+		{
+			__decrypt(bundle, long_key, NULL);
+		}
+
+		void PayloadConfidentialBlock::decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, KeyCache &cache)
+		{
+			__decrypt(bundle, long_key, &cache);
+		}
+
+		void PayloadConfidentialBlock::__decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, KeyCache *cache)
 		{
 			// list of block to delete if the process is successful
 			std::list<const dtn::data::Block*> erasure_list;
 			
-			// load the RSA key
-			RSA *rsa_key = long_key.getRSA();
+			// the RSA key is loaded on demand
+			RSA *rsa_key = NULL;
 
 			try {
 				// array for the current symmetric AES key
@@ -206,11 +296,21 @@ namespace dtn
 						else if (pcb.isSecurityDestination(bundle, long_key.reference) &&
 							(pcb._ciphersuite_id == SecurityBlock::PCB_RSA_AES128_PAYLOAD_PIB_PCB))
 						{
-							// try to decrypt the symmetric AES key
-							if (!getKey(pcb._ciphersuite_params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key))
+							const std::string wrapped = pcb._ciphersuite_params.get(SecurityBlock::key_information);
+
+							// look up the symmetric AES key in the cache first
+							if ((cache == NULL) || !cache->get(wrapped, key))
 							{
-								IBRCOMMON_LOGGER_TAG("PayloadConfidentialBlock", critical) << "could not get symmetric key decrypted" << IBRCOMMON_LOGGER_ENDL;
-								throw ibrcommon::Exception("decrypt failed - could not get symmetric key decrypted");
+								if (rsa_key == NULL) rsa_key = long_key.getRSA();
+
+								// try to decrypt the symmetric AES key
+								if (!getKey(pcb._ciphersuite_params, key, ibrcommon::AES128Stream::key_size_in_bytes, rsa_key))
+								{
+									IBRCOMMON_LOGGER_TAG("PayloadConfidentialBlock", critical) << "could not get symmetric key decrypted" << IBRCOMMON_LOGGER_ENDL;
+									throw ibrcommon::Exception("decrypt failed - could not get symmetric key decrypted");
+								}
+
+								if (cache != NULL) cache->put(wrapped, key);
 							}
 
 							// try to decrypt the payload
@@ -255,11 +355,11 @@ namespace dtn
 					bundle.remove(**it);
 				}
 			} catch (const std::exception&) {
-				long_key.free(rsa_key);
+				if (rsa_key != NULL) long_key.free(rsa_key);
 				throw;
 			}
 
-			long_key.free(rsa_key);
+			if (rsa_key != NULL) long_key.free(rsa_key);
 		}
 
 		bool PayloadConfidentialBlock::decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const uint32_t salt)
@@ -25,6 +25,10 @@
 #include "ibrdtn/security/SecurityKey.h"
 #include "ibrdtn/data/PayloadBlock.h"
 #include "ibrdtn/data/ExtensionBlock.h"
+#include <ibrcommon/thread/Mutex.h>
+#include <string>
+#include <list>
+#include <map>
 
 namespace dtn
 {
@@ -59,6 +63,74 @@ namespace dtn
 					virtual dtn::data::Block* create();
 				};
 
+				/**
+				An ephemeral AES key together with its encrypted form for a
+				security destination. Encrypting several bundles with the same
+				session key saves the RSA operation for each bundle. Salt and
+				IV are still chosen randomly for each bundle.
+				*/
+				class SessionKey
+				{
+				public:
+					/**
+					Creates a random key and encrypts it with the public key
+					of the security destination.
+					@param long_key the public key of the security destination
+					*/
+					SessionKey(const dtn::security::SecurityKey &long_key);
+					virtual ~SessionKey();
+
+					/** the plaintext AES key */
+					unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes];
+
+					/** the key encrypted with the public key of the destination */
+					std::string wrapped;
+				};
+
+				/**
+				A bounded cache of decrypted session keys indexed by their
+				encrypted form. Bundles encrypted with the same session key
+				carry the same wrapped key, thus the RSA operation is only
+				necessary for the first of them. If the cache is full, the
+				oldest key is dropped.
+				*/
+				class KeyCache
+				{
+				public:
+					/**
+					@param limit the maximum number of keys in the cache
+					*/
+					KeyCache(const dtn::data::Size limit = 64);
+					virtual ~KeyCache();
+
+					/**
+					Looks up the plaintext key of a wrapped key.
+					@return true if the key has been found
+					*/
+					bool get(const std::string &wrapped, unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes]) const;
+
+					/**
+					Stores the plaintext key of a wrapped key.
+					*/
+					void put(const std::string &wrapped, const unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes]);
+
+					/**
+					Drops all keys.
+					*/
+					void clear();
+
+					/**
+					@return the number of keys in the cache
+					*/
+					dtn::data::Size size() const;
+
+				private:
+					const dtn::data::Size _limit;
+					mutable ibrcommon::Mutex _lock;
+					std::map<std::string, std::string> _keys;
+					std::list<std::string> _order;
+				};
+
 				/** The block type of this class. */
 				static const dtn::data::block_t BLOCK_TYPE;
 
@@ -74,6 +146,16 @@ namespace dtn
 				*/
 				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source);
 
+				/**
+				Encrypts the Payload like encrypt() above, but uses the given
+				session key instead of a fresh ephemeral key.
+				@param bundle the bundle with the to be encrypted payload
+				@param session the session key for the security destination
+				@throw EncryptException if the session key has not been encrypted
+				with the public key of the security destination
+				*/
+				static void encrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, const dtn::data::EID& source, const SessionKey &session);
+
 				/**
 				Decrypts the Payload inside this Bundle. All correlated Blocks, which
 				are found, will be decrypted, too, placed at the position, where their 
@@ -87,6 +169,15 @@ namespace dtn
 				*/
 				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key);
 
+				/**
+				Decrypts the Payload like decrypt() above, but looks up the
+				symmetric key in the cache first and stores it there after
+				a successful RSA decryption.
+				@param bundle the bundle with the to be decrypted payload
+				@param cache the cache of already decrypted session keys
+				*/
+				static void decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, KeyCache &cache);
+
 			protected:
 				/**
 				Creates an empty PayloadConfidentialBlock. With ciphersuite_id set to
@@ -102,6 +193,9 @@ namespace dtn
 				@return true if tag verification succeeded, false otherwise
 				*/
 				static bool decryptPayload(dtn::data::Bundle& bundle, const unsigned char ephemeral_key[ibrcommon::AES128Stream::key_size_in_bytes], const uint32_t salt);
+
+			private:
+				static void __decrypt(dtn::data::Bundle& bundle, const dtn::security::SecurityKey &long_key, KeyCache *cache);
 		};
 
 		/**
@@ -35,11 +35,42 @@ namespace dtn
 	namespace security
 	{
 		SecurityKey::SecurityKey()
-		 : type(KEY_UNSPEC), trustlevel(NONE)
+		 : type(KEY_UNSPEC), trustlevel(NONE), _rsa(NULL)
 		{}
 
+		SecurityKey::SecurityKey(const SecurityKey &other)
+		 : type(other.type), reference(other.reference), lastupdate(other.lastupdate), trustlevel(other.trustlevel),
+		   file(other.file), flags(other.flags), _rsa(other._rsa)
+		{
+			if (_rsa != NULL) RSA_up_ref(_rsa);
+		}
+
 		SecurityKey::~SecurityKey()
-		{}
+		{
+			if (_rsa != NULL) RSA_free(_rsa);
+		}
+
+		SecurityKey& SecurityKey::operator=(const SecurityKey &other)
+		{
+			type = other.type;
+			reference = other.reference;
+			lastupdate = other.lastupdate;
+			trustlevel = other.trustlevel;
+			file = other.file;
+			flags = other.flags;
+
+			if (other._rsa != NULL) RSA_up_ref(other._rsa);
+			if (_rsa != NULL) RSA_free(_rsa);
+			_rsa = other._rsa;
+
+			return *this;
+		}
+
+		void SecurityKey::setRSA(RSA* rsa)
+		{
+			if (_rsa != NULL) RSA_free(_rsa);
+			_rsa = rsa;
+		}
 
 		void SecurityKey::free(RSA* key)
 		{
@@ -75,6 +106,22 @@ namespace dtn
 
 		RSA* SecurityKey::getRSA() const
 		{
+			if (_rsa != NULL)
+			{
+				switch (type)
+				{
+				case KEY_PRIVATE:
+					// private keys are copied, because decryption
+					// modifies the blinding state of the key
+					return RSAPrivateKey_dup(_rsa);
+				case KEY_PUBLIC:
+					RSA_up_ref(_rsa);
+					return _rsa;
+				default:
+					return NULL;
+				}
+			}
+
 			switch (type)
 			{
 			case KEY_PRIVATE:
@@ -88,6 +135,13 @@ namespace dtn
 
 		EVP_PKEY* SecurityKey::getEVP() const
 		{
+			if ((_rsa != NULL) && ((type == KEY_PRIVATE) || (type == KEY_PUBLIC)))
+			{
+				EVP_PKEY* ret = EVP_PKEY_new();
+				EVP_PKEY_assign_RSA(ret, getRSA());
+				return ret;
+			}
+
 			EVP_PKEY* ret = EVP_PKEY_new();
 			FILE * pkey_file = fopen(file.getPath().c_str(), "r");
 
@@ -119,15 +173,9 @@ namespace dtn
 			switch (type)
 			{
 				case KEY_PRIVATE:
-				{
-					RSA* rsa = getPrivateRSA();
-					std::string ret = getFingerprint(rsa);
-					free(rsa);
-					return ret;
-				}
 				case KEY_PUBLIC:
 				{
-					RSA* rsa = getPublicRSA();
+					RSA* rsa = getRSA();
 					std::string ret = getFingerprint(rsa);
 					free(rsa);
 					return ret;
@@ -65,8 +65,11 @@ namespace dtn
 			};
 
 			SecurityKey();
+			SecurityKey(const SecurityKey &other);
 			virtual ~SecurityKey();
 
+			SecurityKey& operator=(const SecurityKey &other);
+
 			// key type
 			KeyType type;
 
@@ -100,6 +103,14 @@ namespace dtn
 			static void free(RSA* key);
 			static void free(EVP_PKEY* key);
 
+			/**
+			 * Attach the parsed RSA key to this object. Once attached,
+			 * getRSA() and getEVP() return the attached key instead of
+			 * reading the key file again. The object takes over the
+			 * reference of the given key.
+			 */
+			void setRSA(RSA* rsa);
+
 			friend std::ostream &operator<<(std::ostream &stream, const SecurityKey &key)
 			{
 				// key type
@@ -152,6 +163,9 @@ namespace dtn
 		private:
 			RSA* getPublicRSA() const;
 			RSA* getPrivateRSA() const;
+
+			// parsed RSA key if attached
+			RSA* _rsa;
 		};
 	}
 }
@@ -22,15 +22,24 @@
 #include "ibrdtn/streams/StreamConnection.h"
 #include <ibrcommon/Logger.h>
 #include <ibrcommon/TimeMeasurement.h>
+#include <sstream>
 #include <vector>
+#include <string.h>
 
 namespace dtn
 {
 	namespace streams
 	{
+		const unsigned int StreamConnection::StreamBuffer::EXPRESS_WEIGHT = 8;
+
+		const dtn::data::Length StreamConnection::StreamBuffer::MAX_SEGMENT_SIZE = 262144;
+
+		const unsigned int StreamConnection::StreamBuffer::SEGMENTS_IN_FLIGHT = 4;
+
 		StreamConnection::StreamBuffer::StreamBuffer(StreamConnection &conn, iostream &stream, const dtn::data::Length buffer_size)
 			: _buffer_size(buffer_size), _statebits(STREAM_SOB), _conn(conn), in_buf_(buffer_size), out_buf_(buffer_size), _stream(stream),
-			  _recv_size(0), _underflow_data_remain(0), _underflow_state(IDLE), _idle_timer(*this, 0)
+			  _recv_size(0), _underflow_data_remain(0), _underflow_state(IDLE), _idle_timer(*this, 0), _express_pending(0), _express_burst(0),
+			  _segment_size(buffer_size), _bytes_sent(0), _segments_sent(0), _segments_acked(0), _rtt_segment(0), _rtt_bytes(0)
 		{
 			// Initialize get pointer.  This should be zero so that underflow is called upon first read.
 			setg(0, 0, 0);
@@ -138,6 +147,10 @@ namespace dtn
 				if (peer._flags.getBit(StreamContactHeader::REQUEST_ACKNOWLEDGMENTS)) set(STREAM_ACK_SUPPORT);
 				if (peer._flags.getBit(StreamContactHeader::REQUEST_NEGATIVE_ACKNOWLEDGMENTS)) set(STREAM_NACK_SUPPORT);
 
+				// enable the express lane if both peers request it
+				if (header._flags.getBit(StreamContactHeader::REQUEST_INTERLEAVING)
+						&& peer._flags.getBit(StreamContactHeader::REQUEST_INTERLEAVING)) set(STREAM_EXPRESS_SUPPORT);
+
 				// set the incoming timer if set (> 0)
 				if (peer._keepalive > 0)
 				{
@@ -222,6 +235,11 @@ namespace dtn
 		void StreamConnection::StreamBuffer::abort()
 		{
 			_segments.abort();
+			_express_segments.abort();
+
+			// wake-up segments waiting for the express lane
+			ibrcommon::MutexLock l(_lane_cond);
+			_lane_cond.abort();
 		}
 
 		void StreamConnection::StreamBuffer::wait()
@@ -250,7 +268,7 @@ namespace dtn
 				char *iend = pptr();
 
 				// mark the buffer as free
-				setp(&out_buf_[0], &out_buf_[0] + _buffer_size - 1);
+				setp(&out_buf_[0], &out_buf_[0] + out_buf_.size() - 1);
 
 				// append the last character
 				if(!traits_type::eq_int_type(c, traits_type::eof())) {
@@ -263,48 +281,11 @@ namespace dtn
 					return traits_type::not_eof(c);
 				}
 
-				// wrap a segment around the data
-				StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, (iend - ibegin));
-
-				// set the start flag
-				if (get(STREAM_SOB))
-				{
-					seg._flags |= StreamDataSegment::MSG_MARK_BEGINN;
-					unset(STREAM_SKIP);
-					unset(STREAM_SOB);
-				}
+				// wrap a segment around the data and send it
+				__segment(ibegin, (iend - ibegin), char_traits<char>::eq_int_type(c, char_traits<char>::eof()));
 
-				if (char_traits<char>::eq_int_type(c, char_traits<char>::eof()))
-				{
-					// set the end flag
-					seg._flags |= StreamDataSegment::MSG_MARK_END;
-					set(STREAM_SOB);
-				}
-
-				if (!get(STREAM_SKIP))
-				{
-					// put the segment into the queue
-					if (get(STREAM_ACK_SUPPORT))
-					{
-						_segments.push(seg);
-					}
-					else if (seg._flags & StreamDataSegment::MSG_MARK_END)
-					{
-						// without ACK support we have to assume that a bundle is forwarded
-						// when the last segment is sent.
-						_conn.eventBundleForwarded();
-					}
-
-					ibrcommon::MutexLock l(_sendlock);
-					if (!_stream.good()) throw StreamErrorException("stream went bad");
-
-					// write the segment to the stream
-					_stream << seg;
-					_stream.write(&out_buf_[0], seg._value.get<size_t>());
-
-					// record statistics
-					_conn._callback.addTrafficOut(seg._value.get<size_t>());
-				}
+				// adapt the buffer to the current segment size
+				__adapt();
 
 				return traits_type::not_eof(c);
 			} catch (const StreamClosedException&) {
@@ -333,6 +314,219 @@ namespace dtn
 			return traits_type::eof();
 		}
 
+		std::streamsize StreamConnection::StreamBuffer::xsputn(const char *s, std::streamsize n)
+		{
+			std::streamsize done = 0;
+
+			try {
+				while (done < n)
+				{
+					const dtn::data::Length remain = n - done;
+					const dtn::data::Length size = out_buf_.size();
+
+					// send whole segments directly out of the data, at least one
+					// byte is kept in the buffer to mark the end of the bundle on sync()
+					if ((pptr() == pbase()) && (remain > size))
+					{
+						__segment(s + done, size, false);
+						__adapt();
+						done += size;
+						continue;
+					}
+
+					// copy the data into the buffer
+					std::streamsize avail = epptr() - pptr();
+					if (avail > n - done) avail = n - done;
+					::memcpy(pptr(), s + done, avail);
+					pbump(static_cast<int>(avail));
+					done += avail;
+
+					// send the full buffer
+					if ((done < n) && (pptr() == epptr()))
+					{
+						overflow(traits_type::to_int_type(s[done]));
+						++done;
+					}
+				}
+			} catch (const std::exception &ex) {
+				// set failed bit
+				set(STREAM_FAILED);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "exception in xsputn(): " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+				throw;
+			}
+
+			return done;
+		}
+
+		void StreamConnection::StreamBuffer::__segment(const char *data, const dtn::data::Length &length, const bool end)
+		{
+			// wrap a segment around the data
+			StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, length);
+
+			// set the start flag
+			if (get(STREAM_SOB))
+			{
+				seg._flags |= StreamDataSegment::MSG_MARK_BEGINN;
+				unset(STREAM_SKIP);
+				unset(STREAM_SOB);
+			}
+
+			if (end)
+			{
+				// set the end flag
+				seg._flags |= StreamDataSegment::MSG_MARK_END;
+				set(STREAM_SOB);
+			}
+
+			if (!get(STREAM_SKIP))
+			{
+				// write the segment to the stream
+				transmit(seg, data, false);
+			}
+		}
+
+		void StreamConnection::StreamBuffer::__adapt()
+		{
+			const dtn::data::Length size = getSegmentSize();
+			if (size == out_buf_.size()) return;
+
+			// the buffer has to be empty
+			out_buf_.resize(size);
+			setp(&out_buf_[0], &out_buf_[0] + size - 1);
+		}
+
+		dtn::data::Length StreamConnection::StreamBuffer::getSegmentSize() const
+		{
+			ibrcommon::MutexLock l(const_cast<ibrcommon::Mutex&>(_segment_lock));
+			return _segment_size;
+		}
+
+		void StreamConnection::StreamBuffer::__sent(const dtn::data::Length &length)
+		{
+			ibrcommon::MutexLock l(_segment_lock);
+			++_segments_sent;
+			_bytes_sent += length;
+
+			// start a new round-trip measurement with this segment
+			if (_rtt_segment == 0)
+			{
+				_rtt_segment = _segments_sent;
+				_rtt_bytes = _bytes_sent - length;
+				_rtt_tm.start();
+			}
+		}
+
+		void StreamConnection::StreamBuffer::__acknowledged()
+		{
+			ibrcommon::MutexLock l(_segment_lock);
+			++_segments_acked;
+
+			if ((_rtt_segment == 0) || (_segments_acked < _rtt_segment)) return;
+			_rtt_tm.stop();
+			_rtt_segment = 0;
+
+			// the data sent within one round-trip is the bandwidth-delay product
+			// of the connection as long as the sender is not idle
+			const dtn::data::Length bdp = _bytes_sent - _rtt_bytes;
+
+			// a few segments should cover the bandwidth-delay product
+			dtn::data::Length target = bdp / SEGMENTS_IN_FLIGHT;
+			if (target > MAX_SEGMENT_SIZE) target = MAX_SEGMENT_SIZE;
+			if (target < _buffer_size) target = _buffer_size;
+
+			// smooth the changes of the segment size
+			_segment_size = (_segment_size * 3 + target) / 4;
+
+			IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 40) << "rtt: " << _rtt_tm.getMilliseconds() << " ms, bdp: " << bdp << " bytes, segment size: " << _segment_size << IBRCOMMON_LOGGER_ENDL;
+		}
+
+		void StreamConnection::StreamBuffer::__refused()
+		{
+			const size_t queued = _segments.size();
+
+			ibrcommon::MutexLock l(_segment_lock);
+
+			// segments of a refused bundle are not acknowledged anymore
+			_segments_acked = (_segments_sent > queued) ? (_segments_sent - queued) : 0;
+			_rtt_segment = 0;
+		}
+
+		void StreamConnection::StreamBuffer::transmit(const StreamDataSegment &seg, const char *data, const bool express)
+		{
+			{
+				ibrcommon::MutexLock l(_lane_cond);
+
+				if (express)
+				{
+					// announce the express segment
+					++_express_pending;
+				}
+				else
+				{
+					try {
+						// give way to pending segments of the express lane
+						while ((_express_pending > 0) && (_express_burst < EXPRESS_WEIGHT))
+						{
+							_lane_cond.wait();
+						}
+					} catch (const ibrcommon::Conditional::ConditionalAbortException&) {
+						throw StreamClosedException();
+					}
+
+					_express_burst = 0;
+				}
+			}
+
+			try {
+				ibrcommon::Queue<StreamDataSegment> &segments = express ? _express_segments : _segments;
+
+				// put the segment into the queue
+				if (get(STREAM_ACK_SUPPORT))
+				{
+					segments.push(seg);
+					if (!express) __sent(seg._value.get<dtn::data::Length>());
+				}
+				else if (seg._flags & StreamDataSegment::MSG_MARK_END)
+				{
+					// without ACK support we have to assume that a bundle is forwarded
+					// when the last segment is sent.
+					if (express) _conn._callback.eventExpressBundleForwarded();
+					else _conn.eventBundleForwarded();
+				}
+
+				ibrcommon::MutexLock l(_sendlock);
+				if (!_stream.good()) throw StreamErrorException("stream went bad");
+
+				// write the segment to the stream
+				_stream << seg;
+				_stream.write(data, seg._value.get<size_t>());
+
+				// do not delay the last segment of an express bundle
+				if (express && (seg._flags & StreamDataSegment::MSG_MARK_END)) _stream.flush();
+
+				// record statistics
+				_conn._callback.addTrafficOut(seg._value.get<size_t>());
+			} catch (...) {
+				if (express)
+				{
+					ibrcommon::MutexLock l(_lane_cond);
+					--_express_pending;
+					_lane_cond.signal(true);
+				}
+				throw;
+			}
+
+			if (express)
+			{
+				ibrcommon::MutexLock l(_lane_cond);
+				--_express_pending;
+				++_express_burst;
+				_lane_cond.signal(true);
+			}
+		}
+
 		// This is called to flush the buffer.
 		// This is called when we're done with the file stream (or when .flush() is called).
 		int StreamConnection::StreamBuffer::sync()
@@ -385,6 +579,67 @@ namespace dtn
 			}
 		}
 
+		void StreamConnection::StreamBuffer::__express(const StreamDataSegment &seg)
+		{
+			if (!get(STREAM_EXPRESS_SUPPORT)) throw StreamErrorException("express lane not negotiated");
+
+			// start a new bundle
+			if (seg._flags & StreamDataSegment::MSG_MARK_BEGINN) _express_data.clear();
+
+			const dtn::data::Length length = seg._value.get<Length>();
+			if (length > (StreamConnection::EXPRESS_LIMIT - _express_data.size()))
+			{
+				throw StreamErrorException("express bundle exceeds the limit");
+			}
+
+			// read the whole segment
+			const size_t offset = _express_data.size();
+			_express_data.resize(offset + length);
+
+			try {
+				if (length > 0) _stream.read(&_express_data[offset], (std::streamsize)length);
+			} catch (const ios_base::failure &ex) {
+				throw StreamErrorException("read error: " + std::string(ex.what()));
+			}
+
+			// record statistics
+			_conn._callback.addTrafficIn(length);
+
+			bool accepted = true;
+
+			if (seg._flags & StreamDataSegment::MSG_MARK_END)
+			{
+				std::istringstream ss(_express_data);
+				_express_data.clear();
+
+				// hand-over the bundle before the last segment is acknowledged
+				accepted = _conn._callback.eventExpressBundleReceived(ss);
+			}
+
+			if (!get(STREAM_ACK_SUPPORT)) return;
+
+			if (accepted || !get(STREAM_NACK_SUPPORT))
+			{
+				// acknowledge the segment
+				StreamDataSegment ack(StreamDataSegment::MSG_ACK_SEGMENT, offset + length);
+				ack._flags |= StreamDataSegment::MSG_MARK_EXPRESS;
+
+				ibrcommon::MutexLock l(_sendlock);
+				if (!_stream.good()) throw StreamErrorException("stream went bad");
+				_stream << ack << std::flush;
+			}
+			else
+			{
+				// refuse the bundle, the sender has to queue it again
+				StreamDataSegment refuse(StreamDataSegment::MSG_REFUSE_BUNDLE, 0);
+				refuse._flags |= StreamDataSegment::MSG_MARK_EXPRESS;
+
+				ibrcommon::MutexLock l(_sendlock);
+				if (!_stream.good()) throw StreamErrorException("stream went bad");
+				_stream << refuse << std::flush;
+			}
+		}
+
 		// Fill the input buffer.  This reads out of the streambuf.
 		std::char_traits<char>::int_type StreamConnection::StreamBuffer::underflow()
 		{
@@ -455,6 +710,13 @@ namespace dtn
 						{
 							IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 70) << "MSG_DATA_SEGMENT received, size: " << seg._value.toString() << IBRCOMMON_LOGGER_ENDL;
 
+							// segments of the express lane are processed immediately
+							if (seg._flags & StreamDataSegment::MSG_MARK_EXPRESS)
+							{
+								__express(seg);
+								break;
+							}
+
 							if (seg._flags & StreamDataSegment::MSG_MARK_BEGINN)
 							{
 								_recv_size = seg._value;
@@ -496,8 +758,26 @@ namespace dtn
 						{
 							IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 70) << "MSG_ACK_SEGMENT received, size: " << seg._value.toString() << IBRCOMMON_LOGGER_ENDL;
 
+							// remove the segment of the express lane in the queue
+							if (get(STREAM_ACK_SUPPORT) && (seg._flags & StreamDataSegment::MSG_MARK_EXPRESS))
+							{
+								ibrcommon::Queue<StreamDataSegment>::Locked q = _express_segments.exclusive();
+								if (q.empty())
+								{
+									IBRCOMMON_LOGGER_TAG("StreamBuffer", error) << "got an unexpected express ACK with size of " << seg._value.toString() << IBRCOMMON_LOGGER_ENDL;
+								}
+								else
+								{
+									if (q.front()._flags & StreamDataSegment::MSG_MARK_END)
+									{
+										_conn._callback.eventExpressBundleForwarded();
+									}
+
+									q.pop();
+								}
+							}
 							// remove the segment in the queue
-							if (get(STREAM_ACK_SUPPORT))
+							else if (get(STREAM_ACK_SUPPORT))
 							{
 								ibrcommon::Queue<StreamDataSegment>::Locked q = _segments.exclusive();
 								if (q.empty())
@@ -518,6 +798,7 @@ namespace dtn
 									}
 
 									q.pop();
+									__acknowledged();
 								}
 							}
 							break;
@@ -533,8 +814,29 @@ namespace dtn
 
 							// TODO: Test bundle rejection!
 
+							// remove the segments of the refused bundle on the express lane
+							if (get(STREAM_ACK_SUPPORT) && get(STREAM_NACK_SUPPORT) && (seg._flags & StreamDataSegment::MSG_MARK_EXPRESS))
+							{
+								ibrcommon::Queue<StreamDataSegment>::Locked q = _express_segments.exclusive();
+								if (q.empty())
+								{
+									IBRCOMMON_LOGGER_TAG("StreamBuffer", error) << "got an unexpected express NACK" << IBRCOMMON_LOGGER_ENDL;
+								}
+								else
+								{
+									// the receiver refuses a bundle after its last segment
+									while (!q.empty())
+									{
+										const bool end = (q.front()._flags & StreamDataSegment::MSG_MARK_END);
+										q.pop();
+										if (end) break;
+									}
+
+									_conn._callback.eventExpressBundleRefused();
+								}
+							}
 							// remove the segment in the queue
-							if (get(STREAM_ACK_SUPPORT) && get(STREAM_NACK_SUPPORT))
+							else if (get(STREAM_ACK_SUPPORT) && get(STREAM_NACK_SUPPORT))
 							{
 								// skip segments
 								if (!_rejected_segments.empty())
@@ -565,6 +867,9 @@ namespace dtn
 										_segments.pop();
 									}
 
+									// restart the segment accounting
+									__refused();
+
 									// call event reject
 									_conn.eventBundleRefused();
 
@@ -605,24 +910,8 @@ namespace dtn
 				dtn::data::Length readsize = _buffer_size;
 				if (_underflow_data_remain < _buffer_size) readsize = _underflow_data_remain;
 
-				try {
-					if (!_stream.good()) throw StreamErrorException("stream went bad");
-
-					// here receive the data
-					_stream.read(&in_buf_[0], (std::streamsize)readsize);
-
-					// record statistics
-					_conn._callback.addTrafficIn(readsize);
-
-					// reset idle timeout
-					_idle_timer.reset();
-				} catch (const ios_base::failure &ex) {
-					_underflow_state = IDLE;
-					throw StreamErrorException("read error: " + std::string(ex.what()));
-				}
-
-				// adjust the remain counter
-				_underflow_data_remain -= readsize;
+				// here receive the data
+				__read(&in_buf_[0], readsize);
 
 				// Since the input buffer content is now valid (or is new)
 				// the get pointer should be initialized (or reset).
@@ -653,6 +942,76 @@ namespace dtn
 			return traits_type::eof();
 		}
 
+		std::streamsize StreamConnection::StreamBuffer::xsgetn(char *s, std::streamsize n)
+		{
+			std::streamsize done = 0;
+
+			while (done < n)
+			{
+				// take the buffered data first
+				std::streamsize avail = egptr() - gptr();
+				if (avail > 0)
+				{
+					if (avail > (n - done)) avail = (n - done);
+					::memcpy(s + done, gptr(), avail);
+					gbump(static_cast<int>(avail));
+					done += avail;
+					continue;
+				}
+
+				// read large amounts of segment data directly into the destination
+				if ((_underflow_state == DATA_TRANSFER) && (_underflow_data_remain > 0) && !get(STREAM_REJECT)
+						&& (static_cast<dtn::data::Length>(n - done) >= _buffer_size))
+				{
+					dtn::data::Length readsize = n - done;
+					if (_underflow_data_remain < readsize) readsize = _underflow_data_remain;
+
+					try {
+						__read(s + done, readsize);
+					} catch (const StreamErrorException &ex) {
+						// set failed bit
+						set(STREAM_FAILED);
+
+						IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "StreamErrorException in xsgetn(): " << ex.what() << IBRCOMMON_LOGGER_ENDL;
+
+						throw;
+					}
+
+					done += readsize;
+					continue;
+				}
+
+				// process the next segment
+				if (traits_type::eq_int_type(underflow(), traits_type::eof())) break;
+			}
+
+			return done;
+		}
+
+		void StreamConnection::StreamBuffer::__read(char *data, const dtn::data::Length &length)
+		{
+			try {
+				if (!_stream.good()) throw StreamErrorException("stream went bad");
+
+				// here receive the data
+				_stream.read(data, (std::streamsize)length);
+
+				if (static_cast<dtn::data::Length>(_stream.gcount()) != length) throw StreamErrorException("stream went bad");
+
+				// record statistics
+				_conn._callback.addTrafficIn(length);
+
+				// reset idle timeout
+				_idle_timer.reset();
+			} catch (const ios_base::failure &ex) {
+				_underflow_state = IDLE;
+				throw StreamErrorException("read error: " + std::string(ex.what()));
+			}
+
+			// adjust the remain counter
+			_underflow_data_remain -= length;
+		}
+
 		size_t StreamConnection::StreamBuffer::timeout(ibrcommon::Timer*)
 		{
 			if (__good())
@@ -667,5 +1026,93 @@ namespace dtn
 			_idle_timer.set(seconds);
 			_idle_timer.start();
 		}
+
+		StreamConnection::ExpressBuffer::ExpressBuffer(StreamBuffer &buf, const dtn::data::Length buffer_size)
+		 : _buf(buf), _buffer_size(buffer_size), out_buf_(buffer_size), _sob(true)
+		{
+			setp(&out_buf_[0], &out_buf_[0] + _buffer_size - 1);
+		}
+
+		StreamConnection::ExpressBuffer::~ExpressBuffer()
+		{
+		}
+
+		std::char_traits<char>::int_type StreamConnection::ExpressBuffer::overflow(std::char_traits<char>::int_type c)
+		{
+			char *ibegin = &out_buf_[0];
+			char *iend = pptr();
+
+			// mark the buffer as free
+			setp(&out_buf_[0], &out_buf_[0] + _buffer_size - 1);
+
+			// append the last character
+			if(!traits_type::eq_int_type(c, traits_type::eof())) {
+				*iend++ = traits_type::to_char_type(c);
+			}
+
+			// if there is nothing to send, just return
+			// an empty segment is needed to mark the end of a bundle
+			if (((iend - ibegin) == 0) && _sob)
+			{
+				return traits_type::not_eof(c);
+			}
+
+			try {
+				if (!_buf.get(StreamBuffer::STREAM_EXPRESS_SUPPORT)) throw StreamErrorException("express lane not negotiated");
+
+				// wrap a segment around the data
+				StreamDataSegment seg(StreamDataSegment::MSG_DATA_SEGMENT, (iend - ibegin));
+				seg._flags |= StreamDataSegment::MSG_MARK_EXPRESS;
+
+				// set the start flag
+				if (_sob)
+				{
+					seg._flags |= StreamDataSegment::MSG_MARK_BEGINN;
+					_sob = false;
+				}
+
+				if (char_traits<char>::eq_int_type(c, char_traits<char>::eof()))
+				{
+					// set the end flag
+					seg._flags |= StreamDataSegment::MSG_MARK_END;
+					_sob = true;
+				}
+
+				// write the segment to the stream
+				_buf.transmit(seg, ibegin, true);
+
+				return traits_type::not_eof(c);
+			} catch (const StreamClosedException&) {
+				// set failed bit
+				_buf.set(StreamBuffer::STREAM_FAILED);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "StreamClosedException in express overflow()" << IBRCOMMON_LOGGER_ENDL;
+
+				throw;
+			} catch (const StreamErrorException&) {
+				// set failed bit
+				_buf.set(StreamBuffer::STREAM_FAILED);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "StreamErrorException in express overflow()" << IBRCOMMON_LOGGER_ENDL;
+
+				throw;
+			} catch (const ios_base::failure&) {
+				// set failed bit
+				_buf.set(StreamBuffer::STREAM_FAILED);
+
+				IBRCOMMON_LOGGER_DEBUG_TAG("StreamBuffer", 10) << "ios_base::failure in express overflow()" << IBRCOMMON_LOGGER_ENDL;
+
+				throw;
+			}
+
+			return traits_type::eof();
+		}
+
+		int StreamConnection::ExpressBuffer::sync()
+		{
+			// send the remaining data as last segment of the bundle
+			return traits_type::eq_int_type(this->overflow(traits_type::eof()),
+											traits_type::eof()) ? -1 : 0;
+		}
 	}
 }
@@ -33,8 +33,11 @@ namespace dtn
 {
 	namespace streams
 	{
+		const dtn::data::Length StreamConnection::EXPRESS_LIMIT = 65536;
+
 		StreamConnection::StreamConnection(StreamConnection::Callback &cb, iostream &stream, const dtn::data::Length buffer_size)
-		 : std::iostream(&_buf), _callback(cb), _buf(*this, stream, buffer_size), _shutdown_reason(CONNECTION_SHUTDOWN_NOTSET)
+		 : std::iostream(&_buf), _callback(cb), _buf(*this, stream, buffer_size), _express_buf(_buf, buffer_size), _express(&_express_buf),
+		   _shutdown_reason(CONNECTION_SHUTDOWN_NOTSET)
 		{
 		}
 
@@ -159,5 +162,15 @@ namespace dtn
 		{
 			_buf.enableIdleTimeout(seconds);
 		}
+
+		bool StreamConnection::isExpressSupported() const
+		{
+			return _buf.get(StreamBuffer::STREAM_EXPRESS_SUPPORT);
+		}
+
+		std::ostream& StreamConnection::express()
+		{
+			return _express;
+		}
 	}
 }
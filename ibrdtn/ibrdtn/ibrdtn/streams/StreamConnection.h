@@ -29,11 +29,14 @@
 #include "ibrdtn/streams/StreamDataSegment.h"
 #include <ibrcommon/thread/Mutex.h>
 #include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/Timer.h>
 #include <ibrcommon/Exceptions.h>
 #include <ibrcommon/thread/Queue.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include <iostream>
 #include <streambuf>
+#include <string>
 #include <vector>
 
 namespace dtn
@@ -126,6 +129,28 @@ namespace dtn
 				 */
 				virtual void eventBundleAck(const dtn::data::Length &ack) throw () = 0;
 
+				/**
+				 * This method is called if a bundle sent on the express lane
+				 * is acknowledged completely.
+				 */
+				virtual void eventExpressBundleForwarded() throw () { };
+
+				/**
+				 * This method is called if a bundle sent on the express lane
+				 * is refused by the peer.
+				 */
+				virtual void eventExpressBundleRefused() throw () { };
+
+				/**
+				 * This method is called if a bundle has been received on the
+				 * express lane. The last segment of the bundle is acknowledged
+				 * after this call returns.
+				 * @param stream Stream containing the whole bundle
+				 * @return False, if the bundle has not been accepted and has
+				 * to be refused.
+				 */
+				virtual bool eventExpressBundleReceived(std::istream&) throw () { return false; };
+
 				/**
 				 * This method is called if a handshake was successful.
 				 * @param header
@@ -148,6 +173,11 @@ namespace dtn
 				virtual void addTrafficOut(size_t) throw () { };
 			};
 
+			/**
+			 * Maximum size of a bundle transferred on the express lane
+			 */
+			static const dtn::data::Length EXPRESS_LIMIT;
+
 			/**
 			 * Constructor of the StreamConnection class
 			 * @param cb Callback object for events of this stream
@@ -207,7 +237,23 @@ namespace dtn
 			 */
 			void enableIdleTimeout(const dtn::data::Timeout &seconds);
 
+			/**
+			 * Returns true, if both peers support the express lane
+			 */
+			bool isExpressSupported() const;
+
+			/**
+			 * Stream to send bundles on the express lane. The segments of
+			 * these bundles are interleaved with the segments of the
+			 * regular stream, thus a small bundle has not to wait until
+			 * a large bundle is transferred completely. Only available if
+			 * REQUEST_INTERLEAVING has been negotiated during the handshake.
+			 */
+			std::ostream& express();
+
 		private:
+			class ExpressBuffer;
+
 			/**
 			 * stream buffer class
 			 */
@@ -277,22 +323,83 @@ namespace dtn
 				 */
 				void enableIdleTimeout(const dtn::data::Timeout &seconds);
 
+				/**
+				 * Write a data segment to the stream. Segments of the regular
+				 * stream give way to pending segments of the express lane, but
+				 * at least one of them is sent after EXPRESS_WEIGHT segments
+				 * of the express lane.
+				 * @param seg The segment header
+				 * @param data The data of the segment
+				 * @param express True, if the segment belongs to the express lane
+				 */
+				void transmit(const StreamDataSegment &seg, const char *data, const bool express);
+
+				/**
+				 * Returns the current size of outgoing data segments
+				 */
+				dtn::data::Length getSegmentSize() const;
+
 			protected:
 				virtual int sync();
 				virtual std::char_traits<char>::int_type overflow(std::char_traits<char>::int_type = std::char_traits<char>::eof());
 				virtual std::char_traits<char>::int_type underflow();
 
+				/**
+				 * Large writes are sent as data segments directly out of
+				 * the given data without copying them into the buffer.
+				 */
+				virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+				/**
+				 * Large reads of segment data are received directly into
+				 * the given buffer.
+				 */
+				virtual std::streamsize xsgetn(char *s, std::streamsize n);
+
 			private:
+				friend class ExpressBuffer;
+
 				/**
 				 * @return True, if the stream is working.
 				 */
 				bool __good() const;
 
+				/**
+				 * Receive a data segment of the express lane
+				 */
+				void __express(const StreamDataSegment &seg);
+
 				/**
 				 * print out the state of the stream
 				 */
 				void __error() const;
 
+				/**
+				 * Wrap a data segment of the regular stream around the data
+				 * and send it.
+				 * @param end True, if this is the last segment of a bundle
+				 */
+				void __segment(const char *data, const dtn::data::Length &length, const bool end);
+
+				/**
+				 * Resize the empty output buffer to the current segment size
+				 */
+				void __adapt();
+
+				/**
+				 * Read data of the current segment from the stream
+				 */
+				void __read(char *data, const dtn::data::Length &length);
+
+				/**
+				 * Account a sent or acknowledged segment of the regular
+				 * stream and adapt the segment size to the observed
+				 * bandwidth-delay product
+				 */
+				void __sent(const dtn::data::Length &length);
+				void __acknowledged();
+				void __refused();
+
 				enum timerNames
 				{
 					TIMER_IN = 1,
@@ -312,9 +419,20 @@ namespace dtn
 					STREAM_ACK_SUPPORT = 1 << 8,
 					STREAM_NACK_SUPPORT = 1 << 9,
 					STREAM_SOB = 1 << 10,			// start of bundle
-					STREAM_TIMER_SUPPORT = 1 << 11
+					STREAM_TIMER_SUPPORT = 1 << 11,
+					STREAM_EXPRESS_SUPPORT = 1 << 12
 				};
 
+				// number of express segments sent before a regular segment
+				// has to be sent
+				static const unsigned int EXPRESS_WEIGHT;
+
+				// upper limit of the adaptive segment size
+				static const dtn::data::Length MAX_SEGMENT_SIZE;
+
+				// number of segments which should cover the bandwidth-delay product
+				static const unsigned int SEGMENTS_IN_FLIGHT;
+
 				void skipData(dtn::data::Length &size);
 
 				bool get(const StateBits bit) const;
@@ -349,6 +467,55 @@ namespace dtn
 				State _underflow_state;
 
 				ibrcommon::Timer _idle_timer;
+
+				// scheduling of data segments between both lanes
+				ibrcommon::Conditional _lane_cond;
+				unsigned int _express_pending;
+				unsigned int _express_burst;
+
+				// this queue contains all sent express segments
+				ibrcommon::Queue<StreamDataSegment> _express_segments;
+
+				// the express bundle in reception
+				std::string _express_data;
+
+				// adaptive size of outgoing segments
+				ibrcommon::Mutex _segment_lock;
+				dtn::data::Length _segment_size;
+				dtn::data::Length _bytes_sent;
+				size_t _segments_sent;
+				size_t _segments_acked;
+
+				// the segment used to measure the round-trip time
+				size_t _rtt_segment;
+				dtn::data::Length _rtt_bytes;
+				ibrcommon::TimeMeasurement _rtt_tm;
+			};
+
+			/**
+			 * stream buffer for the express lane, the segments are
+			 * written through the stream buffer of the connection
+			 */
+			class ExpressBuffer : public std::basic_streambuf<char, std::char_traits<char> >
+			{
+			public:
+				ExpressBuffer(StreamBuffer &buf, const dtn::data::Length buffer_size);
+				virtual ~ExpressBuffer();
+
+			protected:
+				virtual int sync();
+				virtual std::char_traits<char>::int_type overflow(std::char_traits<char>::int_type = std::char_traits<char>::eof());
+
+			private:
+				StreamBuffer &_buf;
+
+				const dtn::data::Length _buffer_size;
+
+				// Output buffer
+				std::vector<char> out_buf_;
+
+				// start of bundle
+				bool _sob;
 			};
 
 			void connectionTimeout();
@@ -365,6 +532,9 @@ namespace dtn
 
 			StreamConnection::StreamBuffer _buf;
 
+			StreamConnection::ExpressBuffer _express_buf;
+			std::ostream _express;
+
 			ibrcommon::Mutex _shutdown_reason_lock;
 			ConnectionShutdownCases _shutdown_reason;
 		};
@@ -48,6 +48,8 @@ namespace dtn
 				REQUEST_FRAGMENTATION = 1 << 1,
 				REQUEST_NEGATIVE_ACKNOWLEDGMENTS = 1 << 2,
 				/* this flag is implementation specific and not in the draft */
+				REQUEST_INTERLEAVING = 1 << 3,
+				/* this flag is implementation specific and not in the draft */
 				REQUEST_TLS = 1 << 7,
 				HANDSHAKE_SENDONLY = 0x80//!< The client only send bundle and do not want to received any bundle.
 			};
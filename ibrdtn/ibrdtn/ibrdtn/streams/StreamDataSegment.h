@@ -47,7 +47,9 @@ namespace dtn
 			enum SegmentMark
 			{
 				MSG_MARK_BEGINN = 0x02,
-				MSG_MARK_END = 0x01
+				MSG_MARK_END = 0x01,
+				/* this flag is implementation specific and not in the draft */
+				MSG_MARK_EXPRESS = 0x04
 			};
 
 			enum ShutdownReason
@@ -0,0 +1,195 @@
+/*
+ * TestAggregateRecords.cpp
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "data/TestAggregateRecords.h"
+#include <ibrdtn/data/BundleIDRanges.h>
+#include <ibrdtn/data/AggregateStatusReportBlock.h>
+#include <ibrdtn/data/AggregateCustodySignalBlock.h>
+#include <ibrdtn/data/StatusReportBlock.h>
+#include <ibrdtn/data/CustodySignalBlock.h>
+#include <ibrdtn/data/PayloadBlock.h>
+#include <ibrdtn/data/Bundle.h>
+#include <ibrdtn/data/BundleString.h>
+#include <ibrdtn/data/Exceptions.h>
+#include <sstream>
+#include <list>
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TestAggregateRecords);
+
+static int getRecordType(const dtn::data::PayloadBlock &payload)
+{
+	ibrcommon::BLOB::Reference ref = payload.getBLOB();
+	ibrcommon::BLOB::iostream stream = ref.iostream();
+	return ((*stream).get() >> 4) & 0x0f;
+}
+
+static dtn::data::BundleID createID(const std::string &source, size_t timestamp, size_t seqno)
+{
+	dtn::data::BundleID id;
+	id.source = dtn::data::EID(source);
+	id.timestamp = timestamp;
+	id.sequencenumber = seqno;
+	return id;
+}
+
+void TestAggregateRecords::setUp()
+{
+}
+
+void TestAggregateRecords::tearDown()
+{
+}
+
+void TestAggregateRecords::rangesTest(void)
+{
+	dtn::data::BundleIDRanges ranges;
+
+	// two consecutive runs and a single bundle of another source
+	for (size_t i = 0; i < 100; ++i) ranges.add(createID("dtn://source1/app", 1000, i));
+	for (size_t i = 200; i < 250; ++i) ranges.add(createID("dtn://source1/app", 1000, i));
+	ranges.add(createID("dtn://source2/app", 1001, 7));
+
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)151, ranges.size());
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)3, ranges.getRanges());
+
+	std::stringstream ss;
+	ss << ranges;
+
+	// the encoding has to be much smaller than a list of single IDs
+	CPPUNIT_ASSERT(ss.str().size() < 64);
+
+	dtn::data::BundleIDRanges decoded;
+	ss >> decoded;
+
+	CPPUNIT_ASSERT_EQUAL(ranges.size(), decoded.size());
+	CPPUNIT_ASSERT(decoded.has(createID("dtn://source1/app", 1000, 0)));
+	CPPUNIT_ASSERT(decoded.has(createID("dtn://source1/app", 1000, 249)));
+	CPPUNIT_ASSERT(decoded.has(createID("dtn://source2/app", 1001, 7)));
+	CPPUNIT_ASSERT(!decoded.has(createID("dtn://source1/app", 1000, 150)));
+	CPPUNIT_ASSERT(!decoded.has(createID("dtn://source2/app", 1000, 7)));
+}
+
+void TestAggregateRecords::truncatedRangesTest(void)
+{
+	dtn::data::BundleIDRanges ranges;
+	for (size_t i = 0; i < 10; ++i) ranges.add(createID("dtn://source1/app", 1000, i * 2));
+
+	std::stringstream ss;
+	ss << ranges;
+	const std::string data = ss.str();
+
+	// every cut of the encoding is detected
+	for (size_t len = 0; len < data.size(); ++len)
+	{
+		std::stringstream truncated(data.substr(0, len));
+		dtn::data::BundleIDRanges decoded;
+		CPPUNIT_ASSERT_THROW(truncated >> decoded, dtn::InvalidDataException);
+	}
+}
+
+void TestAggregateRecords::hugeRangesTest(void)
+{
+	// a huge number of groups without data
+	{
+		std::stringstream ss;
+		ss << dtn::data::Number(static_cast<dtn::data::Size>(1) << 62);
+
+		dtn::data::BundleIDRanges decoded;
+		CPPUNIT_ASSERT_THROW(ss >> decoded, dtn::InvalidDataException);
+	}
+
+	// a range length which wraps around the limit
+	{
+		std::stringstream ss;
+		ss << dtn::data::Number(1);
+		ss << dtn::data::BundleString("dtn://source1/app");
+		ss << dtn::data::Number(1000) << dtn::data::Number(2);
+		ss << dtn::data::Number(0) << dtn::data::Number(10);
+		ss << dtn::data::Number(100) << dtn::data::Number(static_cast<dtn::data::Size>(-5));
+
+		dtn::data::BundleIDRanges decoded;
+		CPPUNIT_ASSERT_THROW(ss >> decoded, dtn::InvalidDataException);
+	}
+}
+
+void TestAggregateRecords::statusReportTest(void)
+{
+	dtn::data::AggregateStatusReportBlock report;
+	report.status = dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE;
+	report.reasoncode = dtn::data::StatusReportBlock::NO_ADDITIONAL_INFORMATION;
+	report.timeofreport.set();
+
+	for (size_t i = 10; i < 20; ++i) report.bundles.add(createID("dtn://source/app", 500, i));
+
+	dtn::data::Bundle b;
+	dtn::data::PayloadBlock &payload = b.push_back<dtn::data::PayloadBlock>();
+	report.write(payload);
+
+	// the record type must not collide with assigned record types
+	CPPUNIT_ASSERT_EQUAL(14, getRecordType(payload));
+
+	// a single status report must not accept the aggregate
+	dtn::data::StatusReportBlock single;
+	CPPUNIT_ASSERT_THROW(single.read(payload), dtn::data::AdministrativeBlock::WrongRecordException);
+
+	dtn::data::AggregateStatusReportBlock decoded;
+	decoded.read(payload);
+
+	std::list<dtn::data::StatusReportBlock> reports;
+	decoded.expand(reports);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)10, reports.size());
+
+	const dtn::data::StatusReportBlock &first = reports.front();
+	CPPUNIT_ASSERT_EQUAL((char)dtn::data::StatusReportBlock::DELIVERY_OF_BUNDLE, first.status);
+	CPPUNIT_ASSERT(first.timeof_delivery.getTimestamp() == report.timeofreport.getTimestamp());
+	CPPUNIT_ASSERT(first.bundleid == createID("dtn://source/app", 500, 10));
+}
+
+void TestAggregateRecords::custodySignalTest(void)
+{
+	dtn::data::AggregateCustodySignalBlock signal;
+	signal.custody_accepted = true;
+	signal.timeofsignal.set();
+
+	for (size_t i = 0; i < 5; ++i) signal.bundles.add(createID("dtn://source/app", 500, i));
+
+	dtn::data::Bundle b;
+	dtn::data::PayloadBlock &payload = b.push_back<dtn::data::PayloadBlock>();
+	signal.write(payload);
+
+	// the record type must not collide with the aggregate custody signal (ACS) of type 4
+	CPPUNIT_ASSERT_EQUAL(15, getRecordType(payload));
+
+	// a single custody signal must not accept the aggregate
+	dtn::data::CustodySignalBlock single;
+	CPPUNIT_ASSERT_THROW(single.read(payload), dtn::data::AdministrativeBlock::WrongRecordException);
+
+	dtn::data::AggregateCustodySignalBlock decoded;
+	decoded.read(payload);
+
+	CPPUNIT_ASSERT(decoded.custody_accepted);
+
+	std::list<dtn::data::CustodySignalBlock> signals;
+	decoded.expand(signals);
+
+	CPPUNIT_ASSERT_EQUAL((size_t)5, signals.size());
+	CPPUNIT_ASSERT(signals.back().custody_accepted);
+	CPPUNIT_ASSERT(signals.back().bundleid == createID("dtn://source/app", 500, 4));
+}
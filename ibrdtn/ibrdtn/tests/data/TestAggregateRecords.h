@@ -0,0 +1,48 @@
+/*
+ * TestAggregateRecords.h
+ *
+ * Copyright (C) 2014 IBR, TU Braunschweig
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#ifndef TESTAGGREGATERECORDS_H_
+#define TESTAGGREGATERECORDS_H_
+
+class TestAggregateRecords : public CPPUNIT_NS :: TestFixture
+{
+	CPPUNIT_TEST_SUITE (TestAggregateRecords);
+	CPPUNIT_TEST (rangesTest);
+	CPPUNIT_TEST (truncatedRangesTest);
+	CPPUNIT_TEST (hugeRangesTest);
+	CPPUNIT_TEST (statusReportTest);
+	CPPUNIT_TEST (custodySignalTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp (void);
+	void tearDown (void);
+
+protected:
+	void rangesTest(void);
+	void truncatedRangesTest(void);
+	void hugeRangesTest(void);
+	void statusReportTest(void);
+	void custodySignalTest(void);
+};
+
+#endif /* TESTAGGREGATERECORDS_H_ */
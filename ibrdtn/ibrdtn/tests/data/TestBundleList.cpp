@@ -98,3 +98,32 @@ void TestBundleList::orderTest(void)
 	CPPUNIT_ASSERT(ebc.counter == 2000);
 }
 
+void TestBundleList::nextExpirationTest(void)
+{
+	ExpiredBundleCounter ebc;
+	dtn::data::BundleList l(&ebc);
+
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Timestamp(0), l.getNextExpiration());
+
+	genbundles(l, 100, 10, 500);
+
+	// search for the lowest expiration time
+	dtn::data::Timestamp next = 0;
+	for (dtn::data::BundleList::const_iterator it = l.begin(); it != l.end(); ++it)
+	{
+		if ((next == 0) || ((*it).expiretime < next)) next = (*it).expiretime;
+	}
+
+	CPPUNIT_ASSERT_EQUAL(next, l.getNextExpiration());
+
+	// bundles expire after their expiration time
+	l.expire(next);
+	CPPUNIT_ASSERT_EQUAL(next, l.getNextExpiration());
+
+	l.expire(next + 1);
+	CPPUNIT_ASSERT(ebc.counter > 0);
+	CPPUNIT_ASSERT(next < l.getNextExpiration());
+
+	l.clear();
+	CPPUNIT_ASSERT_EQUAL(dtn::data::Timestamp(0), l.getNextExpiration());
+}
@@ -32,6 +32,7 @@ class TestBundleList: public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (TestBundleList);
 	CPPUNIT_TEST (orderTest);
+	CPPUNIT_TEST (nextExpirationTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -40,6 +41,7 @@ public:
 
 protected:
 	void orderTest(void);
+	void nextExpirationTest(void);
 	void containTest(void);
 
 private:
@@ -21,7 +21,9 @@
 
 #include "data/TestEID.h"
 #include <ibrdtn/data/EID.h>
+#include <ibrdtn/data/EIDTable.h>
 #include <cppunit/extensions/HelperMacros.h>
+#include <sstream>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (TestEID);
 
@@ -87,3 +89,82 @@ void TestEID::testCBHEHost(void)
 	CPPUNIT_ASSERT_EQUAL(std::string("12"), a.getHost());
 	CPPUNIT_ASSERT_EQUAL(std::string("ipn:12"), a.getNode().getString());
 }
+
+void TestEID::testInternEquals(void)
+{
+	const dtn::data::EID a("dtn://intern-node1/app");
+	const dtn::data::EID b("dtn://intern-node1/app");
+	const dtn::data::EID c("dtn://intern-node2/app");
+
+	CPPUNIT_ASSERT_EQUAL(a.hash(), b.hash());
+
+	const dtn::data::EIDHandle ha(a);
+	const dtn::data::EIDHandle hb(b);
+	const dtn::data::EIDHandle hc(c);
+
+	// equal EIDs share the same handle
+	CPPUNIT_ASSERT(ha == hb);
+	CPPUNIT_ASSERT(ha != hc);
+	CPPUNIT_ASSERT_EQUAL(ha.id(), hb.id());
+	CPPUNIT_ASSERT_EQUAL(a.hash(), ha.hash());
+	CPPUNIT_ASSERT(a == ha.get());
+
+	// interned EIDs still compare equal to plain ones
+	CPPUNIT_ASSERT(a == b);
+	CPPUNIT_ASSERT(a != c);
+	CPPUNIT_ASSERT(a == dtn::data::EID("dtn://intern-node1/app"));
+
+	// a modified EID is not interned anymore
+	dtn::data::EID d = a;
+	d.setApplication("other");
+	CPPUNIT_ASSERT(d != b);
+	CPPUNIT_ASSERT(dtn::data::EIDHandle(d) != ha);
+
+	// CBHE EIDs
+	const dtn::data::EIDHandle h1(dtn::data::EID("ipn:12.34"));
+	const dtn::data::EIDHandle h2(dtn::data::EID("ipn", "12.34"));
+	CPPUNIT_ASSERT(h1 == h2);
+
+	// the default handle is dtn:none
+	CPPUNIT_ASSERT(dtn::data::EIDHandle().get().isNone());
+}
+
+void TestEID::testInternNode(void)
+{
+	const dtn::data::EIDHandle app(dtn::data::EID("dtn://intern-node3/app"));
+	const dtn::data::EIDHandle node(dtn::data::EID("dtn://intern-node3"));
+
+	CPPUNIT_ASSERT(app.getNode() == node);
+	CPPUNIT_ASSERT(node.getNode() == node);
+
+	const dtn::data::EIDHandle cbhe(dtn::data::EID("ipn:42.1"));
+	CPPUNIT_ASSERT(cbhe.getNode() == dtn::data::EIDHandle(dtn::data::EID("ipn:42")));
+}
+
+void TestEID::testInternLookup(void)
+{
+	dtn::data::EIDHandle handle;
+	const dtn::data::EID a("dtn://intern-lookup/app");
+
+	// lookup does not intern the EID
+	const size_t size = dtn::data::EIDTable::getInstance().size();
+	CPPUNIT_ASSERT(!dtn::data::EIDHandle::lookup(a, handle));
+	CPPUNIT_ASSERT_EQUAL(size, dtn::data::EIDTable::getInstance().size());
+
+	const dtn::data::EIDHandle interned(a);
+	CPPUNIT_ASSERT(dtn::data::EIDHandle::lookup(dtn::data::EID("dtn://intern-lookup/app"), handle));
+	CPPUNIT_ASSERT(handle == interned);
+
+	// many EIDs force the table to grow
+	for (int i = 0; i < 1000; ++i)
+	{
+		std::stringstream ss;
+		ss << "dtn://intern-grow" << i << "/app";
+		const dtn::data::EIDHandle h(dtn::data::EID(ss.str()));
+		CPPUNIT_ASSERT(dtn::data::EIDHandle::lookup(dtn::data::EID(ss.str()), handle));
+		CPPUNIT_ASSERT(h == handle);
+	}
+
+	CPPUNIT_ASSERT(dtn::data::EIDHandle::lookup(a, handle));
+	CPPUNIT_ASSERT(handle == interned);
+}
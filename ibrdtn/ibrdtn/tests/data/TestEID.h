@@ -34,6 +34,9 @@ class TestEID : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST (testCBHEConstructorSchemeSsp);
 	CPPUNIT_TEST (testCBHEEquals);
 	CPPUNIT_TEST (testCBHEHost);
+	CPPUNIT_TEST (testInternEquals);
+	CPPUNIT_TEST (testInternNode);
+	CPPUNIT_TEST (testInternLookup);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -47,6 +50,9 @@ protected:
 	void testCBHEConstructorSchemeSsp(void);
 	void testCBHEEquals(void);
 	void testCBHEHost(void);
+	void testInternEquals(void);
+	void testInternNode(void);
+	void testInternLookup(void);
 
 };
 
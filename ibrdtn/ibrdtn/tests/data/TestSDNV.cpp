@@ -25,6 +25,7 @@
 #include <ibrdtn/data/Number.h>
 #include <sstream>
 #include <stdint.h>
+#include <cstring>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (TestSDNV);
 
@@ -60,7 +61,7 @@ void TestSDNV::testSerialize(void)
 		ss.clear();
 		ss >> dst;
 
-		CPPUNIT_ASSERT_EQUAL(ss.gcount(), (std::streamsize)src.getLength());
+		CPPUNIT_ASSERT_EQUAL((std::streamoff)ss.tellg(), (std::streamoff)src.getLength());
 		CPPUNIT_ASSERT_EQUAL(src.get<size_t>(), dst.get<size_t>());
 	}
 }
@@ -147,3 +148,76 @@ void TestSDNV::testBitset(void)
 	dtn::data::SDNV<uint32_t> dst;
 	CPPUNIT_ASSERT_NO_THROW( ss >> dst );
 }
+
+void TestSDNV::testBuffer(void)
+{
+	const uint64_t values[] = { 0, 1, 127, 128, 700, 16383, 16384, 32896, 8388608,
+			0xffffffffULL, 0x100000000ULL, 0x7fffffffffffffffULL, 0xffffffffffffffffULL };
+
+	for (size_t i = 0; i < (sizeof(values) / sizeof(uint64_t)); ++i)
+	{
+		const dtn::data::SDNV<uint64_t> src(values[i]);
+		dtn::data::SDNV<uint64_t> dst;
+
+		// buffer encoding is equal to the stream encoding
+		std::stringstream ss;
+		ss << src;
+		const std::string stream_data = ss.str();
+
+		char data[dtn::data::SDNV<uint64_t>::MAX_LENGTH + 8];
+		const size_t len = src.encode(data, sizeof(data));
+
+		CPPUNIT_ASSERT_EQUAL(src.getLength(), len);
+		CPPUNIT_ASSERT_EQUAL(stream_data, std::string(data, len));
+
+		// too small buffers are not touched
+		if (len > 1) CPPUNIT_ASSERT_EQUAL((size_t)0, src.encode(data, len - 1));
+
+		// decode with trailing data behind the value
+		::memset(data + len, 0xff, 8);
+		CPPUNIT_ASSERT_EQUAL(len, dst.decode(data, sizeof(data)));
+		CPPUNIT_ASSERT_EQUAL(src, dst);
+
+		// incomplete values are not decoded
+		CPPUNIT_ASSERT_EQUAL((size_t)0, dst.decode(data, len - 1));
+	}
+}
+
+void TestSDNV::testBufferOutOfRange(void)
+{
+	char data[16];
+	::memset(data, 0xff, sizeof(data));
+
+	// no last octet within the maximum length
+	dtn::data::Number number;
+	CPPUNIT_ASSERT_THROW(number.decode(data, sizeof(data)), dtn::data::ValueOutOfRangeException);
+
+	// a 64-bit value does not fit into a 32-bit SDNV
+	dtn::data::SDNV<uint64_t> src(static_cast<uint64_t>(-1));
+	src.encode(data, sizeof(data));
+
+	dtn::data::SDNV<uint32_t> dst;
+	CPPUNIT_ASSERT_THROW(dst.decode(data, sizeof(data)), dtn::data::ValueOutOfRangeException);
+
+	// ten octets are only valid for values with the highest bit set
+	data[0] = static_cast<char>(0x82);
+	CPPUNIT_ASSERT_THROW(number.decode(data, sizeof(data)), dtn::data::ValueOutOfRangeException);
+}
+
+void TestSDNV::testStreamEnd(void)
+{
+	// a truncated value marks the stream as failed
+	std::stringstream ss;
+	ss.put(static_cast<char>(0x81));
+
+	dtn::data::Number number;
+	CPPUNIT_ASSERT_THROW(ss >> number, dtn::data::ValueOutOfRangeException);
+	CPPUNIT_ASSERT(ss.eof());
+
+	// reading on a failed stream does not consume data
+	std::stringstream ss2;
+	ss2.put(0x01);
+	ss2.setstate(std::ios::failbit);
+	ss2 >> number;
+	CPPUNIT_ASSERT_EQUAL((size_t)0, number.get<size_t>());
+}
@@ -35,6 +35,9 @@ class TestSDNV : public CPPUNIT_NS :: TestFixture {
 	CPPUNIT_TEST (testOutOfRange);
 	CPPUNIT_TEST (testBitset);
 	CPPUNIT_TEST (testTrim);
+	CPPUNIT_TEST (testBuffer);
+	CPPUNIT_TEST (testBufferOutOfRange);
+	CPPUNIT_TEST (testStreamEnd);
 	CPPUNIT_TEST_SUITE_END ();
 
 	static void hexdump(char c);
@@ -51,6 +54,9 @@ public:
 	void testMax32(void);
 	void testBitset(void);
 	void testTrim(void);
+	void testBuffer(void);
+	void testBufferOutOfRange(void);
+	void testStreamEnd(void);
 };
 
 #endif /* TESTSDNV_H_ */
@@ -30,6 +30,8 @@
 #include <ibrdtn/data/AgeBlock.h>
 #include <ibrdtn/data/ScopeControlHopLimitBlock.h>
 #include <ibrdtn/data/BundleBuilder.h>
+#include <ibrdtn/data/MetaBundle.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include <iostream>
 #include <sstream>
 
@@ -400,3 +402,97 @@ void TestSerializer::serializer_outin_structure(void)
 	CPPUNIT_ASSERT_NO_THROW( b2.find<dtn::data::AgeBlock>() );
 	CPPUNIT_ASSERT_NO_THROW( b2.find<dtn::data::ScopeControlHopLimitBlock>() );
 }
+
+void TestSerializer::serializer_primaryblock_truncated(void)
+{
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node1/app1");
+	b.destination = dtn::data::EID("dtn://node2/app2");
+	b.lifetime = 3600;
+
+	dtn::data::Dictionary dict;
+	dict.add(b.destination);
+	dict.add(b.source);
+	dict.add(b.reportto);
+	dict.add(b.custodian);
+
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss, dict) << (dtn::data::PrimaryBlock&)b;
+	const std::string data = ss.str();
+
+	// the complete primary block is readable
+	{
+		std::stringstream in(data);
+		dtn::data::MetaBundle meta;
+		CPPUNIT_ASSERT_NO_THROW( dtn::data::DefaultDeserializer(in) >> meta );
+		CPPUNIT_ASSERT( b.source == meta.source );
+		CPPUNIT_ASSERT( b.destination == meta.destination );
+		CPPUNIT_ASSERT_EQUAL( b.lifetime, meta.lifetime );
+	}
+
+	// a missing byte is detected
+	{
+		std::stringstream in(data.substr(0, data.length() - 1));
+		dtn::data::MetaBundle meta;
+		CPPUNIT_ASSERT_THROW( dtn::data::DefaultDeserializer(in) >> meta, dtn::InvalidDataException );
+	}
+}
+
+void TestSerializer::serializer_parse_rate(void)
+{
+	const size_t rounds = 20000;
+
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://node1/app1");
+	b.destination = dtn::data::EID("dtn://node2/app2");
+	b.reportto = dtn::data::EID("dtn://node1/reports");
+	b.lifetime = 3600;
+	b.timestamp = 12345678;
+	b.sequencenumber = 1234;
+
+	b.push_front<dtn::data::AgeBlock>();
+	b.push_front<dtn::data::ScopeControlHopLimitBlock>();
+
+	ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+	{
+		ibrcommon::BLOB::iostream stream = ref.iostream();
+		(*stream) << "hello world" << std::flush;
+	}
+	b.push_back(ref);
+
+	std::stringstream ss;
+	dtn::data::DefaultSerializer(ss) << b;
+	const std::string data = ss.str();
+
+	// parse the primary block only
+	ibrcommon::TimeMeasurement tm;
+	tm.start();
+
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		std::stringstream in(data);
+		dtn::data::MetaBundle meta;
+		dtn::data::DefaultDeserializer(in) >> meta;
+	}
+
+	tm.stop();
+	const double primary_rate = static_cast<double>(rounds) * 1000.0 / (tm.getMilliseconds() + 1.0);
+
+	// parse the complete bundle
+	tm.start();
+
+	for (size_t i = 0; i < rounds; ++i)
+	{
+		std::stringstream in(data);
+		dtn::data::Bundle b2;
+		dtn::data::DefaultDeserializer(in) >> b2;
+		CPPUNIT_ASSERT_EQUAL(b.size(), b2.size());
+	}
+
+	tm.stop();
+	const double bundle_rate = static_cast<double>(rounds) * 1000.0 / (tm.getMilliseconds() + 1.0);
+
+	std::cout << std::endl << "parse rate (" << data.length() << " bytes): "
+			<< static_cast<size_t>(primary_rate) << " primary blocks/s, "
+			<< static_cast<size_t>(bundle_rate) << " bundles/s" << std::endl;
+}
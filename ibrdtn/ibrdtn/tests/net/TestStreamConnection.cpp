@@ -27,10 +27,20 @@
 #include <ibrdtn/streams/StreamConnection.h>
 #include <ibrcommon/thread/Mutex.h>
 #include <ibrcommon/thread/MutexLock.h>
+#include <ibrcommon/thread/Conditional.h>
 #include <ibrcommon/thread/Thread.h>
+#include <ibrcommon/TimeMeasurement.h>
 #include <ibrdtn/data/Serializer.h>
 #include <ibrcommon/data/BLOB.h>
 
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
 CPPUNIT_TEST_SUITE_REGISTRATION (TestStreamConnection);
 
 void TestStreamConnection::setUp()
@@ -257,3 +267,487 @@ void TestStreamConnection::connectionUpDown()
 	CPPUNIT_ASSERT_EQUAL((unsigned int) 2000, srv.recv_bundles);
 }
 
+
+class ExpressPeer : public ibrcommon::JoinableThread, public dtn::streams::StreamConnection::Callback
+{
+private:
+	ibrcommon::socketstream _conn;
+	const dtn::data::EID _eid;
+
+public:
+	dtn::streams::StreamConnection stream;
+
+	ibrcommon::Conditional cond;
+	bool up;
+	bool acked;
+	unsigned int bulk_bundles;
+	unsigned int express_bundles;
+	unsigned int express_forwarded;
+	unsigned int express_refused;
+	bool overtaken;
+	bool refuse;
+
+	ExpressPeer(int fd, const dtn::data::EID &eid)
+	: _conn(new ibrcommon::filesocket(fd)), _eid(eid), stream(*this, _conn), up(false), acked(false),
+	  bulk_bundles(0), express_bundles(0), express_forwarded(0), express_refused(0), overtaken(false), refuse(false)
+	{ }
+
+	virtual ~ExpressPeer() {
+		join();
+	};
+
+	void __cancellation() throw () {
+		_conn.close();
+	}
+
+	void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () {};
+	void eventTimeout() throw () {};
+	void eventError() throw () {};
+	void eventBundleRefused() throw () {};
+	void eventBundleForwarded() throw () {};
+	void eventBundleAck(const dtn::data::Length&) throw ()
+	{
+		ibrcommon::MutexLock l(cond);
+		acked = true;
+		cond.signal(true);
+	};
+
+	void eventExpressBundleForwarded() throw ()
+	{
+		ibrcommon::MutexLock l(cond);
+		express_forwarded++;
+		cond.signal(true);
+	};
+
+	void eventExpressBundleRefused() throw ()
+	{
+		ibrcommon::MutexLock l(cond);
+		express_refused++;
+		cond.signal(true);
+	};
+
+	bool eventExpressBundleReceived(std::istream &s) throw ()
+	{
+		dtn::data::Bundle b;
+		dtn::data::DefaultDeserializer(s) >> b;
+
+		ibrcommon::MutexLock l(cond);
+		express_bundles++;
+
+		// the bulk transfer is still in progress
+		if (bulk_bundles == 0) overtaken = true;
+		cond.signal(true);
+
+		return !refuse;
+	};
+
+	void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () {};
+	void eventConnectionDown() throw () {};
+
+	void send(std::ostream &s, size_t size)
+	{
+		dtn::data::Bundle b;
+		ibrcommon::BLOB::Reference ref = ibrcommon::BLOB::create();
+
+		{
+			ibrcommon::BLOB::iostream io = ref.iostream();
+			const std::string chunk(4096, 'x');
+
+			while (size > chunk.length()) {
+				(*io) << chunk;
+				size -= chunk.length();
+			}
+			(*io) << chunk.substr(0, size);
+		}
+
+		b.source = _eid;
+		b.destination = dtn::data::EID("dtn:peer");
+		b.push_back(ref);
+		dtn::data::DefaultSerializer(s) << b;
+		s << std::flush;
+	}
+
+protected:
+	void run() throw ()
+	{
+		try {
+			stream.handshake(_eid, 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS | dtn::streams::StreamContactHeader::REQUEST_NEGATIVE_ACKNOWLEDGMENTS | dtn::streams::StreamContactHeader::REQUEST_INTERLEAVING);
+
+			{
+				ibrcommon::MutexLock l(cond);
+				up = true;
+				cond.signal(true);
+			}
+
+			while (_conn.good())
+			{
+				dtn::data::Bundle b;
+				dtn::data::DefaultDeserializer(stream) >> b;
+
+				ibrcommon::MutexLock l(cond);
+				bulk_bundles++;
+				cond.signal(true);
+			}
+		} catch (const std::exception&) {
+			// connection closed
+		}
+	}
+};
+
+void TestStreamConnection::expressLatency()
+{
+	class bulksender : public ibrcommon::JoinableThread
+	{
+	private:
+		ExpressPeer &_peer;
+		const size_t _size;
+
+	public:
+		bulksender(ExpressPeer &p, size_t size) : _peer(p), _size(size) { }
+
+		virtual ~bulksender() {
+			join();
+		};
+
+		void __cancellation() throw () { };
+
+	protected:
+		void run() throw ()
+		{
+			try {
+				_peer.send(_peer.stream, _size);
+			} catch (const std::exception&) { };
+		}
+	};
+
+	// the peers close their ends while acknowledgements may still be written
+	::signal(SIGPIPE, SIG_IGN);
+
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ExpressPeer sender(fds[0], dtn::data::EID("dtn:sender"));
+	ExpressPeer receiver(fds[1], dtn::data::EID("dtn:receiver"));
+
+	sender.start();
+	receiver.start();
+
+	// wait until both peers are connected
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (!sender.up) sender.cond.wait(5000);
+	}
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (!receiver.up) receiver.cond.wait(5000);
+	}
+
+	CPPUNIT_ASSERT(sender.stream.isExpressSupported());
+	CPPUNIT_ASSERT(receiver.stream.isExpressSupported());
+
+	ibrcommon::TimeMeasurement bulk_tm, express_tm;
+
+	// start a bulk transfer of 32 MB
+	bulk_tm.start();
+	bulksender bulk(sender, 32 * 1024 * 1024);
+	bulk.start();
+
+	// wait until the first segment of the bulk transfer is acknowledged
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (!sender.acked) sender.cond.wait(5000);
+	}
+
+	// send a small bundle on the express lane
+	express_tm.start();
+	sender.send(sender.stream.express(), 128);
+
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (receiver.express_bundles == 0) receiver.cond.wait(5000);
+	}
+	express_tm.stop();
+
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (receiver.bulk_bundles == 0) receiver.cond.wait(30000);
+	}
+	bulk_tm.stop();
+
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (sender.express_forwarded == 0) sender.cond.wait(5000);
+	}
+
+	std::cout << std::endl << "small bundle latency: " << express_tm.getMilliseconds() << " ms (express lane), "
+			<< bulk_tm.getMilliseconds() << " ms (bulk transfer of 32 MB)" << std::endl;
+
+	// the small bundle has overtaken the large one
+	CPPUNIT_ASSERT(receiver.overtaken);
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 1, receiver.bulk_bundles);
+
+	bulk.join();
+
+	sender.stop();
+	receiver.stop();
+}
+
+void TestStreamConnection::expressRefused()
+{
+	// the peers close their ends while acknowledgements may still be written
+	::signal(SIGPIPE, SIG_IGN);
+
+	int fds[2];
+	CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+	ExpressPeer sender(fds[0], dtn::data::EID("dtn:sender"));
+	ExpressPeer receiver(fds[1], dtn::data::EID("dtn:receiver"));
+
+	sender.start();
+	receiver.start();
+
+	// wait until both peers are connected
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (!sender.up) sender.cond.wait(5000);
+	}
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (!receiver.up) receiver.cond.wait(5000);
+	}
+
+	// the first bundle is accepted
+	sender.send(sender.stream.express(), 128);
+
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (sender.express_forwarded == 0) sender.cond.wait(5000);
+	}
+
+	// the second bundle is refused by the receiver
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		receiver.refuse = true;
+	}
+
+	sender.send(sender.stream.express(), 128);
+
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (sender.express_refused == 0) sender.cond.wait(5000);
+	}
+
+	// the refused bundle is not reported as forwarded
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 2, receiver.express_bundles);
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 1, sender.express_forwarded);
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 1, sender.express_refused);
+
+	// a refused bundle does not block the lane
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		receiver.refuse = false;
+	}
+
+	sender.send(sender.stream.express(), 128);
+
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (sender.express_forwarded < 2) sender.cond.wait(5000);
+	}
+
+	CPPUNIT_ASSERT_EQUAL((unsigned int) 1, sender.express_refused);
+
+	sender.stop();
+	receiver.stop();
+}
+
+void TestStreamConnection::transferData()
+{
+	// transfer sizes around the segment and buffer boundaries
+	static const size_t sizes[] = { 1, 100, 4095, 4096, 4097, 65536, 70001, 1048579 };
+	static const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+
+	class peer : public ibrcommon::JoinableThread, public dtn::streams::StreamConnection::Callback
+	{
+	private:
+		ibrcommon::socketstream _conn;
+		const dtn::data::EID _eid;
+		const bool _receiver;
+
+	public:
+		dtn::streams::StreamConnection stream;
+
+		ibrcommon::Conditional cond;
+		bool up;
+		size_t transfers;
+		size_t mismatches;
+
+		peer(ibrcommon::clientsocket *sock, const dtn::data::EID &eid, bool receiver)
+		: _conn(sock), _eid(eid), _receiver(receiver), stream(*this, _conn), up(false), transfers(0), mismatches(0)
+		{ }
+
+		virtual ~peer() {
+			join();
+		};
+
+		void __cancellation() throw () {
+			_conn.close();
+		}
+
+		static char pattern(size_t transfer, size_t pos)
+		{
+			return static_cast<char>((pos * 7 + transfer) % 251);
+		}
+
+		void eventShutdown(dtn::streams::StreamConnection::ConnectionShutdownCases) throw () {};
+		void eventTimeout() throw () {};
+		void eventError() throw () {};
+		void eventBundleRefused() throw () {};
+		void eventBundleForwarded() throw () {};
+		void eventBundleAck(const dtn::data::Length&) throw () {};
+		void eventConnectionUp(const dtn::streams::StreamContactHeader&) throw () {};
+		void eventConnectionDown() throw () {};
+
+	protected:
+		void run() throw ()
+		{
+			try {
+				stream.handshake(_eid, 0, dtn::streams::StreamContactHeader::REQUEST_ACKNOWLEDGMENTS);
+
+				{
+					ibrcommon::MutexLock l(cond);
+					up = true;
+					cond.signal(true);
+				}
+
+				if (!_receiver)
+				{
+					// process the acknowledgements until the connection is closed
+					char c;
+					while (stream.good()) stream.read(&c, 1);
+					return;
+				}
+
+				// read with small and large chunks to use the buffered and the direct path
+				static const size_t chunks[] = { 1, 17, 4096, 70000 };
+				std::vector<char> buf(70000);
+
+				for (size_t t = 0; t < count; ++t)
+				{
+					size_t pos = 0;
+					size_t c = t;
+
+					while (pos < sizes[t])
+					{
+						size_t len = chunks[c++ % 4];
+						if (len > sizes[t] - pos) len = sizes[t] - pos;
+
+						stream.read(&buf[0], len);
+						if (!stream.good()) return;
+
+						for (size_t i = 0; i < len; ++i)
+						{
+							if (buf[i] != pattern(t, pos + i)) mismatches++;
+						}
+
+						pos += len;
+					}
+
+					ibrcommon::MutexLock l(cond);
+					transfers++;
+					cond.signal(true);
+				}
+
+				// acknowledge the last segment and wait for the shutdown
+				char c;
+				while (stream.good()) stream.read(&c, 1);
+			} catch (const std::exception&) {
+				// connection closed
+			}
+		}
+	};
+
+	// the peers close their ends while acknowledgements may still be written
+	::signal(SIGPIPE, SIG_IGN);
+
+	ibrcommon::clientsocket *client = NULL;
+	ibrcommon::clientsocket *server = NULL;
+
+	try {
+		// connect both peers through the loopback interface on an ephemeral port
+		ibrcommon::tcpserversocket srv(ibrcommon::vaddress("127.0.0.1", 0));
+		srv.up();
+
+		struct sockaddr_in addr;
+		socklen_t len = sizeof(addr);
+		::memset(&addr, 0, sizeof(addr));
+		if (::getsockname(srv.fd(), (struct sockaddr*)&addr, &len) == -1)
+			throw ibrcommon::socket_exception("can not get the port of the server socket");
+
+		client = new ibrcommon::tcpsocket(ibrcommon::vaddress("127.0.0.1", ntohs(addr.sin_port)));
+		client->up();
+
+		ibrcommon::vaddress peeraddr;
+		server = srv.accept(peeraddr);
+	} catch (const ibrcommon::socket_exception&) {
+		delete client;
+
+		// fall back to a local socket pair if TCP is not available
+		int fds[2];
+		CPPUNIT_ASSERT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+		client = new ibrcommon::filesocket(fds[0]);
+		server = new ibrcommon::filesocket(fds[1]);
+	}
+
+	peer sender(client, dtn::data::EID("dtn:sender"), false);
+	peer receiver(server, dtn::data::EID("dtn:receiver"), true);
+
+	sender.start();
+	receiver.start();
+
+	// wait until both peers are connected
+	{
+		ibrcommon::MutexLock ls(sender.cond);
+		while (!sender.up) sender.cond.wait(5000);
+	}
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (!receiver.up) receiver.cond.wait(5000);
+	}
+
+	for (size_t t = 0; t < count; ++t)
+	{
+		std::vector<char> data(sizes[t]);
+		for (size_t i = 0; i < data.size(); ++i) data[i] = peer::pattern(t, i);
+
+		// write the data at once and in small pieces
+		if (t % 2 == 0)
+		{
+			sender.stream.write(&data[0], data.size());
+		}
+		else
+		{
+			for (size_t pos = 0; pos < data.size(); pos += 1000)
+			{
+				sender.stream.write(&data[pos], std::min(data.size() - pos, static_cast<size_t>(1000)));
+			}
+		}
+
+		// mark the end of the transfer
+		sender.stream << std::flush;
+	}
+
+	{
+		ibrcommon::MutexLock lr(receiver.cond);
+		while (receiver.transfers < count) receiver.cond.wait(30000);
+	}
+
+	CPPUNIT_ASSERT(sender.stream.good());
+	CPPUNIT_ASSERT_EQUAL(count, receiver.transfers);
+	CPPUNIT_ASSERT_EQUAL((size_t)0, receiver.mismatches);
+
+	sender.stream.shutdown();
+
+	sender.stop();
+	receiver.stop();
+}
@@ -29,6 +29,9 @@ class TestStreamConnection : public CPPUNIT_NS :: TestFixture
 {
 	CPPUNIT_TEST_SUITE (TestStreamConnection);
 	CPPUNIT_TEST (connectionUpDown);
+	CPPUNIT_TEST (expressLatency);
+	CPPUNIT_TEST (expressRefused);
+	CPPUNIT_TEST (transferData);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -37,6 +40,9 @@ public:
 
 protected:
 	void connectionUpDown(void);
+	void expressLatency(void);
+	void expressRefused(void);
+	void transferData(void);
 };
 
 
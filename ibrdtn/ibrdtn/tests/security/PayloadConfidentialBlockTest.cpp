@@ -29,6 +29,7 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 #include <sstream>
+#include <algorithm>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (PayloadConfidentialBlockTest);
 
@@ -176,6 +177,118 @@ void PayloadConfidentialBlockTest::decryptTest(void)
 	CPPUNIT_ASSERT_EQUAL((size_t)1, recv_b.size());
 }
 
+void PayloadConfidentialBlockTest::missingKeyTest(void)
+{
+	dtn::security::SecurityKey pubkey;
+	pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	pubkey.file = ibrcommon::File("test-key.pem");
+	pubkey.reference = dtn::data::EID("dtn://test");
+
+	if (!pubkey.file.exists())
+	{
+		throw ibrcommon::Exception("test-key.pem file not exists!");
+	}
+
+	dtn::data::Bundle b;
+	b.source = dtn::data::EID("dtn://test");
+	b.destination = pubkey.reference;
+
+	// add payload block
+	dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+
+	// write some payload
+	(*p.getBLOB().iostream()) << _testdata << std::flush;
+
+	// a session key which could not be encrypted for the destination
+	dtn::security::PayloadConfidentialBlock::SessionKey session(pubkey);
+	session.wrapped.clear();
+
+	CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, b.source, session), dtn::security::EncryptException);
+
+	// the bundle is left untouched
+	CPPUNIT_ASSERT_EQUAL((size_t)1, b.size());
+
+	ibrcommon::BLOB::iostream stream = p.getBLOB().iostream();
+	std::stringstream ss; ss << (*stream).rdbuf();
+	CPPUNIT_ASSERT_EQUAL(_testdata, ss.str());
+}
+
+void PayloadConfidentialBlockTest::cachedKeyTest(void)
+{
+	dtn::security::SecurityKey pubkey;
+	pubkey.type = dtn::security::SecurityKey::KEY_PUBLIC;
+	pubkey.file = ibrcommon::File("test-key.pem");
+	pubkey.reference = dtn::data::EID("dtn://test");
+
+	dtn::security::SecurityKey pkey;
+	pkey.type = dtn::security::SecurityKey::KEY_PRIVATE;
+	pkey.file = ibrcommon::File("test-key.pem");
+	pkey.reference = pubkey.reference;
+
+	if (!pubkey.file.exists())
+	{
+		throw ibrcommon::Exception("test-key.pem file not exists!");
+	}
+
+	const dtn::security::PayloadConfidentialBlock::SessionKey session(pubkey);
+	dtn::security::PayloadConfidentialBlock::KeyCache cache;
+
+	// two bundles encrypted with the same session key
+	for (int i = 0; i < 2; ++i)
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << _testdata << std::flush;
+
+		dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, b.source, session);
+		CPPUNIT_ASSERT_EQUAL((size_t)2, b.size());
+
+		dtn::security::PayloadConfidentialBlock::decrypt(b, pkey, cache);
+		CPPUNIT_ASSERT_EQUAL((size_t)1, b.size());
+
+		ibrcommon::BLOB::iostream stream = p.getBLOB().iostream();
+		std::stringstream ss; ss << (*stream).rdbuf();
+		CPPUNIT_ASSERT_EQUAL(_testdata, ss.str());
+
+		// the key is decrypted once and taken from the cache afterwards
+		CPPUNIT_ASSERT_EQUAL((dtn::data::Size)1, cache.size());
+	}
+
+	unsigned char key[ibrcommon::AES128Stream::key_size_in_bytes];
+	CPPUNIT_ASSERT(cache.get(session.wrapped, key));
+	CPPUNIT_ASSERT(std::equal(session.key, session.key + ibrcommon::AES128Stream::key_size_in_bytes, key));
+
+	// a cached key is used instead of the RSA decryption
+	{
+		dtn::data::Bundle b;
+		b.source = dtn::data::EID("dtn://test");
+		b.destination = pubkey.reference;
+
+		dtn::data::PayloadBlock &p = b.push_back<dtn::data::PayloadBlock>();
+		(*p.getBLOB().iostream()) << _testdata << std::flush;
+
+		dtn::security::PayloadConfidentialBlock::encrypt(b, pubkey, b.source, session);
+
+		dtn::security::PayloadConfidentialBlock::KeyCache wrong;
+		std::fill(key, key + ibrcommon::AES128Stream::key_size_in_bytes, 0);
+		wrong.put(session.wrapped, key);
+
+		CPPUNIT_ASSERT_THROW(dtn::security::PayloadConfidentialBlock::decrypt(b, pkey, wrong), ibrcommon::Exception);
+	}
+
+	// the cache is bounded
+	dtn::security::PayloadConfidentialBlock::KeyCache small(2);
+	small.put("a", key);
+	small.put("b", key);
+	small.put("c", key);
+	CPPUNIT_ASSERT_EQUAL((dtn::data::Size)2, small.size());
+	CPPUNIT_ASSERT(!small.get("a", key));
+	CPPUNIT_ASSERT(small.get("c", key));
+}
+
 void PayloadConfidentialBlockTest::encrypt(const dtn::security::SecurityKey &pubkey, dtn::data::Bundle &b)
 {
 	/**
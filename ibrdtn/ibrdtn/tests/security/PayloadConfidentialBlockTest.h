@@ -34,6 +34,8 @@ class PayloadConfidentialBlockTest : public CPPUNIT_NS :: TestFixture
 	CPPUNIT_TEST_SUITE (PayloadConfidentialBlockTest);
 	CPPUNIT_TEST (encryptTest);
 	CPPUNIT_TEST (decryptTest);
+	CPPUNIT_TEST (missingKeyTest);
+	CPPUNIT_TEST (cachedKeyTest);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -43,6 +45,8 @@ public:
 protected:
 	void encryptTest(void);
 	void decryptTest(void);
+	void missingKeyTest(void);
+	void cachedKeyTest(void);
 
 private:
 	void encrypt(const dtn::security::SecurityKey &pubkey, dtn::data::Bundle &b);
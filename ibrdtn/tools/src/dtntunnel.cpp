@@ -31,6 +31,7 @@
 
 // Base for send and receive bundle to/from the IBR-DTN daemon.
 #include "ibrdtn/api/Client.h"
+#include <ibrdtn/data/SDNV.h>
 
 //  TCP client implemented as a stream.
 #include <ibrcommon/net/socket.h>
@@ -39,6 +40,7 @@
 #include "ibrcommon/thread/Mutex.h"
 #include "ibrcommon/thread/MutexLock.h"
 #include <ibrcommon/thread/SignalHandler.h>
+#include <ibrcommon/data/File.h>
 #include <ibrcommon/Logger.h>
 
 // Basic functionalities for streaming.
@@ -46,6 +48,7 @@
 
 // A queue for bundles.
 #include <queue>
+#include <vector>
 
 #include <unistd.h>
 #include <fcntl.h>
@@ -54,6 +57,8 @@
 #include <string.h>
 #include <errno.h>
 
+#include <poll.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <linux/if.h>
@@ -106,42 +111,63 @@ int tun_alloc(char *dev, short int flags) {
   return fd;
 }
 
+int64_t get_monotonic_ms() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000 + ts.tv_nsec / 1000000;
+}
+
 size_t throughput_data_up[5] = { 0, 0, 0, 0, 0 };
 size_t throughput_data_down[5] = { 0, 0, 0, 0, 0 };
+size_t throughput_packets_up[5] = { 0, 0, 0, 0, 0 };
+size_t throughput_packets_down[5] = { 0, 0, 0, 0, 0 };
 int throughput_pos = 0;
 
 void add_throughput_data(ssize_t amount, int updown) {
 	if (updown == 0) {
 		throughput_data_down[throughput_pos] += amount;
+		throughput_packets_down[throughput_pos]++;
 	} else {
 		throughput_data_up[throughput_pos] += amount;
+		throughput_packets_up[throughput_pos]++;
 	}
 }
 
 void timer_display_throughput(int) {
 	float throughput_sum_up = 0;
 	float throughput_sum_down = 0;
+	size_t packets_sum_up = 0;
+	size_t packets_sum_down = 0;
 
 	for (int i = 0; i < 5; ++i) {
 		throughput_sum_up += static_cast<float>(throughput_data_up[i]);
 		throughput_sum_down += static_cast<float>(throughput_data_down[i]);
+		packets_sum_up += throughput_packets_up[i];
+		packets_sum_down += throughput_packets_down[i];
 	}
 
-	std::cout << "  up: " << setiosflags(ios::right) << setw(12) << setiosflags(ios::fixed) << setprecision(2) << (throughput_sum_up/1024) << " kB/s ";
-	std::cout << "  down: " << setiosflags(ios::right) << setw(12) << setiosflags(ios::fixed) << setprecision(2) << (throughput_sum_down/1024) << " kB/s\r" << std::flush;
+	std::cout << "  up: " << setiosflags(ios::right) << setw(12) << setiosflags(ios::fixed) << setprecision(2) << (throughput_sum_up/1024) << " kB/s " << setw(8) << packets_sum_up << " pkt/s ";
+	std::cout << "  down: " << setiosflags(ios::right) << setw(12) << setiosflags(ios::fixed) << setprecision(2) << (throughput_sum_down/1024) << " kB/s " << setw(8) << packets_sum_down << " pkt/s\r" << std::flush;
 
 	throughput_pos++;
 	if (throughput_pos > 4) throughput_pos = 0;
 
 	throughput_data_up[throughput_pos] = 0;
 	throughput_data_down[throughput_pos] = 0;
+	throughput_packets_up[throughput_pos] = 0;
+	throughput_packets_down[throughput_pos] = 0;
 }
 
 class TUN2BundleGateway : public dtn::api::Client
 {
 	public:
+		static const int AGGREGATION_MARKER = 0xff;
+
+		// maximum size of a packet read from or written to the tun device
+		static const size_t MAX_PACKET_SIZE = 65536;
+
 		TUN2BundleGateway(const std::string &app, ibrcommon::socketstream &stream, const std::string &ptp_dev)
-		: dtn::api::Client(app, stream), _stream(stream), _fd(-1)
+		: dtn::api::Client(app, stream), _stream(stream), _fd(-1), _window(0), _max_size(65536), _lowlatency(false)
 		{
 			char tun_name[IFNAMSIZ];
 
@@ -177,23 +203,71 @@ class TUN2BundleGateway : public dtn::api::Client
 			_fd = -1;
 		}
 
+		/**
+		 * Aggregate all packets read within the given time window into
+		 * one bundle, up to the given payload size. A window of zero
+		 * sends one bundle per packet.
+		 */
+		void setAggregation(unsigned int window_ms, size_t max_size)
+		{
+			_window = window_ms;
+			_max_size = max_size;
+		}
+
+		/**
+		 * Send packets with expedited priority
+		 */
+		void setLowLatency(bool val)
+		{
+			_lowlatency = val;
+		}
+
 		void process(const dtn::data::EID &endpoint, unsigned int lifetime = 60) {
 			if (_fd == -1) throw ibrcommon::Exception("Tunnel closed.");
 
-			char data[65536];
-			ssize_t ret = ::read(_fd, data, sizeof(data));
+			// read the first packet, unless one is left from the previous bundle
+			if (_pending.empty() && !read_packet(-1)) return;
 
-			if (ret == -1) {
-				throw ibrcommon::Exception("Error: failed to read from tun device");
+			// create a blob
+			ibrcommon::BLOB::Reference blob = ibrcommon::BLOB::create();
+
+			if (_window == 0)
+			{
+				// add the data
+				blob.iostream()->write(&_pending[0], _pending.size());
+				_pending.clear();
 			}
+			else
+			{
+				ibrcommon::BLOB::iostream io = blob.iostream();
 
-			add_throughput_data(ret, 1);
+				// aggregated bundles start with a marker byte, packets read from
+				// the tun device start with the flags of the packet information
+				io->put(static_cast<char>(AGGREGATION_MARKER));
+				size_t length = 1;
 
-			// create a blob
-			ibrcommon::BLOB::Reference blob = ibrcommon::BLOB::create();
+				const int64_t deadline = get_monotonic_ms() + _window;
+
+				while (!_pending.empty())
+				{
+					const dtn::data::Number len(_pending.size());
+					const size_t framed = len.getLength() + _pending.size();
 
-			// add the data
-			blob.iostream()->write(data, ret);
+					// leave the packet for the next bundle if this one is full
+					if ((length > 1) && (length + framed > _max_size)) break;
+
+					(*io) << len;
+					io->write(&_pending[0], _pending.size());
+					length += framed;
+					_pending.clear();
+
+					if (length >= _max_size) break;
+
+					// wait for more packets until the window is closed
+					const int timeout = static_cast<int>(deadline - get_monotonic_ms());
+					if ((timeout <= 0) || !read_packet(timeout)) break;
+				}
+			}
 
 			// create a new bundle
 			dtn::data::Bundle b;
@@ -202,6 +276,13 @@ class TUN2BundleGateway : public dtn::api::Client
 			b.push_back(blob);
 			b.lifetime = lifetime;
 
+			if (_lowlatency)
+			{
+				// set expedited priority
+				b.set(dtn::data::PrimaryBlock::PRIORITY_BIT1, false);
+				b.set(dtn::data::PrimaryBlock::PRIORITY_BIT2, true);
+			}
+
 			// transmit the packet
 			(*this) << b;
 			flush();
@@ -220,6 +301,56 @@ class TUN2BundleGateway : public dtn::api::Client
 
 		std::string tun_device;
 
+		// aggregation window in milliseconds and maximum payload size
+		unsigned int _window;
+		size_t _max_size;
+
+		bool _lowlatency;
+
+		// the last packet read from the tun device
+		std::vector<char> _pending;
+
+		/**
+		 * Read the next packet from the tun device into the pending buffer.
+		 * @param timeout Time to wait for a packet in milliseconds or -1 to block
+		 * @return False, if no packet has been read within the timeout
+		 */
+		bool read_packet(int timeout)
+		{
+			if (timeout >= 0)
+			{
+				struct pollfd pfd;
+				pfd.fd = _fd;
+				pfd.events = POLLIN;
+				pfd.revents = 0;
+
+				if (::poll(&pfd, 1, timeout) <= 0) return false;
+			}
+
+			_pending.resize(MAX_PACKET_SIZE);
+			ssize_t ret = ::read(_fd, &_pending[0], _pending.size());
+
+			if (ret == -1) {
+				_pending.clear();
+				throw ibrcommon::Exception("Error: failed to read from tun device");
+			}
+
+			_pending.resize(ret);
+			add_throughput_data(ret, 1);
+
+			return (ret > 0);
+		}
+
+		void write_packet(const char *data, size_t len)
+		{
+			if (::write(_fd, data, len) < 0)
+			{
+				IBRCOMMON_LOGGER_TAG("Core", error) << "Error while writing" << IBRCOMMON_LOGGER_ENDL;
+			}
+
+			add_throughput_data(len, 0);
+		}
+
 		/**
 		 * In this API bundles are received asynchronous. To receive bundles it is necessary
 		 * to overload the Client::received()-method. This will be call on a incoming bundles
@@ -229,16 +360,49 @@ class TUN2BundleGateway : public dtn::api::Client
 		{
 			ibrcommon::BLOB::Reference ref = b.find<dtn::data::PayloadBlock>().getBLOB();
 			ibrcommon::BLOB::iostream stream = ref.iostream();
-			char data[65536];
-			stream->read(data, sizeof(data));
-			size_t ret = stream->gcount();
+			std::vector<char> data(MAX_PACKET_SIZE);
 
-			if (::write(_fd, data, ret) < 0)
+			if (stream->peek() != AGGREGATION_MARKER)
 			{
-				IBRCOMMON_LOGGER_TAG("Core", error) << "Error while writing" << IBRCOMMON_LOGGER_ENDL;
+				// one packet per bundle
+				stream->read(&data[0], data.size());
+				write_packet(&data[0], stream->gcount());
+				return;
 			}
 
-			add_throughput_data(ret, 0);
+			// skip the aggregation marker
+			stream->get();
+
+			while (stream->peek() != std::char_traits<char>::eof())
+			{
+				dtn::data::Number len;
+				(*stream) >> len;
+
+				if (stream->fail())
+				{
+					IBRCOMMON_LOGGER_TAG("Core", error) << "Truncated packet length in aggregated bundle" << IBRCOMMON_LOGGER_ENDL;
+					break;
+				}
+
+				// the length is not trusted, a packet never exceeds the tunnel MTU or the remaining payload
+				const dtn::data::Length remain = stream.size() - static_cast<dtn::data::Length>(stream->tellg());
+				if ((len > data.size()) || (len > remain))
+				{
+					IBRCOMMON_LOGGER_TAG("Core", error) << "Invalid packet length " << len.toString() << " in aggregated bundle" << IBRCOMMON_LOGGER_ENDL;
+					break;
+				}
+
+				const size_t length = len.get<size_t>();
+
+				stream->read(&data[0], length);
+				if (static_cast<size_t>(stream->gcount()) != length)
+				{
+					IBRCOMMON_LOGGER_TAG("Core", error) << "Truncated packet in aggregated bundle" << IBRCOMMON_LOGGER_ENDL;
+					break;
+				}
+
+				write_packet(&data[0], length);
+			}
 		}
 };
 
@@ -266,6 +430,10 @@ void print_help(const char *argv0)
 	std::cout << " -s <name>        Application suffix of the local endpoint (default: tunnel)" << std::endl;
 	std::cout << " -l <seconds>     Lifetime of each packet (default: 60)" << std::endl;
 	std::cout << " -t               Show throughput" << std::endl;
+	std::cout << " -a <ms>          Aggregate packets read within this time window into one bundle" << std::endl;
+	std::cout << " -m <bytes>       Maximum payload size of aggregated bundles (default: 65536)" << std::endl;
+	std::cout << " -L               Low-latency mode, send expedited bundles without delay" << std::endl;
+	std::cout << " -U <socket>      Connect to UNIX domain socket API" << std::endl;
 #ifdef HAVE_LIBDAEMON
 	std::cout << " -D               Daemonize the process" << std::endl;
 	std::cout << " -k               Stop the running daemon" << std::endl;
@@ -294,11 +462,15 @@ int main(int argc, char *argv[])
 	bool stop_daemon = false;
 	std::string pidfile;
 	bool throughput = false;
+	unsigned int window = 0;
+	size_t max_size = 65536;
+	bool lowlatency = false;
+	ibrcommon::File unixdomain;
 
 #ifdef HAVE_LIBDAEMON
-	while ((c = getopt (argc, argv, "td:s:l:hDkp:")) != -1)
+	while ((c = getopt (argc, argv, "td:s:l:a:m:LU:hDkp:")) != -1)
 #else
-	while ((c = getopt (argc, argv, "td:s:l:h")) != -1)
+	while ((c = getopt (argc, argv, "td:s:l:a:m:LU:h")) != -1)
 #endif
 	switch (c)
 	{
@@ -332,6 +504,22 @@ int main(int argc, char *argv[])
 			lifetime = atoi(optarg);
 			break;
 
+		case 'a':
+			window = atoi(optarg);
+			break;
+
+		case 'm':
+			max_size = atoi(optarg);
+			break;
+
+		case 'L':
+			lowlatency = true;
+			break;
+
+		case 'U':
+			unixdomain = ibrcommon::File(optarg);
+			break;
+
 		default:
 			print_help(argv[0]);
 			return 1;
@@ -499,17 +687,41 @@ int main(int argc, char *argv[])
 	IBRCOMMON_LOGGER_TAG("Core", info) << "IBR-DTN IP <-> Bundle Tunnel" << IBRCOMMON_LOGGER_ENDL;
 
 	// create a connection to the dtn daemon
-	ibrcommon::vaddress addr("localhost", 4550);
-	ibrcommon::socketstream conn(new ibrcommon::tcpsocket(addr));
+	ibrcommon::clientsocket *sock = NULL;
+
+	// check if the unixdomain socket exists
+	if (unixdomain.exists())
+	{
+		// connect to the unix domain socket
+		sock = new ibrcommon::filesocket(unixdomain);
+	}
+	else
+	{
+		ibrcommon::vaddress addr("localhost", 4550);
+
+		// connect to the standard local api port
+		sock = new ibrcommon::tcpsocket(addr);
+	}
+
+	ibrcommon::socketstream conn(sock);
 
 	try {
+		// do not delay small bundles on the API connection
+		if (lowlatency && !unixdomain.exists()) sock->set(ibrcommon::clientsocket::NO_DELAY, true);
+
 		// set-up tun2bundle gateway
 		TUN2BundleGateway gateway(app_name, conn, ptp_dev);
 		_gateway = &gateway;
 
+		gateway.setAggregation(window, max_size);
+		gateway.setLowLatency(lowlatency);
+
 		IBRCOMMON_LOGGER_TAG("Core", info) << "Local:  " << app_name << IBRCOMMON_LOGGER_ENDL;
 		IBRCOMMON_LOGGER_TAG("Core", info) << "Peer:   " << endpoint << IBRCOMMON_LOGGER_ENDL;
 		IBRCOMMON_LOGGER_TAG("Core", info) << "Device: " << gateway.getDeviceName() << IBRCOMMON_LOGGER_ENDL;
+		if (window > 0) {
+			IBRCOMMON_LOGGER_TAG("Core", info) << "Aggregation: " << window << " ms, " << max_size << " bytes" << IBRCOMMON_LOGGER_ENDL;
+		}
 		IBRCOMMON_LOGGER_TAG("Core", notice) << IBRCOMMON_LOGGER_ENDL;
 		IBRCOMMON_LOGGER_TAG("Core", notice) << "Now you need to set-up the ip tunnel. You can use commands like this:" << IBRCOMMON_LOGGER_ENDL;
 		IBRCOMMON_LOGGER_TAG("Core", notice) << "# sudo ip link set " << gateway.getDeviceName() << " up mtu 65535" << IBRCOMMON_LOGGER_ENDL;